@@ -91,6 +91,9 @@ elseif(MSVC)
     # your catch(...) blocks to catch structured exceptions.
     add_extra_compiler_option("/EHa")
   endif()
+  if(ENABLE_AVX2)
+    add_extra_compiler_option("/arch:AVX2")
+  endif()
 endif()
 
 if(USE_OPENMP)
@@ -126,6 +129,11 @@ if(CMAKE_COMPILER_IS_GNUCXX)
     add_extra_compiler_option(-mno-ssse3)
   endif()
 
+  if(ENABLE_AVX2)
+    add_extra_compiler_option(-mavx2)
+    add_extra_compiler_option(-mfma)
+  endif()
+
   if(X86)
     add_extra_compiler_option(-ffloat-store)
   endif()
@@ -83,10 +83,10 @@
 #include <visp3/vs/vpServo.h>
 
 // List of allowed command line options
-#define GETOPTARGS "cdh"
+#define GETOPTARGS "cdhs"
 
 void usage(const char *name, const char *badparam);
-bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display);
+bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display, bool &stepped);
 
 /*!
 
@@ -106,7 +106,7 @@ Tests a control law with the following characteristics:\n\
 - internal and external camera view displays.\n\
           \n\
 SYNOPSIS\n\
-  %s [-c] [-d] [-h]\n", name);
+  %s [-c] [-d] [-s] [-h]\n", name);
 
   fprintf(stdout, "\n\
 OPTIONS:                                               Default\n\
@@ -117,6 +117,11 @@ OPTIONS:                                               Default\n\
   -d \n\
      Turn off the display.\n\
                   \n\
+  -s \n\
+     Run the simulation in stepped mode: the robot moves\n\
+     of one sampling time at each iteration, as fast as\n\
+     possible and without a background thread.\n\
+                  \n\
   -h\n\
      Print the help.\n");
 
@@ -131,11 +136,12 @@ Set the program options.
   \param argv : Array of command line parameters.
   \param display : Display activation.
   \param click_allowed : Click activation.
+  \param stepped : Stepped simulation activation.
 
   \return false if the program has to be stopped, true otherwise.
 
 */
-bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display)
+bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display, bool &stepped)
 {
   const char *optarg_;
   int c;
@@ -148,6 +154,9 @@ bool getOptions(int argc, const char **argv, bool &click_allowed, bool &display)
     case 'd':
       display = false;
       break;
+    case 's':
+      stepped = true;
+      break;
     case 'h':
       usage(argv[0], NULL);
       return false;
@@ -183,9 +192,10 @@ int main(int argc, const char **argv)
     try {
       bool opt_click_allowed = true;
       bool opt_display = true;
+      bool opt_stepped = false;
 
       // Read the command line options
-      if (getOptions(argc, argv, opt_click_allowed, opt_display) == false) {
+      if (getOptions(argc, argv, opt_click_allowed, opt_display, opt_stepped) == false) {
         exit(-1);
       }
 
@@ -270,6 +280,10 @@ int main(int argc, const char **argv)
       // Initialise the robot and especially the camera
       robot.init(vpViper850::TOOL_PTGREY_FLEA2_CAMERA, vpCameraParameters::perspectiveProjWithoutDistortion);
       robot.setRobotState(vpRobot::STATE_VELOCITY_CONTROL);
+      if (opt_stepped) {
+        // The robot only moves when step() is called
+        robot.setSteppedMode(true);
+      }
 
       // Initialise the object for the display part
       robot.initScene(vpWireFrameSimulator::PLATE, vpWireFrameSimulator::D_STANDARD);
@@ -340,8 +354,13 @@ int main(int argc, const char **argv)
 
         std::cout << "|| s - s* || " << (task.getError()).sumSquare() << std::endl;
 
-        // The main loop has a duration of 10 ms at minimum
-        vpTime::wait(t, 10);
+        if (opt_stepped) {
+          // Move the robot of one sampling time
+          robot.step();
+        } else {
+          // The main loop has a duration of 10 ms at minimum
+          vpTime::wait(t, 10);
+        }
       }
 
       // Display task information
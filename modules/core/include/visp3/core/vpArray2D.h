@@ -78,6 +78,8 @@ protected:
   Type **rowPtrs;
   //! Current array size (rowNum * colNum)
   unsigned int dsize;
+  //! True when data and rowPtrs are heap allocated by the array itself
+  bool isMemoryOwner;
 
 public:
   //! Address of the first element of the data array
@@ -88,11 +90,12 @@ public:
   Basic constructor of a 2D array.
   Number of columns and rows are set to zero.
   */
-  vpArray2D<Type>() : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL) {}
+  vpArray2D<Type>() : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isMemoryOwner(true), data(NULL) {}
   /*!
   Copy constructor of a 2D array.
   */
-  vpArray2D<Type>(const vpArray2D<Type> &A) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+  vpArray2D<Type>(const vpArray2D<Type> &A)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isMemoryOwner(true), data(NULL)
   {
     resize(A.rowNum, A.colNum, false, false);
     memcpy(data, A.data, rowNum * colNum * sizeof(Type));
@@ -103,7 +106,8 @@ public:
   \param r : Array number of rows.
   \param c : Array number of columns.
   */
-  vpArray2D<Type>(unsigned int r, unsigned int c) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+  vpArray2D<Type>(unsigned int r, unsigned int c)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isMemoryOwner(true), data(NULL)
   {
     resize(r, c);
   }
@@ -114,7 +118,8 @@ public:
   \param c : Array number of columns.
   \param val : Each element of the array is set to \e val.
   */
-  vpArray2D<Type>(unsigned int r, unsigned int c, Type val) : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+  vpArray2D<Type>(unsigned int r, unsigned int c, Type val)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), isMemoryOwner(true), data(NULL)
   {
     resize(r, c, false, false);
     *this = val;
@@ -124,15 +129,17 @@ public:
   */
   virtual ~vpArray2D<Type>()
   {
-    if (data != NULL) {
-      free(data);
-      data = NULL;
-    }
+    if (isMemoryOwner) {
+      if (data != NULL) {
+        free(data);
+      }
 
-    if (rowPtrs != NULL) {
-      free(rowPtrs);
-      rowPtrs = NULL;
+      if (rowPtrs != NULL) {
+        free(rowPtrs);
+      }
     }
+    data = NULL;
+    rowPtrs = NULL;
     rowNum = colNum = dsize = 0;
   }
 
@@ -176,6 +183,10 @@ public:
         memset(this->data, 0, this->dsize * sizeof(Type));
       }
     } else {
+      if (!isMemoryOwner) {
+        throw(vpException(vpException::dimensionError, "Cannot resize a fixed-size (%dx%d) array to (%dx%d)", rowNum,
+                          colNum, nrows, ncols));
+      }
       bool recopy = !flagNullify && recopy_; // priority to flagNullify
       const bool recopyNeeded = (ncols != this->colNum && this->colNum > 0 && ncols > 0 && (!flagNullify || recopy));
       Type *copyTmp = NULL;
@@ -645,6 +656,28 @@ public:
     return true;
   }
   //@}
+
+protected:
+  /*!
+  Constructor used by fixed-size containers (vpHomogeneousMatrix,
+  vpRotationMatrix, vpTranslationVector, vpVelocityTwistMatrix,
+  vpForceTwistMatrix) that embed their elements in the object itself to
+  avoid any heap allocation. The array is initialized with 0 but doesn't take
+  the ownership of the buffers and cannot be resized afterwards.
+
+  \param r : Array number of rows.
+  \param c : Array number of columns.
+  \param storage : Buffer of at least r * c elements.
+  \param storageRowPtrs : Buffer of at least r row pointers.
+  */
+  vpArray2D<Type>(unsigned int r, unsigned int c, Type *storage, Type **storageRowPtrs)
+    : rowNum(r), colNum(c), rowPtrs(storageRowPtrs), dsize(r * c), isMemoryOwner(false), data(storage)
+  {
+    for (unsigned int i = 0; i < r; i++) {
+      rowPtrs[i] = data + i * c;
+    }
+    memset(data, 0, dsize * sizeof(Type));
+  }
 };
 
 /*!
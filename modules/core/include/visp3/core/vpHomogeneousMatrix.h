@@ -191,6 +191,12 @@ public:
   vp_deprecated void setIdentity();
 //@}
 #endif
+
+private:
+  //! Inline storage of the 16 elements that avoids any heap allocation
+  double m_storage[16];
+  //! Inline storage of the row pointers
+  double *m_rowPtrsStorage[4];
 };
 
 #endif
@@ -47,6 +47,7 @@
 #define vpIMAGECONVERT_H
 
 #include <stdint.h>
+#include <vector>
 
 // image
 #include <visp3/core/vpConfig.h>
@@ -109,6 +110,10 @@ class VISP_EXPORT vpImageConvert
 public:
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba);
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth);
+  static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba,
+                                   std::vector<uint32_t> &histogram, unsigned int step = 1);
+  static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth,
+                                   std::vector<uint32_t> &histogram, unsigned int step = 1);
   static void convert(const vpImage<unsigned char> &src, vpImage<vpRGBa> &dest);
   static void convert(const vpImage<vpRGBa> &src, vpImage<unsigned char> &dest);
 
@@ -0,0 +1,100 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pyramid of images with persistent buffers.
+ *
+ *****************************************************************************/
+
+#ifndef vpImagePyramid_h
+#define vpImagePyramid_h
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpImagePyramid
+
+  \ingroup group_core_image
+
+  \brief Pyramid of grayscale images whose buffers are reused from one build
+  to the next.
+
+  The level 0 is the input image itself, without copy. The level \f$ i > 0
+  \f$ has a size of \f$ \lfloor h / 2^i \rfloor \times \lfloor w / 2^i
+  \rfloor \f$ and is obtained from the level \f$ i-1 \f$ with downScale2(),
+  an anti-aliased 2x reduction that averages each block of 2x2 pixels.
+
+  Since the buffers of the levels are kept, building the pyramid of an image
+  with the same size as the previous one doesn't allocate any memory. This
+  class is intended to be owned by the trackers that process a pyramid at
+  each frame:
+  \code
+  vpImagePyramid pyramid;
+  std::vector<bool> levels(3, true);
+  while (acquire(I)) {
+    pyramid.build(I, levels);
+    const vpImage<unsigned char> *I2 = pyramid.getLevel(2);
+  }
+  \endcode
+
+  The input image must remain valid while the level 0 is used.
+*/
+class VISP_EXPORT vpImagePyramid
+{
+public:
+  vpImagePyramid();
+
+  void build(const vpImage<unsigned char> &I, const unsigned int nbLevels);
+  void build(const vpImage<unsigned char> &I, const std::vector<bool> &levels);
+  static void build(const std::vector<const vpImage<unsigned char> *> &images, const std::vector<bool> &levels,
+                    const std::vector<vpImagePyramid *> &pyramids);
+
+  void clear();
+
+  static void downScale2(const vpImage<unsigned char> &src, vpImage<unsigned char> &dst);
+
+  const vpImage<unsigned char> *getLevel(const unsigned int level) const;
+  void getLevels(std::vector<const vpImage<unsigned char> *> &pyramid) const;
+  //! Return the number of levels, including the ones that are not built.
+  inline unsigned int getNbLevels() const { return (unsigned int)m_isBuilt.size(); }
+
+private:
+  //! Level 0, not owned
+  const vpImage<unsigned char> *m_base;
+  //! Levels 1 to n-1, m_levels[i-1] is the level i
+  std::vector<vpImage<unsigned char> > m_levels;
+  //! True if the level is requested by the last build
+  std::vector<bool> m_isBuilt;
+};
+
+#endif
@@ -599,6 +599,9 @@ template <class Type> void *vpUndistortInternalType<Type>::vpUndistort_threaded(
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+
+  \sa vpImageUndistortMap to undistort a sequence of images acquired by the
+  same camera without evaluating the distortion model for each image.
 */
 template <class Type>
 void vpImageTools::undistort(const vpImage<Type> &I, const vpCameraParameters &cam, vpImage<Type> &undistI)
@@ -0,0 +1,116 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed look-up table to undistort images.
+ *
+ *****************************************************************************/
+
+#ifndef vpImageUndistortMap_h
+#define vpImageUndistortMap_h
+
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpImageUndistortMap
+
+  \ingroup group_core_image
+
+  \brief Look-up table to undistort (or distort) the images of a camera with
+  radial distortion.
+
+  vpImageTools::undistort() evaluates the distortion model for each pixel of
+  each image. When the camera parameters and the image size don't change, the
+  source coordinates and the bilinear interpolation weights of each pixel are
+  the same from one image to the next. This class computes them once, in
+  fixed-point, so that undistorting an image only costs the interpolation:
+  \code
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 600, 320, 240, -0.19, 0.20);
+  vpImageUndistortMap map(cam, 640, 480);
+
+  vpImage<unsigned char> I, Iundist;
+  while (acquire(I)) {
+    map.remap(I, Iundist);
+  }
+  \endcode
+
+  The interpolation uses SSE2 when available and the image is split in bands
+  of rows processed by the workers of vpThreadPool::getInstance().
+
+  Compared to vpImageTools::undistort(), the interpolated values are rounded
+  instead of truncated and the weights are quantized on 7 bits, which leads to
+  differences of one or two gray levels.
+*/
+class VISP_EXPORT vpImageUndistortMap
+{
+public:
+  //! Direction of the transformation applied by remap().
+  typedef enum {
+    UNDISTORT, //!< Remove the distortion, using \f$ k_{ud} \f$ as vpImageTools::undistort().
+    DISTORT    //!< Add the distortion to an undistorted image, using \f$ k_{du} \f$.
+  } vpMapDirection;
+
+  vpImageUndistortMap();
+  vpImageUndistortMap(const vpCameraParameters &cam, const unsigned int width, const unsigned int height,
+                      const vpMapDirection direction = UNDISTORT);
+
+  //! Return the number of rows of the images the map applies to.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the number of columns of the images the map applies to.
+  inline unsigned int getWidth() const { return m_width; }
+
+  void init(const vpCameraParameters &cam, const unsigned int width, const unsigned int height,
+            const vpMapDirection direction = UNDISTORT);
+
+  void remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Iundist) const;
+  void remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Iundist) const;
+
+private:
+  template <class Type> void remapImage(const vpImage<Type> &I, vpImage<Type> &Iundist) const;
+
+  unsigned int m_width;
+  unsigned int m_height;
+  //! True if there is no distortion, remap() then copies the image
+  bool m_identity;
+  //! Index of the top-left pixel of the interpolation, -1 outside the image
+  std::vector<int> m_offset;
+  //! Horizontal interpolation weight, in [0, 128]
+  std::vector<short> m_du;
+  //! Vertical interpolation weight, in [0, 128]
+  std::vector<short> m_dv;
+};
+
+#endif
@@ -568,12 +568,29 @@ vpMatrix M(R);
   static void add2WeightedMatrices(const vpMatrix &A, const double &wA, const vpMatrix &B, const double &wB,
                                    vpMatrix &C);
   static void computeHLM(const vpMatrix &H, const double &alpha, vpMatrix &HLM);
+  /*!
+    Return the minimal size of the matrices for which the products are
+    delegated to Lapack/BLAS, see setLapackMatrixMinSize().
+  */
+  static unsigned int getLapackMatrixMinSize() { return m_lapack_min_size; }
   static void mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C);
   static void mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpRotationMatrix &C);
   static void mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpHomogeneousMatrix &C);
   static void mult2Matrices(const vpMatrix &A, const vpColVector &B, vpColVector &C);
   static void multMatrixVector(const vpMatrix &A, const vpColVector &v, vpColVector &w);
   static void negateMatrix(const vpMatrix &A, vpMatrix &C);
+  /*!
+    Set the minimal size of the matrices for which the products computed by
+    mult2Matrices(), AtA() and operator*() are delegated to Lapack/BLAS when
+    ViSP is built with a third-party Lapack. A product is delegated only when
+    its three dimensions are greater or equal to \e min_size; smaller
+    products, for which the BLAS call overhead dominates, use the built-in
+    cache-blocked implementation. Set to 0 to always use BLAS.
+
+    \param min_size : Minimal number of rows and columns of the operands.
+    Default value is 16.
+  */
+  static void setLapackMatrixMinSize(unsigned int min_size) { m_lapack_min_size = min_size; }
   static void sub2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C);
   static void sub2Matrices(const vpColVector &A, const vpColVector &B, vpColVector &C);
   //@}
@@ -754,6 +771,14 @@ private:
 
   static void computeCovarianceMatrixVVS(const vpHomogeneousMatrix &cMo, const vpColVector &deltaS, const vpMatrix &Ls,
                                          vpMatrix &Js, vpColVector &deltaP);
+
+  static void gemm(const unsigned int M, const unsigned int N, const unsigned int K, const double *a_data,
+                   const unsigned int lda, const double *b_data, const unsigned int ldb, double *c_data,
+                   const unsigned int ldc);
+  static void syrk(const unsigned int M, const unsigned int N, const double *a_data, double *c_data);
+
+  static unsigned int m_lapack_min_size;
+  static const unsigned int m_lapack_min_size_default;
 };
 
 //////////////////////////////////////////////////////////////////////////
@@ -54,6 +54,7 @@
 #  include <arpa/inet.h>
 #  include <netdb.h>
 #  include <netinet/in.h>
+#  include <netinet/tcp.h>
 #  include <sys/socket.h>
 #  include <unistd.h>
 #else
@@ -98,8 +99,19 @@ protected:
 #endif
     struct sockaddr_in receptorAddress;
     std::string receptorIP;
-
-    vpReceptor() : socketFileDescriptorReceptor(0), receptorAddressSize(), receptorAddress(), receptorIP() {}
+    // Reception buffer of the binary protocol, the bytes not yet handled
+    // are in [receivedBegin, receivedEnd)
+    std::vector<char> receivedData;
+    size_t receivedBegin;
+    size_t receivedEnd;
+    // True once Nagle's algorithm has been disabled for the binary protocol
+    bool noDelay;
+
+    vpReceptor()
+      : socketFileDescriptorReceptor(0), receptorAddressSize(), receptorAddress(), receptorIP(), receivedData(),
+        receivedBegin(0), receivedEnd(0), noDelay(false)
+    {
+    }
   };
 
   struct vpEmitter {
@@ -149,14 +161,21 @@ protected:
 
   bool verboseMode;
 
+  bool binaryProtocol;
+  unsigned int max_size_frame;
+
 private:
   std::vector<int> _handleRequests();
   int _handleFirstRequest();
+  int _handleFirstBinaryRequest();
 
   void _receiveRequest();
   void _receiveRequestFrom(const unsigned int &receptorEmitting);
   int _receiveRequestOnce();
   int _receiveRequestOnceFrom(const unsigned int &receptorEmitting);
+  int _receiveBinaryData(const unsigned int &receptorEmitting);
+
+  int _sendBinaryRequestTo(vpRequest &req, const unsigned int &dest);
 
 public:
   vpNetwork();
@@ -164,6 +183,14 @@ public:
 
   void addDecodingRequest(vpRequest *);
 
+  /*!
+    Return true if the requests are sent and received with the binary
+    protocol.
+
+    \sa vpNetwork::setBinaryProtocol()
+  */
+  bool getBinaryProtocol() const { return binaryProtocol; }
+
   int getReceptorIndex(const char *name);
 
   /*!
@@ -189,6 +216,16 @@ public:
   */
   unsigned int getMaxSizeReceivedMessage() { return max_size_message; }
 
+  /*!
+    Get the maximum size of a frame that can be received with the binary
+    protocol.
+
+    \sa vpNetwork::setMaxSizeReceivedFrame()
+
+    \return Actual max size value, in bytes.
+  */
+  unsigned int getMaxSizeReceivedFrame() const { return max_size_frame; }
+
   void print(const char *id = "");
 
   template <typename T> int receive(T *object, const unsigned int &sizeOfObject = sizeof(T));
@@ -216,6 +253,28 @@ public:
   int sendAndEncodeRequest(vpRequest &req);
   int sendAndEncodeRequestTo(vpRequest &req, const unsigned int &dest);
 
+  /*!
+    Set the protocol used to send and receive the requests. Both sides of the
+    connection have to use the same protocol.
+
+    With the text protocol (default), a request is sent as a string where the
+    id and the parameters are separated by text delimiters, that are searched
+    when the request is received.
+
+    With the binary protocol, a request is sent as a frame made of a header
+    with the length of the request id, the number of parameters and the
+    length of the payload, followed by the id and the parameters, each one
+    prefixed by its length. The header and the parameters are sent with a
+    single scatter/gather call, directly from the memory of the parameters
+    added with vpRequest::addParameterBuffer(). On reception, the frames are
+    extracted from the received bytes without any search, and all the data
+    available on the socket is read without blocking.
+
+    \param binary : True to use the binary protocol, false to use the text
+    protocol.
+  */
+  void setBinaryProtocol(const bool &binary) { binaryProtocol = binary; }
+
   /*!
     Change the maximum size that the emitter can receive (in request mode).
 
@@ -225,6 +284,18 @@ public:
   */
   void setMaxSizeReceivedMessage(const unsigned int &s) { max_size_message = s; }
 
+  /*!
+    Change the maximum size of a frame that can be received with the binary
+    protocol (128 MB by default). When a frame announces a larger size, the
+    data already received from the receptor is dropped. The reception buffer
+    of a receptor doesn't grow much beyond this size.
+
+    \sa vpNetwork::getMaxSizeReceivedFrame()
+
+    \param s : new maximum size value, in bytes, header included.
+  */
+  void setMaxSizeReceivedFrame(const unsigned int &s) { max_size_frame = s; }
+
   /*!
     Change the time the emitter spend to check if he receives a message from a
     receptor. Initially this value is set to 10usec.
@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored in a contiguous buffer.
+ *
+ *****************************************************************************/
+
+#ifndef vpOrganizedPointCloud_h
+#define vpOrganizedPointCloud_h
+
+#include <stdint.h>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpOrganizedPointCloud
+  \ingroup group_core_geometry
+
+  \brief Organized point cloud (one 3D point per pixel) stored in a contiguous
+  buffer.
+
+  Compared to a std::vector<vpColVector> where each point is a separate heap
+  allocated vector, the points are stored either:
+  - in an interleaved XYZ buffer of doubles, owned by the point cloud
+    (see resize()) or provided by the user without copy (see buildFrom(const
+    double *, unsigned int, unsigned int, unsigned int));
+  - or as a view on a raw depth image and the camera intrinsics (see
+    buildFrom(const vpImage<uint16_t> &, const vpCameraParameters &, double)).
+    In that case no 3D point is stored: the X and Y coordinates are computed
+    on the fly from the depth using look-up tables of the normalized
+    coordinates.
+
+  When the point cloud is a view, the wrapped memory has to remain valid as
+  long as the point cloud is used.
+
+  The following example shows how to track with the depth trackers from a
+  depth image without building any intermediate point cloud:
+  \code
+  vpImage<uint16_t> I_depth_raw;
+  vpCameraParameters cam_depth;
+  double depth_scale;
+  // ... acquire I_depth_raw
+  vpOrganizedPointCloud pointcloud;
+  pointcloud.buildFrom(I_depth_raw, cam_depth, depth_scale);
+
+  std::map<std::string, const vpOrganizedPointCloud *> mapOfPointClouds;
+  mapOfPointClouds["Camera2"] = &pointcloud;
+  tracker.track(mapOfImages, mapOfPointClouds);
+  \endcode
+*/
+class VISP_EXPORT vpOrganizedPointCloud
+{
+public:
+  vpOrganizedPointCloud();
+  vpOrganizedPointCloud(const unsigned int height, const unsigned int width);
+  vpOrganizedPointCloud(const vpOrganizedPointCloud &pointcloud);
+  virtual ~vpOrganizedPointCloud();
+
+  void buildFrom(const std::vector<vpColVector> &pointcloud, const unsigned int height, const unsigned int width);
+  void buildFrom(const double *xyz, const unsigned int height, const unsigned int width,
+                 const unsigned int stride = 0);
+  void buildFrom(const vpImage<uint16_t> &depth, const vpCameraParameters &cam, const double depthScale);
+
+  void clear();
+
+  /*!
+    Return the depth of the point at pixel (i, j).
+  */
+  inline double getDepth(const unsigned int i, const unsigned int j) const
+  {
+    return m_depth != NULL ? m_depth[i * m_stride + j] * m_depthScale : m_xyz[i * m_stride + 3 * j + 2];
+  }
+  //! Return the number of rows of the organized point cloud.
+  inline unsigned int getHeight() const { return m_height; }
+  /*!
+    Get the 3D coordinates of the point at pixel (i, j).
+  */
+  inline void getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    if (m_depth != NULL) {
+      Z = m_depth[i * m_stride + j] * m_depthScale;
+      X = m_xLut[j] * Z;
+      Y = m_yLut[i] * Z;
+    } else {
+      const double *xyz = m_xyz + i * m_stride + 3 * j;
+      X = xyz[0];
+      Y = xyz[1];
+      Z = xyz[2];
+    }
+  }
+  /*!
+    Return a pointer to the interleaved XYZ coordinates of the first point of
+    row \e i.
+
+    \exception vpException::fatalError When the point cloud is a view on a
+    depth image.
+  */
+  inline const double *getRow(const unsigned int i) const
+  {
+    if (m_xyz == NULL) {
+      throw(vpException(vpException::fatalError, "The point cloud is not stored as XYZ coordinates"));
+    }
+    return m_xyz + i * m_stride;
+  }
+  double *getRow(const unsigned int i);
+  //! Return the distance in elements between two consecutive rows.
+  inline unsigned int getStride() const { return m_stride; }
+  //! Return the number of columns of the organized point cloud.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return true if the 3D points are computed on the fly from a depth image.
+  inline bool isDepthView() const { return m_depth != NULL; }
+
+  vpOrganizedPointCloud &operator=(const vpOrganizedPointCloud &pointcloud);
+
+  void resize(const unsigned int height, const unsigned int width);
+
+private:
+  void allocate(const unsigned int height, const unsigned int width);
+
+  //! Number of rows
+  unsigned int m_height;
+  //! Number of columns
+  unsigned int m_width;
+  //! Distance in elements (double or uint16_t) between two consecutive rows
+  unsigned int m_stride;
+  //! Interleaved XYZ coordinates owned by the point cloud
+  std::vector<double> m_buffer;
+  //! Interleaved XYZ coordinates, either m_buffer or user memory
+  const double *m_xyz;
+  //! Raw depth values when the point cloud is a view on a depth image
+  const uint16_t *m_depth;
+  //! Scale to convert a raw depth value into meter
+  double m_depthScale;
+  //! Normalized x coordinate of each column
+  std::vector<double> m_xLut;
+  //! Normalized y coordinate of each row
+  std::vector<double> m_yLut;
+};
+
+#endif
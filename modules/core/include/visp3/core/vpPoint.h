@@ -64,6 +64,7 @@ public:
   vpPoint(double oX, double oY, double oZ);
   explicit vpPoint(const vpColVector &P);
   explicit vpPoint(const std::vector<double> &P);
+  vpPoint(const vpPoint &vpp);
   //! Destructor.
   virtual ~vpPoint() {}
 
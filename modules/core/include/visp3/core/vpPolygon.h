@@ -141,6 +141,8 @@ public:
   void initClick(const vpImage<vpRGBa> &I, unsigned int size = 5, const vpColor &color = vpColor::red,
                  unsigned int thickness = 1);
 
+  void getRowSpans(const int i, const int left, const int right, std::vector<int> &spans) const;
+
   bool isInside(const vpImagePoint &iP, const PointInPolygonMethod &method = PnPolyRayCasting) const;
 
   void display(const vpImage<unsigned char> &I, const vpColor &color, unsigned int thickness = 1) const;
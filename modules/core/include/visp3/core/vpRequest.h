@@ -45,6 +45,7 @@
 #include <visp3/core/vpImageException.h>
 
 #include <string.h>
+#include <utility>
 #include <vector>
 
 /*!
@@ -124,6 +125,24 @@ void vpRequestImage::decode(){
 }
   \endcode
 
+  With the binary protocol of vpNetwork (see
+  vpNetwork::setBinaryProtocol()), large parameters like the bitmap of an
+  image or the data of a matrix can be added without copy with
+  addParameterBuffer(). The memory is directly sent from the user buffer, so
+  it has to remain valid until the request is sent:
+  \code
+void vpRequestImage::encode(){
+  clear();
+
+  unsigned int h = I->getHeight();
+  unsigned int w = I->getWidth();
+
+  addParameterObject(&h);
+  addParameterObject(&w);
+  addParameterBuffer(I->bitmap,h*w*sizeof(unsigned char));
+}
+  \endcode
+
   \sa vpClient
   \sa vpServer
   \sa vpNetwork
@@ -133,6 +152,8 @@ class VISP_EXPORT vpRequest
 protected:
   std::string request_id;
   std::vector<std::string> listOfParams;
+  //! Memory of the parameters added without copy, indexed as listOfParams
+  std::vector<std::pair<const char *, unsigned int> > listOfBuffers;
 
 public:
   vpRequest();
@@ -141,6 +162,7 @@ public:
   void addParameter(char *params);
   void addParameter(std::string &params);
   void addParameter(std::vector<std::string> &listOfparams);
+  void addParameterBuffer(const void *params, const unsigned int &sizeOfBuffer);
   template <typename T> void addParameterObject(T *params, const int &sizeOfObject = sizeof(T));
 
   /*!
@@ -153,7 +175,11 @@ public:
   /*!
     Clear the parameters of the request.
   */
-  void clear() { listOfParams.clear(); }
+  void clear()
+  {
+    listOfParams.clear();
+    listOfBuffers.clear();
+  }
 
   /*!
     Encode the parameters of the request (Funtion that has to be redifined).
@@ -185,6 +211,38 @@ public:
   */
   std::string getId() { return request_id; }
 
+  /*!
+    Get the memory of a parameter, either added by copy or with
+    addParameterBuffer().
+
+    \sa getParameterSize()
+
+    \return Pointer to the first byte of the parameter at the index i.
+  */
+  inline const char *getParameterData(const unsigned int &i) const
+  {
+    if (i < listOfBuffers.size() && listOfBuffers[i].first != NULL) {
+      return listOfBuffers[i].first;
+    }
+    return listOfParams[i].data();
+  }
+
+  /*!
+    Get the size in bytes of a parameter, either added by copy or with
+    addParameterBuffer().
+
+    \sa getParameterData()
+
+    \return Size of the parameter at the index i.
+  */
+  inline unsigned int getParameterSize(const unsigned int &i) const
+  {
+    if (i < listOfBuffers.size() && listOfBuffers[i].first != NULL) {
+      return listOfBuffers[i].second;
+    }
+    return (unsigned int)listOfParams[i].size();
+  }
+
   /*!
     Change the ID of the request.
 
@@ -226,6 +284,7 @@ template <typename T> void vpRequest::addParameterObject(T *params, const int &s
     std::string returnVal(tempS, (size_t)sizeOfObject);
 
     listOfParams.push_back(returnVal);
+    listOfBuffers.resize(listOfParams.size(), std::pair<const char *, unsigned int>((const char *)NULL, 0));
 
     delete[] tempS;
   }
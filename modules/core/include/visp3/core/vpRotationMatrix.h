@@ -157,6 +157,10 @@ public:
 
 private:
   static const double threshold;
+  //! Inline storage of the 9 elements that avoids any heap allocation
+  double m_storage[9];
+  //! Inline storage of the row pointers
+  double *m_rowPtrsStorage[3];
 };
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
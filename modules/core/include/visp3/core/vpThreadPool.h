@@ -0,0 +1,136 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Persistent pool of worker threads.
+ *
+ *****************************************************************************/
+
+#ifndef vpThreadPool_h
+#define vpThreadPool_h
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpThreadPool
+
+  \ingroup group_core_threading
+
+  \brief Pool of persistent worker threads that execute batches of tasks.
+
+  Creating and joining threads at each call of a parallel algorithm costs
+  tens of microseconds per thread, which is not negligible for algorithms
+  called several times per frame. The worker threads of the pool are created
+  once and sleep while there is no work.
+
+  Each worker owns a queue of tasks protected by its own lock. The tasks of a
+  batch are spread over the queues and one sleeping worker is woken up per
+  task. A worker takes the tasks of its own queue first and steals from the
+  other queues only once its own queue is empty.
+  The thread that calls run() also executes the tasks of its own batch until
+  the whole batch is done. A pool without worker threads therefore executes
+  the tasks sequentially, and a task can itself call run() on the same pool
+  without risk of deadlock.
+
+  The workers rely on pthread if available, or on the C++11 threading
+  support otherwise. Without any of them, the tasks are executed
+  sequentially by the calling thread.
+
+  An exception thrown by a task is rethrown by run() in the calling thread.
+
+  A process-wide pool sized on the number of processors is shared through
+  getInstance():
+  \code
+#include <visp3/core/vpThreadPool.h>
+
+class vpSumTask : public vpThreadPool::vpTask
+{
+public:
+  vpSumTask(const double *data, size_t size) : m_data(data), m_size(size), m_sum(0) {}
+  virtual void run()
+  {
+    for (size_t i = 0; i < m_size; i++)
+      m_sum += m_data[i];
+  }
+
+  const double *m_data;
+  size_t m_size;
+  double m_sum;
+};
+
+int main()
+{
+  std::vector<double> data(1000, 1.0);
+  vpSumTask task1(&data[0], 500), task2(&data[500], 500);
+  std::vector<vpThreadPool::vpTask *> tasks;
+  tasks.push_back(&task1);
+  tasks.push_back(&task2);
+  vpThreadPool::getInstance().run(tasks);
+  double sum = task1.m_sum + task2.m_sum;
+}
+  \endcode
+*/
+class VISP_EXPORT vpThreadPool
+{
+public:
+  /*!
+    \class vpTask
+    \brief Unit of work executed by a worker thread of vpThreadPool.
+  */
+  class VISP_EXPORT vpTask
+  {
+  public:
+    virtual ~vpTask() {}
+    //! Work to be done, possibly in a worker thread.
+    virtual void run() = 0;
+  };
+
+  explicit vpThreadPool(int nbThreads = -1);
+  virtual ~vpThreadPool();
+
+  static vpThreadPool &getInstance();
+  static unsigned int getNbProcessors();
+
+  unsigned int getNbThreads() const;
+
+  void run(const std::vector<vpTask *> &tasks);
+
+private:
+  class vpThreadPoolImpl;
+
+  vpThreadPool(const vpThreadPool &);
+  vpThreadPool &operator=(const vpThreadPool &);
+
+  vpThreadPoolImpl *m_impl;
+};
+
+#endif
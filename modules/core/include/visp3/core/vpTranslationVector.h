@@ -95,7 +95,7 @@ public:
       Default constructor.
       The translation vector is initialized to zero.
     */
-  vpTranslationVector() : vpArray2D<double>(3, 1){};
+  vpTranslationVector() : vpArray2D<double>(3, 1, m_storage, m_rowPtrsStorage){};
   vpTranslationVector(const double tx, const double ty, const double tz);
   vpTranslationVector(const vpTranslationVector &tv);
   explicit vpTranslationVector(const vpHomogeneousMatrix &M);
@@ -160,6 +160,12 @@ public:
   static vpTranslationVector cross(const vpTranslationVector &a, const vpTranslationVector &b);
   static vpMatrix skew(const vpTranslationVector &tv);
   static void skew(const vpTranslationVector &tv, vpMatrix &M);
+
+private:
+  //! Inline storage of the 3 elements that avoids any heap allocation
+  double m_storage[3];
+  //! Inline storage of the row pointers
+  double *m_rowPtrsStorage[3];
 };
 
 #endif
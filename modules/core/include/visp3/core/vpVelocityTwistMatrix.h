@@ -190,6 +190,12 @@ public:
   vp_deprecated void setIdentity();
 //@}
 #endif
+
+private:
+  //! Inline storage of the 36 elements that avoids any heap allocation
+  double m_storage[36];
+  //! Inline storage of the row pointers
+  double *m_rowPtrsStorage[6];
 };
 
 #endif
@@ -64,6 +64,11 @@
 #endif
 #endif
 
+#if defined __AVX2__
+#include <immintrin.h>
+#define VISP_HAVE_AVX2 1
+#endif
+
 bool vpImageConvert::YCbCrLUTcomputed = false;
 int vpImageConvert::vpCrr[256];
 int vpImageConvert::vpCgb[256];
@@ -191,40 +196,128 @@ void vpImageConvert::convert(const vpImage<unsigned char> &src, vpImage<double>
     dest.bitmap[i] = (double)src.bitmap[i];
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+/*
+  Build in \e histogram the cumulative histogram of the non zero depth values
+  of \e src_depth, sampled every \e step rows and columns, and turn it into a
+  look-up table giving the 0-255 position of each depth value in the
+  histogram. Depth values larger than the ones found in the image, which may
+  happen when the image is subsampled, are at position 255.
+*/
+void computeDepthHistogramLUT(const vpImage<uint16_t> &src_depth, std::vector<uint32_t> &histogram,
+                              unsigned int step)
+{
+  // The vector keeps its capacity from one call to the next
+  histogram.assign(0x10000, 0);
+  if (step == 0) {
+    step = 1;
+  }
+
+  for (unsigned int i = 0; i < src_depth.getHeight(); i += step) {
+    const uint16_t *depth = src_depth[i];
+    for (unsigned int j = 0; j < src_depth.getWidth(); j += step) {
+      ++histogram[depth[j]];
+    }
+  }
+
+  unsigned int minDepth = 1, maxDepth = 0xFFFF;
+  while (maxDepth > 0 && histogram[maxDepth] == 0) {
+    maxDepth--;
+  }
+  while (minDepth < maxDepth && histogram[minDepth] == 0) {
+    minDepth++;
+  }
+  for (unsigned int d = minDepth + 1; d <= maxDepth; ++d) {
+    histogram[d] += histogram[d - 1]; // Build a cumulative histogram for the
+                                      // indices in [1,maxDepth]
+  }
+
+  // Replace the per-pixel division by a look-up table, the values below
+  // minDepth are already 0
+  const uint64_t total = maxDepth > 0 ? histogram[maxDepth] : 0;
+  histogram[0] = 0;
+  for (unsigned int d = minDepth; d <= maxDepth; ++d) {
+    histogram[d] = (uint32_t)((uint64_t)histogram[d] * 255 / total); // 0-255 based on histogram location
+  }
+  for (unsigned int d = maxDepth + 1; d < 0x10000; ++d) {
+    histogram[d] = 255;
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Convert the input 16-bits depth image to a color depth image. The input
   depth value is assigned a color value proportional to its frequency. Tha
   alpha component of the resulting image is set to vpRGBa::alpha_default.
   \param src_depth : input 16-bits depth image.
   \param dest_rgba : output color depth image.
+
+  \note This function allocates its histogram at each call. When the
+  conversion is done for each frame of a stream, use
+  createDepthHistogram(const vpImage<uint16_t> &, vpImage<vpRGBa> &, std::vector<uint32_t> &, unsigned int)
+  to keep it from one call to the next.
 */
 void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba)
+{
+  std::vector<uint32_t> histogram;
+  createDepthHistogram(src_depth, dest_rgba, histogram);
+}
+
+/*!
+  Convert the input 16-bits depth image to a color depth image. The input
+  depth value is assigned a color value proportional to its frequency. Tha
+  alpha component of the resulting image is set to vpRGBa::alpha_default.
+
+  Each thread has to use its own \e histogram buffer, which makes this
+  function safe to call concurrently on several depth streams.
+
+  \param src_depth : input 16-bits depth image.
+  \param dest_rgba : output color depth image.
+  \param histogram : buffer of 65536 elements used to compute the histogram.
+  It is resized if needed and can be reused from one call to the next to
+  avoid any allocation.
+  \param step : the histogram is computed on one pixel every \e step rows and
+  columns. Values larger than 1 speed up the conversion of large images at
+  the price of an approximate histogram.
+*/
+void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba,
+                                          std::vector<uint32_t> &histogram, unsigned int step)
 {
   dest_rgba.resize(src_depth.getHeight(), src_depth.getWidth());
-  static uint32_t histogram[0x10000];
-  memset(histogram, 0, sizeof(histogram));
-
-  for (unsigned int i = 0; i < src_depth.getSize(); ++i)
-    ++histogram[src_depth.bitmap[i]];
-  for (int i = 2; i < 0x10000; ++i)
-    histogram[i] += histogram[i - 1]; // Build a cumulative histogram for the
-                                      // indices in [1,0xFFFF]
-
-  for (unsigned int i = 0; i < src_depth.getSize(); ++i) {
-    uint16_t d = src_depth.bitmap[i];
-    if (d) {
-      int f = (int)(histogram[d] * 255 / histogram[0xFFFF]); // 0-255 based on histogram location
-      dest_rgba.bitmap[i].R = 255 - f;
-      dest_rgba.bitmap[i].G = 0;
-      dest_rgba.bitmap[i].B = f;
-      dest_rgba.bitmap[i].A = vpRGBa::alpha_default;
-    } else {
-      dest_rgba.bitmap[i].R = 20;
-      dest_rgba.bitmap[i].G = 5;
-      dest_rgba.bitmap[i].B = 0;
-      dest_rgba.bitmap[i].A = vpRGBa::alpha_default;
+  computeDepthHistogramLUT(src_depth, histogram, step);
+
+  // Turn the look-up table into a table of colors
+  vpRGBa color(20, 5, 0, vpRGBa::alpha_default);
+  memcpy(&histogram[0], &color, sizeof(vpRGBa));
+  for (unsigned int d = 1; d < 0x10000; ++d) {
+    color.R = (unsigned char)(255 - histogram[d]);
+    color.G = 0;
+    color.B = (unsigned char)histogram[d];
+    memcpy(&histogram[d], &color, sizeof(vpRGBa));
+  }
+
+  const uint32_t *lut = &histogram[0];
+  const uint16_t *src = src_depth.bitmap;
+  unsigned char *dst = reinterpret_cast<unsigned char *>(dest_rgba.bitmap);
+  const unsigned int size = src_depth.getSize();
+  unsigned int i = 0;
+
+#if VISP_HAVE_AVX2
+  if (vpCPUFeatures::checkAVX2() && size >= 8) {
+    for (; i <= size - 8; i += 8) {
+      const __m256i idx = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+      const __m256i colors = _mm256_i32gather_epi32(reinterpret_cast<const int *>(lut), idx, 4);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 4 * i), colors);
     }
   }
+#endif
+
+  for (; i < size; i++) {
+    memcpy(dst + 4 * i, lut + src[i], sizeof(vpRGBa));
+  }
 }
 
 /*!
@@ -232,27 +325,46 @@ void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vp
   depth value is assigned a value proportional to its frequency. \param
   src_depth : input 16-bits depth image. \param dest_depth : output grayscale
   depth image.
+
+  \note This function allocates its histogram at each call. When the
+  conversion is done for each frame of a stream, use
+  createDepthHistogram(const vpImage<uint16_t> &, vpImage<unsigned char> &, std::vector<uint32_t> &, unsigned int)
+  to keep it from one call to the next.
 */
 void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth)
+{
+  std::vector<uint32_t> histogram;
+  createDepthHistogram(src_depth, dest_depth, histogram);
+}
+
+/*!
+  Convert the input 16-bits depth image to a 8-bits depth image. The input
+  depth value is assigned a value proportional to its frequency.
+
+  Each thread has to use its own \e histogram buffer, which makes this
+  function safe to call concurrently on several depth streams.
+
+  \param src_depth : input 16-bits depth image.
+  \param dest_depth : output grayscale depth image.
+  \param histogram : buffer of 65536 elements used to compute the histogram.
+  It is resized if needed and can be reused from one call to the next to
+  avoid any allocation.
+  \param step : the histogram is computed on one pixel every \e step rows and
+  columns. Values larger than 1 speed up the conversion of large images at
+  the price of an approximate histogram.
+*/
+void vpImageConvert::createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<unsigned char> &dest_depth,
+                                          std::vector<uint32_t> &histogram, unsigned int step)
 {
   dest_depth.resize(src_depth.getHeight(), src_depth.getWidth());
-  static uint32_t histogram2[0x10000];
-  memset(histogram2, 0, sizeof(histogram2));
-
-  for (unsigned int i = 0; i < src_depth.getSize(); ++i)
-    ++histogram2[src_depth.bitmap[i]];
-  for (int i = 2; i < 0x10000; ++i)
-    histogram2[i] += histogram2[i - 1]; // Build a cumulative histogram for
-                                        // the indices in [1,0xFFFF]
-
-  for (unsigned int i = 0; i < src_depth.getSize(); ++i) {
-    uint16_t d = src_depth.bitmap[i];
-    if (d) {
-      int f = (int)(histogram2[d] * 255 / histogram2[0xFFFF]); // 0-255 based on histogram location
-      dest_depth.bitmap[i] = f;
-    } else {
-      dest_depth.bitmap[i] = 0;
-    }
+  computeDepthHistogramLUT(src_depth, histogram, step);
+
+  const uint32_t *lut = &histogram[0];
+  const uint16_t *src = src_depth.bitmap;
+  unsigned char *dst = dest_depth.bitmap;
+  const unsigned int size = src_depth.getSize();
+  for (unsigned int i = 0; i < size; i++) {
+    dst[i] = (unsigned char)lut[src[i]];
   }
 }
 
@@ -36,8 +36,14 @@
  *
  *****************************************************************************/
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <algorithm>
+#include <vector>
+
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
 #include <opencv2/imgproc/imgproc.hpp>
 #elif defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020101)
@@ -46,6 +52,689 @@
 #include <cv.h>
 #endif
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#if defined __AVX2__
+#include <immintrin.h>
+#define VISP_HAVE_AVX2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Images for which the number of pixels times the number of taps of the
+// kernels is smaller than this are filtered by the calling thread
+const double sep_filter_parallel_size = 640. * 480. * 14.;
+// Minimum number of rows of the bands filtered by the threads
+const unsigned int sep_filter_min_band = 32;
+// Fractional bits of the horizontal and vertical kernels of the fixed-point
+// Gaussian blur
+const int sep_filter_fixed_bits_h = 8;
+const int sep_filter_fixed_bits_v = 14;
+
+enum vpKernelType {
+  KERNEL_NONE,         // Identity
+  KERNEL_SYMMETRIC,    // Smoothing kernel as used by vpImageFilter::filterX()
+  KERNEL_ANTISYMMETRIC // Derivative kernel as used by vpImageFilter::getGradX()
+};
+
+// 1D kernel of size 2 half + 1 given by its half + 1 coefficients, the
+// first one being the central coefficient
+template <typename T> struct vpKernel1D {
+  vpKernel1D() : type(KERNEL_NONE), coeffs(NULL), half(0) {}
+  vpKernel1D(vpKernelType kernelType, const T *kernelCoeffs, unsigned int size)
+    : type(kernelType), coeffs(kernelCoeffs), half(kernelType == KERNEL_NONE ? 0 : (size - 1) / 2)
+  {
+  }
+
+  vpKernelType type;
+  const T *coeffs;
+  unsigned int half;
+};
+
+#if VISP_HAVE_AVX2
+bool useAVX2()
+{
+  static const bool checkAVX2 = vpCPUFeatures::checkAVX2();
+  return checkAVX2;
+}
+#endif
+
+#if VISP_HAVE_SSE2
+bool useSSE2()
+{
+  static const bool checkSSE2 = vpCPUFeatures::checkSSE2();
+  return checkSSE2;
+}
+#endif
+
+// Index of the element k of a line of n elements extended by reflection on
+// both sides, as done by vpImageFilter::filterXLeftBorder() and
+// vpImageFilter::filterXRightBorder()
+inline unsigned int reflect(int k, unsigned int n)
+{
+  if (k < 0) {
+    k = -k;
+  } else if (k >= (int)n) {
+    k = 2 * (int)n - 1 - k;
+  }
+  return (unsigned int)std::max(0, std::min(k, (int)n - 1));
+}
+
+// Copy the line of n elements of src in dst, extended by half elements on
+// both sides
+template <typename Tin, typename T> void loadLine(const Tin *src, unsigned int n, unsigned int half, T *dst)
+{
+  for (unsigned int j = 0; j < n; j++) {
+    dst[half + j] = static_cast<T>(src[j]);
+  }
+  for (unsigned int k = 1; k <= half; k++) {
+    dst[half - k] = static_cast<T>(src[reflect(-(int)k, n)]);
+    dst[half + n - 1 + k] = static_cast<T>(src[reflect((int)(n - 1 + k), n)]);
+  }
+}
+
+#if VISP_HAVE_SSE2
+struct vpSSE2Double {
+  typedef double value_type;
+  typedef __m128d vector_type;
+  static const unsigned int lanes = 2;
+  static inline __m128d load(const double *p) { return _mm_loadu_pd(p); }
+  static inline void store(double *p, __m128d v) { _mm_storeu_pd(p, v); }
+  static inline __m128d set1(double v) { return _mm_set1_pd(v); }
+  static inline __m128d zero() { return _mm_setzero_pd(); }
+  static inline __m128d add(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+  static inline __m128d sub(__m128d a, __m128d b) { return _mm_sub_pd(a, b); }
+  static inline __m128d mul(__m128d a, __m128d b) { return _mm_mul_pd(a, b); }
+};
+
+struct vpSSE2Float {
+  typedef float value_type;
+  typedef __m128 vector_type;
+  static const unsigned int lanes = 4;
+  static inline __m128 load(const float *p) { return _mm_loadu_ps(p); }
+  static inline void store(float *p, __m128 v) { _mm_storeu_ps(p, v); }
+  static inline __m128 set1(float v) { return _mm_set1_ps(v); }
+  static inline __m128 zero() { return _mm_setzero_ps(); }
+  static inline __m128 add(__m128 a, __m128 b) { return _mm_add_ps(a, b); }
+  static inline __m128 sub(__m128 a, __m128 b) { return _mm_sub_ps(a, b); }
+  static inline __m128 mul(__m128 a, __m128 b) { return _mm_mul_ps(a, b); }
+};
+#endif
+
+#if VISP_HAVE_AVX2
+struct vpAVX2Double {
+  typedef double value_type;
+  typedef __m256d vector_type;
+  static const unsigned int lanes = 4;
+  static inline __m256d load(const double *p) { return _mm256_loadu_pd(p); }
+  static inline void store(double *p, __m256d v) { _mm256_storeu_pd(p, v); }
+  static inline __m256d set1(double v) { return _mm256_set1_pd(v); }
+  static inline __m256d zero() { return _mm256_setzero_pd(); }
+  static inline __m256d add(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+  static inline __m256d sub(__m256d a, __m256d b) { return _mm256_sub_pd(a, b); }
+  static inline __m256d mul(__m256d a, __m256d b) { return _mm256_mul_pd(a, b); }
+};
+
+struct vpAVX2Float {
+  typedef float value_type;
+  typedef __m256 vector_type;
+  static const unsigned int lanes = 8;
+  static inline __m256 load(const float *p) { return _mm256_loadu_ps(p); }
+  static inline void store(float *p, __m256 v) { _mm256_storeu_ps(p, v); }
+  static inline __m256 set1(float v) { return _mm256_set1_ps(v); }
+  static inline __m256 zero() { return _mm256_setzero_ps(); }
+  static inline __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+  static inline __m256 sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+  static inline __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+};
+#endif
+
+// The vectorized and scalar kernels below accumulate the terms in the same
+// order as vpImageFilter::filterX() and vpImageFilter::derivativeFilterX(),
+// so that they all give the same result.
+
+// Filter the n elements of the line src with the kernel k. src[-k.half] to
+// src[n - 1 + k.half] have to be readable. Return the number of elements
+// processed.
+template <class V>
+unsigned int convolveLineVector(const typename V::value_type *src, typename V::value_type *dst, unsigned int n,
+                                const vpKernel1D<typename V::value_type> &k)
+{
+  typedef typename V::vector_type vector_type;
+  unsigned int j = 0;
+  if (k.type == KERNEL_SYMMETRIC) {
+    for (; j + V::lanes <= n; j += V::lanes) {
+      vector_type acc = V::zero();
+      for (unsigned int i = 1; i <= k.half; i++) {
+        acc = V::add(acc, V::mul(V::set1(k.coeffs[i]), V::add(V::load(src + j + i), V::load(src + j - i))));
+      }
+      V::store(dst + j, V::add(acc, V::mul(V::set1(k.coeffs[0]), V::load(src + j))));
+    }
+  } else {
+    for (; j + V::lanes <= n; j += V::lanes) {
+      vector_type acc = V::zero();
+      for (unsigned int i = 1; i <= k.half; i++) {
+        acc = V::add(acc, V::mul(V::set1(k.coeffs[i]), V::sub(V::load(src + j + i), V::load(src + j - i))));
+      }
+      V::store(dst + j, acc);
+    }
+  }
+  return j;
+}
+
+// Filter the n columns of the rows with the kernel k. rows[k.half + i] is
+// the row at the offset i from the filtered row. Return the number of
+// elements processed.
+template <class V>
+unsigned int convolveColumnsVector(const typename V::value_type *const *rows, typename V::value_type *dst,
+                                   unsigned int n, const vpKernel1D<typename V::value_type> &k)
+{
+  typedef typename V::vector_type vector_type;
+  const typename V::value_type *const *center = rows + k.half;
+  unsigned int j = 0;
+  if (k.type == KERNEL_SYMMETRIC) {
+    for (; j + V::lanes <= n; j += V::lanes) {
+      vector_type acc = V::zero();
+      for (unsigned int i = 1; i <= k.half; i++) {
+        acc = V::add(acc, V::mul(V::set1(k.coeffs[i]), V::add(V::load(center[i] + j), V::load(center[-(int)i] + j))));
+      }
+      V::store(dst + j, V::add(acc, V::mul(V::set1(k.coeffs[0]), V::load(center[0] + j))));
+    }
+  } else {
+    for (; j + V::lanes <= n; j += V::lanes) {
+      vector_type acc = V::zero();
+      for (unsigned int i = 1; i <= k.half; i++) {
+        acc = V::add(acc, V::mul(V::set1(k.coeffs[i]), V::sub(V::load(center[i] + j), V::load(center[-(int)i] + j))));
+      }
+      V::store(dst + j, acc);
+    }
+  }
+  return j;
+}
+
+template <typename T> unsigned int convolveLineSIMD(const T *, T *, unsigned int, const vpKernel1D<T> &) { return 0; }
+
+template <typename T> unsigned int convolveColumnsSIMD(const T *const *, T *, unsigned int, const vpKernel1D<T> &)
+{
+  return 0;
+}
+
+#if VISP_HAVE_SSE2
+template <>
+unsigned int convolveLineSIMD<double>(const double *src, double *dst, unsigned int n, const vpKernel1D<double> &k)
+{
+#if VISP_HAVE_AVX2
+  if (useAVX2()) {
+    return convolveLineVector<vpAVX2Double>(src, dst, n, k);
+  }
+#endif
+  return useSSE2() ? convolveLineVector<vpSSE2Double>(src, dst, n, k) : 0;
+}
+
+template <>
+unsigned int convolveLineSIMD<float>(const float *src, float *dst, unsigned int n, const vpKernel1D<float> &k)
+{
+#if VISP_HAVE_AVX2
+  if (useAVX2()) {
+    return convolveLineVector<vpAVX2Float>(src, dst, n, k);
+  }
+#endif
+  return useSSE2() ? convolveLineVector<vpSSE2Float>(src, dst, n, k) : 0;
+}
+
+template <>
+unsigned int convolveColumnsSIMD<double>(const double *const *rows, double *dst, unsigned int n,
+                                         const vpKernel1D<double> &k)
+{
+#if VISP_HAVE_AVX2
+  if (useAVX2()) {
+    return convolveColumnsVector<vpAVX2Double>(rows, dst, n, k);
+  }
+#endif
+  return useSSE2() ? convolveColumnsVector<vpSSE2Double>(rows, dst, n, k) : 0;
+}
+
+template <>
+unsigned int convolveColumnsSIMD<float>(const float *const *rows, float *dst, unsigned int n,
+                                        const vpKernel1D<float> &k)
+{
+#if VISP_HAVE_AVX2
+  if (useAVX2()) {
+    return convolveColumnsVector<vpAVX2Float>(rows, dst, n, k);
+  }
+#endif
+  return useSSE2() ? convolveColumnsVector<vpSSE2Float>(rows, dst, n, k) : 0;
+}
+#endif
+
+// Filter the n elements of the line src, extended by k.half elements on
+// both sides, with the kernel k. The elements for which an antisymmetric
+// kernel is not fully inside the line are set to 0, as done by
+// vpImageFilter::getGradX().
+template <typename T> void convolveLine(const T *src, T *dst, unsigned int n, const vpKernel1D<T> &k)
+{
+  if (k.type == KERNEL_NONE) {
+    std::copy(src, src + n, dst);
+    return;
+  }
+
+  unsigned int begin = 0, end = n;
+  if (k.type == KERNEL_ANTISYMMETRIC) {
+    begin = std::min(k.half, n);
+    end = std::max(begin, n - begin);
+    std::fill(dst, dst + begin, T(0));
+    std::fill(dst + end, dst + n, T(0));
+  }
+
+  unsigned int j = begin + convolveLineSIMD(src + begin, dst + begin, end - begin, k);
+  if (k.type == KERNEL_SYMMETRIC) {
+    for (; j < end; j++) {
+      const T *center = src + j;
+      T result = 0;
+      for (unsigned int i = 1; i <= k.half; i++) {
+        result += k.coeffs[i] * (center[i] + center[-(int)i]);
+      }
+      dst[j] = result + k.coeffs[0] * center[0];
+    }
+  } else {
+    for (; j < end; j++) {
+      const T *center = src + j;
+      T result = 0;
+      for (unsigned int i = 1; i <= k.half; i++) {
+        result += k.coeffs[i] * (center[i] - center[-(int)i]);
+      }
+      dst[j] = result;
+    }
+  }
+}
+
+// Filter the n columns of the rows with the kernel k, rows[k.half + i] being
+// the row at the offset i from the filtered row.
+template <typename T> void convolveColumns(const T *const *rows, T *dst, unsigned int n, const vpKernel1D<T> &k)
+{
+  if (k.type == KERNEL_NONE) {
+    std::copy(rows[0], rows[0] + n, dst);
+    return;
+  }
+
+  const T *const *center = rows + k.half;
+  unsigned int j = convolveColumnsSIMD(rows, dst, n, k);
+  if (k.type == KERNEL_SYMMETRIC) {
+    for (; j < n; j++) {
+      T result = 0;
+      for (unsigned int i = 1; i <= k.half; i++) {
+        result += k.coeffs[i] * (center[i][j] + center[-(int)i][j]);
+      }
+      dst[j] = result + k.coeffs[0] * center[0][j];
+    }
+  } else {
+    for (; j < n; j++) {
+      T result = 0;
+      for (unsigned int i = 1; i <= k.half; i++) {
+        result += k.coeffs[i] * (center[i][j] - center[-(int)i][j]);
+      }
+      dst[j] = result;
+    }
+  }
+}
+
+// Rows of the band [r0, r1[ of the image filtered by the vertical kernel k,
+// taken from the ring buffer of 2 k.half + 1 rows of the given width where
+// the row i is stored at the position i modulo the size of the buffer
+template <typename T>
+void getRingRows(const std::vector<T> &ring, unsigned int width, unsigned int r, unsigned int height,
+                 const vpKernel1D<T> &k, std::vector<const T *> &rows)
+{
+  const unsigned int nbRows = 2 * k.half + 1;
+  for (unsigned int i = 0; i < nbRows; i++) {
+    rows[i] = &ring[(reflect((int)(r + i) - (int)k.half, height) % nbRows) * width];
+  }
+}
+
+// Separable filter of an image of Tin computed with T values.
+//
+// When the horizontal kernel is applied first, the input rows filtered by
+// the horizontal kernel are kept in a ring buffer of 2 half + 1 rows, from
+// which each output row is filtered by the vertical kernel. Otherwise the
+// input rows are kept, extended on both sides, and each row filtered by the
+// vertical kernel is then filtered by the horizontal one. Each input row is
+// thus converted and filtered only once, and the rows stay in cache between
+// the two passes.
+template <typename Tin, typename T> class vpSeparableFilter
+{
+public:
+  vpSeparableFilter(const vpImage<Tin> &I, vpImage<T> &If, const vpKernel1D<T> &kernelH,
+                    const vpKernel1D<T> &kernelV, bool verticalFirst)
+    : m_I(&I), m_If(&If), m_kernelH(kernelH), m_kernelV(kernelV), m_verticalFirst(verticalFirst)
+  {
+  }
+
+  unsigned int getTaps() const { return 2 * (m_kernelH.half + m_kernelV.half) + 2; }
+
+  void filterRows(unsigned int r0, unsigned int r1) const
+  {
+    const unsigned int w = m_I->getWidth(), h = m_I->getHeight();
+    const unsigned int hh = m_kernelH.half, vh = m_kernelV.half;
+    std::vector<T> line(w + 2 * hh);
+
+    if (m_kernelV.type == KERNEL_NONE) {
+      for (unsigned int r = r0; r < r1; r++) {
+        loadLine((*m_I)[r], w, hh, &line[0]);
+        convolveLine(&line[hh], (*m_If)[r], w, m_kernelH);
+      }
+      return;
+    }
+
+    const unsigned int nbRows = 2 * vh + 1;
+    const unsigned int ringWidth = m_verticalFirst ? w + 2 * hh : w;
+    std::vector<T> ring(nbRows * ringWidth);
+    std::vector<const T *> rows(nbRows);
+
+    unsigned int next = r0 > vh ? r0 - vh : 0;
+    for (unsigned int r = r0; r < r1; r++) {
+      T *dst = (*m_If)[r];
+      if (m_kernelV.type == KERNEL_ANTISYMMETRIC && (r < vh || r + vh >= h)) {
+        std::fill(dst, dst + w, T(0));
+        continue;
+      }
+
+      for (const unsigned int last = std::min(h - 1, r + vh); next <= last; next++) {
+        T *row = &ring[(next % nbRows) * ringWidth];
+        if (m_verticalFirst || m_kernelH.type == KERNEL_NONE) {
+          loadLine((*m_I)[next], w, m_verticalFirst ? hh : 0, row);
+        } else {
+          loadLine((*m_I)[next], w, hh, &line[0]);
+          convolveLine(&line[hh], row, w, m_kernelH);
+        }
+      }
+
+      getRingRows(ring, ringWidth, r, h, m_kernelV, rows);
+      if (m_verticalFirst) {
+        convolveColumns(&rows[0], &line[0], ringWidth, m_kernelV);
+        convolveLine(&line[hh], dst, w, m_kernelH);
+      } else {
+        convolveColumns(&rows[0], dst, w, m_kernelV);
+      }
+    }
+  }
+
+private:
+  const vpImage<Tin> *m_I;
+  vpImage<T> *m_If;
+  vpKernel1D<T> m_kernelH;
+  vpKernel1D<T> m_kernelV;
+  bool m_verticalFirst;
+};
+
+// Gradients along X and Y of an image of Tin computed with T values, as
+// given by vpImageFilter::getGradXGauss2D() and
+// vpImageFilter::getGradYGauss2D(), in a single pass over the input image
+template <typename Tin, typename T> class vpGaussianGradientFilter
+{
+public:
+  vpGaussianGradientFilter(const vpImage<Tin> &I, vpImage<T> &dIx, vpImage<T> &dIy, const vpKernel1D<T> &gaussian,
+                           const vpKernel1D<T> &derivative)
+    : m_I(&I), m_dIx(&dIx), m_dIy(&dIy), m_gaussian(gaussian), m_derivative(derivative)
+  {
+  }
+
+  unsigned int getTaps() const { return 8 * m_gaussian.half + 4; }
+
+  void filterRows(unsigned int r0, unsigned int r1) const
+  {
+    const unsigned int w = m_I->getWidth(), h = m_I->getHeight();
+    const unsigned int half = m_gaussian.half;
+    const unsigned int nbRows = 2 * half + 1;
+    // Input rows extended on both sides and input rows blurred along X
+    std::vector<T> ringI(nbRows * (w + 2 * half)), ringGx(nbRows * w), line(w + 2 * half);
+    std::vector<const T *> rows(nbRows);
+
+    unsigned int next = r0 > half ? r0 - half : 0;
+    for (unsigned int r = r0; r < r1; r++) {
+      for (const unsigned int last = std::min(h - 1, r + half); next <= last; next++) {
+        T *row = &ringI[(next % nbRows) * (w + 2 * half)];
+        loadLine((*m_I)[next], w, half, row);
+        convolveLine(row + half, &ringGx[(next % nbRows) * w], w, m_gaussian);
+      }
+
+      // Blur along Y then derivative along X
+      getRingRows(ringI, w + 2 * half, r, h, m_gaussian, rows);
+      convolveColumns(&rows[0], &line[0], w + 2 * half, m_gaussian);
+      convolveLine(&line[half], (*m_dIx)[r], w, m_derivative);
+
+      // Blur along X then derivative along Y
+      if (r < half || r + half >= h) {
+        std::fill((*m_dIy)[r], (*m_dIy)[r] + w, T(0));
+      } else {
+        getRingRows(ringGx, w, r, h, m_derivative, rows);
+        convolveColumns(&rows[0], (*m_dIy)[r], w, m_derivative);
+      }
+    }
+  }
+
+private:
+  const vpImage<Tin> *m_I;
+  vpImage<T> *m_dIx;
+  vpImage<T> *m_dIy;
+  vpKernel1D<T> m_gaussian;
+  vpKernel1D<T> m_derivative;
+};
+
+// Kernel with the given number of fractional bits whose coefficients sum to
+// exactly 1, from the half + 1 coefficients of a normalized symmetric kernel
+std::vector<short> getFixedPointKernel(const double *filter, unsigned int half, int bits)
+{
+  std::vector<short> coeffs(half + 1);
+  int sum = 0;
+  for (unsigned int i = 1; i <= half; i++) {
+    coeffs[i] = (short)vpMath::round(filter[i] * (1 << bits));
+    sum += 2 * coeffs[i];
+  }
+  if (sum > (1 << bits)) {
+    throw(vpImageException(vpImageException::incorrectInitializationError,
+                           "Gaussian filter too flat for the fixed-point blur"));
+  }
+  coeffs[0] = (short)((1 << bits) - sum);
+  return coeffs;
+}
+
+// Horizontal pass of the fixed-point Gaussian blur: each element of src,
+// extended by half elements on both sides, is filtered by the kernel with
+// sep_filter_fixed_bits_h fractional bits, and stored with 7 fractional bits
+// so that it fits in a signed 16-bit integer
+void convolveLineFixed(const unsigned char *src, short *dst, unsigned int n, const std::vector<short> &coeffs)
+{
+  const unsigned int half = (unsigned int)coeffs.size() - 1;
+  const int shift = sep_filter_fixed_bits_h - 7;
+  unsigned int j = 0;
+
+#if VISP_HAVE_SSE2
+  if (useSSE2()) {
+    // All the coefficients are positive and sum to 2^8: the sums of products
+    // of 8-bit values fit in unsigned 16-bit integers
+    const __m128i zero = _mm_setzero_si128(), round = _mm_set1_epi16((short)(1 << (shift - 1)));
+    for (; j + 8 <= n; j += 8) {
+      __m128i acc = _mm_mullo_epi16(
+          _mm_set1_epi16(coeffs[0]),
+          _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + j)), zero));
+      for (unsigned int i = 1; i <= half; i++) {
+        __m128i right = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + j + i)), zero);
+        __m128i left = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + j - i)), zero);
+        acc = _mm_add_epi16(acc, _mm_mullo_epi16(_mm_set1_epi16(coeffs[i]), _mm_add_epi16(right, left)));
+      }
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + j), _mm_srli_epi16(_mm_add_epi16(acc, round), shift));
+    }
+  }
+#endif
+
+  for (; j < n; j++) {
+    const unsigned char *center = src + j;
+    int acc = coeffs[0] * center[0];
+    for (unsigned int i = 1; i <= half; i++) {
+      acc += coeffs[i] * (center[i] + center[-(int)i]);
+    }
+    dst[j] = (short)((acc + (1 << (shift - 1))) >> shift);
+  }
+}
+
+// Vertical pass of the fixed-point Gaussian blur: the columns of the rows
+// with 7 fractional bits are filtered by the kernel with
+// sep_filter_fixed_bits_v fractional bits and rounded to 8-bit values
+void convolveColumnsFixed(const short *const *rows, unsigned char *dst, unsigned int n,
+                          const std::vector<short> &coeffs)
+{
+  const unsigned int half = (unsigned int)coeffs.size() - 1;
+  const short *const *center = rows + half;
+  const int shift = 7 + sep_filter_fixed_bits_v;
+  unsigned int j = 0;
+
+#if VISP_HAVE_SSE2
+  if (useSSE2()) {
+    const __m128i zero = _mm_setzero_si128(), round = _mm_set1_epi32(1 << (shift - 1));
+    for (; j + 8 <= n; j += 8) {
+      // Products accumulated in 32-bit integers by pairs of rows
+      const __m128i c0 = _mm_set1_epi16(coeffs[0]);
+      const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center[0] + j));
+      __m128i acc_lo = _mm_madd_epi16(_mm_unpacklo_epi16(v0, zero), c0);
+      __m128i acc_hi = _mm_madd_epi16(_mm_unpackhi_epi16(v0, zero), c0);
+      for (unsigned int i = 1; i <= half; i++) {
+        const __m128i c = _mm_set1_epi16(coeffs[i]);
+        const __m128i down = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center[i] + j));
+        const __m128i up = _mm_loadu_si128(reinterpret_cast<const __m128i *>(center[-(int)i] + j));
+        acc_lo = _mm_add_epi32(acc_lo, _mm_madd_epi16(_mm_unpacklo_epi16(down, up), c));
+        acc_hi = _mm_add_epi32(acc_hi, _mm_madd_epi16(_mm_unpackhi_epi16(down, up), c));
+      }
+      acc_lo = _mm_srai_epi32(_mm_add_epi32(acc_lo, round), shift);
+      acc_hi = _mm_srai_epi32(_mm_add_epi32(acc_hi, round), shift);
+      const __m128i result = _mm_packs_epi32(acc_lo, acc_hi);
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(dst + j), _mm_packus_epi16(result, result));
+    }
+  }
+#endif
+
+  for (; j < n; j++) {
+    int acc = coeffs[0] * center[0][j];
+    for (unsigned int i = 1; i <= half; i++) {
+      acc += coeffs[i] * (center[i][j] + center[-(int)i][j]);
+    }
+    dst[j] = (unsigned char)std::min(255, (acc + (1 << (shift - 1))) >> shift);
+  }
+}
+
+// Gaussian blur of an 8-bit image computed with 16-bit fixed-point values,
+// using a ring buffer of rows as vpSeparableFilter
+class vpFixedPointGaussianFilter
+{
+public:
+  vpFixedPointGaussianFilter(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI, const double *filter,
+                             unsigned int size)
+    : m_I(&I), m_GI(&GI), m_coeffsH(getFixedPointKernel(filter, (size - 1) / 2, sep_filter_fixed_bits_h)),
+      m_coeffsV(getFixedPointKernel(filter, (size - 1) / 2, sep_filter_fixed_bits_v))
+  {
+  }
+
+  unsigned int getTaps() const { return 2 * (unsigned int)m_coeffsH.size(); }
+
+  void filterRows(unsigned int r0, unsigned int r1) const
+  {
+    const unsigned int w = m_I->getWidth(), h = m_I->getHeight();
+    const unsigned int half = (unsigned int)m_coeffsH.size() - 1;
+    const unsigned int nbRows = 2 * half + 1;
+    std::vector<unsigned char> line(w + 2 * half);
+    std::vector<short> ring(nbRows * w);
+    std::vector<const short *> rows(nbRows);
+
+    unsigned int next = r0 > half ? r0 - half : 0;
+    for (unsigned int r = r0; r < r1; r++) {
+      for (const unsigned int last = std::min(h - 1, r + half); next <= last; next++) {
+        loadLine((*m_I)[next], w, half, &line[0]);
+        convolveLineFixed(&line[half], &ring[(next % nbRows) * w], w, m_coeffsH);
+      }
+      for (unsigned int i = 0; i < nbRows; i++) {
+        rows[i] = &ring[(reflect((int)(r + i) - (int)half, h) % nbRows) * w];
+      }
+      convolveColumnsFixed(&rows[0], (*m_GI)[r], w, m_coeffsV);
+    }
+  }
+
+private:
+  const vpImage<unsigned char> *m_I;
+  vpImage<unsigned char> *m_GI;
+  std::vector<short> m_coeffsH;
+  std::vector<short> m_coeffsV;
+};
+
+// Band of rows of an image filtered by a thread of the pool
+template <class Filter> class vpFilterBandTask : public vpThreadPool::vpTask
+{
+public:
+  vpFilterBandTask(const Filter &filter, unsigned int r0, unsigned int r1) : m_filter(&filter), m_r0(r0), m_r1(r1)
+  {
+  }
+
+  virtual void run() { m_filter->filterRows(m_r0, m_r1); }
+
+private:
+  const Filter *m_filter;
+  unsigned int m_r0;
+  unsigned int m_r1;
+};
+
+// Filter all the rows of an image, split by bands of rows over vpThreadPool
+// for the large images
+template <class Filter> void filterImage(const Filter &filter, unsigned int height, unsigned int width)
+{
+  if (height == 0 || width == 0) {
+    return;
+  }
+
+  vpThreadPool &pool = vpThreadPool::getInstance();
+  const double size = (double)height * (double)width * (double)filter.getTaps();
+  const unsigned int nbTasks = std::min(pool.getNbThreads() + 1, height / sep_filter_min_band);
+  if (size < sep_filter_parallel_size || nbTasks < 2) {
+    filter.filterRows(0, height);
+    return;
+  }
+
+  const unsigned int band = (height + nbTasks - 1) / nbTasks;
+  std::vector<vpFilterBandTask<Filter> > bandTasks;
+  bandTasks.reserve(nbTasks);
+  for (unsigned int r = 0; r < height; r += band) {
+    bandTasks.push_back(vpFilterBandTask<Filter>(filter, r, std::min(height, r + band)));
+  }
+  std::vector<vpThreadPool::vpTask *> tasks(bandTasks.size());
+  for (size_t i = 0; i < bandTasks.size(); i++) {
+    tasks[i] = &bandTasks[i];
+  }
+  pool.run(tasks);
+}
+
+template <typename Tin, typename T>
+void separableFilter(const vpImage<Tin> &I, vpImage<T> &If, const vpKernel1D<T> &kernelH,
+                     const vpKernel1D<T> &kernelV, bool verticalFirst = false)
+{
+  If.resize(I.getHeight(), I.getWidth());
+  vpSeparableFilter<Tin, T> filter(I, If, kernelH, kernelV, verticalFirst);
+  filterImage(filter, I.getHeight(), I.getWidth());
+}
+
+template <typename Tin, typename T>
+void gaussianGradient(const vpImage<Tin> &I, vpImage<T> &dIx, vpImage<T> &dIy, const T *gaussianKernel,
+                      const T *gaussianDerivativeKernel, unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth());
+  dIy.resize(I.getHeight(), I.getWidth());
+  vpGaussianGradientFilter<Tin, T> filter(I, dIx, dIy, vpKernel1D<T>(KERNEL_SYMMETRIC, gaussianKernel, size),
+                                          vpKernel1D<T>(KERNEL_ANTISYMMETRIC, gaussianDerivativeKernel, size));
+  filterImage(filter, I.getHeight(), I.getWidth());
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Apply a filter to an image.
   \param I : Image to filter
@@ -321,101 +1010,146 @@ void vpImageFilter::canny(const vpImage<unsigned char> &Isrc, vpImage<unsigned c
 #endif
 
 /*!
-  Apply a separable filter.
+  Apply a separable filter: the image is filtered along X, then along Y with
+  the same kernel.
+
+  The rows filtered along X are kept in a buffer of \e size rows from which
+  the rows filtered along Y are computed, so that the intermediate image is
+  never stored. Several pixels are filtered at once with SSE2 or AVX2
+  instructions when the CPU supports them, and large images are split by
+  bands of rows over the threads of vpThreadPool. The result is the same as
+  the one given by filterX() followed by filterY().
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param filter : Kernel of (size+1)/2 coefficients, the first one being the
+  central coefficient, the next ones the right coefficients. The left
+  coefficients are deduced by symmetry.
+  \param size : Kernel size. This value should be odd.
  */
 void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<double> &GI, const double *filter,
                            unsigned int size)
 {
-  vpImage<double> GIx;
-  filterX(I, GIx, filter, size);
-  filterY(GIx, GI, filter, size);
-  GIx.destroy();
+  separableFilter(I, GI, vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size),
+                  vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size));
 }
 
 /*!
-  Apply a separable filter.
+  \overload
  */
 void vpImageFilter::filter(const vpImage<double> &I, vpImage<double> &GI, const double *filter, unsigned int size)
 {
-  vpImage<double> GIx;
-  filterX(I, GIx, filter, size);
-  filterY(GIx, GI, filter, size);
-  GIx.destroy();
+  separableFilter(I, GI, vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size),
+                  vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size));
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one
+  since twice more pixels are processed by each SIMD instruction.
+ */
+void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<float> &GI, const float *filter, unsigned int size)
+{
+  separableFilter(I, GI, vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size),
+                  vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size));
 }
 
+/*!
+  \overload
+ */
+void vpImageFilter::filter(const vpImage<float> &I, vpImage<float> &GI, const float *filter, unsigned int size)
+{
+  separableFilter(I, GI, vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size),
+                  vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size));
+}
+
+/*!
+  Apply a symmetric filter along X. The image is extended by reflection
+  beyond its left and right borders, as done by filterXLeftBorder() and
+  filterXRightBorder().
+
+  \param I : Input image.
+  \param dIx : Filtered image.
+  \param filter : Kernel of (size+1)/2 coefficients, the first one being the
+  central coefficient.
+  \param size : Kernel size. This value should be odd.
+ */
 void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter,
                             unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-  }
+  separableFilter(I, dIx, vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size), vpKernel1D<double>());
 }
+
+/*!
+  \overload
+ */
 void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
-      // dIx[i][j]=0;
-    }
-  }
+  separableFilter(I, dIx, vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size), vpKernel1D<double>());
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+ */
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                            unsigned int size)
+{
+  separableFilter(I, dIx, vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size), vpKernel1D<float>());
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size)
+{
+  separableFilter(I, dIx, vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size), vpKernel1D<float>());
 }
+
+/*!
+  Apply a symmetric filter along Y. The image is extended by reflection
+  beyond its top and bottom borders, as done by filterYTopBorder() and
+  filterYBottomBorder().
+
+  \param I : Input image.
+  \param dIy : Filtered image.
+  \param filter : Kernel of (size+1)/2 coefficients, the first one being the
+  central coefficient.
+  \param size : Kernel size. This value should be odd.
+ */
 void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
                             unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
-    }
-  }
+  separableFilter(I, dIy, vpKernel1D<double>(), vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size));
 }
+
+/*!
+  \overload
+ */
 void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
-    }
-  }
+  separableFilter(I, dIy, vpKernel1D<double>(), vpKernel1D<double>(KERNEL_SYMMETRIC, filter, size));
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+ */
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                            unsigned int size)
+{
+  separableFilter(I, dIy, vpKernel1D<float>(), vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size));
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size)
+{
+  separableFilter(I, dIy, vpKernel1D<float>(), vpKernel1D<float>(KERNEL_SYMMETRIC, filter, size));
 }
 
 /*!
@@ -432,13 +1166,9 @@ void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double> &dIy, cons
 void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double> &GI, unsigned int size, double sigma,
                                  bool normalize)
 {
-  double *fg = new double[(size + 1) / 2];
-  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize);
-  vpImage<double> GIx;
-  vpImageFilter::filterX(I, GIx, fg, size);
-  vpImageFilter::filterY(GIx, GI, fg, size);
-  GIx.destroy();
-  delete[] fg;
+  std::vector<double> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize);
+  vpImageFilter::filter(I, GI, &fg[0], size);
 }
 
 /*!
@@ -455,13 +1185,63 @@ void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double
 void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double> &GI, unsigned int size, double sigma,
                                  bool normalize)
 {
-  double *fg = new double[(size + 1) / 2];
-  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize);
-  vpImage<double> GIx;
-  vpImageFilter::filterX(I, GIx, fg, size);
-  vpImageFilter::filterY(GIx, GI, fg, size);
-  GIx.destroy();
-  delete[] fg;
+  std::vector<double> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize);
+  vpImageFilter::filter(I, GI, &fg[0], size);
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<float> &GI, unsigned int size, double sigma,
+                                 bool normalize)
+{
+  std::vector<float> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize);
+  vpImageFilter::filter(I, GI, &fg[0], size);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::gaussianBlur(const vpImage<float> &I, vpImage<float> &GI, unsigned int size, double sigma,
+                                 bool normalize)
+{
+  std::vector<float> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize);
+  vpImageFilter::filter(I, GI, &fg[0], size);
+}
+
+/*!
+  Apply a Gaussian blur to an image and round the result to 8-bit values.
+
+  The image is filtered with 16-bit fixed-point arithmetic: the rows blurred
+  along X are stored as 16-bit integers with 7 fractional bits, and blurred
+  along Y with 32-bit accumulators. The kernels are quantized so that their
+  coefficients sum to exactly 1, and a uniform image is thus left unchanged.
+  Each pixel differs by at most one grey level from the rounded result of
+  gaussianBlur(const vpImage<unsigned char> &, vpImage<double> &, unsigned int, double, bool),
+  which makes this version well suited to build image pyramids.
+
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or
+  negative, it is computed from filter size as sigma = (size-1)/6.
+
+  \exception vpImageException::incorrectInitializationError : If the kernel
+  is too flat to be quantized with positive coefficients.
+ */
+void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI, unsigned int size,
+                                 double sigma)
+{
+  std::vector<double> fg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, true);
+  GI.resize(I.getHeight(), I.getWidth());
+  vpFixedPointGaussianFilter filter(I, GI, &fg[0], size);
+  filterImage(filter, I.getHeight(), I.getWidth());
 }
 
 /*!
@@ -543,6 +1323,32 @@ void vpImageFilter::getGaussianDerivativeKernel(double *filter, unsigned int siz
   }
 }
 
+/*!
+  \overload
+
+  The coefficients are computed in double precision and rounded to single
+  precision.
+*/
+void vpImageFilter::getGaussianKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<double> filter_d((size + 1) / 2);
+  getGaussianKernel(&filter_d[0], size, sigma, normalize);
+  std::copy(filter_d.begin(), filter_d.end(), filter);
+}
+
+/*!
+  \overload
+
+  The coefficients are computed in double precision and rounded to single
+  precision.
+*/
+void vpImageFilter::getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma, bool normalize)
+{
+  std::vector<double> filter_d((size + 1) / 2);
+  getGaussianDerivativeKernel(&filter_d[0], size, sigma, normalize);
+  std::copy(filter_d.begin(), filter_d.end(), filter);
+}
+
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx)
 {
   dIx.resize(I.getHeight(), I.getWidth());
@@ -581,83 +1387,94 @@ void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double> &d
   }
 }
 
+/*!
+  Compute the derivative along X of an image:
+  \f[ dIx(r, c) = \sum_{i=1}^{(size-1)/2} filter[i] \left( I(r, c + i) - I(r, c - i) \right) \f]
+  as done by derivativeFilterX(). The (size-1)/2 first and last columns of
+  \e dIx are set to 0.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param filter : Derivative kernel of (size+1)/2 coefficients, as given by
+  getGaussianDerivativeKernel().
+  \param size : Kernel size. This value should be odd.
+*/
 void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter,
                              unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  //#pragma omp parallel for
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = 0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = 0;
-    }
-  }
+  separableFilter(I, dIx, vpKernel1D<double>(KERNEL_ANTISYMMETRIC, filter, size), vpKernel1D<double>());
 }
+
+/*!
+  \overload
+*/
 void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
 {
-  dIx.resize(I.getHeight(), I.getWidth());
-  // dIx=0;
-  for (unsigned int i = 0; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
-      dIx[i][j] = 0;
-    }
-    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
-      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
-    }
-    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
-      dIx[i][j] = 0;
-    }
-  }
+  separableFilter(I, dIx, vpKernel1D<double>(KERNEL_ANTISYMMETRIC, filter, size), vpKernel1D<double>());
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+*/
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *filter,
+                             unsigned int size)
+{
+  separableFilter(I, dIx, vpKernel1D<float>(KERNEL_ANTISYMMETRIC, filter, size), vpKernel1D<float>());
+}
+
+/*!
+  \overload
+*/
+void vpImageFilter::getGradX(const vpImage<float> &I, vpImage<float> &dIx, const float *filter, unsigned int size)
+{
+  separableFilter(I, dIx, vpKernel1D<float>(KERNEL_ANTISYMMETRIC, filter, size), vpKernel1D<float>());
 }
 
+/*!
+  Compute the derivative along Y of an image:
+  \f[ dIy(r, c) = \sum_{i=1}^{(size-1)/2} filter[i] \left( I(r + i, c) - I(r - i, c) \right) \f]
+  as done by derivativeFilterY(). The (size-1)/2 first and last rows of
+  \e dIy are set to 0.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param filter : Derivative kernel of (size+1)/2 coefficients, as given by
+  getGaussianDerivativeKernel().
+  \param size : Kernel size. This value should be odd.
+*/
 void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *filter,
                              unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  //#pragma omp parallel for
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
+  separableFilter(I, dIy, vpKernel1D<double>(), vpKernel1D<double>(KERNEL_ANTISYMMETRIC, filter, size));
 }
 
+/*!
+  \overload
+*/
 void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
 {
-  dIy.resize(I.getHeight(), I.getWidth());
-  // dIy=0;
-  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
-  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
-    }
-  }
-  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
-    for (unsigned int j = 0; j < I.getWidth(); j++) {
-      dIy[i][j] = 0;
-    }
-  }
+  separableFilter(I, dIy, vpKernel1D<double>(), vpKernel1D<double>(KERNEL_ANTISYMMETRIC, filter, size));
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+*/
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *filter,
+                             unsigned int size)
+{
+  separableFilter(I, dIy, vpKernel1D<float>(), vpKernel1D<float>(KERNEL_ANTISYMMETRIC, filter, size));
+}
+
+/*!
+  \overload
+*/
+void vpImageFilter::getGradY(const vpImage<float> &I, vpImage<float> &dIy, const float *filter, unsigned int size)
+{
+  separableFilter(I, dIy, vpKernel1D<float>(), vpKernel1D<float>(KERNEL_ANTISYMMETRIC, filter, size));
 }
 
 /*!
@@ -669,13 +1486,26 @@ void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double> &dIy, con
    Gaussian derivative kernel which values should be computed using
    vpImageFilter::getGaussianDerivativeKernel(). \param size : Size of the
    Gaussian and Gaussian derivative kernels.
+
+   \sa getGradXYGauss2D() to compute the gradients along X and Y at once.
  */
 void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *gaussianKernel,
                                     const double *gaussianDerivativeKernel, unsigned int size)
 {
-  vpImage<double> GIy;
-  vpImageFilter::filterY(I, GIy, gaussianKernel, size);
-  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size);
+  separableFilter(I, dIx, vpKernel1D<double>(KERNEL_ANTISYMMETRIC, gaussianDerivativeKernel, size),
+                  vpKernel1D<double>(KERNEL_SYMMETRIC, gaussianKernel, size), true);
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+*/
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIx, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size)
+{
+  separableFilter(I, dIx, vpKernel1D<float>(KERNEL_ANTISYMMETRIC, gaussianDerivativeKernel, size),
+                  vpKernel1D<float>(KERNEL_SYMMETRIC, gaussianKernel, size), true);
 }
 
 /*!
@@ -687,13 +1517,60 @@ void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<dou
    Gaussian derivative kernel which values should be computed using
    vpImageFilter::getGaussianDerivativeKernel(). \param size : Size of the
    Gaussian and Gaussian derivative kernels.
+
+   \sa getGradXYGauss2D() to compute the gradients along X and Y at once.
  */
 void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIy, const double *gaussianKernel,
                                     const double *gaussianDerivativeKernel, unsigned int size)
 {
-  vpImage<double> GIx;
-  vpImageFilter::filterX(I, GIx, gaussianKernel, size);
-  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
+  separableFilter(I, dIy, vpKernel1D<double>(KERNEL_SYMMETRIC, gaussianKernel, size),
+                  vpKernel1D<double>(KERNEL_ANTISYMMETRIC, gaussianDerivativeKernel, size));
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+*/
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIy, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size)
+{
+  separableFilter(I, dIy, vpKernel1D<float>(KERNEL_SYMMETRIC, gaussianKernel, size),
+                  vpKernel1D<float>(KERNEL_ANTISYMMETRIC, gaussianDerivativeKernel, size));
+}
+
+/*!
+   Compute the gradients along X and Y of an image blurred by a gaussian
+   filter. The result is the same as the one of getGradXGauss2D() and
+   getGradYGauss2D(), but the input image is read and converted only once,
+   and each of its rows is blurred along X only once.
+
+   \param I : Input image
+   \param dIx : Gradient along X.
+   \param dIy : Gradient along Y.
+   \param gaussianKernel : Gaussian kernel which values should be computed
+   using vpImageFilter::getGaussianKernel().
+   \param gaussianDerivativeKernel : Gaussian derivative kernel which values
+   should be computed using vpImageFilter::getGaussianDerivativeKernel().
+   \param size : Size of the Gaussian and Gaussian derivative kernels.
+ */
+void vpImageFilter::getGradXYGauss2D(const vpImage<unsigned char> &I, vpImage<double> &dIx, vpImage<double> &dIy,
+                                     const double *gaussianKernel, const double *gaussianDerivativeKernel,
+                                     unsigned int size)
+{
+  gaussianGradient(I, dIx, dIy, gaussianKernel, gaussianDerivativeKernel, size);
+}
+
+/*!
+  \overload
+
+  Single precision version, about twice faster than the double precision one.
+*/
+void vpImageFilter::getGradXYGauss2D(const vpImage<unsigned char> &I, vpImage<float> &dIx, vpImage<float> &dIy,
+                                     const float *gaussianKernel, const float *gaussianDerivativeKernel,
+                                     unsigned int size)
+{
+  gaussianGradient(I, dIx, dIy, gaussianKernel, gaussianDerivativeKernel, size);
 }
 
 // operation pour pyramide gaussienne
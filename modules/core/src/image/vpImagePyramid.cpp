@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pyramid of images with persistent buffers.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+namespace
+{
+class vpImagePyramidTask : public vpThreadPool::vpTask
+{
+public:
+  vpImagePyramidTask(const vpImage<unsigned char> *I, const std::vector<bool> *levels, vpImagePyramid *pyramid)
+    : m_I(I), m_levels(levels), m_pyramid(pyramid)
+  {
+  }
+
+  virtual void run() { m_pyramid->build(*m_I, *m_levels); }
+
+private:
+  const vpImage<unsigned char> *m_I;
+  const std::vector<bool> *m_levels;
+  vpImagePyramid *m_pyramid;
+};
+}
+
+/*!
+  Default constructor. The pyramid is empty.
+*/
+vpImagePyramid::vpImagePyramid() : m_base(NULL), m_levels(), m_isBuilt() {}
+
+/*!
+  Build all the \e nbLevels levels of the pyramid of \e I.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, const unsigned int nbLevels)
+{
+  build(I, std::vector<bool>(nbLevels, true));
+}
+
+/*!
+  Build the pyramid of \e I. Only the levels \e i such as \e levels[i] is true
+  are available with getLevel(), the intermediate levels are computed but not
+  exposed.
+
+  \param I : Input image, used as level 0 without copy.
+  \param levels : Flag for each level of the pyramid.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, const std::vector<bool> &levels)
+{
+  m_base = &I;
+  m_isBuilt = levels;
+
+  // The levels above the last requested one are not computed
+  size_t nbLevels = levels.size();
+  while (nbLevels > 1 && !levels[nbLevels - 1]) {
+    nbLevels--;
+  }
+
+  if (nbLevels > 1 && m_levels.size() < nbLevels - 1) {
+    m_levels.resize(nbLevels - 1);
+  }
+
+  const vpImage<unsigned char> *src = &I;
+  for (size_t i = 1; i < nbLevels; i++) {
+    downScale2(*src, m_levels[i - 1]);
+    src = &m_levels[i - 1];
+  }
+}
+
+/*!
+  Build in parallel the pyramids of several images, typically one per camera
+  of a multi-camera tracker, with the tasks of vpThreadPool::getInstance().
+
+  \param images : Input images.
+  \param levels : Flag for each level of the pyramids.
+  \param pyramids : Pyramids to build, one per image.
+*/
+void vpImagePyramid::build(const std::vector<const vpImage<unsigned char> *> &images, const std::vector<bool> &levels,
+                           const std::vector<vpImagePyramid *> &pyramids)
+{
+  if (images.size() != pyramids.size()) {
+    throw(vpException(vpException::dimensionError, "The number of images (%d) and of pyramids (%d) differ",
+                      (int)images.size(), (int)pyramids.size()));
+  }
+
+  std::vector<vpImagePyramidTask> pyramidTasks;
+  pyramidTasks.reserve(images.size());
+  for (size_t i = 0; i < images.size(); i++) {
+    pyramidTasks.push_back(vpImagePyramidTask(images[i], &levels, pyramids[i]));
+  }
+
+  std::vector<vpThreadPool::vpTask *> tasks(pyramidTasks.size());
+  for (size_t i = 0; i < pyramidTasks.size(); i++) {
+    tasks[i] = &pyramidTasks[i];
+  }
+  vpThreadPool::getInstance().run(tasks);
+}
+
+/*!
+  Release the buffers of the levels.
+*/
+void vpImagePyramid::clear()
+{
+  m_base = NULL;
+  m_levels.clear();
+  m_isBuilt.clear();
+}
+
+/*!
+  Reduce the size of \e src by 2 with anti-aliasing. Each pixel of \e dst is
+  the rounded average of a block of 2x2 pixels of \e src, computed as the
+  average of the two vertical averages:
+  \f[ dst(i,j) = \frac{1}{2} \left( \frac{s_{2i,2j} + s_{2i+1,2j} + 1}{2} +
+  \frac{s_{2i,2j+1} + s_{2i+1,2j+1} + 1}{2} + 1 \right) \f]
+  with integer divisions.
+  The last row or column of \e src is ignored if its size is odd. The buffer
+  of \e dst is reused if it already has the right size.
+*/
+void vpImagePyramid::downScale2(const vpImage<unsigned char> &src, vpImage<unsigned char> &dst)
+{
+  const unsigned int height = src.getHeight() / 2, width = src.getWidth() / 2;
+  dst.resize(height, width);
+
+  for (unsigned int i = 0; i < height; i++) {
+    const unsigned char *src0 = src[2 * i];
+    const unsigned char *src1 = src[2 * i + 1];
+    unsigned char *d = dst[i];
+    unsigned int j = 0;
+
+#if VISP_HAVE_SSE2
+    if (vpCPUFeatures::checkSSE2() && width >= 16) {
+      const __m128i mask = _mm_set1_epi16(0x00FF);
+      for (; j <= width - 16; j += 16) {
+        const __m128i v0 = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(src0 + 2 * j)),
+                                        _mm_loadu_si128((const __m128i *)(src1 + 2 * j)));
+        const __m128i v1 = _mm_avg_epu8(_mm_loadu_si128((const __m128i *)(src0 + 2 * j + 16)),
+                                        _mm_loadu_si128((const __m128i *)(src1 + 2 * j + 16)));
+        const __m128i h0 = _mm_avg_epu16(_mm_and_si128(v0, mask), _mm_srli_epi16(v0, 8));
+        const __m128i h1 = _mm_avg_epu16(_mm_and_si128(v1, mask), _mm_srli_epi16(v1, 8));
+        _mm_storeu_si128((__m128i *)(d + j), _mm_packus_epi16(h0, h1));
+      }
+    }
+#endif
+
+    for (; j < width; j++) {
+      const unsigned int a = (src0[2 * j] + src1[2 * j] + 1) >> 1;
+      const unsigned int b = (src0[2 * j + 1] + src1[2 * j + 1] + 1) >> 1;
+      d[j] = (unsigned char)((a + b + 1) >> 1);
+    }
+  }
+}
+
+/*!
+  Return the image of the pyramid at \e level, or NULL if the level was not
+  requested by the last build.
+*/
+const vpImage<unsigned char> *vpImagePyramid::getLevel(const unsigned int level) const
+{
+  if (level >= m_isBuilt.size() || !m_isBuilt[level]) {
+    return NULL;
+  }
+  return level == 0 ? m_base : &m_levels[level - 1];
+}
+
+/*!
+  Get the pointers to all the levels of the pyramid, NULL for the levels that
+  were not requested by the last build.
+*/
+void vpImagePyramid::getLevels(std::vector<const vpImage<unsigned char> *> &pyramid) const
+{
+  pyramid.resize(m_isBuilt.size());
+  for (unsigned int i = 0; i < pyramid.size(); i++) {
+    pyramid[i] = getLevel(i);
+  }
+}
@@ -0,0 +1,392 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed look-up table to undistort images.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageUndistortMap.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+namespace
+{
+// Precision of the interpolation weights
+const int vpUndistortWeightBits = 7;
+const int vpUndistortWeightOne = 1 << vpUndistortWeightBits;
+// Rounding term of the final shift, weights being the product of two weights
+const int vpUndistortRound = 1 << (2 * vpUndistortWeightBits - 1);
+
+#if VISP_HAVE_SSE2
+/*
+  Insert in the lane l of t and b the top and bottom pixel pairs of the
+  2x2 neighbourhood of the pixel l. Pixels outside the image read the first
+  pixel of the image, the result is masked afterwards.
+*/
+template <int l>
+inline void vp_gather(const unsigned char *src, unsigned int width, const int *offset, __m128i &t, __m128i &b)
+{
+  const int o = offset[l] & ~(offset[l] >> 31);
+  t = _mm_insert_epi16(t, src[o] | (src[o + 1] << 8), l);
+  b = _mm_insert_epi16(b, src[o + width] | (src[o + width + 1] << 8), l);
+}
+#endif
+
+/*
+  Bilinear interpolation of nbPixels consecutive pixels of the destination
+  image. The horizontal interpolation is computed first, its result fits in
+  16 bits.
+*/
+void vp_remapPixels(const unsigned char *src, unsigned int width, const int *offset, const short *du, const short *dv,
+                    unsigned char *dst, size_t nbPixels)
+{
+  size_t k = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128i one = _mm_set1_epi16(vpUndistortWeightOne);
+    const __m128i mask = _mm_set1_epi16(0xFF);
+    const __m128i round = _mm_set1_epi32(vpUndistortRound);
+    const __m128i minusOne = _mm_set1_epi32(-1);
+
+    for (; k + 8 <= nbPixels; k += 8) {
+      // Gather the 2x2 neighbourhoods, the left pixel in the low byte
+      __m128i t = _mm_setzero_si128(), b = _mm_setzero_si128();
+      vp_gather<0>(src, width, offset + k, t, b);
+      vp_gather<1>(src, width, offset + k, t, b);
+      vp_gather<2>(src, width, offset + k, t, b);
+      vp_gather<3>(src, width, offset + k, t, b);
+      vp_gather<4>(src, width, offset + k, t, b);
+      vp_gather<5>(src, width, offset + k, t, b);
+      vp_gather<6>(src, width, offset + k, t, b);
+      vp_gather<7>(src, width, offset + k, t, b);
+      const __m128i valid =
+          _mm_packs_epi32(_mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(offset + k)), minusOne),
+                          _mm_cmpgt_epi32(_mm_loadu_si128((const __m128i *)(offset + k + 4)), minusOne));
+
+      const __m128i wu = _mm_loadu_si128((const __m128i *)(du + k));
+      const __m128i wv = _mm_loadu_si128((const __m128i *)(dv + k));
+      const __m128i iwu = _mm_sub_epi16(one, wu);
+      const __m128i iwv = _mm_sub_epi16(one, wv);
+
+      const __m128i h0 =
+          _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(t, mask), iwu), _mm_mullo_epi16(_mm_srli_epi16(t, 8), wu));
+      const __m128i h1 =
+          _mm_add_epi16(_mm_mullo_epi16(_mm_and_si128(b, mask), iwu), _mm_mullo_epi16(_mm_srli_epi16(b, 8), wu));
+
+      __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(h0, h1), _mm_unpacklo_epi16(iwv, wv));
+      __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(h0, h1), _mm_unpackhi_epi16(iwv, wv));
+      lo = _mm_srai_epi32(_mm_add_epi32(lo, round), 2 * vpUndistortWeightBits);
+      hi = _mm_srai_epi32(_mm_add_epi32(hi, round), 2 * vpUndistortWeightBits);
+
+      const __m128i res = _mm_and_si128(_mm_packs_epi32(lo, hi), valid);
+      _mm_storel_epi64((__m128i *)(dst + k), _mm_packus_epi16(res, res));
+    }
+  }
+#endif
+
+  for (; k < nbPixels; k++) {
+    const int o = offset[k];
+    if (o < 0) {
+      dst[k] = 0;
+      continue;
+    }
+    const int wu = du[k], wv = dv[k];
+    const int h0 = src[o] * (vpUndistortWeightOne - wu) + src[o + 1] * wu;
+    const int h1 = src[o + width] * (vpUndistortWeightOne - wu) + src[o + width + 1] * wu;
+    dst[k] = (unsigned char)((h0 * (vpUndistortWeightOne - wv) + h1 * wv + vpUndistortRound) >>
+                             (2 * vpUndistortWeightBits));
+  }
+}
+
+/*
+  Same as above for RGBa pixels, the four channels being interpolated
+  together.
+*/
+void vp_remapPixels(const vpRGBa *src, unsigned int width, const int *offset, const short *du, const short *dv,
+                    vpRGBa *dst, size_t nbPixels)
+{
+  size_t k = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2()) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i round = _mm_set1_epi32(vpUndistortRound);
+
+    for (; k < nbPixels; k++) {
+      const int o = offset[k];
+      if (o < 0) {
+        dst[k] = 0;
+        continue;
+      }
+
+      // The 2 pixels of a row are contiguous, interleave their channels
+      __m128i t = _mm_loadl_epi64((const __m128i *)(src + o));
+      __m128i b = _mm_loadl_epi64((const __m128i *)(src + o + width));
+      t = _mm_unpacklo_epi8(_mm_unpacklo_epi8(t, _mm_srli_si128(t, 4)), zero);
+      b = _mm_unpacklo_epi8(_mm_unpacklo_epi8(b, _mm_srli_si128(b, 4)), zero);
+
+      const __m128i wu = _mm_set1_epi32((du[k] << 16) | (vpUndistortWeightOne - du[k]));
+      const __m128i wv = _mm_set1_epi32((dv[k] << 16) | (vpUndistortWeightOne - dv[k]));
+
+      // Top and bottom horizontal interpolations, then interleaved per channel
+      const __m128i h = _mm_packs_epi32(_mm_madd_epi16(t, wu), _mm_madd_epi16(b, wu));
+      __m128i res = _mm_madd_epi16(_mm_unpacklo_epi16(h, _mm_srli_si128(h, 8)), wv);
+      res = _mm_srai_epi32(_mm_add_epi32(res, round), 2 * vpUndistortWeightBits);
+      res = _mm_packs_epi32(res, res);
+      // SSE2 targets are little-endian: the first channel is the low byte
+      const unsigned int v = (unsigned int)_mm_cvtsi128_si32(_mm_packus_epi16(res, res));
+      const vpRGBa rgba((unsigned char)v, (unsigned char)(v >> 8), (unsigned char)(v >> 16), (unsigned char)(v >> 24));
+      dst[k] = rgba;
+    }
+  }
+#endif
+
+  for (; k < nbPixels; k++) {
+    const int o = offset[k];
+    if (o < 0) {
+      dst[k] = 0;
+      continue;
+    }
+    const int wu = du[k], wv = dv[k];
+    const unsigned char *p0 = (const unsigned char *)(src + o);
+    const unsigned char *p1 = (const unsigned char *)(src + o + width);
+    unsigned char *d = (unsigned char *)(dst + k);
+    for (int c = 0; c < 4; c++) {
+      const int h0 = p0[c] * (vpUndistortWeightOne - wu) + p0[c + 4] * wu;
+      const int h1 = p1[c] * (vpUndistortWeightOne - wu) + p1[c + 4] * wu;
+      d[c] = (unsigned char)((h0 * (vpUndistortWeightOne - wv) + h1 * wv + vpUndistortRound) >>
+                             (2 * vpUndistortWeightBits));
+    }
+  }
+}
+
+template <class Type> class vpRemapTask : public vpThreadPool::vpTask
+{
+public:
+  vpRemapTask(const Type *src, unsigned int width, const int *offset, const short *du, const short *dv, Type *dst,
+              size_t nbPixels)
+    : m_src(src), m_width(width), m_offset(offset), m_du(du), m_dv(dv), m_dst(dst), m_nbPixels(nbPixels)
+  {
+  }
+
+  virtual void run() { vp_remapPixels(m_src, m_width, m_offset, m_du, m_dv, m_dst, m_nbPixels); }
+
+private:
+  const Type *m_src;
+  unsigned int m_width;
+  const int *m_offset;
+  const short *m_du;
+  const short *m_dv;
+  Type *m_dst;
+  size_t m_nbPixels;
+};
+}
+
+/*!
+  Default constructor. The map is empty and has to be initialized with
+  init().
+*/
+vpImageUndistortMap::vpImageUndistortMap()
+  : m_width(0), m_height(0), m_identity(true), m_offset(), m_du(), m_dv()
+{
+}
+
+/*!
+  Build the map of the camera \e cam for images of size \e width x \e height.
+
+  \sa init()
+*/
+vpImageUndistortMap::vpImageUndistortMap(const vpCameraParameters &cam, const unsigned int width,
+                                         const unsigned int height, const vpMapDirection direction)
+  : m_width(0), m_height(0), m_identity(true), m_offset(), m_du(), m_dv()
+{
+  init(cam, width, height, direction);
+}
+
+/*!
+  Build the map of the camera \e cam for images of size \e width x \e height.
+
+  With the UNDISTORT direction, the pixel \f$ (u, v) \f$ of the undistorted
+  image is interpolated in the input image at
+  \f[ u_d = u_0 + (u - u_0)(1 + k_{ud} r^2), \quad v_d = v_0 + (v - v_0)(1 + k_{ud} r^2) \f]
+  with \f$ r^2 = ((u - u_0) / p_x)^2 + ((v - v_0) / p_y)^2 \f$. The DISTORT
+  direction uses \f$ k_{du} \f$ instead to add the distortion to an
+  undistorted image. The pixels whose 2x2 neighbourhood is not fully inside
+  the input image are set to 0.
+
+  \param cam : Camera parameters with distortion.
+  \param width, height : Size of the images to remap.
+  \param direction : Direction of the transformation.
+*/
+void vpImageUndistortMap::init(const vpCameraParameters &cam, const unsigned int width, const unsigned int height,
+                               const vpMapDirection direction)
+{
+  m_width = width;
+  m_height = height;
+
+  const double k = (direction == UNDISTORT) ? cam.get_kud() : cam.get_kdu();
+  m_identity = (std::fabs(k) <= std::numeric_limits<double>::epsilon());
+  if (m_identity) {
+    // There is no need to remap the images
+    m_offset.clear();
+    m_du.clear();
+    m_dv.clear();
+    return;
+  }
+
+  const size_t size = (size_t)width * height;
+  m_offset.resize(size);
+  m_du.resize(size);
+  m_dv.resize(size);
+
+  const double u0 = cam.get_u0();
+  const double v0 = cam.get_v0();
+  const double k_px2 = k / (cam.get_px() * cam.get_px());
+  const double k_py2 = k / (cam.get_py() * cam.get_py());
+
+  size_t idx = 0;
+  for (unsigned int v = 0; v < height; v++) {
+    const double deltav = v - v0;
+    const double fr1 = 1.0 + k_py2 * deltav * deltav;
+
+    for (unsigned int u = 0; u < width; u++, idx++) {
+      const double deltau = u - u0;
+      const double fr2 = fr1 + k_px2 * deltau * deltau;
+
+      const double u_double = deltau * fr2 + u0;
+      const double v_double = deltav * fr2 + v0;
+      const int u_round = (int)std::floor(u_double);
+      const int v_round = (int)std::floor(v_double);
+
+      if (u_round >= 0 && v_round >= 0 && u_round < (int)width - 1 && v_round < (int)height - 1) {
+        m_offset[idx] = v_round * (int)width + u_round;
+        m_du[idx] = (short)((u_double - u_round) * vpUndistortWeightOne + 0.5);
+        m_dv[idx] = (short)((v_double - v_round) * vpUndistortWeightOne + 0.5);
+      } else {
+        m_offset[idx] = -1;
+        m_du[idx] = 0;
+        m_dv[idx] = 0;
+      }
+    }
+  }
+}
+
+/*!
+  Undistort (or distort, depending on the direction given to init()) the
+  grayscale image \e I.
+
+  \param I : Input image, of the size given to init().
+  \param Iundist : Output image, resized to the size of \e I.
+
+  \exception vpException::dimensionError If the size of \e I differs from
+  the size of the map.
+*/
+void vpImageUndistortMap::remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Iundist) const
+{
+  remapImage(I, Iundist);
+}
+
+/*!
+  Undistort (or distort, depending on the direction given to init()) the
+  color image \e I. The four channels, alpha included, are interpolated.
+
+  \param I : Input image, of the size given to init().
+  \param Iundist : Output image, resized to the size of \e I.
+
+  \exception vpException::dimensionError If the size of \e I differs from
+  the size of the map.
+*/
+void vpImageUndistortMap::remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Iundist) const
+{
+  remapImage(I, Iundist);
+}
+
+template <class Type> void vpImageUndistortMap::remapImage(const vpImage<Type> &I, vpImage<Type> &Iundist) const
+{
+  if (I.getWidth() != m_width || I.getHeight() != m_height) {
+    throw(vpException(vpException::dimensionError, "Cannot remap a %dx%d image with a %dx%d map", I.getWidth(),
+                      I.getHeight(), m_width, m_height));
+  }
+
+  if (m_identity) {
+    Iundist = I;
+    return;
+  }
+
+  if (&I == &Iundist) {
+    vpImage<Type> Icopy(I);
+    remapImage(Icopy, Iundist);
+    return;
+  }
+
+  Iundist.resize(m_height, m_width);
+  if (m_height < 2 || m_width < 2) {
+    // No pixel has a 2x2 neighbourhood inside the image
+    for (unsigned int i = 0; i < Iundist.getSize(); i++) {
+      Iundist.bitmap[i] = 0;
+    }
+    return;
+  }
+
+  // Bands of rows, the calling thread processing one of them
+  vpThreadPool &pool = vpThreadPool::getInstance();
+  const unsigned int nbBands = (std::min)(pool.getNbThreads() + 1, m_height);
+  if (nbBands == 1) {
+    vp_remapPixels(I.bitmap, m_width, &m_offset[0], &m_du[0], &m_dv[0], Iundist.bitmap, m_offset.size());
+    return;
+  }
+
+  std::vector<vpRemapTask<Type> > bandTasks;
+  bandTasks.reserve(nbBands);
+  for (unsigned int i = 0; i < nbBands; i++) {
+    const size_t begin = (size_t)(m_height * i / nbBands) * m_width;
+    const size_t end = (size_t)(m_height * (i + 1) / nbBands) * m_width;
+    bandTasks.push_back(vpRemapTask<Type>(I.bitmap, m_width, &m_offset[begin], &m_du[begin], &m_dv[begin],
+                                          Iundist.bitmap + begin, end - begin));
+  }
+
+  std::vector<vpThreadPool::vpTask *> tasks(bandTasks.size());
+  for (size_t i = 0; i < bandTasks.size(); i++) {
+    tasks[i] = &bandTasks[i];
+  }
+  pool.run(tasks);
+}
@@ -483,37 +483,19 @@ void vpMatrix::AtA(vpMatrix &B) const
     B.resize(colNum, colNum, false, false);
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
-  double alpha = 1.0;
-  double beta = 0.0;
-  char transa = 'n';
-  char transb = 't';
-
-  vpMatrix::blas_dgemm(transa, transb, colNum, colNum, rowNum, alpha, data, colNum, data, colNum, beta, B.data, colNum);
-#else
-  unsigned int i, j, k;
-  double s;
-  double *ptr;
-  for (i = 0; i < colNum; i++) {
-    double *Bi = B[i];
-    for (j = 0; j < i; j++) {
-      ptr = data;
-      s = 0;
-      for (k = 0; k < rowNum; k++) {
-        s += (*(ptr + i)) * (*(ptr + j));
-        ptr += colNum;
-      }
-      *Bi++ = s;
-      B[j][i] = s;
-    }
-    ptr = data;
-    s = 0;
-    for (k = 0; k < rowNum; k++) {
-      s += (*(ptr + i)) * (*(ptr + i));
-      ptr += colNum;
-    }
-    *Bi = s;
+  if (rowNum >= m_lapack_min_size && colNum >= m_lapack_min_size) {
+    double alpha = 1.0;
+    double beta = 0.0;
+    char transa = 'n';
+    char transb = 't';
+
+    vpMatrix::blas_dgemm(transa, transb, colNum, colNum, rowNum, alpha, data, colNum, data, colNum, beta, B.data,
+                         colNum);
+    return;
   }
 #endif
+
+  syrk(rowNum, colNum, data, B.data);
 }
 
 /*!
@@ -814,29 +796,18 @@ void vpMatrix::mult2Matrices(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
   }
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
-  double alpha = 1.0;
-  double beta = 0.0;
-  char trans = 'n';
+  if (A.rowNum >= m_lapack_min_size && A.colNum >= m_lapack_min_size && B.colNum >= m_lapack_min_size) {
+    double alpha = 1.0;
+    double beta = 0.0;
+    char trans = 'n';
 
-  vpMatrix::blas_dgemm(trans, trans, B.colNum, A.rowNum, A.colNum, alpha, B.data, B.colNum, A.data, A.colNum, beta,
-                       C.data, B.colNum);
-#else
-  // 5/12/06 some "very" simple optimization to avoid indexation
-  unsigned int BcolNum = B.colNum;
-  unsigned int BrowNum = B.rowNum;
-  unsigned int i, j, k;
-  double **BrowPtrs = B.rowPtrs;
-  for (i = 0; i < A.rowNum; i++) {
-    double *rowptri = A.rowPtrs[i];
-    double *ci = C[i];
-    for (j = 0; j < BcolNum; j++) {
-      double s = 0;
-      for (k = 0; k < BrowNum; k++)
-        s += rowptri[k] * BrowPtrs[k][j];
-      ci[j] = s;
-    }
+    vpMatrix::blas_dgemm(trans, trans, B.colNum, A.rowNum, A.colNum, alpha, B.data, B.colNum, A.data, A.colNum, beta,
+                         C.data, B.colNum);
+    return;
   }
 #endif
+
+  gemm(A.rowNum, B.colNum, A.colNum, A.data, A.colNum, B.data, B.colNum, C.data, C.colNum);
 }
 
 /*!
@@ -988,59 +959,19 @@ vpMatrix vpMatrix::operator*(const vpVelocityTwistMatrix &V) const
   M.resize(rowNum, 6, false, false);
 
 #if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
-  double alpha = 1.0;
-  double beta = 0.0;
-  char trans = 'n';
-
-  vpMatrix::blas_dgemm(trans, trans, V.colNum, rowNum, colNum, alpha, V.data, V.colNum, data, colNum, beta, M.data,
-                       V.colNum);
-#else
-  bool checkSSE2 = vpCPUFeatures::checkSSE2();
-#if !USE_SSE
-  checkSSE2 = false;
-#endif
-
-  if (checkSSE2) {
-#if USE_SSE
-    vpMatrix V_trans(6, 6);
-    for (unsigned int i = 0; i < 6; i++) {
-      for (unsigned int j = 0; j < 6; j++) {
-        V_trans[i][j] = V[j][i];
-      }
-    }
-
-    for (unsigned int i = 0; i < rowNum; i++) {
-      double *rowptri = rowPtrs[i];
-      double *ci = M[i];
-
-      for (int j = 0; j < 6; j++) {
-        __m128d v_mul = _mm_setzero_pd();
-        for (int k = 0; k < 6; k += 2) {
-          v_mul = _mm_add_pd(v_mul, _mm_mul_pd(_mm_loadu_pd(&rowptri[k]), _mm_loadu_pd(&V_trans[j][k])));
-        }
-
-        double v_tmp[2];
-        _mm_storeu_pd(v_tmp, v_mul);
-        ci[j] = v_tmp[0] + v_tmp[1];
-      }
-    }
-#endif
-  } else {
-    unsigned int VcolNum = V.getCols();
-    unsigned int VrowNum = V.getRows();
-    for (unsigned int i = 0; i < rowNum; i++) {
-      double *rowptri = rowPtrs[i];
-      double *ci = M[i];
-      for (unsigned int j = 0; j < VcolNum; j++) {
-        double s = 0;
-        for (unsigned int k = 0; k < VrowNum; k++)
-          s += rowptri[k] * V[k][j];
-        ci[j] = s;
-      }
-    }
+  if (rowNum >= m_lapack_min_size && 6 >= m_lapack_min_size) {
+    double alpha = 1.0;
+    double beta = 0.0;
+    char trans = 'n';
+
+    vpMatrix::blas_dgemm(trans, trans, V.colNum, rowNum, colNum, alpha, V.data, V.colNum, data, colNum, beta, M.data,
+                         V.colNum);
+    return M;
   }
 #endif
 
+  gemm(rowNum, 6, 6, data, colNum, V.data, 6, M.data, 6);
+
   return M;
 }
 /*!
@@ -1053,20 +984,10 @@ vpMatrix vpMatrix::operator*(const vpForceTwistMatrix &V) const
     throw(vpException(vpException::dimensionError, "Cannot multiply (%dx%d) matrix by (6x6) force/torque twist matrix",
                       rowNum, colNum));
   }
-  vpMatrix M(rowNum, 6);
+  vpMatrix M;
+  M.resize(rowNum, 6, false, false);
 
-  unsigned int VcolNum = V.getCols();
-  unsigned int VrowNum = V.getRows();
-  for (unsigned int i = 0; i < rowNum; i++) {
-    double *rowptri = rowPtrs[i];
-    double *ci = M[i];
-    for (unsigned int j = 0; j < VcolNum; j++) {
-      double s = 0;
-      for (unsigned int k = 0; k < VrowNum; k++)
-        s += rowptri[k] * V[k][j];
-      ci[j] = s;
-    }
-  }
+  gemm(rowNum, 6, 6, data, colNum, V.data, 6, M.data, 6);
 
   return M;
 }
@@ -0,0 +1,546 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Built-in matrix multiplication kernels.
+ *
+ *****************************************************************************/
+
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpThreadPool.h>
+
+#define USE_SSE_CODE 1
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#if defined __AVX2__
+#include <immintrin.h>
+#define VISP_HAVE_AVX2 1
+#endif
+
+#if VISP_HAVE_SSE2 && USE_SSE_CODE
+#define USE_SSE 1
+#endif
+
+#if VISP_HAVE_AVX2 && USE_SSE_CODE
+#define USE_AVX2 1
+#endif
+
+const unsigned int vpMatrix::m_lapack_min_size_default = 16;
+unsigned int vpMatrix::m_lapack_min_size = vpMatrix::m_lapack_min_size_default;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Rows of the micro-kernels
+const unsigned int gemm_mr = 4;
+// Rows of A, rows of B and columns of B kept packed, sized so that a packed
+// block of A stays in L2 and a micro-panel of B in L1
+const unsigned int gemm_mc = 64;
+const unsigned int gemm_kc = 256;
+const unsigned int gemm_nc = 512;
+// Products smaller than this number of multiply-adds are not worth packing
+const double gemm_small_size = 32. * 32. * 32.;
+// Products larger than this number of multiply-adds are split over the
+// thread pool
+const double gemm_parallel_size = 128. * 128. * 128.;
+
+bool useAVX2()
+{
+#if USE_AVX2
+  static const bool checkAVX2 = vpCPUFeatures::checkAVX2();
+  return checkAVX2;
+#else
+  return false;
+#endif
+}
+
+bool useSSE2()
+{
+#if USE_SSE
+  static const bool checkSSE2 = vpCPUFeatures::checkSSE2();
+  return checkSSE2;
+#else
+  return false;
+#endif
+}
+
+// C = A * B with an i-k-j loop, that reads A, B and C row by row
+void gemmSmall(unsigned int M, unsigned int N, unsigned int K, const double *A, unsigned int lda, const double *B,
+               unsigned int ldb, double *C, unsigned int ldc)
+{
+  for (unsigned int i = 0; i < M; i++) {
+    const double *ai = A + i * lda;
+    double *ci = C + i * ldc;
+    memset(ci, 0, N * sizeof(double));
+    for (unsigned int k = 0; k < K; k++) {
+      const double aik = ai[k];
+      const double *bk = B + k * ldb;
+      for (unsigned int j = 0; j < N; j++) {
+        ci[j] += aik * bk[j];
+      }
+    }
+  }
+}
+
+// C = A * B for a B matrix with 6 columns, as the products by an interaction
+// matrix or a twist matrix
+void gemmN6(unsigned int M, unsigned int K, const double *A, unsigned int lda, const double *B, unsigned int ldb,
+            double *C, unsigned int ldc)
+{
+  unsigned int i = 0;
+  if (useSSE2()) {
+#if USE_SSE
+    // Two rows at a time to share the loads of B
+    for (; i + 1 < M; i += 2) {
+      const double *a0 = A + i * lda, *a1 = a0 + lda;
+      __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd(), c02 = _mm_setzero_pd();
+      __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd(), c12 = _mm_setzero_pd();
+      for (unsigned int k = 0; k < K; k++) {
+        const double *bk = B + k * ldb;
+        const __m128d b0 = _mm_loadu_pd(bk), b1 = _mm_loadu_pd(bk + 2), b2 = _mm_loadu_pd(bk + 4);
+        const __m128d v_a0 = _mm_set1_pd(a0[k]), v_a1 = _mm_set1_pd(a1[k]);
+        c00 = _mm_add_pd(c00, _mm_mul_pd(v_a0, b0));
+        c01 = _mm_add_pd(c01, _mm_mul_pd(v_a0, b1));
+        c02 = _mm_add_pd(c02, _mm_mul_pd(v_a0, b2));
+        c10 = _mm_add_pd(c10, _mm_mul_pd(v_a1, b0));
+        c11 = _mm_add_pd(c11, _mm_mul_pd(v_a1, b1));
+        c12 = _mm_add_pd(c12, _mm_mul_pd(v_a1, b2));
+      }
+      double *ci = C + i * ldc;
+      _mm_storeu_pd(ci, c00);
+      _mm_storeu_pd(ci + 2, c01);
+      _mm_storeu_pd(ci + 4, c02);
+      ci += ldc;
+      _mm_storeu_pd(ci, c10);
+      _mm_storeu_pd(ci + 2, c11);
+      _mm_storeu_pd(ci + 4, c12);
+    }
+#endif
+  }
+
+  for (; i < M; i++) {
+    const double *ai = A + i * lda;
+    double c0 = 0, c1 = 0, c2 = 0, c3 = 0, c4 = 0, c5 = 0;
+    for (unsigned int k = 0; k < K; k++) {
+      const double *bk = B + k * ldb;
+      const double aik = ai[k];
+      c0 += aik * bk[0];
+      c1 += aik * bk[1];
+      c2 += aik * bk[2];
+      c3 += aik * bk[3];
+      c4 += aik * bk[4];
+      c5 += aik * bk[5];
+    }
+    double *ci = C + i * ldc;
+    ci[0] = c0;
+    ci[1] = c1;
+    ci[2] = c2;
+    ci[3] = c3;
+    ci[4] = c4;
+    ci[5] = c5;
+  }
+}
+
+// Copy a mc x kc block of A as strips of gemm_mr rows stored column by
+// column, padded with zeros
+void packA(unsigned int mc, unsigned int kc, const double *A, unsigned int lda, double *Ap)
+{
+  for (unsigned int ir = 0; ir < mc; ir += gemm_mr) {
+    double *strip = Ap + ir * kc;
+    for (unsigned int r = 0; r < gemm_mr; r++) {
+      if (ir + r < mc) {
+        const double *a = A + (ir + r) * lda;
+        for (unsigned int p = 0; p < kc; p++) {
+          strip[p * gemm_mr + r] = a[p];
+        }
+      } else {
+        for (unsigned int p = 0; p < kc; p++) {
+          strip[p * gemm_mr + r] = 0;
+        }
+      }
+    }
+  }
+}
+
+// Copy a kc x nc block of B as strips of nr columns stored row by row,
+// padded with zeros
+void packB(unsigned int kc, unsigned int nc, unsigned int nr, const double *B, unsigned int ldb, double *Bp)
+{
+  for (unsigned int jr = 0; jr < nc; jr += nr) {
+    double *strip = Bp + jr * kc;
+    const unsigned int n = std::min(nr, nc - jr);
+    for (unsigned int p = 0; p < kc; p++) {
+      const double *b = B + p * ldb + jr;
+      double *s = strip + p * nr;
+      unsigned int c = 0;
+      for (; c < n; c++) {
+        s[c] = b[c];
+      }
+      for (; c < nr; c++) {
+        s[c] = 0;
+      }
+    }
+  }
+}
+
+// Write the mr x nr valid part of a gemm_mr x nr block of accumulators in C
+void storeBlock(const double *acc, unsigned int nr, unsigned int mr_valid, unsigned int nr_valid, double *C,
+                unsigned int ldc, bool accumulate)
+{
+  for (unsigned int r = 0; r < mr_valid; r++) {
+    double *c = C + r * ldc;
+    const double *a = acc + r * nr;
+    if (accumulate) {
+      for (unsigned int j = 0; j < nr_valid; j++) {
+        c[j] += a[j];
+      }
+    } else {
+      for (unsigned int j = 0; j < nr_valid; j++) {
+        c[j] = a[j];
+      }
+    }
+  }
+}
+
+// Micro-kernels computing a gemm_mr x nr block of C from packed strips
+void kernel4x4(unsigned int kc, const double *Ap, const double *Bp, double *C, unsigned int ldc, unsigned int mr,
+               unsigned int nr, bool accumulate)
+{
+  double acc[gemm_mr * 4];
+  if (useSSE2()) {
+#if USE_SSE
+    __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd(), c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+    __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd(), c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+    for (unsigned int p = 0; p < kc; p++, Ap += gemm_mr, Bp += 4) {
+      const __m128d b0 = _mm_loadu_pd(Bp), b1 = _mm_loadu_pd(Bp + 2);
+      __m128d a = _mm_set1_pd(Ap[0]);
+      c00 = _mm_add_pd(c00, _mm_mul_pd(a, b0));
+      c01 = _mm_add_pd(c01, _mm_mul_pd(a, b1));
+      a = _mm_set1_pd(Ap[1]);
+      c10 = _mm_add_pd(c10, _mm_mul_pd(a, b0));
+      c11 = _mm_add_pd(c11, _mm_mul_pd(a, b1));
+      a = _mm_set1_pd(Ap[2]);
+      c20 = _mm_add_pd(c20, _mm_mul_pd(a, b0));
+      c21 = _mm_add_pd(c21, _mm_mul_pd(a, b1));
+      a = _mm_set1_pd(Ap[3]);
+      c30 = _mm_add_pd(c30, _mm_mul_pd(a, b0));
+      c31 = _mm_add_pd(c31, _mm_mul_pd(a, b1));
+    }
+    _mm_storeu_pd(acc, c00);
+    _mm_storeu_pd(acc + 2, c01);
+    _mm_storeu_pd(acc + 4, c10);
+    _mm_storeu_pd(acc + 6, c11);
+    _mm_storeu_pd(acc + 8, c20);
+    _mm_storeu_pd(acc + 10, c21);
+    _mm_storeu_pd(acc + 12, c30);
+    _mm_storeu_pd(acc + 14, c31);
+#endif
+  } else {
+    for (unsigned int i = 0; i < gemm_mr * 4; i++) {
+      acc[i] = 0;
+    }
+    for (unsigned int p = 0; p < kc; p++, Ap += gemm_mr, Bp += 4) {
+      for (unsigned int r = 0; r < gemm_mr; r++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          acc[r * 4 + j] += Ap[r] * Bp[j];
+        }
+      }
+    }
+  }
+
+  storeBlock(acc, 4, mr, nr, C, ldc, accumulate);
+}
+
+#if USE_AVX2
+void kernel4x8(unsigned int kc, const double *Ap, const double *Bp, double *C, unsigned int ldc, unsigned int mr,
+               unsigned int nr, bool accumulate)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd(), c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd(), c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  for (unsigned int p = 0; p < kc; p++, Ap += gemm_mr, Bp += 8) {
+    const __m256d b0 = _mm256_loadu_pd(Bp), b1 = _mm256_loadu_pd(Bp + 4);
+#if defined __FMA__
+    __m256d a = _mm256_broadcast_sd(Ap);
+    c00 = _mm256_fmadd_pd(a, b0, c00);
+    c01 = _mm256_fmadd_pd(a, b1, c01);
+    a = _mm256_broadcast_sd(Ap + 1);
+    c10 = _mm256_fmadd_pd(a, b0, c10);
+    c11 = _mm256_fmadd_pd(a, b1, c11);
+    a = _mm256_broadcast_sd(Ap + 2);
+    c20 = _mm256_fmadd_pd(a, b0, c20);
+    c21 = _mm256_fmadd_pd(a, b1, c21);
+    a = _mm256_broadcast_sd(Ap + 3);
+    c30 = _mm256_fmadd_pd(a, b0, c30);
+    c31 = _mm256_fmadd_pd(a, b1, c31);
+#else
+    __m256d a = _mm256_broadcast_sd(Ap);
+    c00 = _mm256_add_pd(c00, _mm256_mul_pd(a, b0));
+    c01 = _mm256_add_pd(c01, _mm256_mul_pd(a, b1));
+    a = _mm256_broadcast_sd(Ap + 1);
+    c10 = _mm256_add_pd(c10, _mm256_mul_pd(a, b0));
+    c11 = _mm256_add_pd(c11, _mm256_mul_pd(a, b1));
+    a = _mm256_broadcast_sd(Ap + 2);
+    c20 = _mm256_add_pd(c20, _mm256_mul_pd(a, b0));
+    c21 = _mm256_add_pd(c21, _mm256_mul_pd(a, b1));
+    a = _mm256_broadcast_sd(Ap + 3);
+    c30 = _mm256_add_pd(c30, _mm256_mul_pd(a, b0));
+    c31 = _mm256_add_pd(c31, _mm256_mul_pd(a, b1));
+#endif
+  }
+
+  double acc[gemm_mr * 8];
+  _mm256_storeu_pd(acc, c00);
+  _mm256_storeu_pd(acc + 4, c01);
+  _mm256_storeu_pd(acc + 8, c10);
+  _mm256_storeu_pd(acc + 12, c11);
+  _mm256_storeu_pd(acc + 16, c20);
+  _mm256_storeu_pd(acc + 20, c21);
+  _mm256_storeu_pd(acc + 24, c30);
+  _mm256_storeu_pd(acc + 28, c31);
+  storeBlock(acc, 8, mr, nr, C, ldc, accumulate);
+}
+#endif
+
+// C = A * B with packed blocks of A and B and register-blocked micro-kernels
+void gemmBlocked(unsigned int M, unsigned int N, unsigned int K, const double *A, unsigned int lda, const double *B,
+                 unsigned int ldb, double *C, unsigned int ldc)
+{
+  const bool avx2 = useAVX2();
+  const unsigned int nr = avx2 ? 8 : 4;
+  const unsigned int mc_max = std::min(gemm_mc, (M + gemm_mr - 1) / gemm_mr * gemm_mr);
+  const unsigned int kc_max = std::min(gemm_kc, K);
+  const unsigned int nc_max = std::min(gemm_nc, (N + nr - 1) / nr * nr);
+  std::vector<double> Ap(mc_max * kc_max), Bp(kc_max * nc_max);
+
+  for (unsigned int jc = 0; jc < N; jc += gemm_nc) {
+    const unsigned int nc = std::min(gemm_nc, N - jc);
+    for (unsigned int pc = 0; pc < K; pc += gemm_kc) {
+      const unsigned int kc = std::min(gemm_kc, K - pc);
+      packB(kc, nc, nr, B + pc * ldb + jc, ldb, &Bp[0]);
+
+      for (unsigned int ic = 0; ic < M; ic += gemm_mc) {
+        const unsigned int mc = std::min(gemm_mc, M - ic);
+        packA(mc, kc, A + ic * lda + pc, lda, &Ap[0]);
+
+        for (unsigned int jr = 0; jr < nc; jr += nr) {
+          for (unsigned int ir = 0; ir < mc; ir += gemm_mr) {
+            double *c = C + (ic + ir) * ldc + jc + jr;
+            const unsigned int mr_valid = std::min(gemm_mr, mc - ir), nr_valid = std::min(nr, nc - jr);
+#if USE_AVX2
+            if (avx2) {
+              kernel4x8(kc, &Ap[ir * kc], &Bp[jr * kc], c, ldc, mr_valid, nr_valid, pc > 0);
+              continue;
+            }
+#endif
+            kernel4x4(kc, &Ap[ir * kc], &Bp[jr * kc], c, ldc, mr_valid, nr_valid, pc > 0);
+          }
+        }
+      }
+    }
+  }
+}
+
+// Product of a band of rows of A by B, executed by the thread pool
+class vpGemmTask : public vpThreadPool::vpTask
+{
+public:
+  vpGemmTask(unsigned int M, unsigned int N, unsigned int K, const double *A, unsigned int lda, const double *B,
+             unsigned int ldb, double *C, unsigned int ldc)
+    : m_M(M), m_N(N), m_K(K), m_A(A), m_lda(lda), m_B(B), m_ldb(ldb), m_C(C), m_ldc(ldc)
+  {
+  }
+
+  virtual void run() { gemmBlocked(m_M, m_N, m_K, m_A, m_lda, m_B, m_ldb, m_C, m_ldc); }
+
+private:
+  unsigned int m_M, m_N, m_K;
+  const double *m_A;
+  unsigned int m_lda;
+  const double *m_B;
+  unsigned int m_ldb;
+  double *m_C;
+  unsigned int m_ldc;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Built-in computation of C = A * B for row-major matrices, used when no
+  third-party BLAS is available or when the matrices are too small for the
+  BLAS call overhead to pay off.
+
+  Products by a matrix with 6 columns, that are the most frequent in visual
+  servoing and pose estimation, use a dedicated kernel. Small products use a
+  plain loop running along the rows of B. Larger products pack blocks of A
+  and B to compute blocks of C with SSE2 or AVX2 micro-kernels, and the
+  largest ones are split by bands of rows over vpThreadPool.
+
+  \param M, N, K : Size of C (M x N), A (M x K) and B (K x N).
+  \param a_data, b_data, c_data : First element of A, B and C.
+  \param lda, ldb, ldc : Number of elements between two rows of A, B and C.
+*/
+void vpMatrix::gemm(const unsigned int M, const unsigned int N, const unsigned int K, const double *a_data,
+                    const unsigned int lda, const double *b_data, const unsigned int ldb, double *c_data,
+                    const unsigned int ldc)
+{
+  if (M == 0 || N == 0) {
+    return;
+  }
+
+  if (K == 0) {
+    for (unsigned int i = 0; i < M; i++) {
+      memset(c_data + i * ldc, 0, N * sizeof(double));
+    }
+    return;
+  }
+
+  if (N == 6) {
+    gemmN6(M, K, a_data, lda, b_data, ldb, c_data, ldc);
+    return;
+  }
+
+  const double size = (double)M * (double)N * (double)K;
+  if (size < gemm_small_size) {
+    gemmSmall(M, N, K, a_data, lda, b_data, ldb, c_data, ldc);
+    return;
+  }
+
+  vpThreadPool &pool = vpThreadPool::getInstance();
+  unsigned int nbTasks = std::min(pool.getNbThreads() + 1, M / gemm_mc);
+  if (size < gemm_parallel_size || nbTasks < 2) {
+    gemmBlocked(M, N, K, a_data, lda, b_data, ldb, c_data, ldc);
+    return;
+  }
+
+  // Bands of rows multiple of the micro-kernel height
+  const unsigned int band = ((M + nbTasks - 1) / nbTasks + gemm_mr - 1) / gemm_mr * gemm_mr;
+  std::vector<vpGemmTask> gemmTasks;
+  gemmTasks.reserve(nbTasks);
+  for (unsigned int i = 0; i < M; i += band) {
+    const unsigned int rows = std::min(band, M - i);
+    gemmTasks.push_back(vpGemmTask(rows, N, K, a_data + i * lda, lda, b_data, ldb, c_data + i * ldc, ldc));
+  }
+  std::vector<vpThreadPool::vpTask *> tasks(gemmTasks.size());
+  for (size_t i = 0; i < gemmTasks.size(); i++) {
+    tasks[i] = &gemmTasks[i];
+  }
+  pool.run(tasks);
+}
+
+/*!
+  Built-in computation of C = A^T * A, with A a row-major M x N matrix whose
+  rows are contiguous and C a N x N matrix.
+
+  The terms of C are accumulated row after row of A, so that A is read only
+  once and in memory order. Matrices with 6 columns keep the 21 terms of the
+  upper triangle in registers, and matrices with many columns are
+  transposed to use gemm().
+*/
+void vpMatrix::syrk(const unsigned int M, const unsigned int N, const double *a_data, double *c_data)
+{
+  if (N == 6) {
+    double c00 = 0, c01 = 0, c02 = 0, c03 = 0, c04 = 0, c05 = 0;
+    double c11 = 0, c12 = 0, c13 = 0, c14 = 0, c15 = 0;
+    double c22 = 0, c23 = 0, c24 = 0, c25 = 0;
+    double c33 = 0, c34 = 0, c35 = 0;
+    double c44 = 0, c45 = 0;
+    double c55 = 0;
+    const double *a = a_data;
+    for (unsigned int k = 0; k < M; k++, a += 6) {
+      const double a0 = a[0], a1 = a[1], a2 = a[2], a3 = a[3], a4 = a[4], a5 = a[5];
+      c00 += a0 * a0;
+      c01 += a0 * a1;
+      c02 += a0 * a2;
+      c03 += a0 * a3;
+      c04 += a0 * a4;
+      c05 += a0 * a5;
+      c11 += a1 * a1;
+      c12 += a1 * a2;
+      c13 += a1 * a3;
+      c14 += a1 * a4;
+      c15 += a1 * a5;
+      c22 += a2 * a2;
+      c23 += a2 * a3;
+      c24 += a2 * a4;
+      c25 += a2 * a5;
+      c33 += a3 * a3;
+      c34 += a3 * a4;
+      c35 += a3 * a5;
+      c44 += a4 * a4;
+      c45 += a4 * a5;
+      c55 += a5 * a5;
+    }
+
+    const double c[6][6] = {{c00, c01, c02, c03, c04, c05}, {c01, c11, c12, c13, c14, c15},
+                            {c02, c12, c22, c23, c24, c25}, {c03, c13, c23, c33, c34, c35},
+                            {c04, c14, c24, c34, c44, c45}, {c05, c15, c25, c35, c45, c55}};
+    memcpy(c_data, c, sizeof(c));
+    return;
+  }
+
+  if (N > 32) {
+    std::vector<double> at((size_t)N * M);
+    for (unsigned int k = 0; k < M; k++) {
+      const double *a = a_data + k * N;
+      for (unsigned int i = 0; i < N; i++) {
+        at[(size_t)i * M + k] = a[i];
+      }
+    }
+    gemm(N, N, M, M == 0 ? NULL : &at[0], M, a_data, N, c_data, N);
+    return;
+  }
+
+  memset(c_data, 0, (size_t)N * N * sizeof(double));
+  for (unsigned int k = 0; k < M; k++) {
+    const double *a = a_data + k * N;
+    for (unsigned int i = 0; i < N; i++) {
+      const double ai = a[i];
+      double *ci = c_data + i * N;
+      for (unsigned int j = i; j < N; j++) {
+        ci[j] += ai * a[j];
+      }
+    }
+  }
+  for (unsigned int i = 1; i < N; i++) {
+    for (unsigned int j = 0; j < i; j++) {
+      c_data[i * N + j] = c_data[j * N + i];
+    }
+  }
+}
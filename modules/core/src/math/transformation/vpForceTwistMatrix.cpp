@@ -86,7 +86,7 @@ void vpForceTwistMatrix::eye()
 /*!
   Initialize a force/torque twist transformation matrix to identity.
 */
-vpForceTwistMatrix::vpForceTwistMatrix() : vpArray2D<double>(6, 6) { eye(); }
+vpForceTwistMatrix::vpForceTwistMatrix() : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage) { eye(); }
 
 /*!
 
@@ -95,7 +95,11 @@ vpForceTwistMatrix::vpForceTwistMatrix() : vpArray2D<double>(6, 6) { eye(); }
 
   \param F : Force/torque twist matrix used as initializer.
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F) : vpArray2D<double>(6, 6) { *this = F; }
+vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
+{
+  *this = F;
+}
 
 /*!
 
@@ -126,7 +130,8 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F) : vpArray2D<
   \f]
 
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M, bool full) : vpArray2D<double>(6, 6)
+vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M, bool full)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   if (full)
     buildFrom(M);
@@ -154,7 +159,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M, bool full)
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   buildFrom(t, thetau);
 }
@@ -176,7 +181,11 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpThe
   \param thetau : \f$\theta u\f$ rotation vector used to initialize \f$R\f$.
 
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpThetaUVector &thetau) : vpArray2D<double>(6, 6) { buildFrom(thetau); }
+vpForceTwistMatrix::vpForceTwistMatrix(const vpThetaUVector &thetau)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(thetau);
+}
 
 /*!
 
@@ -198,7 +207,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpThetaUVector &thetau) : vpArray2D
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   buildFrom(t, R);
 }
@@ -220,7 +229,11 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t, const vpRot
   \param R : Rotation matrix.
 
 */
-vpForceTwistMatrix::vpForceTwistMatrix(const vpRotationMatrix &R) : vpArray2D<double>(6, 6) { buildFrom(R); }
+vpForceTwistMatrix::vpForceTwistMatrix(const vpRotationMatrix &R)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(R);
+}
 
 /*!
 
@@ -244,7 +257,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpRotationMatrix &R) : vpArray2D<do
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const double tx, const double ty, const double tz, const double tux,
                                        const double tuy, const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   vpTranslationVector T(tx, ty, tz);
   vpThetaUVector tu(tux, tuy, tuz);
@@ -401,7 +414,13 @@ vpColVector vpForceTwistMatrix::operator*(const vpColVector &H) const
 */
 vpForceTwistMatrix vpForceTwistMatrix::buildFrom(const vpTranslationVector &t, const vpRotationMatrix &R)
 {
-  vpMatrix skewaR = t.skew(t) * R;
+  // [t]x * R computed in place to avoid temporary matrices
+  double skewaR[3][3];
+  for (unsigned int j = 0; j < 3; j++) {
+    skewaR[0][j] = -t[2] * R[1][j] + t[1] * R[2][j];
+    skewaR[1][j] = t[2] * R[0][j] - t[0] * R[2][j];
+    skewaR[2][j] = -t[1] * R[0][j] + t[0] * R[1][j];
+  }
 
   for (unsigned int i = 0; i < 3; i++) {
     for (unsigned int j = 0; j < 3; j++) {
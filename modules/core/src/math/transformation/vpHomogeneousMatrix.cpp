@@ -54,7 +54,7 @@
   rotation vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpQuaternionVector &q)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   buildFrom(t, q);
   (*this)[3][3] = 1.;
@@ -63,20 +63,24 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpQ
 /*!
   Default constructor that initialize an homogeneous matrix as identity.
 */
-vpHomogeneousMatrix::vpHomogeneousMatrix() : vpArray2D<double>(4, 4) { eye(); }
+vpHomogeneousMatrix::vpHomogeneousMatrix() : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage) { eye(); }
 
 /*!
   Copy constructor that initialize an homogeneous matrix from another
   homogeneous matrix.
 */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M) : vpArray2D<double>(4, 4) { *this = M; }
+vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
+{
+  *this = M;
+}
 
 /*!
   Construct an homogeneous matrix from a translation vector and \f$\theta {\bf
   u}\f$ rotation vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpThetaUVector &tu)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   buildFrom(t, tu);
   (*this)[3][3] = 1.;
@@ -87,7 +91,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpT
   matrix.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpRotationMatrix &R)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   insert(R);
   insert(t);
@@ -97,7 +101,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t, const vpR
 /*!
   Construct an homogeneous matrix from a pose vector.
  */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p) : vpArray2D<double>(4, 4)
+vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p) : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   buildFrom(p[0], p[1], p[2], p[3], p[4], p[5]);
   (*this)[3][3] = 1.;
@@ -142,7 +146,8 @@ M:
 0  0  0  1
   \endcode
   */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v) : vpArray2D<double>(4, 4)
+vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   buildFrom(v);
   (*this)[3][3] = 1.;
@@ -187,7 +192,8 @@ M:
 0  0  0  1
   \endcode
   */
-vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v) : vpArray2D<double>(4, 4)
+vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   buildFrom(v);
   (*this)[3][3] = 1.;
@@ -200,7 +206,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v) : vpArray
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const double tx, const double ty, const double tz, const double tux,
                                          const double tuy, const double tuz)
-  : vpArray2D<double>(4, 4)
+  : vpArray2D<double>(4, 4, m_storage, m_rowPtrsStorage)
 {
   buildFrom(tx, ty, tz, tux, tuy, tuz);
   (*this)[3][3] = 1.;
@@ -370,10 +376,8 @@ void vpHomogeneousMatrix::buildFrom(const std::vector<double> &v)
 */
 vpHomogeneousMatrix &vpHomogeneousMatrix::operator=(const vpHomogeneousMatrix &M)
 {
-  for (int i = 0; i < 4; i++) {
-    for (int j = 0; j < 4; j++) {
-      rowPtrs[i][j] = M.rowPtrs[i][j];
-    }
+  if (this != &M) {
+    memcpy(data, M.data, 16 * sizeof(double));
   }
   return *this;
 }
@@ -394,26 +398,23 @@ int main()
 }
   \endcode
 
+  Since the elements of an homogeneous matrix are stored in the object
+  itself, the product doesn't involve any heap allocation.
 */
 vpHomogeneousMatrix vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M) const
 {
   vpHomogeneousMatrix p;
 
-  vpRotationMatrix R1, R2, R;
-  vpTranslationVector T1, T2, T;
-
-  extract(T1);
-  M.extract(T2);
-
-  extract(R1);
-  M.extract(R2);
-
-  R = R1 * R2;
-
-  T = R1 * T2 + T1;
-
-  p.insert(T);
-  p.insert(R);
+  // Last row of p is already set to [0 0 0 1] by the constructor
+  const double *b = M.data;
+  for (unsigned int i = 0; i < 3; i++) {
+    const double *a = rowPtrs[i];
+    double *c = p.rowPtrs[i];
+    c[0] = a[0] * b[0] + a[1] * b[4] + a[2] * b[8];
+    c[1] = a[0] * b[1] + a[1] * b[5] + a[2] * b[9];
+    c[2] = a[0] * b[2] + a[1] * b[6] + a[2] * b[10];
+    c[3] = a[0] * b[3] + a[1] * b[7] + a[2] * b[11] + a[3];
+  }
 
   return p;
 }
@@ -484,7 +485,7 @@ vpPoint vpHomogeneousMatrix::operator*(const vpPoint &bP) const
 {
   vpPoint aP;
 
-  vpColVector v(4), v1(4);
+  double v[4], v1[4];
 
   v[0] = bP.get_X();
   v[1] = bP.get_Y();
@@ -496,7 +497,10 @@ vpPoint vpHomogeneousMatrix::operator*(const vpPoint &bP) const
   v1[2] = (*this)[2][0] * v[0] + (*this)[2][1] * v[1] + (*this)[2][2] * v[2] + (*this)[2][3] * v[3];
   v1[3] = (*this)[3][0] * v[0] + (*this)[3][1] * v[1] + (*this)[3][2] * v[2] + (*this)[3][3] * v[3];
 
-  v1 /= v1[3];
+  const double w = v1[3];
+  for (unsigned int i = 0; i < 4; i++) {
+    v1[i] /= w;
+  }
 
   //  v1 = M*v ;
   aP.set_X(v1[0]);
@@ -644,16 +648,7 @@ vpHomogeneousMatrix vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi;
 
-  vpRotationMatrix R;
-  extract(R);
-  vpTranslationVector T;
-  extract(T);
-
-  vpTranslationVector RtT;
-  RtT = -(R.t() * T);
-
-  Mi.insert(R.t());
-  Mi.insert(RtT);
+  inverse(Mi);
 
   return Mi;
 }
@@ -688,7 +683,21 @@ void vpHomogeneousMatrix::eye()
   \right]\f$
 
 */
-void vpHomogeneousMatrix::inverse(vpHomogeneousMatrix &M) const { M = inverse(); }
+void vpHomogeneousMatrix::inverse(vpHomogeneousMatrix &M) const
+{
+  // Work on a copy to allow M.inverse(M)
+  double m[12];
+  memcpy(m, data, 12 * sizeof(double));
+
+  for (unsigned int i = 0; i < 3; i++) {
+    M[i][0] = m[i];
+    M[i][1] = m[4 + i];
+    M[i][2] = m[8 + i];
+    M[i][3] = -(m[i] * m[3] + m[4 + i] * m[7] + m[8 + i] * m[11]);
+  }
+  M[3][0] = M[3][1] = M[3][2] = 0.;
+  M[3][3] = 1.;
+}
 
 /*!
   Write an homogeneous matrix in an output file stream.
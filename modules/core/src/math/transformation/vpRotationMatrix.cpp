@@ -321,52 +321,81 @@ bool vpRotationMatrix::isARotationMatrix() const
 /*!
   Default constructor that initialise a 3-by-3 rotation matrix to identity.
 */
-vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3, 3) { eye(); }
+vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage) { eye(); }
 
 /*!
   Copy contructor that construct a 3-by-3 rotation matrix from another
   rotation matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpArray2D<double>(3, 3) { (*this) = M; }
+vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  (*this) = M;
+}
 /*!
   Construct a 3-by-3 rotation matrix from an homogeneous matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpArray2D<double>(3, 3) { buildFrom(M); }
+vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(M);
+}
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}\f$ angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpArray2D<double>(3, 3) { buildFrom(tu); }
+vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(tu);
+}
 
 /*!
   Construct a 3-by-3 rotation matrix from a pose vector.
  */
-vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpArray2D<double>(3, 3) { buildFrom(p); }
+vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(p);
+}
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,z) \f$ Euler angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpArray2D<double>(3, 3) { buildFrom(euler); }
+vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(euler);
+}
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(x,y,z) \f$ Euler angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpArray2D<double>(3, 3) { buildFrom(Rxyz); }
+vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(Rxyz);
+}
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,x) \f$ Euler angle
   representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpArray2D<double>(3, 3) { buildFrom(Rzyx); }
+vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(Rzyx);
+}
 
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}=(\theta u_x,
   \theta u_y, \theta u_z)^T\f$ angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpArray2D<double>(3, 3)
+vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
 {
   buildFrom(tux, tuy, tuz);
 }
@@ -374,7 +403,11 @@ vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const dou
 /*!
   Construct a 3-by-3 rotation matrix from quaternion angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector &q) : vpArray2D<double>(3, 3) { buildFrom(q); }
+vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector &q)
+  : vpArray2D<double>(3, 3, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(q);
+}
 
 /*!
   Return the rotation matrix transpose which is also the inverse of the
@@ -54,7 +54,8 @@
   in meters.
 
 */
-vpTranslationVector::vpTranslationVector(const double tx, const double ty, const double tz) : vpArray2D<double>(3, 1)
+vpTranslationVector::vpTranslationVector(const double tx, const double ty, const double tz)
+  : vpArray2D<double>(3, 1, m_storage, m_rowPtrsStorage)
 {
   (*this)[0] = tx;
   (*this)[1] = ty;
@@ -68,7 +69,11 @@ vpTranslationVector::vpTranslationVector(const double tx, const double ty, const
   \param M : Homogeneous matrix where translations are in meters.
 
 */
-vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M) : vpArray2D<double>(3, 1) { M.extract(*this); }
+vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M)
+  : vpArray2D<double>(3, 1, m_storage, m_rowPtrsStorage)
+{
+  M.extract(*this);
+}
 
 /*!
   Construct a translation vector \f$ \bf t \f$ from the translation contained
@@ -77,7 +82,7 @@ vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M) : vpArray
   \param p : Pose vector where translations are in meters.
 
 */
-vpTranslationVector::vpTranslationVector(const vpPoseVector &p) : vpArray2D<double>(3, 1)
+vpTranslationVector::vpTranslationVector(const vpPoseVector &p) : vpArray2D<double>(3, 1, m_storage, m_rowPtrsStorage)
 {
   (*this)[0] = p[0];
   (*this)[1] = p[1];
@@ -94,7 +99,11 @@ vpTranslationVector::vpTranslationVector(const vpPoseVector &p) : vpArray2D<doub
   vpTranslationVector t2(t1);    // t2 is now a copy of t1
   \endcode
 */
-vpTranslationVector::vpTranslationVector(const vpTranslationVector &tv) : vpArray2D<double>(tv) {}
+vpTranslationVector::vpTranslationVector(const vpTranslationVector &tv)
+  : vpArray2D<double>(3, 1, m_storage, m_rowPtrsStorage)
+{
+  memcpy(data, tv.data, 3 * sizeof(double));
+}
 
 /*!
   Construct a translation vector \f$ \bf t \f$ from a 3-dimension column
@@ -110,7 +119,7 @@ vpTranslationVector::vpTranslationVector(const vpTranslationVector &tv) : vpArra
   \endcode
 
 */
-vpTranslationVector::vpTranslationVector(const vpColVector &v) : vpArray2D<double>(v)
+vpTranslationVector::vpTranslationVector(const vpColVector &v) : vpArray2D<double>(3, 1, m_storage, m_rowPtrsStorage)
 {
   if (v.size() != 3) {
     throw(vpException(vpException::dimensionError,
@@ -118,6 +127,7 @@ vpTranslationVector::vpTranslationVector(const vpColVector &v) : vpArray2D<doubl
                       "%d-dimension column vector",
                       v.size()));
   }
+  memcpy(data, v.data, 3 * sizeof(double));
 }
 
 /*!
@@ -82,7 +82,7 @@ void vpVelocityTwistMatrix::eye()
 /*!
   Initialize a velocity twist transformation matrix as identity.
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix() : vpArray2D<double>(6, 6) { eye(); }
+vpVelocityTwistMatrix::vpVelocityTwistMatrix() : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage) { eye(); }
 
 /*!
   Initialize a velocity twist transformation matrix from another velocity
@@ -90,7 +90,11 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix() : vpArray2D<double>(6, 6) { eye()
 
   \param V : Velocity twist matrix used as initializer.
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V) : vpArray2D<double>(6, 6) { *this = V; }
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
+{
+  *this = V;
+}
 
 /*!
 
@@ -110,7 +114,8 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V) : v
   {\bf 0}_{3\times 3} & {\bf R} \end{array} \right] \f]
 
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M, bool full) : vpArray2D<double>(6, 6)
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M, bool full)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   if (full)
     buildFrom(M);
@@ -133,7 +138,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M, bool
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   buildFrom(t, thetau);
 }
@@ -150,7 +155,8 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const
   vector \f$R\f$ .
 
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpThetaUVector &thetau) : vpArray2D<double>(6, 6)
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpThetaUVector &thetau)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   buildFrom(thetau);
 }
@@ -169,7 +175,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpThetaUVector &thetau) : vpA
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   buildFrom(t, R);
 }
@@ -185,7 +191,11 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t, const
   \param R : Rotation matrix.
 
 */
-vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpRotationMatrix &R) : vpArray2D<double>(6, 6) { buildFrom(R); }
+vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpRotationMatrix &R)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
+{
+  buildFrom(R);
+}
 
 /*!
 
@@ -204,7 +214,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpRotationMatrix &R) : vpArra
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const double tx, const double ty, const double tz, const double tux,
                                              const double tuy, const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpArray2D<double>(6, 6, m_storage, m_rowPtrsStorage)
 {
   vpTranslationVector t(tx, ty, tz);
   vpThetaUVector tu(tux, tuy, tuz);
@@ -364,7 +374,13 @@ vpVelocityTwistMatrix vpVelocityTwistMatrix::buildFrom(const vpRotationMatrix &R
 */
 vpVelocityTwistMatrix vpVelocityTwistMatrix::buildFrom(const vpTranslationVector &t, const vpRotationMatrix &R)
 {
-  vpMatrix skewaR = t.skew(t) * R;
+  // [t]x * R computed in place to avoid temporary matrices
+  double skewaR[3][3];
+  for (unsigned int j = 0; j < 3; j++) {
+    skewaR[0][j] = -t[2] * R[1][j] + t[1] * R[2][j];
+    skewaR[1][j] = t[2] * R[0][j] - t[0] * R[2][j];
+    skewaR[2][j] = -t[1] * R[0][j] + t[0] * R[1][j];
+  }
 
   for (unsigned int i = 0; i < 3; i++) {
     for (unsigned int j = 0; j < 3; j++) {
@@ -474,17 +490,11 @@ void vpVelocityTwistMatrix::extract(vpRotationMatrix &R) const
 //! Extract the translation vector from the velocity twist matrix.
 void vpVelocityTwistMatrix::extract(vpTranslationVector &tv) const
 {
-  vpRotationMatrix R;
-  extract(R);
-  vpMatrix skTR(3, 3);
-  for (unsigned int i = 0; i < 3; i++)
-    for (unsigned int j = 0; j < 3; j++)
-      skTR[i][j] = (*this)[i][j + 3];
-
-  vpMatrix skT = skTR * R.t();
-  tv[0] = skT[2][1];
-  tv[1] = skT[0][2];
-  tv[2] = skT[1][0];
+  // [t]x = ([t]x R) R^T, only the 3 needed elements are computed
+  const double *r0 = rowPtrs[0], *r1 = rowPtrs[1], *r2 = rowPtrs[2];
+  tv[0] = r2[3] * r1[0] + r2[4] * r1[1] + r2[5] * r1[2];
+  tv[1] = r0[3] * r2[0] + r0[4] * r2[1] + r0[5] * r2[2];
+  tv[2] = r1[3] * r0[0] + r1[4] * r0[1] + r1[5] * r0[2];
 }
 
 /*!
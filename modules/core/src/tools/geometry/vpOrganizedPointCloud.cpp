@@ -0,0 +1,244 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Organized point cloud stored in a contiguous buffer.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpOrganizedPointCloud.h>
+
+/*!
+  Default constructor. The point cloud is empty.
+*/
+vpOrganizedPointCloud::vpOrganizedPointCloud()
+  : m_height(0), m_width(0), m_stride(0), m_buffer(), m_xyz(NULL), m_depth(NULL), m_depthScale(1.0), m_xLut(),
+    m_yLut()
+{
+}
+
+/*!
+  Construct a point cloud of \e height x \e width points set to zero.
+*/
+vpOrganizedPointCloud::vpOrganizedPointCloud(const unsigned int height, const unsigned int width)
+  : m_height(0), m_width(0), m_stride(0), m_buffer(), m_xyz(NULL), m_depth(NULL), m_depthScale(1.0), m_xLut(),
+    m_yLut()
+{
+  resize(height, width);
+}
+
+/*!
+  Copy constructor. If \e pointcloud is a view, the copy is a view on the
+  same memory.
+*/
+vpOrganizedPointCloud::vpOrganizedPointCloud(const vpOrganizedPointCloud &pointcloud)
+  : m_height(0), m_width(0), m_stride(0), m_buffer(), m_xyz(NULL), m_depth(NULL), m_depthScale(1.0), m_xLut(),
+    m_yLut()
+{
+  *this = pointcloud;
+}
+
+/*!
+  Destructor.
+*/
+vpOrganizedPointCloud::~vpOrganizedPointCloud() {}
+
+/*!
+  Copy the points of a std::vector<vpColVector> organized point cloud, where
+  each element contains at least the X, Y, Z coordinates of the point.
+
+  \param pointcloud : Point cloud of size \e height x \e width.
+  \param height : Number of rows.
+  \param width : Number of columns.
+*/
+void vpOrganizedPointCloud::buildFrom(const std::vector<vpColVector> &pointcloud, const unsigned int height,
+                                      const unsigned int width)
+{
+  if (pointcloud.size() != (size_t)height * width) {
+    throw(vpException(vpException::dimensionError, "Point cloud size (%d) is different from %dx%d",
+                      (int)pointcloud.size(), height, width));
+  }
+
+  // All the points are overwritten
+  allocate(height, width);
+  double *xyz = m_buffer.empty() ? NULL : &m_buffer[0];
+  for (size_t i = 0; i < pointcloud.size(); i++, xyz += 3) {
+    const double *pt = pointcloud[i].data;
+    xyz[0] = pt[0];
+    xyz[1] = pt[1];
+    xyz[2] = pt[2];
+  }
+}
+
+/*!
+  Wrap without copy a buffer of interleaved XYZ coordinates.
+
+  \param xyz : Pointer to the X coordinate of the first point.
+  \param height : Number of rows.
+  \param width : Number of columns.
+  \param stride : Number of doubles between the beginning of two consecutive
+  rows. If 0, the rows are considered contiguous (stride = 3 * width).
+*/
+void vpOrganizedPointCloud::buildFrom(const double *xyz, const unsigned int height, const unsigned int width,
+                                      const unsigned int stride)
+{
+  if (stride != 0 && stride < 3 * width) {
+    throw(vpException(vpException::dimensionError, "Stride (%d) must be greater or equal than 3*width (%d)", stride,
+                      3 * width));
+  }
+
+  m_buffer.clear();
+  m_xLut.clear();
+  m_yLut.clear();
+  m_height = height;
+  m_width = width;
+  m_stride = stride == 0 ? 3 * width : stride;
+  m_xyz = xyz;
+  m_depth = NULL;
+  m_depthScale = 1.0;
+}
+
+/*!
+  Build a view on a raw depth image without copy. The 3D coordinates are
+  computed on the fly using the perspective projection model without
+  distortion:
+  \f[ Z = d \; s, \quad X = \frac{u - u_0}{p_x} Z, \quad Y = \frac{v - v_0}{p_y} Z \f]
+
+  \param depth : Raw depth image, must remain valid while the point cloud is
+  used.
+  \param cam : Intrinsic parameters of the depth camera.
+  \param depthScale : Scale \f$ s \f$ to convert a raw depth value \f$ d \f$
+  into meter.
+*/
+void vpOrganizedPointCloud::buildFrom(const vpImage<uint16_t> &depth, const vpCameraParameters &cam,
+                                      const double depthScale)
+{
+  m_buffer.clear();
+  m_height = depth.getHeight();
+  m_width = depth.getWidth();
+  m_stride = depth.getWidth();
+  m_xyz = NULL;
+  m_depth = depth.bitmap;
+  m_depthScale = depthScale;
+
+  m_xLut.resize(m_width);
+  for (unsigned int j = 0; j < m_width; j++) {
+    m_xLut[j] = (j - cam.get_u0()) * cam.get_px_inverse();
+  }
+  m_yLut.resize(m_height);
+  for (unsigned int i = 0; i < m_height; i++) {
+    m_yLut[i] = (i - cam.get_v0()) * cam.get_py_inverse();
+  }
+}
+
+/*!
+  Release the memory and reset the point cloud to an empty one.
+*/
+void vpOrganizedPointCloud::clear()
+{
+  m_buffer.clear();
+  m_xLut.clear();
+  m_yLut.clear();
+  m_height = m_width = m_stride = 0;
+  m_xyz = NULL;
+  m_depth = NULL;
+  m_depthScale = 1.0;
+}
+
+/*!
+  Return a pointer to the interleaved XYZ coordinates of the first point of
+  row \e i.
+
+  \exception vpException::fatalError When the memory is not owned by the
+  point cloud (view on a user buffer or on a depth image).
+*/
+double *vpOrganizedPointCloud::getRow(const unsigned int i)
+{
+  if (m_buffer.empty() || m_xyz != &m_buffer[0]) {
+    throw(vpException(vpException::fatalError, "Cannot modify a point cloud that doesn't own its memory"));
+  }
+  return &m_buffer[i * m_stride];
+}
+
+/*!
+  Copy operator. If \e pointcloud is a view, the copy is a view on the same
+  memory, otherwise the points are copied.
+*/
+vpOrganizedPointCloud &vpOrganizedPointCloud::operator=(const vpOrganizedPointCloud &pointcloud)
+{
+  if (this == &pointcloud) {
+    return *this;
+  }
+
+  const bool owned = !pointcloud.m_buffer.empty() && pointcloud.m_xyz == &pointcloud.m_buffer[0];
+  m_height = pointcloud.m_height;
+  m_width = pointcloud.m_width;
+  m_stride = pointcloud.m_stride;
+  m_buffer = pointcloud.m_buffer;
+  m_xyz = owned ? &m_buffer[0] : pointcloud.m_xyz;
+  m_depth = pointcloud.m_depth;
+  m_depthScale = pointcloud.m_depthScale;
+  m_xLut = pointcloud.m_xLut;
+  m_yLut = pointcloud.m_yLut;
+
+  return *this;
+}
+
+/*!
+  Allocate an owned contiguous buffer of \e height x \e width points set to
+  zero. The buffer is not reallocated if its capacity is large enough, but
+  all the points are set to zero on every call.
+*/
+void vpOrganizedPointCloud::resize(const unsigned int height, const unsigned int width)
+{
+  allocate(height, width);
+  std::fill(m_buffer.begin(), m_buffer.end(), 0.0);
+}
+
+/*!
+  Allocate an owned contiguous buffer of \e height x \e width points without
+  initializing them. The buffer is not reallocated if its capacity is large
+  enough.
+*/
+void vpOrganizedPointCloud::allocate(const unsigned int height, const unsigned int width)
+{
+  m_xLut.clear();
+  m_yLut.clear();
+  m_depth = NULL;
+  m_depthScale = 1.0;
+  m_height = height;
+  m_width = width;
+  m_stride = 3 * width;
+  m_buffer.resize((size_t)3 * width * height);
+  m_xyz = m_buffer.empty() ? NULL : &m_buffer[0];
+}
@@ -38,7 +38,9 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
 #include <limits>
+#include <math.h>
 #include <set>
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpException.h>
@@ -377,6 +379,65 @@ bool vpPolygon::isInside(const vpImagePoint &ip, const PointInPolygonMethod &met
   return test;
 }
 
+/*!
+  Compute the horizontal spans of the polygon along the image row \e i, ie.
+  the intervals of columns of the pixels inside the polygon. It gives
+  exactly the same pixels as isInside() with the PnPolyRayCasting method,
+  but only costs a sort of the edges crossing the row, instead of a test of
+  all the edges for each pixel.
+
+  \param i : Row of the pixels.
+  \param left, right : Range [left, right) of columns the spans are
+  restricted to.
+  \param spans : Pairs [start, end) of columns, sorted in increasing order.
+  The pixel (i, j) with \e left <= j < \e right is inside the polygon if and
+  only if spans[2k] <= j < spans[2k+1] for some k.
+
+  The following example samples the pixels of the polygon row by row:
+  \code
+  std::vector<int> spans;
+  for (int i = top; i < bottom; i++) {
+    polygon.getRowSpans(i, left, right, spans);
+    for (size_t k = 0; k < spans.size(); k += 2) {
+      for (int j = spans[k]; j < spans[k + 1]; j++) {
+        // (i, j) is inside the polygon
+      }
+    }
+  }
+  \endcode
+*/
+void vpPolygon::getRowSpans(const int i, const int left, const int right, std::vector<int> &spans) const
+{
+  spans.clear();
+  if (_corners.size() < 3 || left >= right) {
+    return;
+  }
+
+  // Abscissa of the edges crossing the row, computed as in isInside()
+  const double v = i;
+  std::vector<double> crossings;
+  for (size_t k = 0, l = _corners.size() - 1; k < _corners.size(); k++) {
+    if ((_corners[k].get_v() < v && _corners[l].get_v() >= v) ||
+        (_corners[l].get_v() < v && _corners[k].get_v() >= v)) {
+      crossings.push_back(v * m_PnPolyMultiples[k] + m_PnPolyConstants[k]);
+    }
+
+    l = k;
+  }
+  std::sort(crossings.begin(), crossings.end());
+
+  // A pixel is inside when an odd number of crossings are strictly on its
+  // left, ie. for the integer columns j with crossings[k] < j <= crossings[k+1]
+  for (size_t k = 0; k < crossings.size(); k += 2) {
+    double start = std::max((double)left, floor(crossings[k]) + 1);
+    double end = k + 1 < crossings.size() ? std::min((double)right, floor(crossings[k + 1]) + 1) : right;
+    if (start < end) {
+      spans.push_back((int)start);
+      spans.push_back((int)end);
+    }
+  }
+}
+
 void vpPolygon::precalcValuesPnPoly()
 {
   if (_corners.size() < 3) {
@@ -41,10 +41,37 @@
 // inet_ntop() not supported on win XP
 #ifdef VISP_HAVE_FUNC_INET_NTOP
 
+#include <algorithm>
+#include <limits.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#  include <errno.h>
+#  include <sys/uio.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Binary protocol: header of 4 unsigned int in network byte order, followed
+// by the request id and by the parameters, each one prefixed by its length
+const uint32_t vpBinaryMagic = 0x56504231; // "VPB1"
+const size_t vpBinaryHeaderSize = 4 * sizeof(uint32_t);
+
+inline uint32_t readUInt32(const char *data)
+{
+  uint32_t value;
+  memcpy(&value, data, sizeof(uint32_t));
+  return ntohl(value);
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpNetwork::vpNetwork()
   : emitter(), receptor_list(), readFileDescriptor(), socketMax(0), request_list(), max_size_message(999999),
     separator("[*@*]"), beginning("[*start*]"), end("[*end*]"), param_sep("[*|*]"), currentMessageReceived(), tv(),
-    tv_sec(0), tv_usec(10), verboseMode(false)
+    tv_sec(0), tv_usec(10), verboseMode(false), binaryProtocol(false), max_size_frame(128 * 1024 * 1024)
 {
   tv.tv_sec = tv_sec;
 #if TARGET_OS_IPHONE
@@ -196,13 +223,18 @@ int vpNetwork::sendRequestTo(vpRequest &req, const unsigned int &dest)
     return 0;
   }
 
+  if (binaryProtocol) {
+    return _sendBinaryRequestTo(req, dest);
+  }
+
   std::string message = beginning + req.getId() + separator;
 
   if (req.size() != 0) {
-    message += req[0];
+    message.append(req.getParameterData(0), req.getParameterSize(0));
 
     for (unsigned int i = 1; i < req.size(); i++) {
-      message += param_sep + req[i];
+      message += param_sep;
+      message.append(req.getParameterData(i), req.getParameterSize(i));
     }
   }
 
@@ -508,6 +540,10 @@ std::vector<int> vpNetwork::_handleRequests()
 */
 int vpNetwork::_handleFirstRequest()
 {
+  if (binaryProtocol) {
+    return _handleFirstBinaryRequest();
+  }
+
   size_t indStart = currentMessageReceived.find(beginning);
   size_t indSep = currentMessageReceived.find(separator);
   size_t indEnd = currentMessageReceived.find(end);
@@ -586,6 +622,304 @@ int vpNetwork::_handleFirstRequest()
   return indRequest;
 }
 
+/*!
+  Handle the first complete frame received with the binary protocol. The
+  frames whose id doesn't correspond to any request are dropped.
+
+  \warning : This function doesn't run the request. If it does handle a
+  request that hasn't been ran yet, The request's parameters will be replace.
+
+  \sa vpNetwork::handleFirstRequest()
+
+  \return : The index of the request that has been handled, or -1 if there
+  is no complete frame.
+*/
+int vpNetwork::_handleFirstBinaryRequest()
+{
+  for (unsigned int r = 0; r < receptor_list.size(); r++) {
+    vpReceptor &receptor = receptor_list[r];
+
+    while (receptor.receivedEnd - receptor.receivedBegin >= vpBinaryHeaderSize) {
+      const char *header = &receptor.receivedData[receptor.receivedBegin];
+      const size_t available = receptor.receivedEnd - receptor.receivedBegin;
+      if (readUInt32(header) != vpBinaryMagic) {
+        if (verboseMode)
+          vpTRACE("Incorrect message");
+        receptor.receivedBegin = receptor.receivedEnd = 0;
+        break;
+      }
+
+      const uint32_t idSize = readUInt32(header + 4);
+      const uint32_t nbParams = readUInt32(header + 8);
+      const size_t frameSize = vpBinaryHeaderSize + readUInt32(header + 12);
+      if (frameSize > max_size_frame) {
+        // Drop the frame and what follows, the stream can't be resynchronized
+        if (verboseMode)
+          vpTRACE("Message larger than the maximum frame size");
+        receptor.receivedBegin = receptor.receivedEnd = 0;
+        break;
+      }
+      if (available < frameSize) {
+        // Wait for the end of the frame
+        break;
+      }
+      receptor.receivedBegin += frameSize;
+      if (receptor.receivedBegin == receptor.receivedEnd) {
+        receptor.receivedBegin = receptor.receivedEnd = 0;
+      }
+
+      const char *payload = header + vpBinaryHeaderSize;
+      const char *payloadEnd = header + frameSize;
+      if (idSize > frameSize - vpBinaryHeaderSize) {
+        if (verboseMode)
+          vpTRACE("Incorrect message");
+        continue;
+      }
+      std::string id(payload, idSize);
+
+      int indRequest = -1;
+      for (unsigned int i = 0; i < request_list.size(); i++) {
+        if (id == request_list[i]->getId()) {
+          indRequest = (int)i;
+          break;
+        }
+      }
+
+      if (indRequest == -1) {
+        if (verboseMode)
+          vpTRACE("No request corresponds to the received message");
+        continue;
+      }
+
+      // The parameters are copied in the request: the bytes of the frame may
+      // be overwritten by the next reception
+      vpRequest *req = request_list[(unsigned)indRequest];
+      req->clear();
+      const char *param = payload + idSize;
+      bool isValid = true;
+      for (uint32_t i = 0; i < nbParams; i++) {
+        if (payloadEnd - param < (ptrdiff_t)sizeof(uint32_t)) {
+          isValid = false;
+          break;
+        }
+        const uint32_t paramSize = readUInt32(param);
+        param += sizeof(uint32_t);
+        if ((size_t)(payloadEnd - param) < paramSize) {
+          isValid = false;
+          break;
+        }
+        std::string value(param, paramSize);
+        req->addParameter(value);
+        param += paramSize;
+      }
+
+      if (!isValid) {
+        if (verboseMode)
+          vpTRACE("Incorrect message");
+        req->clear();
+        continue;
+      }
+
+      return indRequest;
+    }
+  }
+
+  return -1;
+}
+
+/*!
+  Send a request to a specific receptor with the binary protocol. The header,
+  the id and the parameters are sent with a single scatter/gather call, so
+  that the parameters added with vpRequest::addParameterBuffer() are not
+  copied.
+
+  \param req : Request to send.
+  \param dest : Index of the receptor receiving the request.
+
+  \return The number of bytes that have been sent, -1 if an error occured.
+*/
+int vpNetwork::_sendBinaryRequestTo(vpRequest &req, const unsigned int &dest)
+{
+  const std::string id = req.getId();
+  const unsigned int nbParams = req.size();
+
+  std::vector<uint32_t> paramSizes(nbParams);
+  size_t payloadSize = id.size();
+  for (unsigned int i = 0; i < nbParams; i++) {
+    paramSizes[i] = htonl(req.getParameterSize(i));
+    payloadSize += sizeof(uint32_t) + req.getParameterSize(i);
+  }
+
+  uint32_t header[4];
+  header[0] = htonl(vpBinaryMagic);
+  header[1] = htonl((uint32_t)id.size());
+  header[2] = htonl(nbParams);
+  header[3] = htonl((uint32_t)payloadSize);
+
+  if (!receptor_list[dest].noDelay) {
+    // A frame is written at once, it must not wait for the acknowledgement of
+    // the previous one
+    int noDelay = 1;
+    setsockopt(receptor_list[dest].socketFileDescriptorReceptor, IPPROTO_TCP, TCP_NODELAY, (const char *)&noDelay,
+               sizeof(noDelay));
+    receptor_list[dest].noDelay = true;
+  }
+
+  int flags = 0;
+#if defined(__linux__)
+  flags = MSG_NOSIGNAL; // Only for Linux
+#endif
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  std::vector<struct iovec> iov;
+  iov.reserve(2 + 2 * nbParams);
+  struct iovec vec;
+  vec.iov_base = (void *)header;
+  vec.iov_len = sizeof(header);
+  iov.push_back(vec);
+  vec.iov_base = (void *)id.data();
+  vec.iov_len = id.size();
+  iov.push_back(vec);
+  for (unsigned int i = 0; i < nbParams; i++) {
+    vec.iov_base = (void *)&paramSizes[i];
+    vec.iov_len = sizeof(uint32_t);
+    iov.push_back(vec);
+    vec.iov_base = (void *)req.getParameterData(i);
+    vec.iov_len = req.getParameterSize(i);
+    iov.push_back(vec);
+  }
+
+#ifdef IOV_MAX
+  const size_t maxIov = IOV_MAX;
+#else
+  const size_t maxIov = 1024;
+#endif
+
+  // Send until all the frame has been written, resuming after partial writes
+  size_t first = 0;
+  size_t sent = 0;
+  while (first < iov.size()) {
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov[first];
+    msg.msg_iovlen = std::min(iov.size() - first, maxIov);
+
+    ssize_t value = sendmsg(receptor_list[dest].socketFileDescriptorReceptor, &msg, flags);
+    if (value < 0) {
+      if (errno == EINTR)
+        continue;
+      if (verboseMode)
+        vpERROR_TRACE("Send error");
+      return -1;
+    }
+
+    sent += (size_t)value;
+    size_t remaining = (size_t)value;
+    while (first < iov.size() && remaining >= iov[first].iov_len) {
+      remaining -= iov[first].iov_len;
+      first++;
+    }
+    if (remaining > 0) {
+      iov[first].iov_base = (void *)((char *)iov[first].iov_base + remaining);
+      iov[first].iov_len -= remaining;
+    }
+  }
+
+  return (int)sent;
+#else
+  // No scatter/gather send: the frame is gathered in a single buffer
+  std::string message((const char *)header, sizeof(header));
+  message.reserve(sizeof(header) + payloadSize);
+  message += id;
+  for (unsigned int i = 0; i < nbParams; i++) {
+    message.append((const char *)&paramSizes[i], sizeof(uint32_t));
+    message.append(req.getParameterData(i), req.getParameterSize(i));
+  }
+
+  size_t sent = 0;
+  while (sent < message.size()) {
+    int value = send((unsigned)receptor_list[dest].socketFileDescriptorReceptor, message.data() + sent,
+                     (int)(message.size() - sent), flags);
+    if (value <= 0) {
+      if (verboseMode)
+        vpERROR_TRACE("Send error");
+      return -1;
+    }
+    sent += (size_t)value;
+  }
+
+  return (int)sent;
+#endif
+}
+
+/*!
+  Read the data available on the socket of a receptor with the binary
+  protocol. The socket is expected to be readable: a first blocking read is
+  done, then the socket is drained without blocking. The data is appended to
+  the buffer of the receptor.
+
+  \param receptorEmitting : Index of the receptor emitting the message.
+
+  \return The number of bytes received, or the result of the first read if
+  it failed or if the receptor has been disconnected.
+*/
+int vpNetwork::_receiveBinaryData(const unsigned int &receptorEmitting)
+{
+  vpReceptor &receptor = receptor_list[receptorEmitting];
+  int flags = 0;
+  int numbytes = 0;
+
+  while (true) {
+    if (receptor.receivedData.size() - receptor.receivedEnd < max_size_message) {
+      // Move the bytes not yet handled to the beginning of the buffer, and
+      // grow it only if there is still not enough room
+      if (receptor.receivedBegin > 0) {
+        memmove(&receptor.receivedData[0], &receptor.receivedData[receptor.receivedBegin],
+                receptor.receivedEnd - receptor.receivedBegin);
+        receptor.receivedEnd -= receptor.receivedBegin;
+        receptor.receivedBegin = 0;
+      }
+      if (receptor.receivedData.size() - receptor.receivedEnd < max_size_message) {
+        receptor.receivedData.resize(receptor.receivedEnd + max_size_message);
+      }
+    }
+
+    char *buf = &receptor.receivedData[receptor.receivedEnd];
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    int value = (int)recv(receptor.socketFileDescriptorReceptor, buf, max_size_message, flags);
+#else
+    int value = recv((unsigned int)receptor.socketFileDescriptorReceptor, buf, (int)max_size_message, flags);
+#endif
+
+    if (value <= 0) {
+      if (numbytes == 0) {
+        // Nothing has been read: error or deconnection
+        numbytes = value;
+      }
+      break;
+    }
+    receptor.receivedEnd += (size_t)value;
+    numbytes += value;
+
+    if (receptor.receivedEnd - receptor.receivedBegin >= max_size_frame) {
+      // Let the frames be handled before the buffer grows any further
+      break;
+    }
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    if ((unsigned int)value < max_size_message) {
+      break;
+    }
+    // Drain the socket without blocking
+    flags = MSG_DONTWAIT;
+#else
+    break;
+#endif
+  }
+
+  return numbytes;
+}
+
 /*!
   Receive requests untils there is requests to receive.
 
@@ -686,6 +1020,15 @@ int vpNetwork::_receiveRequestOnce()
   } else {
     for (unsigned int i = 0; i < receptor_list.size(); i++) {
       if (FD_ISSET((unsigned int)receptor_list[i].socketFileDescriptorReceptor, &readFileDescriptor)) {
+        if (binaryProtocol) {
+          numbytes = _receiveBinaryData(i);
+          if (numbytes <= 0) {
+            std::cout << "Disconnected : " << inet_ntoa(receptor_list[i].receptorAddress.sin_addr) << std::endl;
+            receptor_list.erase(receptor_list.begin() + (int)i);
+          }
+          return numbytes;
+        }
+
         char *buf = new char[max_size_message];
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
         numbytes = (int)recv(receptor_list[i].socketFileDescriptorReceptor, buf, max_size_message, 0);
@@ -765,6 +1108,16 @@ int vpNetwork::_receiveRequestOnceFrom(const unsigned int &receptorEmitting)
     return 0;
   } else {
     if (FD_ISSET((unsigned int)receptor_list[receptorEmitting].socketFileDescriptorReceptor, &readFileDescriptor)) {
+      if (binaryProtocol) {
+        numbytes = _receiveBinaryData(receptorEmitting);
+        if (numbytes <= 0) {
+          std::cout << "Disconnected : " << inet_ntoa(receptor_list[receptorEmitting].receptorAddress.sin_addr)
+                    << std::endl;
+          receptor_list.erase(receptor_list.begin() + (int)receptorEmitting);
+        }
+        return numbytes;
+      }
+
       char *buf = new char[max_size_message];
 #if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
       numbytes = (int)recv(receptor_list[receptorEmitting].socketFileDescriptorReceptor, buf, max_size_message, 0);
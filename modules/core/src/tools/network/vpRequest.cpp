@@ -38,7 +38,7 @@
 
 #include <visp3/core/vpRequest.h>
 
-vpRequest::vpRequest() : request_id(""), listOfParams() {}
+vpRequest::vpRequest() : request_id(""), listOfParams(), listOfBuffers() {}
 
 vpRequest::~vpRequest() {}
 
@@ -53,6 +53,7 @@ void vpRequest::addParameter(char *params)
 {
   std::string val = params;
   listOfParams.push_back(val);
+  listOfBuffers.resize(listOfParams.size(), std::pair<const char *, unsigned int>((const char *)NULL, 0));
 }
 
 /*!
@@ -62,7 +63,11 @@ void vpRequest::addParameter(char *params)
 
   \param params : std::string representing the message to add.
 */
-void vpRequest::addParameter(std::string &params) { listOfParams.push_back(params); }
+void vpRequest::addParameter(std::string &params)
+{
+  listOfParams.push_back(params);
+  listOfBuffers.resize(listOfParams.size(), std::pair<const char *, unsigned int>((const char *)NULL, 0));
+}
 
 /*!
   Add messages as parameters of the request.
@@ -75,5 +80,25 @@ void vpRequest::addParameter(std::string &params) { listOfParams.push_back(param
 void vpRequest::addParameter(std::vector<std::string> &listOfparams)
 {
   for (unsigned int i = 0; i < listOfparams.size(); i++)
-    listOfparams.push_back(listOfparams[i]);
+    listOfParams.push_back(listOfparams[i]);
+  listOfBuffers.resize(listOfParams.size(), std::pair<const char *, unsigned int>((const char *)NULL, 0));
+}
+
+/*!
+  Add a parameter to the request without copying its memory. The buffer has
+  to remain valid until the request is sent. This is intended for large
+  parameters like the bitmap of a vpImage or the data of a vpArray2D, that
+  are directly sent from the user memory with the binary protocol of
+  vpNetwork.
+
+  \sa vpRequest::addParameterObject()
+
+  \param params : Pointer to the first byte of the parameter.
+  \param sizeOfBuffer : Size in bytes of the parameter.
+*/
+void vpRequest::addParameterBuffer(const void *params, const unsigned int &sizeOfBuffer)
+{
+  listOfParams.push_back(std::string());
+  listOfBuffers.resize(listOfParams.size(), std::pair<const char *, unsigned int>((const char *)NULL, 0));
+  listOfBuffers.back() = std::pair<const char *, unsigned int>((const char *)params, sizeOfBuffer);
 }
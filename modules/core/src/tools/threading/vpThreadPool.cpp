@@ -0,0 +1,523 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Persistent pool of worker threads.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <deque>
+#include <string>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpThreadPool.h>
+
+#if defined(VISP_HAVE_PTHREAD)
+#include <pthread.h>
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <exception>
+#endif
+
+#if defined(_WIN32)
+// Include WinSock2.h before windows.h to ensure that winsock.h is not
+// included by windows.h since winsock.h and winsock2.h are incompatible
+#include <WinSock2.h>
+#include <windows.h>
+#elif defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))
+#include <unistd.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Mutex and condition variable, no-op when there is no threading support
+#if defined(VISP_HAVE_PTHREAD)
+class vpPoolMutex
+{
+public:
+  vpPoolMutex() : m_mutex() { pthread_mutex_init(&m_mutex, NULL); }
+  ~vpPoolMutex() { pthread_mutex_destroy(&m_mutex); }
+  void lock() { pthread_mutex_lock(&m_mutex); }
+  void unlock() { pthread_mutex_unlock(&m_mutex); }
+
+  pthread_mutex_t m_mutex;
+
+private:
+  vpPoolMutex(const vpPoolMutex &);
+  vpPoolMutex &operator=(const vpPoolMutex &);
+};
+
+class vpPoolCondition
+{
+public:
+  vpPoolCondition() : m_cond() { pthread_cond_init(&m_cond, NULL); }
+  ~vpPoolCondition() { pthread_cond_destroy(&m_cond); }
+  void wait(vpPoolMutex &mutex) { pthread_cond_wait(&m_cond, &mutex.m_mutex); }
+  void notifyOne() { pthread_cond_signal(&m_cond); }
+  void notifyAll() { pthread_cond_broadcast(&m_cond); }
+
+private:
+  vpPoolCondition(const vpPoolCondition &);
+  vpPoolCondition &operator=(const vpPoolCondition &);
+
+  pthread_cond_t m_cond;
+};
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+class vpPoolMutex
+{
+public:
+  vpPoolMutex() : m_mutex() {}
+  void lock() { m_mutex.lock(); }
+  void unlock() { m_mutex.unlock(); }
+
+  std::mutex m_mutex;
+};
+
+class vpPoolCondition
+{
+public:
+  vpPoolCondition() : m_cond() {}
+  void wait(vpPoolMutex &mutex) { m_cond.wait(mutex.m_mutex); }
+  void notifyOne() { m_cond.notify_one(); }
+  void notifyAll() { m_cond.notify_all(); }
+
+private:
+  std::condition_variable_any m_cond;
+};
+#else
+class vpPoolMutex
+{
+public:
+  void lock() {}
+  void unlock() {}
+};
+
+class vpPoolCondition
+{
+public:
+  void wait(vpPoolMutex &) {}
+  void notifyOne() {}
+  void notifyAll() {}
+};
+#endif
+}
+
+class vpThreadPool::vpThreadPoolImpl
+{
+public:
+  explicit vpThreadPoolImpl(unsigned int nbThreads);
+  ~vpThreadPoolImpl();
+
+  unsigned int getNbThreads() const { return (unsigned int)m_workers.size(); }
+  void run(const std::vector<vpTask *> &tasks);
+
+private:
+  struct vpBatch {
+    //! Number of tasks of the batch that are not finished
+    size_t m_remaining;
+    //! True if a task of the batch threw an exception
+    bool m_failed;
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    //! Exception thrown by the first failed task
+    std::exception_ptr m_exception;
+#else
+    //! Exception thrown by the first failed task if it is a vpException
+    bool m_isVpException;
+    int m_code;
+    std::string m_message;
+#endif
+  };
+
+  struct vpItem {
+    vpTask *m_task;
+    vpBatch *m_batch;
+  };
+
+  //! Queue of tasks of a worker, with its own lock
+  struct vpQueue {
+    vpPoolMutex m_mutex;
+    std::deque<vpItem> m_items;
+  };
+
+  struct vpWorker {
+    vpThreadPoolImpl *m_pool;
+    unsigned int m_id;
+  };
+
+  void execute(const vpItem &item);
+  bool pop(unsigned int queueId, const vpBatch *batch, vpItem &item);
+  void workerLoop(unsigned int id);
+
+#if defined(VISP_HAVE_PTHREAD)
+  static void *workerEntry(void *arg)
+  {
+    vpWorker *worker = static_cast<vpWorker *>(arg);
+    worker->m_pool->workerLoop(worker->m_id);
+    return NULL;
+  }
+
+  std::vector<pthread_t> m_threads;
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  static void workerEntry(vpWorker *worker) { worker->m_pool->workerLoop(worker->m_id); }
+
+  std::vector<std::thread> m_threads;
+#endif
+  //! One queue of tasks per worker (a single one without worker)
+  vpQueue *m_queues;
+  unsigned int m_nbQueues;
+  std::vector<vpWorker> m_workers;
+
+  //! Protects the counters below, the batches and the stop flag. The queues
+  //! have their own lock.
+  vpPoolMutex m_mutex;
+  //! Signaled once per queued task to wake up an idle worker
+  vpPoolCondition m_workCond;
+  //! Signaled when a batch is finished
+  vpPoolCondition m_doneCond;
+  //! Number of tasks in the queues
+  size_t m_nbQueued;
+  //! Number of workers waiting for a task
+  unsigned int m_nbIdle;
+  unsigned int m_nextQueue;
+  bool m_stop;
+};
+
+vpThreadPool::vpThreadPoolImpl::vpThreadPoolImpl(unsigned int nbThreads)
+  :
+#if defined(VISP_HAVE_PTHREAD) || defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    m_threads(),
+#endif
+    m_queues(NULL), m_nbQueues(0), m_workers(), m_mutex(), m_workCond(), m_doneCond(), m_nbQueued(0), m_nbIdle(0),
+    m_nextQueue(0), m_stop(false)
+{
+#if !defined(VISP_HAVE_PTHREAD) && !defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  nbThreads = 0;
+#endif
+
+  m_nbQueues = nbThreads > 0 ? nbThreads : 1;
+  m_queues = new vpQueue[m_nbQueues];
+  m_workers.resize(nbThreads);
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    m_workers[i].m_pool = this;
+    m_workers[i].m_id = i;
+  }
+
+#if defined(VISP_HAVE_PTHREAD)
+  m_threads.resize(nbThreads);
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    int err = pthread_create(&m_threads[i], NULL, workerEntry, &m_workers[i]);
+    if (err != 0) {
+      // Keep the workers already created. Their queues are still used by
+      // run() and emptied by the other workers and the calling thread.
+      m_workers.resize(i);
+      m_threads.resize(i);
+      break;
+    }
+  }
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    m_threads.push_back(std::thread(workerEntry, &m_workers[i]));
+  }
+#endif
+}
+
+vpThreadPool::vpThreadPoolImpl::~vpThreadPoolImpl()
+{
+  m_mutex.lock();
+  m_stop = true;
+  m_workCond.notifyAll();
+  m_mutex.unlock();
+
+#if defined(VISP_HAVE_PTHREAD)
+  for (size_t i = 0; i < m_threads.size(); i++) {
+    pthread_join(m_threads[i], NULL);
+  }
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  for (size_t i = 0; i < m_threads.size(); i++) {
+    m_threads[i].join();
+  }
+#endif
+
+  delete[] m_queues;
+}
+
+/*
+  Run a task, then record the end of the task and its exception in its batch.
+*/
+void vpThreadPool::vpThreadPoolImpl::execute(const vpItem &item)
+{
+  vpBatch &batch = *item.m_batch;
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  std::exception_ptr exception;
+  try {
+    item.m_task->run();
+  } catch (...) {
+    exception = std::current_exception();
+  }
+
+  m_mutex.lock();
+  if (exception && !batch.m_failed) {
+    batch.m_failed = true;
+    batch.m_exception = exception;
+  }
+#else
+  bool failed = false, isVpException = false;
+  int code = vpException::fatalError;
+  std::string message;
+  try {
+    item.m_task->run();
+  } catch (vpException &e) {
+    failed = true;
+    isVpException = true;
+    code = e.getCode();
+    message = e.getStringMessage();
+  } catch (...) {
+    failed = true;
+  }
+
+  m_mutex.lock();
+  if (failed && !batch.m_failed) {
+    batch.m_failed = true;
+    batch.m_isVpException = isVpException;
+    batch.m_code = code;
+    batch.m_message = message;
+  }
+#endif
+  batch.m_remaining--;
+  if (batch.m_remaining == 0) {
+    m_doneCond.notifyAll();
+  }
+  m_mutex.unlock();
+}
+
+/*
+  Take a task from the front of the queue \e queueId or, if it is empty,
+  steal one from the back of the other queues. If \e batch is not NULL, only
+  the tasks of this batch are considered. Only the lock of the queue being
+  looked at is held.
+*/
+bool vpThreadPool::vpThreadPoolImpl::pop(unsigned int queueId, const vpBatch *batch, vpItem &item)
+{
+  bool found = false;
+  for (unsigned int k = 0; k < m_nbQueues && !found; k++) {
+    vpQueue &queue = m_queues[(queueId + k) % m_nbQueues];
+    queue.m_mutex.lock();
+    if (!queue.m_items.empty()) {
+      if (batch == NULL) {
+        if (k == 0) {
+          item = queue.m_items.front();
+          queue.m_items.pop_front();
+        } else {
+          item = queue.m_items.back();
+          queue.m_items.pop_back();
+        }
+        found = true;
+      } else {
+        for (std::deque<vpItem>::iterator it = queue.m_items.begin(); it != queue.m_items.end(); ++it) {
+          if (it->m_batch == batch) {
+            item = *it;
+            queue.m_items.erase(it);
+            found = true;
+            break;
+          }
+        }
+      }
+    }
+    queue.m_mutex.unlock();
+  }
+
+  if (found) {
+    m_mutex.lock();
+    m_nbQueued--;
+    m_mutex.unlock();
+  }
+  return found;
+}
+
+void vpThreadPool::vpThreadPoolImpl::workerLoop(unsigned int id)
+{
+  while (true) {
+    vpItem item;
+    if (pop(id, NULL, item)) {
+      execute(item);
+      continue;
+    }
+
+    // Nothing to do: sleep until a task is queued
+    m_mutex.lock();
+    while (m_nbQueued == 0 && !m_stop) {
+      m_nbIdle++;
+      m_workCond.wait(m_mutex);
+      m_nbIdle--;
+    }
+    const bool stop = m_stop && m_nbQueued == 0;
+    m_mutex.unlock();
+    if (stop) {
+      break;
+    }
+  }
+}
+
+void vpThreadPool::vpThreadPoolImpl::run(const std::vector<vpTask *> &tasks)
+{
+  if (tasks.empty()) {
+    return;
+  }
+
+  vpBatch batch;
+  batch.m_remaining = tasks.size();
+  batch.m_failed = false;
+#if !defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  batch.m_isVpException = false;
+  batch.m_code = vpException::fatalError;
+#endif
+
+  // The tasks are counted before being queued so that the counter never
+  // underflows when a worker takes a task as soon as it is queued
+  m_mutex.lock();
+  const unsigned int firstQueue = m_nextQueue;
+  m_nextQueue = (unsigned int)((m_nextQueue + tasks.size()) % m_nbQueues);
+  m_nbQueued += tasks.size();
+  m_mutex.unlock();
+
+  for (size_t i = 0; i < tasks.size(); i++) {
+    vpItem item;
+    item.m_task = tasks[i];
+    item.m_batch = &batch;
+    vpQueue &queue = m_queues[(firstQueue + i) % m_nbQueues];
+    queue.m_mutex.lock();
+    queue.m_items.push_back(item);
+    queue.m_mutex.unlock();
+  }
+
+  // Wake up one idle worker per task
+  m_mutex.lock();
+  const size_t nbWakeUp = std::min(tasks.size(), (size_t)m_nbIdle);
+  for (size_t i = 0; i < nbWakeUp; i++) {
+    m_workCond.notifyOne();
+  }
+  m_mutex.unlock();
+
+  // The calling thread helps with its own batch, then waits for the tasks
+  // of the batch that are executed by the workers
+  vpItem item;
+  while (pop(firstQueue, &batch, item)) {
+    execute(item);
+  }
+  m_mutex.lock();
+  while (batch.m_remaining > 0) {
+    m_doneCond.wait(m_mutex);
+  }
+  m_mutex.unlock();
+
+  if (batch.m_failed) {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    std::rethrow_exception(batch.m_exception);
+#else
+    if (batch.m_isVpException) {
+      throw(vpException(batch.m_code, batch.m_message));
+    }
+    throw(vpException(vpException::fatalError, "A task executed by the thread pool threw an exception"));
+#endif
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Create the pool and start its worker threads.
+
+  \param nbThreads : Number of worker threads. If negative, one worker less
+  than the number of processors is created since the thread that calls run()
+  also executes tasks. With 0 worker, the tasks are executed sequentially by
+  the calling thread.
+*/
+vpThreadPool::vpThreadPool(int nbThreads) : m_impl(NULL)
+{
+  if (nbThreads < 0) {
+    nbThreads = (int)getNbProcessors() - 1;
+  }
+  m_impl = new vpThreadPoolImpl((unsigned int)nbThreads);
+}
+
+/*!
+  Wait for the worker threads to finish and destroy them.
+*/
+vpThreadPool::~vpThreadPool() { delete m_impl; }
+
+/*!
+  Return the process-wide pool, created at first use with one worker less
+  than the number of processors.
+*/
+vpThreadPool &vpThreadPool::getInstance()
+{
+  static vpThreadPool pool;
+  return pool;
+}
+
+/*!
+  Return the number of processors available, or 1 if it cannot be
+  determined.
+*/
+unsigned int vpThreadPool::getNbProcessors()
+{
+  long nbProcessors = 1;
+#if defined(_WIN32)
+  SYSTEM_INFO sysinfo;
+  GetSystemInfo(&sysinfo);
+  nbProcessors = (long)sysinfo.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+  nbProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+  return nbProcessors > 1 ? (unsigned int)nbProcessors : 1;
+}
+
+/*!
+  Return the number of worker threads, without the calling thread.
+*/
+unsigned int vpThreadPool::getNbThreads() const { return m_impl->getNbThreads(); }
+
+/*!
+  Execute the tasks and return when all of them are finished. The calling
+  thread executes the tasks of the batch that are not yet taken by a worker.
+  The tasks must remain valid until the function returns.
+
+  If a task throws an exception, the other tasks are still executed and the
+  exception of the first failed task is rethrown once the batch is done.
+  Without C++11 support, only the code and the message of a vpException are
+  kept, and the other exceptions are reported as vpException::fatalError.
+*/
+void vpThreadPool::run(const std::vector<vpTask *> &tasks) { m_impl->run(tasks); }
@@ -105,6 +105,12 @@ vpPoint::vpPoint(const std::vector<double> &P)
   setWorldCoordinates(P);
 }
 
+/*!
+  Copy constructor.
+  \param vpp : Point to copy.
+*/
+vpPoint::vpPoint(const vpPoint &vpp) : vpForwardProjection(vpp) {}
+
 /*!
   Set the 3D point world coordinates. We mean here the coordinates of the
   point in the object frame. \param oX, oY, oZ: Coordinates of a 3D point in
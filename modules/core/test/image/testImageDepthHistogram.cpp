@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImageConvert::createDepthHistogram().
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageDepthHistogram.cpp
+
+  \brief Test vpImageConvert::createDepthHistogram() against a reference
+  implementation, check that concurrent calls give the same result and
+  measure the conversion time of a 848x480 depth image.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <string.h>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+void fill(vpImage<uint16_t> &I, unsigned int seed)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      // Holes without depth and a slanted plane with some noise
+      if ((i / 20 + j / 30 + seed) % 7 == 0) {
+        I[i][j] = 0;
+      } else {
+        I[i][j] = (uint16_t)(400 + 3 * i + 2 * j + 10 * seed + (i * 7919 + j * 104729 + seed) % 23);
+      }
+    }
+  }
+}
+
+// Color depth image computed as createDepthHistogram() used to
+void reference(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba)
+{
+  dest_rgba.resize(src_depth.getHeight(), src_depth.getWidth());
+  std::vector<uint32_t> histogram(0x10000, 0);
+
+  for (unsigned int i = 0; i < src_depth.getSize(); ++i)
+    ++histogram[src_depth.bitmap[i]];
+  for (int i = 2; i < 0x10000; ++i)
+    histogram[i] += histogram[i - 1];
+
+  for (unsigned int i = 0; i < src_depth.getSize(); ++i) {
+    uint16_t d = src_depth.bitmap[i];
+    if (d) {
+      int f = (int)(histogram[d] * 255 / histogram[0xFFFF]);
+      dest_rgba.bitmap[i] = vpRGBa((unsigned char)(255 - f), 0, (unsigned char)f, vpRGBa::alpha_default);
+    } else {
+      dest_rgba.bitmap[i] = vpRGBa(20, 5, 0, vpRGBa::alpha_default);
+    }
+  }
+}
+
+class vpDepthTask : public vpThreadPool::vpTask
+{
+public:
+  vpDepthTask(const vpImage<uint16_t> &depth) : m_depth(depth), m_color(), m_histogram() {}
+
+  virtual void run()
+  {
+    for (unsigned int i = 0; i < 20; i++) {
+      vpImageConvert::createDepthHistogram(m_depth, m_color, m_histogram);
+    }
+  }
+
+  const vpImage<uint16_t> &m_depth;
+  vpImage<vpRGBa> m_color;
+  std::vector<uint32_t> m_histogram;
+};
+}
+
+int main()
+{
+  // Sizes that exercise the vectorized loop and its remainder
+  const unsigned int sizes[][2] = {{480, 848}, {121, 163}, {1, 5}};
+  std::vector<uint32_t> histogram;
+  for (unsigned int s = 0; s < 3; s++) {
+    vpImage<uint16_t> depth(sizes[s][0], sizes[s][1]);
+    fill(depth, s);
+
+    vpImage<vpRGBa> Iref, Icolor;
+    reference(depth, Iref);
+    vpImageConvert::createDepthHistogram(depth, Icolor);
+    if (!(Icolor == Iref)) {
+      std::cerr << "Bad color depth image of size " << sizes[s][1] << "x" << sizes[s][0] << std::endl;
+      return EXIT_FAILURE;
+    }
+    vpImageConvert::createDepthHistogram(depth, Icolor, histogram);
+    if (!(Icolor == Iref)) {
+      std::cerr << "Bad color depth image with a reused histogram" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpImage<unsigned char> Igray;
+    vpImageConvert::createDepthHistogram(depth, Igray, histogram);
+    for (unsigned int i = 0; i < depth.getSize(); i++) {
+      if (Igray.bitmap[i] != (depth.bitmap[i] ? Iref.bitmap[i].B : 0)) {
+        std::cerr << "Bad grayscale depth image of size " << sizes[s][1] << "x" << sizes[s][0] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  vpImage<uint16_t> depth(480, 848);
+  fill(depth, 0);
+  vpImage<vpRGBa> Iref;
+  reference(depth, Iref);
+
+  // A subsampled histogram gives a close result
+  vpImage<vpRGBa> Isubsampled;
+  vpImageConvert::createDepthHistogram(depth, Isubsampled, histogram, 4);
+  for (unsigned int i = 0; i < depth.getSize(); i++) {
+    if (std::abs((int)Isubsampled.bitmap[i].B - (int)Iref.bitmap[i].B) > 4) {
+      std::cerr << "Bad subsampled color depth image: " << (int)Isubsampled.bitmap[i].B << " instead of "
+                << (int)Iref.bitmap[i].B << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Concurrent conversions of different streams
+  std::vector<vpImage<uint16_t> > streams(4, vpImage<uint16_t>(480, 848));
+  std::vector<vpDepthTask *> depthTasks;
+  std::vector<vpThreadPool::vpTask *> tasks;
+  for (unsigned int s = 0; s < streams.size(); s++) {
+    fill(streams[s], s + 1);
+    depthTasks.push_back(new vpDepthTask(streams[s]));
+    tasks.push_back(depthTasks.back());
+  }
+  vpThreadPool::getInstance().run(tasks);
+  bool concurrentOk = true;
+  for (unsigned int s = 0; s < streams.size(); s++) {
+    vpImage<vpRGBa> Icolor;
+    reference(streams[s], Icolor);
+    if (!(Icolor == depthTasks[s]->m_color)) {
+      std::cerr << "Bad color depth image for stream " << s << std::endl;
+      concurrentOk = false;
+    }
+    delete depthTasks[s];
+  }
+  if (!concurrentOk) {
+    return EXIT_FAILURE;
+  }
+
+  // Benchmark
+  const unsigned int nbIter = 200;
+  vpImage<vpRGBa> Icolor;
+  double t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    reference(depth, Icolor);
+  }
+  double t_reference = (vpTime::measureTimeMs() - t) / nbIter;
+
+  t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    vpImageConvert::createDepthHistogram(depth, Icolor, histogram);
+  }
+  double t_color = (vpTime::measureTimeMs() - t) / nbIter;
+
+  t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    vpImageConvert::createDepthHistogram(depth, Icolor, histogram, 4);
+  }
+  double t_subsampled = (vpTime::measureTimeMs() - t) / nbIter;
+
+  vpImage<unsigned char> Igray;
+  t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    vpImageConvert::createDepthHistogram(depth, Igray, histogram);
+  }
+  double t_gray = (vpTime::measureTimeMs() - t) / nbIter;
+
+  std::cout << "848x480 depth image: reference " << t_reference << " ms, color " << t_color
+            << " ms, color with a subsampled histogram " << t_subsampled << " ms, grayscale " << t_gray << " ms"
+            << std::endl;
+
+  std::cout << "vpImageConvert::createDepthHistogram() is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImagePyramid.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImagePyramid.cpp
+
+  \brief Test vpImagePyramid: 2x reduction, reuse of the buffers and parallel
+  build of several pyramids.
+*/
+
+#include <iostream>
+
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+void fill(vpImage<unsigned char> &I, unsigned int seed)
+{
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    seed = seed * 1103515245 + 12345;
+    I.bitmap[i] = (unsigned char)(seed >> 16);
+  }
+}
+
+bool checkDownScale2(const vpImage<unsigned char> &src, const vpImage<unsigned char> &dst)
+{
+  if (dst.getHeight() != src.getHeight() / 2 || dst.getWidth() != src.getWidth() / 2) {
+    std::cerr << "Bad size: " << dst.getHeight() << "x" << dst.getWidth() << std::endl;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < dst.getHeight(); i++) {
+    for (unsigned int j = 0; j < dst.getWidth(); j++) {
+      unsigned int a = (src[2 * i][2 * j] + src[2 * i + 1][2 * j] + 1) / 2;
+      unsigned int b = (src[2 * i][2 * j + 1] + src[2 * i + 1][2 * j + 1] + 1) / 2;
+      if (dst[i][j] != (a + b + 1) / 2) {
+        std::cerr << "Bad value at (" << i << ", " << j << "): " << (int)dst[i][j] << " instead of " << (a + b + 1) / 2
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  // Sizes that exercise the vectorized loop and its remainder
+  const unsigned int sizes[][2] = {{1, 1}, {2, 2}, {7, 33}, {31, 64}, {480, 640}, {481, 641}};
+  for (unsigned int k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+    vpImage<unsigned char> src(sizes[k][0], sizes[k][1]), dst;
+    fill(src, k);
+    vpImagePyramid::downScale2(src, dst);
+    if (!checkDownScale2(src, dst)) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Only the requested levels are available
+  vpImage<unsigned char> I(480, 640);
+  fill(I, 42);
+  std::vector<bool> levels(3, false);
+  levels[0] = true;
+  levels[2] = true;
+  vpImagePyramid pyramid;
+  pyramid.build(I, levels);
+  if (pyramid.getLevel(0) != &I || pyramid.getLevel(1) != NULL || pyramid.getLevel(2) == NULL ||
+      pyramid.getLevel(3) != NULL || pyramid.getLevel(2)->getHeight() != 120 ||
+      pyramid.getLevel(2)->getWidth() != 160) {
+    std::cerr << "Bad levels" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The buffers are reused by the next build
+  const unsigned char *bitmap = pyramid.getLevel(2)->bitmap;
+  fill(I, 43);
+  pyramid.build(I, levels);
+  if (pyramid.getLevel(2)->bitmap != bitmap) {
+    std::cerr << "The buffer of the level 2 was reallocated" << std::endl;
+    return EXIT_FAILURE;
+  }
+  vpImage<unsigned char> I1, I2;
+  vpImagePyramid::downScale2(I, I1);
+  vpImagePyramid::downScale2(I1, I2);
+  if (!(I2 == *pyramid.getLevel(2))) {
+    std::cerr << "Bad level 2" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Parallel build of the pyramids of several cameras
+  std::vector<vpImage<unsigned char> > images(3, vpImage<unsigned char>(240, 320));
+  std::vector<vpImagePyramid> pyramids(3);
+  std::vector<const vpImage<unsigned char> *> ptrImages;
+  std::vector<vpImagePyramid *> ptrPyramids;
+  for (unsigned int i = 0; i < images.size(); i++) {
+    fill(images[i], 100 + i);
+    ptrImages.push_back(&images[i]);
+    ptrPyramids.push_back(&pyramids[i]);
+  }
+  vpImagePyramid::build(ptrImages, std::vector<bool>(4, true), ptrPyramids);
+  for (unsigned int i = 0; i < images.size(); i++) {
+    vpImagePyramid ref;
+    ref.build(images[i], 4);
+    for (unsigned int lvl = 1; lvl < 4; lvl++) {
+      vpImage<unsigned char> refLevel = *ref.getLevel(lvl);
+      if (!(refLevel == *pyramids[i].getLevel(lvl))) {
+        std::cerr << "Bad level " << lvl << " of the pyramid " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // Benchmark
+  const unsigned int nbIter = 100;
+  double t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    pyramid.build(I, 4);
+  }
+  t = (vpTime::measureTimeMs() - t) / nbIter;
+  std::cout << "Pyramid of 4 levels of a 640x480 image: " << t << " ms" << std::endl;
+
+  std::cout << "vpImagePyramid is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,214 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpImageUndistortMap.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageUndistortMap.cpp
+
+  \brief Test vpImageUndistortMap against vpImageTools::undistort() on
+  grayscale and color images, and compare their computation times at 640x480
+  and 1920x1080.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpImageUndistortMap.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+void fill(vpImage<unsigned char> &I)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (unsigned char)(128 + 60 * sin(i / 7.0) + 60 * cos(j / 11.0));
+    }
+  }
+}
+
+void fill(vpImage<vpRGBa> &I)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = vpRGBa((unsigned char)(128 + 120 * sin(i / 9.0)), (unsigned char)(128 + 120 * cos(j / 5.0)),
+                       (unsigned char)((i + j) % 256));
+    }
+  }
+}
+
+unsigned int difference(unsigned char a, unsigned char b) { return (unsigned int)(a > b ? a - b : b - a); }
+
+unsigned int difference(const vpRGBa &a, const vpRGBa &b)
+{
+  return (std::max)(difference(a.R, b.R), (std::max)(difference(a.G, b.G), difference(a.B, b.B)));
+}
+
+/*
+  Return the ratio of pixels that differ by more than 2 levels. The
+  truncation of vpImageTools::undistort() and the fixed-point weights of the
+  map lead to small differences, and the pixels at the border of the valid
+  area are handled differently.
+*/
+template <class Type> double compare(const vpImage<Type> &I1, const vpImage<Type> &I2)
+{
+  if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+    return 1.0;
+  }
+  unsigned int nbDiff = 0;
+  for (unsigned int i = 0; i < I1.getSize(); i++) {
+    if (difference(I1.bitmap[i], I2.bitmap[i]) > 2) {
+      nbDiff++;
+    }
+  }
+  return nbDiff / (double)I1.getSize();
+}
+
+template <class Type> bool test(unsigned int height, unsigned int width, const vpCameraParameters &cam)
+{
+  vpImage<Type> I(height, width), Iref, Iundist;
+  fill(I);
+
+  vpImageUndistortMap map(cam, width, height);
+  vpImageTools::undistort(I, cam, Iref);
+  map.remap(I, Iundist);
+
+  double ratio = compare(Iref, Iundist);
+  if (ratio > 0.005) {
+    std::cerr << "Undistortion of a " << width << "x" << height << " image: " << ratio * 100
+              << "% of the pixels differ" << std::endl;
+    return false;
+  }
+
+  // In place remapping
+  vpImage<Type> Iinplace(I);
+  map.remap(Iinplace, Iinplace);
+  if (!(Iinplace == Iundist)) {
+    std::cerr << "In place undistortion of a " << width << "x" << height << " image differs" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+template <class Type> void benchmark(unsigned int height, unsigned int width, const vpCameraParameters &cam)
+{
+  const unsigned int nbIter = 20;
+  vpImage<Type> I(height, width), Iundist;
+  fill(I);
+
+  double t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    vpImageTools::undistort(I, cam, Iundist);
+  }
+  double t_undistort = (vpTime::measureTimeMs() - t) / nbIter;
+
+  t = vpTime::measureTimeMs();
+  vpImageUndistortMap map(cam, width, height);
+  double t_init = vpTime::measureTimeMs() - t;
+
+  t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    map.remap(I, Iundist);
+  }
+  double t_remap = (vpTime::measureTimeMs() - t) / nbIter;
+
+  std::cout << "  " << width << "x" << height << ": vpImageTools::undistort() " << t_undistort
+            << " ms, vpImageUndistortMap::remap() " << t_remap << " ms (init " << t_init << " ms)" << std::endl;
+}
+}
+
+int main()
+{
+  vpCameraParameters cam;
+  cam.initPersProjWithDistortion(600, 610, 320, 240, -0.19, 0.20);
+  vpCameraParameters camHD;
+  camHD.initPersProjWithDistortion(1400, 1400, 960, 540, 0.12, -0.11);
+
+  // Sizes that exercise the vectorized loop and its remainder
+  if (!test<unsigned char>(480, 640, cam) || !test<unsigned char>(479, 637, cam) ||
+      !test<vpRGBa>(480, 640, cam) || !test<vpRGBa>(1080, 1920, camHD)) {
+    return EXIT_FAILURE;
+  }
+
+  // Without distortion the image is copied
+  vpCameraParameters camNoDistortion(600, 610, 320, 240);
+  vpImage<unsigned char> I(480, 640), Iundist;
+  fill(I);
+  vpImageUndistortMap identity(camNoDistortion, 640, 480);
+  identity.remap(I, Iundist);
+  if (!(Iundist == I)) {
+    std::cerr << "Remapping without distortion differs from the image" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Distorting the undistorted image gives back the image in the center
+  vpImageUndistortMap distort(cam, 640, 480, vpImageUndistortMap::DISTORT);
+  vpImageUndistortMap undistort(cam, 640, 480);
+  vpImage<unsigned char> Idistorted;
+  undistort.remap(I, Iundist);
+  distort.remap(Iundist, Idistorted);
+  for (unsigned int i = 140; i < 340; i++) {
+    for (unsigned int j = 220; j < 420; j++) {
+      if (difference(I[i][j], Idistorted[i][j]) > 6) {
+        std::cerr << "Bad distortion at (" << i << ", " << j << "): " << (int)Idistorted[i][j] << " instead of "
+                  << (int)I[i][j] << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The size of the image must match the map
+  try {
+    vpImage<unsigned char> Ismall(240, 320);
+    undistort.remap(Ismall, Iundist);
+    std::cerr << "No exception for an image of bad size" << std::endl;
+    return EXIT_FAILURE;
+  } catch (vpException &e) {
+    if (e.getCode() != vpException::dimensionError) {
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Benchmark
+  std::cout << "Grayscale images:" << std::endl;
+  benchmark<unsigned char>(480, 640, cam);
+  benchmark<unsigned char>(1080, 1920, camHD);
+  std::cout << "Color images:" << std::endl;
+  benchmark<vpRGBa>(480, 640, cam);
+  benchmark<vpRGBa>(1080, 1920, camHD);
+
+  std::cout << "vpImageUndistortMap is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,298 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the separable filters of vpImageFilter.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceImageFilter.cpp
+
+  \brief Check that the separable filters of vpImageFilter give the same
+  result as the per-pixel implementation for 3, 5, 7 and 11-tap kernels,
+  that the single precision and fixed-point versions are close to the double
+  precision one, and measure the time taken by each of them.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Per-pixel filters, as implemented before the separable filters were
+// vectorized
+template <typename Type>
+void filterXReference(const vpImage<Type> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < (size - 1) / 2; j++) {
+      dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+    }
+    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
+      dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+    }
+    for (unsigned int j = I.getWidth() - (size - 1) / 2; j < I.getWidth(); j++) {
+      dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+    }
+  }
+}
+
+template <typename Type>
+void filterYReference(const vpImage<Type> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth());
+  for (unsigned int i = 0; i < (size - 1) / 2; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+    }
+  }
+  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+    }
+  }
+  for (unsigned int i = I.getHeight() - (size - 1) / 2; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+    }
+  }
+}
+
+void getGradXReference(const vpImage<double> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+{
+  dIx.resize(I.getHeight(), I.getWidth(), 0.0);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = (size - 1) / 2; j < I.getWidth() - (size - 1) / 2; j++) {
+      dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j, filter, size);
+    }
+  }
+}
+
+void getGradYReference(const vpImage<double> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+{
+  dIy.resize(I.getHeight(), I.getWidth(), 0.0);
+  for (unsigned int i = (size - 1) / 2; i < I.getHeight() - (size - 1) / 2; i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j, filter, size);
+    }
+  }
+}
+
+void blurReference(const vpImage<unsigned char> &I, vpImage<double> &GI, const double *filter, unsigned int size)
+{
+  vpImage<double> GIx;
+  filterXReference(I, GIx, filter, size);
+  filterYReference(GIx, GI, filter, size);
+}
+
+void gradientReference(const vpImage<unsigned char> &I, vpImage<double> &dIx, vpImage<double> &dIy,
+                       const double *gaussianKernel, const double *gaussianDerivativeKernel, unsigned int size)
+{
+  vpImage<double> GI;
+  filterYReference(I, GI, gaussianKernel, size);
+  getGradXReference(GI, dIx, gaussianDerivativeKernel, size);
+  filterXReference(I, GI, gaussianKernel, size);
+  getGradYReference(GI, dIy, gaussianDerivativeKernel, size);
+}
+
+template <typename Type> double maxDifference(const vpImage<Type> &I, const vpImage<double> &Iref)
+{
+  if (I.getHeight() != Iref.getHeight() || I.getWidth() != Iref.getWidth()) {
+    return 1e30;
+  }
+  double diff = 0;
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    diff = std::max(diff, std::fabs(I.bitmap[i] - Iref.bitmap[i]));
+  }
+  return diff;
+}
+
+bool check(double diff, double threshold, const std::string &name, unsigned int size)
+{
+  if (diff > threshold) {
+    std::cerr << name << " with a " << size << "-tap kernel differs from the reference by " << diff << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool testKernel(const vpImage<unsigned char> &I, unsigned int size, unsigned int nbIter)
+{
+  std::vector<double> g((size + 1) / 2), dg((size + 1) / 2);
+  std::vector<float> gf((size + 1) / 2), dgf((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&g[0], size);
+  vpImageFilter::getGaussianDerivativeKernel(&dg[0], size);
+  vpImageFilter::getGaussianKernel(&gf[0], size);
+  vpImageFilter::getGaussianDerivativeKernel(&dgf[0], size);
+
+  vpImage<double> GI_ref, dIx_ref, dIy_ref, GI, dIx, dIy, dIx_fused, dIy_fused;
+  vpImage<float> GI_float, dIx_float, dIy_float;
+  vpImage<unsigned char> GI_fixed;
+
+  double t_blur_ref = 0, t_blur = 0, t_blur_float = 0, t_blur_fixed = 0;
+  double t_grad_ref = 0, t_grad = 0, t_grad_fused = 0, t_grad_float = 0;
+  for (unsigned int iter = 0; iter < nbIter; iter++) {
+    double t = vpTime::measureTimeMs();
+    blurReference(I, GI_ref, &g[0], size);
+    t_blur_ref += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    vpImageFilter::filter(I, GI, &g[0], size);
+    t_blur += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    vpImageFilter::filter(I, GI_float, &gf[0], size);
+    t_blur_float += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    vpImageFilter::gaussianBlur(I, GI_fixed, size);
+    t_blur_fixed += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    gradientReference(I, dIx_ref, dIy_ref, &g[0], &dg[0], size);
+    t_grad_ref += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    vpImageFilter::getGradXGauss2D(I, dIx, &g[0], &dg[0], size);
+    vpImageFilter::getGradYGauss2D(I, dIy, &g[0], &dg[0], size);
+    t_grad += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    vpImageFilter::getGradXYGauss2D(I, dIx_fused, dIy_fused, &g[0], &dg[0], size);
+    t_grad_fused += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    vpImageFilter::getGradXYGauss2D(I, dIx_float, dIy_float, &gf[0], &dgf[0], size);
+    t_grad_float += vpTime::measureTimeMs() - t;
+  }
+
+  std::cout << size << "-tap kernel, " << I.getWidth() << "x" << I.getHeight() << " image:" << std::endl;
+  std::cout << "  blur: per-pixel " << t_blur_ref / nbIter << " ms ; double " << t_blur / nbIter << " ms ; float "
+            << t_blur_float / nbIter << " ms ; fixed-point " << t_blur_fixed / nbIter << " ms" << std::endl;
+  std::cout << "  gradients: per-pixel " << t_grad_ref / nbIter << " ms ; double " << t_grad / nbIter
+            << " ms ; fused double " << t_grad_fused / nbIter << " ms ; fused float " << t_grad_float / nbIter
+            << " ms" << std::endl;
+
+  // The double precision filters accumulate the terms in the same order as
+  // the per-pixel implementation
+  const double eps = 1e-9;
+  vpImage<double> GIx_ref, GIy_ref, GIx, GIy;
+  filterXReference(I, GIx_ref, &g[0], size);
+  filterYReference(I, GIy_ref, &g[0], size);
+  vpImageFilter::filterX(I, GIx, &g[0], size);
+  vpImageFilter::filterY(I, GIy, &g[0], size);
+
+  double diff_fixed = 0;
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    diff_fixed = std::max(diff_fixed, std::fabs(GI_fixed.bitmap[i] - vpMath::round(GI_ref.bitmap[i])));
+  }
+
+  return check(maxDifference(GIx, GIx_ref), eps, "filterX()", size) &&
+         check(maxDifference(GIy, GIy_ref), eps, "filterY()", size) &&
+         check(maxDifference(GI, GI_ref), eps, "filter()", size) &&
+         check(maxDifference(dIx, dIx_ref), eps, "getGradXGauss2D()", size) &&
+         check(maxDifference(dIy, dIy_ref), eps, "getGradYGauss2D()", size) &&
+         check(maxDifference(dIx_fused, dIx_ref), eps, "getGradXYGauss2D() along X", size) &&
+         check(maxDifference(dIy_fused, dIy_ref), eps, "getGradXYGauss2D() along Y", size) &&
+         check(maxDifference(GI_float, GI_ref), 1e-3, "filter() in single precision", size) &&
+         check(maxDifference(dIx_float, dIx_ref), 1e-3, "getGradXYGauss2D() along X in single precision", size) &&
+         check(maxDifference(dIy_float, dIy_ref), 1e-3, "getGradXYGauss2D() along Y in single precision", size) &&
+         check(diff_fixed, 1, "gaussianBlur() in fixed-point", size);
+}
+
+// Images smaller than the kernel are extended by reflection without reading
+// outside of the image: a uniform image stays uniform and has no gradient
+bool testSmallImages()
+{
+  const unsigned int size = 11;
+  std::vector<double> g((size + 1) / 2), dg((size + 1) / 2);
+  vpImageFilter::getGaussianKernel(&g[0], size);
+  vpImageFilter::getGaussianDerivativeKernel(&dg[0], size);
+
+  for (unsigned int height = 1; height <= 4; height++) {
+    for (unsigned int width = 1; width <= 4; width++) {
+      vpImage<unsigned char> I(height, width, 100), GI_fixed;
+      vpImage<double> GI, dIx, dIy, Iref(height, width, 100.0), Izero(height, width, 0.0);
+      vpImageFilter::filter(I, GI, &g[0], size);
+      vpImageFilter::gaussianBlur(I, GI_fixed, size);
+      vpImageFilter::getGradXYGauss2D(I, dIx, dIy, &g[0], &dg[0], size);
+      if (maxDifference(GI, Iref) > 1e-9 || maxDifference(GI_fixed, Iref) > 0 || maxDifference(dIx, Izero) > 1e-9 ||
+          maxDifference(dIy, Izero) > 1e-9) {
+        std::cerr << "Filtering of a uniform " << width << "x" << height << " image failed" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+  try {
+    // Textured image with noise
+    vpImage<unsigned char> I(480, 640);
+    vpUniRand rand(42);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double val = 127.5 + 50. * sin(j / 7.) * cos(i / 11.) + 50. * cos((i + j) / 17.) + 20. * (rand() - 0.5);
+        I[i][j] = (unsigned char)vpMath::round(val);
+      }
+    }
+
+    const unsigned int sizes[4] = {3, 5, 7, 11};
+    for (unsigned int k = 0; k < 4; k++) {
+      if (!testKernel(I, sizes[k], 10)) {
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (!testSmallImages()) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testPerformanceImageFilter is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
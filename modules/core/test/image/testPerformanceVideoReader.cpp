@@ -0,0 +1,303 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the image sequence reading with vpVideoReader.
+ *
+ *****************************************************************************/
+
+#include <iostream>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpParseArgv.h>
+#include <visp3/io/vpVideoReader.h>
+
+/*!
+  \example testPerformanceVideoReader.cpp
+
+  \brief Measure the number of frames per second read by vpVideoReader on
+  sequences of PGM and PNG images, with and without the read-ahead mode.
+  Check also that the images read ahead are the same.
+*/
+
+// List of allowed command line options
+#define GETOPTARGS "cdn:o:p:q:t:h"
+
+/*
+  Print the program options.
+
+  \param name : Program name.
+  \param badparam : Bad parameter name.
+  \param opath : Output image path.
+  \param user : Username.
+  \param nbFrames : Number of frames of the sequences.
+  \param depth : Number of images read ahead.
+  \param nbThreads : Number of threads reading ahead.
+  \param processingTime : Simulated processing time per frame.
+ */
+void usage(const char *name, const char *badparam, const std::string &opath, const std::string &user,
+           unsigned int nbFrames, unsigned int depth, unsigned int nbThreads, double processingTime)
+{
+  fprintf(stdout, "\n\
+Benchmark of the image sequence reading with vpVideoReader.\n\
+\n\
+SYNOPSIS\n\
+  %s [-o <output image path>] [-n <nb frames>] [-q <depth>]\n\
+     [-t <nb threads>] [-p <processing time>] [-h]\n", name);
+
+  fprintf(stdout, "\n\
+OPTIONS:                                               Default\n\
+  -o <output image path>                               %s\n\
+     Set image output path.\n\
+     From this directory, creates the \"%s\"\n\
+     subdirectory depending on the username, where \n\
+     the PGM and PNG sequences are written.\n\
+\n\
+  -n <nb frames>                                       %u\n\
+     Number of frames of the sequences.\n\
+\n\
+  -q <depth>                                           %u\n\
+     Number of images read ahead.\n\
+\n\
+  -t <nb threads>                                      %u\n\
+     Number of threads that read ahead the images.\n\
+\n\
+  -p <processing time>                                 %g\n\
+     Simulated processing time in ms of each frame.\n\
+\n\
+  -h\n\
+     Print the help.\n\n", opath.c_str(), user.c_str(), nbFrames, depth, nbThreads, processingTime);
+
+  if (badparam)
+    fprintf(stdout, "\nERROR: Bad parameter [%s]\n", badparam);
+}
+
+/*!
+  Set the program options.
+
+  \param argc : Command line number of parameters.
+  \param argv : Array of command line parameters.
+  \param opath : Output image path.
+  \param user : Username.
+  \param nbFrames : Number of frames of the sequences.
+  \param depth : Number of images read ahead.
+  \param nbThreads : Number of threads reading ahead.
+  \param processingTime : Simulated processing time per frame.
+  \return false if the program has to be stopped, true otherwise.
+*/
+bool getOptions(int argc, const char **argv, std::string &opath, const std::string &user, unsigned int &nbFrames,
+                unsigned int &depth, unsigned int &nbThreads, double &processingTime)
+{
+  const char *optarg_;
+  int c;
+  while ((c = vpParseArgv::parse(argc, argv, GETOPTARGS, &optarg_)) > 1) {
+
+    switch (c) {
+    case 'o':
+      opath = optarg_;
+      break;
+    case 'n':
+      nbFrames = (unsigned int)atoi(optarg_);
+      break;
+    case 'q':
+      depth = (unsigned int)atoi(optarg_);
+      break;
+    case 't':
+      nbThreads = (unsigned int)atoi(optarg_);
+      break;
+    case 'p':
+      processingTime = atof(optarg_);
+      break;
+    case 'h':
+      usage(argv[0], NULL, opath, user, nbFrames, depth, nbThreads, processingTime);
+      return false;
+      break;
+
+    case 'c':
+    case 'd':
+      break;
+
+    default:
+      usage(argv[0], optarg_, opath, user, nbFrames, depth, nbThreads, processingTime);
+      return false;
+      break;
+    }
+  }
+
+  if ((c == 1) || (c == -1)) {
+    // standalone param or error
+    usage(argv[0], NULL, opath, user, nbFrames, depth, nbThreads, processingTime);
+    std::cerr << "ERROR: " << std::endl;
+    std::cerr << "  Bad argument " << optarg_ << std::endl << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+/*
+  Read the whole sequence and return the number of frames per second. The
+  sum of the pixels of each frame is stored in \e checksums.
+*/
+double readSequence(const std::string &filename, unsigned int depth, unsigned int nbThreads, double processingTime,
+                    std::vector<unsigned int> &checksums)
+{
+  vpImage<unsigned char> I;
+  vpVideoReader reader;
+  reader.setFileName(filename);
+  reader.setPrefetch(depth, nbThreads);
+
+  checksums.clear();
+  double t = vpTime::measureTimeMs();
+  reader.open(I);
+  while (!reader.end()) {
+    reader.acquire(I);
+
+    unsigned int sum = 0;
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      sum += I.bitmap[i];
+    }
+    checksums.push_back(sum);
+
+    if (processingTime > 0) {
+      vpTime::sleepMs(processingTime);
+    }
+  }
+  t = vpTime::measureTimeMs() - t;
+
+  return checksums.size() / (t / 1000.0);
+}
+
+int main(int argc, const char **argv)
+{
+  try {
+    std::string opt_opath;
+    std::string opath;
+    std::string username;
+    unsigned int nbFrames = 100;
+    unsigned int depth = 4;
+    unsigned int nbThreads = 2;
+    double processingTime = 0;
+
+// Set the default output path
+#if defined(_WIN32)
+    opt_opath = "C:/temp";
+#else
+    opt_opath = "/tmp";
+#endif
+
+    // Get the user login name
+    vpIoTools::getUserName(username);
+
+    // Read the command line options
+    if (getOptions(argc, argv, opt_opath, username, nbFrames, depth, nbThreads, processingTime) == false) {
+      exit(-1);
+    }
+
+    // Get the option values
+    if (!opt_opath.empty())
+      opath = opt_opath;
+
+    // Append to the output path string, the login name of the user
+    opath = vpIoTools::createFilePath(opath, username);
+    opath = vpIoTools::createFilePath(opath, "testPerformanceVideoReader");
+
+    // Test if the output path exist. If no try to create it
+    if (vpIoTools::checkDirectory(opath) == false) {
+      try {
+        // Create the dirname
+        vpIoTools::makeDirectory(opath);
+      } catch (...) {
+        usage(argv[0], NULL, opath, username, nbFrames, depth, nbThreads, processingTime);
+        std::cerr << std::endl << "ERROR:" << std::endl;
+        std::cerr << "  Cannot create " << opath << std::endl;
+        std::cerr << "  Check your -o " << opt_opath << " option " << std::endl;
+        exit(-1);
+      }
+    }
+
+    std::vector<std::string> extensions;
+    extensions.push_back("pgm");
+#if defined(VISP_HAVE_PNG) || defined(VISP_HAVE_OPENCV)
+    extensions.push_back("png");
+#endif
+
+    // Write synthetic VGA sequences
+    vpImage<unsigned char> I(480, 640);
+    for (unsigned int k = 0; k < nbFrames; k++) {
+      for (unsigned int i = 0; i < I.getHeight(); i++) {
+        for (unsigned int j = 0; j < I.getWidth(); j++) {
+          I[i][j] = (unsigned char)((i * j + 7 * k) ^ (i + 3 * j));
+        }
+      }
+      for (size_t e = 0; e < extensions.size(); e++) {
+        char buffer[FILENAME_MAX];
+        sprintf(buffer, "image%04u.%s", k, extensions[e].c_str());
+        vpImageIo::write(I, vpIoTools::createFilePath(opath, buffer));
+      }
+    }
+
+    bool success = true;
+    for (size_t e = 0; e < extensions.size(); e++) {
+      std::string filename = vpIoTools::createFilePath(opath, "image%04d." + extensions[e]);
+
+      std::vector<unsigned int> checksums, checksumsPrefetch;
+      double fps = readSequence(filename, 0, 0, processingTime, checksums);
+      double fpsPrefetch = readSequence(filename, depth, nbThreads, processingTime, checksumsPrefetch);
+
+      std::cout << extensions[e] << ": " << fps << " fps without read-ahead, " << fpsPrefetch
+                << " fps with a read-ahead of " << depth << " frames on " << nbThreads << " thread(s)" << std::endl;
+
+      if (checksums.size() != nbFrames || checksums != checksumsPrefetch) {
+        std::cerr << "Images read ahead differ from the sequence (" << checksumsPrefetch.size() << " frames read over "
+                  << checksums.size() << ")" << std::endl;
+        success = false;
+      }
+    }
+
+    for (unsigned int k = 0; k < nbFrames; k++) {
+      for (size_t e = 0; e < extensions.size(); e++) {
+        char buffer[FILENAME_MAX];
+        sprintf(buffer, "image%04u.%s", k, extensions[e].c_str());
+        vpIoTools::remove(vpIoTools::createFilePath(opath, buffer));
+      }
+    }
+
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,290 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test fixed-size storage and performance of the transformation classes.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceHomogeneousMatrix.cpp
+
+  Test that homogeneous, rotation, translation and twist matrices store their
+  elements in the object itself, check compose/inverse results against a
+  generic vpMatrix implementation and compare their computation time.
+*/
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <visp3/core/vpForceTwistMatrix.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpVelocityTwistMatrix.h>
+
+namespace
+{
+//! Number of calls to the global operator new since the program started
+unsigned long nbHeapAllocations = 0;
+}
+
+// Not inlined so that GCC does not match the malloc() and free() calls with
+// the new and delete expressions
+#if defined(__GNUC__)
+#define VP_NO_INLINE __attribute__((noinline))
+#else
+#define VP_NO_INLINE
+#endif
+
+#if (__cplusplus >= 201103L)
+#define VP_THROW_BAD_ALLOC
+#define VP_NO_THROW noexcept
+#else
+#define VP_THROW_BAD_ALLOC throw(std::bad_alloc)
+#define VP_NO_THROW throw()
+#endif
+
+// Replace the global allocation functions to count the heap allocations
+VP_NO_INLINE void *operator new(std::size_t size) VP_THROW_BAD_ALLOC
+{
+  nbHeapAllocations++;
+  void *ptr = malloc(size > 0 ? size : 1);
+  if (ptr == NULL) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+VP_NO_INLINE void *operator new[](std::size_t size) VP_THROW_BAD_ALLOC { return operator new(size); }
+
+VP_NO_INLINE void operator delete(void *ptr) VP_NO_THROW { free(ptr); }
+
+VP_NO_INLINE void operator delete[](void *ptr) VP_NO_THROW { free(ptr); }
+
+#if defined(__cpp_sized_deallocation)
+VP_NO_INLINE void operator delete(void *ptr, std::size_t) VP_NO_THROW { free(ptr); }
+
+VP_NO_INLINE void operator delete[](void *ptr, std::size_t) VP_NO_THROW { free(ptr); }
+#endif
+
+namespace
+{
+//! Return true when the elements of A are stored inside the object memory footprint
+template <class Type> bool isStoredInline(const Type &A)
+{
+  const char *begin = reinterpret_cast<const char *>(&A);
+  const char *end = begin + sizeof(Type);
+  const char *first = reinterpret_cast<const char *>(A.data);
+  const char *last = reinterpret_cast<const char *>(A.data + A.size());
+  return (first >= begin) && (last <= end);
+}
+
+//! Compose two homogeneous matrices as done before, using heap allocated vpMatrix
+vpMatrix composeGeneric(const vpMatrix &aMb, const vpMatrix &bMc)
+{
+  vpMatrix R1(3, 3), R2(3, 3), T1(3, 1), T2(3, 1);
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      R1[i][j] = aMb[i][j];
+      R2[i][j] = bMc[i][j];
+    }
+    T1[i][0] = aMb[i][3];
+    T2[i][0] = bMc[i][3];
+  }
+  vpMatrix R = R1 * R2;
+  vpMatrix T = R1 * T2 + T1;
+
+  vpMatrix aMc(4, 4);
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      aMc[i][j] = R[i][j];
+    }
+    aMc[i][3] = T[i][0];
+  }
+  aMc[3][3] = 1.;
+  return aMc;
+}
+
+bool equal(const vpArray2D<double> &A, const vpArray2D<double> &B, double threshold = 1e-12)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < A.size(); i++) {
+    if (!vpMath::equal(A.data[i], B.data[i], threshold)) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpHomogeneousMatrix aMb(0.1, -0.2, 0.3, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+    vpHomogeneousMatrix bMc(-0.4, 0.5, 1.2, vpMath::rad(-5), vpMath::rad(40), vpMath::rad(15));
+
+    //
+    // Storage of the fixed-size containers
+    //
+    vpRotationMatrix R(aMb);
+    vpTranslationVector t(aMb);
+    vpVelocityTwistMatrix V(aMb);
+    vpForceTwistMatrix F(aMb);
+    vpHomogeneousMatrix aMc = aMb * bMc;
+    vpHomogeneousMatrix bMa = aMb.inverse();
+    vpHomogeneousMatrix copy(aMc);
+    std::vector<vpHomogeneousMatrix> vec(3, aMc);
+
+    if (!isStoredInline(aMb) || !isStoredInline(aMc) || !isStoredInline(bMa) || !isStoredInline(copy) ||
+        !isStoredInline(vec[2]) || !isStoredInline(R) || !isStoredInline(t) || !isStoredInline(V) ||
+        !isStoredInline(F)) {
+      std::cerr << "Fixed-size containers should not use heap allocated memory" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Compose, inverse and change of frame of the twists do not allocate.
+    // The heap memory of vpArray2D is allocated with realloc(), which is not
+    // counted, so the storage is also checked to still be inline afterwards.
+    const unsigned long nbHeapAllocationsBefore = nbHeapAllocations;
+    for (int i = 0; i < 100; i++) {
+      aMc = aMb * bMc;
+      bMa = aMb.inverse();
+      copy = aMc;
+      copy *= bMa;
+      V.buildFrom(aMc);
+      F.buildFrom(aMc);
+      R = aMc.getRotationMatrix();
+      t = aMc.getTranslationVector();
+    }
+    const unsigned long nbAllocations = nbHeapAllocations - nbHeapAllocationsBefore;
+    std::cout << "Heap allocations per compose: " << nbAllocations / 100. << std::endl;
+    if (nbAllocations != 0 || !isStoredInline(aMc) || !isStoredInline(bMa) || !isStoredInline(copy) ||
+        !isStoredInline(V) || !isStoredInline(F) || !isStoredInline(R) || !isStoredInline(t)) {
+      std::cerr << "Fixed-size containers should not allocate memory, " << nbAllocations
+                << " allocations counted" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    try {
+      vpArray2D<double> &A = aMc;
+      A.resize(3, 3);
+      std::cerr << "Resizing a fixed-size container should throw an exception" << std::endl;
+      return EXIT_FAILURE;
+    } catch (const vpException &e) {
+      std::cout << "Catch expected exception: " << e.getMessage() << std::endl;
+    }
+
+    //
+    // Results
+    //
+    vpMatrix aMc_generic = composeGeneric(aMb, bMc);
+    if (!equal(aMc, aMc_generic)) {
+      std::cerr << "Bad homogeneous matrix product:\n" << aMc << "\n\nexpected:\n" << aMc_generic << std::endl;
+      return EXIT_FAILURE;
+    }
+    vpHomogeneousMatrix M = aMb;
+    M *= bMc;
+    if (!equal(M, aMc)) {
+      std::cerr << "Bad homogeneous matrix *= operator" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpMatrix bMa_generic = static_cast<vpMatrix>(aMb).inverseByLU();
+    if (!equal(bMa, bMa_generic, 1e-9)) {
+      std::cerr << "Bad homogeneous matrix inverse:\n" << bMa << "\n\nexpected:\n" << bMa_generic << std::endl;
+      return EXIT_FAILURE;
+    }
+    M = aMb;
+    M.inverse(M);
+    if (!equal(M, bMa)) {
+      std::cerr << "Bad in place homogeneous matrix inverse" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!equal(aMb * bMa, vpHomogeneousMatrix(), 1e-12)) {
+      std::cerr << "aMb * aMb^-1 should be identity" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpTranslationVector V_t;
+    V.extract(V_t);
+    if (!equal(V_t, t)) {
+      std::cerr << "Bad translation extracted from velocity twist matrix" << std::endl;
+      return EXIT_FAILURE;
+    }
+    vpMatrix V_generic = static_cast<vpMatrix>(V).inverseByLU();
+    if (!equal(V.inverse(), V_generic, 1e-9)) {
+      std::cerr << "Bad velocity twist matrix inverse" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!equal(F, V_generic.t(), 1e-9)) {
+      std::cerr << "Bad force twist matrix" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    //
+    // Performance
+    //
+    const int nbIterations = 200000;
+    vpMatrix aMb_generic(aMb), bMc_generic(bMc), res_generic;
+    double t_generic = vpTime::measureTimeMs();
+    for (int i = 0; i < nbIterations; i++) {
+      res_generic = composeGeneric(aMb_generic, bMc_generic);
+    }
+    t_generic = vpTime::measureTimeMs() - t_generic;
+
+    vpHomogeneousMatrix res;
+    double t_fixed = vpTime::measureTimeMs();
+    for (int i = 0; i < nbIterations; i++) {
+      res = aMb * bMc;
+    }
+    t_fixed = vpTime::measureTimeMs() - t_fixed;
+
+    double t_inverse = vpTime::measureTimeMs();
+    for (int i = 0; i < nbIterations; i++) {
+      res = res.inverse();
+    }
+    t_inverse = vpTime::measureTimeMs() - t_inverse;
+
+    std::cout << nbIterations << " composes: generic=" << t_generic << " ms ; fixed-size=" << t_fixed << " ms"
+              << std::endl;
+    std::cout << "Speed-up: " << (t_generic / t_fixed) << "X" << std::endl;
+    std::cout << nbIterations << " inverses: " << t_inverse << " ms" << std::endl;
+
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,212 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test and benchmark the matrix products.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMatrixMultiplication.cpp
+
+  Check the products computed by vpMatrix::mult2Matrices(), vpMatrix::AtA()
+  and the products by twist matrices against a textbook triple loop, and
+  compare the computation time of the triple loop, of the built-in kernels
+  and of the third-party BLAS if any.
+*/
+
+#include <limits>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/core/vpVelocityTwistMatrix.h>
+
+namespace
+{
+//! Product computed as before, with an i-j-k loop walking B column-wise
+void multNaive(const vpMatrix &A, const vpMatrix &B, vpMatrix &C)
+{
+  C.resize(A.getRows(), B.getCols(), false, false);
+  for (unsigned int i = 0; i < A.getRows(); i++) {
+    for (unsigned int j = 0; j < B.getCols(); j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < B.getRows(); k++)
+        s += A[i][k] * B[k][j];
+      C[i][j] = s;
+    }
+  }
+}
+
+void generateRandomMatrix(unsigned int rows, unsigned int cols, vpUniRand &rng, vpMatrix &A)
+{
+  A.resize(rows, cols, false, false);
+  for (unsigned int i = 0; i < A.size(); i++) {
+    A.data[i] = 2 * rng() - 1;
+  }
+}
+
+bool equal(const vpMatrix &A, const vpMatrix &B, double threshold = 1e-10)
+{
+  if (A.getRows() != B.getRows() || A.getCols() != B.getCols()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < A.size(); i++) {
+    if (!vpMath::equal(A.data[i], B.data[i], threshold)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool checkProduct(unsigned int m, unsigned int k, unsigned int n, vpUniRand &rng)
+{
+  vpMatrix A, B, C, C_naive;
+  generateRandomMatrix(m, k, rng, A);
+  generateRandomMatrix(k, n, rng, B);
+  multNaive(A, B, C_naive);
+
+  vpMatrix::mult2Matrices(A, B, C);
+  if (!equal(C, C_naive)) {
+    std::cerr << "Bad (" << m << "x" << k << ") * (" << k << "x" << n << ") product" << std::endl;
+    return false;
+  }
+
+  vpMatrix AtA = A.AtA(), AtA_naive;
+  multNaive(A.t(), A, AtA_naive);
+  if (!equal(AtA, AtA_naive)) {
+    std::cerr << "Bad AtA() of a (" << m << "x" << k << ") matrix" << std::endl;
+    return false;
+  }
+
+  return true;
+}
+
+//! Print the mean time of a product with the triple loop, the built-in kernels and BLAS if available
+void benchmark(unsigned int m, unsigned int k, unsigned int n, vpUniRand &rng)
+{
+  vpMatrix A, B, C;
+  generateRandomMatrix(m, k, rng, A);
+  generateRandomMatrix(k, n, rng, B);
+  multNaive(A, B, C);
+
+  const double flops = 2. * m * n * k;
+  const int nbIterations = std::max(1, (int)(2e8 / flops));
+  double t = vpTime::measureTimeMs();
+  for (int i = 0; i < nbIterations; i++) {
+    multNaive(A, B, C);
+  }
+  const double t_naive = (vpTime::measureTimeMs() - t) / nbIterations;
+
+  unsigned int lapack_min_size = vpMatrix::getLapackMatrixMinSize();
+  vpMatrix::setLapackMatrixMinSize(std::numeric_limits<unsigned int>::max());
+  t = vpTime::measureTimeMs();
+  for (int i = 0; i < nbIterations; i++) {
+    vpMatrix::mult2Matrices(A, B, C);
+  }
+  const double t_builtin = (vpTime::measureTimeMs() - t) / nbIterations;
+
+  std::cout << "(" << m << "x" << k << ") * (" << k << "x" << n << "): naive=" << t_naive
+            << " ms ; built-in=" << t_builtin << " ms (" << flops / t_builtin * 1e-6 << " GFlops)";
+
+#if defined(VISP_HAVE_LAPACK) && !defined(VISP_HAVE_LAPACK_BUILT_IN)
+  vpMatrix::setLapackMatrixMinSize(0);
+  t = vpTime::measureTimeMs();
+  for (int i = 0; i < nbIterations; i++) {
+    vpMatrix::mult2Matrices(A, B, C);
+  }
+  const double t_blas = (vpTime::measureTimeMs() - t) / nbIterations;
+  std::cout << " ; BLAS=" << t_blas << " ms";
+#endif
+  std::cout << std::endl;
+  vpMatrix::setLapackMatrixMinSize(lapack_min_size);
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rng;
+
+    //
+    // Results, with the built-in kernels and with BLAS if available
+    //
+    const unsigned int sizes[][3] = {{6, 6, 6},    {1, 1, 1},     {500, 6, 6},   {6, 500, 6},  {7, 6, 3},
+                                     {37, 53, 29}, {64, 64, 64},  {130, 300, 517}, {301, 257, 300}, {3, 0, 5}};
+    const unsigned int lapack_min_sizes[] = {std::numeric_limits<unsigned int>::max(), 0,
+                                             vpMatrix::getLapackMatrixMinSize()};
+    for (size_t l = 0; l < sizeof(lapack_min_sizes) / sizeof(lapack_min_sizes[0]); l++) {
+      vpMatrix::setLapackMatrixMinSize(lapack_min_sizes[l]);
+      for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (!checkProduct(sizes[s][0], sizes[s][1], sizes[s][2], rng)) {
+          return EXIT_FAILURE;
+        }
+      }
+
+      vpMatrix L, L_naive;
+      generateRandomMatrix(200, 6, rng, L);
+      vpVelocityTwistMatrix V(0.1, -0.2, 0.3, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+      multNaive(L, V, L_naive);
+      if (!equal(L * V, L_naive)) {
+        std::cerr << "Bad product by a velocity twist matrix" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    std::cout << "Matrix products are correct" << std::endl;
+
+    //
+    // Performance
+    //
+    benchmark(6, 6, 6, rng);
+    benchmark(1000, 6, 6, rng);
+    benchmark(6, 1000, 6, rng);
+    benchmark(64, 64, 64, rng);
+    benchmark(256, 256, 256, rng);
+    benchmark(1000, 1000, 1000, rng);
+
+    vpMatrix L;
+    generateRandomMatrix(5000, 6, rng, L);
+    const int nbIterations = 1000;
+    double t = vpTime::measureTimeMs();
+    for (int i = 0; i < nbIterations; i++) {
+      L.AtA();
+    }
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "AtA() of a (5000x6) matrix: " << t / nbIterations << " ms" << std::endl;
+
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,229 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the binary protocol of vpNetwork over the loopback interface.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testRequestBinary.cpp
+
+  Send requests containing an image and a pose between a vpServer and a
+  vpClient in the same process, with the text and the binary protocols, and
+  compare the throughput.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#include <visp3/core/vpClient.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpServer.h>
+#include <visp3/core/vpTime.h>
+
+#ifdef VISP_HAVE_FUNC_INET_NTOP
+
+namespace
+{
+class vpRequestImagePose : public vpRequest
+{
+public:
+  vpRequestImagePose(vpImage<unsigned char> &I, vpHomogeneousMatrix &cMo) : m_I(I), m_cMo(cMo) { request_id = "pose"; }
+
+  virtual void encode()
+  {
+    clear();
+
+    unsigned int h = m_I.getHeight();
+    unsigned int w = m_I.getWidth();
+
+    addParameterObject(&h);
+    addParameterObject(&w);
+    addParameterBuffer(m_I.bitmap, h * w * sizeof(unsigned char));
+    addParameterBuffer(m_cMo.data, 16 * sizeof(double));
+  }
+
+  virtual void decode()
+  {
+    if (size() == 4) {
+      unsigned int h, w;
+      memcpy((void *)&h, (void *)listOfParams[0].c_str(), sizeof(unsigned int));
+      memcpy((void *)&w, (void *)listOfParams[1].c_str(), sizeof(unsigned int));
+
+      m_I.resize(h, w);
+      memcpy((void *)m_I.bitmap, (void *)listOfParams[2].c_str(), w * h * sizeof(unsigned char));
+      memcpy((void *)m_cMo.data, (void *)listOfParams[3].c_str(), 16 * sizeof(double));
+    }
+  }
+
+private:
+  vpImage<unsigned char> &m_I;
+  vpHomogeneousMatrix &m_cMo;
+};
+
+bool runProtocol(vpServer &serv, vpClient &client, const bool binary, const unsigned int nbRequests, double &time)
+{
+  serv.setBinaryProtocol(binary);
+  client.setBinaryProtocol(binary);
+
+  // The values of the image avoid the text delimiters
+  vpImage<unsigned char> I(120, 160), I_received;
+  vpHomogeneousMatrix cMo, cMo_received;
+  vpRequestImagePose req_send(I, cMo), req_receive(I_received, cMo_received);
+  serv.addDecodingRequest(&req_receive);
+
+  bool success = true;
+  time = 0;
+  for (unsigned int n = 0; n < nbRequests && success; n++) {
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        I[i][j] = (unsigned char)((i + j + n) % 90);
+      }
+    }
+    cMo.buildFrom(0.1 * n, 0.2, 0.3, 0.01 * n, 0.02, 0.03);
+
+    double t = vpTime::measureTimeMs();
+    client.sendAndEncodeRequest(req_send);
+
+    int index = -1;
+    for (unsigned int attempt = 0; attempt < 10000 && index == -1; attempt++) {
+      index = serv.receiveAndDecodeRequestOnce();
+    }
+    time += vpTime::measureTimeMs() - t;
+
+    if (index == -1) {
+      std::cerr << "Request " << n << " not received" << std::endl;
+      success = false;
+    } else if (I_received != I || memcmp(cMo_received.data, cMo.data, 16 * sizeof(double)) != 0) {
+      std::cerr << "Request " << n << " received with wrong values" << std::endl;
+      success = false;
+    }
+  }
+
+  serv.removeDecodingRequest("pose");
+  return success;
+}
+
+// A frame larger than the maximum frame size is dropped, the next ones are
+// received
+bool runFrameSizeLimit(vpServer &serv, vpClient &client)
+{
+  serv.setBinaryProtocol(true);
+  client.setBinaryProtocol(true);
+
+  vpImage<unsigned char> I(120, 160, 10), I_received;
+  vpHomogeneousMatrix cMo, cMo_received;
+  vpRequestImagePose req_send(I, cMo), req_receive(I_received, cMo_received);
+  serv.addDecodingRequest(&req_receive);
+
+  const unsigned int max_size_frame = serv.getMaxSizeReceivedFrame();
+  serv.setMaxSizeReceivedFrame(I.getSize() / 2);
+  client.sendAndEncodeRequest(req_send);
+  int index = -1;
+  for (unsigned int attempt = 0; attempt < 1000; attempt++) {
+    if (serv.receiveAndDecodeRequestOnce() != -1) {
+      index = 0;
+    }
+  }
+  serv.setMaxSizeReceivedFrame(max_size_frame);
+
+  bool success = true;
+  if (index != -1) {
+    std::cerr << "Request larger than the maximum frame size received" << std::endl;
+    success = false;
+  }
+
+  client.sendAndEncodeRequest(req_send);
+  for (unsigned int attempt = 0; attempt < 10000 && index == -1; attempt++) {
+    index = serv.receiveAndDecodeRequestOnce();
+  }
+  if (success && (index == -1 || I_received != I)) {
+    std::cerr << "Request not received after a dropped frame" << std::endl;
+    success = false;
+  }
+
+  serv.removeDecodingRequest("pose");
+  return success;
+}
+}
+
+int main()
+{
+  try {
+    const unsigned int port = 35100;
+    vpServer serv((int)port);
+    if (!serv.start()) {
+      std::cerr << "Cannot start the server" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpClient client;
+    if (!client.connectToIP("127.0.0.1", port)) {
+      return EXIT_FAILURE;
+    }
+    for (unsigned int attempt = 0; attempt < 100 && serv.getNumberOfClients() == 0; attempt++) {
+      serv.checkForConnections();
+    }
+    if (serv.getNumberOfClients() == 0) {
+      std::cerr << "The client is not connected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const unsigned int nbRequests = 200;
+    double time_text, time_binary;
+    if (!runProtocol(serv, client, false, nbRequests, time_text)) {
+      return EXIT_FAILURE;
+    }
+    if (!runProtocol(serv, client, true, nbRequests, time_binary)) {
+      return EXIT_FAILURE;
+    }
+    if (!runFrameSizeLimit(serv, client)) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Text protocol: " << time_text / nbRequests << " ms per request" << std::endl;
+    std::cout << "Binary protocol: " << time_binary / nbRequests << " ms per request" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
+
+#else
+int main()
+{
+  std::cout << "This test doesn't work on win XP where inet_ntop() is not available" << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpOrganizedPointCloud.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testOrganizedPointCloud.cpp
+
+  \brief Test vpOrganizedPointCloud views against a std::vector<vpColVector>
+  point cloud.
+*/
+
+#include <iostream>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpOrganizedPointCloud.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+
+namespace
+{
+bool checkPoint(const vpOrganizedPointCloud &pointcloud, unsigned int i, unsigned int j, const vpColVector &pt)
+{
+  double X = 0, Y = 0, Z = 0;
+  pointcloud.getPoint(i, j, X, Y, Z);
+  const double eps = 1e-12;
+  return vpMath::equal(X, pt[0], eps) && vpMath::equal(Y, pt[1], eps) && vpMath::equal(Z, pt[2], eps) &&
+         vpMath::equal(pointcloud.getDepth(i, j), pt[2], eps);
+}
+}
+
+int main()
+{
+  const unsigned int height = 48, width = 64;
+  const double depth_scale = 0.001;
+  vpCameraParameters cam(600.0, 610.0, width / 2.0, height / 2.0);
+
+  vpImage<uint16_t> I_depth_raw(height, width);
+  std::vector<vpColVector> pointcloud_vec(height * width);
+  std::vector<double> xyz(3 * height * width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      I_depth_raw[i][j] = (uint16_t)(500 + 7 * i + 3 * j);
+      double x = 0, y = 0, Z = I_depth_raw[i][j] * depth_scale;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+      vpColVector pt(4, 1.0);
+      pt[0] = x * Z;
+      pt[1] = y * Z;
+      pt[2] = Z;
+      pointcloud_vec[i * width + j] = pt;
+      for (unsigned int k = 0; k < 3; k++) {
+        xyz[3 * (i * width + j) + k] = pt[k];
+      }
+    }
+  }
+
+  vpOrganizedPointCloud copy, view, depth_view;
+  copy.buildFrom(pointcloud_vec, height, width);
+  view.buildFrom(&xyz[0], height, width);
+  depth_view.buildFrom(I_depth_raw, cam, depth_scale);
+  vpOrganizedPointCloud depth_view_copy(depth_view);
+
+  if (copy.getWidth() != width || copy.getHeight() != height || view.getStride() != 3 * width ||
+      !depth_view.isDepthView() || copy.isDepthView()) {
+    std::cerr << "Bad point cloud dimensions!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      const vpColVector &pt = pointcloud_vec[i * width + j];
+      if (!checkPoint(copy, i, j, pt) || !checkPoint(view, i, j, pt) || !checkPoint(depth_view, i, j, pt) ||
+          !checkPoint(depth_view_copy, i, j, pt)) {
+        std::cerr << "Bad point at (" << i << ", " << j << ")!" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // A view on a user buffer or on a depth image cannot be modified
+  bool exception_thrown = false;
+  try {
+    view.getRow(0);
+  } catch (const vpException &) {
+    exception_thrown = true;
+  }
+  if (!exception_thrown) {
+    std::cerr << "Modifying a view should throw!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The copy of an owned point cloud must not share its memory
+  vpOrganizedPointCloud copy2 = copy;
+  copy2.getRow(0)[2] = -1.0;
+  if (vpMath::equal(copy.getDepth(0, 0), -1.0, 1e-12)) {
+    std::cerr << "The copy shares its memory with the original point cloud!" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "vpOrganizedPointCloud is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -38,6 +38,7 @@
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpImagePoint.h>
 #include <visp3/core/vpPolygon.h>
+#include <visp3/core/vpUniRand.h>
 #include <visp3/io/vpParseArgv.h>
 
 #include <visp3/core/vpDisplay.h>
@@ -148,6 +149,39 @@ bool getOptions(int argc, const char **argv, bool &opt_display, bool &opt_click,
 /* --------------------------------------------------------------------------
  */
 
+/*!
+  Check that the pixels given by vpPolygon::getRowSpans() are exactly the ones
+  for which vpPolygon::isInside() is true, and compare the computation times.
+*/
+bool checkRowSpans(const vpPolygon &polygon, int height, int width, double &t_isInside, double &t_spans)
+{
+  vpImage<unsigned char> I_isInside(height, width, 0), I_spans(height, width, 0);
+
+  double t = vpTime::measureTimeMs();
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
+      if (polygon.isInside(vpImagePoint(i, j))) {
+        I_isInside[i][j] = 255;
+      }
+    }
+  }
+  t_isInside += vpTime::measureTimeMs() - t;
+
+  t = vpTime::measureTimeMs();
+  std::vector<int> spans;
+  for (int i = 0; i < height; i++) {
+    polygon.getRowSpans(i, 0, width, spans);
+    for (size_t k = 0; k < spans.size(); k += 2) {
+      for (int j = spans[k]; j < spans[k + 1]; j++) {
+        I_spans[i][j] = 255;
+      }
+    }
+  }
+  t_spans += vpTime::measureTimeMs() - t;
+
+  return I_isInside == I_spans;
+}
+
 int main(int argc, const char **argv)
 {
   try {
@@ -202,6 +236,34 @@ int main(int argc, const char **argv)
     std::cout << " area : " << p3.getArea() << std::endl;
     std::cout << " center : " << p3.getCenter() << std::endl;
 
+    // Row spans against the point in polygon test, on polygons with non
+    // integer corners partially outside the image
+    double t_isInside = 0, t_spans = 0;
+    if (!checkRowSpans(p1, 480, 640, t_isInside, t_spans) || !checkRowSpans(p2, 480, 640, t_isInside, t_spans) ||
+        !checkRowSpans(p3, 480, 640, t_isInside, t_spans)) {
+      std::cerr << "Row spans differ from vpPolygon::isInside()" << std::endl;
+      return 1;
+    }
+    vpUniRand rng;
+    for (unsigned int n = 0; n < 50; n++) {
+      std::vector<vpImagePoint> corners;
+      for (unsigned int k = 0; k < 3 + n % 8; k++) {
+        double i = 600 * rng() - 60, j = 800 * rng() - 80;
+        if (k % 3 == 0) {
+          // Horizontal edges and corners lying on a row
+          i = corners.empty() ? floor(i) : corners.back().get_i();
+        }
+        corners.push_back(vpImagePoint(i, j));
+      }
+      vpPolygon polygon(corners);
+      if (!checkRowSpans(polygon, 480, 640, t_isInside, t_spans)) {
+        std::cerr << "Row spans differ from vpPolygon::isInside() for the random polygon " << n << std::endl;
+        return 1;
+      }
+    }
+    std::cout << "\nPixels inside the polygons: " << t_isInside << " ms with isInside(), " << t_spans
+              << " ms with getRowSpans()" << std::endl;
+
     if (opt_display) {
 #if (defined VISP_HAVE_X11) || (defined VISP_HAVE_GTK) || (defined VISP_HAVE_GDI)
       display.init(I, 10, 10, "Test vpPolygon");
@@ -0,0 +1,250 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test vpThreadPool.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testThreadPool.cpp
+
+  \brief Test vpThreadPool: results of the tasks, nested batches, exceptions
+  and cost of a batch compared to the creation of threads at each call.
+*/
+
+#include <iostream>
+#include <stdexcept>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+class vpSumTask : public vpThreadPool::vpTask
+{
+public:
+  vpSumTask() : m_begin(0), m_end(0), m_sum(0) {}
+  vpSumTask(unsigned int begin, unsigned int end) : m_begin(begin), m_end(end), m_sum(0) {}
+
+  virtual void run()
+  {
+    m_sum = 0;
+    for (unsigned int i = m_begin; i < m_end; i++) {
+      m_sum += i;
+    }
+  }
+
+  unsigned int m_begin;
+  unsigned int m_end;
+  unsigned long long m_sum;
+};
+
+// Task that submits a batch to the same pool
+class vpNestedTask : public vpThreadPool::vpTask
+{
+public:
+  vpNestedTask(vpThreadPool *pool, unsigned int begin) : m_pool(pool), m_begin(begin), m_sum(0) {}
+
+  virtual void run()
+  {
+    vpSumTask task1(m_begin, m_begin + 100), task2(m_begin + 100, m_begin + 200);
+    std::vector<vpThreadPool::vpTask *> tasks;
+    tasks.push_back(&task1);
+    tasks.push_back(&task2);
+    m_pool->run(tasks);
+    m_sum = task1.m_sum + task2.m_sum;
+  }
+
+  vpThreadPool *m_pool;
+  unsigned int m_begin;
+  unsigned long long m_sum;
+};
+
+class vpThrowTask : public vpThreadPool::vpTask
+{
+public:
+  virtual void run() { throw vpException(vpException::badValue, "Expected exception"); }
+};
+
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+class vpThrowStdTask : public vpThreadPool::vpTask
+{
+public:
+  virtual void run() { throw std::runtime_error("Expected std exception"); }
+};
+#endif
+
+class vpEmptyTask : public vpThreadPool::vpTask
+{
+public:
+  virtual void run() {}
+};
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+vpThread::Return emptyFunction(vpThread::Args args)
+{
+  (void)(args);
+  return 0;
+}
+#endif
+
+bool testPool(vpThreadPool &pool)
+{
+  std::cout << "Test a pool of " << pool.getNbThreads() << " worker threads" << std::endl;
+
+  // Sum of 0..n-1 split in many tasks
+  const unsigned int nbTasks = 64, n = 100000;
+  std::vector<vpSumTask> sumTasks(nbTasks);
+  std::vector<vpThreadPool::vpTask *> tasks(nbTasks);
+  for (unsigned int i = 0; i < nbTasks; i++) {
+    sumTasks[i] = vpSumTask(i * n / nbTasks, (i + 1) * n / nbTasks);
+    tasks[i] = &sumTasks[i];
+  }
+  for (int iter = 0; iter < 10; iter++) {
+    pool.run(tasks);
+    unsigned long long sum = 0;
+    for (unsigned int i = 0; i < nbTasks; i++) {
+      sum += sumTasks[i].m_sum;
+    }
+    if (sum != (unsigned long long)n * (n - 1) / 2) {
+      std::cerr << "Bad sum: " << sum << std::endl;
+      return false;
+    }
+  }
+
+  // Batches submitted from the tasks of another batch
+  std::vector<vpNestedTask> nestedTasks;
+  for (unsigned int i = 0; i < 8; i++) {
+    nestedTasks.push_back(vpNestedTask(&pool, 200 * i));
+  }
+  tasks.clear();
+  for (size_t i = 0; i < nestedTasks.size(); i++) {
+    tasks.push_back(&nestedTasks[i]);
+  }
+  pool.run(tasks);
+  unsigned long long sum = 0;
+  for (size_t i = 0; i < nestedTasks.size(); i++) {
+    sum += nestedTasks[i].m_sum;
+  }
+  if (sum != 1600ULL * 1599 / 2) {
+    std::cerr << "Bad sum with nested batches: " << sum << std::endl;
+    return false;
+  }
+
+  // An exception in a task is reported once the batch is finished
+  vpThrowTask throwTask;
+  vpSumTask sumTask(0, 10);
+  tasks.clear();
+  tasks.push_back(&throwTask);
+  tasks.push_back(&sumTask);
+  bool exceptionThrown = false;
+  try {
+    pool.run(tasks);
+  } catch (vpException &e) {
+    // The exception of the task is rethrown as is
+    exceptionThrown = (e.getCode() == vpException::badValue && e.getStringMessage() == "Expected exception");
+  }
+  if (!exceptionThrown || sumTask.m_sum != 45) {
+    std::cerr << "The exception of a task is not reported correctly" << std::endl;
+    return false;
+  }
+
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  // Any exception type is propagated to the caller
+  vpThrowStdTask throwStdTask;
+  tasks.clear();
+  tasks.push_back(&throwStdTask);
+  exceptionThrown = false;
+  try {
+    pool.run(tasks);
+  } catch (const std::runtime_error &e) {
+    exceptionThrown = (std::string(e.what()) == "Expected std exception");
+  }
+  if (!exceptionThrown) {
+    std::cerr << "The std exception of a task is not reported correctly" << std::endl;
+    return false;
+  }
+#endif
+
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    std::cout << "Number of processors: " << vpThreadPool::getNbProcessors() << std::endl;
+
+    vpThreadPool pool0(0), pool4(4);
+    if (pool0.getNbThreads() != 0 || !testPool(pool0) || !testPool(pool4) ||
+        !testPool(vpThreadPool::getInstance())) {
+      return EXIT_FAILURE;
+    }
+
+    // Latency of a batch of empty tasks compared to the creation of one thread per task
+    const unsigned int nbThreads = 4, nbCalls = 1000;
+    std::vector<vpEmptyTask> emptyTasks(nbThreads);
+    std::vector<vpThreadPool::vpTask *> tasks(nbThreads);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      tasks[i] = &emptyTasks[i];
+    }
+    double t_pool = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbCalls; i++) {
+      pool4.run(tasks);
+    }
+    t_pool = (vpTime::measureTimeMs() - t_pool) / nbCalls;
+    std::cout << "Batch of " << nbThreads << " tasks with the pool: " << t_pool * 1000.0 << " us" << std::endl;
+
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+    double t_threads = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbCalls; i++) {
+      std::vector<vpThread *> threads(nbThreads);
+      for (unsigned int j = 0; j < nbThreads; j++) {
+        threads[j] = new vpThread(emptyFunction);
+      }
+      for (unsigned int j = 0; j < nbThreads; j++) {
+        delete threads[j]; // join
+      }
+    }
+    t_threads = (vpTime::measureTimeMs() - t_threads) / nbCalls;
+    std::cout << "Creation and join of " << nbThreads << " threads: " << t_threads * 1000.0 << " us" << std::endl;
+#endif
+
+    std::cout << "vpThreadPool is ok." << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -47,6 +47,9 @@
 //{
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
+#ifdef VISP_HAVE_X11_XSHM
+#include <X11/extensions/XShm.h>
+#endif
 //#include <X11/Xatom.h>
 //#include <X11/cursorfont.h>
 //} ;
@@ -75,6 +78,12 @@
   Thus to enable this class X11 should be installed. Installation
   instructions are provided here https://visp.inria.fr/3rd_x11.
 
+  When the X server provides the MIT-SHM extension and runs on the same
+  host, the image is transferred to the server through a shared memory
+  segment. Otherwise it is sent over the X connection with XPutImage().
+  Only the part of the window modified since the last flush is repainted
+  by flush().
+
   This class define the X11 console to display  images
   It also define method to display some geometric feature (point, line,
 circle) in the image.
@@ -167,6 +176,15 @@ private:
   bool ximage_data_init;
   unsigned int RMask, GMask, BMask;
   int RShift, GShift, BShift;
+  bool ximage_shm;         // Ximage data is a shared memory segment
+  bool ximage_put_pending; // Ximage data may still be read by the server
+#ifdef VISP_HAVE_X11_XSHM
+  XShmSegmentInfo shminfo;
+#endif
+  XFontStruct *font_info;
+  // Area of the pixmap modified since the last flush, in window coordinates
+  bool dirty;
+  int dirty_umin, dirty_vmin, dirty_umax, dirty_vmax;
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -204,6 +222,13 @@ public:
   void getScreenSize(unsigned int &width, unsigned int &height);
   unsigned int getScreenWidth();
 
+  /*!
+    Return true if the image is transferred to the X server through a
+    shared memory segment (MIT-SHM extension), false if it is sent over the
+    X connection with XPutImage().
+  */
+  inline bool hasSharedMemory() const { return ximage_shm; }
+
   void init(vpImage<unsigned char> &I, int winx = -1, int winy = -1, const std::string &title = "");
   void init(vpImage<vpRGBa> &I, int winx = -1, int winy = -1, const std::string &title = "");
   void init(unsigned int width, unsigned int height, int winx = -1, int winy = -1, const std::string &title = "");
@@ -260,6 +285,14 @@ protected:
   void setFont(const std::string &font);
   void setTitle(const std::string &title);
   void setWindowPosition(int winx, int winy);
+
+private:
+  void addDirtyArea(int u1, int v1, int u2, int v2, unsigned int margin = 0);
+  void removeDirtyArea(int umin, int vmin, int umax, int vmax);
+  void createXImage();
+  void destroyXImage();
+  void putXImage(int u, int v, unsigned int w, unsigned int h);
+  void waitXImage();
 };
 
 #endif
@@ -62,6 +62,97 @@
 // math
 #include <visp3/core/vpMath.h>
 
+#ifdef VISP_HAVE_X11_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <visp3/core/vpMutex.h>
+#endif
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+#ifdef VISP_HAVE_X11_XSHM
+// The X error handler is common to the whole process: the attach of the
+// shared memory segments of the displays is serialized. During an attach,
+// shmErrorHandler() records the errors of the attaching connection, which
+// happen for instance with a remote display, and forwards the errors of the
+// other connections to the previous handler.
+#if defined(VISP_HAVE_PTHREAD)
+vpMutex shmAttachMutex;
+#endif
+Display *shmAttachDisplay = NULL;
+XErrorHandler shmPreviousErrorHandler = NULL;
+bool shmAttachFailed = false;
+
+int shmErrorHandler(Display *display, XErrorEvent *event)
+{
+  if (display == shmAttachDisplay) {
+    shmAttachFailed = true;
+    return 0;
+  }
+  return (shmPreviousErrorHandler != NULL) ? shmPreviousErrorHandler(display, event) : 0;
+}
+#endif
+
+// Convert grey levels into 32 bits little endian pixels (B, G, R, A)
+void greyToBGRa(const unsigned char *src, unsigned char *dst, unsigned int size)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  const __m128i alpha = _mm_set1_epi8((char)vpRGBa::alpha_default);
+  for (; i + 16 <= size; i += 16) {
+    const __m128i grey = _mm_loadu_si128((const __m128i *)(src + i));
+    const __m128i gg_lo = _mm_unpacklo_epi8(grey, grey);
+    const __m128i gg_hi = _mm_unpackhi_epi8(grey, grey);
+    const __m128i ga_lo = _mm_unpacklo_epi8(grey, alpha);
+    const __m128i ga_hi = _mm_unpackhi_epi8(grey, alpha);
+    _mm_storeu_si128((__m128i *)(dst + 4 * i), _mm_unpacklo_epi16(gg_lo, ga_lo));
+    _mm_storeu_si128((__m128i *)(dst + 4 * i + 16), _mm_unpackhi_epi16(gg_lo, ga_lo));
+    _mm_storeu_si128((__m128i *)(dst + 4 * i + 32), _mm_unpacklo_epi16(gg_hi, ga_hi));
+    _mm_storeu_si128((__m128i *)(dst + 4 * i + 48), _mm_unpackhi_epi16(gg_hi, ga_hi));
+  }
+#endif
+  for (; i < size; i++) {
+    unsigned char val = src[i];
+    *(dst + 4 * i) = val;     // Blue
+    *(dst + 4 * i + 1) = val; // Green
+    *(dst + 4 * i + 2) = val; // Red
+    *(dst + 4 * i + 3) = vpRGBa::alpha_default;
+  }
+}
+
+// Convert RGBa pixels into 32 bits little endian pixels (B, G, R, A)
+void RGBaToBGRa(const vpRGBa *src, unsigned char *dst, unsigned int size)
+{
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  // Once loaded as little endian 32 bits words, a RGBa pixel is 0xAABBGGRR
+  // and has to become 0xAARRGGBB: swap the R and B bytes
+  const __m128i mask_ag = _mm_set1_epi32((int)0xFF00FF00);
+  const __m128i mask_b = _mm_set1_epi32(0x000000FF);
+  for (; i + 4 <= size; i += 4) {
+    const __m128i rgba = _mm_loadu_si128((const __m128i *)(src + i));
+    const __m128i ag = _mm_and_si128(rgba, mask_ag);
+    const __m128i r = _mm_slli_epi32(_mm_and_si128(rgba, mask_b), 16);
+    const __m128i b = _mm_and_si128(_mm_srli_epi32(rgba, 16), mask_b);
+    _mm_storeu_si128((__m128i *)(dst + 4 * i), _mm_or_si128(ag, _mm_or_si128(r, b)));
+  }
+#endif
+  for (; i < size; i++) {
+    *(dst + 4 * i) = src[i].B;
+    *(dst + 4 * i + 1) = src[i].G;
+    *(dst + 4 * i + 2) = src[i].R;
+    *(dst + 4 * i + 3) = src[i].A;
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
 
   Constructor : initialize a display to visualize a gray level image
@@ -86,7 +177,8 @@
 vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), ximage_shm(false), ximage_put_pending(false), font_info(NULL), dirty(false), dirty_umin(0),
+    dirty_vmin(0), dirty_umax(0), dirty_vmax(0)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
 
@@ -119,7 +211,8 @@ vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, vpScaleType scaleType)
 vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, int x, int y, const std::string &title, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), ximage_shm(false), ximage_put_pending(false), font_info(NULL), dirty(false), dirty_umin(0),
+    dirty_vmin(0), dirty_umax(0), dirty_vmax(0)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
   init(I, x, y, title);
@@ -147,7 +240,8 @@ vpDisplayX::vpDisplayX(vpImage<unsigned char> &I, int x, int y, const std::strin
 vpDisplayX::vpDisplayX(vpImage<vpRGBa> &I, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), ximage_shm(false), ximage_put_pending(false), font_info(NULL), dirty(false), dirty_umin(0),
+    dirty_vmin(0), dirty_umax(0), dirty_vmax(0)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
   init(I);
@@ -177,7 +271,8 @@ vpDisplayX::vpDisplayX(vpImage<vpRGBa> &I, vpScaleType scaleType)
 vpDisplayX::vpDisplayX(vpImage<vpRGBa> &I, int x, int y, const std::string &title, vpScaleType scaleType)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), ximage_shm(false), ximage_put_pending(false), font_info(NULL), dirty(false), dirty_umin(0),
+    dirty_vmin(0), dirty_umax(0), dirty_vmax(0)
 {
   setScale(scaleType, I.getWidth(), I.getHeight());
   init(I, x, y, title);
@@ -208,7 +303,8 @@ int main()
 vpDisplayX::vpDisplayX(int x, int y, const std::string &title)
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), ximage_shm(false), ximage_put_pending(false), font_info(NULL), dirty(false), dirty_umin(0),
+    dirty_vmin(0), dirty_umax(0), dirty_vmax(0)
 {
   m_windowXPosition = x;
   m_windowYPosition = y;
@@ -238,7 +334,8 @@ int main()
 vpDisplayX::vpDisplayX()
   : display(NULL), window(), Ximage(NULL), lut(), context(), screen(0), event(), pixmap(), x_color(NULL),
     screen_depth(8), xcolor(), values(), ximage_data_init(false), RMask(0), GMask(0), BMask(0), RShift(0), GShift(0),
-    BShift(0)
+    BShift(0), ximage_shm(false), ximage_put_pending(false), font_info(NULL), dirty(false), dirty_umin(0),
+    dirty_vmin(0), dirty_umax(0), dirty_vmax(0)
 {
 }
 
@@ -659,13 +756,7 @@ void vpDisplayX::init(vpImage<unsigned char> &I, int x, int y, const std::string
   //    XNextEvent ( display, &event );
   //  while ( event.xany.type != Expose );
 
-  {
-    Ximage = XCreateImage(display, DefaultVisual(display, screen), screen_depth, ZPixmap, 0, NULL, m_width, m_height,
-                          XBitmapPad(display), 0);
-
-    Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
-    ximage_data_init = true;
-  }
+  createXImage();
   m_displayHasBeenInitialized = true;
 
   XStoreName(display, window, m_title.c_str());
@@ -1091,13 +1182,7 @@ void vpDisplayX::init(vpImage<vpRGBa> &I, int x, int y, const std::string &title
   //    XNextEvent ( display, &event );
   //  while ( event.xany.type != Expose );
 
-  {
-    Ximage = XCreateImage(display, DefaultVisual(display, screen), screen_depth, ZPixmap, 0, NULL, m_width, m_height,
-                          XBitmapPad(display), 0);
-
-    Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
-    ximage_data_init = true;
-  }
+  createXImage();
   m_displayHasBeenInitialized = true;
 
   XSync(display, true);
@@ -1542,13 +1627,7 @@ void vpDisplayX::init(unsigned int w, unsigned int h, int x, int y, const std::s
   //    XNextEvent ( display, &event );
   //  while ( event.xany.type != Expose );
 
-  {
-    Ximage = XCreateImage(display, DefaultVisual(display, screen), screen_depth, ZPixmap, 0, NULL, m_width, m_height,
-                          XBitmapPad(display), 0);
-
-    Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
-    ximage_data_init = true;
-  }
+  createXImage();
   m_displayHasBeenInitialized = true;
 
   XSync(display, true);
@@ -1578,6 +1657,10 @@ void vpDisplayX::setFont(const std::string &font)
         Font stringfont;
         stringfont = XLoadFont(display, font.c_str()); //"-adobe-times-bold-r-normal--18*");
         XSetFont(display, context, stringfont);
+        if (font_info != NULL) {
+          XFreeFontInfo(NULL, font_info, 1);
+          font_info = NULL;
+        }
       } catch (...) {
         throw(vpDisplayException(vpDisplayException::notInitializedError, "Bad font"));
       }
@@ -1634,6 +1717,7 @@ void vpDisplayX::setWindowPosition(int winx, int winy)
 void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
 {
   if (m_displayHasBeenInitialized) {
+    waitXImage();
     switch (screen_depth) {
     case 8: {
       // Correction de l'image de facon a liberer les niveaux de gris
@@ -1670,7 +1754,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putXImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1695,7 +1779,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putXImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1720,13 +1804,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
           }
         } else {
           // little endian
-          while (bitmap < n) {
-            unsigned char val = *(bitmap++);
-            *(dst_32++) = val; // Blue
-            *(dst_32++) = val; // Green
-            *(dst_32++) = val; // Red
-            *(dst_32++) = vpRGBa::alpha_default;
-          }
+          greyToBGRa(bitmap, dst_32, size_);
         }
       } else {
         if (XImageByteOrder(display) == 1) {
@@ -1755,7 +1833,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putXImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1778,6 +1856,7 @@ void vpDisplayX::displayImage(const vpImage<unsigned char> &I)
 void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
 {
   if (m_displayHasBeenInitialized) {
+    waitXImage();
     switch (screen_depth) {
     case 16: {
       vpRGBa *bitmap = I.bitmap;
@@ -1813,7 +1892,7 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
         }
       }
 
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putXImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
 
       break;
@@ -1839,13 +1918,7 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
           }
         } else {
           // little endian
-          for (unsigned int i = 0; i < sizeI; i++) {
-            *(dst_32++) = bitmap->B;
-            *(dst_32++) = bitmap->G;
-            *(dst_32++) = bitmap->R;
-            *(dst_32++) = bitmap->A;
-            bitmap++;
-          }
+          RGBaToBGRa(bitmap, dst_32, sizeI);
         }
       } else {
         if (XImageByteOrder(display) == 1) {
@@ -1874,7 +1947,7 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
       }
 
       // Affichage de l'image dans la Pixmap.
-      XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+      putXImage(0, 0, m_width, m_height);
       XSetWindowBackgroundPixmap(display, window, pixmap);
       break;
     }
@@ -1900,8 +1973,8 @@ void vpDisplayX::displayImage(const vpImage<vpRGBa> &I)
 */
 void vpDisplayX::displayImage(const unsigned char *bitmap)
 {
-
   if (m_displayHasBeenInitialized) {
+    waitXImage();
     unsigned char *dst_32 = (unsigned char *)Ximage->data;
     for (unsigned int i = 0; i < m_width * m_height; i++) {
       *(dst_32++) = *bitmap; // red component.
@@ -1912,7 +1985,7 @@ void vpDisplayX::displayImage(const unsigned char *bitmap)
     }
 
     // Affichage de l'image dans la Pixmap.
-    XPutImage(display, pixmap, context, Ximage, 0, 0, 0, 0, m_width, m_height);
+    putXImage(0, 0, m_width, m_height);
     XSetWindowBackgroundPixmap(display, window, pixmap);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
@@ -1938,6 +2011,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
                                  const unsigned int h)
 {
   if (m_displayHasBeenInitialized) {
+    waitXImage();
     switch (screen_depth) {
     case 8: {
       // Correction de l'image de facon a liberer les niveaux de gris
@@ -1967,8 +2041,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           i++;
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putXImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         // Correction de l'image de facon a liberer les niveaux de gris
         // ROUGE, VERT, BLEU, JAUNE
@@ -1992,7 +2065,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
               dst_8[j] = nivGris;
           }
         }
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putXImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       // Affichage de l'image dans la Pixmap.
@@ -2010,8 +2083,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putXImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
         int j_min = (std::max)((int)ceil(iP.get_j() / m_scale), 0);
@@ -2031,7 +2103,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putXImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2064,25 +2136,14 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         } else {
           // little endian
-          unsigned int i = 0;
-          while (i < h) {
-            unsigned int j = 0;
-            while (j < w) {
-              unsigned char val = *(src_8 + j);
-              *(dst_32 + 4 * j) = val;
-              *(dst_32 + 4 * j + 1) = val;
-              *(dst_32 + 4 * j + 2) = val;
-              *(dst_32 + 4 * j + 3) = vpRGBa::alpha_default;
-              j++;
-            }
+          for (unsigned int i = 0; i < h; i++) {
+            greyToBGRa(src_8, dst_32, w);
             src_8 = src_8 + iwidth;
             dst_32 = dst_32 + 4 * m_width;
-            i++;
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putXImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
         int j_min = (std::max)((int)ceil(iP.get_j() / m_scale), 0);
@@ -2120,7 +2181,7 @@ void vpDisplayX::displayImageROI(const vpImage<unsigned char> &I, const vpImageP
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putXImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2151,6 +2212,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
                                  const unsigned int h)
 {
   if (m_displayHasBeenInitialized) {
+    waitXImage();
     switch (screen_depth) {
     case 16: {
       if (m_scale == 1) {
@@ -2167,8 +2229,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
                 (((r << 8) >> RShift) & RMask) | (((g << 8) >> GShift) & GMask) | (((b << 8) >> BShift) & BMask);
           }
         }
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putXImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         unsigned int bytes_per_line = (unsigned int)Ximage->bytes_per_line;
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
@@ -2193,7 +2254,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
                 (((r << 8) >> RShift) & RMask) | (((g << 8) >> GShift) & GMask) | (((b << 8) >> BShift) & BMask);
           }
         }
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putXImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2237,23 +2298,14 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
         } else {
           // little endian
           while (i < h) {
-            unsigned int j = 0;
-            while (j < w) {
-              *(dst_32 + 4 * j) = (src_32 + j)->B;
-              *(dst_32 + 4 * j + 1) = (src_32 + j)->G;
-              *(dst_32 + 4 * j + 2) = (src_32 + j)->R;
-              *(dst_32 + 4 * j + 3) = (src_32 + j)->A;
-
-              j++;
-            }
+            RGBaToBGRa(src_32, dst_32, w);
             src_32 = src_32 + iwidth;
             dst_32 = dst_32 + 4 * m_width;
             i++;
           }
         }
 
-        XPutImage(display, pixmap, context, Ximage, (int)iP.get_u(), (int)iP.get_v(), (int)iP.get_u(), (int)iP.get_v(),
-                  w, h);
+        putXImage((int)iP.get_u(), (int)iP.get_v(), w, h);
       } else {
         int i_min = (std::max)((int)ceil(iP.get_i() / m_scale), 0);
         int j_min = (std::max)((int)ceil(iP.get_j() / m_scale), 0);
@@ -2290,7 +2342,7 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
             }
           }
         }
-        XPutImage(display, pixmap, context, Ximage, j_min, i_min, j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
+        putXImage(j_min, i_min, j_max_ - j_min_, i_max_ - i_min_);
       }
 
       XSetWindowBackgroundPixmap(display, window, pixmap);
@@ -2315,11 +2367,12 @@ void vpDisplayX::displayImageROI(const vpImage<vpRGBa> &I, const vpImagePoint &i
 void vpDisplayX::closeDisplay()
 {
   if (m_displayHasBeenInitialized) {
-    if (ximage_data_init == true)
-      free(Ximage->data);
+    destroyXImage();
 
-    Ximage->data = NULL;
-    XDestroyImage(Ximage);
+    if (font_info != NULL) {
+      XFreeFontInfo(NULL, font_info, 1);
+      font_info = NULL;
+    }
 
     XFreePixmap(display, pixmap);
 
@@ -2340,11 +2393,17 @@ void vpDisplayX::closeDisplay()
   Flushes the X buffer.
   It's necessary to use this function to see the results of any drawing.
 
+  Only the part of the window that was modified by a display function since
+  the last flush is repainted.
 */
 void vpDisplayX::flushDisplay()
 {
   if (m_displayHasBeenInitialized) {
-    XClearWindow(display, window);
+    if (dirty) {
+      XClearArea(display, window, dirty_umin, dirty_vmin, (unsigned int)(dirty_umax - dirty_umin + 1),
+                 (unsigned int)(dirty_vmax - dirty_vmin + 1), 0);
+      dirty = false;
+    }
     XFlush(display);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
@@ -2361,7 +2420,14 @@ void vpDisplayX::flushDisplay()
 void vpDisplayX::flushDisplayROI(const vpImagePoint &iP, const unsigned int w, const unsigned int h)
 {
   if (m_displayHasBeenInitialized) {
-    XClearArea(display, window, (int)(iP.get_u() / m_scale), (int)(iP.get_v() / m_scale), w / m_scale, h / m_scale, 0);
+    const int u = (int)(iP.get_u() / m_scale);
+    const int v = (int)(iP.get_v() / m_scale);
+    const unsigned int w_ = w / m_scale;
+    const unsigned int h_ = h / m_scale;
+    XClearArea(display, window, u, v, w_, h_, 0);
+    if (w_ > 0 && h_ > 0) {
+      removeDirtyArea(u, v, u + (int)w_ - 1, v + (int)h_ - 1);
+    }
     XFlush(display);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
@@ -2468,8 +2534,21 @@ void vpDisplayX::displayCharString(const vpImagePoint &ip, const char *text, con
       XAllocColor(display, lut, &xcolor);
       XSetForeground(display, context, xcolor.pixel);
     }
-    XDrawString(display, pixmap, context, (int)(ip.get_u() / m_scale), (int)(ip.get_v() / m_scale), text,
-                (int)strlen(text));
+    int u = (int)(ip.get_u() / m_scale);
+    int v = (int)(ip.get_v() / m_scale);
+    int length = (int)strlen(text);
+    XDrawString(display, pixmap, context, u, v, text, length);
+
+    if (font_info == NULL)
+      font_info = XQueryFont(display, XGContextFromGC(context));
+    if (font_info != NULL) {
+      int direction, ascent, descent;
+      XCharStruct overall;
+      XTextExtents(font_info, text, length, &direction, &ascent, &descent, &overall);
+      addDirtyArea(u + overall.lbearing, v - overall.ascent, u + overall.rbearing, v + overall.descent, 1);
+    } else {
+      addDirtyArea(0, 0, (int)m_width - 1, (int)m_height - 1);
+    }
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2503,15 +2582,15 @@ void vpDisplayX::displayCircle(const vpImagePoint &center, unsigned int radius,
 
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
 
+    int u = vpMath::round((center.get_u() - radius) / m_scale);
+    int v = vpMath::round((center.get_v() - radius) / m_scale);
+    unsigned int diameter = radius * 2 / m_scale;
     if (fill == false) {
-      XDrawArc(display, pixmap, context, vpMath::round((center.get_u() - radius) / m_scale),
-               vpMath::round((center.get_v() - radius) / m_scale), radius * 2 / m_scale, radius * 2 / m_scale, 0,
-               23040); /* 23040 = 360*64 */
+      XDrawArc(display, pixmap, context, u, v, diameter, diameter, 0, 23040); /* 23040 = 360*64 */
     } else {
-      XFillArc(display, pixmap, context, vpMath::round((center.get_u() - radius) / m_scale),
-               vpMath::round((center.get_v() - radius) / m_scale), radius * 2 / m_scale, radius * 2 / m_scale, 0,
-               23040); /* 23040 = 360*64 */
+      XFillArc(display, pixmap, context, u, v, diameter, diameter, 0, 23040); /* 23040 = 360*64 */
     }
+    addDirtyArea(u, v, u + (int)diameter, v + (int)diameter, thickness + 1);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2574,8 +2653,12 @@ void vpDisplayX::displayDotLine(const vpImagePoint &ip1, const vpImagePoint &ip2
 
     XSetLineAttributes(display, context, thickness, LineOnOffDash, CapButt, JoinBevel);
 
-    XDrawLine(display, pixmap, context, vpMath::round(ip1.get_u() / m_scale), vpMath::round(ip1.get_v() / m_scale),
-              vpMath::round(ip2.get_u() / m_scale), vpMath::round(ip2.get_v() / m_scale));
+    int u1 = vpMath::round(ip1.get_u() / m_scale);
+    int v1 = vpMath::round(ip1.get_v() / m_scale);
+    int u2 = vpMath::round(ip2.get_u() / m_scale);
+    int v2 = vpMath::round(ip2.get_v() / m_scale);
+    XDrawLine(display, pixmap, context, u1, v1, u2, v2);
+    addDirtyArea(u1, v1, u2, v2, thickness + 1);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2607,8 +2690,12 @@ void vpDisplayX::displayLine(const vpImagePoint &ip1, const vpImagePoint &ip2, c
 
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
 
-    XDrawLine(display, pixmap, context, vpMath::round(ip1.get_u() / m_scale), vpMath::round(ip1.get_v() / m_scale),
-              vpMath::round(ip2.get_u() / m_scale), vpMath::round(ip2.get_v() / m_scale));
+    int u1 = vpMath::round(ip1.get_u() / m_scale);
+    int v1 = vpMath::round(ip1.get_v() / m_scale);
+    int u2 = vpMath::round(ip2.get_u() / m_scale);
+    int v2 = vpMath::round(ip2.get_v() / m_scale);
+    XDrawLine(display, pixmap, context, u1, v1, u2, v2);
+    addDirtyArea(u1, v1, u2, v2, thickness + 1);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2634,11 +2721,14 @@ void vpDisplayX::displayPoint(const vpImagePoint &ip, const vpColor &color, unsi
       XSetForeground(display, context, xcolor.pixel);
     }
 
+    int u = vpMath::round(ip.get_u() / m_scale);
+    int v = vpMath::round(ip.get_v() / m_scale);
     if (thickness == 1) {
-      XDrawPoint(display, pixmap, context, vpMath::round(ip.get_u() / m_scale), vpMath::round(ip.get_v() / m_scale));
+      XDrawPoint(display, pixmap, context, u, v);
+      addDirtyArea(u, v, u, v);
     } else {
-      XFillRectangle(display, pixmap, context, vpMath::round(ip.get_u() / m_scale), vpMath::round(ip.get_v() / m_scale),
-                     thickness, thickness);
+      XFillRectangle(display, pixmap, context, u, v, thickness, thickness);
+      addDirtyArea(u, v, u + (int)thickness, v + (int)thickness);
     }
 
   } else {
@@ -2676,13 +2766,14 @@ void vpDisplayX::displayRectangle(const vpImagePoint &topLeft, unsigned int w, u
       XSetForeground(display, context, xcolor.pixel);
     }
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
+    int u = vpMath::round(topLeft.get_u() / m_scale);
+    int v = vpMath::round(topLeft.get_v() / m_scale);
     if (fill == false) {
-      XDrawRectangle(display, pixmap, context, vpMath::round(topLeft.get_u() / m_scale),
-                     vpMath::round(topLeft.get_v() / m_scale), w / m_scale, h / m_scale);
+      XDrawRectangle(display, pixmap, context, u, v, w / m_scale, h / m_scale);
     } else {
-      XFillRectangle(display, pixmap, context, vpMath::round(topLeft.get_u() / m_scale),
-                     vpMath::round(topLeft.get_v() / m_scale), w / m_scale, h / m_scale);
+      XFillRectangle(display, pixmap, context, u, v, w / m_scale, h / m_scale);
     }
+    addDirtyArea(u, v, u + (int)(w / m_scale), v + (int)(h / m_scale), thickness + 1);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2723,18 +2814,15 @@ void vpDisplayX::displayRectangle(const vpImagePoint &topLeft, const vpImagePoin
     vpImagePoint bottomRight_ = bottomRight / m_scale;
     unsigned int w = (unsigned int)vpMath::round(std::fabs(bottomRight_.get_u() - topLeft_.get_u()));
     unsigned int h = (unsigned int)vpMath::round(std::fabs(bottomRight_.get_v() - topLeft_.get_v()));
+    int u = vpMath::round(topLeft_.get_u() < bottomRight_.get_u() ? topLeft_.get_u() : bottomRight_.get_u());
+    int v = vpMath::round(topLeft_.get_v() < bottomRight_.get_v() ? topLeft_.get_v() : bottomRight_.get_v());
     if (fill == false) {
 
-      XDrawRectangle(display, pixmap, context,
-                     vpMath::round(topLeft_.get_u() < bottomRight_.get_u() ? topLeft_.get_u() : bottomRight_.get_u()),
-                     vpMath::round(topLeft_.get_v() < bottomRight_.get_v() ? topLeft_.get_v() : bottomRight_.get_v()),
-                     w > 0 ? w : 1, h > 0 ? h : 1);
+      XDrawRectangle(display, pixmap, context, u, v, w > 0 ? w : 1, h > 0 ? h : 1);
     } else {
-      XFillRectangle(display, pixmap, context,
-                     vpMath::round(topLeft_.get_u() < bottomRight_.get_u() ? topLeft_.get_u() : bottomRight_.get_u()),
-                     vpMath::round(topLeft_.get_v() < bottomRight_.get_v() ? topLeft_.get_v() : bottomRight_.get_v()),
-                     w, h);
+      XFillRectangle(display, pixmap, context, u, v, w, h);
     }
+    addDirtyArea(u, v, u + (int)w + 1, v + (int)h + 1, thickness + 1);
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
   }
@@ -2770,17 +2858,17 @@ void vpDisplayX::displayRectangle(const vpRect &rectangle, const vpColor &color,
 
     XSetLineAttributes(display, context, thickness, LineSolid, CapButt, JoinBevel);
 
+    int u = vpMath::round(rectangle.getLeft() / m_scale);
+    int v = vpMath::round(rectangle.getTop() / m_scale);
     if (fill == false) {
-      XDrawRectangle(display, pixmap, context, vpMath::round(rectangle.getLeft() / m_scale),
-                     vpMath::round(rectangle.getTop() / m_scale),
-                     (unsigned int)vpMath::round(rectangle.getWidth() / m_scale - 1),
+      XDrawRectangle(display, pixmap, context, u, v, (unsigned int)vpMath::round(rectangle.getWidth() / m_scale - 1),
                      (unsigned int)vpMath::round(rectangle.getHeight() / m_scale - 1));
     } else {
-      XFillRectangle(display, pixmap, context, vpMath::round(rectangle.getLeft() / m_scale),
-                     vpMath::round(rectangle.getTop() / m_scale),
-                     (unsigned int)vpMath::round(rectangle.getWidth() / m_scale),
+      XFillRectangle(display, pixmap, context, u, v, (unsigned int)vpMath::round(rectangle.getWidth() / m_scale),
                      (unsigned int)vpMath::round(rectangle.getHeight() / m_scale));
     }
+    addDirtyArea(u, v, u + vpMath::round(rectangle.getWidth() / m_scale),
+                 v + vpMath::round(rectangle.getHeight() / m_scale), thickness + 1);
 
   } else {
     throw(vpDisplayException(vpDisplayException::notInitializedError, "X not initialized"));
@@ -3316,6 +3404,179 @@ int vpDisplayX::getMsb(unsigned int u32val)
   return i;
 }
 
+/*!
+  Extend the area of the window to repaint at the next flush with the
+  rectangle with corners (\e u1, \e v1) and (\e u2, \e v2) in window
+  coordinates, enlarged by \e margin pixels.
+*/
+void vpDisplayX::addDirtyArea(int u1, int v1, int u2, int v2, unsigned int margin)
+{
+  int umin = (std::max)((std::min)(u1, u2) - (int)margin, 0);
+  int vmin = (std::max)((std::min)(v1, v2) - (int)margin, 0);
+  int umax = (std::min)((std::max)(u1, u2) + (int)margin, (int)m_width - 1);
+  int vmax = (std::min)((std::max)(v1, v2) + (int)margin, (int)m_height - 1);
+  if ((umin > umax) || (vmin > vmax))
+    return;
+
+  if (dirty) {
+    dirty_umin = (std::min)(dirty_umin, umin);
+    dirty_vmin = (std::min)(dirty_vmin, vmin);
+    dirty_umax = (std::max)(dirty_umax, umax);
+    dirty_vmax = (std::max)(dirty_vmax, vmax);
+  } else {
+    dirty_umin = umin;
+    dirty_vmin = vmin;
+    dirty_umax = umax;
+    dirty_vmax = vmax;
+    dirty = true;
+  }
+}
+
+/*!
+  Remove from the area of the window to repaint at the next flush the
+  rectangle with corners (\e umin, \e vmin) and (\e umax, \e vmax) in window
+  coordinates, that has just been repainted. The area is kept as a
+  rectangle: it is only trimmed when the rectangle covers a whole side of it.
+*/
+void vpDisplayX::removeDirtyArea(int umin, int vmin, int umax, int vmax)
+{
+  if (!dirty || umin > dirty_umax || umax < dirty_umin || vmin > dirty_vmax || vmax < dirty_vmin)
+    return;
+
+  const bool coverU = (umin <= dirty_umin) && (umax >= dirty_umax);
+  const bool coverV = (vmin <= dirty_vmin) && (vmax >= dirty_vmax);
+  if (coverU && coverV) {
+    dirty = false;
+  } else if (coverU) {
+    if (vmin <= dirty_vmin)
+      dirty_vmin = vmax + 1;
+    else if (vmax >= dirty_vmax)
+      dirty_vmax = vmin - 1;
+  } else if (coverV) {
+    if (umin <= dirty_umin)
+      dirty_umin = umax + 1;
+    else if (umax >= dirty_umax)
+      dirty_umax = umin - 1;
+  }
+}
+
+/*!
+  Create the image used to transfer the pixels to the X server. A shared
+  memory segment is used when the MIT-SHM extension is available and the
+  server can attach the segment. Otherwise the image data is allocated in
+  the client memory and sent with XPutImage().
+*/
+void vpDisplayX::createXImage()
+{
+  Visual *visual = DefaultVisual(display, screen);
+  ximage_shm = false;
+  ximage_put_pending = false;
+  dirty = false;
+
+#ifdef VISP_HAVE_X11_XSHM
+  if (XShmQueryExtension(display)) {
+    Ximage = XShmCreateImage(display, visual, screen_depth, ZPixmap, NULL, &shminfo, m_width, m_height);
+    if (Ximage != NULL) {
+      shminfo.shmid = shmget(IPC_PRIVATE, (size_t)Ximage->bytes_per_line * (size_t)Ximage->height, IPC_CREAT | 0600);
+      if (shminfo.shmid != -1) {
+        shminfo.shmaddr = (char *)shmat(shminfo.shmid, NULL, 0);
+        if (shminfo.shmaddr != (char *)-1) {
+          Ximage->data = shminfo.shmaddr;
+          shminfo.readOnly = False;
+
+          // XShmAttach() errors, for instance with a remote server, are
+          // reported asynchronously
+          {
+#if defined(VISP_HAVE_PTHREAD)
+            vpMutex::vpScopedLock lock(shmAttachMutex);
+#endif
+            shmAttachDisplay = display;
+            shmAttachFailed = false;
+            shmPreviousErrorHandler = XSetErrorHandler(shmErrorHandler);
+            XShmAttach(display, &shminfo);
+            XSync(display, False);
+            XSetErrorHandler(shmPreviousErrorHandler);
+            shmPreviousErrorHandler = NULL;
+            shmAttachDisplay = NULL;
+            ximage_shm = !shmAttachFailed;
+          }
+
+          if (!ximage_shm)
+            shmdt(shminfo.shmaddr);
+        }
+        // The segment is freed once both the client and the server detach it
+        shmctl(shminfo.shmid, IPC_RMID, NULL);
+      }
+
+      if (ximage_shm) {
+        ximage_data_init = false;
+        return;
+      }
+      Ximage->data = NULL;
+      XDestroyImage(Ximage);
+    }
+  }
+#endif
+
+  Ximage = XCreateImage(display, visual, screen_depth, ZPixmap, 0, NULL, m_width, m_height, XBitmapPad(display), 0);
+
+  Ximage->data = (char *)malloc(m_height * (unsigned int)Ximage->bytes_per_line);
+  ximage_data_init = true;
+}
+
+/*!
+  Free the image created by createXImage().
+*/
+void vpDisplayX::destroyXImage()
+{
+#ifdef VISP_HAVE_X11_XSHM
+  if (ximage_shm) {
+    XShmDetach(display, &shminfo);
+    XSync(display, False);
+    shmdt(shminfo.shmaddr);
+    ximage_shm = false;
+    ximage_put_pending = false;
+  }
+#endif
+  if (ximage_data_init == true)
+    free(Ximage->data);
+
+  Ximage->data = NULL;
+  XDestroyImage(Ximage);
+  Ximage = NULL;
+}
+
+/*!
+  Copy the area of size \e w x \e h with top-left corner (\e u, \e v) in
+  window coordinates from the image to the pixmap displayed in the window
+  background.
+*/
+void vpDisplayX::putXImage(int u, int v, unsigned int w, unsigned int h)
+{
+#ifdef VISP_HAVE_X11_XSHM
+  if (ximage_shm) {
+    XShmPutImage(display, pixmap, context, Ximage, u, v, u, v, w, h, False);
+    ximage_put_pending = true;
+  } else
+#endif
+  {
+    XPutImage(display, pixmap, context, Ximage, u, v, u, v, w, h);
+  }
+  addDirtyArea(u, v, u + (int)w - 1, v + (int)h - 1);
+}
+
+/*!
+  Wait until the X server has finished reading the shared memory image, so
+  that its content can be modified.
+*/
+void vpDisplayX::waitXImage()
+{
+  if (ximage_put_pending) {
+    XSync(display, False);
+    ximage_put_pending = false;
+  }
+}
+
 #elif !defined(VISP_BUILD_SHARED_LIBS)
 // Work arround to avoid warning: libvisp_core.a(vpDisplayX.cpp.o) has no
 // symbols
@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the X11 display.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDisplayXPerformance.cpp
+
+  Measure the time needed by vpDisplayX to display and flush full HD grey
+  level and color images with some overlay drawings, and check that the
+  displayed images and the overlays flushed without a new image are the
+  expected ones.
+
+  This test can be run without screen under a virtual X server:
+  \code
+  $ xvfb-run -s "-screen 0 1920x1080x24" ./testDisplayXPerformance
+  \endcode
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/gui/vpDisplayX.h>
+
+#if defined(VISP_HAVE_X11)
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+void generateImage(vpImage<unsigned char> &I, unsigned int frame)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (unsigned char)((i + j + 7 * frame) & 0xFF);
+    }
+  }
+}
+
+void generateImage(vpImage<vpRGBa> &I, unsigned int frame)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = vpRGBa((unsigned char)((i + 7 * frame) & 0xFF), (unsigned char)((j + 3 * frame) & 0xFF),
+                       (unsigned char)((i + j) & 0xFF));
+    }
+  }
+}
+
+void toRGBa(const vpImage<unsigned char> &I, vpImage<vpRGBa> &C) { vpImageConvert::convert(I, C); }
+
+void toRGBa(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &C) { C = I; }
+
+template <typename Type>
+bool test(vpImage<Type> &I, const std::string &type, unsigned int nbFrames, bool click_allowed)
+{
+  vpDisplayX d(I, 0, 0, "Display " + type);
+  std::cout << type << " image " << I.getWidth() << "x" << I.getHeight() << ", screen depth " << d.getScreenDepth()
+            << ", " << (d.hasSharedMemory() ? "shared memory" : "XPutImage") << std::endl;
+
+  // Full frames with overlays
+  double t_image = 0;
+  for (unsigned int frame = 0; frame < nbFrames; frame++) {
+    generateImage(I, frame);
+    double t = vpTime::measureTimeMs();
+    vpDisplay::display(I);
+    vpDisplay::displayRectangle(I, vpImagePoint(100 + frame, 200), 300, 200, vpColor::red, false, 2);
+    vpDisplay::displayCross(I, vpImagePoint(540, 960), 40, vpColor::green, 2);
+    vpDisplay::displayText(I, vpImagePoint(50, 50), "ViSP", vpColor::yellow);
+    vpDisplay::flush(I);
+    t_image += vpTime::measureTimeMs() - t;
+  }
+
+  // Overlays only
+  double t_overlay = 0;
+  for (unsigned int frame = 0; frame < nbFrames; frame++) {
+    double t = vpTime::measureTimeMs();
+    vpDisplay::displayCircle(I, vpImagePoint(300, 800 + 2 * frame), 20, vpColor::blue, true);
+    vpDisplay::flush(I);
+    t_overlay += vpTime::measureTimeMs() - t;
+  }
+
+  std::cout << "  display + overlays + flush: " << t_image / nbFrames << " ms/frame" << std::endl;
+  std::cout << "  overlays + flush: " << t_overlay / nbFrames << " ms/frame" << std::endl;
+
+  if (d.getScreenDepth() < 24) {
+    return true;
+  }
+
+  // The last image and the filled rectangle flushed without a new image
+  // have to be displayed
+  vpDisplay::display(I);
+  vpDisplay::flush(I);
+  vpDisplay::displayRectangle(I, vpImagePoint(500, 600), 40, 30, vpColor::green, true);
+  vpDisplay::flush(I);
+
+  vpImage<vpRGBa> Iexpected, Irendered;
+  toRGBa(I, Iexpected);
+  for (unsigned int i = 500; i < 530; i++) {
+    for (unsigned int j = 600; j < 640; j++) {
+      Iexpected[i][j] = vpRGBa(0, 255, 0);
+    }
+  }
+  vpDisplay::getImage(I, Irendered);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      const vpRGBa &e = Iexpected[i][j], &r = Irendered[i][j];
+      if (e.R != r.R || e.G != r.G || e.B != r.B) {
+        std::cerr << type << ": pixel (" << i << ", " << j << ") is (" << (int)r.R << ", " << (int)r.G << ", "
+                  << (int)r.B << ") instead of (" << (int)e.R << ", " << (int)e.G << ", " << (int)e.B << ")"
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+
+  if (click_allowed) {
+    vpDisplay::displayText(I, vpImagePoint(20, 20), "A click to continue...", vpColor::red);
+    vpDisplay::flush(I);
+    vpDisplay::getClick(I);
+  }
+
+  return true;
+}
+} // namespace
+#endif
+
+int main(int argc, const char *argv[])
+{
+  bool opt_display = true;
+  bool opt_click_allowed = true;
+  unsigned int opt_frames = 100;
+
+  for (int i = 1; i < argc; i++) {
+    if (std::string(argv[i]) == "-d")
+      opt_display = false;
+    else if (std::string(argv[i]) == "-c")
+      opt_click_allowed = false;
+    else if (std::string(argv[i]) == "-n" && i + 1 < argc)
+      opt_frames = (unsigned int)atoi(argv[++i]);
+    else if (std::string(argv[i]) == "--help" || std::string(argv[i]) == "-h") {
+      std::cout << "\nUsage: " << argv[0] << " [-n <frames>] [-c] [-d] [--help]\n" << std::endl;
+      std::cout << "\nOptions: " << std::endl;
+      std::cout << "  -n <frames> : number of frames to display (default " << opt_frames << ")" << std::endl;
+      std::cout << "  -c : disable mouse click" << std::endl;
+      std::cout << "  -d : disable display" << std::endl;
+      std::cout << "  -h, --help : print this help\n" << std::endl;
+      return EXIT_SUCCESS;
+    }
+  }
+
+  if (!opt_display) {
+    return EXIT_SUCCESS;
+  }
+
+  try {
+    vpImage<unsigned char> I(1080, 1920);
+    if (!test(I, "grey", opt_frames, opt_click_allowed)) {
+      return EXIT_FAILURE;
+    }
+
+    vpImage<vpRGBa> C(1080, 1920);
+    if (!test(C, "color", opt_frames, opt_click_allowed)) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testDisplayXPerformance is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
+
+#else
+int main()
+{
+  std::cout << "X11 is not available." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
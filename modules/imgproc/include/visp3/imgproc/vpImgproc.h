@@ -45,8 +45,10 @@
 #ifndef __vpImgproc_h__
 #define __vpImgproc_h__
 
+#include <vector>
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageMorphology.h>
+#include <visp3/core/vpImagePoint.h>
 #include <visp3/imgproc/vpContours.h>
 
 #define USE_OLD_FILL_HOLE 0
@@ -83,6 +85,19 @@ typedef enum {
                               */
 } vpAutoThresholdMethod;
 
+/*!
+  Statistics of a connected component computed by
+  vp::connectedComponents().
+*/
+typedef struct vpComponentStats {
+  unsigned int area;  //!< Number of pixels of the component.
+  unsigned int i_min; //!< Top row of the bounding box.
+  unsigned int i_max; //!< Bottom row of the bounding box.
+  unsigned int j_min; //!< Left column of the bounding box.
+  unsigned int j_max; //!< Right column of the bounding box.
+  vpImagePoint cog;   //!< Center of gravity of the component.
+} vpComponentStats;
+
 VISP_EXPORT void adjust(vpImage<unsigned char> &I, const double alpha, const double beta);
 VISP_EXPORT void adjust(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const double alpha,
                         const double beta);
@@ -127,6 +142,10 @@ VISP_EXPORT void unsharpMask(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Ires, co
 VISP_EXPORT void
 connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
                     const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
+VISP_EXPORT void
+connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                    std::vector<vpComponentStats> &stats,
+                    const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
 
 VISP_EXPORT void fillHoles(vpImage<unsigned char> &I
 #if USE_OLD_FILL_HOLE
@@ -143,6 +162,19 @@ VISP_EXPORT void reconstruct(const vpImage<unsigned char> &marker, const vpImage
                              vpImage<unsigned char> &I,
                              const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
 
+VISP_EXPORT void erosion(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                         unsigned int height);
+VISP_EXPORT void dilatation(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                            unsigned int height);
+VISP_EXPORT void opening(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                         unsigned int height);
+VISP_EXPORT void closing(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                         unsigned int height);
+VISP_EXPORT void whiteTopHat(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                             unsigned int height);
+VISP_EXPORT void blackTopHat(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                             unsigned int height);
+
 VISP_EXPORT unsigned char autoThreshold(vpImage<unsigned char> &I, const vp::vpAutoThresholdMethod &method,
                                         const unsigned char backgroundValue = 0,
                                         const unsigned char foregroundValue = 255);
@@ -41,69 +41,183 @@
   \brief Basic connected components.
 */
 
-#include <queue>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/imgproc/vpImgproc.h>
 
 namespace
 {
-void getNeighbors(const vpImage<unsigned char> &I, std::queue<vpImagePoint> &listOfNeighbors, const unsigned int i,
-                  const unsigned int j, const vpImageMorphology::vpConnexityType &connexity)
+// Images smaller than this number of pixels are labelled by the calling
+// thread only
+const unsigned int minParallelSize = 256 * 256;
+// Minimal height of the strips processed in parallel
+const unsigned int minStripHeight = 16;
+
+// Horizontal run of pixels having the same non zero value
+struct vpRun {
+  unsigned int i;
+  unsigned int j_start;
+  unsigned int j_end; // Inclusive
+  unsigned char value;
+};
+
+unsigned int findRoot(std::vector<unsigned int> &parent, unsigned int r)
 {
-  unsigned char currValue = I[i][j];
+  unsigned int root = r;
+  while (parent[root] != root) {
+    root = parent[root];
+  }
+  // Path compression
+  while (parent[r] != root) {
+    unsigned int next = parent[r];
+    parent[r] = root;
+    r = next;
+  }
+  return root;
+}
 
-  if (connexity == vpImageMorphology::CONNEXITY_4) {
-    // Top
-    if (I[i - 1][j] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i - 1, j));
-    }
+// The root of a set is its smallest run, that is its first run in raster
+// order
+void unite(std::vector<unsigned int> &parent, unsigned int r1, unsigned int r2)
+{
+  r1 = findRoot(parent, r1);
+  r2 = findRoot(parent, r2);
+  if (r1 < r2) {
+    parent[r2] = r1;
+  } else if (r2 < r1) {
+    parent[r1] = r2;
+  }
+}
 
-    // Left
-    if (I[i][j - 1] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i, j - 1));
+/*
+  Unite the runs [begin, end) of a row with the touching runs [prevBegin,
+  prevEnd) of the previous row that have the same value.
+*/
+void uniteRows(const std::vector<vpRun> &runs, std::vector<unsigned int> &parent, unsigned int prevBegin,
+               unsigned int prevEnd, unsigned int begin, unsigned int end, unsigned int diagonal)
+{
+  unsigned int p = prevBegin;
+  for (unsigned int r = begin; r < end; r++) {
+    const vpRun &run = runs[r];
+    while (p < prevEnd && runs[p].j_end + diagonal < run.j_start) {
+      p++;
     }
-
-    // Right
-    if (I[i][j + 1] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i, j + 1));
+    for (unsigned int q = p; q < prevEnd && runs[q].j_start <= run.j_end + diagonal; q++) {
+      if (runs[q].value == run.value) {
+        unite(parent, q, r);
+      }
     }
+  }
+}
 
-    // Bottom
-    if (I[i + 1][j] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i + 1, j));
-    }
-  } else {
-    for (int cpt1 = -1; cpt1 <= 1; cpt1++) {
-      for (int cpt2 = -1; cpt2 <= 1; cpt2++) {
-        // Everything except the current position
-        if (cpt1 != 0 || cpt2 != 0) {
-          if (I[(int)i + cpt1][(int)j + cpt2] == currValue) {
-            listOfNeighbors.push(vpImagePoint((int)i + cpt1, (int)j + cpt2));
-          }
-        }
+/*
+  Extract the runs of the rows [firstRow, lastRow) of an image and unite the
+  runs of consecutive rows. rowStart[k] is the index of the first run of row
+  firstRow + k.
+*/
+void labelStrip(const vpImage<unsigned char> &I, unsigned int firstRow, unsigned int lastRow, unsigned int diagonal,
+                std::vector<vpRun> &runs, std::vector<unsigned int> &rowStart, std::vector<unsigned int> &parent)
+{
+  const unsigned int width = I.getWidth();
+  runs.clear();
+  rowStart.resize(lastRow - firstRow + 1);
+
+  for (unsigned int i = firstRow; i < lastRow; i++) {
+    rowStart[i - firstRow] = (unsigned int)runs.size();
+    const unsigned char *row = I[i];
+    unsigned int j = 0;
+    while (j < width) {
+      if (row[j] == 0) {
+        j++;
+        continue;
+      }
+      vpRun run;
+      run.i = i;
+      run.j_start = j;
+      run.value = row[j];
+      while (j + 1 < width && row[j + 1] == run.value) {
+        j++;
       }
+      run.j_end = j;
+      runs.push_back(run);
+      j++;
     }
   }
+  rowStart[lastRow - firstRow] = (unsigned int)runs.size();
+
+  parent.resize(runs.size());
+  for (unsigned int r = 0; r < parent.size(); r++) {
+    parent[r] = r;
+  }
+  for (unsigned int k = 1; k < lastRow - firstRow; k++) {
+    uniteRows(runs, parent, rowStart[k - 1], rowStart[k], rowStart[k], rowStart[k + 1], diagonal);
+  }
 }
 
-void visitNeighbors(vpImage<unsigned char> &I_copy, std::queue<vpImagePoint> &listOfNeighbors, vpImage<int> &labels,
-                    const int current_label, const vpImageMorphology::vpConnexityType &connexity)
+// Write the labels of the rows [firstRow, lastRow) from their runs
+void writeLabels(const std::vector<vpRun> &runs, const std::vector<int> &runLabels, unsigned int firstRun,
+                 unsigned int lastRun, unsigned int firstRow, unsigned int lastRow, vpImage<int> &labels)
 {
-  // Visit the neighbors
-  while (!listOfNeighbors.empty()) {
-    vpImagePoint imPt = listOfNeighbors.front();
-    unsigned int i = (unsigned int)imPt.get_i();
-    unsigned int j = (unsigned int)imPt.get_j();
-    listOfNeighbors.pop();
-
-    if (I_copy[i][j]) {
-      getNeighbors(I_copy, listOfNeighbors, i, j, connexity);
-
-      // Reset current position and set label
-      I_copy[i][j] = 0;
-      labels[i][j] = current_label;
+  for (unsigned int i = firstRow; i < lastRow; i++) {
+    memset(labels[i], 0, sizeof(int) * labels.getWidth());
+  }
+  for (unsigned int r = firstRun; r < lastRun; r++) {
+    int *row = labels[runs[r].i];
+    const int label = runLabels[r];
+    for (unsigned int j = runs[r].j_start; j <= runs[r].j_end; j++) {
+      row[j] = label;
     }
   }
 }
+
+class vpStripTask : public vpThreadPool::vpTask
+{
+public:
+  vpStripTask(const vpImage<unsigned char> &I, unsigned int firstRow, unsigned int lastRow, unsigned int diagonal)
+    : m_I(&I), m_firstRow(firstRow), m_lastRow(lastRow), m_diagonal(diagonal), m_runs(), m_rowStart(), m_parent()
+  {
+  }
+
+  virtual void run() { labelStrip(*m_I, m_firstRow, m_lastRow, m_diagonal, m_runs, m_rowStart, m_parent); }
+
+  const vpImage<unsigned char> *m_I;
+  unsigned int m_firstRow;
+  unsigned int m_lastRow;
+  unsigned int m_diagonal;
+  std::vector<vpRun> m_runs;
+  std::vector<unsigned int> m_rowStart;
+  std::vector<unsigned int> m_parent;
+};
+
+class vpWriteLabelsTask : public vpThreadPool::vpTask
+{
+public:
+  vpWriteLabelsTask(const std::vector<vpRun> &runs, const std::vector<int> &runLabels, unsigned int firstRun,
+                    unsigned int lastRun, unsigned int firstRow, unsigned int lastRow, vpImage<int> &labels)
+    : m_runs(&runs), m_runLabels(&runLabels), m_firstRun(firstRun), m_lastRun(lastRun), m_firstRow(firstRow),
+      m_lastRow(lastRow), m_labels(&labels)
+  {
+  }
+
+  virtual void run() { writeLabels(*m_runs, *m_runLabels, m_firstRun, m_lastRun, m_firstRow, m_lastRow, *m_labels); }
+
+private:
+  const std::vector<vpRun> *m_runs;
+  const std::vector<int> *m_runLabels;
+  unsigned int m_firstRun;
+  unsigned int m_lastRun;
+  unsigned int m_firstRow;
+  unsigned int m_lastRow;
+  vpImage<int> *m_labels;
+};
+
+void runTasks(std::vector<vpThreadPool::vpTask *> &tasks)
+{
+  if (tasks.size() == 1) {
+    tasks[0]->run();
+  } else {
+    vpThreadPool::getInstance().run(tasks);
+  }
+}
 } // namespace
 
 /*!
@@ -119,54 +233,137 @@ void visitNeighbors(vpImage<unsigned char> &I_copy, std::queue<vpImagePoint> &li
 void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
                              const vpImageMorphology::vpConnexityType &connexity)
 {
-  if (I.getSize() == 0) {
-    return;
-  }
-
-  labels.resize(I.getHeight(), I.getWidth());
+  std::vector<vpComponentStats> stats;
+  connectedComponents(I, labels, nbComponents, stats, connexity);
+}
 
-  vpImage<unsigned char> I_copy(I.getHeight() + 2, I.getWidth() + 2);
-  // Copy and add border
-  for (unsigned int i = 0; i < I_copy.getHeight(); i++) {
-    if (i == 0 || i == I_copy.getHeight() - 1) {
-      memset(I_copy[i], 0, sizeof(unsigned char) * I_copy.getWidth());
-    } else {
-      I_copy[i][0] = 0;
-      memcpy(I_copy[i] + 1, I[i - 1], sizeof(unsigned char) * I.getWidth());
-      I_copy[i][I_copy.getWidth() - 1] = 0;
-    }
-  }
+/*!
+  \ingroup group_imgproc_connected_components
 
-  vpImage<int> labels_copy(I.getHeight() + 2, I.getWidth() + 2, 0);
+  Perform connected components detection and compute the area, the bounding
+  box and the center of gravity of each component.
 
-  int current_label = 1;
-  std::queue<vpImagePoint> listOfNeighbors;
+  A connected component is a set of connected pixels having the same non
+  zero value. The components are labelled from 1 in the order of their first
+  pixel when scanning the image row by row.
 
-  for (unsigned int cpt1 = 0; cpt1 < I.getHeight(); cpt1++) {
-    unsigned int i = cpt1 + 1;
+  The image is split into horizontal runs of pixels of same value. The runs
+  of consecutive rows are united with a union-find structure, in parallel
+  over strips of rows for large images, and the statistics are computed
+  from the runs without scanning the image again.
 
-    for (unsigned int cpt2 = 0; cpt2 < I.getWidth(); cpt2++) {
-      unsigned int j = cpt2 + 1;
+  \param I : Input image (0 means background).
+  \param labels : Label image that contain for each position the component
+  label.
+  \param nbComponents : Number of connected components.
+  \param stats : Statistics of the components, \e stats[k] corresponding to
+  the component labelled \e k+1.
+  \param connexity : Type of connexity.
+*/
+void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                             std::vector<vpComponentStats> &stats,
+                             const vpImageMorphology::vpConnexityType &connexity)
+{
+  if (I.getSize() == 0) {
+    return;
+  }
 
-      if (I_copy[i][j] && labels_copy[i][j] == 0) {
-        // Get all the neighbors relative to the current position
-        getNeighbors(I_copy, listOfNeighbors, i, j, connexity);
+  const unsigned int height = I.getHeight();
+  labels.resize(height, I.getWidth());
+  const unsigned int diagonal = connexity == vpImageMorphology::CONNEXITY_8 ? 1 : 0;
 
-        // Reset current position and set label
-        I_copy[i][j] = 0;
-        labels_copy[i][j] = current_label;
+  unsigned int nbStrips = 1;
+  if (I.getSize() >= minParallelSize) {
+    nbStrips = (std::min)(vpThreadPool::getInstance().getNbThreads() + 1, height / minStripHeight);
+    nbStrips = (std::max)(nbStrips, 1u);
+  }
 
-        visitNeighbors(I_copy, listOfNeighbors, labels_copy, current_label, connexity);
+  // Runs and partial labelling of each strip
+  std::vector<vpStripTask> stripTasks;
+  stripTasks.reserve(nbStrips);
+  for (unsigned int k = 0; k < nbStrips; k++) {
+    stripTasks.push_back(vpStripTask(I, height * k / nbStrips, height * (k + 1) / nbStrips, diagonal));
+  }
+  std::vector<vpThreadPool::vpTask *> tasks(nbStrips);
+  for (unsigned int k = 0; k < nbStrips; k++) {
+    tasks[k] = &stripTasks[k];
+  }
+  runTasks(tasks);
 
-        // Increment label
-        current_label++;
+  // Gather the strips, the runs remaining in raster order
+  std::vector<unsigned int> stripStart(nbStrips + 1, 0);
+  for (unsigned int k = 0; k < nbStrips; k++) {
+    stripStart[k + 1] = stripStart[k] + (unsigned int)stripTasks[k].m_runs.size();
+  }
+  std::vector<vpRun> runs;
+  std::vector<unsigned int> parent;
+  if (nbStrips == 1) {
+    runs.swap(stripTasks[0].m_runs);
+    parent.swap(stripTasks[0].m_parent);
+  } else {
+    runs.reserve(stripStart[nbStrips]);
+    parent.reserve(stripStart[nbStrips]);
+    for (unsigned int k = 0; k < nbStrips; k++) {
+      runs.insert(runs.end(), stripTasks[k].m_runs.begin(), stripTasks[k].m_runs.end());
+      for (size_t r = 0; r < stripTasks[k].m_parent.size(); r++) {
+        parent.push_back(stripTasks[k].m_parent[r] + stripStart[k]);
       }
     }
+
+    // Merge the last row of a strip with the first row of the next one
+    for (unsigned int k = 1; k < nbStrips; k++) {
+      const std::vector<unsigned int> &prevRows = stripTasks[k - 1].m_rowStart;
+      const std::vector<unsigned int> &rows = stripTasks[k].m_rowStart;
+      uniteRows(runs, parent, stripStart[k - 1] + prevRows[prevRows.size() - 2], stripStart[k],
+                stripStart[k] + rows[0], stripStart[k] + rows[1], diagonal);
+    }
+  }
+
+  // Final labels in raster order, the root of a component being its first
+  // run, and statistics
+  std::vector<int> runLabels(runs.size());
+  std::vector<double> sum_i, sum_j;
+  stats.clear();
+  for (unsigned int r = 0; r < runs.size(); r++) {
+    const unsigned int root = findRoot(parent, r);
+    const vpRun &run = runs[r];
+    const unsigned int length = run.j_end - run.j_start + 1;
+    if (root == r) {
+      runLabels[r] = (int)stats.size() + 1;
+      vpComponentStats component;
+      component.area = 0;
+      component.i_min = component.i_max = run.i;
+      component.j_min = run.j_start;
+      component.j_max = run.j_end;
+      stats.push_back(component);
+      sum_i.push_back(0.0);
+      sum_j.push_back(0.0);
+    } else {
+      runLabels[r] = runLabels[root];
+    }
+
+    const unsigned int k = (unsigned int)runLabels[r] - 1;
+    vpComponentStats &component = stats[k];
+    component.area += length;
+    component.i_max = (std::max)(component.i_max, run.i);
+    component.j_min = (std::min)(component.j_min, run.j_start);
+    component.j_max = (std::max)(component.j_max, run.j_end);
+    sum_i[k] += (double)run.i * length;
+    sum_j[k] += 0.5 * ((double)run.j_start + run.j_end) * length;
+  }
+  for (size_t k = 0; k < stats.size(); k++) {
+    stats[k].cog.set_ij(sum_i[k] / stats[k].area, sum_j[k] / stats[k].area);
   }
 
-  for (unsigned int i = 0; i < labels.getHeight(); i++) {
-    memcpy(labels[i], labels_copy[i + 1] + 1, sizeof(int) * labels.getWidth());
+  // Label image
+  std::vector<vpWriteLabelsTask> writeTasks;
+  writeTasks.reserve(nbStrips);
+  for (unsigned int k = 0; k < nbStrips; k++) {
+    writeTasks.push_back(vpWriteLabelsTask(runs, runLabels, stripStart[k], stripStart[k + 1],
+                                           stripTasks[k].m_firstRow, stripTasks[k].m_lastRow, labels));
+    tasks[k] = &writeTasks[k];
   }
+  runTasks(tasks);
 
-  nbComponents = current_label - 1;
+  nbComponents = (int)stats.size();
 }
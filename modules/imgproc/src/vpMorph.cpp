@@ -41,9 +41,251 @@
   \brief Additional image morphology functions.
 */
 
+#include <queue>
+#include <vector>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpImageTools.h>
 #include <visp3/imgproc/vpImgproc.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Flat erosion: minimum over the structuring element, +inf outside the image
+struct vpMinOp {
+  static inline unsigned char neutral() { return 255; }
+  static inline unsigned char apply(unsigned char a, unsigned char b) { return a < b ? a : b; }
+#if VISP_HAVE_SSE2
+  static inline __m128i apply(const __m128i &a, const __m128i &b) { return _mm_min_epu8(a, b); }
+#endif
+};
+
+// Flat dilatation: maximum over the structuring element, -inf outside the
+// image
+struct vpMaxOp {
+  static inline unsigned char neutral() { return 0; }
+  static inline unsigned char apply(unsigned char a, unsigned char b) { return a > b ? a : b; }
+#if VISP_HAVE_SSE2
+  static inline __m128i apply(const __m128i &a, const __m128i &b) { return _mm_max_epu8(a, b); }
+#endif
+};
+
+// dst[k] = Op(a[k], b[k]) for k in [0, n), dst may be a or b
+template <class Op> void applyOp(const unsigned char *a, const unsigned char *b, unsigned char *dst, unsigned int n)
+{
+  unsigned int k = 0;
+#if VISP_HAVE_SSE2
+  static const bool checkSSE2 = vpCPUFeatures::checkSSE2();
+  if (checkSSE2) {
+    for (; k + 16 <= n; k += 16) {
+      const __m128i va = _mm_loadu_si128((const __m128i *)(a + k));
+      const __m128i vb = _mm_loadu_si128((const __m128i *)(b + k));
+      _mm_storeu_si128((__m128i *)(dst + k), Op::apply(va, vb));
+    }
+  }
+#endif
+  for (; k < n; k++) {
+    dst[k] = Op::apply(a[k], b[k]);
+  }
+}
+
+// Block of columns processed at once by the van Herk / Gil-Werman column pass
+// so that its buffers stay in cache
+const unsigned int morph_strip_width = 256;
+
+// Up to this size the direct computation (k - 1 operations per pixel) is
+// faster than van Herk / Gil-Werman (3 operations and 2 stores per pixel)
+const unsigned int morph_direct_max_size = 5;
+
+/*
+  Running minimum or maximum of size k along the columns of I: the window of
+  the row i is [i - before, i - before + k - 1]. Ires has to be another image.
+
+  For large k the van Herk / Gil-Werman algorithm is used: the padded column
+  is cut into blocks of k pixels in which a prefix (g) and a suffix (h) scan
+  are computed, so that any window, which covers at most two blocks, is given
+  by Op(h[i], g[i + k - 1]). All the operations combine contiguous rows.
+*/
+template <class Op>
+void runningColumns(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int k,
+                    unsigned int before)
+{
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  const unsigned int nb = ((height + k - 1 + k - 1) / k) * k;
+  std::vector<unsigned char> border(width, Op::neutral());
+  std::vector<const unsigned char *> rows(nb);
+  for (unsigned int t = 0; t < nb; t++) {
+    rows[t] = (t >= before && t < before + height) ? I[t - before] : &border[0];
+  }
+
+  Ires.resize(height, width);
+
+  if (k <= morph_direct_max_size) {
+    for (unsigned int i = 0; i < height; i++) {
+      applyOp<Op>(rows[i], rows[i + 1], Ires[i], width);
+      for (unsigned int u = 2; u < k; u++) {
+        applyOp<Op>(Ires[i], rows[i + u], Ires[i], width);
+      }
+    }
+    return;
+  }
+
+  std::vector<unsigned char> g(nb * morph_strip_width), h(nb * morph_strip_width);
+  for (unsigned int c = 0; c < width; c += morph_strip_width) {
+    const unsigned int n = std::min(morph_strip_width, width - c);
+    unsigned char *const G = &g[0], *const H = &h[0];
+
+    for (unsigned int t = 0; t < nb; t += k) {
+      memcpy(G + t * n, rows[t] + c, n);
+      for (unsigned int u = t + 1; u < t + k; u++) {
+        applyOp<Op>(G + (u - 1) * n, rows[u] + c, G + u * n, n);
+      }
+      memcpy(H + (t + k - 1) * n, rows[t + k - 1] + c, n);
+      for (unsigned int u = t + k - 1; u > t; u--) {
+        applyOp<Op>(H + u * n, rows[u - 1] + c, H + (u - 1) * n, n);
+      }
+    }
+
+    for (unsigned int i = 0; i < height; i++) {
+      applyOp<Op>(H + i * n, G + (i + k - 1) * n, Ires[i] + c, n);
+    }
+  }
+}
+
+/*
+  Running minimum or maximum of size k <= morph_direct_max_size along the rows
+  of I, computed directly on a padded copy of each row. The window of the
+  column j is [j - before, j - before + k - 1]. I and Ires may be the same
+  image.
+*/
+template <class Op>
+void runningRowsDirect(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int k,
+                       unsigned int before)
+{
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  std::vector<unsigned char> P(width + k - 1, Op::neutral());
+
+  if (&Ires != &I) {
+    Ires.resize(height, width);
+  }
+
+  for (unsigned int i = 0; i < height; i++) {
+    memcpy(&P[before], I[i], width);
+    applyOp<Op>(&P[0], &P[1], Ires[i], width);
+    for (unsigned int u = 2; u < k; u++) {
+      applyOp<Op>(Ires[i], &P[u], Ires[i], width);
+    }
+  }
+}
+
+#if VISP_HAVE_SSE2
+// Interleave the bytes of the rows u and u + 8 of a 16x16 block
+inline void interleave(const __m128i *r, __m128i *t)
+{
+  t[0] = _mm_unpacklo_epi8(r[0], r[8]);
+  t[1] = _mm_unpackhi_epi8(r[0], r[8]);
+  t[2] = _mm_unpacklo_epi8(r[1], r[9]);
+  t[3] = _mm_unpackhi_epi8(r[1], r[9]);
+  t[4] = _mm_unpacklo_epi8(r[2], r[10]);
+  t[5] = _mm_unpackhi_epi8(r[2], r[10]);
+  t[6] = _mm_unpacklo_epi8(r[3], r[11]);
+  t[7] = _mm_unpackhi_epi8(r[3], r[11]);
+  t[8] = _mm_unpacklo_epi8(r[4], r[12]);
+  t[9] = _mm_unpackhi_epi8(r[4], r[12]);
+  t[10] = _mm_unpacklo_epi8(r[5], r[13]);
+  t[11] = _mm_unpackhi_epi8(r[5], r[13]);
+  t[12] = _mm_unpacklo_epi8(r[6], r[14]);
+  t[13] = _mm_unpackhi_epi8(r[6], r[14]);
+  t[14] = _mm_unpacklo_epi8(r[7], r[15]);
+  t[15] = _mm_unpackhi_epi8(r[7], r[15]);
+}
+#endif
+
+// Transpose I into It (another image), by 16x16 blocks with SSE2
+void transpose(const vpImage<unsigned char> &I, vpImage<unsigned char> &It)
+{
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  It.resize(width, height);
+
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  static const bool checkSSE2 = vpCPUFeatures::checkSSE2();
+  if (checkSSE2) {
+    for (; i + 16 <= height; i += 16) {
+      unsigned int j = 0;
+      for (; j + 16 <= width; j += 16) {
+        __m128i r[16], t[16];
+        for (unsigned int u = 0; u < 16; u++) {
+          r[u] = _mm_loadu_si128((const __m128i *)(I[i + u] + j));
+        }
+        // Each pass rotates the 8 bits (4 bits of row, 4 bits of column) of
+        // the index of an element by one, 4 passes swap the row and the column
+        interleave(r, t);
+        interleave(t, r);
+        interleave(r, t);
+        interleave(t, r);
+        for (unsigned int u = 0; u < 16; u++) {
+          _mm_storeu_si128((__m128i *)(It[j + u] + i), r[u]);
+        }
+      }
+      for (; j < width; j++) {
+        for (unsigned int u = 0; u < 16; u++) {
+          It[j][i + u] = I[i + u][j];
+        }
+      }
+    }
+  }
+#endif
+
+  for (; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      It[j][i] = I[i][j];
+    }
+  }
+}
+
+/*
+  Flat morphology with a width x height rectangle, as a column pass followed
+  by a row pass, done as a column pass of the transposed image for large
+  widths. For the erosion
+  the anchor is at (width/2, height/2); the dilatation uses the reflected
+  rectangle so that openings and closings are also correct with even sizes.
+  I and Ires may be the same image.
+*/
+template <class Op>
+void morphRectangle(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                    unsigned int height, bool reflect)
+{
+  if (width == 0 || height == 0) {
+    throw vpException(vpException::badValue, "Null size of the structuring element: %ux%u", width, height);
+  }
+
+  vpImage<unsigned char> J;
+  if (height > 1) {
+    runningColumns<Op>(I, J, height, reflect ? height - 1 - height / 2 : height / 2);
+  }
+
+  if (width > 1 && width <= morph_direct_max_size) {
+    runningRowsDirect<Op>(height > 1 ? J : I, Ires, width, reflect ? width - 1 - width / 2 : width / 2);
+  } else if (width > 1) {
+    vpImage<unsigned char> T, T_res;
+    transpose(height > 1 ? J : I, T);
+    runningColumns<Op>(T, T_res, width, reflect ? width - 1 - width / 2 : width / 2);
+    transpose(T_res, Ires);
+  } else if (height > 1) {
+    Ires = J;
+  } else if (&Ires != &I) {
+    Ires = I;
+  }
+}
+} // namespace
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   \ingroup group_imgproc_morph
 
@@ -137,6 +379,14 @@ void vp::fillHoles(vpImage<unsigned char> &I
   ) \f] with \f$ k \f$ such that: \f$ D_{g}^{\left ( k \right )} \left ( f
   \right ) = D_{g}^{\left ( k+1 \right )} \left ( f \right ) \f$
 
+  The reconstruction is computed with the hybrid algorithm of L. Vincent
+  ("Morphological grayscale reconstruction in image analysis: applications and
+  efficient algorithms", IEEE Trans. on Image Processing, 1993): a raster and
+  an anti-raster scan propagate the marker, then a FIFO queue propagates the
+  remaining changes only where they happen. The cost is a few passes over the
+  image instead of one dilatation per iteration of the geodesic dilatation,
+  for the same result.
+
   \param marker : Grayscale image marker.
   \param mask : Grayscale image mask.
   \param h_kp1 : Image morphologically reconstructed.
@@ -157,24 +407,228 @@ void vp::reconstruct(const vpImage<unsigned char> &marker, const vpImage<unsigne
     return;
   }
 
-  vpImage<unsigned char> h_k = marker;
-  h_kp1 = h_k;
+  // First geodesic dilatation, after which the marker is below the mask as
+  // required by the hybrid algorithm
+  vpImage<unsigned char> h_1 = marker;
+  vpImageMorphology::dilatation(h_1, connexity);
+
+  // Images with a one pixel border set to 0 in both the marker and the mask
+  // so that the border pixels are never propagated nor enqueued
+  const unsigned int height = marker.getHeight(), width = marker.getWidth();
+  const int stride = (int)width + 2;
+  vpImage<unsigned char> J(height + 2, width + 2, 0), M(height + 2, width + 2, 0);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      M[i + 1][j + 1] = mask[i][j];
+      J[i + 1][j + 1] = std::min(h_1[i][j], mask[i][j]);
+    }
+  }
+
+  // Neighbors already visited by the raster scan (the anti-raster scan uses
+  // the opposite offsets)
+  int offsets[4];
+  unsigned int nbOffsets;
+  if (connexity == vpImageMorphology::CONNEXITY_4) {
+    offsets[0] = -stride;
+    offsets[1] = -1;
+    nbOffsets = 2;
+  } else {
+    offsets[0] = -stride - 1;
+    offsets[1] = -stride;
+    offsets[2] = -stride + 1;
+    offsets[3] = -1;
+    nbOffsets = 4;
+  }
+
+  unsigned char *const ptrJ = J.bitmap;
+  const unsigned char *const ptrM = M.bitmap;
+
+  // Raster scan
+  for (unsigned int i = 1; i <= height; i++) {
+    int p = (int)i * stride + 1;
+    for (unsigned int j = 1; j <= width; j++, p++) {
+      unsigned char value = ptrJ[p];
+      for (unsigned int k = 0; k < nbOffsets; k++) {
+        value = std::max(value, ptrJ[p + offsets[k]]);
+      }
+      ptrJ[p] = std::min(value, ptrM[p]);
+    }
+  }
 
-  do {
-    // Dilatation
-    vpImageMorphology::dilatation(h_kp1, connexity);
+  // Anti-raster scan, the pixels that can still propagate are enqueued
+  std::queue<int> fifo;
+  for (unsigned int i = height; i >= 1; i--) {
+    int p = (int)i * stride + (int)width;
+    for (unsigned int j = width; j >= 1; j--, p--) {
+      unsigned char value = ptrJ[p];
+      for (unsigned int k = 0; k < nbOffsets; k++) {
+        value = std::max(value, ptrJ[p - offsets[k]]);
+      }
+      value = std::min(value, ptrM[p]);
+      ptrJ[p] = value;
 
-    // Keep min
-    for (unsigned int i = 0; i < h_kp1.getHeight(); i++) {
-      for (unsigned int j = 0; j < h_kp1.getWidth(); j++) {
-        h_kp1[i][j] = std::min(h_kp1[i][j], mask[i][j]);
+      for (unsigned int k = 0; k < nbOffsets; k++) {
+        const int q = p - offsets[k];
+        if (ptrJ[q] < value && ptrJ[q] < ptrM[q]) {
+          fifo.push(p);
+          break;
+        }
       }
     }
+  }
+
+  // Propagation
+  while (!fifo.empty()) {
+    const int p = fifo.front();
+    fifo.pop();
+    const unsigned char value = ptrJ[p];
 
-    if (h_kp1 == h_k) {
-      break;
+    for (unsigned int k = 0; k < 2 * nbOffsets; k++) {
+      const int q = k < nbOffsets ? p + offsets[k] : p - offsets[k - nbOffsets];
+      if (ptrJ[q] < value && ptrJ[q] != ptrM[q]) {
+        ptrJ[q] = std::min(value, ptrM[q]);
+        fifo.push(q);
+      }
     }
+  }
+
+  h_kp1.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    memcpy(h_kp1[i], J[i + 1] + 1, width);
+  }
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Erode a grayscale image with a flat rectangular structuring element of size
+  \a width x \a height. A line structuring element is obtained with a height
+  or a width equal to 1. Pixels outside the image are considered as equal to
+  255.
+
+  The erosion is computed with the van Herk / Gil-Werman running minimum along
+  the columns and then along the rows, on the transposed image, so that all
+  the comparisons work on contiguous memory and use SSE2 when available. The
+  cost is about 6 comparisons per pixel whatever the size of the structuring
+  element.
+
+  \param I : Input image.
+  \param Ires : Eroded image. Can be the same image as \a I.
+  \param width : Width of the structuring element. The anchor is at the
+  column width/2.
+  \param height : Height of the structuring element. The anchor is at the row
+  height/2.
+
+  \sa dilatation(const vpImage<unsigned char> &, vpImage<unsigned char> &, unsigned int, unsigned int)
+*/
+void vp::erosion(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                 unsigned int height)
+{
+  morphRectangle<vpMinOp>(I, Ires, width, height, false);
+}
+
+/*!
+  \ingroup group_imgproc_morph
 
-    h_k = h_kp1;
-  } while (true);
+  Dilate a grayscale image with a flat rectangular structuring element of size
+  \a width x \a height. A line structuring element is obtained with a height
+  or a width equal to 1. Pixels outside the image are considered as equal to
+  0.
+
+  As for erosion(), the cost does not depend on the size of the structuring
+  element. The dilatation uses the structuring element reflected about its
+  anchor, which makes no difference for odd sizes and keeps opening() and
+  closing() consistent for even sizes.
+
+  \param I : Input image.
+  \param Ires : Dilated image. Can be the same image as \a I.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+
+  \sa erosion(const vpImage<unsigned char> &, vpImage<unsigned char> &, unsigned int, unsigned int)
+*/
+void vp::dilatation(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                    unsigned int height)
+{
+  morphRectangle<vpMaxOp>(I, Ires, width, height, true);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Morphological opening (erosion followed by dilatation) with a flat
+  rectangular structuring element of size \a width x \a height.
+
+  \param I : Input image.
+  \param Ires : Opened image. Can be the same image as \a I.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+*/
+void vp::opening(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                 unsigned int height)
+{
+  vp::erosion(I, Ires, width, height);
+  vp::dilatation(Ires, Ires, width, height);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Morphological closing (dilatation followed by erosion) with a flat
+  rectangular structuring element of size \a width x \a height.
+
+  \param I : Input image.
+  \param Ires : Closed image. Can be the same image as \a I.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+*/
+void vp::closing(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                 unsigned int height)
+{
+  vp::dilatation(I, Ires, width, height);
+  vp::erosion(Ires, Ires, width, height);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  White top-hat transform: difference between the image and its opening by a
+  flat rectangular structuring element of size \a width x \a height. It
+  extracts the bright details smaller than the structuring element.
+
+  \param I : Input image.
+  \param Ires : Transformed image. Can be the same image as \a I.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+
+  \sa blackTopHat()
+*/
+void vp::whiteTopHat(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                     unsigned int height)
+{
+  vpImage<unsigned char> I_open;
+  vp::opening(I, I_open, width, height);
+  vpImageTools::imageSubtract(I, I_open, Ires, true);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Black top-hat transform: difference between the closing of the image by a
+  flat rectangular structuring element of size \a width x \a height and the
+  image. It extracts the dark details smaller than the structuring element.
+
+  \param I : Input image.
+  \param Ires : Transformed image. Can be the same image as \a I.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+
+  \sa whiteTopHat()
+*/
+void vp::blackTopHat(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                     unsigned int height)
+{
+  vpImage<unsigned char> I_close;
+  vp::closing(I, I_close, width, height);
+  vpImageTools::imageSubtract(I_close, I, Ires, true);
 }
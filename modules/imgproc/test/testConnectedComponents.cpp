@@ -36,6 +36,7 @@
  *
  *****************************************************************************/
 #include <map>
+#include <queue>
 #include <set>
 #include <visp3/core/vpImageTools.h>
 #include <visp3/core/vpIoTools.h>
@@ -55,6 +56,9 @@
 void usage(const char *name, const char *badparam, std::string ipath, std::string opath, std::string user);
 bool getOptions(int argc, const char **argv, std::string &ipath, std::string &opath, std::string user);
 bool checkLabels(const vpImage<int> &label1, const vpImage<int> &label2);
+void referenceConnectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                                  const vpImageMorphology::vpConnexityType &connexity);
+bool checkSynthetic(unsigned int height, unsigned int width, const vpImageMorphology::vpConnexityType &connexity);
 
 /*
   Print the program options.
@@ -197,6 +201,101 @@ bool checkLabels(const vpImage<int> &label1, const vpImage<int> &label2)
   return true;
 }
 
+/*
+  Label the image with a breadth-first search, the components being numbered
+  in the order of their first pixel in raster order.
+ */
+void referenceConnectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                                  const vpImageMorphology::vpConnexityType &connexity)
+{
+  const int height = (int)I.getHeight(), width = (int)I.getWidth();
+  labels.resize(I.getHeight(), I.getWidth(), 0);
+  nbComponents = 0;
+  std::queue<std::pair<int, int> > queue;
+  for (int i = 0; i < height; i++) {
+    for (int j = 0; j < width; j++) {
+      if (I[i][j] == 0 || labels[i][j] != 0) {
+        continue;
+      }
+      nbComponents++;
+      labels[i][j] = nbComponents;
+      queue.push(std::make_pair(i, j));
+      while (!queue.empty()) {
+        std::pair<int, int> pt = queue.front();
+        queue.pop();
+        for (int di = -1; di <= 1; di++) {
+          for (int dj = -1; dj <= 1; dj++) {
+            int ii = pt.first + di, jj = pt.second + dj;
+            if ((di == 0 && dj == 0) || (connexity == vpImageMorphology::CONNEXITY_4 && di != 0 && dj != 0) ||
+                ii < 0 || jj < 0 || ii >= height || jj >= width) {
+              continue;
+            }
+            if (I[ii][jj] == I[i][j] && labels[ii][jj] == 0) {
+              labels[ii][jj] = nbComponents;
+              queue.push(std::make_pair(ii, jj));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*
+  Compare the labels and the statistics of the components of a synthetic
+  image made of blobs of several values with the reference labelling.
+ */
+bool checkSynthetic(unsigned int height, unsigned int width, const vpImageMorphology::vpConnexityType &connexity)
+{
+  vpImage<unsigned char> I(height, width, 0);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      unsigned int h = (i * 2654435761u) ^ (j * 40503u) ^ ((i / 5) * (j / 7) * 97u);
+      if (h % 5 < 2 || ((i / 9 + j / 13) % 3 == 0 && h % 3 != 0)) {
+        I[i][j] = (unsigned char)(1 + (h >> 7) % 2);
+      }
+    }
+  }
+
+  vpImage<int> labels, labels_ref;
+  int nbComponents = 0, nbComponents_ref = 0;
+  std::vector<vp::vpComponentStats> stats;
+  vp::connectedComponents(I, labels, nbComponents, stats, connexity);
+  referenceConnectedComponents(I, labels_ref, nbComponents_ref, connexity);
+
+  if (nbComponents != nbComponents_ref || !(labels == labels_ref) || stats.size() != (size_t)nbComponents) {
+    std::cerr << "Bad labelling of a " << width << "x" << height << " image: " << nbComponents
+              << " components instead of " << nbComponents_ref << std::endl;
+    return false;
+  }
+
+  std::vector<unsigned int> area(stats.size(), 0);
+  std::vector<double> sum_i(stats.size(), 0.0), sum_j(stats.size(), 0.0);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      if (labels[i][j] == 0) {
+        continue;
+      }
+      const vp::vpComponentStats &component = stats[(size_t)labels[i][j] - 1];
+      if (i < component.i_min || i > component.i_max || j < component.j_min || j > component.j_max) {
+        std::cerr << "Pixel (" << i << ", " << j << ") outside of the bounding box of its component" << std::endl;
+        return false;
+      }
+      area[(size_t)labels[i][j] - 1]++;
+      sum_i[(size_t)labels[i][j] - 1] += i;
+      sum_j[(size_t)labels[i][j] - 1] += j;
+    }
+  }
+  for (size_t k = 0; k < stats.size(); k++) {
+    if (area[k] != stats[k].area || !vpMath::equal(sum_i[k] / area[k], stats[k].cog.get_i(), 1e-9) ||
+        !vpMath::equal(sum_j[k] / area[k], stats[k].cog.get_j(), 1e-9)) {
+      std::cerr << "Bad statistics for component " << k + 1 << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
 int main(int argc, const char **argv)
 {
   try {
@@ -231,6 +330,16 @@ int main(int argc, const char **argv)
       exit(EXIT_FAILURE);
     }
 
+    // Compare with a reference labelling on synthetic images, the largest
+    // ones being labelled in parallel
+    const unsigned int sizes[][2] = {{1, 1}, {1, 37}, {23, 1}, {31, 47}, {480, 640}, {1021, 1283}};
+    for (unsigned int s = 0; s < 6; s++) {
+      if (!checkSynthetic(sizes[s][0], sizes[s][1], vpImageMorphology::CONNEXITY_4) ||
+          !checkSynthetic(sizes[s][0], sizes[s][1], vpImageMorphology::CONNEXITY_8)) {
+        return EXIT_FAILURE;
+      }
+    }
+
     // Get the option values
     if (!opt_ipath.empty())
       ipath = opt_ipath;
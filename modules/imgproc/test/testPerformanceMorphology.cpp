@@ -0,0 +1,356 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test and benchmark of the grayscale morphology of the imgproc module.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceMorphology.cpp
+
+  \brief Check vp::erosion(), vp::dilatation(), vp::opening(), vp::closing()
+  and the top-hat transforms against a brute-force implementation, check that
+  vp::reconstruct() gives the same result as the iterated geodesic dilatation,
+  and compare the timings with the repeated 3x3 vpImageMorphology operations
+  for 3x3, 15x15 and 51x51 structuring elements.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <sstream>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImageMorphology.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/imgproc/vpImgproc.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+void generateRandomImage(vpImage<unsigned char> &I, unsigned int height, unsigned int width, vpUniRand &rand)
+{
+  I.resize(height, width);
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    I.bitmap[i] = (unsigned char)(rand() * 256);
+  }
+}
+
+// Smooth image with bright spots of different heights
+void generateSmoothImage(vpImage<unsigned char> &I, unsigned int height, unsigned int width)
+{
+  I.resize(height, width);
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      double val = 127.5 + 60. * sin(j / 13.) * cos(i / 19.) + 60. * cos((i + j) / 41.);
+      I[i][j] = (unsigned char)vpMath::round(val);
+    }
+  }
+}
+
+// Flat erosion or dilatation of a width x height rectangle, computed pixel by
+// pixel
+void morphologyReference(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, unsigned int width,
+                         unsigned int height, bool erode)
+{
+  // The dilatation uses the reflected structuring element
+  int top = erode ? (int)(height / 2) : (int)(height - 1 - height / 2);
+  int left = erode ? (int)(width / 2) : (int)(width - 1 - width / 2);
+  Ires.resize(I.getHeight(), I.getWidth());
+  for (int i = 0; i < (int)I.getHeight(); i++) {
+    for (int j = 0; j < (int)I.getWidth(); j++) {
+      unsigned char value = erode ? 255 : 0;
+      for (int u = i - top; u < i - top + (int)height; u++) {
+        for (int v = j - left; v < j - left + (int)width; v++) {
+          if (u >= 0 && v >= 0 && u < (int)I.getHeight() && v < (int)I.getWidth()) {
+            value = erode ? std::min(value, I[u][v]) : std::max(value, I[u][v]);
+          }
+        }
+      }
+      Ires[i][j] = value;
+    }
+  }
+}
+
+// Reconstruction by iterated geodesic dilatation, as done before the hybrid
+// algorithm was introduced
+void reconstructReference(const vpImage<unsigned char> &marker, const vpImage<unsigned char> &mask,
+                          vpImage<unsigned char> &h_kp1, const vpImageMorphology::vpConnexityType &connexity)
+{
+  vpImage<unsigned char> h_k = marker;
+  h_kp1 = h_k;
+
+  do {
+    vpImageMorphology::dilatation(h_kp1, connexity);
+
+    for (unsigned int i = 0; i < h_kp1.getHeight(); i++) {
+      for (unsigned int j = 0; j < h_kp1.getWidth(); j++) {
+        h_kp1[i][j] = std::min(h_kp1[i][j], mask[i][j]);
+      }
+    }
+
+    if (h_kp1 == h_k) {
+      break;
+    }
+
+    h_k = h_kp1;
+  } while (true);
+}
+
+bool compare(const vpImage<unsigned char> &I, const vpImage<unsigned char> &I_ref, const std::string &name)
+{
+  if (I.getHeight() != I_ref.getHeight() || I.getWidth() != I_ref.getWidth()) {
+    std::cerr << name << ": size " << I.getWidth() << "x" << I.getHeight() << " instead of " << I_ref.getWidth()
+              << "x" << I_ref.getHeight() << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (I[i][j] != I_ref[i][j]) {
+        std::cerr << name << ": pixel (" << i << ", " << j << ") is " << (int)I[i][j] << " instead of "
+                  << (int)I_ref[i][j] << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool testMorphology(const vpImage<unsigned char> &I, unsigned int width, unsigned int height)
+{
+  std::stringstream ss;
+  ss << I.getWidth() << "x" << I.getHeight() << " image, " << width << "x" << height << " structuring element";
+  const std::string name = ss.str();
+
+  vpImage<unsigned char> I_erode, I_dilate, I_ref, I_tmp;
+  morphologyReference(I, I_erode, width, height, true);
+  morphologyReference(I, I_dilate, width, height, false);
+
+  vp::erosion(I, I_tmp, width, height);
+  if (!compare(I_tmp, I_erode, "erosion, " + name)) {
+    return false;
+  }
+  vp::dilatation(I, I_tmp, width, height);
+  if (!compare(I_tmp, I_dilate, "dilatation, " + name)) {
+    return false;
+  }
+
+  // In place
+  I_tmp = I;
+  vp::erosion(I_tmp, I_tmp, width, height);
+  if (!compare(I_tmp, I_erode, "in place erosion, " + name)) {
+    return false;
+  }
+
+  vpImage<unsigned char> I_open, I_close;
+  morphologyReference(I_erode, I_open, width, height, false);
+  morphologyReference(I_dilate, I_close, width, height, true);
+  vp::opening(I, I_tmp, width, height);
+  if (!compare(I_tmp, I_open, "opening, " + name)) {
+    return false;
+  }
+  vp::closing(I, I_tmp, width, height);
+  if (!compare(I_tmp, I_close, "closing, " + name)) {
+    return false;
+  }
+
+  // The opening is below the image and the closing above, so that the
+  // top-hats do not saturate
+  vpImageTools::imageSubtract(I, I_open, I_ref);
+  vp::whiteTopHat(I, I_tmp, width, height);
+  if (!compare(I_tmp, I_ref, "white top-hat, " + name)) {
+    return false;
+  }
+  vpImageTools::imageSubtract(I_close, I, I_ref);
+  vp::blackTopHat(I, I_tmp, width, height);
+  if (!compare(I_tmp, I_ref, "black top-hat, " + name)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool testReconstruct(const vpImage<unsigned char> &marker, const vpImage<unsigned char> &mask,
+                     const std::string &name)
+{
+  vpImageMorphology::vpConnexityType connexities[2] = {vpImageMorphology::CONNEXITY_4,
+                                                       vpImageMorphology::CONNEXITY_8};
+  for (unsigned int k = 0; k < 2; k++) {
+    vpImage<unsigned char> I, I_ref;
+    double t_ref = vpTime::measureTimeMs();
+    reconstructReference(marker, mask, I_ref, connexities[k]);
+    t_ref = vpTime::measureTimeMs() - t_ref;
+
+    double t = vpTime::measureTimeMs();
+    vp::reconstruct(marker, mask, I, connexities[k]);
+    t = vpTime::measureTimeMs() - t;
+
+    std::string full_name = name + (k == 0 ? ", connexity 4" : ", connexity 8");
+    if (!compare(I, I_ref, "reconstruct, " + full_name)) {
+      return false;
+    }
+    if (marker.getSize() > 10000) {
+      std::cout << "reconstruct, " << full_name << ": " << t << " ms, iterated geodesic dilatation " << t_ref << " ms"
+                << std::endl;
+    }
+  }
+  return true;
+}
+
+bool benchmark(const vpImage<unsigned char> &I, unsigned int size, unsigned int nbIter)
+{
+  // A (2r+1)x(2r+1) square is the same as r 3x3 operations
+  unsigned int r = size / 2;
+  vpImage<unsigned char> I_rect, I_iter;
+
+  double t_rect = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbIter; n++) {
+    vp::dilatation(I, I_rect, size, size);
+  }
+  t_rect = (vpTime::measureTimeMs() - t_rect) / nbIter;
+
+  double t_iter = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbIter; n++) {
+    I_iter = I;
+    for (unsigned int k = 0; k < r; k++) {
+      vpImageMorphology::dilatation(I_iter, vpImageMorphology::CONNEXITY_8);
+    }
+  }
+  t_iter = (vpTime::measureTimeMs() - t_iter) / nbIter;
+
+  std::stringstream ss;
+  ss << size << "x" << size;
+  if (!compare(I_rect, I_iter, "dilatation " + ss.str())) {
+    return false;
+  }
+
+  double t_open = vpTime::measureTimeMs();
+  for (unsigned int n = 0; n < nbIter; n++) {
+    vp::whiteTopHat(I, I_rect, size, size);
+  }
+  t_open = (vpTime::measureTimeMs() - t_open) / nbIter;
+
+  std::cout << ss.str() << ": dilatation " << t_rect << " ms, " << r << " 3x3 dilatations " << t_iter
+            << " ms, white top-hat " << t_open << " ms" << std::endl;
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+    vpImage<unsigned char> I;
+
+    // Sizes smaller and larger than the image, odd and even, lines
+    unsigned int sizes[9][2] = {{1, 1}, {3, 3}, {2, 4}, {5, 1}, {1, 7}, {15, 15}, {6, 11}, {51, 51}, {64, 3}};
+    for (unsigned int s = 0; s < 9; s++) {
+      generateRandomImage(I, 37, 53, rand);
+      if (!testMorphology(I, sizes[s][0], sizes[s][1])) {
+        return EXIT_FAILURE;
+      }
+    }
+    for (unsigned int h = 1; h <= 4; h++) {
+      for (unsigned int w = 1; w <= 4; w++) {
+        generateRandomImage(I, h, w, rand);
+        if (!testMorphology(I, 3, 3) || !testMorphology(I, 8, 5)) {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Reconstruction of a smooth image from the image lowered by 40 (h-dome
+    // transform), of a random image, and from a marker partly above the mask
+    vpImage<unsigned char> mask, marker;
+    for (unsigned int h = 1; h <= 4; h++) {
+      for (unsigned int w = 1; w <= 4; w++) {
+        generateRandomImage(mask, h, w, rand);
+        generateRandomImage(marker, h, w, rand);
+        if (!testReconstruct(marker, mask, "tiny random images")) {
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    generateRandomImage(mask, 61, 47, rand);
+    generateRandomImage(marker, 61, 47, rand);
+    if (!testReconstruct(marker, mask, "random images")) {
+      return EXIT_FAILURE;
+    }
+
+    generateSmoothImage(mask, 480, 640);
+    vpImage<unsigned char> offset(480, 640, 40);
+    vpImageTools::imageSubtract(mask, offset, marker, true);
+    if (!testReconstruct(marker, mask, "h-dome")) {
+      return EXIT_FAILURE;
+    }
+
+    // Binary hole filling as with Matlab imfill(BW,'holes')
+    vpImage<unsigned char> binary(480, 640, 0);
+    for (unsigned int i = 0; i < 480; i++) {
+      for (unsigned int j = 0; j < 640; j++) {
+        binary[i][j] = mask[i][j] > 150 ? 255 : 0;
+      }
+    }
+    vpImage<unsigned char> marker_holes(480, 640, 0);
+    for (unsigned int i = 0; i < 480; i++) {
+      marker_holes[i][0] = 255 - binary[i][0];
+      marker_holes[i][639] = 255 - binary[i][639];
+    }
+    for (unsigned int j = 0; j < 640; j++) {
+      marker_holes[0][j] = 255 - binary[0][j];
+      marker_holes[479][j] = 255 - binary[479][j];
+    }
+    vpImage<unsigned char> binary_complement(480, 640, 255);
+    vpImageTools::imageSubtract(binary_complement, binary, binary_complement);
+    if (!testReconstruct(marker_holes, binary_complement, "hole filling")) {
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark
+    generateRandomImage(I, 480, 640, rand);
+    unsigned int bench_sizes[3] = {3, 15, 51};
+    for (unsigned int s = 0; s < 3; s++) {
+      if (!benchmark(I, bench_sizes[s], 10)) {
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testPerformanceMorphology is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
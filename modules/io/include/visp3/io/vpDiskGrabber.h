@@ -62,6 +62,11 @@
 
   \sa vpFrameGrabber
 
+  When replaying a sequence, the time spent to read and decode the images
+  can be hidden by a read-ahead mode enabled with setPrefetch(). Background
+  threads then load the next images of the sequence into a bounded queue
+  while the current one is processed.
+
   Here an example of capture from the directory
   "/local/soft/ViSP/ViSP-images/cube". We want to acquire 10 images
   from the first named "image.0001.pgm" by steps of 2.
@@ -111,6 +116,9 @@ private:
   long m_image_number;           //!< id of the current image to be read
   long m_image_number_next;      //!< id of the next image to be read
   long m_image_step;             //!< increment between two image id
+  long m_image_number_first;     //!< lowest id of the images read ahead
+  long m_image_number_last;      //!< highest id of the images read ahead
+                                 //!< (no bound if < m_image_number_first)
   unsigned int m_number_of_zero; //!< number of zero in the image name
                                  //!< (image.00000.pgm)
 
@@ -121,6 +129,11 @@ private:
   bool m_use_generic_name;
   std::string m_generic_name;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class vpPrefetcher;
+#endif
+  vpPrefetcher *m_prefetcher; //!< read-ahead queue, NULL if disabled
+
 public:
   vpDiskGrabber();
   explicit vpDiskGrabber(const std::string &genericName);
@@ -141,6 +154,7 @@ public:
     Return the current image number.
   */
   long getImageNumber() { return m_image_number; };
+  unsigned int getPrefetchDepth() const;
 
   void open(vpImage<unsigned char> &I);
   void open(vpImage<vpRGBa> &I);
@@ -151,8 +165,17 @@ public:
   void setExtension(const std::string &ext);
   void setGenericName(const std::string &genericName);
   void setImageNumber(long number);
+  void setImageNumberRange(long first, long last);
   void setNumberOfZero(unsigned int noz);
+  void setPrefetch(unsigned int depth, unsigned int nbThreads = 1);
   void setStep(long step);
+
+private:
+  vpDiskGrabber(const vpDiskGrabber &);
+  vpDiskGrabber &operator=(const vpDiskGrabber &);
+
+  std::string getImageName(long number) const;
+  template <class Type> void readImage(vpImage<Type> &I, long number);
 };
 
 #endif
@@ -223,6 +223,10 @@ private:
   //! The frame step
   long frameStep;
   double frameRate;
+  //! Number of images read ahead by the image sequence grabber
+  unsigned int m_prefetchDepth;
+  //! Number of threads that read ahead the images
+  unsigned int m_prefetchThreads;
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -364,6 +368,7 @@ public:
     this->lastFrameIndexIsSet = true;
     this->lastFrame = last_frame;
   }
+  void setPrefetch(unsigned int depth, unsigned int nbThreads = 1);
 
   /*!
     Sets the frame step index.
@@ -46,6 +46,15 @@
 #include <visp3/core/vpIoTools.h>
 #include <visp3/io/vpImageIo.h>
 
+#include <string.h> // memcpy
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 void vp_decodeHeaderPNM(const std::string &filename, std::ifstream &fd, const std::string &magic, unsigned int &w,
                         unsigned int &h, unsigned int &maxval);
 
@@ -114,6 +123,81 @@ void vp_decodeHeaderPNM(const std::string &filename, std::ifstream &fd, const st
     }
   }
 }
+
+/*!
+ * Read-only memory mapping of the pixel data of a PNM file, used to copy the
+ * data straight into the image bitmap instead of going through the
+ * std::ifstream buffer.
+ *
+ * data() returns NULL when the file cannot be mapped (no mmap support, file
+ * shorter than expected...). The caller then reads the data from the stream,
+ * which also produces the usual error messages.
+ */
+namespace
+{
+class vpPNMMapping
+{
+public:
+  /*!
+   * \param filename[in] : File name.
+   * \param offset[in] : Offset of the first pixel, i.e. size of the header.
+   * \param nbyte[in] : Size in bytes of the pixel data.
+   */
+  vpPNMMapping(const std::string &filename, std::streamoff offset, size_t nbyte)
+    : m_addr(NULL), m_length(0), m_data(NULL)
+  {
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    if (offset < 0 || nbyte == 0) {
+      return;
+    }
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= (size_t)offset + nbyte) {
+      int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+      // The whole file is read at once, avoid a page fault per page
+      flags |= MAP_POPULATE;
+#endif
+      m_length = (size_t)offset + nbyte;
+      void *addr = mmap(NULL, m_length, PROT_READ, flags, fd, 0);
+      if (addr != MAP_FAILED) {
+        m_addr = addr;
+        m_data = static_cast<const unsigned char *>(addr) + offset;
+      }
+    }
+    close(fd);
+#else
+    (void)filename;
+    (void)offset;
+    (void)nbyte;
+#endif
+  }
+
+  ~vpPNMMapping()
+  {
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    if (m_addr != NULL) {
+      munmap(m_addr, m_length);
+    }
+#endif
+  }
+
+  const unsigned char *data() const { return m_data; }
+
+private:
+  vpPNMMapping(const vpPNMMapping &);
+  vpPNMMapping &operator=(const vpPNMMapping &);
+
+  void *m_addr;
+  size_t m_length;
+  const unsigned char *m_data;
+};
+}
 #endif
 
 vpImageIo::vpImageFormatType vpImageIo::getFormat(const std::string &filename)
@@ -657,6 +741,9 @@ void vpImageIo::writePGM(const vpImage<vpRGBa> &I, const std::string &filename)
   only if the new image size is different, else we re-use the same
   memory space.
 
+  On UNIX systems the pixel data is memory mapped and copied straight into
+  the image bitmap.
+
   \param I : Image to set with the \e filename content.
   \param filename : Name of the file containing the image.
 
@@ -691,6 +778,13 @@ void vpImageIo::readPFM(vpImage<float> &I, const std::string &filename)
   }
 
   unsigned int nbyte = I.getHeight() * I.getWidth();
+  vpPNMMapping mapping(filename, fd.tellg(), sizeof(float) * nbyte);
+  if (mapping.data() != NULL) {
+    memcpy(I.bitmap, mapping.data(), sizeof(float) * nbyte);
+    fd.close();
+    return;
+  }
+
   fd.read((char *)I.bitmap, sizeof(float) * nbyte);
   if (!fd) {
     fd.close();
@@ -712,6 +806,9 @@ void vpImageIo::readPFM(vpImage<float> &I, const std::string &filename)
   only if the new image size is different, else we re-use the same
   memory space.
 
+  On UNIX systems the pixel data is memory mapped and copied straight into
+  the image bitmap.
+
   \param I : Image to set with the \e filename content.
   \param filename : Name of the file containing the image.
 */
@@ -745,6 +842,13 @@ void vpImageIo::readPGM(vpImage<unsigned char> &I, const std::string &filename)
   }
 
   unsigned int nbyte = I.getHeight() * I.getWidth();
+  vpPNMMapping mapping(filename, fd.tellg(), nbyte);
+  if (mapping.data() != NULL) {
+    memcpy(I.bitmap, mapping.data(), nbyte);
+    fd.close();
+    return;
+  }
+
   fd.read((char *)I.bitmap, nbyte);
   if (!fd) {
     fd.close();
@@ -819,6 +923,9 @@ void vpImageIo::readPPM(vpImage<unsigned char> &I, const std::string &filename)
   only if the new image size is different, else we re-use the same
   memory space.
 
+  On UNIX systems the pixel data is memory mapped and copied straight into
+  the image bitmap.
+
   \param I : Image to set with the \e filename content.
   \param filename : Name of the file containing the image.
 */
@@ -850,6 +957,13 @@ void vpImageIo::readPPM(vpImage<vpRGBa> &I, const std::string &filename)
     I.resize(h, w);
   }
 
+  vpPNMMapping mapping(filename, fd.tellg(), 3 * (size_t)I.getSize());
+  if (mapping.data() != NULL) {
+    vpImageConvert::RGBToRGBa(const_cast<unsigned char *>(mapping.data()), (unsigned char *)I.bitmap, I.getSize());
+    fd.close();
+    return;
+  }
+
   for (unsigned int i = 0; i < I.getHeight(); i++) {
     for (unsigned int j = 0; j < I.getWidth(); j++) {
       unsigned char rgb[3];
@@ -36,14 +36,322 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+#include <list>
+
 #include <visp3/io/vpDiskGrabber.h>
 
+#if defined(VISP_HAVE_PTHREAD)
+#include <pthread.h>
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+void vp_readImage(vpImage<unsigned char> &I, const std::string &filename) { vpImageIo::read(I, filename); }
+void vp_readImage(vpImage<vpRGBa> &I, const std::string &filename) { vpImageIo::read(I, filename); }
+void vp_readImage(vpImage<float> &I, const std::string &filename) { vpImageIo::readPFM(I, filename); }
+}
+
+/*
+  Bounded queue of images read ahead by background threads.
+
+  The queue is filled by schedule() with the names of the next images of the
+  sequence and emptied by get(). The decoder threads load the pending images
+  in the order they were scheduled. The image buffers of the consumed frames
+  are recycled, so that once the queue is full no memory is allocated.
+*/
+class vpDiskGrabber::vpPrefetcher
+{
+public:
+  vpPrefetcher(unsigned int depth, unsigned int nbThreads);
+  ~vpPrefetcher();
+
+  unsigned int getDepth() const { return m_depth; }
+  template <class Type> bool get(const std::string &filename, vpImage<Type> &I);
+  template <class Type> void schedule(const std::vector<std::string> &filenames, const vpImage<Type> &I);
+
+private:
+  enum vpFrameState { PENDING, LOADING, READY, FAILED };
+  enum vpFrameType { TYPE_UCHAR, TYPE_RGBA, TYPE_FLOAT };
+
+  struct vpFrame {
+    std::string m_filename;
+    vpFrameType m_type;
+    vpFrameState m_state;
+    vpImage<unsigned char> m_Iuchar;
+    vpImage<vpRGBa> m_Irgba;
+    vpImage<float> m_Ifloat;
+  };
+
+  static vpFrameType getType(const vpImage<unsigned char> &) { return TYPE_UCHAR; }
+  static vpFrameType getType(const vpImage<vpRGBa> &) { return TYPE_RGBA; }
+  static vpFrameType getType(const vpImage<float> &) { return TYPE_FLOAT; }
+  static vpImage<unsigned char> &getImage(vpFrame &frame, const vpImage<unsigned char> &) { return frame.m_Iuchar; }
+  static vpImage<vpRGBa> &getImage(vpFrame &frame, const vpImage<vpRGBa> &) { return frame.m_Irgba; }
+  static vpImage<float> &getImage(vpFrame &frame, const vpImage<float> &) { return frame.m_Ifloat; }
+
+  std::list<vpFrame>::iterator find(const std::string &filename, vpFrameType type);
+  void workerLoop();
+
+  // Synchronization primitives
+  void lock();
+  void unlock();
+  void wait();
+  void notifyAll();
+
+#if defined(VISP_HAVE_PTHREAD)
+  static void *workerEntry(void *arg)
+  {
+#if defined(SCHED_BATCH)
+    // Reading ahead is background work: the decoder threads must not
+    // preempt the thread that processes the images when they wake up
+    struct sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_BATCH, &param);
+#endif
+    static_cast<vpPrefetcher *>(arg)->workerLoop();
+    return NULL;
+  }
+
+  pthread_mutex_t m_mutex;
+  pthread_cond_t m_cond;
+  std::vector<pthread_t> m_threads;
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  static void workerEntry(vpPrefetcher *prefetcher) { prefetcher->workerLoop(); }
+
+  std::mutex m_mutex;
+  std::condition_variable_any m_cond;
+  std::vector<std::thread> m_threads;
+#endif
+  //! Scheduled frames, in the reading order
+  std::list<vpFrame> m_frames;
+  //! Consumed frames whose buffers are reused
+  std::list<vpFrame> m_freeFrames;
+  unsigned int m_depth;
+  bool m_stop;
+};
+
+vpDiskGrabber::vpPrefetcher::vpPrefetcher(unsigned int depth, unsigned int nbThreads)
+  :
+#if defined(VISP_HAVE_PTHREAD) || defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    m_mutex(), m_cond(), m_threads(),
+#endif
+    m_frames(), m_freeFrames(), m_depth(depth), m_stop(false)
+{
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_mutex_init(&m_mutex, NULL);
+  pthread_cond_init(&m_cond, NULL);
+  m_threads.resize(nbThreads);
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    if (pthread_create(&m_threads[i], NULL, workerEntry, this) != 0) {
+      // Keep the threads already created
+      m_threads.resize(i);
+      break;
+    }
+  }
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    m_threads.push_back(std::thread(workerEntry, this));
+  }
+#else
+  (void)nbThreads;
+#endif
+}
+
+vpDiskGrabber::vpPrefetcher::~vpPrefetcher()
+{
+  lock();
+  m_stop = true;
+  notifyAll();
+  unlock();
+
+#if defined(VISP_HAVE_PTHREAD)
+  for (size_t i = 0; i < m_threads.size(); i++) {
+    pthread_join(m_threads[i], NULL);
+  }
+  pthread_cond_destroy(&m_cond);
+  pthread_mutex_destroy(&m_mutex);
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  for (size_t i = 0; i < m_threads.size(); i++) {
+    m_threads[i].join();
+  }
+#endif
+}
+
+void vpDiskGrabber::vpPrefetcher::lock()
+{
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_mutex_lock(&m_mutex);
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  m_mutex.lock();
+#endif
+}
+
+void vpDiskGrabber::vpPrefetcher::unlock()
+{
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_mutex_unlock(&m_mutex);
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  m_mutex.unlock();
+#endif
+}
+
+void vpDiskGrabber::vpPrefetcher::wait()
+{
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_cond_wait(&m_cond, &m_mutex);
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  m_cond.wait(m_mutex);
+#endif
+}
+
+void vpDiskGrabber::vpPrefetcher::notifyAll()
+{
+#if defined(VISP_HAVE_PTHREAD)
+  pthread_cond_broadcast(&m_cond);
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  m_cond.notify_all();
+#endif
+}
+
+/*
+  Must be called with the lock held.
+*/
+std::list<vpDiskGrabber::vpPrefetcher::vpFrame>::iterator
+vpDiskGrabber::vpPrefetcher::find(const std::string &filename, vpFrameType type)
+{
+  for (std::list<vpFrame>::iterator it = m_frames.begin(); it != m_frames.end(); ++it) {
+    if (it->m_type == type && it->m_filename == filename) {
+      return it;
+    }
+  }
+  return m_frames.end();
+}
+
+/*
+  Move the image \e filename into \e I if it was read ahead. If the image is
+  being loaded, wait for it. Return false if the image was not scheduled,
+  not loaded yet, or could not be read: the caller then reads it itself,
+  which raises the appropriate exception in the latter case.
+*/
+template <class Type> bool vpDiskGrabber::vpPrefetcher::get(const std::string &filename, vpImage<Type> &I)
+{
+  lock();
+  std::list<vpFrame>::iterator it = find(filename, getType(I));
+  if (it == m_frames.end()) {
+    unlock();
+    return false;
+  }
+  // Only the consumer thread removes frames, the iterator remains valid
+  while (it->m_state == LOADING) {
+    wait();
+  }
+
+  bool ready = (it->m_state == READY);
+  if (ready) {
+    vpImage<Type> &Iframe = getImage(*it, I);
+    swap(I, Iframe);
+    // The display stays attached to the user image
+    std::swap(I.display, Iframe.display);
+  }
+  m_freeFrames.splice(m_freeFrames.end(), m_frames, it);
+  unlock();
+
+  return ready;
+}
+
+/*
+  Replace the content of the queue by the images \e filenames. The images
+  already scheduled are kept, the others are dropped except those being
+  loaded, that are dropped by the next call.
+*/
+template <class Type>
+void vpDiskGrabber::vpPrefetcher::schedule(const std::vector<std::string> &filenames, const vpImage<Type> &I)
+{
+  const vpFrameType type = getType(I);
+
+  lock();
+  std::list<vpFrame>::iterator it = m_frames.begin();
+  while (it != m_frames.end()) {
+    std::list<vpFrame>::iterator current = it++;
+    if (current->m_state != LOADING &&
+        (current->m_type != type ||
+         std::find(filenames.begin(), filenames.end(), current->m_filename) == filenames.end())) {
+      m_freeFrames.splice(m_freeFrames.end(), m_frames, current);
+    }
+  }
+
+  for (size_t i = 0; i < filenames.size(); i++) {
+    if (find(filenames[i], type) == m_frames.end()) {
+      if (m_freeFrames.empty()) {
+        m_freeFrames.push_back(vpFrame());
+      }
+      vpFrame &frame = m_freeFrames.front();
+      frame.m_filename = filenames[i];
+      frame.m_type = type;
+      frame.m_state = PENDING;
+      m_frames.splice(m_frames.end(), m_freeFrames, m_freeFrames.begin());
+    }
+  }
+  notifyAll();
+  unlock();
+}
+
+void vpDiskGrabber::vpPrefetcher::workerLoop()
+{
+  lock();
+  while (!m_stop) {
+    std::list<vpFrame>::iterator it = m_frames.begin();
+    while (it != m_frames.end() && it->m_state != PENDING) {
+      ++it;
+    }
+    if (it == m_frames.end()) {
+      wait();
+      continue;
+    }
+
+    // The frame cannot be removed from the list while it is being loaded
+    it->m_state = LOADING;
+    unlock();
+
+    bool success = true;
+    try {
+      switch (it->m_type) {
+      case TYPE_UCHAR:
+        vp_readImage(it->m_Iuchar, it->m_filename);
+        break;
+      case TYPE_RGBA:
+        vp_readImage(it->m_Irgba, it->m_filename);
+        break;
+      case TYPE_FLOAT:
+        vp_readImage(it->m_Ifloat, it->m_filename);
+        break;
+      }
+    } catch (...) {
+      success = false;
+    }
+
+    lock();
+    it->m_state = success ? READY : FAILED;
+    notifyAll();
+  }
+  unlock();
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Elementary constructor.
 */
 vpDiskGrabber::vpDiskGrabber()
-  : m_image_number(0), m_image_number_next(0), m_image_step(1), m_number_of_zero(0), m_directory("/tmp"),
-    m_base_name("I"), m_extension("pgm"), m_use_generic_name(false), m_generic_name("empty")
+  : m_image_number(0), m_image_number_next(0), m_image_step(1), m_image_number_first(0),
+    m_image_number_last(-1), m_number_of_zero(0), m_directory("/tmp"),
+    m_base_name("I"), m_extension("pgm"), m_use_generic_name(false), m_generic_name("empty"),
+    m_prefetcher(NULL)
 {
   init = false;
 }
@@ -52,8 +360,10 @@ vpDiskGrabber::vpDiskGrabber()
   Constructor that takes a generic image sequence as input.
 */
 vpDiskGrabber::vpDiskGrabber(const std::string &generic_name)
-  : m_image_number(0), m_image_number_next(0), m_image_step(1), m_number_of_zero(0), m_directory("/tmp"),
-    m_base_name("I"), m_extension("pgm"), m_use_generic_name(true), m_generic_name(generic_name)
+  : m_image_number(0), m_image_number_next(0), m_image_step(1), m_image_number_first(0),
+    m_image_number_last(-1), m_number_of_zero(0), m_directory("/tmp"),
+    m_base_name("I"), m_extension("pgm"), m_use_generic_name(true), m_generic_name(generic_name),
+    m_prefetcher(NULL)
 {
   init = false;
 }
@@ -71,12 +381,63 @@ vpDiskGrabber::vpDiskGrabber(const std::string &generic_name)
 
 vpDiskGrabber::vpDiskGrabber(const std::string &dir, const std::string &basename, long number, int step,
                              unsigned int noz, const std::string &ext)
-  : m_image_number(number), m_image_number_next(number), m_image_step(step), m_number_of_zero(noz), m_directory(dir),
-    m_base_name(basename), m_extension(ext), m_use_generic_name(false), m_generic_name("empty")
+  : m_image_number(number), m_image_number_next(number), m_image_step(step),
+    m_image_number_first(0), m_image_number_last(-1), m_number_of_zero(noz), m_directory(dir),
+    m_base_name(basename), m_extension(ext), m_use_generic_name(false), m_generic_name("empty"),
+    m_prefetcher(NULL)
 {
   init = false;
 }
 
+/*!
+  Return the name of the image file with number \e number.
+*/
+std::string vpDiskGrabber::getImageName(long number) const
+{
+  if (m_use_generic_name) {
+    char filename[FILENAME_MAX];
+    sprintf(filename, m_generic_name.c_str(), number);
+    return filename;
+  }
+
+  std::stringstream ss;
+  ss << m_directory << "/" << m_base_name << std::setfill('0') << std::setw(m_number_of_zero) << number << "."
+     << m_extension;
+  return ss.str();
+}
+
+/*!
+  Read the image with number \e number, from the read-ahead queue if
+  enabled, and schedule the reading of the next images.
+*/
+template <class Type> void vpDiskGrabber::readImage(vpImage<Type> &I, long number)
+{
+  std::string filename = getImageName(number);
+
+  if (m_prefetcher != NULL) {
+    // The current image is kept in the queue, it may already be loaded. The
+    // images outside the range of the sequence are not read ahead.
+    const bool bounded = m_image_number_last >= m_image_number_first;
+    std::vector<std::string> filenames;
+    filenames.reserve(m_prefetcher->getDepth() + 1);
+    filenames.push_back(filename);
+    for (unsigned int i = 1; i <= m_prefetcher->getDepth(); i++) {
+      const long next = number + (long)i * m_image_step;
+      if (bounded && (next < m_image_number_first || next > m_image_number_last)) {
+        break;
+      }
+      filenames.push_back(getImageName(next));
+    }
+    m_prefetcher->schedule(filenames, I);
+
+    if (m_prefetcher->get(filename, I)) {
+      return;
+    }
+  }
+
+  vp_readImage(I, filename);
+}
+
 /*!
   Read the first image of the sequence.
   The image number is not incremented.
@@ -144,19 +505,9 @@ void vpDiskGrabber::open(vpImage<float> &I)
 void vpDiskGrabber::acquire(vpImage<unsigned char> &I)
 {
   m_image_number = m_image_number_next;
-  std::stringstream ss;
-
-  if (m_use_generic_name) {
-    char filename[FILENAME_MAX];
-    sprintf(filename, m_generic_name.c_str(), m_image_number);
-    ss << filename;
-  } else {
-    ss << m_directory << "/" << m_base_name << std::setfill('0') << std::setw(m_number_of_zero) << m_image_number << "."
-       << m_extension;
-  }
-
   m_image_number_next += m_image_step;
-  vpImageIo::read(I, ss.str());
+
+  readImage(I, m_image_number);
 
   width = I.getWidth();
   height = I.getHeight();
@@ -171,20 +522,9 @@ void vpDiskGrabber::acquire(vpImage<unsigned char> &I)
 void vpDiskGrabber::acquire(vpImage<vpRGBa> &I)
 {
   m_image_number = m_image_number_next;
-  std::stringstream ss;
-
-  if (m_use_generic_name) {
-    char filename[FILENAME_MAX];
-    sprintf(filename, m_generic_name.c_str(), m_image_number);
-    ss << filename;
-  } else {
-    ss << m_directory << "/" << m_base_name << std::setfill('0') << std::setw(m_number_of_zero) << m_image_number << "."
-       << m_extension;
-  }
-
   m_image_number_next += m_image_step;
 
-  vpImageIo::read(I, ss.str());
+  readImage(I, m_image_number);
 
   width = I.getWidth();
   height = I.getHeight();
@@ -199,19 +539,9 @@ void vpDiskGrabber::acquire(vpImage<vpRGBa> &I)
 void vpDiskGrabber::acquire(vpImage<float> &I)
 {
   m_image_number = m_image_number_next;
-  std::stringstream ss;
-  if (m_use_generic_name) {
-    char filename[FILENAME_MAX];
-    sprintf(filename, m_generic_name.c_str(), m_image_number);
-    ss << filename;
-  } else {
-    ss << m_directory << "/" << m_base_name << std::setfill('0') << std::setw(m_number_of_zero) << m_image_number << "."
-       << m_extension;
-  }
-
   m_image_number_next += m_image_step;
 
-  vpImageIo::readPFM(I, ss.str());
+  readImage(I, m_image_number);
 
   width = I.getWidth();
   height = I.getHeight();
@@ -239,7 +569,9 @@ void vpDiskGrabber::acquire(vpImage<unsigned char> &I, long img_number)
 
   m_image_number_next += m_image_step;
 
-  vpImageIo::read(I, ss.str());
+  if (m_prefetcher == NULL || !m_prefetcher->get(ss.str(), I)) {
+    vp_readImage(I, ss.str());
+  }
 
   width = I.getWidth();
   height = I.getHeight();
@@ -267,7 +599,9 @@ void vpDiskGrabber::acquire(vpImage<vpRGBa> &I, long img_number)
 
   m_image_number_next += m_image_step;
 
-  vpImageIo::read(I, ss.str());
+  if (m_prefetcher == NULL || !m_prefetcher->get(ss.str(), I)) {
+    vp_readImage(I, ss.str());
+  }
 
   width = I.getWidth();
   height = I.getHeight();
@@ -295,7 +629,9 @@ void vpDiskGrabber::acquire(vpImage<float> &I, long img_number)
 
   m_image_number_next += m_image_step;
 
-  vpImageIo::readPFM(I, ss.str());
+  if (m_prefetcher == NULL || !m_prefetcher->get(ss.str(), I)) {
+    vp_readImage(I, ss.str());
+  }
 
   width = I.getWidth();
   height = I.getHeight();
@@ -316,7 +652,12 @@ void vpDiskGrabber::close()
 
   In fact nothing to destroy...
  */
-vpDiskGrabber::~vpDiskGrabber() {}
+vpDiskGrabber::~vpDiskGrabber()
+{
+  if (m_prefetcher != NULL) {
+    delete m_prefetcher;
+  }
+}
 
 /*!
   Set the main directory name (ie location of the image sequence)
@@ -342,6 +683,64 @@ void vpDiskGrabber::setImageNumber(long number)
   m_image_number_next = number;
 }
 
+/*!
+  Set the range of the image numbers of the sequence. The read-ahead mode
+  does not schedule the images whose number is outside [\e first, \e last].
+  If \e last is lower than \e first, the range is not bounded.
+
+  \param first : Number of the first image of the sequence.
+  \param last : Number of the last image of the sequence.
+
+  \sa setPrefetch()
+*/
+void vpDiskGrabber::setImageNumberRange(long first, long last)
+{
+  m_image_number_first = first;
+  m_image_number_last = last;
+}
+
+/*!
+  Enable the read-ahead mode. After each acquire(), \e nbThreads background
+  threads load the next \e depth images of the sequence, considering the
+  step, while the current image is processed. The next acquire() then only
+  swaps the image buffers. An image that is not loaded yet when it is
+  requested is read by the calling thread as without read-ahead.
+
+  The read-ahead mode is worth when the processing of an image takes at
+  least as long as its reading, or with several threads when decoding is
+  the bottleneck (compressed formats).
+
+  \param depth : Number of images read ahead. 0 disables the read-ahead mode.
+  \param nbThreads : Number of threads that read and decode the images.
+
+  \note Without thread support (pthread or C++11) this function has no
+  effect.
+*/
+void vpDiskGrabber::setPrefetch(unsigned int depth, unsigned int nbThreads)
+{
+  if (m_prefetcher != NULL) {
+    delete m_prefetcher;
+    m_prefetcher = NULL;
+  }
+
+#if defined(VISP_HAVE_PTHREAD) || defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  if (depth > 0 && nbThreads > 0) {
+    m_prefetcher = new vpPrefetcher(depth, nbThreads);
+  }
+#endif
+}
+
+/*!
+  Return the number of images read ahead, 0 if the read-ahead mode is
+  disabled.
+
+  \sa setPrefetch()
+*/
+unsigned int vpDiskGrabber::getPrefetchDepth() const
+{
+  return m_prefetcher != NULL ? m_prefetcher->getDepth() : 0;
+}
+
 /*!
   Set the step between two images.
 */
@@ -60,7 +60,8 @@ vpVideoReader::vpVideoReader()
     capture(), frame(),
 #endif
     formatType(FORMAT_UNKNOWN), initFileName(false), isOpen(false), frameCount(0), firstFrame(0), lastFrame(0),
-    firstFrameIndexIsSet(false), lastFrameIndexIsSet(false), frameStep(1), frameRate(0.)
+    firstFrameIndexIsSet(false), lastFrameIndexIsSet(false), frameStep(1), frameRate(0.), m_prefetchDepth(0),
+    m_prefetchThreads(1)
 {
 }
 
@@ -136,6 +137,25 @@ sequence.
 */
 void vpVideoReader::setFileName(const std::string &filename) { setFileName(filename.c_str()); }
 
+/*!
+  Enable the read-ahead mode when reading a sequence of images: background
+  threads load and decode the next images of the sequence while the current
+  one is processed. This option has no effect on video files.
+
+  \param depth : Number of images read ahead. 0 disables the read-ahead mode.
+  \param nbThreads : Number of threads that read and decode the images.
+
+  \sa vpDiskGrabber::setPrefetch()
+*/
+void vpVideoReader::setPrefetch(unsigned int depth, unsigned int nbThreads)
+{
+  m_prefetchDepth = depth;
+  m_prefetchThreads = nbThreads;
+  if (imSequence != NULL) {
+    imSequence->setPrefetch(depth, nbThreads);
+  }
+}
+
 /*!
   Open video stream and get first and last frame indexes.
 */
@@ -149,6 +169,7 @@ void vpVideoReader::getProperties()
     imSequence = new vpDiskGrabber;
     imSequence->setGenericName(fileName);
     imSequence->setStep(frameStep);
+    imSequence->setPrefetch(m_prefetchDepth, m_prefetchThreads);
     if (firstFrameIndexIsSet) {
       imSequence->setImageNumber(firstFrame);
     }
@@ -272,6 +293,7 @@ void vpVideoReader::acquire(vpImage<vpRGBa> &I)
   // getFrame(I,frameCount);
   if (imSequence != NULL) {
     imSequence->setStep(frameStep);
+    imSequence->setImageNumberRange(firstFrame, lastFrame);
     imSequence->acquire(I);
     frameCount = imSequence->getImageNumber();
     if (frameCount + frameStep > lastFrame) {
@@ -343,6 +365,7 @@ void vpVideoReader::acquire(vpImage<unsigned char> &I)
 
   if (imSequence != NULL) {
     imSequence->setStep(frameStep);
+    imSequence->setImageNumberRange(firstFrame, lastFrame);
     imSequence->acquire(I);
     frameCount = imSequence->getImageNumber();
     if (frameCount + frameStep > lastFrame) {
@@ -415,6 +438,7 @@ bool vpVideoReader::getFrame(vpImage<vpRGBa> &I, long frame_index)
 {
   if (imSequence != NULL) {
     try {
+      imSequence->setImageNumberRange(firstFrame, lastFrame);
       imSequence->acquire(I, frame_index);
       width = I.getWidth();
       height = I.getHeight();
@@ -485,6 +509,7 @@ bool vpVideoReader::getFrame(vpImage<unsigned char> &I, long frame_index)
 {
   if (imSequence != NULL) {
     try {
+      imSequence->setImageNumberRange(firstFrame, lastFrame);
       imSequence->acquire(I, frame_index);
       width = I.getWidth();
       height = I.getHeight();
@@ -664,28 +689,10 @@ void vpVideoReader::findLastFrameIndex()
     throw(vpException(vpException::notInitialized, "file not yet opened"));
   }
 
-  if (imSequence != NULL) {
-    if (!lastFrameIndexIsSet) {
-      std::string imageNameFormat = vpIoTools::getName(std::string(fileName));
-      std::string dirName = vpIoTools::getParent(std::string(fileName));
-      if (dirName == "") {
-        dirName = ".";
-      }
-      std::vector<std::string> files = vpIoTools::getDirFiles(dirName);
-      lastFrame = 0;
-      for (size_t i = 0; i < files.size(); i++) {
-        // Checking that file name satisfies image format,
-        // specified by imageNameFormat, and extracting imageIndex
-        long imageIndex = extractImageIndex(files[i], imageNameFormat);
-        if ((imageIndex != -1) && (imageIndex > lastFrame)) {
-          lastFrame = imageIndex;
-        }
-      }
-    }
-  }
-
+  // The last frame index of an image sequence is found by
+  // findFirstFrameIndex() that lists the directory only once
 #if VISP_HAVE_OPENCV_VERSION >= 0x030000
-  else if (!lastFrameIndexIsSet) {
+  if (imSequence == NULL && !lastFrameIndexIsSet) {
     lastFrame = (long)capture.get(cv::CAP_PROP_FRAME_COUNT);
     if (lastFrame <= 2) // with tutorial/matching/video-postcard.mpeg it
                         // return 2 with OpenCV 3.0.0
@@ -696,7 +703,7 @@ void vpVideoReader::findLastFrameIndex()
     }
   }
 #elif VISP_HAVE_OPENCV_VERSION >= 0x020100
-  else if (!lastFrameIndexIsSet) {
+  if (imSequence == NULL && !lastFrameIndexIsSet) {
     lastFrame = (long)capture.get(CV_CAP_PROP_FRAME_COUNT);
     if (lastFrame <= 2) // with tutorial/matching/video-postcard.mpeg it
                         // return 2 with OpenCV 2.4.10
@@ -710,28 +717,39 @@ void vpVideoReader::findLastFrameIndex()
 }
 
 /*!
-Get the first frame index (update the firstFrame attribute).
+Get the first frame index (update the firstFrame attribute). For a sequence
+of images, the lastFrame attribute is also updated if not set by the user.
 */
 void vpVideoReader::findFirstFrameIndex()
 {
   if (imSequence != NULL) {
-    if (!firstFrameIndexIsSet) {
+    if (!firstFrameIndexIsSet || !lastFrameIndexIsSet) {
       std::string imageNameFormat = vpIoTools::getName(std::string(fileName));
       std::string dirName = vpIoTools::getParent(std::string(fileName));
       if (dirName == "") {
         dirName = ".";
       }
+      // List the directory once to get both the first and the last indexes
       std::vector<std::string> files = vpIoTools::getDirFiles(dirName);
-      firstFrame = -1;
+      long first = -1, last = 0;
       for (size_t i = 0; i < files.size(); i++) {
         // Checking that file name satisfies image format, specified by
         // imageNameFormat, and extracting imageIndex
         long imageIndex = extractImageIndex(files[i], imageNameFormat);
-        if ((imageIndex != -1) && (imageIndex < firstFrame || firstFrame == -1)) {
-          firstFrame = imageIndex;
+        if ((imageIndex != -1) && (imageIndex < first || first == -1)) {
+          first = imageIndex;
+        }
+        if ((imageIndex != -1) && (imageIndex > last)) {
+          last = imageIndex;
         }
       }
-      imSequence->setImageNumber(firstFrame);
+      if (!firstFrameIndexIsSet) {
+        firstFrame = first;
+        imSequence->setImageNumber(firstFrame);
+      }
+      if (!lastFrameIndexIsSet) {
+        lastFrame = last;
+      }
     }
   }
 #if VISP_HAVE_OPENCV_VERSION >= 0x020100
@@ -81,6 +81,28 @@
   virtual. In this case it means that they are specific to the each
   robot, for example the computation of the geometrical model.
 
+  By default the robot displacement is computed in a background thread
+  from the velocity applied to the robot and the wall-clock time. In the
+  stepped mode enabled by setSteppedMode(), there is no background thread:
+  the simulation only moves forward when step() is called, by a sampling
+  time given by setSamplingTime(). The trajectories then only depend on the
+  sequence of commands, and a simulation runs as fast as the calling thread
+  allows. Combined with a simulator built without the external view, it
+  allows to run many visual servoing scenarios in parallel processes.
+
+  \code
+  vpSimulatorViper850 robot(false); // no external view
+  robot.setSteppedMode(true);
+  robot.setSamplingTime(0.040);
+  robot.setRobotState(vpRobot::STATE_VELOCITY_CONTROL);
+  for (unsigned int iter = 0; iter < 500; iter++) {
+    vpHomogeneousMatrix cMo = robot.get_cMo();
+    // compute the velocity v from cMo
+    robot.setVelocity(vpRobot::CAMERA_FRAME, v);
+    robot.step(); // the robot moves during 40 ms with the velocity v
+  }
+  \endcode
+
   \warning This class uses threading capabilities. Thus on Unix-like
   platforms, the libpthread third-party library need to be
   installed. On Windows, we use the native threading capabilities.
@@ -176,6 +198,12 @@ protected:
 
   bool verbose_;
 
+  //! True if the robot only moves when step() is called, without background
+  //! thread
+  bool steppedMode;
+  //! Simulated time in second, incremented by step()
+  double simulationTime;
+
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
   //    vpRobotWireFrameSimulator(const vpRobotWireFrameSimulator &)
@@ -246,6 +274,20 @@ public:
   void getInternalView(vpImage<vpRGBa> &I);
   void getInternalView(vpImage<unsigned char> &I);
 
+  /*!
+    Return the time in second simulated by the successive calls to step()
+    since the stepped mode was enabled.
+
+    \sa setSteppedMode(), step()
+  */
+  double getSimulationTime() const { return simulationTime; }
+  /*!
+    Return true if the robot only moves when step() is called.
+
+    \sa setSteppedMode()
+  */
+  bool getSteppedMode() const { return steppedMode; }
+
   vpHomogeneousMatrix get_cMo();
   /*!
     Get the pose between the object and the fixed world frame.
@@ -337,12 +379,14 @@ public:
     displacement from the velocity applied to the robot during this time.
 
     Since the wireframe simulator is threaded, the sampling time is set to
-    vpTime::getMinTimeForUsleepCall() / 1000 seconds.
+    vpTime::getMinTimeForUsleepCall() / 1000 seconds. In stepped mode, it is
+    the duration simulated by each call to step() and it is not bounded.
 
+    \sa setSteppedMode()
   */
   inline void setSamplingTime(const double &delta_t)
   {
-    if (delta_t < static_cast<float>(vpTime::getMinTimeForUsleepCall() * 1e-3)) {
+    if (!steppedMode && delta_t < static_cast<float>(vpTime::getMinTimeForUsleepCall() * 1e-3)) {
       this->delta_t_ = static_cast<float>(vpTime::getMinTimeForUsleepCall() * 1e-3);
     } else {
       this->delta_t_ = delta_t;
@@ -351,6 +395,8 @@ public:
   /*! Set the parameter which enable or disable the singularity mangement */
   void setSingularityManagement(const bool sm) { singularityManagement = sm; }
 
+  void setSteppedMode(bool stepped);
+
   /*!
     Activates extra printings when the robot reaches joint limits...
     */
@@ -362,6 +408,8 @@ public:
     \param fMo_ : The pose between the object and the fixed world frame.
   */
   void set_fMo(const vpHomogeneousMatrix &fMo_) { this->fMo = fMo_; }
+
+  void step();
   //@}
 
 protected:
@@ -386,11 +434,24 @@ protected:
   }
 #endif
 
+  void startThread();
+  void stopThread();
+
+  /*!
+    Return the time of the robot measurements: the simulated time in stepped
+    mode, the Unix time in second since January 1st 1970 otherwise.
+  */
+  double getTimestamp() const { return steppedMode ? simulationTime : vpTime::measureTimeSecond(); }
+  void stepArticularPosition();
+
   /* Robot functions */
   void init() { ; }
   /*! Method lauched by the thread to compute the position of the robot in the
    * articular frame. */
   virtual void updateArticularPosition() = 0;
+  /*! Method used to move the robot in the articular frame with the current
+   * articular velocity during \e ellapsedTime seconds. */
+  virtual void integrateArticularPosition(double ellapsedTime) = 0;
   /*! Method used to check if the robot reached a joint limit. */
   virtual int isInJointLimit() = 0;
   /*! Compute the articular velocity relative to the velocity in another
@@ -401,158 +462,94 @@ protected:
   void initDisplay() { ; }
   virtual void initArms() = 0;
 
+  // The mutexes are only needed while the background thread runs
 #if defined(_WIN32)
-  vpColVector get_artCoord() const
-  {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_artCoord, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_artCoord, INFINITE);
-#endif
-    vpColVector artCoordTmp(6);
-    artCoordTmp = artCoord;
-    ReleaseMutex(mutex_artCoord);
-    return artCoordTmp;
-  }
-  void set_artCoord(const vpColVector &coord)
-  {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_artCoord, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_artCoord, INFINITE);
-#endif
-    artCoord = coord;
-    ReleaseMutex(mutex_artCoord);
-  }
-
-  vpColVector get_artVel() const
-  {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_artVel, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_artVel, INFINITE);
-#endif
-    vpColVector artVelTmp(artVel);
-    ReleaseMutex(mutex_artVel);
-    return artVelTmp;
-  }
-  void set_artVel(const vpColVector &vel)
+  void lockMutex(HANDLE &mutex)
   {
+    if (!steppedMode) {
 #if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_artVel, INFINITE, FALSE);
+      WaitForSingleObjectEx(mutex, INFINITE, FALSE);
 #else // pure win32
-    WaitForSingleObject(mutex_artVel, INFINITE);
+      WaitForSingleObject(mutex, INFINITE);
 #endif
-    artVel = vel;
-    ReleaseMutex(mutex_artVel);
+    }
   }
-
-  vpColVector get_velocity()
+  void unlockMutex(HANDLE &mutex)
   {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_velocity, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_velocity, INFINITE);
-#endif
-    vpColVector velocityTmp = velocity;
-    ReleaseMutex(mutex_velocity);
-    return velocityTmp;
+    if (!steppedMode)
+      ReleaseMutex(mutex);
   }
-  void set_velocity(const vpColVector &vel)
+#elif defined(VISP_HAVE_PTHREAD)
+  void lockMutex(pthread_mutex_t &mutex)
   {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_velocity, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_velocity, INFINITE);
-#endif
-    velocity = vel;
-    ReleaseMutex(mutex_velocity);
+    if (!steppedMode)
+      pthread_mutex_lock(&mutex);
   }
-
-  void set_displayBusy(const bool &status)
+  void unlockMutex(pthread_mutex_t &mutex)
   {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_display, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_display, INFINITE);
-#endif
-    displayBusy = status;
-    ReleaseMutex(mutex_display);
+    if (!steppedMode)
+      pthread_mutex_unlock(&mutex);
   }
-  bool get_displayBusy()
-  {
-#if defined(WINRT_8_1)
-    WaitForSingleObjectEx(mutex_display, INFINITE, FALSE);
-#else // pure win32
-    WaitForSingleObject(mutex_display, INFINITE);
 #endif
-    bool status = displayBusy;
-    if (!displayBusy)
-      displayBusy = true;
-    ReleaseMutex(mutex_display);
-    return status;
-  }
 
-#elif defined(VISP_HAVE_PTHREAD)
   vpColVector get_artCoord()
   {
-    pthread_mutex_lock(&mutex_artCoord);
+    lockMutex(mutex_artCoord);
     vpColVector artCoordTmp(6);
     artCoordTmp = artCoord;
-    pthread_mutex_unlock(&mutex_artCoord);
+    unlockMutex(mutex_artCoord);
     return artCoordTmp;
   }
   void set_artCoord(const vpColVector &coord)
   {
-    pthread_mutex_lock(&mutex_artCoord);
+    lockMutex(mutex_artCoord);
     artCoord = coord;
-    pthread_mutex_unlock(&mutex_artCoord);
+    unlockMutex(mutex_artCoord);
   }
 
   vpColVector get_artVel()
   {
-    pthread_mutex_lock(&mutex_artVel);
+    lockMutex(mutex_artVel);
     vpColVector artVelTmp(artVel);
-    pthread_mutex_unlock(&mutex_artVel);
+    unlockMutex(mutex_artVel);
     return artVelTmp;
   }
   void set_artVel(const vpColVector &vel)
   {
-    pthread_mutex_lock(&mutex_artVel);
+    lockMutex(mutex_artVel);
     artVel = vel;
-    pthread_mutex_unlock(&mutex_artVel);
+    unlockMutex(mutex_artVel);
   }
 
   vpColVector get_velocity()
   {
-    pthread_mutex_lock(&mutex_velocity);
+    lockMutex(mutex_velocity);
     vpColVector velocityTmp = velocity;
-    pthread_mutex_unlock(&mutex_velocity);
+    unlockMutex(mutex_velocity);
     return velocityTmp;
   }
   void set_velocity(const vpColVector &vel)
   {
-    pthread_mutex_lock(&mutex_velocity);
+    lockMutex(mutex_velocity);
     velocity = vel;
-    pthread_mutex_unlock(&mutex_velocity);
+    unlockMutex(mutex_velocity);
   }
 
   void set_displayBusy(const bool &status)
   {
-    pthread_mutex_lock(&mutex_display);
+    lockMutex(mutex_display);
     displayBusy = status;
-    pthread_mutex_unlock(&mutex_display);
+    unlockMutex(mutex_display);
   }
   bool get_displayBusy()
   {
-    pthread_mutex_lock(&mutex_display);
+    lockMutex(mutex_display);
     bool status = displayBusy;
     if (!displayBusy)
       displayBusy = true;
-    pthread_mutex_unlock(&mutex_display);
+    unlockMutex(mutex_display);
     return status;
   }
-#endif
 
   /*! Get a table of poses between the reference frame and the frames you used
    * to compute the Denavit-Hartenberg representation */
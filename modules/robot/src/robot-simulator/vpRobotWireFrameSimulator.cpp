@@ -39,6 +39,7 @@
 #include <visp3/core/vpConfig.h>
 
 #if defined(VISP_HAVE_MODULE_GUI) && ((defined(_WIN32) && !defined(WINRT_8_0)) || defined(VISP_HAVE_PTHREAD))
+#include <visp3/robot/vpRobotException.h>
 #include <visp3/robot/vpRobotWireFrameSimulator.h>
 #include <visp3/robot/vpSimulatorViper850.h>
 
@@ -62,7 +63,7 @@ vpRobotWireFrameSimulator::vpRobotWireFrameSimulator()
     display(),
 #endif
     displayType(MODEL_3D), displayAllowed(true), constantSamplingTimeMode(false), setVelocityCalled(false),
-    verbose_(false)
+    verbose_(false), steppedMode(false), simulationTime(0)
 {
   setSamplingTime(0.010);
   velocity.resize(6);
@@ -94,7 +95,7 @@ vpRobotWireFrameSimulator::vpRobotWireFrameSimulator(bool do_display)
     display(),
 #endif
     displayType(MODEL_3D), displayAllowed(do_display), constantSamplingTimeMode(false), setVelocityCalled(false),
-    verbose_(false)
+    verbose_(false), steppedMode(false), simulationTime(0)
 {
   setSamplingTime(0.010);
   velocity.resize(6);
@@ -357,6 +358,111 @@ void vpRobotWireFrameSimulator::getInternalView(vpImage<unsigned char> &I_)
   set_displayBusy(false);
 }
 
+/*!
+  Enable or disable the stepped mode of the simulator.
+
+  In stepped mode, the background thread that moves the robot in real time
+  is stopped. The robot only moves when step() is called, by the sampling
+  time set with setSamplingTime(), and the timestamps of the measurements
+  are the simulated time returned by getSimulationTime(). The state of the
+  robot is then accessed without locking, and the same sequence of commands
+  always gives the same trajectory.
+
+  Disabling the stepped mode restarts the background thread.
+
+  \param stepped : True to move the robot only when step() is called, false
+  to move it in real time.
+
+  \sa step(), setSamplingTime()
+*/
+void vpRobotWireFrameSimulator::setSteppedMode(bool stepped)
+{
+  if (stepped == steppedMode) {
+    return;
+  }
+
+  if (stepped) {
+    stopThread();
+    steppedMode = true;
+    simulationTime = 0;
+  } else {
+    steppedMode = false;
+    startThread();
+  }
+}
+
+/*!
+  In stepped mode, move the robot during the sampling time set with
+  setSamplingTime() with the velocity applied to the robot, and update the
+  external view if the simulator displays it.
+
+  \exception vpRobotException::wrongStateError : If the stepped mode is not
+  enabled.
+
+  \sa setSteppedMode()
+*/
+void vpRobotWireFrameSimulator::step()
+{
+  if (!steppedMode) {
+    throw vpRobotException(vpRobotException::wrongStateError, "The simulator has to be in stepped mode to call step()");
+  }
+
+  setVelocityCalled = false;
+  computeArticularVelocity();
+  stepArticularPosition();
+}
+
+/*!
+  Move the robot with the current articular velocity during the sampling
+  time and update the simulated time, without computing the articular
+  velocity from the velocity applied to the robot. Used in stepped mode.
+*/
+void vpRobotWireFrameSimulator::stepArticularPosition()
+{
+  integrateArticularPosition(getSamplingTime());
+  simulationTime += getSamplingTime();
+}
+
+/*!
+  Launch the thread which moves the robot in real time.
+*/
+void vpRobotWireFrameSimulator::startThread()
+{
+  robotStop = false;
+  tcur = vpTime::measureTimeMs();
+
+#if defined(_WIN32)
+  DWORD dwThreadIdArray;
+  hThread = CreateThread(NULL,              // default security attributes
+                         0,                 // use default stack size
+                         launcher,          // thread function name
+                         this,              // argument to thread function
+                         0,                 // use default creation flags
+                         &dwThreadIdArray); // returns the thread identifier
+#elif defined(VISP_HAVE_PTHREAD)
+  pthread_create(&thread, NULL, launcher, (void *)this);
+#endif
+}
+
+/*!
+  Stop the thread which moves the robot in real time and wait for its end.
+*/
+void vpRobotWireFrameSimulator::stopThread()
+{
+  robotStop = true;
+
+#if defined(_WIN32)
+#if defined(WINRT_8_1)
+  WaitForSingleObjectEx(hThread, INFINITE, FALSE);
+#else // pure win32
+  WaitForSingleObject(hThread, INFINITE);
+#endif
+  CloseHandle(hThread);
+#elif defined(VISP_HAVE_PTHREAD)
+  pthread_join(thread, NULL);
+#endif
+}
+
 /*!
   Get the pose between the object and the robot's camera.
 
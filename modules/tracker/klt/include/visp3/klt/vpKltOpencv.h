@@ -74,6 +74,14 @@
   \include tutorial-klt-tracker.cpp
 
   A line by line explanation is provided in \ref tutorial-tracking-keypoint.
+
+  The image pyramid of the last image passed to initTracking() or track() is
+  kept and used as the previous pyramid at the next call to track(), so that
+  only one pyramid is built per frame. Since this pyramid holds its own copy
+  of the image, the image given to track() may be a cv::Mat header wrapping
+  a vpImage without copy (see vpImageConvert::convert(const
+  vpImage<unsigned char> &, cv::Mat &, bool) with \e copyData set to false),
+  which can then be overwritten by the next acquisition.
 */
 class VISP_EXPORT vpKltOpencv
 {
@@ -158,7 +166,12 @@ public:
   void suppressFeature(const int &index);
 
 protected:
+  void buildPyramid(const cv::Mat &I);
+
   cv::Mat m_gray, m_prevGray;
+  //! Current and previous image pyramids with derivatives, reused from one
+  //! call to track() to the next
+  std::vector<cv::Mat> m_pyramid, m_prevPyramid;
   std::vector<cv::Point2f> m_points[2]; //!< Previous [0] and current [1] keypoint location
   std::vector<long> m_points_id;        //!< Keypoint id
   int m_maxCount;
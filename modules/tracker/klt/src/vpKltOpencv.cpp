@@ -59,9 +59,9 @@
   Default constructor.
  */
 vpKltOpencv::vpKltOpencv()
-  : m_gray(), m_prevGray(), m_points_id(), m_maxCount(500), m_termcrit(), m_winSize(10), m_qualityLevel(0.01),
-    m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04), m_blockSize(3), m_useHarrisDetector(1),
-    m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
+  : m_gray(), m_prevGray(), m_pyramid(), m_prevPyramid(), m_points_id(), m_maxCount(500), m_termcrit(),
+    m_winSize(10), m_qualityLevel(0.01), m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04),
+    m_blockSize(3), m_useHarrisDetector(1), m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
 {
   m_termcrit = cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03);
 }
@@ -70,9 +70,9 @@ vpKltOpencv::vpKltOpencv()
   Copy constructor.
  */
 vpKltOpencv::vpKltOpencv(const vpKltOpencv &copy)
-  : m_gray(), m_prevGray(), m_points_id(), m_maxCount(500), m_termcrit(), m_winSize(10), m_qualityLevel(0.01),
-    m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04), m_blockSize(3), m_useHarrisDetector(1),
-    m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
+  : m_gray(), m_prevGray(), m_pyramid(), m_prevPyramid(), m_points_id(), m_maxCount(500), m_termcrit(),
+    m_winSize(10), m_qualityLevel(0.01), m_minDistance(15), m_minEigThreshold(1e-4), m_harris_k(0.04),
+    m_blockSize(3), m_useHarrisDetector(1), m_pyrMaxLevel(3), m_next_points_id(0), m_initial_guess(false)
 {
   *this = copy;
 }
@@ -82,8 +82,12 @@ vpKltOpencv::vpKltOpencv(const vpKltOpencv &copy)
  */
 vpKltOpencv &vpKltOpencv::operator=(const vpKltOpencv &copy)
 {
-  m_gray = copy.m_gray;
-  m_prevGray = copy.m_prevGray;
+  // Deep copy since the images share their memory with the pyramids that are
+  // overwritten by the next call to track()
+  m_gray = copy.m_gray.clone();
+  m_prevGray = copy.m_prevGray.clone();
+  m_pyramid.clear();
+  m_prevPyramid.clear();
   m_points[0] = copy.m_points[0];
   m_points[1] = copy.m_points[1];
   m_points_id = copy.m_points_id;
@@ -119,8 +123,7 @@ void vpKltOpencv::initTracking(const cv::Mat &I, const cv::Mat &mask)
 {
   m_next_points_id = 0;
 
-  // cvtColor(I, m_gray, cv::COLOR_BGR2GRAY);
-  I.copyTo(m_gray);
+  buildPyramid(I);
 
   for (size_t i = 0; i < 2; i++) {
     m_points[i].clear();
@@ -139,9 +142,25 @@ void vpKltOpencv::initTracking(const cv::Mat &I, const cv::Mat &mask)
   }
 }
 
+/*!
+  Build the pyramid of \e I with its derivatives in m_pyramid. The level 0 of
+  the pyramid is a bordered copy of \e I that becomes the current image
+  m_gray, thus \e I is no more referenced after this call.
+*/
+void vpKltOpencv::buildPyramid(const cv::Mat &I)
+{
+  // Never reuse the input image as level 0 since it may be overwritten by the caller
+  cv::buildOpticalFlowPyramid(I, m_pyramid, cv::Size(m_winSize, m_winSize), m_pyrMaxLevel, true,
+                              cv::BORDER_REFLECT_101, cv::BORDER_CONSTANT, false);
+  m_gray = m_pyramid[0];
+}
+
 /*!
    Track KLT keypoints using the iterative Lucas-Kanade method with pyramids.
 
+   The pyramid of the previous image is the one built at the previous call to
+   initTracking() or track(), and \e I is not referenced after the call.
+
    \param I : Input image.
  */
 void vpKltOpencv::track(const cv::Mat &I)
@@ -153,6 +172,7 @@ void vpKltOpencv::track(const cv::Mat &I)
   int flags = 0;
 
   cv::swap(m_prevGray, m_gray);
+  std::swap(m_prevPyramid, m_pyramid);
 
   if (m_initial_guess) {
     flags |= cv::OPTFLOW_USE_INITIAL_FLOW;
@@ -161,26 +181,40 @@ void vpKltOpencv::track(const cv::Mat &I)
     std::swap(m_points[1], m_points[0]);
   }
 
-  // cvtColor(I, m_gray, cv::COLOR_BGR2GRAY);
-  I.copyTo(m_gray);
+  // Reuses the buffers of the pyramid of the image before the previous one
+  buildPyramid(I);
 
-  if (m_prevGray.empty()) {
-    m_gray.copyTo(m_prevGray);
+  if (m_prevPyramid.empty()) {
+    // No pyramid kept for the previous image: first call, or the pyramid
+    // parameters have changed
+    if (m_prevGray.empty()) {
+      m_prevGray = m_gray;
+    }
+    cv::buildOpticalFlowPyramid(m_prevGray, m_prevPyramid, cv::Size(m_winSize, m_winSize), m_pyrMaxLevel, true,
+                                cv::BORDER_REFLECT_101, cv::BORDER_CONSTANT, false);
+    m_prevGray = m_prevPyramid[0];
   }
 
   std::vector<uchar> status;
 
-  cv::calcOpticalFlowPyrLK(m_prevGray, m_gray, m_points[0], m_points[1], status, err, cv::Size(m_winSize, m_winSize),
-                           m_pyrMaxLevel, m_termcrit, flags, m_minEigThreshold);
-
-  // Remove points that are lost
-  for (int i = (int)status.size() - 1; i >= 0; i--) {
-    if (status[(size_t)i] == 0) { // point is lost
-      m_points[0].erase(m_points[0].begin() + i);
-      m_points[1].erase(m_points[1].begin() + i);
-      m_points_id.erase(m_points_id.begin() + i);
+  cv::calcOpticalFlowPyrLK(m_prevPyramid, m_pyramid, m_points[0], m_points[1], status, err,
+                           cv::Size(m_winSize, m_winSize), m_pyrMaxLevel, m_termcrit, flags, m_minEigThreshold);
+
+  // Remove points that are lost by compacting the remaining ones in place
+  size_t nbPoints = 0;
+  for (size_t i = 0; i < status.size(); i++) {
+    if (status[i] != 0) {
+      if (nbPoints != i) {
+        m_points[0][nbPoints] = m_points[0][i];
+        m_points[1][nbPoints] = m_points[1][i];
+        m_points_id[nbPoints] = m_points_id[i];
+      }
+      nbPoints++;
     }
   }
+  m_points[0].resize(nbPoints);
+  m_points[1].resize(nbPoints);
+  m_points_id.resize(nbPoints);
 }
 
 /*!
@@ -340,7 +374,13 @@ void vpKltOpencv::setMaxFeatures(const int maxCount) { m_maxCount = maxCount; }
   is set to 10. For example, if \e winSize=5 , then a 5*2+1 \f$\times\f$ 5*2+1
   = 11 \f$\times\f$ 11 search window is used.
 */
-void vpKltOpencv::setWindowSize(const int winSize) { m_winSize = winSize; }
+void vpKltOpencv::setWindowSize(const int winSize)
+{
+  m_winSize = winSize;
+  // The border of the kept pyramids depends on the window size
+  m_pyramid.clear();
+  m_prevPyramid.clear();
+}
 
 /*!
   Set the parameter characterizing the minimal accepted quality of image
@@ -406,7 +446,12 @@ void vpKltOpencv::setBlockSize(const int blockSize) { m_blockSize = blockSize; }
   pyramids are not used (single level), if set to 1, two levels are used, and
   so on. Default value is set to 3.
 */
-void vpKltOpencv::setPyramidLevels(const int pyrMaxLevel) { m_pyrMaxLevel = pyrMaxLevel; }
+void vpKltOpencv::setPyramidLevels(const int pyrMaxLevel)
+{
+  m_pyrMaxLevel = pyrMaxLevel;
+  m_pyramid.clear();
+  m_prevPyramid.clear();
+}
 
 /*!
   Set the points that will be used as initial guess during the next call to
@@ -481,7 +526,7 @@ void vpKltOpencv::initTracking(const cv::Mat &I, const std::vector<cv::Point2f>
     m_points_id.push_back(m_next_points_id++);
   }
 
-  I.copyTo(m_gray);
+  buildPyramid(I);
 }
 
 void vpKltOpencv::initTracking(const cv::Mat &I, const std::vector<cv::Point2f> &pts, const std::vector<long> &ids)
@@ -504,7 +549,7 @@ void vpKltOpencv::initTracking(const cv::Mat &I, const std::vector<cv::Point2f>
     m_next_points_id = max + 1;
   }
 
-  I.copyTo(m_gray);
+  buildPyramid(I);
 }
 
 /*!
@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the KLT tracking with vpKltOpencv.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKltOpencvPerformance.cpp
+
+  \brief Measure the time spent in vpKltOpencv::track() with 300, 1000 and
+  3000 features on a synthetic translating texture, compared to a direct call
+  to cv::calcOpticalFlowPyrLK() on copied images. The frames are written in a
+  single vpImage wrapped without copy, to check that the tracker doesn't keep
+  any reference on its input.
+*/
+
+#include <iostream>
+#include <math.h>
+#include <stdlib.h>
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_MODULE_KLT) && defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/klt/vpKltOpencv.h>
+
+namespace
+{
+// Translation in pixel of the texture between two consecutive frames
+const double tx = 0.7;
+const double ty = -0.4;
+
+void buildSequence(std::vector<cv::Mat> &frames, unsigned int nbFrames)
+{
+  cv::Mat noise(120, 160, CV_8UC1), texture;
+  cv::randu(noise, cv::Scalar(0), cv::Scalar(256));
+  cv::resize(noise, texture, cv::Size(640, 480), 0, 0, cv::INTER_CUBIC);
+  cv::GaussianBlur(texture, texture, cv::Size(5, 5), 1.0);
+
+  frames.resize(nbFrames);
+  for (unsigned int k = 0; k < nbFrames; k++) {
+    cv::Mat M = (cv::Mat_<double>(2, 3) << 1, 0, k * tx, 0, 1, k * ty);
+    cv::warpAffine(texture, frames[k], M, texture.size(), cv::INTER_LINEAR, cv::BORDER_REFLECT);
+  }
+}
+
+bool runBenchmark(const std::vector<cv::Mat> &frames, int nbFeatures)
+{
+  vpKltOpencv tracker;
+  tracker.setMaxFeatures(nbFeatures);
+  tracker.setWindowSize(10);
+  tracker.setQuality(0.001);
+  tracker.setMinDistance(4);
+  tracker.setHarrisFreeParameter(0.04);
+  tracker.setBlockSize(9);
+  tracker.setUseHarris(1);
+  tracker.setPyramidLevels(3);
+
+  // All the frames are written in the same vpImage, wrapped without copy
+  vpImage<unsigned char> I;
+  cv::Mat cvI;
+  vpImageConvert::convert(frames[0], I);
+  vpImageConvert::convert(I, cvI, false);
+  tracker.initTracking(cvI);
+
+  std::vector<cv::Point2f> initPoints = tracker.getFeatures();
+  std::vector<long> initIds = tracker.getFeaturesId();
+  std::vector<cv::Point2f> refPoints = initPoints;
+  const cv::Size winSize(tracker.getWindowSize(), tracker.getWindowSize());
+  const cv::TermCriteria termcrit(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 20, 0.03);
+
+  double t_klt = 0, t_ref = 0;
+  for (size_t k = 1; k < frames.size(); k++) {
+    vpImageConvert::convert(frames[k], I);
+
+    double t = vpTime::measureTimeMs();
+    tracker.track(cvI);
+    t_klt += vpTime::measureTimeMs() - t;
+
+    // Reference: both pyramids built at each frame from copies of the images
+    t = vpTime::measureTimeMs();
+    cv::Mat prev = frames[k - 1].clone(), cur = frames[k].clone();
+    std::vector<cv::Point2f> points;
+    std::vector<uchar> status;
+    std::vector<float> err;
+    cv::calcOpticalFlowPyrLK(prev, cur, refPoints, points, status, err, winSize, tracker.getPyramidLevels(),
+                             termcrit, 0, 1e-4);
+    t_ref += vpTime::measureTimeMs() - t;
+    refPoints = points;
+  }
+
+  // Check the tracked features against the known translation
+  std::vector<cv::Point2f> points = tracker.getFeatures();
+  std::vector<long> ids = tracker.getFeaturesId();
+  const double dx = (frames.size() - 1) * tx, dy = (frames.size() - 1) * ty;
+  unsigned int nbBad = 0;
+  for (size_t i = 0; i < points.size(); i++) {
+    size_t j = (size_t)(ids[i] - initIds[0]);
+    double ex = points[i].x - initPoints[j].x - dx, ey = points[i].y - initPoints[j].y - dy;
+    if (sqrt(ex * ex + ey * ey) > 0.5) {
+      nbBad++;
+    }
+  }
+
+  std::cout << initPoints.size() << " features: " << t_klt / (frames.size() - 1) << " ms per frame with vpKltOpencv, "
+            << t_ref / (frames.size() - 1) << " ms with cv::calcOpticalFlowPyrLK on copies; "
+            << points.size() << " features kept, " << nbBad << " badly tracked" << std::endl;
+
+  if (points.size() < initPoints.size() / 2 || nbBad > points.size() / 20) {
+    std::cerr << "Bad tracking with " << nbFeatures << " features" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    std::vector<cv::Mat> frames;
+    buildSequence(frames, 30);
+
+    const int nbFeatures[] = {300, 1000, 3000};
+    for (size_t i = 0; i < sizeof(nbFeatures) / sizeof(nbFeatures[0]); i++) {
+      if (!runBenchmark(frames, nbFeatures[i])) {
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
+
+#else
+int main()
+{
+  std::cout << "This test requires OpenCV >= 2.4.8." << std::endl;
+  return EXIT_SUCCESS;
+}
+#endif
@@ -110,6 +110,7 @@ public:
   virtual void track(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud);
 #endif
   virtual void track(const std::vector<vpColVector> &point_cloud, const unsigned int width, const unsigned int height);
+  virtual void track(const vpOrganizedPointCloud &point_cloud);
 
 protected:
   //! Set of faces describing the object used only for display with scan line.
@@ -166,5 +167,9 @@ protected:
 #endif
   void segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                          const unsigned int height);
+  void segmentPointCloud(const vpOrganizedPointCloud &point_cloud);
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  template <class vpPointAccessor> void segmentPointCloudImpl(const vpPointAccessor &points);
+#endif
 };
 #endif
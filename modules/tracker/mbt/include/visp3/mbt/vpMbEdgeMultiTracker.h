@@ -84,6 +84,8 @@ protected:
 
   //! Map of pyramidal images for each camera
   std::map<std::string, std::vector<const vpImage<unsigned char> *> > m_mapOfPyramidalImages;
+  //! Storage of the pyramidal images for each camera, reused from one frame to the next
+  std::map<std::string, vpImagePyramid> m_mapOfPyramids;
 
   //! Name of the reference camera
   std::string m_referenceCameraName;
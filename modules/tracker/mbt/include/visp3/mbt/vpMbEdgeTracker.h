@@ -46,6 +46,7 @@
 #ifndef vpMbEdgeTracker_HH
 #define vpMbEdgeTracker_HH
 
+#include <visp3/core/vpImagePyramid.h>
 #include <visp3/core/vpPoint.h>
 #include <visp3/core/vpXmlParser.h>
 #include <visp3/mbt/vpMbTracker.h>
@@ -312,6 +313,8 @@ protected:
   //! Pyramid of image associated to the current image. This pyramid is
   //! computed in the init() and in the track() methods.
   std::vector<const vpImage<unsigned char> *> Ipyramid;
+  //! Storage of the levels of Ipyramid, reused from one frame to the next.
+  vpImagePyramid m_pyramid;
 
   //! Current scale level used. This attribute must not be modified outside of
   //! the downScale() and upScale() methods, as it used to specify to some
@@ -342,6 +345,10 @@ protected:
   vpColVector m_weightedError_edge;
   //! Robust
   vpRobust m_robust_edge;
+  //! If true, the features are processed in parallel on the vpThreadPool
+  bool m_useParallelEdgeTracking;
+  //! Number of parallel tasks, 0 or less for one task per thread of the pool
+  int m_nbParallelEdgeTrackingThreads;
 
 public:
   vpMbEdgeTracker();
@@ -375,12 +382,25 @@ public:
 
   virtual unsigned int getNbPoints(const unsigned int level = 0) const;
 
+  /*!
+    Return the number of tasks used to process the features in parallel.
+
+    \sa setNbParallelEdgeTrackingThreads()
+  */
+  inline int getNbParallelEdgeTrackingThreads() const { return m_nbParallelEdgeTrackingThreads; }
+
   /*!
     Return the scales levels used for the tracking.
 
     \return The scales levels used for the tracking.
   */
   std::vector<bool> getScales() const { return scales; }
+  /*!
+    Return true if the features are processed in parallel.
+
+    \sa setUseParallelEdgeTracking()
+  */
+  inline bool getUseParallelEdgeTracking() const { return m_useParallelEdgeTracking; }
   /*!
      \return The threshold value between 0 and 1 over good moving edges ratio.
      It allows to decide if the tracker has enough valid moving edges to
@@ -487,12 +507,40 @@ public:
 
   void setMovingEdge(const vpMe &me);
 
+  /*!
+    Set the number of tasks used to process the features in parallel when
+    setUseParallelEdgeTracking() is enabled.
+
+    \param nb : Number of tasks. If 0 or less, one task is created per
+    thread of vpThreadPool::getInstance(), including the calling thread.
+
+    \sa getNbParallelEdgeTrackingThreads()
+  */
+  void setNbParallelEdgeTrackingThreads(const int nb) { m_nbParallelEdgeTrackingThreads = nb; }
+
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cdMo);
 
   void setScales(const std::vector<bool> &_scales);
 
   void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
 
+  /*!
+    Enable or disable the parallel processing of the lines, cylinders and
+    circles. When enabled, the moving edges of the features are tracked and
+    updated, and their rows of the interaction matrix and of the residual are
+    computed, by several tasks run on vpThreadPool::getInstance(). Each
+    feature is processed independently and writes to its own rows: the
+    result doesn't depend on the number of tasks. Disabled by default.
+
+    \warning The moving edges display (see vpMe and vpMeSite::setDisplay())
+    must stay disabled when the features are processed in parallel.
+
+    \param parallel : True to process the features in parallel.
+
+    \sa setNbParallelEdgeTrackingThreads(), getUseParallelEdgeTracking()
+  */
+  void setUseParallelEdgeTracking(const bool parallel) { m_useParallelEdgeTracking = parallel; }
+
   void track(const vpImage<unsigned char> &I);
   //@}
 
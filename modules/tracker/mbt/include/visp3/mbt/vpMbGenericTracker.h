@@ -178,6 +178,21 @@ public:
   virtual unsigned int getNbPoints(const unsigned int level = 0) const;
   virtual void getNbPoints(std::map<std::string, unsigned int> &mapOfNbPoints, const unsigned int level = 0) const;
 
+  /*!
+    Return true if the cameras are processed concurrently.
+
+    \sa setUseParallelCameraTracking()
+  */
+  virtual inline bool getUseParallelCameraTracking() const { return m_useParallelCameraTracking; }
+
+  /*!
+    Return true if the normal equations are accumulated per block of
+    features.
+
+    \sa setNormalEquationsAccumulation()
+  */
+  virtual inline bool getNormalEquationsAccumulation() const { return m_accumulateNormalEquations; }
+
   virtual inline unsigned int getNbPolygon() const;
   virtual void getNbPolygon(std::map<std::string, unsigned int> &mapOfNbPolygons) const;
 
@@ -328,6 +343,8 @@ public:
   virtual void setNearClippingDistance(const double &dist1, const double &dist2);
   virtual void setNearClippingDistance(const std::map<std::string, double> &mapOfDists);
 
+  virtual void setNormalEquationsAccumulation(const bool flag);
+
   virtual void setOgreShowConfigDialog(const bool showConfigDialog);
   virtual void setOgreVisibilityTest(const bool &v);
 
@@ -355,6 +372,8 @@ public:
   virtual void setUseDepthDenseTracking(const std::string &name, const bool &useDepthDenseTracking);
   virtual void setUseDepthNormalTracking(const std::string &name, const bool &useDepthNormalTracking);
   virtual void setUseEdgeTracking(const std::string &name, const bool &useEdgeTracking);
+  virtual void setUseParallelCameraTracking(const bool parallel);
+  virtual void setUseParallelEdgeTracking(const bool parallel, const int nbThreads = 0);
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   virtual void setUseKltTracking(const std::string &name, const bool &useKltTracking);
 #endif
@@ -372,6 +391,8 @@ public:
                      std::map<std::string, const std::vector<vpColVector> *> &mapOfPointClouds,
                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                      std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                     std::map<std::string, const vpOrganizedPointCloud *> &mapOfPointClouds);
 
 protected:
   virtual void computeProjectionError();
@@ -404,8 +425,12 @@ protected:
                            std::map<std::string, const std::vector<vpColVector> *> &mapOfPointClouds,
                            std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                            std::map<std::string, unsigned int> &mapOfPointCloudHeights);
+  virtual void preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                           std::map<std::string, const vpOrganizedPointCloud *> &mapOfPointClouds);
 
 private:
+  class CameraTask;
+
   class TrackerWrapper : public vpMbEdgeTracker,
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
                          public vpMbKltTracker,
@@ -414,6 +439,7 @@ private:
                          public vpMbDepthDenseTracker
   {
     friend class vpMbGenericTracker;
+    friend class vpMbGenericTracker::CameraTask;
 
   public:
     //! (s - s*)
@@ -426,6 +452,9 @@ private:
     vpColVector m_w;
     //! Weighted error
     vpColVector m_weightedError;
+    //! If false, the interaction matrices of the feature types are not
+    //! stacked in m_L
+    bool m_stackInteractionMatrix;
 
     TrackerWrapper();
     explicit TrackerWrapper(const int trackerType);
@@ -513,8 +542,15 @@ private:
     virtual void preTracking(const vpImage<unsigned char> *const ptr_I = NULL,
                              const std::vector<vpColVector> *const point_cloud = NULL,
                              const unsigned int pointcloud_width = 0, const unsigned int pointcloud_height = 0);
+    virtual void preTracking(const vpImage<unsigned char> *const ptr_I, const vpOrganizedPointCloud *const point_cloud);
+
+  private:
+    template <class vpPointAccessor>
+    void preTrackingImpl(const vpImage<unsigned char> *const ptr_I, const vpPointAccessor &points);
   };
 
+  static void runCameraTasks(std::vector<CameraTask> &tasks);
+
 protected:
   //! (s - s*)
   vpColVector m_error;
@@ -540,5 +576,14 @@ protected:
   vpColVector m_w;
   //! Weighted error
   vpColVector m_weightedError;
+  //! If true, the cameras are processed concurrently on the vpThreadPool
+  bool m_useParallelCameraTracking;
+  //! If true, the normal equations are accumulated per block of features
+  bool m_accumulateNormalEquations;
+  //! Normal matrix of the features of one camera, when the normal equations
+  //! are accumulated
+  vpMatrix m_LTL_camera;
+  //! Right-hand side of the normal equations of the features of one camera
+  vpColVector m_LTR_camera;
 };
 #endif
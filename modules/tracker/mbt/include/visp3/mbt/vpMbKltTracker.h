@@ -235,10 +235,12 @@ class VISP_EXPORT vpMbKltTracker : public virtual vpMbTracker
   friend class vpMbEdgeKltMultiTracker;
 
 protected:
-//! Temporary OpenCV image for fast conversion.
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+  //! Header without copy on the last input image, only valid during the
+  //! call that sets it.
   cv::Mat cur;
 #else
+  //! Temporary OpenCV image for fast conversion.
   IplImage *cur;
 #endif
   //! Initial pose.
@@ -757,6 +757,8 @@ protected:
                                           const vpMatrix &LVJ_true, const vpColVector &error);
 
   void computeJTR(const vpMatrix &J, const vpColVector &R, vpColVector &JTR) const;
+  void accumulateJTWJ(const vpMatrix &J, const vpColVector &R, const vpColVector &w, const double factor,
+                      vpMatrix &JTWJ, vpColVector &JTWR) const;
 
   double computeProjectionErrorImpl(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo,
                                     const vpCameraParameters &_cam, unsigned int &nbFeatures);
@@ -771,6 +773,10 @@ protected:
                                         vpColVector &R, const vpColVector &error, vpColVector &error_prev,
                                         vpColVector &LTR, double &mu, vpColVector &v, const vpColVector *const w = NULL,
                                         vpColVector *const m_w_prev = NULL);
+  void computeVVSPoseEstimationFromJTWJ(const bool isoJoIdentity_, const unsigned int iter, const vpMatrix &LTL,
+                                        const vpColVector &LTR, const vpColVector &error, vpColVector &error_prev,
+                                        double &mu, vpColVector &v, const vpColVector *const w = NULL,
+                                        vpColVector *const m_w_prev = NULL);
   virtual void computeVVSWeights(vpRobust &robust, const vpColVector &error, vpColVector &w);
 
 #ifdef VISP_HAVE_COIN3D
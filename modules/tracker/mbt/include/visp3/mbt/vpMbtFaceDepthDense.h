@@ -44,6 +44,7 @@
 #include <pcl/point_types.h>
 #endif
 
+#include <visp3/core/vpOrganizedPointCloud.h>
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
@@ -107,6 +108,14 @@ public:
 #endif
                               , const vpImage<bool> *mask = NULL
   );
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpOrganizedPointCloud &point_cloud,
+                              const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
 
   void computeInteractionMatrixAndResidu(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &error);
 
@@ -231,5 +240,21 @@ protected:
                   double &distanceToFace);
 
   bool samePoint(const vpPoint &P1, const vpPoint &P2) const;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+private:
+  friend class vpMbDepthDenseTracker;
+
+  template <class vpPointAccessor>
+  bool computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const vpPointAccessor &points,
+                                  const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                  ,
+                                  vpImage<unsigned char> &debugImage,
+                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                  , const vpImage<bool> *mask
+  );
+#endif
 };
 #endif
@@ -44,6 +44,7 @@
 #include <pcl/point_types.h>
 #endif
 
+#include <visp3/core/vpOrganizedPointCloud.h>
 #include <visp3/core/vpPlane.h>
 #include <visp3/mbt/vpMbTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
@@ -109,6 +110,14 @@ public:
 #endif
                               , const vpImage<bool> *mask = NULL
   );
+  bool computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const vpOrganizedPointCloud &point_cloud,
+                              vpColVector &desired_features, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                              ,
+                              vpImage<unsigned char> &debugImage, std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                              , const vpImage<bool> *mask = NULL
+  );
 
   void computeInteractionMatrix(const vpHomogeneousMatrix &cMo, vpMatrix &L, vpColVector &features);
 
@@ -293,5 +302,21 @@ protected:
                                 vpColVector &plane_equation_estimated, vpColVector &centroid);
 
   bool samePoint(const vpPoint &P1, const vpPoint &P2) const;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+private:
+  friend class vpMbDepthNormalTracker;
+
+  template <class vpPointAccessor>
+  bool computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const vpPointAccessor &points,
+                                  vpColVector &desired_features, const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                  ,
+                                  vpImage<unsigned char> &debugImage,
+                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                  , const vpImage<bool> *mask
+  );
+#endif
 };
 #endif
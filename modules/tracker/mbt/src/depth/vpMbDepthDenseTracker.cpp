@@ -47,6 +47,8 @@
 #include <visp3/mbt/vpMbDepthDenseTracker.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
+#include "vpMbtFaceDepthSampling.h"
+
 #if DEBUG_DISPLAY_DEPTH_DENSE
 #include <visp3/gui/vpDisplayGDI.h>
 #include <visp3/gui/vpDisplayX.h>
@@ -532,69 +534,33 @@ void vpMbDepthDenseTracker::testTracking() {}
 #ifdef VISP_HAVE_PCL
 void vpMbDepthDenseTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
-  m_depthDenseListOfActiveFaces.clear();
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
-  if (!m_debugDisp_depthDense->isInitialised()) {
-    m_debugImage_depthDense.resize(point_cloud->height, point_cloud->width);
-    m_debugDisp_depthDense->init(m_debugImage_depthDense, 50, 0, "Debug display dense depth tracker");
-  }
-
-  m_debugImage_depthDense = 0;
-  std::vector<std::vector<vpImagePoint> > roiPts_vec;
-#endif
-
-  for (std::vector<vpMbtFaceDepthDense *>::iterator it = m_depthDenseFaces.begin();
-       it != m_depthDenseFaces.end(); ++it) {
-    vpMbtFaceDepthDense *face = *it;
-
-    if (face->isVisible() && face->isTracked()) {
-#if DEBUG_DISPLAY_DEPTH_DENSE
-      std::vector<std::vector<vpImagePoint> > roiPts_vec_;
-#endif
-      if (face->computeDesiredFeatures(cMo, point_cloud, m_depthDenseSamplingStepX, m_depthDenseSamplingStepY
-#if DEBUG_DISPLAY_DEPTH_DENSE
-                                       ,
-                                       m_debugImage_depthDense, roiPts_vec_
-#endif
-                                       , m_mask
-                                       )) {
-        m_depthDenseListOfActiveFaces.push_back(*it);
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
-        roiPts_vec.insert(roiPts_vec.end(), roiPts_vec_.begin(), roiPts_vec_.end());
-#endif
-      }
-    }
-  }
-
-#if DEBUG_DISPLAY_DEPTH_DENSE
-  vpDisplay::display(m_debugImage_depthDense);
-
-  for (size_t i = 0; i < roiPts_vec.size(); i++) {
-    if (roiPts_vec[i].empty())
-      continue;
-
-    for (size_t j = 0; j < roiPts_vec[i].size() - 1; j++) {
-      vpDisplay::displayLine(m_debugImage_depthDense, roiPts_vec[i][j], roiPts_vec[i][j + 1], vpColor::red, 2);
-    }
-    vpDisplay::displayLine(m_debugImage_depthDense, roiPts_vec[i][0], roiPts_vec[i][roiPts_vec[i].size() - 1],
-                           vpColor::red, 2);
-  }
-
-  vpDisplay::flush(m_debugImage_depthDense);
-#endif
+  segmentPointCloudImpl(vpMbtPclPointAccessor(point_cloud));
 }
 #endif
 
 void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                                               const unsigned int height)
+{
+  segmentPointCloudImpl(vpMbtVectorPointAccessor(&point_cloud, height, width));
+}
+
+void vpMbDepthDenseTracker::segmentPointCloud(const vpOrganizedPointCloud &point_cloud)
+{
+  segmentPointCloudImpl(vpMbtOrganizedPointAccessor(&point_cloud));
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Select the visible faces and compute their desired features from the point
+  cloud, read through one of the accessors of vpMbtFaceDepthSampling.h.
+*/
+template <class vpPointAccessor> void vpMbDepthDenseTracker::segmentPointCloudImpl(const vpPointAccessor &points)
 {
   m_depthDenseListOfActiveFaces.clear();
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
   if (!m_debugDisp_depthDense->isInitialised()) {
-    m_debugImage_depthDense.resize(height, width);
+    m_debugImage_depthDense.resize(points.getHeight(), points.getWidth());
     m_debugDisp_depthDense->init(m_debugImage_depthDense, 50, 0, "Debug display dense depth tracker");
   }
 
@@ -610,14 +576,13 @@ void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &po
 #if DEBUG_DISPLAY_DEPTH_DENSE
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
 #endif
-      if (face->computeDesiredFeatures(cMo, width, height, point_cloud, m_depthDenseSamplingStepX,
-                                       m_depthDenseSamplingStepY
+      if (face->computeDesiredFeaturesImpl(cMo, points, m_depthDenseSamplingStepX, m_depthDenseSamplingStepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-                                       ,
-                                       m_debugImage_depthDense, roiPts_vec_
+                                           ,
+                                           m_debugImage_depthDense, roiPts_vec_
 #endif
-                                       , m_mask
-                                       )) {
+                                           , m_mask
+                                           )) {
         m_depthDenseListOfActiveFaces.push_back(*it);
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
@@ -645,6 +610,14 @@ void vpMbDepthDenseTracker::segmentPointCloud(const std::vector<vpColVector> &po
 #endif
 }
 
+// Instantiations used by vpMbGenericTracker
+#ifdef VISP_HAVE_PCL
+template void vpMbDepthDenseTracker::segmentPointCloudImpl(const vpMbtPclPointAccessor &);
+#endif
+template void vpMbDepthDenseTracker::segmentPointCloudImpl(const vpMbtVectorPointAccessor &);
+template void vpMbDepthDenseTracker::segmentPointCloudImpl(const vpMbtOrganizedPointAccessor &);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpMbDepthDenseTracker::setCameraParameters(const vpCameraParameters &camera)
 {
   this->cam = camera;
@@ -718,6 +691,15 @@ void vpMbDepthDenseTracker::track(const std::vector<vpColVector> &point_cloud, c
   computeVisibility(width, height);
 }
 
+void vpMbDepthDenseTracker::track(const vpOrganizedPointCloud &point_cloud)
+{
+  segmentPointCloud(point_cloud);
+
+  computeVVS();
+
+  computeVisibility(point_cloud.getWidth(), point_cloud.getHeight());
+}
+
 void vpMbDepthDenseTracker::initCircle(const vpPoint & /*p1*/, const vpPoint & /*p2*/, const vpPoint & /*p3*/,
                                        const double /*radius*/, const int /*idFace*/, const std::string & /*name*/)
 {
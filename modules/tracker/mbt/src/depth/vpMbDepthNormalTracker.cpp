@@ -47,6 +47,8 @@
 #include <visp3/mbt/vpMbDepthNormalTracker.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
+#include "vpMbtFaceDepthSampling.h"
+
 #if DEBUG_DISPLAY_DEPTH_NORMAL
 #include <visp3/gui/vpDisplayGDI.h>
 #include <visp3/gui/vpDisplayX.h>
@@ -536,75 +538,34 @@ void vpMbDepthNormalTracker::testTracking() {}
 #ifdef VISP_HAVE_PCL
 void vpMbDepthNormalTracker::segmentPointCloud(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
-  m_depthNormalListOfActiveFaces.clear();
-  m_depthNormalListOfDesiredFeatures.clear();
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-  if (!m_debugDisp_depthNormal->isInitialised()) {
-    m_debugImage_depthNormal.resize(point_cloud->height, point_cloud->width);
-    m_debugDisp_depthNormal->init(m_debugImage_depthNormal, 50, 0, "Debug display normal depth tracker");
-  }
-
-  m_debugImage_depthNormal = 0;
-  std::vector<std::vector<vpImagePoint> > roiPts_vec;
-#endif
-
-  for (std::vector<vpMbtFaceDepthNormal *>::iterator it = m_depthNormalFaces.begin(); it != m_depthNormalFaces.end();
-       ++it) {
-    vpMbtFaceDepthNormal *face = *it;
-
-    if (face->isVisible() && face->isTracked()) {
-      vpColVector desired_features;
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-      std::vector<std::vector<vpImagePoint> > roiPts_vec_;
-#endif
-      if (face->computeDesiredFeatures(cMo, point_cloud->width, point_cloud->height, point_cloud, desired_features,
-                                       m_depthNormalSamplingStepX, m_depthNormalSamplingStepY
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-                                       ,
-                                       m_debugImage_depthNormal, roiPts_vec_
-#endif
-                                       , m_mask
-                                       )) {
-        m_depthNormalListOfDesiredFeatures.push_back(desired_features);
-        m_depthNormalListOfActiveFaces.push_back(face);
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-        roiPts_vec.insert(roiPts_vec.end(), roiPts_vec_.begin(), roiPts_vec_.end());
-#endif
-      }
-    }
-  }
-
-#if DEBUG_DISPLAY_DEPTH_NORMAL
-  vpDisplay::display(m_debugImage_depthNormal);
-
-  for (size_t i = 0; i < roiPts_vec.size(); i++) {
-    if (roiPts_vec[i].empty())
-      continue;
-
-    for (size_t j = 0; j < roiPts_vec[i].size() - 1; j++) {
-      vpDisplay::displayLine(m_debugImage_depthNormal, roiPts_vec[i][j], roiPts_vec[i][j + 1], vpColor::red, 2);
-    }
-    vpDisplay::displayLine(m_debugImage_depthNormal, roiPts_vec[i][0], roiPts_vec[i][roiPts_vec[i].size() - 1],
-                           vpColor::red, 2);
-  }
-
-  vpDisplay::flush(m_debugImage_depthNormal);
-#endif
+  segmentPointCloudImpl(vpMbtPclPointAccessor(point_cloud));
 }
 #endif
 
 void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &point_cloud, const unsigned int width,
                                                const unsigned int height)
+{
+  segmentPointCloudImpl(vpMbtVectorPointAccessor(&point_cloud, height, width));
+}
+
+void vpMbDepthNormalTracker::segmentPointCloud(const vpOrganizedPointCloud &point_cloud)
+{
+  segmentPointCloudImpl(vpMbtOrganizedPointAccessor(&point_cloud));
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Select the visible faces and compute their desired features from the point
+  cloud, read through one of the accessors of vpMbtFaceDepthSampling.h.
+*/
+template <class vpPointAccessor> void vpMbDepthNormalTracker::segmentPointCloudImpl(const vpPointAccessor &points)
 {
   m_depthNormalListOfActiveFaces.clear();
   m_depthNormalListOfDesiredFeatures.clear();
 
 #if DEBUG_DISPLAY_DEPTH_NORMAL
   if (!m_debugDisp_depthNormal->isInitialised()) {
-    m_debugImage_depthNormal.resize(height, width);
+    m_debugImage_depthNormal.resize(points.getHeight(), points.getWidth());
     m_debugDisp_depthNormal->init(m_debugImage_depthNormal, 50, 0, "Debug display normal depth tracker");
   }
 
@@ -623,14 +584,14 @@ void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &p
       std::vector<std::vector<vpImagePoint> > roiPts_vec_;
 #endif
 
-      if (face->computeDesiredFeatures(cMo, width, height, point_cloud, desired_features, m_depthNormalSamplingStepX,
-                                       m_depthNormalSamplingStepY
+      if (face->computeDesiredFeaturesImpl(cMo, points, desired_features, m_depthNormalSamplingStepX,
+                                           m_depthNormalSamplingStepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
-                                       ,
-                                       m_debugImage_depthNormal, roiPts_vec_
+                                           ,
+                                           m_debugImage_depthNormal, roiPts_vec_
 #endif
-                                       , m_mask
-                                       )) {
+                                           , m_mask
+                                           )) {
         m_depthNormalListOfDesiredFeatures.push_back(desired_features);
         m_depthNormalListOfActiveFaces.push_back(face);
 
@@ -659,6 +620,14 @@ void vpMbDepthNormalTracker::segmentPointCloud(const std::vector<vpColVector> &p
 #endif
 }
 
+// Instantiations used by vpMbGenericTracker
+#ifdef VISP_HAVE_PCL
+template void vpMbDepthNormalTracker::segmentPointCloudImpl(const vpMbtPclPointAccessor &);
+#endif
+template void vpMbDepthNormalTracker::segmentPointCloudImpl(const vpMbtVectorPointAccessor &);
+template void vpMbDepthNormalTracker::segmentPointCloudImpl(const vpMbtOrganizedPointAccessor &);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpMbDepthNormalTracker::setCameraParameters(const vpCameraParameters &camera)
 {
   this->cam = camera;
@@ -759,6 +728,15 @@ void vpMbDepthNormalTracker::track(const std::vector<vpColVector> &point_cloud,
   computeVisibility(width, height);
 }
 
+void vpMbDepthNormalTracker::track(const vpOrganizedPointCloud &point_cloud)
+{
+  segmentPointCloud(point_cloud);
+
+  computeVVS();
+
+  computeVisibility(point_cloud.getWidth(), point_cloud.getHeight());
+}
+
 void vpMbDepthNormalTracker::initCircle(const vpPoint & /*p1*/, const vpPoint & /*p2*/, const vpPoint & /*p3*/,
                                         const double /*radius*/, const int /*idFace*/, const std::string & /*name*/)
 {
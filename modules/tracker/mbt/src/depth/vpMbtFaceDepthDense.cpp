@@ -36,6 +36,8 @@
 #include <visp3/core/vpCPUFeatures.h>
 #include <visp3/mbt/vpMbtFaceDepthDense.h>
 
+#include "vpMbtFaceDepthSampling.h"
+
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #include <emmintrin.h>
 #define VISP_HAVE_SSE2 1
@@ -149,126 +151,39 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
                                                  , const vpImage<bool> *mask
 )
 {
-  unsigned int width = point_cloud->width, height = point_cloud->height;
-  m_pointCloudFace.clear();
-
-  if (point_cloud->width == 0 || point_cloud->height == 0)
-    return false;
-
-  std::vector<vpImagePoint> roiPts;
-  double distanceToFace;
-  computeROI(cMo, width, height, roiPts
+  return computeDesiredFeaturesImpl(cMo, vpMbtPclPointAccessor(point_cloud), stepX, stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-             ,
-             roiPts_vec
-#endif
-             ,
-             distanceToFace);
-
-  if (roiPts.size() <= 2) {
-#ifndef NDEBUG
-    std::cerr << "Error: roiPts.size() <= 2 in computeDesiredFeatures" << std::endl;
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
-    return false;
-  }
-
-  if (((m_depthDenseFilteringMethod & MAX_DISTANCE_FILTERING) && distanceToFace > m_depthDenseFilteringMaxDist) ||
-      ((m_depthDenseFilteringMethod & MIN_DISTANCE_FILTERING) && distanceToFace < m_depthDenseFilteringMinDist)) {
-    return false;
-  }
-
-  vpPolygon polygon_2d(roiPts);
-  vpRect bb = polygon_2d.getBoundingBox();
-
-  unsigned int top = (unsigned int)std::max(0.0, bb.getTop());
-  unsigned int bottom = (unsigned int)std::min((double)height, std::max(0.0, bb.getBottom()));
-  unsigned int left = (unsigned int)std::max(0.0, bb.getLeft());
-  unsigned int right = (unsigned int)std::min((double)width, std::max(0.0, bb.getRight()));
-
-  bb.setTop(top);
-  bb.setBottom(bottom);
-  bb.setLeft(left);
-  bb.setRight(right);
-
-  if (bb.getHeight() < 0 || bb.getWidth() < 0) {
-    return false;
-  }
-
-  m_pointCloudFace.reserve((size_t)(bb.getWidth() * bb.getHeight()));
-
-  bool checkSSE2 = vpCPUFeatures::checkSSE2();
-#if !USE_SSE
-  checkSSE2 = false;
-#else
-  bool push = false;
-  double prev_x = 0.0, prev_y = 0.0, prev_z = 0.0;
-#endif
-
-  int totalTheoreticalPoints = 0, totalPoints = 0;
-  for (unsigned int i = top; i < bottom; i += stepY) {
-    for (unsigned int j = left; j < right; j += stepX) {
-      if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
-                         : polygon_2d.isInside(vpImagePoint(i, j)))) {
-        totalTheoreticalPoints++;
-
-        if (vpMeTracker::inMask(mask, i, j) && pcl::isFinite((*point_cloud)(j, i)) && (*point_cloud)(j, i).z > 0) {
-          totalPoints++;
-
-          if (checkSSE2) {
-#if USE_SSE
-            if (!push) {
-              push = true;
-              prev_x = (*point_cloud)(j, i).x;
-              prev_y = (*point_cloud)(j, i).y;
-              prev_z = (*point_cloud)(j, i).z;
-            } else {
-              push = false;
-              m_pointCloudFace.push_back(prev_x);
-              m_pointCloudFace.push_back((*point_cloud)(j, i).x);
-
-              m_pointCloudFace.push_back(prev_y);
-              m_pointCloudFace.push_back((*point_cloud)(j, i).y);
-
-              m_pointCloudFace.push_back(prev_z);
-              m_pointCloudFace.push_back((*point_cloud)(j, i).z);
-            }
+                                    , mask
+  );
+}
 #endif
-          } else {
-            m_pointCloudFace.push_back((*point_cloud)(j, i).x);
-            m_pointCloudFace.push_back((*point_cloud)(j, i).y);
-            m_pointCloudFace.push_back((*point_cloud)(j, i).z);
-          }
 
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
+                                                 const unsigned int height, const std::vector<vpColVector> &point_cloud,
+                                                 const unsigned int stepX, const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
-          debugImage[i][j] = 255;
+                                                 ,
+                                                 vpImage<unsigned char> &debugImage,
+                                                 std::vector<std::vector<vpImagePoint> > &roiPts_vec
 #endif
-        }
-      }
-    }
-  }
-
-#if USE_SSE
-  if (checkSSE2 && push) {
-    m_pointCloudFace.push_back(prev_x);
-    m_pointCloudFace.push_back(prev_y);
-    m_pointCloudFace.push_back(prev_z);
-  }
+                                                 , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtVectorPointAccessor(&point_cloud, height, width), stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
-
-  if (totalPoints == 0 || ((m_depthDenseFilteringMethod & DEPTH_OCCUPANCY_RATIO_FILTERING) &&
-                           totalPoints / (double)totalTheoreticalPoints < m_depthDenseFilteringOccupancyRatio)) {
-    return false;
-  }
-
-  return true;
+                                    , mask
+  );
 }
-#endif
 
-bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
-                                                 const unsigned int height, const std::vector<vpColVector> &point_cloud,
-                                                 const unsigned int stepX, const unsigned int stepY
+bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
+                                                 const vpOrganizedPointCloud &point_cloud, const unsigned int stepX,
+                                                 const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_DENSE
                                                  ,
                                                  vpImage<unsigned char> &debugImage,
@@ -277,10 +192,36 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
                                                  , const vpImage<bool> *mask
 )
 {
+  return computeDesiredFeaturesImpl(cMo, vpMbtOrganizedPointAccessor(&point_cloud), stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                    ,
+                                    debugImage, roiPts_vec
+#endif
+                                    , mask
+  );
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Keep the points of the point cloud that are inside the projected face. The
+  point cloud is read through one of the accessors of vpMbtFaceDepthSampling.h.
+*/
+template <class vpPointAccessor>
+bool vpMbtFaceDepthDense::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const vpPointAccessor &points,
+                                                     const unsigned int stepX, const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                     ,
+                                                     vpImage<unsigned char> &debugImage,
+                                                     std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                     , const vpImage<bool> *mask
+)
+{
+  const unsigned int height = points.getHeight(), width = points.getWidth();
   m_pointCloudFace.clear();
 
   if (width == 0 || height == 0)
-    return 0;
+    return false;
 
   std::vector<vpImagePoint> roiPts;
   double distanceToFace;
@@ -305,78 +246,27 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
   }
 
   vpPolygon polygon_2d(roiPts);
-  vpRect bb = polygon_2d.getBoundingBox();
-
-  unsigned int top = (unsigned int)std::max(0.0, bb.getTop());
-  unsigned int bottom = (unsigned int)std::min((double)height, std::max(0.0, bb.getBottom()));
-  unsigned int left = (unsigned int)std::max(0.0, bb.getLeft());
-  unsigned int right = (unsigned int)std::min((double)width, std::max(0.0, bb.getRight()));
-
-  bb.setTop(top);
-  bb.setBottom(bottom);
-  bb.setLeft(left);
-  bb.setRight(right);
-
-  m_pointCloudFace.reserve((size_t)(bb.getWidth() * bb.getHeight()));
-
-  bool checkSSE2 = vpCPUFeatures::checkSSE2();
-#if !USE_SSE
-  checkSSE2 = false;
+  const vpImage<int> *primitiveIDs = m_useScanLine ? &m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs() : NULL;
+#if DEBUG_DISPLAY_DEPTH_DENSE
+  std::vector<unsigned int> pixels;
+  std::vector<unsigned int> *ptr_pixels = &pixels;
 #else
-  bool push = false;
-  double prev_x = 0.0, prev_y = 0.0, prev_z = 0.0;
+  std::vector<unsigned int> *ptr_pixels = NULL;
 #endif
-
-  int totalTheoreticalPoints = 0, totalPoints = 0;
-  for (unsigned int i = top; i < bottom; i += stepY) {
-    for (unsigned int j = left; j < right; j += stepX) {
-      if ((m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
-                         : polygon_2d.isInside(vpImagePoint(i, j)))) {
-        totalTheoreticalPoints++;
-
-        if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0) {
-          totalPoints++;
-
-          if (checkSSE2) {
-#if USE_SSE
-            if (!push) {
-              push = true;
-              prev_x = point_cloud[i * width + j][0];
-              prev_y = point_cloud[i * width + j][1];
-              prev_z = point_cloud[i * width + j][2];
-            } else {
-              push = false;
-              m_pointCloudFace.push_back(prev_x);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
-
-              m_pointCloudFace.push_back(prev_y);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
-
-              m_pointCloudFace.push_back(prev_z);
-              m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
-            }
-#endif
-          } else {
-            m_pointCloudFace.push_back(point_cloud[i * width + j][0]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][1]);
-            m_pointCloudFace.push_back(point_cloud[i * width + j][2]);
-          }
+  const unsigned int totalTheoreticalPoints = vpMbtSampleFacePoints(
+      polygon_2d, points, stepY, stepX, mask, primitiveIDs, m_polygon->getIndex(), m_pointCloudFace, ptr_pixels);
+  const size_t totalPoints = m_pointCloudFace.size() / 3;
 
 #if DEBUG_DISPLAY_DEPTH_DENSE
-          debugImage[i][j] = 255;
-#endif
-        }
-      }
-    }
+  for (size_t k = 0; k < pixels.size(); k += 2) {
+    debugImage[pixels[k]][pixels[k + 1]] = 255;
   }
+#endif
 
 #if USE_SSE
-  if (checkSSE2 && push) {
-    m_pointCloudFace.push_back(prev_x);
-    m_pointCloudFace.push_back(prev_y);
-    m_pointCloudFace.push_back(prev_z);
+  if (vpCPUFeatures::checkSSE2()) {
+    // Layout of the points expected by computeInteractionMatrixAndResidu()
+    vpMbtInterleavePointPairs(m_pointCloudFace);
   }
 #endif
 
@@ -388,6 +278,35 @@ bool vpMbtFaceDepthDense::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
   return true;
 }
 
+// Instantiations used by the depth dense tracker
+#ifdef VISP_HAVE_PCL
+template bool vpMbtFaceDepthDense::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &, const vpMbtPclPointAccessor &,
+                                                              const unsigned int, const unsigned int
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                              ,
+                                                              vpImage<unsigned char> &,
+                                                              std::vector<std::vector<vpImagePoint> > &
+#endif
+                                                              , const vpImage<bool> *);
+#endif
+template bool vpMbtFaceDepthDense::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &, const vpMbtVectorPointAccessor &,
+                                                              const unsigned int, const unsigned int
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                              ,
+                                                              vpImage<unsigned char> &,
+                                                              std::vector<std::vector<vpImagePoint> > &
+#endif
+                                                              , const vpImage<bool> *);
+template bool vpMbtFaceDepthDense::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &, const vpMbtOrganizedPointAccessor &,
+                                                              const unsigned int, const unsigned int
+#if DEBUG_DISPLAY_DEPTH_DENSE
+                                                              ,
+                                                              vpImage<unsigned char> &,
+                                                              std::vector<std::vector<vpImagePoint> > &
+#endif
+                                                              , const vpImage<bool> *);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 void vpMbtFaceDepthDense::computeVisibility() { m_isVisible = m_polygon->isVisible(); }
 
 void vpMbtFaceDepthDense::computeVisibilityDisplay()
@@ -37,6 +37,8 @@
 #include <visp3/mbt/vpMbtFaceDepthNormal.h>
 #include <visp3/mbt/vpMbtTukeyEstimator.h>
 
+#include "vpMbtFaceDepthSampling.h"
+
 #ifdef VISP_HAVE_PCL
 #include <pcl/common/centroid.h>
 #include <pcl/filters/extract_indices.h>
@@ -147,6 +149,10 @@ void vpMbtFaceDepthNormal::addLine(vpPoint &P1, vpPoint &P2, vpMbHiddenFaces<vpM
 }
 
 #ifdef VISP_HAVE_PCL
+/*!
+  Compute the desired features from a PCL point cloud. The size of the point
+  cloud is used, \e width and \e height are kept for compatibility.
+*/
 bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
                                                   const unsigned int height,
                                                   const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud,
@@ -160,156 +166,43 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
                                                   , const vpImage<bool> *mask
 )
 {
-  m_faceActivated = false;
-
-  if (width == 0 || height == 0)
-    return false;
-
-  std::vector<vpImagePoint> roiPts;
-  vpColVector desired_normal(3);
-
-  computeROI(cMo, width, height, roiPts
+  (void)height;
+  (void)width;
+  return computeDesiredFeaturesImpl(cMo, vpMbtPclPointAccessor(point_cloud), desired_features, stepX, stepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
-             ,
-             roiPts_vec
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
+                                    , mask
   );
-
-  if (roiPts.size() <= 2) {
-#ifndef NDEBUG
-    std::cerr << "Error: roiPts.size() <= 2 in computeDesiredFeatures" << std::endl;
-#endif
-    return false;
-  }
-
-  vpPolygon polygon_2d(roiPts);
-  vpRect bb = polygon_2d.getBoundingBox();
-
-  unsigned int top = (unsigned int)std::max(0.0, bb.getTop());
-  unsigned int bottom = (unsigned int)std::min((double)height, std::max(0.0, bb.getBottom()));
-  unsigned int left = (unsigned int)std::max(0.0, bb.getLeft());
-  unsigned int right = (unsigned int)std::min((double)width, std::max(0.0, bb.getRight()));
-
-  bb.setTop(top);
-  bb.setBottom(bottom);
-  bb.setLeft(left);
-  bb.setRight(right);
-
-  // Keep only 3D points inside the projected polygon face
-  pcl::PointCloud<pcl::PointXYZ>::Ptr point_cloud_face(new pcl::PointCloud<pcl::PointXYZ>);
-  std::vector<double> point_cloud_face_vec, point_cloud_face_custom;
-
-  if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
-    point_cloud_face_custom.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
-    point_cloud_face_vec.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
-  } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION) {
-    point_cloud_face_vec.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
-  } else if (m_featureEstimationMethod == PCL_PLANE_ESTIMATION) {
-    point_cloud_face->reserve((size_t)(bb.getWidth() * bb.getHeight()));
-  }
-
-  bool checkSSE2 = vpCPUFeatures::checkSSE2();
-#if !USE_SSE
-  checkSSE2 = false;
-#else
-  bool push = false;
-  double prev_x, prev_y, prev_z;
+}
 #endif
 
-  double x = 0.0, y = 0.0;
-  for (unsigned int i = top; i < bottom; i += stepY) {
-    for (unsigned int j = left; j < right; j += stepX) {
-      if (vpMeTracker::inMask(mask, i, j) && pcl::isFinite((*point_cloud)(j, i)) && (*point_cloud)(j, i).z > 0 &&
-          (m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
-                         : polygon_2d.isInside(vpImagePoint(i, j)))) {
-
-        if (m_featureEstimationMethod == PCL_PLANE_ESTIMATION) {
-          point_cloud_face->push_back((*point_cloud)(j, i));
-        } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION ||
-                   m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
-          point_cloud_face_vec.push_back((*point_cloud)(j, i).x);
-          point_cloud_face_vec.push_back((*point_cloud)(j, i).y);
-          point_cloud_face_vec.push_back((*point_cloud)(j, i).z);
-
-          if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
-            // Add point for custom method for plane equation estimation
-            vpPixelMeterConversion::convertPoint(m_cam, j, i, x, y);
-
-            if (checkSSE2) {
-#if USE_SSE
-              if (!push) {
-                push = true;
-                prev_x = x;
-                prev_y = y;
-                prev_z = (*point_cloud)(j, i).z;
-              } else {
-                push = false;
-                point_cloud_face_custom.push_back(prev_x);
-                point_cloud_face_custom.push_back(x);
-
-                point_cloud_face_custom.push_back(prev_y);
-                point_cloud_face_custom.push_back(y);
-
-                point_cloud_face_custom.push_back(prev_z);
-                point_cloud_face_custom.push_back((*point_cloud)(j, i).z);
-              }
-#endif
-            } else {
-              point_cloud_face_custom.push_back(x);
-              point_cloud_face_custom.push_back(y);
-              point_cloud_face_custom.push_back((*point_cloud)(j, i).z);
-            }
-          }
-        }
-
+bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
+                                                  const unsigned int height,
+                                                  const std::vector<vpColVector> &point_cloud,
+                                                  vpColVector &desired_features, const unsigned int stepX,
+                                                  const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
-        debugImage[i][j] = 255;
+                                                  ,
+                                                  vpImage<unsigned char> &debugImage,
+                                                  std::vector<std::vector<vpImagePoint> > &roiPts_vec
 #endif
-      }
-    }
-  }
-
-#if USE_SSE
-  if (checkSSE2 && push) {
-    point_cloud_face_custom.push_back(prev_x);
-    point_cloud_face_custom.push_back(prev_y);
-    point_cloud_face_custom.push_back(prev_z);
-  }
+                                                  , const vpImage<bool> *mask
+)
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtVectorPointAccessor(&point_cloud, height, width), desired_features,
+                                    stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                    ,
+                                    debugImage, roiPts_vec
 #endif
-
-  if (point_cloud_face->empty() && point_cloud_face_custom.empty() && point_cloud_face_vec.empty()) {
-    return false;
-  }
-
-  // Face centroid computed by the different methods
-  vpColVector centroid_point(3);
-
-  if (m_featureEstimationMethod == PCL_PLANE_ESTIMATION) {
-    if (!computeDesiredFeaturesPCL(point_cloud_face, desired_features, desired_normal, centroid_point)) {
-      return false;
-    }
-  } else if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION) {
-    computeDesiredFeaturesSVD(point_cloud_face_vec, cMo, desired_features, desired_normal, centroid_point);
-  } else if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
-    computeDesiredFeaturesRobustFeatures(point_cloud_face_custom, point_cloud_face_vec, cMo, desired_features,
-                                         desired_normal, centroid_point);
-  } else {
-    throw vpException(vpException::badValue, "Unknown feature estimation method!");
-  }
-
-  computeDesiredNormalAndCentroid(cMo, desired_normal, centroid_point);
-
-  m_faceActivated = true;
-
-  return true;
+                                    , mask
+  );
 }
-#endif
 
-bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo, const unsigned int width,
-                                                  const unsigned int height,
-                                                  const std::vector<vpColVector> &point_cloud,
+bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo,
+                                                  const vpOrganizedPointCloud &point_cloud,
                                                   vpColVector &desired_features, const unsigned int stepX,
                                                   const unsigned int stepY
 #if DEBUG_DISPLAY_DEPTH_NORMAL
@@ -319,8 +212,36 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
 #endif
                                                   , const vpImage<bool> *mask
 )
+{
+  return computeDesiredFeaturesImpl(cMo, vpMbtOrganizedPointAccessor(&point_cloud), desired_features, stepX, stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                    ,
+                                    debugImage, roiPts_vec
+#endif
+                                    , mask
+  );
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Estimate the plane of the face from the points of the point cloud that are
+  inside the projected face. The point cloud is read through one of the
+  accessors of vpMbtFaceDepthSampling.h.
+*/
+template <class vpPointAccessor>
+bool vpMbtFaceDepthNormal::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &cMo, const vpPointAccessor &points,
+                                                      vpColVector &desired_features, const unsigned int stepX,
+                                                      const unsigned int stepY
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                      ,
+                                                      vpImage<unsigned char> &debugImage,
+                                                      std::vector<std::vector<vpImagePoint> > &roiPts_vec
+#endif
+                                                      , const vpImage<bool> *mask
+)
 {
   m_faceActivated = false;
+  const unsigned int height = points.getHeight(), width = points.getWidth();
 
   if (width == 0 || height == 0)
     return false;
@@ -342,95 +263,48 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
     return false;
   }
 
-  vpPolygon polygon_2d(roiPts);
-  vpRect bb = polygon_2d.getBoundingBox();
-
-  unsigned int top = (unsigned int)std::max(0.0, bb.getTop());
-  unsigned int bottom = (unsigned int)std::min((double)height, std::max(0.0, bb.getBottom()));
-  unsigned int left = (unsigned int)std::max(0.0, bb.getLeft());
-  unsigned int right = (unsigned int)std::min((double)width, std::max(0.0, bb.getRight()));
-
-  bb.setTop(top);
-  bb.setBottom(bottom);
-  bb.setLeft(left);
-  bb.setRight(right);
-
   // Keep only 3D points inside the projected polygon face
+  vpPolygon polygon_2d(roiPts);
+  const vpImage<int> *primitiveIDs = m_useScanLine ? &m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs() : NULL;
   std::vector<double> point_cloud_face, point_cloud_face_custom;
-
-  point_cloud_face.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
-  if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
-    point_cloud_face_custom.reserve((size_t)(3 * bb.getWidth() * bb.getHeight()));
-  }
-
-  bool checkSSE2 = vpCPUFeatures::checkSSE2();
-#if !USE_SSE
-  checkSSE2 = false;
-#else
-  bool push = false;
-  double prev_x, prev_y, prev_z;
+  // Pixel coordinates of the points, needed by the custom plane estimation
+  std::vector<unsigned int> pixels;
+  bool needPixels = m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION;
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+  needPixels = true;
 #endif
+  vpMbtSampleFacePoints(polygon_2d, points, stepY, stepX, mask, primitiveIDs, m_polygon->getIndex(), point_cloud_face,
+                        needPixels ? &pixels : NULL);
 
-  double x = 0.0, y = 0.0;
-  for (unsigned int i = top; i < bottom; i += stepY) {
-    for (unsigned int j = left; j < right; j += stepX) {
-      if (vpMeTracker::inMask(mask, i, j) && point_cloud[i * width + j][2] > 0 &&
-          (m_useScanLine ? (i < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getHeight() &&
-                            j < m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs().getWidth() &&
-                            m_hiddenFace->getMbScanLineRenderer().getPrimitiveIDs()[i][j] == m_polygon->getIndex())
-                         : polygon_2d.isInside(vpImagePoint(i, j)))) {
-        // Add point
-        point_cloud_face.push_back(point_cloud[i * width + j][0]);
-        point_cloud_face.push_back(point_cloud[i * width + j][1]);
-        point_cloud_face.push_back(point_cloud[i * width + j][2]);
-
-        if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
-          // Add point for custom method for plane equation estimation
-          vpPixelMeterConversion::convertPoint(m_cam, j, i, x, y);
-
-          if (checkSSE2) {
-#if USE_SSE
-            if (!push) {
-              push = true;
-              prev_x = x;
-              prev_y = y;
-              prev_z = point_cloud[i * width + j][2];
-            } else {
-              push = false;
-              point_cloud_face_custom.push_back(prev_x);
-              point_cloud_face_custom.push_back(x);
-
-              point_cloud_face_custom.push_back(prev_y);
-              point_cloud_face_custom.push_back(y);
-
-              point_cloud_face_custom.push_back(prev_z);
-              point_cloud_face_custom.push_back(point_cloud[i * width + j][2]);
-            }
-#endif
-          } else {
-            point_cloud_face_custom.push_back(x);
-            point_cloud_face_custom.push_back(y);
-            point_cloud_face_custom.push_back(point_cloud[i * width + j][2]);
-          }
-        }
+  if (point_cloud_face.empty()) {
+    return false;
+  }
 
 #if DEBUG_DISPLAY_DEPTH_NORMAL
-        debugImage[i][j] = 255;
+  for (size_t k = 0; k < pixels.size(); k += 2) {
+    debugImage[pixels[k]][pixels[k + 1]] = 255;
+  }
 #endif
-      }
+
+  if (m_featureEstimationMethod == ROBUST_FEATURE_ESTIMATION) {
+    // Normalized coordinates and depth of the points for the custom method
+    // of plane equation estimation
+    const size_t nbPoints = point_cloud_face.size() / 3;
+    point_cloud_face_custom.resize(3 * nbPoints);
+    double x = 0.0, y = 0.0;
+    for (size_t k = 0; k < nbPoints; k++) {
+      vpPixelMeterConversion::convertPoint(m_cam, pixels[2 * k + 1], pixels[2 * k], x, y);
+      point_cloud_face_custom[3 * k] = x;
+      point_cloud_face_custom[3 * k + 1] = y;
+      point_cloud_face_custom[3 * k + 2] = point_cloud_face[3 * k + 2];
     }
-  }
 
 #if USE_SSE
-  if (checkSSE2 && push) {
-    point_cloud_face_custom.push_back(prev_x);
-    point_cloud_face_custom.push_back(prev_y);
-    point_cloud_face_custom.push_back(prev_z);
-  }
+    if (vpCPUFeatures::checkSSE2()) {
+      // Layout of the points expected by estimateFeatures()
+      vpMbtInterleavePointPairs(point_cloud_face_custom);
+    }
 #endif
-
-  if (point_cloud_face.empty() && point_cloud_face_custom.empty()) {
-    return false;
   }
 
   // Face centroid computed by the different methods
@@ -446,7 +320,9 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
           pcl::PointXYZ(point_cloud_face[3 * i], point_cloud_face[3 * i + 1], point_cloud_face[3 * i + 2]));
     }
 
-    computeDesiredFeaturesPCL(point_cloud_face_pcl, desired_features, desired_normal, centroid_point);
+    if (!computeDesiredFeaturesPCL(point_cloud_face_pcl, desired_features, desired_normal, centroid_point)) {
+      return false;
+    }
   } else
 #endif
       if (m_featureEstimationMethod == ROBUST_SVD_PLANE_ESTIMATION) {
@@ -465,6 +341,35 @@ bool vpMbtFaceDepthNormal::computeDesiredFeatures(const vpHomogeneousMatrix &cMo
   return true;
 }
 
+// Instantiations used by the depth normal tracker
+#ifdef VISP_HAVE_PCL
+template bool vpMbtFaceDepthNormal::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &, const vpMbtPclPointAccessor &,
+                                                               vpColVector &, const unsigned int, const unsigned int
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                               ,
+                                                               vpImage<unsigned char> &,
+                                                               std::vector<std::vector<vpImagePoint> > &
+#endif
+                                                               , const vpImage<bool> *);
+#endif
+template bool vpMbtFaceDepthNormal::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &, const vpMbtVectorPointAccessor &,
+                                                               vpColVector &, const unsigned int, const unsigned int
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                               ,
+                                                               vpImage<unsigned char> &,
+                                                               std::vector<std::vector<vpImagePoint> > &
+#endif
+                                                               , const vpImage<bool> *);
+template bool vpMbtFaceDepthNormal::computeDesiredFeaturesImpl(const vpHomogeneousMatrix &, const vpMbtOrganizedPointAccessor &,
+                                                               vpColVector &, const unsigned int, const unsigned int
+#if DEBUG_DISPLAY_DEPTH_NORMAL
+                                                               ,
+                                                               vpImage<unsigned char> &,
+                                                               std::vector<std::vector<vpImagePoint> > &
+#endif
+                                                               , const vpImage<bool> *);
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 #ifdef VISP_HAVE_PCL
 bool vpMbtFaceDepthNormal::computeDesiredFeaturesPCL(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud_face,
                                                      vpColVector &desired_features, vpColVector &desired_normal,
@@ -0,0 +1,327 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Sampling of the depth points inside a face, shared by the depth features.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMbtFaceDepthSampling_h_
+#define __vpMbtFaceDepthSampling_h_
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpOrganizedPointCloud.h>
+#include <visp3/core/vpPolygon.h>
+#include <visp3/core/vpRect.h>
+#include <visp3/me/vpMeTracker.h>
+
+#ifdef VISP_HAVE_PCL
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Point accessors used to sample the depth points of a face whatever the type
+  of the organized point cloud. getPoint() returns false if the point at
+  pixel (i, j) has no valid depth. getRow() returns the interleaved XYZ
+  coordinates of the row i if they are stored contiguously, NULL otherwise.
+  The accessors only keep a pointer to the point cloud, which is not
+  dereferenced before the first access.
+*/
+
+// Point cloud given as a vector of height x width vpColVector
+class vpMbtVectorPointAccessor
+{
+public:
+  vpMbtVectorPointAccessor(const std::vector<vpColVector> *point_cloud, const unsigned int height,
+                           const unsigned int width)
+    : m_height(height), m_pointCloud(point_cloud), m_width(width)
+  {
+  }
+
+  inline unsigned int getHeight() const { return m_height; }
+  inline unsigned int getWidth() const { return m_width; }
+
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    const vpColVector &point = (*m_pointCloud)[i * m_width + j];
+    Z = point[2];
+    if (!(Z > 0)) {
+      return false;
+    }
+    X = point[0];
+    Y = point[1];
+    return true;
+  }
+
+  inline const double *getRow(const unsigned int) const { return NULL; }
+
+private:
+  unsigned int m_height;
+  const std::vector<vpColVector> *m_pointCloud;
+  unsigned int m_width;
+};
+
+#ifdef VISP_HAVE_PCL
+// Organized PCL point cloud
+class vpMbtPclPointAccessor
+{
+public:
+  explicit vpMbtPclPointAccessor(const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
+    : m_pointCloud(point_cloud.get())
+  {
+  }
+
+  inline unsigned int getHeight() const { return m_pointCloud->height; }
+  inline unsigned int getWidth() const { return m_pointCloud->width; }
+
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    const pcl::PointXYZ &point = (*m_pointCloud)(j, i);
+    if (!pcl::isFinite(point) || !(point.z > 0)) {
+      return false;
+    }
+    X = point.x;
+    Y = point.y;
+    Z = point.z;
+    return true;
+  }
+
+  inline const double *getRow(const unsigned int) const { return NULL; }
+
+private:
+  const pcl::PointCloud<pcl::PointXYZ> *m_pointCloud;
+};
+#endif
+
+// Strided XYZ buffer or depth image wrapped in a vpOrganizedPointCloud
+class vpMbtOrganizedPointAccessor
+{
+public:
+  explicit vpMbtOrganizedPointAccessor(const vpOrganizedPointCloud *point_cloud) : m_pointCloud(point_cloud) {}
+
+  inline unsigned int getHeight() const { return m_pointCloud->getHeight(); }
+  inline unsigned int getWidth() const { return m_pointCloud->getWidth(); }
+
+  inline bool getPoint(const unsigned int i, const unsigned int j, double &X, double &Y, double &Z) const
+  {
+    if (!(m_pointCloud->getDepth(i, j) > 0)) {
+      return false;
+    }
+    m_pointCloud->getPoint(i, j, X, Y, Z);
+    return true;
+  }
+
+  inline const double *getRow(const unsigned int i) const
+  {
+    return m_pointCloud->isDepthView() ? NULL : m_pointCloud->getRow(i);
+  }
+
+private:
+  const vpOrganizedPointCloud *m_pointCloud;
+};
+
+/*
+  Compute the spans [start, end) of the columns of the row \e i where the
+  primitive id of the scan-line renderer is \e primitiveIndex. Only the
+  columns of the sampling grid (left + k * stepX) are tested.
+*/
+inline void vpMbtGetPrimitiveRowSpans(const vpImage<int> &primitiveIDs, const int primitiveIndex, const unsigned int i,
+                                      const unsigned int left, const unsigned int right, const unsigned int stepX,
+                                      std::vector<int> &spans)
+{
+  spans.clear();
+  if (i >= primitiveIDs.getHeight()) {
+    return;
+  }
+
+  const int *const ids = primitiveIDs[i];
+  const unsigned int end = std::min(right, primitiveIDs.getWidth());
+  bool inside = false;
+  unsigned int j = left;
+  for (; j < end; j += stepX) {
+    if ((ids[j] == primitiveIndex) != inside) {
+      spans.push_back((int)j);
+      inside = !inside;
+    }
+  }
+  if (inside) {
+    spans.push_back((int)end);
+  }
+}
+
+/*
+  Sample the points of an organized point cloud that project inside the face
+  polygon \e polygon, on a grid of \e stepY rows and \e stepX columns.
+
+  With scan-line visibility (\e primitiveIDs not NULL), a pixel belongs to
+  the face if its primitive id is \e primitiveIndex, otherwise if it lies
+  inside the polygon. In both cases the face is described row by row by spans
+  of columns, so that no per-pixel membership test is needed. When all the
+  columns are sampled without mask and the point cloud stores its XYZ
+  coordinates contiguously, the points of a span are copied with a single
+  memcpy() and the points without valid depth are then removed in place.
+  Otherwise the points are read one at a time, and the pixels outside
+  \e mask are skipped.
+
+  The coordinates of the valid points are appended to \e xyz (X, Y, Z
+  interleaved) and, if \e pixels is not NULL, their pixel coordinates to
+  \e pixels (i, j interleaved).
+
+  Return the number of pixels of the sampling grid that belong to the face,
+  with or without valid depth.
+*/
+template <class vpPointAccessor>
+unsigned int vpMbtSampleFacePoints(const vpPolygon &polygon, const vpPointAccessor &points, const unsigned int stepY,
+                                   const unsigned int stepX, const vpImage<bool> *mask,
+                                   const vpImage<int> *primitiveIDs, const int primitiveIndex,
+                                   std::vector<double> &xyz, std::vector<unsigned int> *pixels)
+{
+  const unsigned int height = points.getHeight(), width = points.getWidth();
+  const vpRect bb = polygon.getBoundingBox();
+
+  const unsigned int top = (unsigned int)std::max(0.0, bb.getTop());
+  const unsigned int bottom = (unsigned int)std::min((double)height, std::max(0.0, bb.getBottom()));
+  const unsigned int left = (unsigned int)std::max(0.0, bb.getLeft());
+  const unsigned int right = (unsigned int)std::min((double)width, std::max(0.0, bb.getRight()));
+
+  if (top >= bottom || left >= right) {
+    return 0;
+  }
+
+  // Upper bound of the number of points: the sampling grid in the bounding
+  // box. The buffers are sized once and shrunk to the valid points at the end.
+  const size_t nbSamples = (size_t)((right - left + stepX - 1) / stepX) * ((bottom - top + stepY - 1) / stepY);
+  const size_t xyzOffset = xyz.size();
+  xyz.resize(xyzOffset + 3 * nbSamples);
+  double *xyzPtr = &xyz[xyzOffset];
+  size_t pixelsOffset = 0;
+  unsigned int *pixelsPtr = NULL;
+  if (pixels != NULL) {
+    pixelsOffset = pixels->size();
+    pixels->resize(pixelsOffset + 2 * nbSamples);
+    pixelsPtr = &(*pixels)[pixelsOffset];
+  }
+
+  unsigned int nbTheoreticalPoints = 0;
+  size_t nbPoints = 0;
+  std::vector<int> spans;
+  spans.reserve(8);
+  const bool bulkCopy = (stepX == 1 && mask == NULL);
+  for (unsigned int i = top; i < bottom; i += stepY) {
+    const double *const row = bulkCopy ? points.getRow(i) : NULL;
+    if (primitiveIDs == NULL) {
+      // Columns of the pixels inside the projected face along the row
+      polygon.getRowSpans((int)i, (int)left, (int)right, spans);
+    } else {
+      vpMbtGetPrimitiveRowSpans(*primitiveIDs, primitiveIndex, i, left, right, stepX, spans);
+    }
+
+    for (size_t k = 0; k < spans.size(); k += 2) {
+      // Columns of the sampling grid in the span
+      const unsigned int start = left + ((unsigned int)spans[k] - left + stepX - 1) / stepX * stepX;
+      const unsigned int end = (unsigned int)spans[k + 1];
+      if (start >= end) {
+        continue;
+      }
+      nbTheoreticalPoints += (end - start + stepX - 1) / stepX;
+
+      if (row != NULL) {
+        // Copy the whole span, then compact out the points without depth
+        const unsigned int n = end - start;
+        memcpy(xyzPtr, row + 3 * start, 3 * n * sizeof(double));
+        const double *src = xyzPtr;
+        for (unsigned int j = start; j < end; j++, src += 3) {
+          if (src[2] > 0) {
+            if (src != xyzPtr) {
+              xyzPtr[0] = src[0];
+              xyzPtr[1] = src[1];
+              xyzPtr[2] = src[2];
+            }
+            xyzPtr += 3;
+            if (pixelsPtr != NULL) {
+              pixelsPtr[0] = i;
+              pixelsPtr[1] = j;
+              pixelsPtr += 2;
+            }
+            nbPoints++;
+          }
+        }
+        continue;
+      }
+
+      for (unsigned int j = start; j < end; j += stepX) {
+        if (vpMeTracker::inMask(mask, i, j) && points.getPoint(i, j, xyzPtr[0], xyzPtr[1], xyzPtr[2])) {
+          xyzPtr += 3;
+          if (pixelsPtr != NULL) {
+            pixelsPtr[0] = i;
+            pixelsPtr[1] = j;
+            pixelsPtr += 2;
+          }
+          nbPoints++;
+        }
+      }
+    }
+  }
+
+  xyz.resize(xyzOffset + 3 * nbPoints);
+  if (pixels != NULL) {
+    pixels->resize(pixelsOffset + 2 * nbPoints);
+  }
+
+  return nbTheoreticalPoints;
+}
+
+/*
+  Reorder interleaved XYZ coordinates so that each pair of points is stored
+  as (X0, X1, Y0, Y1, Z0, Z1), the layout loaded by the SSE2 code. The last
+  point is kept as (X, Y, Z) if the number of points is odd.
+*/
+inline void vpMbtInterleavePointPairs(std::vector<double> &xyz)
+{
+  for (size_t k = 0; k + 6 <= xyz.size(); k += 6) {
+    double *p = &xyz[k];
+    const double x1 = p[3], y0 = p[1], z0 = p[2];
+    p[1] = x1;
+    p[2] = y0;
+    p[3] = p[4];
+    p[4] = z0;
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
@@ -55,7 +55,7 @@
   Basic constructor
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker()
-  : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(),
+  : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfPyramids(),
     m_referenceCameraName("Camera"), m_L_edgeMulti(), m_error_edgeMulti(), m_w_edgeMulti(), m_weightedError_edgeMulti()
 {
   m_mapOfEdgeTrackers["Camera"] = new vpMbEdgeTracker();
@@ -70,7 +70,7 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker()
   \param nbCameras : Number of cameras to use.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras)
-  : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(),
+  : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfPyramids(),
     m_referenceCameraName("Camera"), m_L_edgeMulti(), m_error_edgeMulti(), m_w_edgeMulti(), m_weightedError_edgeMulti()
 {
 
@@ -114,7 +114,7 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras)
   \param cameraNames : List of camera names.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const std::vector<std::string> &cameraNames)
-  : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(),
+  : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfPyramids(),
     m_referenceCameraName("Camera"), m_L_edgeMulti(), m_error_edgeMulti(), m_w_edgeMulti(), m_weightedError_edgeMulti()
 {
 
@@ -147,18 +147,10 @@ vpMbEdgeMultiTracker::~vpMbEdgeMultiTracker()
 
 void vpMbEdgeMultiTracker::cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char> *> > &pyramid)
 {
+  // The images are owned by m_mapOfPyramids and reused by the next initPyramid()
   for (std::map<std::string, std::vector<const vpImage<unsigned char> *> >::iterator it1 = pyramid.begin();
        it1 != pyramid.end(); ++it1) {
-    if (it1->second.size() > 0) {
-      it1->second[0] = NULL;
-      for (size_t i = 1; i < it1->second.size(); i++) {
-        if (it1->second[i] != NULL) {
-          delete it1->second[i];
-          it1->second[i] = NULL;
-        }
-      }
-      it1->second.clear();
-    }
+    it1->second.clear();
   }
 }
 
@@ -1647,11 +1639,19 @@ void vpMbEdgeMultiTracker::initFromPose(const std::map<std::string, const vpImag
 void vpMbEdgeMultiTracker::initPyramid(const std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                        std::map<std::string, std::vector<const vpImage<unsigned char> *> > &pyramid)
 {
+  // Build the pyramids of the cameras in parallel
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<vpImagePyramid *> pyramids;
   for (std::map<std::string, const vpImage<unsigned char> *>::const_iterator it = mapOfImages.begin();
        it != mapOfImages.end(); ++it) {
-    pyramid[it->first].resize(scales.size());
+    images.push_back(it->second);
+    pyramids.push_back(&m_mapOfPyramids[it->first]);
+  }
+  vpImagePyramid::build(images, scales, pyramids);
 
-    vpMbEdgeTracker::initPyramid(*it->second, pyramid[it->first]);
+  for (std::map<std::string, const vpImage<unsigned char> *>::const_iterator it = mapOfImages.begin();
+       it != mapOfImages.end(); ++it) {
+    m_mapOfPyramids[it->first].getLevels(pyramid[it->first]);
   }
 }
 
@@ -50,6 +50,7 @@
 #include <visp3/core/vpMatrixException.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpPolygon3D.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/mbt/vpMbEdgeTracker.h>
@@ -57,21 +58,216 @@
 #include <visp3/mbt/vpMbtXmlParser.h>
 #include <visp3/vision/vpPose.h>
 
+#include <algorithm>
 #include <float.h>
 #include <limits>
 #include <map>
 #include <sstream>
 #include <string>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+typedef enum { EDGE_TRACK, EDGE_UPDATE, EDGE_INTERACTION } vpEdgeStep;
+
+// Features of the current scale level processed in parallel, and the data
+// shared by the tasks. Each feature only modifies its own state and its own
+// rows of the interaction matrix and of the error vectors.
+struct vpEdgeFeatures {
+  vpEdgeFeatures(vpEdgeStep step_, const vpImage<unsigned char> &I_, const vpHomogeneousMatrix &cMo_,
+                 const vpImage<bool> *mask_)
+    : step(step_), I(&I_), cMo(&cMo_), mask(mask_), lines(), cylinders(), circles(), rows(), typeRows(), L(NULL),
+      error(NULL), errorLines(NULL), errorCylinders(NULL), errorCircles(NULL)
+  {
+  }
+
+  size_t size() const { return lines.size() + cylinders.size() + circles.size(); }
+
+  void copyRows(const vpMatrix &L_, const vpColVector &error_, unsigned int nbRows, size_t k,
+                vpColVector &typeError) const
+  {
+    for (unsigned int i = 0; i < nbRows; i++) {
+      for (unsigned int j = 0; j < 6; j++) {
+        (*L)[rows[k] + i][j] = L_[i][j];
+      }
+      (*error)[rows[k] + i] = error_[i];
+      typeError[typeRows[k] + i] = error_[i];
+    }
+  }
+
+  void process(size_t k) const
+  {
+    const bool doNotTrack = false;
+
+    if (k < lines.size()) {
+      vpMbtDistanceLine *l = lines[k];
+      if (step == EDGE_TRACK) {
+        if (l->meline.empty()) {
+          l->initMovingEdge(*I, *cMo, doNotTrack, mask);
+        }
+        l->trackMovingEdge(*I);
+      } else if (step == EDGE_UPDATE) {
+        l->updateMovingEdge(*I, *cMo);
+        if (l->nbFeatureTotal == 0 && l->isVisible()) {
+          l->Reinit = true;
+        }
+      } else {
+        l->computeInteractionMatrixError(*cMo);
+        copyRows(l->L, l->error, l->nbFeatureTotal, k, *errorLines);
+      }
+    } else if (k < lines.size() + cylinders.size()) {
+      vpMbtDistanceCylinder *cy = cylinders[k - lines.size()];
+      if (step == EDGE_TRACK) {
+        if (cy->meline1 == NULL || cy->meline2 == NULL) {
+          cy->initMovingEdge(*I, *cMo, doNotTrack, mask);
+        }
+        cy->trackMovingEdge(*I, *cMo);
+      } else if (step == EDGE_UPDATE) {
+        cy->updateMovingEdge(*I, *cMo);
+        if ((cy->nbFeaturel1 == 0 || cy->nbFeaturel2 == 0) && cy->isVisible()) {
+          cy->Reinit = true;
+        }
+      } else {
+        cy->computeInteractionMatrixError(*cMo, *I);
+        copyRows(cy->L, cy->error, cy->nbFeature, k, *errorCylinders);
+      }
+    } else {
+      vpMbtDistanceCircle *ci = circles[k - lines.size() - cylinders.size()];
+      if (step == EDGE_TRACK) {
+        if (ci->meEllipse == NULL) {
+          ci->initMovingEdge(*I, *cMo, doNotTrack, mask);
+        }
+        ci->trackMovingEdge(*I, *cMo);
+      } else if (step == EDGE_UPDATE) {
+        ci->updateMovingEdge(*I, *cMo);
+        if (ci->nbFeature == 0 && ci->isVisible()) {
+          ci->Reinit = true;
+        }
+      } else {
+        ci->computeInteractionMatrixError(*cMo);
+        copyRows(ci->L, ci->error, ci->nbFeature, k, *errorCircles);
+      }
+    }
+  }
+
+  vpEdgeStep step;
+  const vpImage<unsigned char> *I;
+  const vpHomogeneousMatrix *cMo;
+  const vpImage<bool> *mask;
+  std::vector<vpMbtDistanceLine *> lines;
+  std::vector<vpMbtDistanceCylinder *> cylinders;
+  std::vector<vpMbtDistanceCircle *> circles;
+  // First row of each feature in the interaction matrix and in the error
+  // vector of its type (EDGE_INTERACTION only)
+  std::vector<unsigned int> rows;
+  std::vector<unsigned int> typeRows;
+  vpMatrix *L;
+  vpColVector *error;
+  vpColVector *errorLines;
+  vpColVector *errorCylinders;
+  vpColVector *errorCircles;
+};
+
+// Process the features first, first + stride, first + 2*stride...
+class vpEdgeFeaturesTask : public vpThreadPool::vpTask
+{
+public:
+  vpEdgeFeaturesTask(const vpEdgeFeatures &features, size_t first, size_t stride)
+    : m_features(&features), m_first(first), m_stride(stride), m_errorIndex(features.size()),
+      m_errorCode(vpException::fatalError), m_errorMessage()
+  {
+  }
+
+  virtual void run()
+  {
+    for (size_t k = m_first; k < m_features->size(); k += m_stride) {
+      try {
+        m_features->process(k);
+      } catch (vpException &e) {
+        if (k < m_errorIndex) {
+          m_errorIndex = k;
+          m_errorCode = e.getCode();
+          m_errorMessage = e.getStringMessage();
+        }
+      }
+    }
+  }
+
+  const vpEdgeFeatures *m_features;
+  size_t m_first;
+  size_t m_stride;
+  // First feature that raised an exception
+  size_t m_errorIndex;
+  int m_errorCode;
+  std::string m_errorMessage;
+};
+
+void gatherEdgeFeatures(const std::list<vpMbtDistanceLine *> &lines,
+                        const std::list<vpMbtDistanceCylinder *> &cylinders,
+                        const std::list<vpMbtDistanceCircle *> &circles, bool visibleOnly, vpEdgeFeatures &features)
+{
+  for (std::list<vpMbtDistanceLine *>::const_iterator it = lines.begin(); it != lines.end(); ++it) {
+    if ((*it)->isTracked() && (!visibleOnly || (*it)->isVisible())) {
+      features.lines.push_back(*it);
+    }
+  }
+  for (std::list<vpMbtDistanceCylinder *>::const_iterator it = cylinders.begin(); it != cylinders.end(); ++it) {
+    if ((*it)->isTracked() && (!visibleOnly || (*it)->isVisible())) {
+      features.cylinders.push_back(*it);
+    }
+  }
+  for (std::list<vpMbtDistanceCircle *>::const_iterator it = circles.begin(); it != circles.end(); ++it) {
+    if ((*it)->isTracked() && (!visibleOnly || (*it)->isVisible())) {
+      features.circles.push_back(*it);
+    }
+  }
+}
+
+// Process all the features on the thread pool. If some features raised an
+// exception, the one of the first of these features is thrown once all the
+// features are processed.
+void processEdgeFeatures(const vpEdgeFeatures &features, int nbThreads)
+{
+  if (features.size() == 0) {
+    return;
+  }
+
+  size_t nbTasks = nbThreads <= 0 ? vpThreadPool::getInstance().getNbThreads() + 1 : (size_t)nbThreads;
+  nbTasks = std::min(nbTasks, features.size());
+
+  std::vector<vpEdgeFeaturesTask> edgeTasks;
+  edgeTasks.reserve(nbTasks);
+  for (size_t i = 0; i < nbTasks; i++) {
+    edgeTasks.push_back(vpEdgeFeaturesTask(features, i, nbTasks));
+  }
+  std::vector<vpThreadPool::vpTask *> tasks(nbTasks);
+  for (size_t i = 0; i < nbTasks; i++) {
+    tasks[i] = &edgeTasks[i];
+  }
+  vpThreadPool::getInstance().run(tasks);
+
+  size_t first_error = 0;
+  for (size_t i = 1; i < nbTasks; i++) {
+    if (edgeTasks[i].m_errorIndex < edgeTasks[first_error].m_errorIndex) {
+      first_error = i;
+    }
+  }
+  if (edgeTasks[first_error].m_errorIndex < features.size()) {
+    throw vpException(edgeTasks[first_error].m_errorCode, edgeTasks[first_error].m_errorMessage);
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Basic constructor
 */
 vpMbEdgeTracker::vpMbEdgeTracker()
   : me(), lines(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0), nbvisiblepolygone(0),
-    percentageGdPt(0.4), scales(1), Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0), m_factor(),
-    m_robustLines(), m_robustCylinders(), m_robustCircles(), m_wLines(), m_wCylinders(), m_wCircles(), m_errorLines(),
-    m_errorCylinders(), m_errorCircles(), m_L_edge(), m_error_edge(), m_w_edge(), m_weightedError_edge(),
-    m_robust_edge()
+    percentageGdPt(0.4), scales(1), Ipyramid(0), m_pyramid(), scaleLevel(0), nbFeaturesForProjErrorComputation(0),
+    m_factor(), m_robustLines(), m_robustCylinders(), m_robustCircles(), m_wLines(), m_wCylinders(), m_wCircles(),
+    m_errorLines(), m_errorCylinders(), m_errorCircles(), m_L_edge(), m_error_edge(), m_w_edge(),
+    m_weightedError_edge(), m_robust_edge(), m_useParallelEdgeTracking(false), m_nbParallelEdgeTrackingThreads(0)
 {
   angleAppears = vpMath::rad(89);
   angleDisappears = vpMath::rad(89);
@@ -777,6 +973,40 @@ void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu()
 
 void vpMbEdgeTracker::computeVVSInteractionMatrixAndResidu(const vpImage<unsigned char> &_I)
 {
+  if (m_useParallelEdgeTracking) {
+    vpEdgeFeatures features(EDGE_INTERACTION, _I, cMo, m_mask);
+    gatherEdgeFeatures(lines[scaleLevel], cylinders[scaleLevel], circles[scaleLevel], false, features);
+    features.rows.resize(features.size());
+    features.typeRows.resize(features.size());
+    unsigned int n = 0, ntype = 0;
+    for (size_t k = 0; k < features.lines.size(); k++) {
+      features.rows[k] = n;
+      features.typeRows[k] = n;
+      n += features.lines[k]->nbFeatureTotal;
+    }
+    for (size_t k = 0; k < features.cylinders.size(); k++) {
+      features.rows[features.lines.size() + k] = n;
+      features.typeRows[features.lines.size() + k] = ntype;
+      n += features.cylinders[k]->nbFeature;
+      ntype += features.cylinders[k]->nbFeature;
+    }
+    ntype = 0;
+    for (size_t k = 0; k < features.circles.size(); k++) {
+      features.rows[features.lines.size() + features.cylinders.size() + k] = n;
+      features.typeRows[features.lines.size() + features.cylinders.size() + k] = ntype;
+      n += features.circles[k]->nbFeature;
+      ntype += features.circles[k]->nbFeature;
+    }
+    features.L = &m_L_edge;
+    features.error = &m_error_edge;
+    features.errorLines = &m_errorLines;
+    features.errorCylinders = &m_errorCylinders;
+    features.errorCircles = &m_errorCircles;
+
+    processEdgeFeatures(features, m_nbParallelEdgeTrackingThreads);
+    return;
+  }
+
   vpMbtDistanceLine *l;
   vpMbtDistanceCylinder *cy;
   vpMbtDistanceCircle *ci;
@@ -1496,6 +1726,13 @@ void vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHo
 */
 void vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 {
+  if (m_useParallelEdgeTracking) {
+    vpEdgeFeatures features(EDGE_TRACK, I, cMo, m_mask);
+    gatherEdgeFeatures(lines[scaleLevel], cylinders[scaleLevel], circles[scaleLevel], true, features);
+    processEdgeFeatures(features, m_nbParallelEdgeTrackingThreads);
+    return;
+  }
+
   const bool doNotTrack = false;
 
   for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
@@ -1539,6 +1776,13 @@ void vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
 */
 void vpMbEdgeTracker::updateMovingEdge(const vpImage<unsigned char> &I)
 {
+  if (m_useParallelEdgeTracking) {
+    vpEdgeFeatures features(EDGE_UPDATE, I, cMo, m_mask);
+    gatherEdgeFeatures(lines[scaleLevel], cylinders[scaleLevel], circles[scaleLevel], false, features);
+    processEdgeFeatures(features, m_nbParallelEdgeTrackingThreads);
+    return;
+  }
+
   vpMbtDistanceLine *l;
   for (std::list<vpMbtDistanceLine *>::const_iterator it = lines[scaleLevel].begin(); it != lines[scaleLevel].end();
        ++it) {
@@ -2571,14 +2815,13 @@ void vpMbEdgeTracker::setClipping(const unsigned int &flags)
 /*!
   Compute the pyramid of image associated to the image in parameter. The
   scales computed are the ones corresponding to the scales  attribute of the
-  class. If OpenCV is detected, the functions used to computed a smoothed
-  pyramid come from OpenCV, otherwise a simple subsampling (no smoothing, no
-  interpolation) is realized.
+  class. Each level is an anti-aliased 2x reduction of the previous one (see
+  vpImagePyramid::downScale2()).
 
-  \warning The pyramid contains pointers to vpImage. To properly deallocate
-  the pyramid. All the element but the first (which is a pointer to the input
-  image) must be freed. A proper cleaning is implemented in the cleanPyramid()
-  method.
+  The images of the pyramid are stored in the tracker and their buffers are
+  reused by the next call, so that no memory is allocated while the size of
+  the images doesn't change. The pointers in \e _pyramid remain valid until
+  the next call.
 
   \param _I : The input image.
   \param _pyramid : The pyramid of image to build from the input image.
@@ -2586,61 +2829,18 @@ void vpMbEdgeTracker::setClipping(const unsigned int &flags)
 void vpMbEdgeTracker::initPyramid(const vpImage<unsigned char> &_I,
                                   std::vector<const vpImage<unsigned char> *> &_pyramid)
 {
-  _pyramid.resize(scales.size());
-
-  if (scales[0]) {
-    _pyramid[0] = &_I;
-  } else {
-    _pyramid[0] = NULL;
-  }
-
-  for (unsigned int i = 1; i < _pyramid.size(); i += 1) {
-    if (scales[i]) {
-      unsigned int cScale = static_cast<unsigned int>(pow(2., (int)i));
-      vpImage<unsigned char> *I = new vpImage<unsigned char>(_I.getHeight() / cScale, _I.getWidth() / cScale);
-#if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408))
-      IplImage *vpI0 = cvCreateImageHeader(cvSize((int)_I.getWidth(), (int)_I.getHeight()), IPL_DEPTH_8U, 1);
-      vpI0->imageData = (char *)(_I.bitmap);
-      IplImage *vpI =
-          cvCreateImage(cvSize((int)(_I.getWidth() / cScale), (int)(_I.getHeight() / cScale)), IPL_DEPTH_8U, 1);
-      cvResize(vpI0, vpI, CV_INTER_NN);
-      vpImageConvert::convert(vpI, *I);
-      cvReleaseImage(&vpI);
-      vpI0->imageData = NULL;
-      cvReleaseImageHeader(&vpI0);
-#else
-      for (unsigned int k = 0, ii = 0; k < I->getHeight(); k += 1, ii += cScale) {
-        for (unsigned int l = 0, jj = 0; l < I->getWidth(); l += 1, jj += cScale) {
-          (*I)[k][l] = _I[ii][jj];
-        }
-      }
-#endif
-      _pyramid[i] = I;
-    } else {
-      _pyramid[i] = NULL;
-    }
-  }
+  m_pyramid.build(_I, scales);
+  m_pyramid.getLevels(_pyramid);
 }
 
 /*!
-  Clean the pyramid of image allocated with the initPyramid() method. The
-  vector has a size equal to zero at the end of the method.
+  Clean the pyramid of image computed with the initPyramid() method. The
+  vector has a size equal to zero at the end of the method. The buffers of
+  the images are kept to be reused by the next call to initPyramid().
 
   \param _pyramid : The pyramid of image to clean.
 */
-void vpMbEdgeTracker::cleanPyramid(std::vector<const vpImage<unsigned char> *> &_pyramid)
-{
-  if (_pyramid.size() > 0) {
-    _pyramid[0] = NULL;
-    for (unsigned int i = 1; i < _pyramid.size(); i += 1) {
-      if (_pyramid[i] != NULL) {
-        delete _pyramid[i];
-        _pyramid[i] = NULL;
-      }
-    }
-    _pyramid.resize(0);
-  }
-}
+void vpMbEdgeTracker::cleanPyramid(std::vector<const vpImage<unsigned char> *> &_pyramid) { _pyramid.clear(); }
 
 /*!
   Get the list of the lines tracked for the specified level. Each line
@@ -160,7 +160,12 @@ void vpMbKltTracker::reinit(const vpImage<unsigned char> &I)
   c0Mo = cMo;
   ctTc0.eye();
 
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+  // Header on I without copy, vpKltOpencv keeps its own copy in its pyramid
+  vpImageConvert::convert(I, cur, false);
+#else
   vpImageConvert::convert(I, cur);
+#endif
 
   cam.computeFov(I.getWidth(), I.getHeight());
 
@@ -545,11 +550,11 @@ void vpMbKltTracker::setPose(const vpImage<unsigned char> &I, const vpHomogeneou
       }
     }
 
-    vpImageConvert::convert(I, cur);
-
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+    vpImageConvert::convert(I, cur, false);
     tracker.setInitialGuess(init_pts, guess_pts, init_ids);
 #else
+    vpImageConvert::convert(I, cur);
     tracker.setInitialGuess(&init_pts, &guess_pts, init_ids, iter_pts);
 
     if (init_pts)
@@ -636,7 +641,11 @@ void vpMbKltTracker::initFaceFromLines(vpMbtPolygon &polygon)
 */
 void vpMbKltTracker::preTracking(const vpImage<unsigned char> &I)
 {
+#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
+  vpImageConvert::convert(I, cur, false);
+#else
   vpImageConvert::convert(I, cur);
+#endif
   tracker.track(cur);
 
   m_nbInfos = 0;
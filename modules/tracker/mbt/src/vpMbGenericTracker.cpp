@@ -35,14 +35,172 @@
 
 #include <visp3/mbt/vpMbGenericTracker.h>
 
+#include "depth/vpMbtFaceDepthSampling.h"
+
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/mbt/vpMbtXmlGenericParser.h>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Task running one step of the tracking pipeline of a single camera.
+  Exceptions are caught and stored, and rethrown by runCameraTasks() in the
+  camera order so that the behaviour matches the sequential processing.
+*/
+class vpMbGenericTracker::CameraTask : public vpThreadPool::vpTask
+{
+public:
+  typedef enum {
+    PRE_TRACKING,
+    PRE_TRACKING_ORGANIZED,
+#ifdef VISP_HAVE_PCL
+    PRE_TRACKING_PCL,
+    POST_TRACKING_PCL,
+#endif
+    POST_TRACKING,
+    VVS_INIT,
+    VVS_INTERACTION,
+    VVS_WEIGHTS
+  } vpCameraStep;
+
+  CameraTask(const vpCameraStep step, TrackerWrapper *const tracker, const vpImage<unsigned char> *const I = NULL)
+    : m_step(step), m_tracker(tracker), m_I(I), m_pointCloud(NULL), m_organizedPointCloud(NULL), m_width(0),
+      m_height(0),
+#ifdef VISP_HAVE_PCL
+      m_pclPointCloud(),
+#endif
+      m_hasError(false), m_isTrackingException(false), m_errorCode(vpException::fatalError), m_errorMessage()
+  {
+  }
+
+  virtual void run()
+  {
+    try {
+      switch (m_step) {
+      case PRE_TRACKING:
+        m_tracker->preTracking(m_I, m_pointCloud, m_width, m_height);
+        break;
+      case PRE_TRACKING_ORGANIZED:
+        m_tracker->preTracking(m_I, m_organizedPointCloud);
+        break;
+#ifdef VISP_HAVE_PCL
+      case PRE_TRACKING_PCL:
+        m_tracker->preTracking(m_I, m_pclPointCloud);
+        break;
+      case POST_TRACKING_PCL:
+        m_tracker->postTracking(m_I, m_pclPointCloud);
+        break;
+#endif
+      case POST_TRACKING:
+        m_tracker->postTracking(m_I, m_width, m_height);
+        break;
+      case VVS_INIT:
+        m_tracker->computeVVSInit(m_I);
+        break;
+      case VVS_INTERACTION:
+        m_tracker->computeVVSInteractionMatrixAndResidu(m_I);
+        break;
+      case VVS_WEIGHTS:
+        m_tracker->computeVVSWeights();
+        break;
+      }
+    } catch (vpTrackingException &e) {
+      m_hasError = true;
+      m_isTrackingException = true;
+      m_errorCode = e.getCode();
+      m_errorMessage = e.getStringMessage();
+    } catch (vpException &e) {
+      m_hasError = true;
+      m_errorCode = e.getCode();
+      m_errorMessage = e.getStringMessage();
+    }
+  }
+
+  vpCameraStep m_step;
+  TrackerWrapper *m_tracker;
+  const vpImage<unsigned char> *m_I;
+  const std::vector<vpColVector> *m_pointCloud;
+  const vpOrganizedPointCloud *m_organizedPointCloud;
+  unsigned int m_width;
+  unsigned int m_height;
+#ifdef VISP_HAVE_PCL
+  pcl::PointCloud<pcl::PointXYZ>::ConstPtr m_pclPointCloud;
+#endif
+  bool m_hasError;
+  bool m_isTrackingException;
+  int m_errorCode;
+  std::string m_errorMessage;
+};
+
+namespace
+{
+// Accumulate the terms of the weighted norm of the residual of a block of
+// features, with the weights w[i] * factor
+void computeVVSResidualNorm(const vpColVector &error, const vpColVector &w, const double factor, double &num,
+                            double &den)
+{
+  for (unsigned int i = 0; i < error.getRows(); i++) {
+    double wi = w[i] * factor;
+    num += wi * vpMath::sqr(error[i]);
+    den += wi;
+  }
+}
+
+// Add the unweighted normal matrix J^T J of a block of features to JTJ
+void accumulateJTJ(const vpMatrix &J, vpMatrix &JTJ)
+{
+  for (unsigned int i = 0; i < J.getRows(); i++) {
+    const double *Ji = J[i];
+    for (unsigned int r = 0; r < 6; r++) {
+      for (unsigned int c = 0; c < 6; c++) {
+        JTJ[r][c] += Ji[r] * Ji[c];
+      }
+    }
+  }
+}
+
+// Express the normal equations (JTJ, JTR) of a camera in the reference camera
+// frame and add them to (LTL, LTR): LTL += cVo^T JTJ cVo and LTR += cVo^T JTR
+void addNormalEquations(const vpVelocityTwistMatrix &cVo, const vpMatrix &JTJ, const vpColVector &JTR, vpMatrix &LTL,
+                        vpColVector &LTR)
+{
+  double JTJV[6][6];
+  for (unsigned int r = 0; r < 6; r++) {
+    for (unsigned int c = 0; c < 6; c++) {
+      double ssum = 0;
+      for (unsigned int k = 0; k < 6; k++) {
+        ssum += JTJ[r][k] * cVo[k][c];
+      }
+      JTJV[r][c] = ssum;
+    }
+  }
+
+  for (unsigned int r = 0; r < 6; r++) {
+    for (unsigned int c = 0; c < 6; c++) {
+      double ssum = 0;
+      for (unsigned int k = 0; k < 6; k++) {
+        ssum += cVo[k][r] * JTJV[k][c];
+      }
+      LTL[r][c] += ssum;
+    }
+
+    double ssum = 0;
+    for (unsigned int k = 0; k < 6; k++) {
+      ssum += cVo[k][r] * JTR[k];
+    }
+    LTR[r] += ssum;
+  }
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 vpMbGenericTracker::vpMbGenericTracker()
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelCameraTracking(false), m_accumulateNormalEquations(false), m_LTL_camera(6, 6),
+    m_LTR_camera(6)
 {
   m_mapOfTrackers["Camera"] = new TrackerWrapper(EDGE_TRACKER);
 
@@ -62,7 +220,9 @@ vpMbGenericTracker::vpMbGenericTracker()
 
 vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int trackerType)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelCameraTracking(false), m_accumulateNormalEquations(false), m_LTL_camera(6, 6),
+    m_LTR_camera(6)
 {
   if (nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot use no camera!");
@@ -98,7 +258,9 @@ vpMbGenericTracker::vpMbGenericTracker(const unsigned int nbCameras, const int t
 
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelCameraTracking(false), m_accumulateNormalEquations(false), m_LTL_camera(6, 6),
+    m_LTR_camera(6)
 {
   if (trackerTypes.empty()) {
     throw vpException(vpException::badValue, "There is no camera!");
@@ -137,7 +299,9 @@ vpMbGenericTracker::vpMbGenericTracker(const std::vector<int> &trackerTypes)
 vpMbGenericTracker::vpMbGenericTracker(const std::vector<std::string> &cameraNames,
                                        const std::vector<int> &trackerTypes)
   : m_error(), m_L(), m_mapOfCameraTransformationMatrix(), m_mapOfFeatureFactors(), m_mapOfTrackers(),
-    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError()
+    m_percentageGdPt(0.4), m_referenceCameraName("Camera"), m_thresholdOutlier(0.5), m_w(), m_weightedError(),
+    m_useParallelCameraTracking(false), m_accumulateNormalEquations(false), m_LTL_camera(6, 6),
+    m_LTR_camera(6)
 {
   if (cameraNames.size() != trackerTypes.size() || cameraNames.empty()) {
     throw vpException(vpTrackingException::badValue,
@@ -287,6 +451,10 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
   double factorDepth = m_mapOfFeatureFactors[DEPTH_NORMAL_TRACKER];
   double factorDepthDense = m_mapOfFeatureFactors[DEPTH_DENSE_TRACKER];
 
+  // The covariance needs the stacked and weighted interaction matrix
+  const bool accumulateNormalEquations = m_accumulateNormalEquations && !computeCovariance;
+  vpColVector edgeWeights;
+
   while (std::fabs(normRes_1 - normRes) > m_stopCriteriaEpsilon && (iter < m_maxIter)) {
     computeVVSInteractionMatrixAndResidu(mapOfImages, mapOfVelocityTwist);
 
@@ -332,7 +500,41 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
           cVo.buildFrom(cMo);
 
           vpMatrix K; // kernel
-          unsigned int rank = (m_L * cVo).kernel(K);
+          unsigned int rank = 0;
+          if (accumulateNormalEquations) {
+            // L^T L has the same kernel as the stacked interaction matrix L,
+            // and its singular values are the squares of the ones of L
+            LTL.resize(6, 6, true);
+            LTR.resize(6, true);
+            for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+                 it != m_mapOfTrackers.end(); ++it) {
+              TrackerWrapper *tracker = it->second;
+              m_LTL_camera = 0;
+              m_LTR_camera = 0;
+
+              if (tracker->m_trackerType & EDGE_TRACKER) {
+                accumulateJTJ(tracker->m_L_edge, m_LTL_camera);
+              }
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+              if (tracker->m_trackerType & KLT_TRACKER) {
+                accumulateJTJ(tracker->m_L_klt, m_LTL_camera);
+              }
+#endif
+              if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+                accumulateJTJ(tracker->m_L_depthNormal, m_LTL_camera);
+              }
+              if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
+                accumulateJTJ(tracker->m_L_depthDense, m_LTL_camera);
+              }
+
+              addNormalEquations(mapOfVelocityTwist[it->first], m_LTL_camera, m_LTR_camera, LTL, LTR);
+            }
+
+            vpMatrix V(cVo);
+            rank = (V.transpose() * LTL * V).kernel(K, 1e-12);
+          } else {
+            rank = (m_L * cVo).kernel(K);
+          }
           if (rank == 0) {
             throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
           }
@@ -351,86 +553,136 @@ void vpMbGenericTracker::computeVVS(std::map<std::string, const vpImage<unsigned
       double num = 0;
       double den = 0;
 
-      unsigned int start_index = 0;
-      for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-           it != m_mapOfTrackers.end(); ++it) {
-        TrackerWrapper *tracker = it->second;
+      if (accumulateNormalEquations) {
+        LTL.resize(6, 6, true);
+        LTR.resize(6, true);
 
-        if (tracker->m_trackerType & EDGE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
-            double wi = tracker->m_w_edge[i] * tracker->m_factor[i] * factorEdge;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
+        for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+             it != m_mapOfTrackers.end(); ++it) {
+          TrackerWrapper *tracker = it->second;
+          m_LTL_camera = 0;
+          m_LTR_camera = 0;
 
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
-
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
+          if (tracker->m_trackerType & EDGE_TRACKER) {
+            edgeWeights.resize(tracker->m_error_edge.getRows(), false);
+            for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
+              edgeWeights[i] = tracker->m_w_edge[i] * tracker->m_factor[i];
             }
+            computeVVSResidualNorm(tracker->m_error_edge, edgeWeights, factorEdge, num, den);
+            accumulateJTWJ(tracker->m_L_edge, tracker->m_error_edge, edgeWeights, factorEdge, m_LTL_camera,
+                           m_LTR_camera);
           }
 
-          start_index += tracker->m_error_edge.getRows();
-        }
-
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-        if (tracker->m_trackerType & KLT_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_klt.getRows(); i++) {
-            double wi = tracker->m_w_klt[i] * factorKlt;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
+          if (tracker->m_trackerType & KLT_TRACKER) {
+            computeVVSResidualNorm(tracker->m_error_klt, tracker->m_w_klt, factorKlt, num, den);
+            accumulateJTWJ(tracker->m_L_klt, tracker->m_error_klt, tracker->m_w_klt, factorKlt, m_LTL_camera,
+                           m_LTR_camera);
+          }
+#endif
 
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
+          if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+            computeVVSResidualNorm(tracker->m_error_depthNormal, tracker->m_w_depthNormal, factorDepth, num, den);
+            accumulateJTWJ(tracker->m_L_depthNormal, tracker->m_error_depthNormal, tracker->m_w_depthNormal,
+                           factorDepth, m_LTL_camera, m_LTR_camera);
+          }
 
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
-            }
+          if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
+            computeVVSResidualNorm(tracker->m_error_depthDense, tracker->m_w_depthDense, factorDepthDense, num,
+                                   den);
+            accumulateJTWJ(tracker->m_L_depthDense, tracker->m_error_depthDense, tracker->m_w_depthDense,
+                           factorDepthDense, m_LTL_camera, m_LTR_camera);
           }
 
-          start_index += tracker->m_error_klt.getRows();
+          addNormalEquations(mapOfVelocityTwist[it->first], m_LTL_camera, m_LTR_camera, LTL, LTR);
         }
-#endif
-
-        if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthNormal.getRows(); i++) {
-            double wi = tracker->m_w_depthNormal[i] * factorDepth;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
 
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
+        normRes_1 = normRes;
+        normRes = sqrt(num / den);
 
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
+        computeVVSPoseEstimationFromJTWJ(isoJoIdentity_, iter, LTL, LTR, m_error, error_prev, mu, v);
+      } else {
+        unsigned int start_index = 0;
+        for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+             it != m_mapOfTrackers.end(); ++it) {
+          TrackerWrapper *tracker = it->second;
+
+          if (tracker->m_trackerType & EDGE_TRACKER) {
+            for (unsigned int i = 0; i < tracker->m_error_edge.getRows(); i++) {
+              double wi = tracker->m_w_edge[i] * tracker->m_factor[i] * factorEdge;
+              W_true[start_index + i] = wi;
+              m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+              num += wi * vpMath::sqr(m_error[start_index + i]);
+              den += wi;
+
+              for (unsigned int j = 0; j < m_L.getCols(); j++) {
+                m_L[start_index + i][j] *= wi;
+              }
             }
+
+            start_index += tracker->m_error_edge.getRows();
           }
 
-          start_index += tracker->m_error_depthNormal.getRows();
-        }
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+          if (tracker->m_trackerType & KLT_TRACKER) {
+            for (unsigned int i = 0; i < tracker->m_error_klt.getRows(); i++) {
+              double wi = tracker->m_w_klt[i] * factorKlt;
+              W_true[start_index + i] = wi;
+              m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+              num += wi * vpMath::sqr(m_error[start_index + i]);
+              den += wi;
+
+              for (unsigned int j = 0; j < m_L.getCols(); j++) {
+                m_L[start_index + i][j] *= wi;
+              }
+            }
 
-        if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
-          for (unsigned int i = 0; i < tracker->m_error_depthDense.getRows(); i++) {
-            double wi = tracker->m_w_depthDense[i] * factorDepthDense;
-            W_true[start_index + i] = wi;
-            m_weightedError[start_index + i] = wi * m_error[start_index + i];
+            start_index += tracker->m_error_klt.getRows();
+          }
+#endif
+
+          if (tracker->m_trackerType & DEPTH_NORMAL_TRACKER) {
+            for (unsigned int i = 0; i < tracker->m_error_depthNormal.getRows(); i++) {
+              double wi = tracker->m_w_depthNormal[i] * factorDepth;
+              W_true[start_index + i] = wi;
+              m_weightedError[start_index + i] = wi * m_error[start_index + i];
 
-            num += wi * vpMath::sqr(m_error[start_index + i]);
-            den += wi;
+              num += wi * vpMath::sqr(m_error[start_index + i]);
+              den += wi;
 
-            for (unsigned int j = 0; j < m_L.getCols(); j++) {
-              m_L[start_index + i][j] *= wi;
+              for (unsigned int j = 0; j < m_L.getCols(); j++) {
+                m_L[start_index + i][j] *= wi;
+              }
             }
+
+            start_index += tracker->m_error_depthNormal.getRows();
           }
 
-          start_index += tracker->m_error_depthDense.getRows();
+          if (tracker->m_trackerType & DEPTH_DENSE_TRACKER) {
+            for (unsigned int i = 0; i < tracker->m_error_depthDense.getRows(); i++) {
+              double wi = tracker->m_w_depthDense[i] * factorDepthDense;
+              W_true[start_index + i] = wi;
+              m_weightedError[start_index + i] = wi * m_error[start_index + i];
+
+              num += wi * vpMath::sqr(m_error[start_index + i]);
+              den += wi;
+
+              for (unsigned int j = 0; j < m_L.getCols(); j++) {
+                m_L[start_index + i][j] *= wi;
+              }
+            }
+
+            start_index += tracker->m_error_depthDense.getRows();
+          }
         }
-      }
 
-      normRes_1 = normRes;
-      normRes = sqrt(num / den);
+        normRes_1 = normRes;
+        normRes = sqrt(num / den);
 
-      computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
+        computeVVSPoseEstimation(isoJoIdentity_, iter, m_L, LTL, m_weightedError, m_error, error_prev, LTR, mu, v);
+      }
 
       cMo_prev = cMo;
 
@@ -478,16 +730,38 @@ void vpMbGenericTracker::computeVVSInit()
 void vpMbGenericTracker::computeVVSInit(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages)
 {
   unsigned int nbFeatures = 0;
+  // The stacked interaction matrices are not needed when the normal equations
+  // are accumulated per block of features
+  const bool stackInteractionMatrix = !m_accumulateNormalEquations || computeCovariance;
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    it->second->m_stackInteractionMatrix = stackInteractionMatrix;
+  }
+
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      tasks.push_back(CameraTask(CameraTask::VVS_INIT, it->second, mapOfImages[it->first]));
+    }
+    runCameraTasks(tasks);
+  }
 
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
-    tracker->computeVVSInit(mapOfImages[it->first]);
+    if (!m_useParallelCameraTracking) {
+      tracker->computeVVSInit(mapOfImages[it->first]);
+    }
 
     nbFeatures += tracker->m_error.getRows();
   }
 
-  m_L.resize(nbFeatures, 6, false, false);
+  if (stackInteractionMatrix) {
+    m_L.resize(nbFeatures, 6, false, false);
+  } else {
+    m_L.resize(0, 0);
+  }
   m_error.resize(nbFeatures, false);
 
   m_weightedError.resize(nbFeatures, false);
@@ -508,6 +782,35 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
 {
   unsigned int start_index = 0;
 
+  if (m_useParallelCameraTracking) {
+    // Only the stacking of the per-camera systems is sequential
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      TrackerWrapper *tracker = it->second;
+
+      tracker->cMo = m_mapOfCameraTransformationMatrix[it->first] * cMo;
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+      tracker->ctTc0 = m_mapOfCameraTransformationMatrix[it->first] * cMo * tracker->c0Mo.inverse();
+#endif
+      tasks.push_back(CameraTask(CameraTask::VVS_INTERACTION, tracker, mapOfImages[it->first]));
+    }
+    runCameraTasks(tasks);
+
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      TrackerWrapper *tracker = it->second;
+
+      if (tracker->m_stackInteractionMatrix) {
+        m_L.insert(tracker->m_L * mapOfVelocityTwist[it->first], start_index, 0);
+      }
+      m_error.insert(start_index, tracker->m_error);
+
+      start_index += tracker->m_error.getRows();
+    }
+    return;
+  }
+
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
@@ -520,7 +823,9 @@ void vpMbGenericTracker::computeVVSInteractionMatrixAndResidu(
 
     tracker->computeVVSInteractionMatrixAndResidu(mapOfImages[it->first]);
 
-    m_L.insert(tracker->m_L * mapOfVelocityTwist[it->first], start_index, 0);
+    if (tracker->m_stackInteractionMatrix) {
+      m_L.insert(tracker->m_L * mapOfVelocityTwist[it->first], start_index, 0);
+    }
     m_error.insert(start_index, tracker->m_error);
 
     start_index += tracker->m_error.getRows();
@@ -531,10 +836,21 @@ void vpMbGenericTracker::computeVVSWeights()
 {
   unsigned int start_index = 0;
 
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      tasks.push_back(CameraTask(CameraTask::VVS_WEIGHTS, it->second));
+    }
+    runCameraTasks(tasks);
+  }
+
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
-    tracker->computeVVSWeights();
+    if (!m_useParallelCameraTracking) {
+      tracker->computeVVSWeights();
+    }
 
     m_w.insert(start_index, tracker->m_w);
     start_index += tracker->m_w.getRows();
@@ -2244,6 +2560,18 @@ void vpMbGenericTracker::loadModel(const std::map<std::string, std::string> &map
 void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
                                      std::map<std::string, pcl::PointCloud<pcl::PointXYZ>::ConstPtr> &mapOfPointClouds)
 {
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      CameraTask task(CameraTask::PRE_TRACKING_PCL, it->second, mapOfImages[it->first]);
+      task.m_pclPointCloud = mapOfPointClouds[it->first];
+      tasks.push_back(task);
+    }
+    runCameraTasks(tasks);
+    return;
+  }
+
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
@@ -2257,6 +2585,20 @@ void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigne
                                      std::map<std::string, unsigned int> &mapOfPointCloudWidths,
                                      std::map<std::string, unsigned int> &mapOfPointCloudHeights)
 {
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      CameraTask task(CameraTask::PRE_TRACKING, it->second, mapOfImages[it->first]);
+      task.m_pointCloud = mapOfPointClouds[it->first];
+      task.m_width = mapOfPointCloudWidths[it->first];
+      task.m_height = mapOfPointCloudHeights[it->first];
+      tasks.push_back(task);
+    }
+    runCameraTasks(tasks);
+    return;
+  }
+
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
@@ -2265,6 +2607,28 @@ void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigne
   }
 }
 
+void vpMbGenericTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                                     std::map<std::string, const vpOrganizedPointCloud *> &mapOfPointClouds)
+{
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      CameraTask task(CameraTask::PRE_TRACKING_ORGANIZED, it->second, mapOfImages[it->first]);
+      task.m_organizedPointCloud = mapOfPointClouds[it->first];
+      tasks.push_back(task);
+    }
+    runCameraTasks(tasks);
+    return;
+  }
+
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->preTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+  }
+}
+
 /*!
   Re-initialize the model used by the tracker.
 
@@ -3520,6 +3884,24 @@ void vpMbGenericTracker::setNearClippingDistance(const std::map<std::string, dou
   }
 }
 
+/*!
+  Set if the normal equations of the virtual visual servoing have to be
+  accumulated directly from the interaction matrix of each block of features
+  (edges, KLT points, depth normal and dense depth features of each camera).
+  The global interaction matrix of all the features is then neither stacked
+  nor weighted at each iteration, which reduces the memory traffic when there
+  are many features, e.g. with the dense depth tracker.
+
+  The estimated pose is the same as with the stacked interaction matrix, up
+  to the floating-point rounding errors.
+
+  \param flag : True to accumulate the normal equations.
+
+  \note The stacked interaction matrix is still used when the covariance
+  matrix is computed (see setCovarianceComputation()).
+*/
+void vpMbGenericTracker::setNormalEquationsAccumulation(const bool flag) { m_accumulateNormalEquations = flag; }
+
 /*!
   Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -3910,6 +4292,46 @@ void vpMbGenericTracker::setUseEdgeTracking(const std::string &name, const bool
   }
 }
 
+/*!
+  Enable or disable the parallel processing of the edge features (lines,
+  cylinders and circles) of each camera.
+
+  \param parallel : True to process the edge features in parallel.
+  \param nbThreads : Number of parallel tasks per camera. If 0 or less, one
+  task is created per thread of vpThreadPool::getInstance().
+
+  \note This function will set the new parameter for all the cameras.
+
+  \sa vpMbEdgeTracker::setUseParallelEdgeTracking()
+*/
+void vpMbGenericTracker::setUseParallelEdgeTracking(const bool parallel, const int nbThreads)
+{
+  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+       it != m_mapOfTrackers.end(); ++it) {
+    TrackerWrapper *tracker = it->second;
+    tracker->setUseParallelEdgeTracking(parallel);
+    tracker->setNbParallelEdgeTrackingThreads(nbThreads);
+  }
+}
+
+/*!
+  Set if the cameras have to be processed concurrently. When enabled, the
+  pre-tracking, the computation of the interaction matrix, residual and
+  weights of each camera during the virtual visual servoing, and the
+  post-tracking are run in parallel on the vpThreadPool, one task per camera.
+  Only the stacking of the per-camera systems and the pose update are
+  sequential, so that the estimated pose is the same as with the sequential
+  processing.
+
+  \param parallel : True to process the cameras concurrently.
+
+  \note The cameras that display their features (see setDisplayFeatures())
+  in an image attached to a display are processed by the calling thread.
+
+  \sa setUseParallelEdgeTracking()
+*/
+void vpMbGenericTracker::setUseParallelCameraTracking(const bool parallel) { m_useParallelCameraTracking = parallel; }
+
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 /*!
   Set if the polygon that has the given name has to be considered during
@@ -4069,11 +4491,22 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
 
   testTracking();
 
-  for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
-       it != m_mapOfTrackers.end(); ++it) {
-    TrackerWrapper *tracker = it->second;
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      CameraTask task(CameraTask::POST_TRACKING_PCL, it->second, mapOfImages[it->first]);
+      task.m_pclPointCloud = mapOfPointClouds[it->first];
+      tasks.push_back(task);
+    }
+    runCameraTasks(tasks);
+  } else {
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      TrackerWrapper *tracker = it->second;
 
-    tracker->postTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+      tracker->postTracking(mapOfImages[it->first], mapOfPointClouds[it->first]);
+    }
   }
 
   computeProjectionError();
@@ -4133,19 +4566,134 @@ void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char
 
   testTracking();
 
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      CameraTask task(CameraTask::POST_TRACKING, it->second, mapOfImages[it->first]);
+      task.m_width = mapOfPointCloudWidths[it->first];
+      task.m_height = mapOfPointCloudHeights[it->first];
+      tasks.push_back(task);
+    }
+    runCameraTasks(tasks);
+  } else {
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      TrackerWrapper *tracker = it->second;
+
+      tracker->postTracking(mapOfImages[it->first], mapOfPointCloudWidths[it->first],
+                            mapOfPointCloudHeights[it->first]);
+    }
+  }
+
+  computeProjectionError();
+}
+
+/*!
+  Realize the tracking of the object in the image.
+
+  \throw vpException : if the tracking is supposed to have failed
+
+  \param mapOfImages : Map of images.
+  \param mapOfPointClouds : Map of organized pointclouds, that can be views on
+  the raw depth images to avoid any conversion.
+*/
+void vpMbGenericTracker::track(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
+                               std::map<std::string, const vpOrganizedPointCloud *> &mapOfPointClouds)
+{
   for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
        it != m_mapOfTrackers.end(); ++it) {
     TrackerWrapper *tracker = it->second;
 
-    tracker->postTracking(mapOfImages[it->first], mapOfPointCloudWidths[it->first], mapOfPointCloudHeights[it->first]);
+    if ((tracker->m_trackerType & (EDGE_TRACKER |
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+                                   KLT_TRACKER |
+#endif
+                                   DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER)) == 0) {
+      throw vpException(vpException::fatalError, "Bad tracker type: %d", tracker->m_trackerType);
+    }
+
+    if (tracker->m_trackerType & (EDGE_TRACKER
+#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
+                                  | KLT_TRACKER
+#endif
+                                  ) &&
+        mapOfImages[it->first] == NULL) {
+      throw vpException(vpException::fatalError, "Image pointer is NULL!");
+    }
+
+    if (tracker->m_trackerType & (DEPTH_NORMAL_TRACKER | DEPTH_DENSE_TRACKER) &&
+        (mapOfPointClouds[it->first] == NULL)) {
+      throw vpException(vpException::fatalError, "Pointcloud is NULL!");
+    }
+  }
+
+  preTracking(mapOfImages, mapOfPointClouds);
+
+  try {
+    computeVVS(mapOfImages);
+  } catch (...) {
+    covarianceMatrix = -1;
+    throw; // throw the original exception
+  }
+
+  testTracking();
+
+  if (m_useParallelCameraTracking) {
+    std::vector<CameraTask> tasks;
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      const vpOrganizedPointCloud *point_cloud = mapOfPointClouds[it->first];
+      CameraTask task(CameraTask::POST_TRACKING, it->second, mapOfImages[it->first]);
+      task.m_width = point_cloud != NULL ? point_cloud->getWidth() : 0;
+      task.m_height = point_cloud != NULL ? point_cloud->getHeight() : 0;
+      tasks.push_back(task);
+    }
+    runCameraTasks(tasks);
+  } else {
+    for (std::map<std::string, TrackerWrapper *>::const_iterator it = m_mapOfTrackers.begin();
+         it != m_mapOfTrackers.end(); ++it) {
+      TrackerWrapper *tracker = it->second;
+
+      const vpOrganizedPointCloud *point_cloud = mapOfPointClouds[it->first];
+      tracker->postTracking(mapOfImages[it->first], point_cloud != NULL ? point_cloud->getWidth() : 0,
+                            point_cloud != NULL ? point_cloud->getHeight() : 0);
+    }
   }
 
   computeProjectionError();
 }
 
+/*!
+  Run the per-camera tasks on the vpThreadPool and rethrow the exception
+  raised by the first failing camera, in the camera order.
+*/
+void vpMbGenericTracker::runCameraTasks(std::vector<CameraTask> &tasks)
+{
+  std::vector<vpThreadPool::vpTask *> poolTasks;
+  for (size_t i = 0; i < tasks.size(); i++) {
+    // Drawing in a displayed image is not thread-safe
+    if (tasks[i].m_tracker->displayFeatures && tasks[i].m_I != NULL && tasks[i].m_I->display != NULL) {
+      tasks[i].run();
+    } else {
+      poolTasks.push_back(&tasks[i]);
+    }
+  }
+  vpThreadPool::getInstance().run(poolTasks);
+
+  for (size_t i = 0; i < tasks.size(); i++) {
+    if (tasks[i].m_hasError) {
+      if (tasks[i].m_isTrackingException) {
+        throw vpTrackingException(tasks[i].m_errorCode, tasks[i].m_errorMessage);
+      }
+      throw vpException(tasks[i].m_errorCode, tasks[i].m_errorMessage);
+    }
+  }
+}
+
 /** TrackerWrapper **/
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
-  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w(), m_weightedError()
+  : m_error(), m_L(), m_trackerType(EDGE_TRACKER), m_w(), m_weightedError(), m_stackInteractionMatrix(true)
 {
   m_lambda = 1.0;
   m_maxIter = 30;
@@ -4158,7 +4706,7 @@ vpMbGenericTracker::TrackerWrapper::TrackerWrapper()
 }
 
 vpMbGenericTracker::TrackerWrapper::TrackerWrapper(const int trackerType)
-  : m_error(), m_L(), m_trackerType(trackerType), m_w(), m_weightedError()
+  : m_error(), m_L(), m_trackerType(trackerType), m_w(), m_weightedError(), m_stackInteractionMatrix(true)
 {
   if ((m_trackerType & (EDGE_TRACKER |
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
@@ -4208,6 +4756,7 @@ vpMbGenericTracker::TrackerWrapper::~TrackerWrapper() {
 // Implemented only for debugging purposes: use TrackerWrapper as a standalone tracker
 void vpMbGenericTracker::TrackerWrapper::computeVVS(const vpImage<unsigned char> *const ptr_I)
 {
+  m_stackInteractionMatrix = true;
   computeVVSInit(ptr_I);
 
   if (m_error.getRows() < 4) {
@@ -4461,7 +5010,11 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInit(const vpImage<unsigned c
     m_w_depthDense.clear();
   }
 
-  m_L.resize(nbFeatures, 6, false, false);
+  if (m_stackInteractionMatrix) {
+    m_L.resize(nbFeatures, 6, false, false);
+  } else {
+    m_L.resize(0, 0);
+  }
   m_error.resize(nbFeatures, false);
 
   m_weightedError.resize(nbFeatures, false);
@@ -4499,7 +5052,9 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
 
   unsigned int start_index = 0;
   if (m_trackerType & EDGE_TRACKER) {
-    m_L.insert(m_L_edge, start_index, 0);
+    if (m_stackInteractionMatrix) {
+      m_L.insert(m_L_edge, start_index, 0);
+    }
     m_error.insert(start_index, m_error_edge);
 
     start_index += m_error_edge.getRows();
@@ -4507,7 +5062,9 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
 
 #if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
   if (m_trackerType & KLT_TRACKER) {
-    m_L.insert(m_L_klt, start_index, 0);
+    if (m_stackInteractionMatrix) {
+      m_L.insert(m_L_klt, start_index, 0);
+    }
     m_error.insert(start_index, m_error_klt);
 
     start_index += m_error_klt.getRows();
@@ -4515,14 +5072,18 @@ void vpMbGenericTracker::TrackerWrapper::computeVVSInteractionMatrixAndResidu(co
 #endif
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    m_L.insert(m_L_depthNormal, start_index, 0);
+    if (m_stackInteractionMatrix) {
+      m_L.insert(m_L_depthNormal, start_index, 0);
+    }
     m_error.insert(start_index, m_error_depthNormal);
 
     start_index += m_error_depthNormal.getRows();
   }
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
-    m_L.insert(m_L_depthDense, start_index, 0);
+    if (m_stackInteractionMatrix) {
+      m_L.insert(m_L_depthDense, start_index, 0);
+    }
     m_error.insert(start_index, m_error_depthDense);
 
     //    start_index += m_error_depthDense.getRows();
@@ -5019,43 +5580,7 @@ void vpMbGenericTracker::TrackerWrapper::postTracking(const vpImage<unsigned cha
 void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
                                                      const pcl::PointCloud<pcl::PointXYZ>::ConstPtr &point_cloud)
 {
-  if (m_trackerType & EDGE_TRACKER) {
-    try {
-      vpMbEdgeTracker::trackMovingEdge(*ptr_I);
-    } catch (...) {
-      std::cerr << "Error in moving edge tracking" << std::endl;
-      throw;
-    }
-  }
-
-#if defined(VISP_HAVE_MODULE_KLT) && (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
-  if (m_trackerType & KLT_TRACKER) {
-    try {
-      vpMbKltTracker::preTracking(*ptr_I);
-    } catch (const vpException &e) {
-      std::cerr << "Error in KLT tracking: " << e.what() << std::endl;
-      throw;
-    }
-  }
-#endif
-
-  if (m_trackerType & DEPTH_NORMAL_TRACKER) {
-    try {
-      vpMbDepthNormalTracker::segmentPointCloud(point_cloud);
-    } catch (...) {
-      std::cerr << "Error in Depth normal tracking" << std::endl;
-      throw;
-    }
-  }
-
-  if (m_trackerType & DEPTH_DENSE_TRACKER) {
-    try {
-      vpMbDepthDenseTracker::segmentPointCloud(point_cloud);
-    } catch (...) {
-      std::cerr << "Error in Depth dense tracking" << std::endl;
-      throw;
-    }
-  }
+  preTrackingImpl(ptr_I, vpMbtPclPointAccessor(point_cloud));
 }
 #endif
 
@@ -5115,6 +5640,25 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
                                                      const std::vector<vpColVector> *const point_cloud,
                                                      const unsigned int pointcloud_width,
                                                      const unsigned int pointcloud_height)
+{
+  preTrackingImpl(ptr_I, vpMbtVectorPointAccessor(point_cloud, pointcloud_height, pointcloud_width));
+}
+
+void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char> *const ptr_I,
+                                                     const vpOrganizedPointCloud *const point_cloud)
+{
+  preTrackingImpl(ptr_I, vpMbtOrganizedPointAccessor(point_cloud));
+}
+
+/*
+  Track the moving edges and the KLT points, then select the depth faces and
+  compute their desired features from the point cloud read through one of the
+  accessors of vpMbtFaceDepthSampling.h. The point cloud is only accessed if
+  a depth tracker is used.
+*/
+template <class vpPointAccessor>
+void vpMbGenericTracker::TrackerWrapper::preTrackingImpl(const vpImage<unsigned char> *const ptr_I,
+                                                         const vpPointAccessor &points)
 {
   if (m_trackerType & EDGE_TRACKER) {
     try {
@@ -5138,7 +5682,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
 
   if (m_trackerType & DEPTH_NORMAL_TRACKER) {
     try {
-      vpMbDepthNormalTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
+      vpMbDepthNormalTracker::segmentPointCloudImpl(points);
     } catch (...) {
       std::cerr << "Error in Depth tracking" << std::endl;
       throw;
@@ -5147,7 +5691,7 @@ void vpMbGenericTracker::TrackerWrapper::preTracking(const vpImage<unsigned char
 
   if (m_trackerType & DEPTH_DENSE_TRACKER) {
     try {
-      vpMbDepthDenseTracker::segmentPointCloud(*point_cloud, pointcloud_width, pointcloud_height);
+      vpMbDepthDenseTracker::segmentPointCloudImpl(points);
     } catch (...) {
       std::cerr << "Error in Depth dense tracking" << std::endl;
       throw;
@@ -2456,6 +2456,98 @@ void vpMbTracker::computeJTR(const vpMatrix &interaction, const vpColVector &err
   }
 }
 
+/*!
+  Accumulate the normal equations \f$ (WJ)^T WJ \f$ and \f$ (WJ)^T WR \f$ of
+  a block of features, where \f$ W \f$ is the diagonal matrix of the weights
+  \f$ w_i \; factor \f$. Compared to weighting and stacking the interaction
+  matrices of all the features before calling vpMatrix::AtA() and
+  computeJTR(), the interaction matrix \e J of the block is read once and no
+  intermediate matrix is allocated.
+
+  \throw vpMatrixException::incorrectMatrixSizeError if the sizes of the
+  matrices do not allow the computation.
+
+  \param J : The interaction matrix of the block (size Nx6).
+  \param R : The residu vector of the block (size Nx1).
+  \param w : The weights of the features (size Nx1).
+  \param factor : Weighting factor common to all the features of the block.
+  \param JTWJ : Matrix (size 6x6) to which \f$ (WJ)^T WJ \f$ is added.
+  \param JTWR : Vector (size 6x1) to which \f$ (WJ)^T WR \f$ is added.
+*/
+void vpMbTracker::accumulateJTWJ(const vpMatrix &J, const vpColVector &R, const vpColVector &w, const double factor,
+                                 vpMatrix &JTWJ, vpColVector &JTWR) const
+{
+  if (J.getRows() != R.getRows() || J.getRows() != w.getRows() || J.getCols() != 6 || JTWJ.getRows() != 6 ||
+      JTWJ.getCols() != 6 || JTWR.getRows() != 6) {
+    throw vpMatrixException(vpMatrixException::incorrectMatrixSizeError, "Incorrect matrices size in accumulateJTWJ.");
+  }
+
+  const unsigned int N = J.getRows();
+
+  bool checkSSE2 = vpCPUFeatures::checkSSE2();
+#if !VISP_HAVE_SSE2
+  checkSSE2 = false;
+#endif
+
+  if (checkSSE2) {
+#if VISP_HAVE_SSE2
+    __m128d v_JTWJ[18];
+    for (unsigned int k = 0; k < 18; k++) {
+      v_JTWJ[k] = _mm_loadu_pd(JTWJ.data + 2 * k);
+    }
+    __m128d v_JTWR_0_1 = _mm_loadu_pd(JTWR.data);
+    __m128d v_JTWR_2_3 = _mm_loadu_pd(JTWR.data + 2);
+    __m128d v_JTWR_4_5 = _mm_loadu_pd(JTWR.data + 4);
+
+    for (unsigned int i = 0; i < N; i++) {
+      const double wi = w[i] * factor;
+      const double wi2 = wi * wi;
+      const double *Ji = J[i];
+      const __m128d v_J_0_1 = _mm_loadu_pd(Ji);
+      const __m128d v_J_2_3 = _mm_loadu_pd(Ji + 2);
+      const __m128d v_J_4_5 = _mm_loadu_pd(Ji + 4);
+
+      for (unsigned int r = 0; r < 6; r++) {
+        const __m128d v_wJ = _mm_set1_pd(wi2 * Ji[r]);
+        v_JTWJ[3 * r] = _mm_add_pd(v_JTWJ[3 * r], _mm_mul_pd(v_wJ, v_J_0_1));
+        v_JTWJ[3 * r + 1] = _mm_add_pd(v_JTWJ[3 * r + 1], _mm_mul_pd(v_wJ, v_J_2_3));
+        v_JTWJ[3 * r + 2] = _mm_add_pd(v_JTWJ[3 * r + 2], _mm_mul_pd(v_wJ, v_J_4_5));
+      }
+
+      const __m128d v_wR = _mm_set1_pd(wi2 * R[i]);
+      v_JTWR_0_1 = _mm_add_pd(v_JTWR_0_1, _mm_mul_pd(v_J_0_1, v_wR));
+      v_JTWR_2_3 = _mm_add_pd(v_JTWR_2_3, _mm_mul_pd(v_J_2_3, v_wR));
+      v_JTWR_4_5 = _mm_add_pd(v_JTWR_4_5, _mm_mul_pd(v_J_4_5, v_wR));
+    }
+
+    for (unsigned int k = 0; k < 18; k++) {
+      _mm_storeu_pd(JTWJ.data + 2 * k, v_JTWJ[k]);
+    }
+    _mm_storeu_pd(JTWR.data, v_JTWR_0_1);
+    _mm_storeu_pd(JTWR.data + 2, v_JTWR_2_3);
+    _mm_storeu_pd(JTWR.data + 4, v_JTWR_4_5);
+#endif
+  } else {
+    for (unsigned int i = 0; i < N; i++) {
+      const double wi = w[i] * factor;
+      const double wi2 = wi * wi;
+      const double *Ji = J[i];
+
+      for (unsigned int r = 0; r < 6; r++) {
+        const double wJ = wi2 * Ji[r];
+        for (unsigned int c = 0; c < 6; c++) {
+          JTWJ[r][c] += wJ * Ji[c];
+        }
+      }
+
+      const double wR = wi2 * R[i];
+      for (unsigned int c = 0; c < 6; c++) {
+        JTWR[c] += Ji[c] * wR;
+      }
+    }
+  }
+}
+
 void vpMbTracker::computeVVSCheckLevenbergMarquardt(const unsigned int iter, vpColVector &error,
                                                     const vpColVector &m_error_prev, const vpHomogeneousMatrix &cMoPrev,
                                                     double &mu, bool &reStartFromLastIncrement, vpColVector *const w,
@@ -2483,61 +2575,71 @@ void vpMbTracker::computeVVSPoseEstimation(const bool isoJoIdentity_, const unsi
                                            vpColVector &error_prev, vpColVector &LTR, double &mu, vpColVector &v,
                                            const vpColVector *const w, vpColVector *const m_w_prev)
 {
-  if (isoJoIdentity_) {
-    LTL = L.AtA();
-    computeJTR(L, R, LTR);
-
-    switch (m_optimizationMethod) {
-    case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
-      vpMatrix LMA(LTL.getRows(), LTL.getCols());
-      LMA.eye();
-      vpMatrix LTLmuI = LTL + (LMA * mu);
-      v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * std::numeric_limits<double>::epsilon()) * LTR;
+  L.AtA(LTL);
+  computeJTR(L, R, LTR);
 
-      if (iter != 0)
-        mu /= 10.0;
+  computeVVSPoseEstimationFromJTWJ(isoJoIdentity_, iter, LTL, LTR, error, error_prev, mu, v, w, m_w_prev);
+}
 
-      error_prev = error;
-      if (w != NULL && m_w_prev != NULL)
-        *m_w_prev = *w;
-      break;
-    }
+/*!
+  Compute the velocity of the virtual visual servoing from the normal
+  equations \f$ L^T W L \f$ and \f$ L^T W R \f$, accumulated for instance with
+  accumulateJTWJ(), instead of the weighted interaction matrix and residu.
 
-    case vpMbTracker::GAUSS_NEWTON_OPT:
-    default:
-      v = -m_lambda * LTL.pseudoInverse(LTL.getRows() * std::numeric_limits<double>::epsilon()) * LTR;
-      break;
-    }
-  } else {
-    vpVelocityTwistMatrix cVo;
+  \param isoJoIdentity_ : If false, only the degrees of freedom of oJo are
+  estimated.
+  \param iter : Current iteration.
+  \param LTL : Normal matrix (size 6x6).
+  \param LTR : Right-hand side of the normal equations (size 6x1).
+  \param error : Residu of the current iteration.
+  \param error_prev : Residu kept for the Levenberg-Marquardt check.
+  \param mu : Levenberg-Marquardt damping factor.
+  \param v : Estimated velocity.
+  \param w : If not NULL, robust weights kept in \e m_w_prev for the
+  Levenberg-Marquardt check.
+  \param m_w_prev : Robust weights of the previous iteration.
+*/
+void vpMbTracker::computeVVSPoseEstimationFromJTWJ(const bool isoJoIdentity_, const unsigned int iter,
+                                                   const vpMatrix &LTL, const vpColVector &LTR,
+                                                   const vpColVector &error, vpColVector &error_prev, double &mu,
+                                                   vpColVector &v, const vpColVector *const w,
+                                                   vpColVector *const m_w_prev)
+{
+  vpVelocityTwistMatrix cVo;
+  vpMatrix JTJ = LTL;
+  vpColVector JTR = LTR;
+  if (!isoJoIdentity_) {
+    // Normal equations of L * cVo * oJo
     cVo.buildFrom(cMo);
-    vpMatrix LVJ = (L * (cVo * oJo));
-    vpMatrix LVJTLVJ = (LVJ).AtA();
-    vpColVector LVJTR;
-    computeJTR(LVJ, R, LVJTR);
-
-    switch (m_optimizationMethod) {
-    case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
-      vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
-      LMA.eye();
-      vpMatrix LTLmuI = LVJTLVJ + (LMA * mu);
-      v = -m_lambda * LTLmuI.pseudoInverse(LTLmuI.getRows() * std::numeric_limits<double>::epsilon()) * LVJTR;
-      v = cVo * v;
-
-      if (iter != 0)
-        mu /= 10.0;
-
-      error_prev = error;
-      if (w != NULL && m_w_prev != NULL)
-        *m_w_prev = *w;
-      break;
-    }
-    case vpMbTracker::GAUSS_NEWTON_OPT:
-    default:
-      v = -m_lambda * LVJTLVJ.pseudoInverse(LVJTLVJ.getRows() * std::numeric_limits<double>::epsilon()) * LVJTR;
-      v = cVo * v;
-      break;
+    vpMatrix VJ = cVo * oJo;
+    JTJ = VJ.transpose() * LTL * VJ;
+    JTR = VJ.transpose() * LTR;
+  }
+
+  switch (m_optimizationMethod) {
+  case vpMbTracker::LEVENBERG_MARQUARDT_OPT: {
+    for (unsigned int i = 0; i < JTJ.getRows(); i++) {
+      JTJ[i][i] += mu;
     }
+    v = -m_lambda * JTJ.pseudoInverse(JTJ.getRows() * std::numeric_limits<double>::epsilon()) * JTR;
+
+    if (iter != 0)
+      mu /= 10.0;
+
+    error_prev = error;
+    if (w != NULL && m_w_prev != NULL)
+      *m_w_prev = *w;
+    break;
+  }
+
+  case vpMbTracker::GAUSS_NEWTON_OPT:
+  default:
+    v = -m_lambda * JTJ.pseudoInverse(JTJ.getRows() * std::numeric_limits<double>::epsilon()) * JTR;
+    break;
+  }
+
+  if (!isoJoIdentity_) {
+    v = cVo * v;
   }
 }
 
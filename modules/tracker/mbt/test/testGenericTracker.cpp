@@ -55,7 +55,7 @@
 #include <visp3/gui/vpDisplayGTK.h>
 #include <visp3/mbt/vpMbGenericTracker.h>
 
-#define GETOPTARGS "i:dclt:e:Dmh"
+#define GETOPTARGS "i:dclt:e:DmpCNh"
 
 namespace
 {
@@ -66,7 +66,7 @@ namespace
     \n\
     SYNOPSIS\n\
       %s [-i <test image path>] [-c] [-d] [-h] [-l] \n\
-     [-t <tracker type>] [-e <last frame index>] [-D] [-m]\n", name);
+     [-t <tracker type>] [-e <last frame index>] [-D] [-m] [-p] [-C] [-N]\n", name);
 
     fprintf(stdout, "\n\
     OPTIONS:                                               \n\
@@ -99,6 +99,15 @@ namespace
     \n\
       -m \n\
          Set a tracking mask.\n\
+    \n\
+      -p \n\
+         Process the edge features in parallel.\n\
+    \n\
+      -C \n\
+         Process the cameras concurrently.\n\
+    \n\
+      -N \n\
+         Accumulate the normal equations per block of features.\n\
     \n\
       -h \n\
          Print the help.\n\n");
@@ -108,7 +117,8 @@ namespace
   }
 
   bool getOptions(int argc, const char **argv, std::string &ipath, bool &click_allowed, bool &display,
-                  bool &useScanline, int &trackerType, int &lastFrame, bool &use_depth, bool &use_mask)
+                  bool &useScanline, int &trackerType, int &lastFrame, bool &use_depth, bool &use_mask,
+                  bool &use_parallel, bool &use_parallel_cameras, bool &use_normal_equations)
   {
     const char *optarg_;
     int c;
@@ -139,6 +149,15 @@ namespace
       case 'm':
         use_mask = true;
         break;
+      case 'p':
+        use_parallel = true;
+        break;
+      case 'C':
+        use_parallel_cameras = true;
+        break;
+      case 'N':
+        use_normal_equations = true;
+        break;
       case 'h':
         usage(argv[0], NULL);
         return false;
@@ -238,6 +257,9 @@ int main(int argc, const char *argv[])
 #endif
     bool use_depth = false;
     bool use_mask = false;
+    bool use_parallel = false;
+    bool use_parallel_cameras = false;
+    bool use_normal_equations = false;
 
     // Get the visp-images-data package path or VISP_INPUT_IMAGE_PATH
     // environment variable value
@@ -246,7 +268,7 @@ int main(int argc, const char *argv[])
     // Read the command line options
     if (!getOptions(argc, argv, opt_ipath, opt_click_allowed, opt_display,
                     useScanline, trackerType_image, opt_lastFrame, use_depth,
-                    use_mask)) {
+                    use_mask, use_parallel, use_parallel_cameras, use_normal_equations)) {
       return EXIT_FAILURE;
     }
 
@@ -254,6 +276,9 @@ int main(int argc, const char *argv[])
     std::cout << "useScanline: " << useScanline << std::endl;
     std::cout << "use_depth: " << use_depth << std::endl;
     std::cout << "use_mask: " << use_mask << std::endl;
+    std::cout << "use_parallel: " << use_parallel << std::endl;
+    std::cout << "use_parallel_cameras: " << use_parallel_cameras << std::endl;
+    std::cout << "use_normal_equations: " << use_normal_equations << std::endl;
 #ifdef VISP_HAVE_COIN3D
     std::cout << "COIN3D available." << std::endl;
 #endif
@@ -375,6 +400,9 @@ int main(int argc, const char *argv[])
     tracker.getCameraParameters(cam_color, cam_depth);
     tracker.setDisplayFeatures(true);
     tracker.setScanLineVisibilityTest(useScanline);
+    tracker.setUseParallelEdgeTracking(use_parallel);
+    tracker.setUseParallelCameraTracking(use_parallel_cameras);
+    tracker.setNormalEquationsAccumulation(use_normal_equations);
 
     std::map<int, std::pair<double, double> > map_thresh;
     //Take the highest thresholds between all CI machines
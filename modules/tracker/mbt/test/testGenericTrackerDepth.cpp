@@ -55,7 +55,7 @@
 #include <visp3/gui/vpDisplayGTK.h>
 #include <visp3/mbt/vpMbGenericTracker.h>
 
-#define GETOPTARGS "i:dcle:mh"
+#define GETOPTARGS "i:dcle:moh"
 
 namespace
 {
@@ -66,7 +66,7 @@ namespace
     \n\
     SYNOPSIS\n\
       %s [-i <test image path>] [-c] [-d] [-h] [-l] \n\
-     [-e <last frame index>] [-m]\n", name);
+     [-e <last frame index>] [-m] [-o]\n", name);
 
     fprintf(stdout, "\n\
     OPTIONS:                                               \n\
@@ -93,6 +93,9 @@ namespace
     \n\
       -m \n\
          Set a tracking mask.\n\
+    \n\
+      -o \n\
+         Track with a vpOrganizedPointCloud view on the raw depth image.\n\
     \n\
       -h \n\
          Print the help.\n\n");
@@ -102,7 +105,7 @@ namespace
   }
 
   bool getOptions(int argc, const char **argv, std::string &ipath, bool &click_allowed, bool &display,
-                  bool &useScanline, int &lastFrame, bool &use_mask)
+                  bool &useScanline, int &lastFrame, bool &use_mask, bool &use_organized)
   {
     const char *optarg_;
     int c;
@@ -127,6 +130,9 @@ namespace
       case 'm':
         use_mask = true;
         break;
+      case 'o':
+        use_organized = true;
+        break;
       case 'h':
         usage(argv[0], NULL);
         return false;
@@ -224,6 +230,7 @@ int main(int argc, const char *argv[])
     int opt_lastFrame = -1;
 #endif
     bool use_mask = false;
+    bool use_organized = false;
 
     // Get the visp-images-data package path or VISP_INPUT_IMAGE_PATH
     // environment variable value
@@ -231,12 +238,13 @@ int main(int argc, const char *argv[])
 
     // Read the command line options
     if (!getOptions(argc, argv, opt_ipath, opt_click_allowed, opt_display,
-                    useScanline, opt_lastFrame, use_mask)) {
+                    useScanline, opt_lastFrame, use_mask, use_organized)) {
       return EXIT_FAILURE;
     }
 
     std::cout << "useScanline: " << useScanline << std::endl;
     std::cout << "use_mask: " << use_mask << std::endl;
+    std::cout << "use_organized: " << use_organized << std::endl;
 
     // Test if an input path is set
     if (opt_ipath.empty() && env_ipath.empty()) {
@@ -367,13 +375,22 @@ int main(int argc, const char *argv[])
 
       double t = vpTime::measureTimeMs();
       std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
-      std::map<std::string, const std::vector<vpColVector> *> mapOfPointclouds;
-      mapOfPointclouds["Camera"] = &pointcloud;
-      std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
-      mapOfWidths["Camera"] = I_depth.getWidth();
-      mapOfHeights["Camera"] = I_depth.getHeight();
-
-      tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      if (use_organized) {
+        vpOrganizedPointCloud organized_pointcloud;
+        organized_pointcloud.buildFrom(I_depth_raw, cam_depth, 0.000030518f);
+        std::map<std::string, const vpOrganizedPointCloud *> mapOfPointclouds;
+        mapOfPointclouds["Camera"] = &organized_pointcloud;
+
+        tracker.track(mapOfImages, mapOfPointclouds);
+      } else {
+        std::map<std::string, const std::vector<vpColVector> *> mapOfPointclouds;
+        mapOfPointclouds["Camera"] = &pointcloud;
+        std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+        mapOfWidths["Camera"] = I_depth.getWidth();
+        mapOfHeights["Camera"] = I_depth.getHeight();
+
+        tracker.track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+      }
       vpHomogeneousMatrix cMo = tracker.getPose();
       t = vpTime::measureTimeMs() - t;
       time_vec.push_back(t);
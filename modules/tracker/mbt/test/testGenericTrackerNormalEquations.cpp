@@ -0,0 +1,302 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the stacked and the normal equations pose estimation of the
+ * generic model-based tracker on a synthetic sequence.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGenericTrackerNormalEquations.cpp
+
+  \brief Track a synthetic cube seen by a stereo RGB-D rig with the edge,
+  dense depth and depth normal features, once by stacking the interaction
+  matrices of all the cameras and once by accumulating the normal equations
+  (vpMbGenericTracker::setNormalEquationsAccumulation()), and check that both
+  give the same pose with the same number of iterations.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/mbt/vpMbGenericTracker.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Axis aligned cube of 4.2 cm in the object frame
+const double cube_min[3] = {-0.042, 0, 0};
+const double cube_max[3] = {0, 0.042, 0.042};
+
+// Generic tracker that counts the iterations of the virtual visual servoing
+class vpMbGenericTrackerIterationCounter : public vpMbGenericTracker
+{
+public:
+  explicit vpMbGenericTrackerIterationCounter(const std::vector<int> &trackerTypes)
+    : vpMbGenericTracker(trackerTypes), m_nbIterations(0)
+  {
+  }
+
+  unsigned int m_nbIterations;
+
+protected:
+  virtual void computeVVSCheckLevenbergMarquardt(const unsigned int iter, vpColVector &error,
+                                                 const vpColVector &m_error_prev, const vpHomogeneousMatrix &cMoPrev,
+                                                 double &mu, bool &reStartFromLastIncrement, vpColVector *const w,
+                                                 const vpColVector *const m_w_prev)
+  {
+    m_nbIterations++;
+    vpMbGenericTracker::computeVVSCheckLevenbergMarquardt(iter, error, m_error_prev, cMoPrev, mu,
+                                                         reStartFromLastIncrement, w, m_w_prev);
+  }
+};
+
+bool writeCubeModel(const std::string &filename)
+{
+  std::ofstream file(filename.c_str());
+  if (!file.is_open()) {
+    return false;
+  }
+
+  file << "V1\n"
+       << "8\n"
+       << "0 0 0\n"
+       << "-0.042 0 0\n"
+       << "-0.042 0.042 0\n"
+       << "0 0.042 0\n"
+       << "0 0 0.042\n"
+       << "-0.042 0 0.042\n"
+       << "-0.042 0.042 0.042\n"
+       << "0 0.042 0.042\n"
+       << "0\n"
+       << "0\n"
+       << "6\n"
+       << "4 0 4 5 1\n"
+       << "4 1 5 6 2\n"
+       << "4 6 7 3 2\n"
+       << "4 3 7 4 0\n"
+       << "4 0 1 2 3\n"
+       << "4 7 6 5 4\n"
+       << "0\n"
+       << "0\n";
+  return true;
+}
+
+// Ray cast the cube seen from cMo: each visible face gets its own gray level
+// and the point cloud is expressed in the camera frame
+void render(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, vpImage<unsigned char> &I,
+            std::vector<vpColVector> &pointcloud)
+{
+  unsigned int height = I.getHeight(), width = I.getWidth();
+  pointcloud.assign(height * width, vpColVector(3, 0));
+  vpHomogeneousMatrix oMc = cMo.inverse();
+
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+
+      double origin[3], dir[3];
+      for (unsigned int k = 0; k < 3; k++) {
+        origin[k] = oMc[k][3];
+        dir[k] = oMc[k][0] * x + oMc[k][1] * y + oMc[k][2];
+      }
+
+      double tmin = -1e30, tmax = 1e30;
+      int face = -1;
+      bool hit = true;
+      for (unsigned int k = 0; k < 3; k++) {
+        if (std::fabs(dir[k]) < 1e-12) {
+          if (origin[k] < cube_min[k] || origin[k] > cube_max[k]) {
+            hit = false;
+          }
+          continue;
+        }
+
+        double t1 = (cube_min[k] - origin[k]) / dir[k], t2 = (cube_max[k] - origin[k]) / dir[k];
+        int side = 0;
+        if (t1 > t2) {
+          std::swap(t1, t2);
+          side = 1;
+        }
+        if (t1 > tmin) {
+          tmin = t1;
+          face = 2 * (int)k + side;
+        }
+        if (t2 < tmax) {
+          tmax = t2;
+        }
+      }
+
+      if (hit && tmin <= tmax && tmin > 0) {
+        I[i][j] = (unsigned char)(60 + 30 * face);
+        pointcloud[i * width + j][0] = x * tmin;
+        pointcloud[i * width + j][1] = y * tmin;
+        pointcloud[i * width + j][2] = tmin;
+      } else {
+        I[i][j] = 240;
+      }
+    }
+  }
+}
+} // namespace
+#endif
+
+int main()
+{
+  try {
+    // The cube model is written in the temporary directory of the user
+#if defined(_WIN32)
+    std::string opath = "C:/temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    opath = vpIoTools::createFilePath(opath, vpIoTools::getUserName());
+    if (vpIoTools::checkDirectory(opath) == false) {
+      vpIoTools::makeDirectory(opath);
+    }
+    std::string model = vpIoTools::createFilePath(opath, "testGenericTrackerNormalEquations_cube.cao");
+    if (!writeCubeModel(model)) {
+      std::cerr << "Cannot write " << model << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpCameraParameters cam(600, 600, 320, 240);
+    vpHomogeneousMatrix c2Mc1(0.05, 0.0, 0.0, 0, 0.05, 0);
+    std::map<std::string, vpHomogeneousMatrix> mapOfCameraTransformations;
+    mapOfCameraTransformations["Camera1"] = vpHomogeneousMatrix();
+    mapOfCameraTransformations["Camera2"] = c2Mc1;
+
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(8);
+    me.setThreshold(1500);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+
+    // Index 0: stacked interaction matrix, index 1: normal equations
+    std::vector<int> trackerTypes(2, vpMbGenericTracker::EDGE_TRACKER | vpMbGenericTracker::DEPTH_DENSE_TRACKER |
+                                         vpMbGenericTracker::DEPTH_NORMAL_TRACKER);
+    vpMbGenericTrackerIterationCounter tracker_stacked(trackerTypes), tracker_accumulated(trackerTypes);
+    vpMbGenericTrackerIterationCounter *trackers[2] = {&tracker_stacked, &tracker_accumulated};
+    for (unsigned int t = 0; t < 2; t++) {
+      trackers[t]->setCameraParameters(cam, cam);
+      trackers[t]->setCameraTransformationMatrix(mapOfCameraTransformations);
+      trackers[t]->setMovingEdge(me);
+      trackers[t]->setDepthDenseSamplingStep(2, 2);
+      trackers[t]->loadModel(model, model);
+      trackers[t]->setNearClippingDistance(0.01);
+      trackers[t]->setFarClippingDistance(2.0);
+      trackers[t]->setGoodMovingEdgesRatioThreshold(0.1);
+      trackers[t]->setNormalEquationsAccumulation(t == 1);
+    }
+
+    const unsigned int width = 640, height = 480;
+    vpImage<unsigned char> I1(height, width), I2(height, width);
+    std::vector<vpColVector> pointcloud1, pointcloud2;
+    vpHomogeneousMatrix cMo_truth(0.02, -0.02, 0.25, vpMath::rad(30), vpMath::rad(-35), vpMath::rad(10));
+    vpHomogeneousMatrix cMo_init = vpHomogeneousMatrix(0.003, -0.002, 0.004, 0.02, -0.01, 0.015) * cMo_truth;
+    render(cMo_truth, cam, I1, pointcloud1);
+    render(c2Mc1 * cMo_truth, cam, I2, pointcloud2);
+    for (unsigned int t = 0; t < 2; t++) {
+      trackers[t]->initFromPose(I1, I2, cMo_init, c2Mc1 * cMo_init);
+    }
+
+    std::map<std::string, const vpImage<unsigned char> *> mapOfImages;
+    mapOfImages["Camera1"] = &I1;
+    mapOfImages["Camera2"] = &I2;
+    std::map<std::string, const std::vector<vpColVector> *> mapOfPointclouds;
+    mapOfPointclouds["Camera1"] = &pointcloud1;
+    mapOfPointclouds["Camera2"] = &pointcloud2;
+    std::map<std::string, unsigned int> mapOfWidths, mapOfHeights;
+    mapOfWidths["Camera1"] = mapOfWidths["Camera2"] = width;
+    mapOfHeights["Camera1"] = mapOfHeights["Camera2"] = height;
+
+    const unsigned int nbFrames = 30;
+    double max_pose_diff = 0, max_pose_error = 0;
+    unsigned int nbTotalIterations = 0;
+    for (unsigned int frame = 0; frame < nbFrames; frame++) {
+      cMo_truth = vpHomogeneousMatrix(0.001, 0.0005, 0.0005, 0.004, 0.006, -0.003) * cMo_truth;
+      render(cMo_truth, cam, I1, pointcloud1);
+      render(c2Mc1 * cMo_truth, cam, I2, pointcloud2);
+
+      vpHomogeneousMatrix cMo[2];
+      unsigned int nbIterations[2];
+      for (unsigned int t = 0; t < 2; t++) {
+        trackers[t]->m_nbIterations = 0;
+        trackers[t]->track(mapOfImages, mapOfPointclouds, mapOfWidths, mapOfHeights);
+        trackers[t]->getPose(cMo[t]);
+        nbIterations[t] = trackers[t]->m_nbIterations;
+      }
+
+      if (nbIterations[0] != nbIterations[1]) {
+        std::cerr << "Frame " << frame << ": " << nbIterations[0] << " iterations with the stacked interaction matrix, "
+                  << nbIterations[1] << " iterations with the normal equations" << std::endl;
+        return EXIT_FAILURE;
+      }
+      nbTotalIterations += nbIterations[0];
+
+      for (unsigned int i = 0; i < 3; i++) {
+        for (unsigned int j = 0; j < 4; j++) {
+          max_pose_diff = (std::max)(max_pose_diff, std::fabs(cMo[0][i][j] - cMo[1][i][j]));
+          max_pose_error = (std::max)(max_pose_error, std::fabs(cMo[1][i][j] - cMo_truth[i][j]));
+        }
+      }
+    }
+
+    std::cout << "Max pose difference between the stacked and the normal equations estimation: " << max_pose_diff
+              << std::endl;
+    std::cout << "Iterations over the " << nbFrames << " frames: " << nbTotalIterations << std::endl;
+    std::cout << "Max pose error: " << max_pose_error << std::endl;
+
+    if (max_pose_diff > 1e-8) {
+      std::cerr << "The stacked and the normal equations estimation give different poses" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (max_pose_error > 5e-3) {
+      std::cerr << "The tracking drifted from the ground truth pose" << std::endl;
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testGenericTrackerNormalEquations is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
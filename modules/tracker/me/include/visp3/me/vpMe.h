@@ -46,6 +46,8 @@
 #ifndef vpMe_H
 #define vpMe_H
 
+#include <vector>
+
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpMatrix.h>
@@ -91,6 +93,13 @@ private:
   vpMatrix *mask; //! Array of matrices defining the different masks (one for
                   //! every angle step).
 
+private:
+  //! Integer copy of the masks, each row padded with zeros to
+  //! m_maskTableStride coefficients (see getMaskTable()).
+  std::vector<short> m_maskTable;
+  //! Number of coefficients per row in m_maskTable, multiple of 8.
+  unsigned int m_maskTableStride;
+
 public:
   vpMe();
   vpMe(const vpMe &me);
@@ -140,6 +149,27 @@ public:
     \return the current mask size.
   */
   inline unsigned int getMaskSize() const { return mask_size; }
+  /*!
+    Return the integer coefficients of the mask \e index, stored row by row.
+    Each row holds getMaskTableStride() coefficients: the getMaskSize() first
+    ones are the mask coefficients, the others are set to zero so that a row
+    can be processed with fixed size SIMD registers.
+
+    The table is built by initMask() from getMask(). Since the mask
+    coefficients are rounded integers, the convolution computed with this
+    table is identical to the one computed with getMask().
+
+    \param index : Index of the mask in [0, getMaskNumber()[.
+  */
+  inline const short *getMaskTable(const unsigned int index) const
+  {
+    return &m_maskTable[index * mask_size * m_maskTableStride];
+  }
+  /*!
+    Return the number of coefficients per row of the tables returned by
+    getMaskTable(). It is a multiple of 8 greater or equal to getMaskSize().
+  */
+  inline unsigned int getMaskTableStride() const { return m_maskTableStride; }
   /*!
     Get the minimum allowed sample step. Useful to specify a lower bound when
     the sample step is changed.
@@ -355,6 +355,19 @@ void vpMe::initMask()
     angle[k++] = i;
 
   calcul_masques(angle, mask_size, mask);
+
+  // Integer masks with rows padded to a multiple of 8 coefficients for
+  // vpMeSite::track()
+  m_maskTableStride = ((mask_size + 7) / 8) * 8;
+  m_maskTable.assign((size_t)n_mask * mask_size * m_maskTableStride, 0);
+  for (unsigned int k = 0; k < n_mask; k++) {
+    short *table = &m_maskTable[(size_t)k * mask_size * m_maskTableStride];
+    for (unsigned int a = 0; a < mask_size; a++) {
+      for (unsigned int b = 0; b < mask_size; b++) {
+        table[a * m_maskTableStride + b] = static_cast<short>(mask[k][a][b]);
+      }
+    }
+  }
 }
 
 void vpMe::print()
@@ -375,7 +388,8 @@ void vpMe::print()
 
 vpMe::vpMe()
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0), range(4), sample_step(10),
-    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL)
+    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL),
+    m_maskTable(), m_maskTableStride(8)
 {
   // ntotal_sample = 0; // not sure that it is used
   // points_to_track = 500; // not sure that it is used
@@ -386,7 +400,8 @@ vpMe::vpMe()
 
 vpMe::vpMe(const vpMe &me)
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0), range(4), sample_step(10),
-    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL)
+    ntotal_sample(0), points_to_track(500), mask_size(5), n_mask(180), strip(2), mask(NULL),
+    m_maskTable(), m_maskTableStride(8)
 {
   *this = me;
 }
@@ -46,10 +46,16 @@
 #include <cmath>  // std::fabs
 #include <limits> // numeric_limits
 #include <stdlib.h>
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/me/vpMe.h>
 #include <visp3/me/vpMeSite.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 static bool horsImage(int i, int j, int half, int rows, int cols)
 {
@@ -61,6 +67,67 @@ static bool horsImage(int i, int j, int half, int rows, int cols)
   // > (cols - half - 3) )) ;
   return ((0 < (half_1 - i)) || ((i - rows + half_3) > 0) || (0 < (half_1 - j)) || ((j - cols + half_3) > 0));
 }
+
+// Index of the mask used for a site whose normal has the angle alpha
+static unsigned int maskIndex(double alpha, const vpMe *me)
+{
+  // Calculate tangent angle from normal
+  double theta = alpha + M_PI / 2;
+  // Move tangent angle to within 0->M_PI for a positive
+  // mask index
+  while (theta < 0)
+    theta += M_PI;
+  while (theta > M_PI)
+    theta -= M_PI;
+
+  // Convert radians to degrees
+  int thetadeg = vpMath::round(theta * 180 / M_PI);
+
+  if (abs(thetadeg) == 180) {
+    thetadeg = 0;
+  }
+
+  return (unsigned int)(thetadeg / (double)me->getAngleStep());
+}
+
+// Integer convolution of the msize x msize window of I whose top-left corner
+// is (ihalf, jhalf) with a mask of vpMe::getMaskTable(). The SSE2 path reads
+// each window row by blocks of 8 pixels: the pixels after the window are
+// multiplied by the zero padding of the mask rows, and stay inside the image
+// buffer since horsImage() keeps the window away from the last image rows.
+static int maskConvolution(const vpImage<unsigned char> &I, const short *mask, unsigned int msize,
+                           unsigned int stride, unsigned int ihalf, unsigned int jhalf, bool useSSE2)
+{
+#if VISP_HAVE_SSE2
+  if (useSSE2) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = _mm_setzero_si128();
+    for (unsigned int a = 0; a < msize; a++) {
+      const unsigned char *row = I[ihalf + a] + jhalf;
+      const short *mask_row = mask + a * stride;
+      for (unsigned int b = 0; b < stride; b += 8) {
+        __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(row + b)), zero);
+        acc = _mm_add_epi32(acc, _mm_madd_epi16(pixels, _mm_loadu_si128((const __m128i *)(mask_row + b))));
+      }
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+  }
+#else
+  (void)useSSE2;
+#endif
+
+  int conv = 0;
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row = I[ihalf + a] + jhalf;
+    const short *mask_row = mask + a * stride;
+    for (unsigned int b = 0; b < msize; b++) {
+      conv += mask_row[b] * row[b];
+    }
+  }
+  return conv;
+}
 #endif
 
 void vpMeSite::init()
@@ -306,39 +373,12 @@ double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
     i = 0;
     j = 0;
   } else {
-    // Calculate tangent angle from normal
-    double theta = alpha + M_PI / 2;
-    // Move tangent angle to within 0->M_PI for a positive
-    // mask index
-    while (theta < 0)
-      theta += M_PI;
-    while (theta > M_PI)
-      theta -= M_PI;
-
-    // Convert radians to degrees
-    int thetadeg = vpMath::round(theta * 180 / M_PI);
-
-    if (abs(thetadeg) == 180) {
-      thetadeg = 0;
-    }
-
-    unsigned int index_mask = (unsigned int)(thetadeg / (double)me->getAngleStep());
-
     unsigned int i_ = static_cast<unsigned int>(i);
     unsigned int j_ = static_cast<unsigned int>(j);
     unsigned int half_ = static_cast<unsigned int>(half);
 
-    unsigned int ihalf = i_ - half_;
-    unsigned int jhalf = j_ - half_;
-
-    for (unsigned int a = 0; a < msize; a++) {
-      unsigned int ihalfa = ihalf + a;
-      for (unsigned int b = 0; b < msize; b++) {
-        conv += mask_sign * me->getMask()[index_mask][a][b] *
-                //	  I(i-half+a,j-half+b) ;
-                I(ihalfa, jhalf + b);
-      }
-    }
+    conv = mask_sign * maskConvolution(I, me->getMaskTable(maskIndex(alpha, me)), msize, me->getMaskTableStride(),
+                                       i_ - half_, j_ - half_, vpCPUFeatures::checkSSE2());
   }
 
   return (conv);
@@ -348,230 +388,146 @@ double vpMeSite::convolution(const vpImage<unsigned char> &I, const vpMe *me)
 
   Specific function for ME.
 
+  Seek the edge along the normal to the contour within +/- me->getRange()
+  pixels. All the candidates share the same normal, hence the same mask: the
+  mask is selected once and each candidate is scored with an integer
+  convolution (vectorized when SSE2 is available) without any memory
+  allocation. The result is the same as scoring the sites returned by
+  getQueryList() with convolution().
+
   \warning To display the moving edges graphics a call to vpDisplay::flush()
   is needed.
 
 */
 void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool test_contraste)
 {
-  //   vpMeSite  *list_query_pixels ;
-  //   int  max_rank =0 ;
-  //   int max_rank1=0 ;
-  //   int max_rank2 = 0;
-  //   double  convolution = 0 ;
-  //   double  max_convolution = 0 ;
-  //   double max = 0 ;
-  //   double contraste = 0;
-  //   //  vpDisplay::display(I) ;
-  //   //  vpERROR_TRACE("getclcik %d",me->getRange()) ;
-  //   //  vpDisplay::getClick(I) ;
-  //
-  //   // range = +/- range of pixels within which the correspondent
-  //   // of the current pixel will be sought
-  //   int range  = me->getRange() ;
-  //
-  //   //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  <<
-  //   std::endl ; list_query_pixels = getQueryList(I, range) ;
-  //
-  //   double  contraste_max = 1 + me->getMu2();
-  //   double  contraste_min = 1 - me->getMu1();
-  //
-  //   // array in which likelihood ratios will be stored
-  //   double  *likelihood= new double[ 2 * range + 1 ] ;
-  //
-  //   int ii_1 = i ;
-  //   int jj_1 = j ;
-  //   i_1 = i ;
-  //   j_1 = j ;
-  //   double threshold;
-  //   threshold = me->getThreshold();
-  //
-  //   //    std::cout <<"---------------------"<<std::endl ;
-  //   for(int n = 0 ; n < 2 * range + 1 ; n++)
-  //     {
-  //
-  //       //   convolution results
-  //       convolution = list_query_pixels[n].convolution(I, me) ;
-  //
-  //       // luminance ratio of reference pixel to potential correspondent
-  //       pixel
-  //       // the luminance must be similar, hence the ratio value should
-  //       // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-  //       if( test_contraste )
-  // 	{
-  // 	  // Include this to eliminate temporal calculation
-  // 	  if (convlt==0)
-  // 	    {
-  // 	      std::cout << "vpMeSite::track : Division by zero  convlt = 0" <<
-  // std::endl ; 	      delete []list_query_pixels ; 	      delete
-  // []likelihood;
-  // 	      throw(vpTrackingException(vpTrackingException::initializationError,
-  // 					"Division by zero")) ;
-  // 	    }
-  //
-  // // 	  contraste = fabs(convolution / convlt) ;
-  // 	  contraste = convolution / convlt ;
-  // 	  // likelihood ratios
-  // 	  if((contraste > contraste_min) && (contraste < contraste_max))
-  // 	    likelihood[n] = fabs(convolution + convlt ) ;
-  // 	  else
-  // 	    likelihood[n] = 0 ;
-  // 	}
-  //       else
-  // 	likelihood[n] = fabs(2*convolution) ;
-  //
-  //
-  //       // establishment of the maximal likelihood ratios's  rank
-  //       // in the array, the value of the likelihood ratio can now be
-  //     // referenced by its rank in the array
-  //     if (likelihood[n] > max)
-  //     {
-  //       max_convolution= convolution;
-  //       max = likelihood[n] ;
-  //       max_rank = n ;
-  //       max_rank2 = max_rank1;
-  //       max_rank1 = max_rank;
-  //     }
-  //
-  //   }
-  //
-  //   // test on the likelihood threshold if threshold==-1 then
-  //   // the me->threshold is  selected
-  //
-  //   vpImagePoint ip;
-  //
-  //   //  if (test_contrast)
-  //   if(max > threshold)
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::red);
-  // 	}
-  //
-  //       *this = list_query_pixels[max_rank] ;//The vpMeSite is replaced by
-  //       the vpMeSite of max likelihood normGradient =
-  //       vpMath::sqr(max_convolution);
-  //
-  //       convlt = max_convolution;
-  //       i_1 = ii_1; //list_query_pixels[max_rank].i ;
-  //       j_1 = jj_1; //list_query_pixels[max_rank].j ;
-  //       delete []list_query_pixels ;
-  //       delete []likelihood;
-  //     }
-  //   else //none of the query sites is better than the threshold
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::green);
-  // 	}
-  //       normGradient = 0 ;
-  //       if(max == 0)
-  // 	suppress = 1; // contrast suppression
-  //       else
-  // 	suppress = 2; // threshold suppression
-  //
-  //       delete []list_query_pixels ;
-  //       delete []likelihood; // modif portage
-  //     }
-
   int max_rank = -1;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
   double max_convolution = 0;
   double max = 0;
   double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
 
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range = me->getRange();
-
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  <<
-  //  std::endl ;
-  vpMeSite *list_query_pixels = getQueryList(I, (int)range);
+  int range = static_cast<int>(me->getRange());
 
   double contraste_max = 1 + me->getMu2();
   double contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double *likelihood = new double[2 * range + 1];
-
   int ii_1 = i;
   int jj_1 = j;
   i_1 = i;
   j_1 = j;
-  double threshold;
-  threshold = me->getThreshold();
+  double threshold = me->getThreshold();
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for (unsigned int n = 0; n < 2 * range + 1; n++) {
+  int height_ = static_cast<int>(I.getHeight());
+  int width_ = static_cast<int>(I.getWidth());
+  unsigned int msize = me->getMaskSize();
+  int half = (static_cast<int>(msize) - 1) >> 1;
+  int border = half + me->getStrip();
+  const short *mask = me->getMaskTable(maskIndex(alpha, me));
+  unsigned int mask_stride = me->getMaskTableStride();
+  bool useSSE2 = vpCPUFeatures::checkSSE2();
+
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
+
+  // Position of the first query site and of the query site of max likelihood
+  int i_first = 0, j_first = 0;
+  int i_max = 0, j_max = 0;
+  double ifloat_max = 0, jfloat_max = 0;
+  vpImagePoint ip;
+
+  for (int k = -range; k <= range; k++) {
+    double ii = (ifloat + k * salpha);
+    double jj = (jfloat + k * calpha);
+
+    // Display
+    if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RANGE)) {
+      ip.set_i(ii);
+      ip.set_j(jj);
+      vpDisplay::displayCross(I, ip, 1, vpColor::yellow);
+    }
+
     //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me);
+    int i_query = (int)ii;
+    int j_query = (int)jj;
+    double convolution_ = 0.0;
+    if (horsImage(i_query, j_query, border, height_, width_)) {
+      i_query = 0;
+      j_query = 0;
+    } else {
+      convolution_ = mask_sign * maskConvolution(I, mask, msize, mask_stride, static_cast<unsigned int>(i_query - half),
+                                                 static_cast<unsigned int>(j_query - half), useSSE2);
+    }
+    if (k == -range) {
+      i_first = i_query;
+      j_first = j_query;
+    }
 
     // luminance ratio of reference pixel to potential correspondent pixel
     // the luminance must be similar, hence the ratio value should
     // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
+    bool better = false;
     if (test_contraste) {
-      likelihood[n] = fabs(convolution_ + convlt);
-      if (likelihood[n] > threshold) {
+      double likelihood = fabs(convolution_ + convlt);
+      if (likelihood > threshold) {
         contraste = convolution_ / convlt;
         if ((contraste > contraste_min) && (contraste < contraste_max) && fabs(1 - contraste) < diff) {
           diff = fabs(1 - contraste);
-          max_convolution = convolution_;
-          max = likelihood[n];
-          max_rank = (int)n;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
+          max = likelihood;
+          better = true;
         }
       }
+    } else {
+      double likelihood = fabs(2 * convolution_);
+      if (likelihood > max && likelihood > threshold) {
+        max = likelihood;
+        better = true;
+      }
     }
 
-    else {
-      likelihood[n] = fabs(2 * convolution_);
-      if (likelihood[n] > max && likelihood[n] > threshold) {
-        max_convolution = convolution_;
-        max = likelihood[n];
-        max_rank = (int)n;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
-      }
+    if (better) {
+      max_convolution = convolution_;
+      max_rank = k + range;
+      i_max = i_query;
+      j_max = j_query;
+      ifloat_max = ii;
+      jfloat_max = jj;
     }
   }
 
   // test on the likelihood threshold if threshold==-1 then
   // the me->threshold is  selected
 
-  vpImagePoint ip;
-
-  //  if (test_contrast)
   if (max_rank >= 0) {
     if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT)) {
-      ip.set_i(list_query_pixels[max_rank].i);
-      ip.set_j(list_query_pixels[max_rank].j);
+      ip.set_i(i_max);
+      ip.set_j(j_max);
       vpDisplay::displayPoint(I, ip, vpColor::red);
     }
 
-    *this = list_query_pixels[max_rank]; // The vpMeSite2 is replaced by the
-                                         // vpMeSite2 of max likelihood
+    // The vpMeSite is replaced by the query site of max likelihood
+    i = i_max;
+    j = j_max;
+    ifloat = ifloat_max;
+    jfloat = jfloat_max;
+    v = 0;
+    weight = 1;
+    state = NO_SUPPRESSION;
+#ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
+    suppress = 0;
+#endif
     normGradient = vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
-    i_1 = ii_1; // list_query_pixels[max_rank].i ;
-    j_1 = jj_1; // list_query_pixels[max_rank].j ;
-    delete[] list_query_pixels;
-    delete[] likelihood;
+    i_1 = ii_1;
+    j_1 = jj_1;
   } else // none of the query sites is better than the threshold
   {
     if ((selectDisplay == RANGE_RESULT) || (selectDisplay == RESULT)) {
-      ip.set_i(list_query_pixels[0].i);
-      ip.set_j(list_query_pixels[0].j);
+      ip.set_i(i_first);
+      ip.set_j(j_first);
       vpDisplay::displayPoint(I, ip, vpColor::green);
     }
     normGradient = 0;
@@ -580,9 +536,6 @@ void vpMeSite::track(const vpImage<unsigned char> &I, const vpMe *me, const bool
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete[] list_query_pixels;
-    delete[] likelihood; // modif portage
   }
 }
 
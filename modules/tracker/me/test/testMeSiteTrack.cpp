@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Regression test and benchmark of the moving-edges search along the normal.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMeSiteTrack.cpp
+
+  \brief Check that vpMeSite::track() selects the same edges as the original
+  implementation based on getQueryList() and on the floating point masks, and
+  measure the number of sites tracked per second.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/me/vpMe.h>
+#include <visp3/me/vpMeSite.h>
+
+namespace
+{
+double uniform(vpUniRand &rand_uniform, double a, double b) { return a + (b - a) * rand_uniform(); }
+
+// Random rectangles and discs over a noisy background
+void createImage(vpImage<unsigned char> &I, vpUniRand &rand_uniform)
+{
+  I.resize(240, 320);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = (unsigned char)(60 + (i + j) / 8 + uniform(rand_uniform, 0, 10));
+    }
+  }
+  for (unsigned int n = 0; n < 40; n++) {
+    int i0 = (int)uniform(rand_uniform, 0, I.getHeight()), j0 = (int)uniform(rand_uniform, 0, I.getWidth());
+    int h = (int)uniform(rand_uniform, 5, 60), w = (int)uniform(rand_uniform, 5, 60);
+    unsigned char value = (unsigned char)uniform(rand_uniform, 0, 255);
+    bool disc = n % 2 == 0;
+    for (int i = i0; i < i0 + h && i < (int)I.getHeight(); i++) {
+      for (int j = j0; j < j0 + w && j < (int)I.getWidth(); j++) {
+        if (!disc || vpMath::sqr(2. * (i - i0) / h - 1) + vpMath::sqr(2. * (j - j0) / w - 1) < 1) {
+          I[i][j] = value;
+        }
+      }
+    }
+  }
+}
+
+// Original convolution with the floating point masks of vpMe
+double referenceConvolution(vpMeSite &site, const vpImage<unsigned char> &I, const vpMe &me)
+{
+  int half = ((int)me.getMaskSize() - 1) >> 1;
+  int border = half + me.getStrip();
+  if (site.i < border + 1 || site.i > (int)I.getHeight() - border - 3 || site.j < border + 1 ||
+      site.j > (int)I.getWidth() - border - 3) {
+    site.i = 0;
+    site.j = 0;
+    return 0.0;
+  }
+
+  double theta = site.alpha + M_PI / 2;
+  while (theta < 0)
+    theta += M_PI;
+  while (theta > M_PI)
+    theta -= M_PI;
+  int thetadeg = vpMath::round(theta * 180 / M_PI);
+  if (abs(thetadeg) == 180) {
+    thetadeg = 0;
+  }
+  unsigned int index_mask = (unsigned int)(thetadeg / (double)me.getAngleStep());
+
+  double conv = 0.0;
+  for (unsigned int a = 0; a < me.getMaskSize(); a++) {
+    for (unsigned int b = 0; b < me.getMaskSize(); b++) {
+      conv += site.mask_sign * me.getMask()[index_mask][a][b] * I[site.i - half + a][site.j - half + b];
+    }
+  }
+  return conv;
+}
+
+// Original vpMeSite::track()
+void referenceTrack(vpMeSite &site, const vpImage<unsigned char> &I, const vpMe &me, bool test_contraste)
+{
+  int max_rank = -1;
+  double max_convolution = 0, max = 0, contraste = 0, diff = 1e6;
+  unsigned int range = me.getRange();
+  vpMeSite *list_query_pixels = site.getQueryList(I, (int)range);
+  int ii_1 = site.i, jj_1 = site.j;
+  site.i_1 = site.i;
+  site.j_1 = site.j;
+
+  for (unsigned int n = 0; n < 2 * range + 1; n++) {
+    double convolution = referenceConvolution(list_query_pixels[n], I, me);
+    if (test_contraste) {
+      double likelihood = fabs(convolution + site.convlt);
+      if (likelihood > me.getThreshold()) {
+        contraste = convolution / site.convlt;
+        if (contraste > 1 - me.getMu1() && contraste < 1 + me.getMu2() && fabs(1 - contraste) < diff) {
+          diff = fabs(1 - contraste);
+          max_convolution = convolution;
+          max = likelihood;
+          max_rank = (int)n;
+        }
+      }
+    } else {
+      double likelihood = fabs(2 * convolution);
+      if (likelihood > max && likelihood > me.getThreshold()) {
+        max_convolution = convolution;
+        max = likelihood;
+        max_rank = (int)n;
+      }
+    }
+  }
+
+  if (max_rank >= 0) {
+    site = list_query_pixels[max_rank];
+    site.normGradient = vpMath::sqr(max_convolution);
+    site.convlt = max_convolution;
+    site.i_1 = ii_1;
+    site.j_1 = jj_1;
+  } else {
+    site.normGradient = 0;
+    site.setState(std::fabs(contraste) > std::numeric_limits<double>::epsilon() ? vpMeSite::CONSTRAST
+                                                                                : vpMeSite::THRESHOLD);
+  }
+  delete[] list_query_pixels;
+}
+
+bool equal(const vpMeSite &s1, const vpMeSite &s2)
+{
+  return s1.i == s2.i && s1.j == s2.j && s1.i_1 == s2.i_1 && s1.j_1 == s2.j_1 && s1.ifloat == s2.ifloat &&
+         s1.jfloat == s2.jfloat && s1.convlt == s2.convlt && s1.normGradient == s2.normGradient &&
+         s1.getState() == s2.getState() && s1.getWeight() == s2.getWeight();
+}
+
+std::vector<vpMeSite> createSites(const vpImage<unsigned char> &I, vpUniRand &rand_uniform, unsigned int nbSites)
+{
+  std::vector<vpMeSite> sites(nbSites);
+  for (unsigned int n = 0; n < nbSites; n++) {
+    // Some sites are close to the image borders to test the rejected query sites
+    sites[n].init(uniform(rand_uniform, -2, I.getHeight() + 2), uniform(rand_uniform, -2, I.getWidth() + 2),
+                  uniform(rand_uniform, -2 * M_PI, 2 * M_PI), uniform(rand_uniform, -5000, 5000),
+                  n % 3 == 0 ? -1 : 1);
+    sites[n].setWeight(uniform(rand_uniform, 0, 1));
+  }
+  return sites;
+}
+}
+
+int main()
+{
+  try {
+    vpUniRand rand_uniform(1234);
+    vpImage<unsigned char> I;
+    createImage(I, rand_uniform);
+
+    const unsigned int mask_sizes[] = {3, 5, 7, 9, 12};
+    const unsigned int ranges[] = {2, 4, 10};
+    for (unsigned int m = 0; m < sizeof(mask_sizes) / sizeof(mask_sizes[0]); m++) {
+      for (unsigned int r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+        vpMe me;
+        me.setMaskSize(mask_sizes[m]);
+        me.setRange(ranges[r]);
+        me.setThreshold(mask_sizes[m] * mask_sizes[m] * 60.0);
+
+        std::vector<vpMeSite> sites = createSites(I, rand_uniform, 2000);
+        unsigned int nb_tracked = 0;
+        for (size_t n = 0; n < sites.size(); n++) {
+          bool test_contraste = n % 2 == 0;
+          vpMeSite site = sites[n], site_ref = sites[n];
+          site.track(I, &me, test_contraste);
+          referenceTrack(site_ref, I, me, test_contraste);
+          if (!equal(site, site_ref)) {
+            std::cerr << "Mask size " << mask_sizes[m] << ", range " << ranges[r] << ": site (" << sites[n].ifloat
+                      << ", " << sites[n].jfloat << ") tracked at (" << site.i << ", " << site.j
+                      << ") instead of (" << site_ref.i << ", " << site_ref.j << ")" << std::endl;
+            return EXIT_FAILURE;
+          }
+          if (site.getState() == vpMeSite::NO_SUPPRESSION) {
+            nb_tracked++;
+          }
+        }
+        std::cout << "Mask size " << mask_sizes[m] << ", range " << ranges[r] << ": " << nb_tracked << "/"
+                  << sites.size() << " sites tracked as the reference implementation" << std::endl;
+      }
+    }
+
+    // Benchmark with the default moving-edges settings
+    vpMe me;
+    me.setRange(8);
+    std::vector<vpMeSite> sites = createSites(I, rand_uniform, 5000);
+    const unsigned int nb_iter = 20;
+    double t_ref = 0, t = 0;
+    for (unsigned int iter = 0; iter < nb_iter; iter++) {
+      std::vector<vpMeSite> sites_ref = sites, sites_new = sites;
+      double t0 = vpTime::measureTimeMs();
+      for (size_t n = 0; n < sites_ref.size(); n++) {
+        referenceTrack(sites_ref[n], I, me, true);
+      }
+      double t1 = vpTime::measureTimeMs();
+      for (size_t n = 0; n < sites_new.size(); n++) {
+        sites_new[n].track(I, &me, true);
+      }
+      double t2 = vpTime::measureTimeMs();
+      t_ref += t1 - t0;
+      t += t2 - t1;
+    }
+    double nb_sites = (double)nb_iter * sites.size();
+    std::cout << "Reference implementation: " << nb_sites / t_ref * 1000 << " sites/s" << std::endl;
+    std::cout << "vpMeSite::track(): " << nb_sites / t * 1000 << " sites/s" << std::endl;
+
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -46,8 +46,10 @@
 #define vpTemplateTracker_hh
 
 #include <math.h>
+#include <vector>
 
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpRect.h>
 #include <visp3/tt/vpTemplateTrackerHeader.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 #include <visp3/tt/vpTemplateTrackerZone.h>
@@ -89,6 +91,11 @@ protected:
   vpTemplateTrackerZone *zoneTrackedPyr;
 
   vpImage<unsigned char> *pyr_IDes;
+  // Pyramid of the current image and its blurred levels, kept between two
+  // calls to track() to avoid reallocating them at each frame. pyr_I[i - 1]
+  // is the level i, the level 0 being the current image itself
+  vpImage<unsigned char> *pyr_I;
+  vpImage<double> *pyr_BI;
 
   vpMatrix H;
   vpMatrix Hdesire;
@@ -139,6 +146,37 @@ protected:
   vpImage<double> dIy;
   vpTemplateTrackerZone zoneRef_; // Reference zone
 
+  // Template points laid out as separate coordinate arrays for
+  // warpTemplatePoints(), rebuilt when ptTemplate or the selection changes
+  const vpTemplateTrackerPoint *ptTemplateBatch;
+  const bool *ptTemplateSelectBatch;
+  unsigned int templateSizeBatch;
+  std::vector<unsigned int> ptTemplateBatchIndex;
+  std::vector<double> ptTemplateBatchX;
+  std::vector<double> ptTemplateBatchY;
+  // Warped template points and image values sampled at their location
+  std::vector<double> ptWarpedX;
+  std::vector<double> ptWarpedY;
+  std::vector<double> ptWarpedValue;
+  std::vector<bool> ptWarpedIn;
+
+  // Area of the current image around the tracked zone where the pyramid and
+  // the blurred image are computed (see computeROI())
+  bool useROI;
+  bool roiUsed;
+  vpRect roi;
+  // Area of roi where the image and the blurred image are valid (see
+  // checkROI()), and whether a point out of this area was needed
+  double roiValidTop;
+  double roiValidLeft;
+  double roiValidBottom;
+  double roiValidRight;
+  bool roiExceeded;
+  vpRect *roiPyr;
+  vpImage<unsigned char> Iroi;
+  vpImage<unsigned char> IroiPyr;
+  vpImage<double> BIroi;
+
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
   //    vpTemplateTracker(const vpTemplateTracker &)
@@ -176,13 +214,16 @@ public:
     : nbLvlPyr(0), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL), ptTemplateInit(false),
       templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
       ptTemplateSelectInit(false), templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
-      ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(),
-      Hdesire(), HdesirePyr(NULL), HLM(), HLMdesire(), HLMdesirePyr(NULL), HLMdesireInverse(),
-      HLMdesireInversePyr(NULL), G(), gain(0), thresholdGradient(0), costFunctionVerification(false), blur(false),
-      useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(0), mod_j(0),
-      nbParam(), lambdaDep(0), iterationMax(0), iterationGlobale(0), diverge(false), nbIteration(0),
-      useCompositionnal(false), useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(),
-      zoneRef_()
+      ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL),
+      pyr_I(NULL), pyr_BI(NULL), H(), Hdesire(), HdesirePyr(NULL), HLM(), HLMdesire(), HLMdesirePyr(NULL),
+      HLMdesireInverse(), HLMdesireInversePyr(NULL), G(), gain(0), thresholdGradient(0),
+      costFunctionVerification(false), blur(false), useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL),
+      ratioPixelIn(0), mod_i(0), mod_j(0), nbParam(), lambdaDep(0), iterationMax(0), iterationGlobale(0),
+      diverge(false), nbIteration(0), useCompositionnal(false), useInverse(false), Warp(NULL), p(), dp(), X1(), X2(),
+      dW(), BI(), dIx(), dIy(), zoneRef_(), ptTemplateBatch(NULL), ptTemplateSelectBatch(NULL), templateSizeBatch(0),
+      ptTemplateBatchIndex(), ptTemplateBatchX(), ptTemplateBatchY(), ptWarpedX(), ptWarpedY(), ptWarpedValue(),
+      ptWarpedIn(), useROI(true), roiUsed(false), roi(), roiValidTop(0), roiValidLeft(0), roiValidBottom(0),
+      roiValidRight(0), roiExceeded(false), roiPyr(NULL), Iroi(), IroiPyr(), BIroi()
   {
   }
   explicit vpTemplateTracker(vpTemplateTrackerWarp *_warp);
@@ -280,6 +321,17 @@ public:
   void setThresholdGradient(double threshold) { thresholdGradient = threshold; }
   /*! By default Brent usage is disabled. */
   void setUseBrent(bool b) { useBrent = b; }
+  /*!
+    Restrict the computation of the image pyramid and of the blurred image to
+    an area around the tracked zone. The area is the bounding box of the zone
+    warped with the current parameters, enlarged by its own size on each
+    side. The whole image is processed when this area reaches the image
+    borders or covers more than half of the image. By default this feature
+    is enabled.
+
+    \param b : If false, the whole image is always processed.
+   */
+  void setUseROI(bool b) { useROI = b; }
 
   void track(const vpImage<unsigned char> &I);
   void trackRobust(const vpImage<unsigned char> &I);
@@ -288,13 +340,34 @@ protected:
   void computeOptimalBrentGain(const vpImage<unsigned char> &I, vpColVector &tp, double tMI, vpColVector &direction,
                                double &alpha);
   virtual double getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
-  void getGaussianBluredImage(const vpImage<unsigned char> &I) { vpImageFilter::filter(I, BI, fgG, taillef); }
+  /*!
+    When the processing is restricted to roi, check that the pixels read by
+    the bilinear interpolation of the image at (i2, j2) are in the area where
+    the image and its blurred version are valid. Otherwise set roiExceeded,
+    so that track() processes the whole image again.
+
+    \return false if the point must be skipped.
+   */
+  inline bool checkROI(double i2, double j2)
+  {
+    if (roiUsed && !((i2 >= roiValidTop) && (j2 >= roiValidLeft) && (i2 < roiValidBottom) && (j2 < roiValidRight))) {
+      roiExceeded = true;
+      return false;
+    }
+    return true;
+  }
+  bool computeROI(unsigned int height, unsigned int width, unsigned int border);
+  void getGaussianBluredImage(const vpImage<unsigned char> &I);
+  void getGaussPyramidalROI(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI, vpRect &r);
   virtual void initHessienDesired(const vpImage<unsigned char> &I) = 0;
   virtual void initHessienDesiredPyr(const vpImage<unsigned char> &I);
   virtual void initPyramidal(unsigned int nbLvl, unsigned int l0);
   void initTracking(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
+  void setROIValidArea(const vpRect &r);
   virtual void initTrackingPyr(const vpImage<unsigned char> &I, vpTemplateTrackerZone &zone);
   virtual void trackNoPyr(const vpImage<unsigned char> &I) = 0;
   virtual void trackPyr(const vpImage<unsigned char> &I);
+  bool trackPyrLevels(const vpImage<unsigned char> &I);
+  unsigned int warpTemplatePoints(const vpImage<unsigned char> &I, const vpColVector &tp, const bool *select = NULL);
 };
 #endif
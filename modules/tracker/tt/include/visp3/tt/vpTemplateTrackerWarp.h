@@ -204,6 +204,9 @@ public:
   */
   void warp(const double *ut0, const double *vt0, int nb_pt, const vpColVector &p, double *u, double *v);
 
+  virtual void warpPoints(const double *u, const double *v, unsigned int nbPoints, const vpColVector &ParamM,
+                          double *u2, double *v2);
+
   /*!
     Warp a point.
 
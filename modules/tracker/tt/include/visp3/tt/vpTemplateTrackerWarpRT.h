@@ -152,6 +152,20 @@ public:
     */
   void pRondp(const vpColVector &p1, const vpColVector &p2, vpColVector &pres) const;
 
+  /*!
+      Warp a list of points. computeCoeff() has to be called before with the
+      same parameters.
+
+      \param u : List of u coordinates (along the columns) of the points.
+      \param v : List of v coordinates (along the rows) of the points.
+      \param nbPoints : Number of points to warp.
+      \param ParamM : Parameters of the warping function.
+      \param u2 : Resulting u coordinates.
+      \param v2 : Resulting v coordinates.
+    */
+  void warpPoints(const double *u, const double *v, unsigned int nbPoints, const vpColVector &ParamM, double *u2,
+                  double *v2);
+
   /*!
       Warp a point.
 
@@ -71,7 +71,7 @@ double vpTemplateTrackerSSD::getCost(const vpImage<unsigned char> &I, const vpCo
 
     double j2 = X2[0];
     double i2 = X2[1];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       double Tij = ptTemplate[point].val;
       if (!blur)
         IW = I.getValue(i2, j2);
@@ -111,7 +111,7 @@ double vpTemplateTrackerSSD::getSSD(const vpImage<unsigned char> &I, const vpCol
 
     double j2 = X2[0];
     double i2 = X2[1];
-    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0)) {
+    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0) && checkROI(i2, j2)) {
       double Tij = ptTemplate[point].val;
       IW = I.getValue(i2, j2);
       // IW=getSubPixBspline4(I,i2,j2);
@@ -106,50 +106,27 @@ void vpTemplateTrackerSSDInverseCompositional::initHessienDesired(const vpImage<
 void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   vpColVector dpinv(nbParam);
-  double IW;
-  double Tij;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   double alpha = 2.;
   // vpTemplateTrackerPointtest *pt;
   initPosEvalRMS(p);
 
   vpTemplateTrackerPoint *pt;
   do {
-    unsigned int Nbpoint = 0;
     double erreur = 0;
     dp = 0;
-    Warp->computeCoeff(p);
-    for (unsigned int point = 0; point < templateSize; point++) {
-      if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
-        // pt=&ptTemplatetest[point];
-        pt = &ptTemplate[point];
-        i = pt->y;
-        j = pt->x;
-        X1[0] = j;
-        X1[1] = i;
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-        j2 = X2[0];
-        i2 = X2[1];
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-          Tij = pt->val;
-          if (!blur)
-            IW = I.getValue(i2, j2);
-          else
-            IW = BI.getValue(i2, j2);
-          Nbpoint++;
-          double er = (Tij - IW);
-          for (unsigned int it = 0; it < nbParam; it++)
-            dp[it] += er * pt->HiG[it];
-
-          erreur += er * er;
-        }
+    unsigned int Nbpoint = warpTemplatePoints(I, p, useTemplateSelect ? ptTemplateSelect : NULL);
+    for (unsigned int k = 0; k < ptTemplateBatchIndex.size(); k++) {
+      if (ptWarpedIn[k]) {
+        pt = &ptTemplate[ptTemplateBatchIndex[k]];
+        double er = (pt->val - ptWarpedValue[k]);
+        for (unsigned int it = 0; it < nbParam; it++)
+          dp[it] += er * pt->HiG[it];
+
+        erreur += er * er;
       }
     }
     // std::cout << "npoint: " << Nbpoint << std::endl;
@@ -38,6 +38,9 @@
  *
  *****************************************************************************/
 
+#include <string.h>
+
+#include <visp3/core/vpImageTools.h>
 #include <visp3/tt/vpTemplateTracker.h>
 #include <visp3/tt/vpTemplateTrackerBSpline.h>
 
@@ -45,12 +48,15 @@ vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
   : nbLvlPyr(1), l0Pyr(0), pyrInitialised(false), ptTemplate(NULL), ptTemplatePyr(NULL), ptTemplateInit(false),
     templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL),
     ptTemplateSelectInit(false), templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
-    ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(),
-    Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(), HLMdesireInverse(), HLMdesireInversePyr(), G(),
-    gain(1.), thresholdGradient(40), costFunctionVerification(false), blur(true), useBrent(false), nbIterBrent(3),
-    taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0), lambdaDep(0.001),
-    iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(true), useInverse(false),
-    Warp(_warp), p(0), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
+    ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL),
+    pyr_I(NULL), pyr_BI(NULL), H(), Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(), HLMdesireInverse(),
+    HLMdesireInversePyr(), G(), gain(1.), thresholdGradient(40), costFunctionVerification(false), blur(true),
+    useBrent(false), nbIterBrent(3), taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0),
+    lambdaDep(0.001), iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(true),
+    useInverse(false), Warp(_warp), p(0), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_(), ptTemplateBatch(NULL),
+    ptTemplateSelectBatch(NULL), templateSizeBatch(0), ptTemplateBatchIndex(), ptTemplateBatchX(), ptTemplateBatchY(),
+    ptWarpedX(), ptWarpedY(), ptWarpedValue(), ptWarpedIn(), useROI(true), roiUsed(false), roi(), roiValidTop(0),
+    roiValidLeft(0), roiValidBottom(0), roiValidRight(0), roiExceeded(false), roiPyr(NULL), Iroi(), IroiPyr(), BIroi()
 {
   nbParam = Warp->getNbParam();
   p.resize(nbParam);
@@ -116,8 +122,7 @@ void vpTemplateTracker::initTracking(const vpImage<unsigned char> &I, vpTemplate
   // vpTemplateTrackerZPoint ptZ;
   vpImage<double> GaussI;
   vpImageFilter::filter(I, GaussI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+  vpImageFilter::getGradXYGauss2D(I, dIx, dIy, fgG, fgdG, taillef);
 
   unsigned int cpt_point = 0;
   templateSelectSize = 0;
@@ -181,6 +186,11 @@ void vpTemplateTracker::resetTracker()
   // reset the tracker parameters
   p = 0;
 
+  // the template points may be reallocated at the same address
+  ptTemplateBatch = NULL;
+  ptTemplateSelectBatch = NULL;
+  templateSizeBatch = 0;
+
   // 	vpTRACE("resetTracking");
   if (pyrInitialised) {
     if (ptTemplatePyr) {
@@ -266,6 +276,21 @@ void vpTemplateTracker::resetTracker()
       delete[] pyr_IDes;
       pyr_IDes = NULL;
     }
+
+    if (pyr_I) {
+      delete[] pyr_I;
+      pyr_I = NULL;
+    }
+
+    if (pyr_BI) {
+      delete[] pyr_BI;
+      pyr_BI = NULL;
+    }
+
+    if (roiPyr) {
+      delete[] roiPyr;
+      roiPyr = NULL;
+    }
   } else {
     if (ptTemplateInit) {
       for (unsigned int point = 0; point < templateSize; point++) {
@@ -592,6 +617,9 @@ void vpTemplateTracker::initPyramidal(unsigned int nbLvl, unsigned int l0)
 
   zoneTrackedPyr = new vpTemplateTrackerZone[nbLvlPyr];
   pyr_IDes = new vpImage<unsigned char>[nbLvlPyr];
+  pyr_I = (nbLvlPyr > 1) ? new vpImage<unsigned char>[nbLvlPyr - 1] : NULL;
+  pyr_BI = new vpImage<double>[nbLvlPyr];
+  roiPyr = new vpRect[nbLvlPyr];
   ptTemplatePyr = new vpTemplateTrackerPoint *[nbLvlPyr];
   ptTemplateSelectPyr = new bool *[nbLvlPyr];
   ptTemplateSuppPyr = new vpTemplateTrackerPointSuppMIInv *[nbLvlPyr];
@@ -795,107 +823,294 @@ void vpTemplateTracker::track(const vpImage<unsigned char> &I)
 {
   if (nbLvlPyr > 1)
     trackPyr(I);
-  else
-    trackNoPyr(I);
+  else {
+    roiUsed = computeROI(I.getHeight(), I.getWidth(), (taillef - 1) / 2 + 1);
+    try {
+      vpColVector p_init = p;
+      if (roiUsed)
+        setROIValidArea(roi);
+      try {
+        trackNoPyr(I);
+      } catch (...) {
+        if (!roiExceeded)
+          throw;
+      }
+      if (roiExceeded) {
+        // Pixels out of the area where the blurred image is valid were
+        // needed: track again with the whole image blurred
+        p = p_init;
+        roiUsed = false;
+        roiExceeded = false;
+        trackNoPyr(I);
+      }
+    } catch (...) {
+      roiUsed = false;
+      roiExceeded = false;
+      throw;
+    }
+    roiUsed = false;
+  }
 }
 
 void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
 {
   // vpTRACE("trackPyr");
-  vpImage<unsigned char> *pyr_I;
-  //  pyr_I=new vpImage<unsigned char>[nbLvlPyr+1]; // Why +1 ?
-  pyr_I = new vpImage<unsigned char>[nbLvlPyr]; // Why +1 ?
-  pyr_I[0] = I;
-
   try {
-    vpColVector ptemp(nbParam);
     if (nbLvlPyr > 1) {
-      //    vpColVector *p_sauv=new vpColVector[nbLvlPyr];
-      //    for(unsigned int i=0;i<nbLvlPyr;i++)p_sauv[i].resize(nbParam);
-
-      //    p_sauv[0]=p;
-      for (unsigned int i = 1; i < nbLvlPyr; i++) {
-        vpImageFilter::getGaussPyramidal(pyr_I[i - 1], pyr_I[i]);
-        // test getParamPyramidDown
-        /*vpColVector vX_test(2);vX_test[0]=15.;vX_test[1]=30.;
-        vpColVector vX_test2(2);
-        Warp->computeCoeff(p);
-        Warp->computeDenom(vX_test,p);
-        Warp->warpX(vX_test,vX_test2,p);
-        std::cout<<"p = "<<p.t()<<std::endl;*/
-        // std::cout<<"get p down"<<std::endl;
-        Warp->getParamPyramidDown(p, ptemp);
-        p = ptemp;
-        zoneTracked = &zoneTrackedPyr[i];
-
-        //      p_sauv[i]=p;
-        /*std::cout<<"p_down = "<<p.t()<<std::endl;
-
-        vpColVector vX_testd(2);vX_testd[0]=15./2.;vX_testd[1]=30./2.;
-        vpColVector vX_testd2(2);
-        Warp->computeCoeff(p);
-        Warp->computeDenom(vX_testd,p);
-        Warp->warpX(vX_testd,vX_testd2,p);
-        std::cout<<2.*vX_testd2[0]<<","<<2.*vX_testd2[1]<<" <=>
-        "<<vX_test2[0]<<","<<vX_test2[1]<<std::endl;*/
+      // Each level of the pyramid is valid on a smaller area than the
+      // previous one; enlarge the area of the first level accordingly
+      unsigned int border = ((taillef - 1) / 2 + 6) << (nbLvlPyr - 1);
+      roiUsed = computeROI(I.getHeight(), I.getWidth(), border);
+      roiPyr[0] = roi;
+
+      vpColVector p_init = p;
+      bool tracked = false;
+      try {
+        tracked = trackPyrLevels(I);
+      } catch (...) {
+        if (!roiExceeded)
+          throw;
       }
-
-      for (int i = (int)nbLvlPyr - 1; i >= 0; i--) {
-        if (i >= (int)l0Pyr) {
-          templateSize = templateSizePyr[i];
-          ptTemplate = ptTemplatePyr[i];
-          ptTemplateSelect = ptTemplateSelectPyr[i];
-          ptTemplateSupp = ptTemplateSuppPyr[i];
-          ptTemplateCompo = ptTemplateCompoPyr[i];
-          H = HdesirePyr[i];
-          HLM = HLMdesirePyr[i];
-          HLMdesireInverse = HLMdesireInversePyr[i];
-          //        zoneTracked=&zoneTrackedPyr[i];
-          trackRobust(pyr_I[i]);
-        }
-        // std::cout<<"get p up"<<std::endl;
-        //      ptemp=p_sauv[i-1];
-        if (i > 0) {
-          Warp->getParamPyramidUp(p, ptemp);
-          p = ptemp;
-          zoneTracked = &zoneTrackedPyr[i - 1];
-        }
+      if (!tracked) {
+        // Pixels out of the area where a level is valid were needed: build
+        // the pyramid and track again on the whole image
+        p = p_init;
+        zoneTracked = &zoneTrackedPyr[0];
+        roiUsed = false;
+        roiExceeded = false;
+        trackPyrLevels(I);
       }
-#if 0
-        if(l0Pyr==0)
-        {
-          templateSize=templateSizePyr[0];
-          ptTemplate=ptTemplatePyr[0];
-          ptTemplateSelect=ptTemplateSelectPyr[0];
-          ptTemplateSupp=ptTemplateSuppPyr[0];
-          ptTemplateCompo=ptTemplateCompoPyr[0];
-          H=HdesirePyr[0];
-          HLM=HLMdesirePyr[0];
-          HLMdesireInverse=HLMdesireInversePyr[0];
-          zoneTracked=&zoneTrackedPyr[0];
-          trackRobust(pyr_I[0]);
-        }
-
-        if (l0Pyr > 0) {
-    //      for (int l=(int)l0Pyr; l >=0; l--) {
-    //        Warp->getParamPyramidUp(p,ptemp);
-    //        p=ptemp;
-    //      }
-          zoneTracked=&zoneTrackedPyr[0];
-        }
-#endif
-      //    delete [] p_sauv;
     } else {
       // std::cout<<"reviens a tracker de base"<<std::endl;
       trackRobust(I);
     }
-    delete[] pyr_I;
+    roiUsed = false;
   } catch (const vpException &e) {
-    delete[] pyr_I;
+    roiUsed = false;
+    roiExceeded = false;
     throw(vpTrackingException(vpTrackingException::badValue, e.getMessage()));
   }
 }
 
+/*!
+  Build the pyramid of \e I and track the template from the coarsest level
+  to the level l0Pyr.
+
+  \return false if the processing is restricted to roiPyr and the tracking
+  of one level needed pixels out of the area where this level and its blurred
+  image are valid (see checkROI()). The tracking is then stopped at this
+  level.
+ */
+bool vpTemplateTracker::trackPyrLevels(const vpImage<unsigned char> &I)
+{
+  vpColVector ptemp(nbParam);
+  //    vpColVector *p_sauv=new vpColVector[nbLvlPyr];
+  //    for(unsigned int i=0;i<nbLvlPyr;i++)p_sauv[i].resize(nbParam);
+
+  //    p_sauv[0]=p;
+  for (unsigned int i = 1; i < nbLvlPyr; i++) {
+    // pyr_I[i - 1] is the level i, the level 0 being I itself
+    const vpImage<unsigned char> &I_prev = (i == 1) ? I : pyr_I[i - 2];
+    if (roiUsed) {
+      roiPyr[i] = roiPyr[i - 1];
+      getGaussPyramidalROI(I_prev, pyr_I[i - 1], roiPyr[i]);
+    } else {
+      vpImageFilter::getGaussPyramidal(I_prev, pyr_I[i - 1]);
+    }
+    Warp->getParamPyramidDown(p, ptemp);
+    p = ptemp;
+    zoneTracked = &zoneTrackedPyr[i];
+
+    //      p_sauv[i]=p;
+  }
+
+  for (int i = (int)nbLvlPyr - 1; i >= 0; i--) {
+    if (i >= (int)l0Pyr) {
+      templateSize = templateSizePyr[i];
+      ptTemplate = ptTemplatePyr[i];
+      ptTemplateSelect = ptTemplateSelectPyr[i];
+      ptTemplateSupp = ptTemplateSuppPyr[i];
+      ptTemplateCompo = ptTemplateCompoPyr[i];
+      H = HdesirePyr[i];
+      HLM = HLMdesirePyr[i];
+      HLMdesireInverse = HLMdesireInversePyr[i];
+      //        zoneTracked=&zoneTrackedPyr[i];
+      roi = roiPyr[i];
+      if (roiUsed)
+        setROIValidArea(roi);
+      // Use the blurred image kept for this level
+      swap(BI, pyr_BI[i]);
+      try {
+        trackRobust((i == 0) ? I : pyr_I[i - 1]);
+      } catch (...) {
+        swap(BI, pyr_BI[i]);
+        throw;
+      }
+      swap(BI, pyr_BI[i]);
+
+      if (roiExceeded)
+        return false;
+    }
+    // std::cout<<"get p up"<<std::endl;
+    //      ptemp=p_sauv[i-1];
+    if (i > 0) {
+      Warp->getParamPyramidUp(p, ptemp);
+      p = ptemp;
+      zoneTracked = &zoneTrackedPyr[i - 1];
+    }
+  }
+  //    delete [] p_sauv;
+
+  return true;
+}
+
+/*!
+  Compute the area of the current image where the pyramid and the blurred
+  image are needed. This area is the bounding box of the tracked zone warped
+  with the current parameters, enlarged by its own size on each side and by
+  \e border pixels. The result is stored in roi.
+
+  \param height : Height of the image.
+  \param width : Width of the image.
+  \param border : Number of pixels added on each side of the area.
+
+  \return false if the whole image has to be processed: ROI usage is
+  disabled, the area is not fully inside the image or covers more than half
+  of it.
+ */
+bool vpTemplateTracker::computeROI(unsigned int height, unsigned int width, unsigned int border)
+{
+  if ((!useROI) || (zoneTracked == NULL) || (zoneTracked->getNbTriangle() == 0))
+    return false;
+
+  double umin = 0, umax = 0, vmin = 0, vmax = 0;
+  try {
+    Warp->computeCoeff(p);
+    vpTemplateTrackerTriangle triangle;
+    for (unsigned int i = 0; i < zoneTracked->getNbTriangle(); i++) {
+      zoneTracked->getTriangle(i, triangle);
+      for (unsigned int j = 0; j < 3; j++) {
+        triangle.getCorner(j, X1[0], X1[1]);
+        Warp->computeDenom(X1, p);
+        Warp->warpX(X1, X2, p);
+        if ((i == 0 && j == 0) || (X2[0] < umin))
+          umin = X2[0];
+        if ((i == 0 && j == 0) || (X2[0] > umax))
+          umax = X2[0];
+        if ((i == 0 && j == 0) || (X2[1] < vmin))
+          vmin = X2[1];
+        if ((i == 0 && j == 0) || (X2[1] > vmax))
+          vmax = X2[1];
+      }
+    }
+  } catch (...) {
+    return false;
+  }
+
+  double size = (std::max)(umax - umin, vmax - vmin);
+  double top = floor(vmin - size) - border;
+  double left = floor(umin - size) - border;
+  double bottom = ceil(vmax + size) + border + 1;
+  double right = ceil(umax + size) + border + 1;
+
+  // Also rejects the area if the warped zone is not finite
+  if (!((top >= 0) && (left >= 0) && (bottom <= height) && (right <= width)))
+    return false;
+  if ((bottom - top) * (right - left) > 0.5 * height * width)
+    return false;
+
+  roi = vpRect(left, top, right - left, bottom - top);
+  return true;
+}
+
+/*!
+  Set the area where the current image (or pyramid level) and its blurred
+  version are valid when the processing is restricted to \e r, and reset
+  roiExceeded. This area is \e r minus half the filter size on each side.
+  The pixels read by the bilinear interpolation at (i2, j2) are in this area
+  if checkROI() returns true.
+
+  \param r : Area processed by getGaussianBluredImage() and
+  getGaussPyramidalROI().
+ */
+void vpTemplateTracker::setROIValidArea(const vpRect &r)
+{
+  unsigned int rad = (taillef - 1) / 2;
+  roiValidTop = r.getTop() + rad;
+  roiValidLeft = r.getLeft() + rad;
+  roiValidBottom = r.getTop() + r.getHeight() - rad - 1;
+  roiValidRight = r.getLeft() + r.getWidth() - rad - 1;
+  roiExceeded = false;
+}
+
+/*!
+  Compute BI, the image \e I blurred with the Gaussian filter of the tracker.
+
+  When the tracker restricts the processing to roi, only this area of \e I is
+  filtered. BI is then valid on roi minus half the filter size on each side,
+  and keeps its previous content elsewhere.
+
+  \param I : Image to blur.
+ */
+void vpTemplateTracker::getGaussianBluredImage(const vpImage<unsigned char> &I)
+{
+  unsigned int rad = (taillef - 1) / 2;
+  unsigned int top = (unsigned int)roi.getTop();
+  unsigned int left = (unsigned int)roi.getLeft();
+  unsigned int height = (unsigned int)roi.getHeight();
+  unsigned int width = (unsigned int)roi.getWidth();
+
+  if ((!roiUsed) || (height <= 2 * rad) || (width <= 2 * rad) || (top + height > I.getHeight()) ||
+      (left + width > I.getWidth())) {
+    vpImageFilter::filter(I, BI, fgG, taillef);
+    return;
+  }
+
+  if ((BI.getHeight() != I.getHeight()) || (BI.getWidth() != I.getWidth()))
+    BI.resize(I.getHeight(), I.getWidth(), 0.);
+
+  vpImageTools::crop(I, top, left, height, width, Iroi);
+  vpImageFilter::filter(Iroi, BIroi, fgG, taillef);
+  // Values close to the borders of the crop depend on them and are skipped
+  for (unsigned int i = rad; i < height - rad; i++)
+    memcpy(BI[top + i] + left + rad, BIroi[i] + rad, (width - 2 * rad) * sizeof(double));
+}
+
+/*!
+  Compute the next level of a Gaussian pyramid only on an area of the image.
+
+  \param I : Pyramid level, valid on \e r.
+  \param GI : Next pyramid level, resized if needed to the size given by
+  vpImageFilter::getGaussPyramidal(). Outside of the updated area, it keeps
+  its previous content.
+  \param r : Area of \e I to process. Updated with the area of \e GI where
+  the values are the same as those computed on the whole image.
+ */
+void vpTemplateTracker::getGaussPyramidalROI(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI, vpRect &r)
+{
+  unsigned int h = I.getHeight() / 2;
+  unsigned int w = I.getWidth() / 2;
+  if ((GI.getHeight() != h) || (GI.getWidth() != w))
+    GI.resize(h, w, 0);
+
+  // Start on even coordinates to keep the sampling of the whole image
+  unsigned int top = ((unsigned int)r.getTop() + 1) & ~1u;
+  unsigned int left = ((unsigned int)r.getLeft() + 1) & ~1u;
+  unsigned int bottom = (unsigned int)(r.getTop() + r.getHeight());
+  unsigned int right = (unsigned int)(r.getLeft() + r.getWidth());
+
+  vpImageTools::crop(I, top, left, bottom - top, right - left, Iroi);
+  vpImageFilter::getGaussPyramidal(Iroi, IroiPyr);
+
+  // The two first and last rows and columns depend on the crop borders
+  unsigned int hr = IroiPyr.getHeight() - 2;
+  unsigned int wr = IroiPyr.getWidth() - 2;
+  for (unsigned int i = 2; i < hr; i++)
+    memcpy(GI[top / 2 + i] + left / 2 + 2, IroiPyr[i] + 2, (wr - 2) * sizeof(unsigned char));
+
+  r = vpRect(left / 2 + 2, top / 2 + 2, wr - 2, hr - 2);
+}
+
 void vpTemplateTracker::trackRobust(const vpImage<unsigned char> &I)
 {
   if (costFunctionVerification) {
@@ -914,3 +1129,71 @@ void vpTemplateTracker::trackRobust(const vpImage<unsigned char> &I)
   } else
     trackNoPyr(I);
 }
+
+/*!
+  Warp all the template points with the parameters \e tp in a single call to
+  vpTemplateTrackerWarp::warpPoints() and sample the image at the warped
+  locations.
+
+  On return, ptWarpedX, ptWarpedY, ptWarpedValue and ptWarpedIn hold for
+  each batched point its warped coordinates, the value of \e I (or of its
+  blurred version when blur is enabled) and whether it lies inside the image.
+  ptTemplateBatchIndex gives the index in ptTemplate of each batched point.
+
+  \param I : Current image.
+  \param tp : Warp parameters.
+  \param select : If not NULL, only the points whose flag is true are
+  batched.
+
+  \return Number of warped points that lie inside the image.
+ */
+unsigned int vpTemplateTracker::warpTemplatePoints(const vpImage<unsigned char> &I, const vpColVector &tp,
+                                                   const bool *select)
+{
+  if ((ptTemplateBatch != ptTemplate) || (ptTemplateSelectBatch != select) || (templateSizeBatch != templateSize)) {
+    ptTemplateBatchIndex.clear();
+    ptTemplateBatchX.clear();
+    ptTemplateBatchY.clear();
+    for (unsigned int point = 0; point < templateSize; point++) {
+      if ((select == NULL) || select[point]) {
+        ptTemplateBatchIndex.push_back(point);
+        ptTemplateBatchX.push_back((double)ptTemplate[point].x);
+        ptTemplateBatchY.push_back((double)ptTemplate[point].y);
+      }
+    }
+    ptTemplateBatch = ptTemplate;
+    ptTemplateSelectBatch = select;
+    templateSizeBatch = templateSize;
+  }
+
+  unsigned int nbPoints = (unsigned int)ptTemplateBatchIndex.size();
+  ptWarpedX.resize(nbPoints);
+  ptWarpedY.resize(nbPoints);
+  ptWarpedValue.resize(nbPoints);
+  ptWarpedIn.resize(nbPoints);
+  if (nbPoints == 0)
+    return 0;
+
+  Warp->computeCoeff(tp);
+  Warp->warpPoints(&ptTemplateBatchX[0], &ptTemplateBatchY[0], nbPoints, tp, &ptWarpedX[0], &ptWarpedY[0]);
+
+  unsigned int nbIn = 0;
+  double height = (double)I.getHeight() - 1;
+  double width = (double)I.getWidth() - 1;
+  for (unsigned int k = 0; k < nbPoints; k++) {
+    double i2 = ptWarpedY[k];
+    double j2 = ptWarpedX[k];
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < height) && (j2 < width) && checkROI(i2, j2)) {
+      if (!blur)
+        ptWarpedValue[k] = I.getValue(i2, j2);
+      else
+        ptWarpedValue[k] = BI.getValue(i2, j2);
+      ptWarpedIn[k] = true;
+      nbIn++;
+    } else {
+      ptWarpedIn[k] = false;
+    }
+  }
+
+  return nbIn;
+}
@@ -96,15 +96,35 @@ void vpTemplateTrackerWarp::warp(const double *ut0, const double *vt0, int nb_pt
                                  double *v)
 {
   computeCoeff(p);
+  warpPoints(ut0, vt0, (unsigned int)nb_pt, p, u, v);
+}
+
+/*!
+  Warp a list of points. computeCoeff() has to be called before with the same
+  parameters.
+
+  The warping functions provided with ViSP reimplement this method with a
+  single loop over the points, avoiding a call to computeDenom() and warpX()
+  for each of them.
+
+  \param u : List of u coordinates (along the columns) of the points.
+  \param v : List of v coordinates (along the rows) of the points.
+  \param nbPoints : Number of points to warp.
+  \param ParamM : Parameters of the warping function.
+  \param u2 : Resulting u coordinates.
+  \param v2 : Resulting v coordinates.
+*/
+void vpTemplateTrackerWarp::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                       const vpColVector &ParamM, double *u2, double *v2)
+{
   vpColVector X1(2), X2(2);
-  for (int i = 0; i < nb_pt; i++) {
-    X1[0] = ut0[i];
-    X1[1] = vt0[i];
-    computeDenom(X1, p);
-    warpX(X1, X2, p);
-    u[i] = X2[0];
-    v[i] = X2[1];
-    // std::cout<<"warp "<<X2[0]<<","<<X2[1]<<std::endl;
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    X1[0] = u[i];
+    X1[1] = v[i];
+    computeDenom(X1, ParamM);
+    warpX(X1, X2, ParamM);
+    u2[i] = X2[0];
+    v2[i] = X2[1];
   }
 }
 
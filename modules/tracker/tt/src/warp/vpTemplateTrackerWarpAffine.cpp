@@ -101,6 +101,17 @@ void vpTemplateTrackerWarpAffine::warpX(const vpColVector &vX, vpColVector &vXre
   vXres[1] = ParamM[1] * vX[0] + (1.0 + ParamM[3]) * vX[1] + ParamM[5];
 }
 
+void vpTemplateTrackerWarpAffine::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                             const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double a0 = 1.0 + ParamM[0], a1 = ParamM[1], a2 = ParamM[2];
+  const double a3 = 1.0 + ParamM[3], a4 = ParamM[4], a5 = ParamM[5];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    u2[i] = a0 * u[i] + a2 * v[i] + a4;
+    v2[i] = a1 * u[i] + a3 * v[i] + a5;
+  }
+}
+
 void vpTemplateTrackerWarpAffine::dWarp(const vpColVector &X1, const vpColVector & /*X2*/,
                                         const vpColVector & /*ParamM*/, vpMatrix &dW_)
 {
@@ -123,6 +123,23 @@ void vpTemplateTrackerWarpHomography::warpX(const vpColVector &vX, vpColVector &
                               "Division by zero in vpTemplateTrackerWarpHomography::warpX()"));
 }
 
+void vpTemplateTrackerWarpHomography::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                                 const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double h00 = 1. + ParamM[0], h10 = ParamM[1], h20 = ParamM[2];
+  const double h01 = ParamM[3], h11 = 1. + ParamM[4], h21 = ParamM[5];
+  const double h02 = ParamM[6], h12 = ParamM[7];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    const double d = (1. / (h20 * u[i] + h21 * v[i] + 1.));
+    if (d <= 0) {
+      throw(vpTrackingException(vpTrackingException::fatalError,
+                                "Division by zero in vpTemplateTrackerWarpHomography::warpPoints()"));
+    }
+    u2[i] = (h00 * u[i] + h01 * v[i] + h02) * d;
+    v2[i] = (h10 * u[i] + h11 * v[i] + h12) * d;
+  }
+}
+
 void vpTemplateTrackerWarpHomography::dWarp(const vpColVector &X1, const vpColVector &X2,
                                             const vpColVector & /*ParamM*/, vpMatrix &dW_)
 {
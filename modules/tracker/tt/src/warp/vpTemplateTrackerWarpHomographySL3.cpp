@@ -257,6 +257,20 @@ void vpTemplateTrackerWarpHomographySL3::warpX(const vpColVector &vX, vpColVecto
   vXres[0] = (j * G[0][0] + i * G[0][1] + G[0][2]) / denom;
   vXres[1] = (j * G[1][0] + i * G[1][1] + G[1][2]) / denom;
 }
+
+void vpTemplateTrackerWarpHomographySL3::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                                    const vpColVector & /*ParamM*/, double *u2, double *v2)
+{
+  const double g00 = G[0][0], g01 = G[0][1], g02 = G[0][2];
+  const double g10 = G[1][0], g11 = G[1][1], g12 = G[1][2];
+  const double g20 = G[2][0], g21 = G[2][1], g22 = G[2][2];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    const double d = u[i] * g20 + v[i] * g21 + g22;
+    u2[i] = (u[i] * g00 + v[i] * g01 + g02) / d;
+    v2[i] = (u[i] * g10 + v[i] * g11 + g12) / d;
+  }
+}
+
 void vpTemplateTrackerWarpHomographySL3::warpX(const int &i, const int &j, double &i2, double &j2,
                                                const vpColVector & /*ParamM*/)
 {
@@ -93,6 +93,19 @@ void vpTemplateTrackerWarpRT::warpX(const vpColVector &vX, vpColVector &vXres, c
   vXres[1] = (sin(ParamM[0]) * vX[0]) + (cos(ParamM[0]) * vX[1]) + ParamM[2];
 }
 
+void vpTemplateTrackerWarpRT::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                         const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double c = cos(ParamM[0]);
+  const double s = sin(ParamM[0]);
+  const double tu = ParamM[1];
+  const double tv = ParamM[2];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    u2[i] = (c * u[i]) - (s * v[i]) + tu;
+    v2[i] = (s * u[i]) + (c * v[i]) + tv;
+  }
+}
+
 void vpTemplateTrackerWarpRT::dWarp(const vpColVector &X1, const vpColVector & /*X2*/, const vpColVector &ParamM,
                                     vpMatrix &dW_)
 {
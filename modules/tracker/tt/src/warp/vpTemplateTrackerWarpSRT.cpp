@@ -96,6 +96,19 @@ void vpTemplateTrackerWarpSRT::warpX(const vpColVector &vX, vpColVector &vXres,
   vXres[1] = ((1.0 + ParamM[0]) * sin(ParamM[1]) * vX[0]) + ((1.0 + ParamM[0]) * cos(ParamM[1]) * vX[1]) + ParamM[3];
 }
 
+void vpTemplateTrackerWarpSRT::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                          const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double c = (1.0 + ParamM[0]) * cos(ParamM[1]);
+  const double s = (1.0 + ParamM[0]) * sin(ParamM[1]);
+  const double tu = ParamM[2];
+  const double tv = ParamM[3];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    u2[i] = (c * u[i]) - (s * v[i]) + tu;
+    v2[i] = (s * u[i]) + (c * v[i]) + tv;
+  }
+}
+
 void vpTemplateTrackerWarpSRT::dWarp(const vpColVector &X1, const vpColVector & /*X2*/, const vpColVector &ParamM,
                                      vpMatrix &dW_)
 {
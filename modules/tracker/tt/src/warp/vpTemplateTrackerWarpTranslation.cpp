@@ -90,6 +90,17 @@ void vpTemplateTrackerWarpTranslation::warpX(const vpColVector &vX, vpColVector
   vXres[1] = vX[1] + ParamM[1];
 }
 
+void vpTemplateTrackerWarpTranslation::warpPoints(const double *u, const double *v, unsigned int nbPoints,
+                                                  const vpColVector &ParamM, double *u2, double *v2)
+{
+  const double tu = ParamM[0];
+  const double tv = ParamM[1];
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    u2[i] = u[i] + tu;
+    v2[i] = v[i] + tv;
+  }
+}
+
 void vpTemplateTrackerWarpTranslation::dWarp(const vpColVector & /*X1*/, const vpColVector & /*X2*/,
                                              const vpColVector & /*ParamM*/, vpMatrix &dW_)
 {
@@ -74,7 +74,7 @@ double vpTemplateTrackerZNCC::getCost(const vpImage<unsigned char> &I, const vpC
 
     j2 = X2[0];
     i2 = X2[1];
-    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0)) {
+    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0) && checkROI(i2, j2)) {
       Tij = ptTemplate[point].val;
       if (!blur)
         IW = I.getValue(i2, j2);
@@ -106,7 +106,7 @@ double vpTemplateTrackerZNCC::getCost(const vpImage<unsigned char> &I, const vpC
 
     j2 = X2[0];
     i2 = X2[1];
-    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0)) {
+    if ((j2 < I.getWidth() - 1) && (i2 < I.getHeight() - 1) && (i2 > 0) && (j2 > 0) && checkROI(i2, j2)) {
       Tij = ptTemplate[point].val;
       if (!blur)
         IW = I.getValue(i2, j2);
@@ -49,9 +49,8 @@ vpTemplateTrackerZNCCForwardAdditional::vpTemplateTrackerZNCCForwardAdditional(v
 void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+    getGaussianBluredImage(I);
+  vpImageFilter::getGradXYGauss2D(I, dIx, dIy, fgG, fgdG, taillef);
 
   vpImage<double> dIxx, dIxy, dIyx, dIyy;
   vpImageFilter::getGradX(dIx, dIxx, fgdG, taillef);
@@ -83,7 +82,7 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
     j2 = X2[0];
     i2 = X2[1];
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Tij = ptTemplate[point].val;
 
       if (!blur)
@@ -112,7 +111,7 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
     j2 = X2[0];
     i2 = X2[1];
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Tij = ptTemplate[point].val;
 
       if (!blur)
@@ -157,9 +156,8 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
 void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+    getGaussianBluredImage(I);
+  vpImageFilter::getGradXYGauss2D(I, dIx, dIy, fgG, fgdG, taillef);
 
   /*vpImage<double> dIxx,dIxy,dIyx,dIyy;
   getGradX(dIx, dIxx, fgdG,taillef);
@@ -197,7 +195,7 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
 
       j2 = X2[0];
       i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
         Tij = ptTemplate[point].val;
 
         if (!blur)
@@ -230,7 +228,7 @@ void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned c
 
       j2 = X2[0];
       i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
         Tij = ptTemplate[point].val;
 
         if (!blur)
@@ -53,8 +53,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<un
 {
   // std::cout<<"Initialise precomputed value of Compositionnal
   // Inverse"<<std::endl;
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+  vpImageFilter::getGradXYGauss2D(I, dIx, dIy, fgG, fgdG, taillef);
 
   for (unsigned int point = 0; point < templateSize; point++) {
     int i = ptTemplate[point].y;
@@ -80,9 +79,8 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
   initCompInverse(I);
 
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+    getGaussianBluredImage(I);
+  vpImageFilter::getGradXYGauss2D(I, dIx, dIy, fgG, fgdG, taillef);
 
   vpImage<double> dIxx, dIxy, dIyx, dIyy;
   vpImageFilter::getGradX(dIx, dIxx, fgdG, taillef);
@@ -119,7 +117,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
     j2 = X2[0];
     i2 = X2[1];
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Iref = ptTemplate[point].val;
 
       if (!blur)
@@ -178,7 +176,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
     j2 = X2[0];
     i2 = X2[1];
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Iref = ptTemplate[point].val;
 
       if (!blur)
@@ -246,45 +244,24 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
 void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   // double erreur=0;
   vpColVector dpinv(nbParam);
   double Ic;
   double Iref;
   unsigned int iteration = 0;
-  int i, j;
-  double i2, j2;
   initPosEvalRMS(p);
   do {
-    unsigned int Nbpoint = 0;
     // erreur=0;
     G = 0;
-    Warp->computeCoeff(p);
+    unsigned int Nbpoint = warpTemplatePoints(I, p);
     double moyIref = 0;
     double moyIc = 0;
     for (unsigned int point = 0; point < templateSize; point++) {
-      i = ptTemplate[point].y;
-      j = ptTemplate[point].x;
-      X1[0] = j;
-      X1[1] = i;
-
-      Warp->computeDenom(X1, p);
-      Warp->warpX(X1, X2, p);
-
-      j2 = X2[0];
-      i2 = X2[1];
-      if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
-        Iref = ptTemplate[point].val;
-
-        if (!blur)
-          Ic = I.getValue(i2, j2);
-        else
-          Ic = BI.getValue(i2, j2);
-
-        Nbpoint++;
-        moyIref += Iref;
-        moyIc += Ic;
+      if (ptWarpedIn[point]) {
+        moyIref += ptTemplate[point].val;
+        moyIc += ptWarpedValue[point];
       }
     }
     if (Nbpoint > 0) {
@@ -298,23 +275,9 @@ void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigne
       sIrefdIref = 0;
 
       for (unsigned int point = 0; point < templateSize; point++) {
-        i = ptTemplate[point].y;
-        j = ptTemplate[point].x;
-        X1[0] = j;
-        X1[1] = i;
-
-        Warp->computeDenom(X1, p);
-        Warp->warpX(X1, X2, p);
-
-        j2 = X2[0];
-        i2 = X2[1];
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+        if (ptWarpedIn[point]) {
           Iref = ptTemplate[point].val;
-
-          if (!blur)
-            Ic = I.getValue(i2, j2);
-          else
-            Ic = BI.getValue(i2, j2);
+          Ic = ptWarpedValue[point];
 
           double prod = (Ic - moyIc);
           for (unsigned int it = 0; it < nbParam; it++)
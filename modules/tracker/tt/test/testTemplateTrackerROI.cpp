@@ -0,0 +1,197 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test template tracking restricted to an area around the tracked zone.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerROI.cpp
+
+  \brief Test that restricting the pyramid and the blur to an area around the
+  tracked zone gives the same parameters as processing the whole image.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/tt/vpTemplateTrackerSSDForwardAdditional.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerZNCCInverseCompositional.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Smooth textured HD image, translated by (tu, tv) and rotated by theta
+// around the tracked area. A larger scale gives a smoother texture
+void generateImage(vpImage<unsigned char> &I, double tu, double tv, double theta, double scale = 1)
+{
+  unsigned int height = 720, width = 1280;
+  I.resize(height, width);
+  double c = cos(theta), s = sin(theta);
+  double u0 = 400, v0 = 300;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      double u = c * (j - u0 - tu) + s * (i - v0 - tv) + u0;
+      double v = -s * (j - u0 - tu) + c * (i - v0 - tv) + v0;
+      double val =
+          127.5 + 60. * sin(u / (9. * scale)) * cos(v / (13. * scale)) + 60. * cos((u + 2 * v) / (23. * scale));
+      I[i][j] = (unsigned char)vpMath::round(val);
+    }
+  }
+}
+
+// Track a smooth motion. With a non zero jump, the image is translated by
+// jump pixels along the columns between the frames 5 and 6, more than the
+// margin of the area processed around the tracked zone, on a smoother texture
+// that lets the tracker follow this motion
+template <class Tracker>
+bool testTracking(vpTemplateTrackerWarp &warp, vpTemplateTrackerWarp &warp_full, const std::string &name,
+                  unsigned int nbLvlPyr, double jump = 0)
+{
+  double scale = (jump != 0) ? 6 : 1;
+  vpImage<unsigned char> I;
+  generateImage(I, 0, 0, 0, scale);
+
+  std::vector<vpImagePoint> v_ip;
+  v_ip.push_back(vpImagePoint(250, 350));
+  v_ip.push_back(vpImagePoint(250, 450));
+  v_ip.push_back(vpImagePoint(350, 450));
+  v_ip.push_back(vpImagePoint(250, 350));
+  v_ip.push_back(vpImagePoint(350, 450));
+  v_ip.push_back(vpImagePoint(350, 350));
+
+  Tracker tracker(&warp), tracker_full(&warp_full);
+  tracker_full.setUseROI(false);
+  Tracker *trackers[2] = {&tracker, &tracker_full};
+  for (unsigned int k = 0; k < 2; k++) {
+    trackers[k]->setSampling(2, 2);
+    trackers[k]->setLambda(0.001);
+    trackers[k]->setIterationMax(30);
+    if (nbLvlPyr > 1)
+      trackers[k]->setPyramidal(nbLvlPyr, 0);
+    trackers[k]->initFromPoints(I, v_ip);
+  }
+
+  double t_roi = 0, t_full = 0;
+  for (unsigned int frame = 1; frame <= 10; frame++) {
+    generateImage(I, 0.7 * frame + (frame > 5 ? jump : 0), 0.4 * frame, 0.003 * frame, scale);
+
+    // When the tracking fails, it must fail the same way in both cases
+    bool lost = false, lost_full = false;
+    double t = vpTime::measureTimeMs();
+    try {
+      tracker.track(I);
+    } catch (const vpException &) {
+      lost = true;
+    }
+    t_roi += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    try {
+      tracker_full.track(I);
+    } catch (const vpException &) {
+      lost_full = true;
+    }
+    t_full += vpTime::measureTimeMs() - t;
+
+    if (lost != lost_full) {
+      std::cerr << name << ": frame " << frame << " tracking lost only " << (lost ? "with" : "without") << " ROI"
+                << std::endl;
+      return false;
+    }
+    if (lost) {
+      std::cout << name << ": tracking lost at frame " << frame << std::endl;
+      break;
+    }
+
+    vpColVector p = tracker.getp(), p_full = tracker_full.getp();
+    for (unsigned int k = 0; k < p.size(); k++) {
+      if (p[k] != p_full[k]) {
+        std::cerr << name << ": frame " << frame << " parameters differ:\n" << p.t() << "\n" << p_full.t() << std::endl;
+        return false;
+      }
+    }
+  }
+
+  std::cout << name << (jump != 0 ? " with a jump" : "") << " with " << nbLvlPyr << " pyramid level(s): " << t_roi
+            << " ms, whole image " << t_full << " ms" << std::endl;
+
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+  try {
+    for (unsigned int nbLvlPyr = 1; nbLvlPyr <= 3; nbLvlPyr++) {
+      vpTemplateTrackerWarpHomography homography, homography_full;
+      if (!testTracking<vpTemplateTrackerSSDInverseCompositional>(homography, homography_full, "SSD IC homography",
+                                                                  nbLvlPyr)) {
+        return EXIT_FAILURE;
+      }
+      vpTemplateTrackerWarpAffine affine, affine_full;
+      if (!testTracking<vpTemplateTrackerZNCCInverseCompositional>(affine, affine_full, "ZNCC IC affine", nbLvlPyr)) {
+        return EXIT_FAILURE;
+      }
+      vpTemplateTrackerWarpAffine affine_fa, affine_fa_full;
+      if (!testTracking<vpTemplateTrackerSSDForwardAdditional>(affine_fa, affine_fa_full, "SSD FA affine",
+                                                               nbLvlPyr)) {
+        return EXIT_FAILURE;
+      }
+
+      // The zone moves out of the processed area during the iterations
+      vpTemplateTrackerWarpAffine affine_ic_jump, affine_ic_jump_full;
+      if (!testTracking<vpTemplateTrackerSSDInverseCompositional>(affine_ic_jump, affine_ic_jump_full, "SSD IC affine",
+                                                                  nbLvlPyr, 150)) {
+        return EXIT_FAILURE;
+      }
+      vpTemplateTrackerWarpAffine affine_jump, affine_jump_full;
+      if (!testTracking<vpTemplateTrackerZNCCInverseCompositional>(affine_jump, affine_jump_full, "ZNCC IC affine",
+                                                                   nbLvlPyr, 150)) {
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testTemplateTrackerROI is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,314 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test batched warp of the template tracker points.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testTemplateTrackerWarp.cpp
+
+  \brief Test that vpTemplateTrackerWarp::warpPoints() gives the same result
+  as vpTemplateTrackerWarp::warpX() for all the warps, and that the inverse
+  compositional SSD tracker converges to the same parameters as the per-point
+  implementation, up to rounding errors.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/tt/vpTemplateTrackerSSDInverseCompositional.h>
+#include <visp3/tt/vpTemplateTrackerWarpAffine.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomography.h>
+#include <visp3/tt/vpTemplateTrackerWarpHomographySL3.h>
+#include <visp3/tt/vpTemplateTrackerWarpRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpSRT.h>
+#include <visp3/tt/vpTemplateTrackerWarpTranslation.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Inverse compositional SSD tracker that warps and samples the template
+// points one at a time, as done before the batched warp was introduced
+class vpTemplateTrackerSSDInverseCompositionalReference : public vpTemplateTrackerSSDInverseCompositional
+{
+public:
+  explicit vpTemplateTrackerSSDInverseCompositionalReference(vpTemplateTrackerWarp *warp)
+    : vpTemplateTrackerSSDInverseCompositional(warp)
+  {
+  }
+
+protected:
+  void trackNoPyr(const vpImage<unsigned char> &I)
+  {
+    if (blur)
+      vpImageFilter::filter(I, BI, fgG, taillef);
+
+    vpColVector dpinv(nbParam);
+    unsigned int iteration = 0;
+    initPosEvalRMS(p);
+
+    do {
+      unsigned int Nbpoint = 0;
+      dp = 0;
+      Warp->computeCoeff(p);
+      for (unsigned int point = 0; point < templateSize; point++) {
+        if ((!useTemplateSelect) || (ptTemplateSelect[point])) {
+          vpTemplateTrackerPoint *pt = &ptTemplate[point];
+          X1[0] = pt->x;
+          X1[1] = pt->y;
+          Warp->computeDenom(X1, p);
+          Warp->warpX(X1, X2, p);
+          double j2 = X2[0];
+          double i2 = X2[1];
+
+          if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+            double IW;
+            if (!blur)
+              IW = I.getValue(i2, j2);
+            else
+              IW = BI.getValue(i2, j2);
+            Nbpoint++;
+            double er = (pt->val - IW);
+            for (unsigned int it = 0; it < nbParam; it++)
+              dp[it] += er * pt->HiG[it];
+          }
+        }
+      }
+      if (Nbpoint == 0) {
+        deletePosEvalRMS();
+        throw(vpTrackingException(vpTrackingException::notEnoughPointError, "No points in the template"));
+      }
+      dp = gain * dp;
+      Warp->getParamInverse(dp, dpinv);
+      Warp->pRondp(p, dpinv, p);
+      iteration++;
+
+      computeEvalRMS(p);
+    } while ((iteration < iterationMax) && (evolRMS > threshold_RMS));
+
+    nbIteration = iteration;
+    deletePosEvalRMS();
+  }
+};
+
+// Smooth textured image, translated by (tu, tv) and rotated by theta around
+// the image center
+void generateImage(vpImage<unsigned char> &I, double tu, double tv, double theta)
+{
+  unsigned int height = 240, width = 320;
+  I.resize(height, width);
+  double c = cos(theta), s = sin(theta);
+  double u0 = width / 2., v0 = height / 2.;
+  for (unsigned int i = 0; i < height; i++) {
+    for (unsigned int j = 0; j < width; j++) {
+      double u = c * (j - u0 - tu) + s * (i - v0 - tv) + u0;
+      double v = -s * (j - u0 - tu) + c * (i - v0 - tv) + v0;
+      double val = 127.5 + 60. * sin(u / 7.) * cos(v / 11.) + 60. * cos((u + v) / 17.);
+      I[i][j] = (unsigned char)vpMath::round(val);
+    }
+  }
+}
+
+// The batched and the per-point implementations do not evaluate the
+// expressions in the same order, and the compiler may contract them into
+// fused multiply-adds (-mfma), so they only agree up to rounding
+bool equal(double a, double b, double tolerance = 1e-12)
+{
+  return std::fabs(a - b) <= tolerance * (std::max)(1.0, (std::max)(std::fabs(a), std::fabs(b)));
+}
+
+bool testWarpPoints(vpTemplateTrackerWarp &warp, const std::string &name, vpUniRand &rand)
+{
+  unsigned int nbParam = warp.getNbParam();
+  unsigned int nbPoints = 100000;
+  std::vector<double> u(nbPoints), v(nbPoints), u2(nbPoints), v2(nbPoints);
+  for (unsigned int k = 0; k < nbPoints; k++) {
+    u[k] = (double)(int)(rand() * 640);
+    v[k] = (double)(int)(rand() * 480);
+  }
+
+  vpColVector p(nbParam);
+  for (unsigned int k = 0; k < nbParam; k++)
+    p[k] = 0.01 * (rand() - 0.5);
+  if (name == "translation" || name == "SRT" || name == "RT") {
+    p[nbParam - 2] = 10 * (rand() - 0.5);
+    p[nbParam - 1] = 10 * (rand() - 0.5);
+  }
+  // Keep the homography denominator positive on the whole image
+  if (name == "homography") {
+    p[2] = 1e-5 * (rand() - 0.5);
+    p[5] = 1e-5 * (rand() - 0.5);
+  }
+
+  int nbIter = 20;
+  vpColVector X1(2), X2(2);
+  double t_ref = vpTime::measureTimeMs();
+  for (int iter = 0; iter < nbIter; iter++) {
+    warp.computeCoeff(p);
+    for (unsigned int k = 0; k < nbPoints; k++) {
+      X1[0] = u[k];
+      X1[1] = v[k];
+      warp.computeDenom(X1, p);
+      warp.warpX(X1, X2, p);
+    }
+  }
+  t_ref = vpTime::measureTimeMs() - t_ref;
+
+  double t_batch = vpTime::measureTimeMs();
+  for (int iter = 0; iter < nbIter; iter++) {
+    warp.computeCoeff(p);
+    warp.warpPoints(&u[0], &v[0], nbPoints, p, &u2[0], &v2[0]);
+  }
+  t_batch = vpTime::measureTimeMs() - t_batch;
+
+  std::cout << name << ": warpX " << t_ref / nbIter << " ms, warpPoints " << t_batch / nbIter << " ms" << std::endl;
+
+  warp.computeCoeff(p);
+  for (unsigned int k = 0; k < nbPoints; k++) {
+    X1[0] = u[k];
+    X1[1] = v[k];
+    warp.computeDenom(X1, p);
+    warp.warpX(X1, X2, p);
+    if (!equal(X2[0], u2[k]) || !equal(X2[1], v2[k])) {
+      std::cerr << name << ": point " << k << " (" << u[k] << ", " << v[k] << ") warpX gives (" << X2[0] << ", "
+                << X2[1] << ") while warpPoints gives (" << u2[k] << ", " << v2[k] << ")" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool testTracking(vpTemplateTrackerWarp &warp, vpTemplateTrackerWarp &warp_ref, const std::string &name,
+                  bool template_select)
+{
+  vpImage<unsigned char> I;
+  generateImage(I, 0, 0, 0);
+
+  std::vector<vpImagePoint> v_ip;
+  v_ip.push_back(vpImagePoint(70, 110));
+  v_ip.push_back(vpImagePoint(70, 210));
+  v_ip.push_back(vpImagePoint(170, 210));
+  v_ip.push_back(vpImagePoint(70, 110));
+  v_ip.push_back(vpImagePoint(170, 210));
+  v_ip.push_back(vpImagePoint(170, 110));
+
+  vpTemplateTrackerSSDInverseCompositional tracker(&warp);
+  vpTemplateTrackerSSDInverseCompositionalReference tracker_ref(&warp_ref);
+  vpTemplateTrackerSSDInverseCompositional *trackers[2] = {&tracker, &tracker_ref};
+  for (unsigned int k = 0; k < 2; k++) {
+    trackers[k]->setSampling(2, 2);
+    trackers[k]->setLambda(0.001);
+    trackers[k]->setIterationMax(50);
+    trackers[k]->setUseTemplateSelect(template_select);
+    trackers[k]->initFromPoints(I, v_ip);
+  }
+
+  double t_batch = 0, t_ref = 0;
+  for (unsigned int frame = 1; frame <= 10; frame++) {
+    generateImage(I, 0.8 * frame, 0.5 * frame, 0.004 * frame);
+
+    double t = vpTime::measureTimeMs();
+    tracker.track(I);
+    t_batch += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    tracker_ref.track(I);
+    t_ref += vpTime::measureTimeMs() - t;
+
+    vpColVector p = tracker.getp(), p_ref = tracker_ref.getp();
+    for (unsigned int k = 0; k < p.size(); k++) {
+      // The rounding differences are amplified by the Gauss-Newton iterations
+      if (!equal(p[k], p_ref[k], 1e-9)) {
+        std::cerr << name << ": frame " << frame << " parameters differ:\n" << p.t() << "\n" << p_ref.t() << std::endl;
+        return false;
+      }
+    }
+    if (tracker.getNbIteration() != tracker_ref.getNbIteration()) {
+      std::cerr << name << ": frame " << frame << " iterations differ" << std::endl;
+      return false;
+    }
+  }
+
+  std::cout << name << (template_select ? " (template select)" : "") << ": tracking " << t_batch
+            << " ms, per-point tracking " << t_ref << " ms" << std::endl;
+
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+  try {
+    vpUniRand rand(42);
+
+    vpTemplateTrackerWarpTranslation translation, translation_ref;
+    vpTemplateTrackerWarpSRT srt, srt_ref;
+    vpTemplateTrackerWarpRT rt, rt_ref;
+    vpTemplateTrackerWarpAffine affine, affine_ref;
+    vpTemplateTrackerWarpHomography homography, homography_ref;
+    vpTemplateTrackerWarpHomographySL3 sl3, sl3_ref;
+
+    vpTemplateTrackerWarp *warps[6] = {&translation, &srt, &rt, &affine, &homography, &sl3};
+    vpTemplateTrackerWarp *warps_ref[6] = {&translation_ref, &srt_ref, &rt_ref, &affine_ref, &homography_ref, &sl3_ref};
+    std::string names[6] = {"translation", "SRT", "RT", "affine", "homography", "SL3"};
+
+    for (unsigned int k = 0; k < 6; k++) {
+      if (!testWarpPoints(*warps[k], names[k], rand)) {
+        return EXIT_FAILURE;
+      }
+    }
+
+    for (unsigned int k = 0; k < 6; k++) {
+      if (!testTracking(*warps[k], *warps_ref[k], names[k], false)) {
+        return EXIT_FAILURE;
+      }
+    }
+    if (!testTracking(homography, homography_ref, names[4], true)) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testTemplateTrackerWarp is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -172,7 +172,7 @@ double vpTemplateTrackerMI::getCost(const vpImage<unsigned char> &I, const vpCol
     double i2 = X2[1];
 
     // Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Nbpoint++;
 
       double Tij = ptTemplate[point].val;
@@ -274,7 +274,7 @@ double vpTemplateTrackerMI::getNormalizedCost(const vpImage<unsigned char> &I, c
     double j2 = X2[0];
     double i2 = X2[1];
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Nbpoint++;
       double Tij = ptTemplate[point].val;
       if (!blur)
@@ -694,7 +694,7 @@ double vpTemplateTrackerMI::getMI(const vpImage<unsigned char> &I, int &nc, cons
     double i2 = X2[1];
 
     // Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth()) - 1) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth()) - 1 && checkROI(i2, j2)) {
       Nbpoint++;
 
       double Tij = ptTemplate[point].val;
@@ -807,7 +807,7 @@ double vpTemplateTrackerMI::getMI256(const vpImage<unsigned char> &I, const vpCo
     double i2 = X2[1];
 
     // Tij=Templ[i-(int)Triangle->GetMiny()][j-(int)Triangle->GetMinx()];
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth()) - 1) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth()) - 1 && checkROI(i2, j2)) {
       Nbpoint++;
 
       Tij = (unsigned int)ptTemplate[point].val;
@@ -90,8 +90,7 @@ void vpTemplateTrackerMIInverseCompositional::initCompInverse(const vpImage<unsi
 {
   ptTemplateSupp = new vpTemplateTrackerPointSuppMIInv[templateSize];
 
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG, fgdG, taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG, fgdG, taillef);
+  vpImageFilter::getGradXYGauss2D(I, dIx, dIy, fgG, fgdG, taillef);
 
   if (ApproxHessian != HESSIAN_NONSECOND && ApproxHessian != HESSIAN_0 && ApproxHessian != HESSIAN_NEW &&
       ApproxHessian != HESSIAN_YOUCEF) {
@@ -148,7 +147,7 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
   // erreur=0;
 
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   zeroProbabilities();
   Warp->computeCoeff(p);
@@ -170,7 +169,7 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
     double j2 = X2[0];
     double i2 = X2[1];
 
-    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+    if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1) && checkROI(i2, j2)) {
       Nbpoint++;
       // Tij=ptTemplate[point].val;
 
@@ -241,7 +240,7 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
   dW = 0;
 
   if (blur)
-    vpImageFilter::filter(I, BI, fgG, taillef);
+    getGaussianBluredImage(I);
 
   lambda = lambdaDep;
   double MI = 0, MIprec = -1000;
@@ -274,35 +273,17 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
 
     zeroProbabilities();
 
-    Warp->computeCoeff(p);
+    warpTemplatePoints(I, p);
 
     {
       for (int point = 0; point < (int)templateSize; point++) {
-        vpColVector x1(2), x2(2);
-        double i2, j2;
-
-        x1[0] = (double)ptTemplate[point].x;
-        x1[1] = (double)ptTemplate[point].y;
-
-        Warp->computeDenom(x1, p); // A modif pour parallelisation mais ne
-                                   // pose pas de pb avec warp utilises dans
-                                   // DECSA
-        Warp->warpX(x1, x2, p);
-
-        j2 = x2[0];
-        i2 = x2[1];
-
-        if ((i2 >= 0) && (j2 >= 0) && (i2 < I.getHeight() - 1) && (j2 < I.getWidth() - 1)) {
+        if (ptWarpedIn[point]) {
           // if(m_ptCurrentMask == NULL ||(m_ptCurrentMask->getWidth() ==
           // I.getWidth() && m_ptCurrentMask->getHeight() == I.getHeight() &&
           // (*m_ptCurrentMask)[(unsigned int)i2][(unsigned int)j2] > 128))
           {
             Nbpoint++;
-            double IW;
-            if (!blur)
-              IW = (double)I.getValue(i2, j2);
-            else
-              IW = BI.getValue(i2, j2);
+            double IW = ptWarpedValue[point];
 
             int ct = ptTemplateSupp[point].ct;
             double et = ptTemplateSupp[point].et;
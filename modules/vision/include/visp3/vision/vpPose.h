@@ -53,17 +53,16 @@
 #include <visp3/core/vpPoint.h>
 #include <visp3/core/vpRGBa.h>
 #include <visp3/vision/vpHomography.h>
+#include <visp3/vision/vpPosePoints.h>
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
 #include <visp3/core/vpList.h>
 #endif
 #include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <list>
 #include <math.h>
 #include <vector>
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-#include <atomic>
-#endif
 
 /*!
   \class vpPose
@@ -75,6 +74,11 @@
   \note It is also possible to estimate a pose from other features using
   vpPoseFeatures class.
 
+  The points given to addPoint() and addPoints() are stored in a vpPosePoints
+  set on which all the pose estimation algorithms work. When many points are
+  used, for example in a tracking loop, giving a vpPosePoints to addPoints()
+  avoids the creation of a vpPoint per point.
+
   To see how to use this class you can follow the \ref tutorial-pose-estimation.
 */
 
@@ -109,7 +113,17 @@ public:
   };
 
   unsigned int npt;         //!< Number of point used in pose computation
-  std::list<vpPoint> listP; //!< Array of point (use here class vpPoint)
+  /*!
+    Array of the points added as vpPoint with addPoint() or addPoints().
+
+    \deprecated Use addPoint(), addPoints() and clearPoint() to modify the
+    points. The pose computation works on the points returned by
+    getPosePoints(). If all the points were added as vpPoint, computePose()
+    rebuilds them from listP so that a direct modification of listP is taken
+    into account. Otherwise, i.e. once addPoints(const vpPosePoints &) was
+    called, the modifications of listP are ignored.
+  */
+  std::list<vpPoint> listP;
 
   double residual; //!< Residual in meter
 
@@ -120,7 +134,7 @@ private:
   //! define the maximum number of iteration in VVS
   int vvsIterMax;
   //! variable used in the Dementhon approach
-  std::vector<vpPoint> c3d;
+  vpPosePoints c3d;
   //! Flag used to specify if the covariance matrix has to be computed or not.
   bool computeCovariance;
   //! Covariance matrix
@@ -141,9 +155,10 @@ private:
   double distanceToPlaneForCoplanarityTest;
   //! RANSAC flag to remove or not degenerate points
   RANSAC_FILTER_FLAGS ransacFlag;
-  //! List of points used for the RANSAC (std::vector is contiguous whereas
-  //! std::list is a linked list)
-  std::vector<vpPoint> listOfPoints;
+  //! Points used by the pose computation
+  vpPosePoints posePoints;
+  //! True if all the points were added as vpPoint, i.e. are also in listP
+  bool posePointsFromListP;
   //! If true, use a parallel RANSAC implementation
   bool useParallelRansac;
   //! Number of threads to spawn for the parallel RANSAC implementation
@@ -152,29 +167,25 @@ private:
   //! epsilon
   double vvsEpsilon;
 
+  // State shared by the workers of the parallel RANSAC
+  class RansacSharedState;
+
   // For parallel RANSAC
-  class RansacFunctor
+  class RansacFunctor : public vpThreadPool::vpTask
   {
   public:
     RansacFunctor(const vpHomogeneousMatrix &cMo_, const unsigned int ransacNbInlierConsensus_,
                   const int ransacMaxTrials_, const double ransacThreshold_, const unsigned int initial_seed_,
-                  const bool checkDegeneratePoints_, const std::vector<vpPoint> &listOfUniquePoints_,
-                  bool (*func_)(vpHomogeneousMatrix *)
-              #ifdef VISP_HAVE_CPP11_COMPATIBILITY
-                  , std::atomic<bool> &abort
-              #endif
-                  )
-      :
-    #ifdef VISP_HAVE_CPP11_COMPATIBILITY
-        m_abort(abort),
-    #endif
-        m_best_consensus(), m_checkDegeneratePoints(checkDegeneratePoints_), m_cMo(cMo_), m_foundSolution(false),
-        m_func(func_), m_initial_seed(initial_seed_), m_listOfUniquePoints(listOfUniquePoints_), m_nbInliers(0),
+                  const bool checkDegeneratePoints_, const vpPosePoints &listOfUniquePoints_,
+                  bool (*func_)(vpHomogeneousMatrix *), RansacSharedState *sharedState_ = NULL)
+      : m_best_consensus(), m_checkDegeneratePoints(checkDegeneratePoints_), m_cMo(cMo_), m_foundSolution(false),
+        m_func(func_), m_initial_seed(initial_seed_), m_listOfUniquePoints(&listOfUniquePoints_), m_nbInliers(0),
         m_ransacMaxTrials(ransacMaxTrials_), m_ransacNbInlierConsensus(ransacNbInlierConsensus_),
-        m_ransacThreshold(ransacThreshold_)
+        m_ransacThreshold(ransacThreshold_), m_sharedState(sharedState_)
     { }
 
     void operator()() { m_foundSolution = poseRansacImpl(); }
+    virtual void run() { m_foundSolution = poseRansacImpl(); }
 
     // Access the return value.
     bool getResult() const { return m_foundSolution; }
@@ -186,20 +197,20 @@ private:
     unsigned int getNbInliers() const { return m_nbInliers; }
 
   private:
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    std::atomic<bool> &m_abort;
-#endif
     std::vector<unsigned int> m_best_consensus;
     bool m_checkDegeneratePoints;
     vpHomogeneousMatrix m_cMo;
     bool m_foundSolution;
     bool (*m_func)(vpHomogeneousMatrix *);
     unsigned int m_initial_seed;
-    std::vector<vpPoint> m_listOfUniquePoints;
+    //! Points shared by all the workers, not copied
+    const vpPosePoints *m_listOfUniquePoints;
     unsigned int m_nbInliers;
     int m_ransacMaxTrials;
     unsigned int m_ransacNbInlierConsensus;
     double m_ransacThreshold;
+    //! Trial counter and abort flag shared by the workers, NULL for the sequential version
+    RansacSharedState *m_sharedState;
 
     bool poseRansacImpl();
   };
@@ -210,11 +221,15 @@ protected:
   // method used in poseDementhonPlan()
   int calculArbreDementhon(vpMatrix &b, vpColVector &U, vpHomogeneousMatrix &cMo);
 
+  // method used in computePose()
+  void updatePosePoints();
+
 public:
   vpPose();
   virtual ~vpPose();
   void addPoint(const vpPoint &P);
   void addPoints(const std::vector<vpPoint> &lP);
+  void addPoints(const vpPosePoints &points);
   void clearPoint();
 
   bool computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatrix *) = NULL);
@@ -254,6 +269,12 @@ public:
       throw vpException(vpException::badValue, "The Ransac threshold must be positive as we deal with distance.");
     }
   }
+  /*!
+    Set the maximum number of RANSAC trials. The number of trials is reduced
+    as better consensus sets are found, to the number given by
+    computeRansacIterations() with a probability of 0.99 and the current
+    ratio of outliers.
+  */
   void setRansacMaxTrials(const int &rM) { ransacMaxTrials = rM; }
   unsigned int getRansacNbInliers() const { return (unsigned int)ransacInliers.size(); }
   std::vector<unsigned int> getRansacInlierIndex() const { return ransacInlierIndex; }
@@ -309,37 +330,60 @@ public:
     Set the number of threads for the parallel RANSAC implementation.
 
     \note You have to enable the parallel version with setUseParallelRansac().
-    If the number of threads is 0, the number of threads to use is
-    automatically determined with C++11.
+    If the number of threads is 0, the number of threads of the process-wide
+    vpThreadPool plus the calling thread is used.
     \sa setUseParallelRansac
   */
   inline void setNbParallelRansacThreads(const int nb) { nbParallelRansacThreads = nb; }
 
   /*!
-    \return True if the parallel RANSAC version should be used (depends also to C++11 availability).
+    \return True if the parallel RANSAC version should be used.
 
     \sa setUseParallelRansac
   */
   inline bool getUseParallelRansac() const { return useParallelRansac; }
 
   /*!
-    Set if parallel RANSAC version should be used or not (only if C++11).
-
-    \note Need C++11.
+    Set if parallel RANSAC version should be used or not.
+
+    The trials are executed by the persistent threads of
+    vpThreadPool::getInstance(), no thread is created at each call. The
+    workers share the trial counter and stop as soon as one of them reaches
+    the consensus. As in the sequential version, the number of trials is
+    reduced as better consensus sets are found, to the number given by
+    computeRansacIterations() with a probability of 0.99 and the current
+    ratio of outliers. Only the samples that are not degenerate count as
+    trials.
   */
   inline void setUseParallelRansac(const bool use) { useParallelRansac = use; }
 
   /*!
     Get the vector of points.
 
-    \return The vector of points.
+    \return The vector of points. The points given as vpPoint are returned
+    as is if all the points were given as vpPoint, otherwise only their
+    object frame and image plane coordinates are set.
   */
   std::vector<vpPoint> getPoints() const
   {
-    std::vector<vpPoint> vectorOfPoints(listP.begin(), listP.end());
+    if (posePointsFromListP) {
+      return std::vector<vpPoint>(listP.begin(), listP.end());
+    }
+    std::vector<vpPoint> vectorOfPoints;
+    vectorOfPoints.reserve(posePoints.size());
+    for (unsigned int i = 0; i < posePoints.size(); i++) {
+      vectorOfPoints.push_back(posePoints.getPoint(i));
+    }
     return vectorOfPoints;
   }
 
+  /*!
+    Get the set of points used by the pose computation.
+
+    \return The points added with addPoint() and addPoints().
+  */
+  const vpPosePoints &getPosePoints() const { return posePoints; }
+
   static void display(vpImage<unsigned char> &I, vpHomogeneousMatrix &cMo, vpCameraParameters &cam, double size,
                       vpColor col = vpColor::none);
   static void display(vpImage<vpRGBa> &I, vpHomogeneousMatrix &cMo, vpCameraParameters &cam, double size,
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Set of 3D-2D point correspondences used for pose computation.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPosePoints.h
+  \brief Set of 3D-2D point correspondences used for pose computation.
+*/
+
+#ifndef vpPosePoints_h
+#define vpPosePoints_h
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+
+#include <vector>
+
+/*!
+  \class vpPosePoints
+  \ingroup group_vision_pose
+  \brief Compact set of 3D-2D point correspondences used for pose computation.
+
+  Each correspondence is made of the 3D coordinates (oX, oY, oZ) of a point
+  in the object frame and of its 2D normalized coordinates (x, y) in the
+  image plane. The coordinates are stored in five contiguous arrays, so that
+  a set of correspondences does not need a vpPoint, and thus several heap
+  allocated vectors, per point. project() computes the projection of all the
+  points for a given pose in a single pass over these arrays.
+
+  This class is used internally by vpPose, and can be given directly to
+  vpPose::addPoints() to avoid the creation of a vpPoint per correspondence:
+  \code
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPosePoints.h>
+
+int main()
+{
+  vpPosePoints points;
+  points.reserve(4);
+  points.addPoint(-0.1, -0.1, 0, -0.2,  -0.15); // oX, oY, oZ, x, y
+  points.addPoint( 0.1, -0.1, 0,  0.2,  -0.15);
+  points.addPoint( 0.1,  0.1, 0,  0.18,  0.17);
+  points.addPoint(-0.1,  0.1, 0, -0.18,  0.17);
+
+  vpPose pose;
+  pose.addPoints(points);
+  vpHomogeneousMatrix cMo;
+  pose.computePose(vpPose::DEMENTHON_VIRTUAL_VS, cMo);
+}
+  \endcode
+*/
+class VISP_EXPORT vpPosePoints
+{
+public:
+  vpPosePoints();
+  explicit vpPosePoints(const std::vector<vpPoint> &points);
+
+  void addPoint(double oX, double oY, double oZ, double x, double y);
+  void addPoint(const vpPoint &P);
+  void addPoints(const std::vector<vpPoint> &points);
+  void addPoints(const vpPosePoints &points);
+  void clear();
+  double computeResidual(const vpHomogeneousMatrix &cMo) const;
+
+  //! Return the coordinate oX in the object frame of the point \e i.
+  inline double get_oX(unsigned int i) const { return m_oX[i]; }
+  //! Return the coordinate oY in the object frame of the point \e i.
+  inline double get_oY(unsigned int i) const { return m_oY[i]; }
+  //! Return the coordinate oZ in the object frame of the point \e i.
+  inline double get_oZ(unsigned int i) const { return m_oZ[i]; }
+  //! Return the normalized coordinate x in the image plane of the point \e i.
+  inline double get_x(unsigned int i) const { return m_x[i]; }
+  //! Return the normalized coordinate y in the image plane of the point \e i.
+  inline double get_y(unsigned int i) const { return m_y[i]; }
+  vpPoint getPoint(unsigned int i) const;
+
+  void project(const vpHomogeneousMatrix &cMo, double *x, double *y, double *Z) const;
+  void reserve(unsigned int n);
+
+  //! Return the number of point correspondences.
+  inline unsigned int size() const { return (unsigned int)m_oX.size(); }
+
+private:
+  std::vector<double> m_oX;
+  std::vector<double> m_oY;
+  std::vector<double> m_oZ;
+  std::vector<double> m_x;
+  std::vector<double> m_y;
+};
+
+#endif
@@ -80,7 +80,8 @@ void vpPose::init()
   ransacThreshold = 0.0001;
   distanceToPlaneForCoplanarityTest = 0.001;
   ransacFlag = NO_FILTER;
-  listOfPoints.clear();
+  posePoints.clear();
+  posePointsFromListP = true;
   useParallelRansac = false;
   nbParallelRansacThreads = 0;
   vvsEpsilon = 1e-8;
@@ -94,9 +95,9 @@ void vpPose::init()
 vpPose::vpPose()
   : npt(0), listP(), residual(0), lambda(0.25), vvsIterMax(200), c3d(), computeCovariance(false), covarianceMatrix(),
     ransacNbInlierConsensus(4), ransacMaxTrials(1000), ransacInliers(), ransacInlierIndex(), ransacThreshold(0.0001),
-    distanceToPlaneForCoplanarityTest(0.001), ransacFlag(vpPose::NO_FILTER), listOfPoints(),
-    useParallelRansac(false),
-    nbParallelRansacThreads(0), // 0 means that we use C++11 (if available) to get the number of threads
+    distanceToPlaneForCoplanarityTest(0.001), ransacFlag(vpPose::NO_FILTER), posePoints(),
+    posePointsFromListP(true), useParallelRansac(false),
+    nbParallelRansacThreads(0), // 0 means that we use the number of threads of vpThreadPool
     vvsEpsilon(1e-8)
 {
 }
@@ -122,7 +123,8 @@ vpPose::~vpPose()
 void vpPose::clearPoint()
 {
   listP.clear();
-  listOfPoints.clear();
+  posePoints.clear();
+  posePointsFromListP = true;
   npt = 0;
 }
 
@@ -137,7 +139,7 @@ void vpPose::clearPoint()
 void vpPose::addPoint(const vpPoint &newP)
 {
   listP.push_back(newP);
-  listOfPoints.push_back(newP);
+  posePoints.addPoint(newP);
   npt++;
 }
 
@@ -152,8 +154,45 @@ void vpPose::addPoint(const vpPoint &newP)
 void vpPose::addPoints(const std::vector<vpPoint> &lP)
 {
   listP.insert(listP.end(), lP.begin(), lP.end());
-  listOfPoints.insert(listOfPoints.end(), lP.begin(), lP.end());
-  npt = (unsigned int)listP.size();
+  posePoints.addPoints(lP);
+  npt = posePoints.size();
+}
+
+/*!
+  Add (append) a set of points in the array of points.
+  \param points : Object frame coordinates oX, oY, oZ and image plane
+  coordinates x, y of the points to add (append).
+  \note Contrary to the other functions that add points, no vpPoint is
+  created and listP is not modified. This is the fastest way to give a large
+  number of points. Until the next clearPoint(), the modifications of listP
+  are then ignored by the pose computation.
+*/
+void vpPose::addPoints(const vpPosePoints &points)
+{
+  if (points.size() > 0) {
+    posePoints.addPoints(points);
+    posePointsFromListP = false;
+  }
+  npt = posePoints.size();
+}
+
+/*!
+  Rebuild the points used by the pose computation from listP if all the
+  points were added as vpPoint, so that a direct modification of listP is
+  taken into account. The memory of the points is reused.
+*/
+void vpPose::updatePosePoints()
+{
+  if (!posePointsFromListP) {
+    return;
+  }
+
+  posePoints.clear();
+  posePoints.reserve((unsigned int)listP.size());
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
+    posePoints.addPoint(*it);
+  }
+  npt = posePoints.size();
 }
 
 void vpPose::setDistanceToPlaneForCoplanarityTest(double d) { distanceToPlaneForCoplanarityTest = d; }
@@ -182,70 +221,57 @@ bool vpPose::coplanar(int &coplanar_plane_type)
 
   double x1 = 0, x2 = 0, x3 = 0, y1 = 0, y2 = 0, y3 = 0, z1 = 0, z2 = 0, z3 = 0;
 
-  std::list<vpPoint>::const_iterator it = listP.begin();
-
-  vpPoint P1, P2, P3;
-
   // Get three 3D points that are not collinear and that is not at origin
   bool degenerate = true;
   bool not_on_origin = true;
-  std::list<vpPoint>::const_iterator it_tmp;
 
-  std::list<vpPoint>::const_iterator it_i, it_j, it_k;
-  for (it_i = listP.begin(); it_i != listP.end(); ++it_i) {
+  for (unsigned int i = 0; i < npt; i++) {
     if (degenerate == false) {
       // std::cout << "Found a non degenerate configuration" << std::endl;
       break;
     }
-    P1 = *it_i;
     // Test if point is on origin
-    if ((std::fabs(P1.get_oX()) <= std::numeric_limits<double>::epsilon()) &&
-        (std::fabs(P1.get_oY()) <= std::numeric_limits<double>::epsilon()) &&
-        (std::fabs(P1.get_oZ()) <= std::numeric_limits<double>::epsilon())) {
+    if ((std::fabs(posePoints.get_oX(i)) <= std::numeric_limits<double>::epsilon()) &&
+        (std::fabs(posePoints.get_oY(i)) <= std::numeric_limits<double>::epsilon()) &&
+        (std::fabs(posePoints.get_oZ(i)) <= std::numeric_limits<double>::epsilon())) {
       not_on_origin = false;
     } else {
       not_on_origin = true;
     }
     if (not_on_origin) {
-      it_tmp = it_i;
-      ++it_tmp; // j = i+1
-      for (it_j = it_tmp; it_j != listP.end(); ++it_j) {
+      for (unsigned int j = i + 1; j < npt; j++) {
         if (degenerate == false) {
           // std::cout << "Found a non degenerate configuration" << std::endl;
           break;
         }
-        P2 = *it_j;
-        if ((std::fabs(P2.get_oX()) <= std::numeric_limits<double>::epsilon()) &&
-            (std::fabs(P2.get_oY()) <= std::numeric_limits<double>::epsilon()) &&
-            (std::fabs(P2.get_oZ()) <= std::numeric_limits<double>::epsilon())) {
+        if ((std::fabs(posePoints.get_oX(j)) <= std::numeric_limits<double>::epsilon()) &&
+            (std::fabs(posePoints.get_oY(j)) <= std::numeric_limits<double>::epsilon()) &&
+            (std::fabs(posePoints.get_oZ(j)) <= std::numeric_limits<double>::epsilon())) {
           not_on_origin = false;
         } else {
           not_on_origin = true;
         }
         if (not_on_origin) {
-          it_tmp = it_j;
-          ++it_tmp; // k = j+1
-          for (it_k = it_tmp; it_k != listP.end(); ++it_k) {
-            P3 = *it_k;
-            if ((std::fabs(P3.get_oX()) <= std::numeric_limits<double>::epsilon()) &&
-                (std::fabs(P3.get_oY()) <= std::numeric_limits<double>::epsilon()) &&
-                (std::fabs(P3.get_oZ()) <= std::numeric_limits<double>::epsilon())) {
+          for (unsigned int k = j + 1; k < npt; k++) {
+            if ((std::fabs(posePoints.get_oX(k)) <= std::numeric_limits<double>::epsilon()) &&
+                (std::fabs(posePoints.get_oY(k)) <= std::numeric_limits<double>::epsilon()) &&
+                (std::fabs(posePoints.get_oZ(k)) <= std::numeric_limits<double>::epsilon())) {
               not_on_origin = false;
             } else {
               not_on_origin = true;
             }
             if (not_on_origin) {
-              x1 = P1.get_oX();
-              x2 = P2.get_oX();
-              x3 = P3.get_oX();
+              x1 = posePoints.get_oX(i);
+              x2 = posePoints.get_oX(j);
+              x3 = posePoints.get_oX(k);
 
-              y1 = P1.get_oY();
-              y2 = P2.get_oY();
-              y3 = P3.get_oY();
+              y1 = posePoints.get_oY(i);
+              y2 = posePoints.get_oY(j);
+              y3 = posePoints.get_oY(k);
 
-              z1 = P1.get_oZ();
-              z2 = P2.get_oZ();
-              z3 = P3.get_oZ();
+              z1 = posePoints.get_oZ(i);
+              z2 = posePoints.get_oZ(j);
+              z3 = posePoints.get_oZ(k);
 
               vpColVector a_b(3), b_c(3), cross_prod;
               a_b[0] = x1 - x2;
@@ -294,9 +320,8 @@ bool vpPose::coplanar(int &coplanar_plane_type)
 
   double D = sqrt(vpMath::sqr(a) + vpMath::sqr(b) + vpMath::sqr(c));
 
-  for (it = listP.begin(); it != listP.end(); ++it) {
-    P1 = *it;
-    double dist = (a * P1.get_oX() + b * P1.get_oY() + c * P1.get_oZ() + d) / D;
+  for (unsigned int i = 0; i < npt; i++) {
+    double dist = (a * posePoints.get_oX(i) + b * posePoints.get_oY(i) + c * posePoints.get_oZ(i) + d) / D;
     // std::cout << "dist= " << dist << std::endl;
 
     if (fabs(dist) > distanceToPlaneForCoplanarityTest) {
@@ -321,21 +346,7 @@ the pose matrix 'cMo'.
 \return The value of he residual in meter.
 
 */
-double vpPose::computeResidual(const vpHomogeneousMatrix &cMo) const
-{
-  double residual_ = 0;
-  vpPoint P;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
-    double x = P.get_x();
-    double y = P.get_y();
-
-    P.track(cMo);
-
-    residual_ += vpMath::sqr(x - P.get_x()) + vpMath::sqr(y - P.get_y());
-  }
-  return residual_;
-}
+double vpPose::computeResidual(const vpHomogeneousMatrix &cMo) const { return posePoints.computeResidual(cMo); }
 
 /*!
   Compute the pose according to the desired method which are:
@@ -361,6 +372,8 @@ double vpPose::computeResidual(const vpHomogeneousMatrix &cMo) const
 */
 bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatrix *))
 {
+  updatePosePoints();
+
   if (npt < 4) {
     vpERROR_TRACE("Not enough point (%d) to compute the pose  ", npt);
     throw(vpPoseException(vpPoseException::notEnoughPointError, "No enough point "));
@@ -494,9 +507,8 @@ bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool
 
 void vpPose::printPoint()
 {
-  vpPoint P;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
+  for (unsigned int i = 0; i < npt; i++) {
+    vpPoint P = posePoints.getPoint(i);
 
     std::cout << "3D oP " << P.oP.t();
     std::cout << "3D cP " << P.cP.t();
@@ -539,11 +551,9 @@ void vpPose::display(vpImage<vpRGBa> &I, vpHomogeneousMatrix &cMo, vpCameraParam
 */
 void vpPose::displayModel(vpImage<unsigned char> &I, vpCameraParameters &cam, vpColor col)
 {
-  vpPoint P;
   vpImagePoint ip;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
-    vpMeterPixelConversion::convertPoint(cam, P.p[0], P.p[1], ip);
+  for (unsigned int i = 0; i < npt; i++) {
+    vpMeterPixelConversion::convertPoint(cam, posePoints.get_x(i), posePoints.get_y(i), ip);
     vpDisplay::displayCross(I, ip, 5, col);
     //  std::cout << "3D oP " << P.oP.t() ;
     //  std::cout << "3D cP " << P.cP.t() ;
@@ -557,11 +567,9 @@ void vpPose::displayModel(vpImage<unsigned char> &I, vpCameraParameters &cam, vp
 */
 void vpPose::displayModel(vpImage<vpRGBa> &I, vpCameraParameters &cam, vpColor col)
 {
-  vpPoint P;
   vpImagePoint ip;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
-    vpMeterPixelConversion::convertPoint(cam, P.p[0], P.p[1], ip);
+  for (unsigned int i = 0; i < npt; i++) {
+    vpMeterPixelConversion::convertPoint(cam, posePoints.get_x(i), posePoints.get_y(i), ip);
     vpDisplay::displayCross(I, ip, 5, col);
     //  std::cout << "3D oP " << P.oP.t() ;
     //  std::cout << "3D cP " << P.cP.t() ;
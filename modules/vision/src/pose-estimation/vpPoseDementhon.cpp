@@ -64,24 +64,21 @@ void vpPose::poseDementhonNonPlan(vpHomogeneousMatrix &cMo)
   // double seuil=1.0;
   double f = 1.;
 
-  vpPoint p0 = listP.front();
+  const double oX0 = posePoints.get_oX(0), oY0 = posePoints.get_oY(0), oZ0 = posePoints.get_oZ(0);
 
   c3d.clear();
-  vpPoint P;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = (*it);
-    P.set_oX(P.get_oX() - p0.get_oX());
-    P.set_oY(P.get_oY() - p0.get_oY());
-    P.set_oZ(P.get_oZ() - p0.get_oZ());
-    c3d.push_back(P);
+  c3d.reserve(npt);
+  for (unsigned int i = 0; i < npt; i++) {
+    c3d.addPoint(posePoints.get_oX(i) - oX0, posePoints.get_oY(i) - oY0, posePoints.get_oZ(i) - oZ0,
+                 posePoints.get_x(i), posePoints.get_y(i));
   }
 
   vpMatrix a(npt, 3);
 
   for (unsigned int i = 0; i < npt; i++) {
-    a[i][0] = c3d[i].get_oX();
-    a[i][1] = c3d[i].get_oY();
-    a[i][2] = c3d[i].get_oZ();
+    a[i][0] = c3d.get_oX(i);
+    a[i][1] = c3d.get_oY(i);
+    a[i][2] = c3d.get_oZ(i);
   }
 
   // std::cout << a << std::endl ;
@@ -124,8 +121,8 @@ void vpPose::poseDementhonNonPlan(vpHomogeneousMatrix &cMo)
     vpColVector xprim(npt);
     vpColVector yprim(npt);
     for (unsigned int i = 0; i < npt; i++) {
-      xprim[i] = (1 + eps[i]) * c3d[i].get_x() - c3d[0].get_x();
-      yprim[i] = (1 + eps[i]) * c3d[i].get_y() - c3d[0].get_y();
+      xprim[i] = (1 + eps[i]) * c3d.get_x(i) - c3d.get_x(0);
+      yprim[i] = (1 + eps[i]) * c3d.get_y(i) - c3d.get_y(0);
     }
     I = b * xprim;
     J = b * yprim;
@@ -145,7 +142,7 @@ void vpPose::poseDementhonNonPlan(vpHomogeneousMatrix &cMo)
     cpt = cpt + 1; // seuil=0.0;
     for (unsigned int i = 0; i < npt; i++) {
       // double      epsi_1 = eps[i] ;
-      eps[i] = (c3d[i].get_oX() * k[0] + c3d[i].get_oY() * k[1] + c3d[i].get_oZ() * k[2]) / Z0;
+      eps[i] = (c3d.get_oX(i) * k[0] + c3d.get_oY(i) * k[1] + c3d.get_oZ(i) * k[2]) / Z0;
       // seuil+=fabs(eps[i]-epsi_1);
     }
     if (npt == 0) {
@@ -161,21 +158,21 @@ void vpPose::poseDementhonNonPlan(vpHomogeneousMatrix &cMo)
   cMo[0][0] = I[0];
   cMo[0][1] = I[1];
   cMo[0][2] = I[2];
-  cMo[0][3] = c3d[0].get_x() * 2 / (normI + normJ);
+  cMo[0][3] = c3d.get_x(0) * 2 / (normI + normJ);
 
   cMo[1][0] = J[0];
   cMo[1][1] = J[1];
   cMo[1][2] = J[2];
-  cMo[1][3] = c3d[0].get_y() * 2 / (normI + normJ);
+  cMo[1][3] = c3d.get_y(0) * 2 / (normI + normJ);
 
   cMo[2][0] = k[0];
   cMo[2][1] = k[1];
   cMo[2][2] = k[2];
   cMo[2][3] = Z0;
 
-  cMo[0][3] -= (p0.get_oX() * cMo[0][0] + p0.get_oY() * cMo[0][1] + p0.get_oZ() * cMo[0][2]);
-  cMo[1][3] -= (p0.get_oX() * cMo[1][0] + p0.get_oY() * cMo[1][1] + p0.get_oZ() * cMo[1][2]);
-  cMo[2][3] -= (p0.get_oX() * cMo[2][0] + p0.get_oY() * cMo[2][1] + p0.get_oZ() * cMo[2][2]);
+  cMo[0][3] -= (oX0 * cMo[0][0] + oY0 * cMo[0][1] + oZ0 * cMo[0][2]);
+  cMo[1][3] -= (oX0 * cMo[1][0] + oY0 * cMo[1][1] + oZ0 * cMo[1][2]);
+  cMo[2][3] -= (oX0 * cMo[2][0] + oY0 * cMo[2][1] + oZ0 * cMo[2][2]);
 }
 
 #define DMIN 0.01 /* distance min entre la cible et la camera */
@@ -268,7 +265,7 @@ int vpPose::calculArbreDementhon(vpMatrix &b, vpColVector &U, vpHomogeneousMatri
   // on test si tous les points sont devant la camera
   for (unsigned int i = 0; i < npt; i++) {
     double z;
-    z = cMo[2][0] * c3d[i].get_oX() + cMo[2][1] * c3d[i].get_oY() + cMo[2][2] * c3d[i].get_oZ() + cMo[2][3];
+    z = cMo[2][0] * c3d.get_oX(i) + cMo[2][1] * c3d.get_oY(i) + cMo[2][2] * c3d.get_oZ(i) + cMo[2][3];
     if (z <= 0.0)
       erreur = -1;
   }
@@ -281,12 +278,12 @@ int vpPose::calculArbreDementhon(vpMatrix &b, vpColVector &U, vpHomogeneousMatri
   if (erreur == 0) {
     unsigned int k = 0;
     for (unsigned int i = 0; i < npt; i++) {
-      xi[k] = c3d[i].get_x();
-      yi[k] = c3d[i].get_y();
+      xi[k] = c3d.get_x(i);
+      yi[k] = c3d.get_y(i);
 
       if (k != 0) { // On ne prend pas le 1er point
         eps[0][k] =
-            (cMo[2][0] * c3d[i].get_oX() + cMo[2][1] * c3d[i].get_oY() + cMo[2][2] * c3d[i].get_oZ()) / cMo[2][3];
+            (cMo[2][0] * c3d.get_oX(i) + cMo[2][1] * c3d.get_oY(i) + cMo[2][2] * c3d.get_oZ(i)) / cMo[2][3];
       }
       k++;
     }
@@ -373,7 +370,7 @@ int vpPose::calculArbreDementhon(vpMatrix &b, vpColVector &U, vpHomogeneousMatri
         k = 0;
         for (unsigned int i = 0; i < npt; i++) {
           if (k != 0) { // On ne prend pas le 1er point
-            eps[cpt][k] = (cMo1[2][0] * c3d[i].get_oX() + cMo1[2][1] * c3d[i].get_oY() + cMo1[2][2] * c3d[i].get_oZ()) /
+            eps[cpt][k] = (cMo1[2][0] * c3d.get_oX(i) + cMo1[2][1] * c3d.get_oY(i) + cMo1[2][2] * c3d.get_oZ(i)) /
                           cMo1[2][3];
           }
           k++;
@@ -384,7 +381,7 @@ int vpPose::calculArbreDementhon(vpMatrix &b, vpColVector &U, vpHomogeneousMatri
         k = 0;
         for (unsigned int i = 0; i < npt; i++) {
           if (k != 0) { // On ne prend pas le 1er point
-            eps[cpt][k] = (cMo2[2][0] * c3d[i].get_oX() + cMo2[2][1] * c3d[i].get_oY() + cMo2[2][2] * c3d[i].get_oZ()) /
+            eps[cpt][k] = (cMo2[2][0] * c3d.get_oX(i) + cMo2[2][1] * c3d.get_oY(i) + cMo2[2][2] * c3d.get_oZ(i)) /
                           cMo2[2][3];
           }
           k++;
@@ -432,16 +429,13 @@ void vpPose::poseDementhonPlan(vpHomogeneousMatrix &cMo)
 
   unsigned int i, j, k;
 
-  vpPoint p0 = listP.front();
+  const double oX0 = posePoints.get_oX(0), oY0 = posePoints.get_oY(0), oZ0 = posePoints.get_oZ(0);
 
-  vpPoint P;
   c3d.clear();
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
-    P.set_oX(P.get_oX() - p0.get_oX());
-    P.set_oY(P.get_oY() - p0.get_oY());
-    P.set_oZ(P.get_oZ() - p0.get_oZ());
-    c3d.push_back(P);
+  c3d.reserve(npt);
+  for (i = 0; i < npt; i++) {
+    c3d.addPoint(posePoints.get_oX(i) - oX0, posePoints.get_oY(i) - oY0, posePoints.get_oZ(i) - oZ0,
+                 posePoints.get_x(i), posePoints.get_y(i));
   }
 
   vpMatrix a;
@@ -453,9 +447,9 @@ void vpPose::poseDementhonPlan(vpHomogeneousMatrix &cMo)
   }
 
   for (i = 1; i < npt; i++) {
-    a[i - 1][0] = c3d[i].get_oX();
-    a[i - 1][1] = c3d[i].get_oY();
-    a[i - 1][2] = c3d[i].get_oZ();
+    a[i - 1][0] = c3d.get_oX(i);
+    a[i - 1][1] = c3d.get_oY(i);
+    a[i - 1][2] = c3d.get_oZ(i);
   }
 
   // calcul a^T a
@@ -551,8 +545,8 @@ void vpPose::poseDementhonPlan(vpHomogeneousMatrix &cMo)
   vpColVector yi(npt);
   // calcul de la premiere solution
   for (i = 0; i < npt; i++) {
-    xi[i] = c3d[i].get_x();
-    yi[i] = c3d[i].get_y();
+    xi[i] = c3d.get_x(i);
+    yi[i] = c3d.get_y(i);
   }
 
   vpColVector I0(3);
@@ -619,9 +613,9 @@ void vpPose::poseDementhonPlan(vpHomogeneousMatrix &cMo)
       cMo = cMo2f;
   }
 
-  cMo[0][3] -= p0.get_oX() * cMo[0][0] + p0.get_oY() * cMo[0][1] + p0.get_oZ() * cMo[0][2];
-  cMo[1][3] -= p0.get_oX() * cMo[1][0] + p0.get_oY() * cMo[1][1] + p0.get_oZ() * cMo[1][2];
-  cMo[2][3] -= p0.get_oX() * cMo[2][0] + p0.get_oY() * cMo[2][1] + p0.get_oZ() * cMo[2][2];
+  cMo[0][3] -= oX0 * cMo[0][0] + oY0 * cMo[0][1] + oZ0 * cMo[0][2];
+  cMo[1][3] -= oX0 * cMo[1][0] + oY0 * cMo[1][1] + oZ0 * cMo[1][2];
+  cMo[2][3] -= oX0 * cMo[2][0] + oY0 * cMo[2][1] + oZ0 * cMo[2][2];
 
 #if (DEBUG_LEVEL1)
   std::cout << "end CCalculPose::PoseDementhonPlan()" << std::endl;
@@ -647,14 +641,14 @@ double vpPose::computeResidualDementhon(const vpHomogeneousMatrix &cMo)
   residual_ = 0;
   for (unsigned int i = 0; i < npt; i++) {
 
-    double X = c3d[i].get_oX() * cMo[0][0] + c3d[i].get_oY() * cMo[0][1] + c3d[i].get_oZ() * cMo[0][2] + cMo[0][3];
-    double Y = c3d[i].get_oX() * cMo[1][0] + c3d[i].get_oY() * cMo[1][1] + c3d[i].get_oZ() * cMo[1][2] + cMo[1][3];
-    double Z = c3d[i].get_oX() * cMo[2][0] + c3d[i].get_oY() * cMo[2][1] + c3d[i].get_oZ() * cMo[2][2] + cMo[2][3];
+    double X = c3d.get_oX(i) * cMo[0][0] + c3d.get_oY(i) * cMo[0][1] + c3d.get_oZ(i) * cMo[0][2] + cMo[0][3];
+    double Y = c3d.get_oX(i) * cMo[1][0] + c3d.get_oY(i) * cMo[1][1] + c3d.get_oZ(i) * cMo[1][2] + cMo[1][3];
+    double Z = c3d.get_oX(i) * cMo[2][0] + c3d.get_oY(i) * cMo[2][1] + c3d.get_oZ(i) * cMo[2][2] + cMo[2][3];
 
     double x = X / Z;
     double y = Y / Z;
 
-    residual_ += vpMath::sqr(x - c3d[i].get_x()) + vpMath::sqr(y - c3d[i].get_y());
+    residual_ += vpMath::sqr(x - c3d.get_x(i)) + vpMath::sqr(y - c3d.get_y(i));
   }
   return residual_;
 }
@@ -272,90 +272,86 @@ void vpPose::poseLagrangePlan(vpHomogeneousMatrix &cMo, const int coplanar_plane
 
     vpMatrix a(nl, 3);
     vpMatrix b(nl, 6);
-    vpPoint P;
     i = 0;
 
     if (coplanar_plane_type == 1) { // plane ax=d
-      for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-        P = *it;
-        a[k][0] = -P.get_oY();
+      for (unsigned int j = 0; j < npt; j++) {
+        a[k][0] = -posePoints.get_oY(j);
         a[k][1] = 0.0;
-        a[k][2] = P.get_oY() * P.get_x();
+        a[k][2] = posePoints.get_oY(j) * posePoints.get_x(j);
 
         a[k + 1][0] = 0.0;
-        a[k + 1][1] = -P.get_oY();
-        a[k + 1][2] = P.get_oY() * P.get_y();
+        a[k + 1][1] = -posePoints.get_oY(j);
+        a[k + 1][2] = posePoints.get_oY(j) * posePoints.get_y(j);
 
-        b[k][0] = -P.get_oZ();
+        b[k][0] = -posePoints.get_oZ(j);
         b[k][1] = 0.0;
-        b[k][2] = P.get_oZ() * P.get_x();
+        b[k][2] = posePoints.get_oZ(j) * posePoints.get_x(j);
         b[k][3] = -1.0;
         b[k][4] = 0.0;
-        b[k][5] = P.get_x();
+        b[k][5] = posePoints.get_x(j);
 
         b[k + 1][0] = 0.0;
-        b[k + 1][1] = -P.get_oZ();
-        b[k + 1][2] = P.get_oZ() * P.get_y();
+        b[k + 1][1] = -posePoints.get_oZ(j);
+        b[k + 1][2] = posePoints.get_oZ(j) * posePoints.get_y(j);
         b[k + 1][3] = 0.0;
         b[k + 1][4] = -1.0;
-        b[k + 1][5] = P.get_y();
+        b[k + 1][5] = posePoints.get_y(j);
 
         k += 2;
       }
 
     } else if (coplanar_plane_type == 2) { // plane by=d
-      for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-        P = *it;
-        a[k][0] = -P.get_oX();
+      for (unsigned int j = 0; j < npt; j++) {
+        a[k][0] = -posePoints.get_oX(j);
         a[k][1] = 0.0;
-        a[k][2] = P.get_oX() * P.get_x();
+        a[k][2] = posePoints.get_oX(j) * posePoints.get_x(j);
 
         a[k + 1][0] = 0.0;
-        a[k + 1][1] = -P.get_oX();
-        a[k + 1][2] = P.get_oX() * P.get_y();
+        a[k + 1][1] = -posePoints.get_oX(j);
+        a[k + 1][2] = posePoints.get_oX(j) * posePoints.get_y(j);
 
-        b[k][0] = -P.get_oZ();
+        b[k][0] = -posePoints.get_oZ(j);
         b[k][1] = 0.0;
-        b[k][2] = P.get_oZ() * P.get_x();
+        b[k][2] = posePoints.get_oZ(j) * posePoints.get_x(j);
         b[k][3] = -1.0;
         b[k][4] = 0.0;
-        b[k][5] = P.get_x();
+        b[k][5] = posePoints.get_x(j);
 
         b[k + 1][0] = 0.0;
-        b[k + 1][1] = -P.get_oZ();
-        b[k + 1][2] = P.get_oZ() * P.get_y();
+        b[k + 1][1] = -posePoints.get_oZ(j);
+        b[k + 1][2] = posePoints.get_oZ(j) * posePoints.get_y(j);
         b[k + 1][3] = 0.0;
         b[k + 1][4] = -1.0;
-        b[k + 1][5] = P.get_y();
+        b[k + 1][5] = posePoints.get_y(j);
 
         k += 2;
       }
 
     } else { // plane cz=d or any other
 
-      for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-        P = *it;
-        a[k][0] = -P.get_oX();
+      for (unsigned int j = 0; j < npt; j++) {
+        a[k][0] = -posePoints.get_oX(j);
         a[k][1] = 0.0;
-        a[k][2] = P.get_oX() * P.get_x();
+        a[k][2] = posePoints.get_oX(j) * posePoints.get_x(j);
 
         a[k + 1][0] = 0.0;
-        a[k + 1][1] = -P.get_oX();
-        a[k + 1][2] = P.get_oX() * P.get_y();
+        a[k + 1][1] = -posePoints.get_oX(j);
+        a[k + 1][2] = posePoints.get_oX(j) * posePoints.get_y(j);
 
-        b[k][0] = -P.get_oY();
+        b[k][0] = -posePoints.get_oY(j);
         b[k][1] = 0.0;
-        b[k][2] = P.get_oY() * P.get_x();
+        b[k][2] = posePoints.get_oY(j) * posePoints.get_x(j);
         b[k][3] = -1.0;
         b[k][4] = 0.0;
-        b[k][5] = P.get_x();
+        b[k][5] = posePoints.get_x(j);
 
         b[k + 1][0] = 0.0;
-        b[k + 1][1] = -P.get_oY();
-        b[k + 1][2] = P.get_oY() * P.get_y();
+        b[k + 1][1] = -posePoints.get_oY(j);
+        b[k + 1][2] = posePoints.get_oY(j) * posePoints.get_y(j);
         b[k + 1][3] = 0.0;
         b[k + 1][4] = -1.0;
-        b[k + 1][5] = P.get_y();
+        b[k + 1][5] = posePoints.get_y(j);
 
         k += 2;
       }
@@ -485,41 +481,39 @@ void vpPose::poseLagrangeNonPlan(vpHomogeneousMatrix &cMo)
     vpMatrix b(nl, 9);
     b = 0;
 
-    vpPoint P;
     i = 0;
-    for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-      P = *it;
-      a[k][0] = -P.get_oX();
+    for (unsigned int j = 0; j < npt; j++) {
+      a[k][0] = -posePoints.get_oX(j);
       a[k][1] = 0.0;
-      a[k][2] = P.get_oX() * P.get_x();
+      a[k][2] = posePoints.get_oX(j) * posePoints.get_x(j);
 
       a[k + 1][0] = 0.0;
-      a[k + 1][1] = -P.get_oX();
-      a[k + 1][2] = P.get_oX() * P.get_y();
+      a[k + 1][1] = -posePoints.get_oX(j);
+      a[k + 1][2] = posePoints.get_oX(j) * posePoints.get_y(j);
 
-      b[k][0] = -P.get_oY();
+      b[k][0] = -posePoints.get_oY(j);
       b[k][1] = 0.0;
-      b[k][2] = P.get_oY() * P.get_x();
+      b[k][2] = posePoints.get_oY(j) * posePoints.get_x(j);
 
-      b[k][3] = -P.get_oZ();
+      b[k][3] = -posePoints.get_oZ(j);
       b[k][4] = 0.0;
-      b[k][5] = P.get_oZ() * P.get_x();
+      b[k][5] = posePoints.get_oZ(j) * posePoints.get_x(j);
 
       b[k][6] = -1.0;
       b[k][7] = 0.0;
-      b[k][8] = P.get_x();
+      b[k][8] = posePoints.get_x(j);
 
       b[k + 1][0] = 0.0;
-      b[k + 1][1] = -P.get_oY();
-      b[k + 1][2] = P.get_oY() * P.get_y();
+      b[k + 1][1] = -posePoints.get_oY(j);
+      b[k + 1][2] = posePoints.get_oY(j) * posePoints.get_y(j);
 
       b[k + 1][3] = 0.0;
-      b[k + 1][4] = -P.get_oZ();
-      b[k + 1][5] = P.get_oZ() * P.get_y();
+      b[k + 1][4] = -posePoints.get_oZ(j);
+      b[k + 1][5] = posePoints.get_oZ(j) * posePoints.get_y(j);
 
       b[k + 1][6] = 0.0;
       b[k + 1][7] = -1.0;
-      b[k + 1][8] = P.get_y();
+      b[k + 1][8] = posePoints.get_y(j);
 
       k += 2;
     }
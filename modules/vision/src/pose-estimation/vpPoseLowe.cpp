@@ -292,16 +292,12 @@ void vpPose::poseLowe(vpHomogeneousMatrix &cMo)
     sol[i + 3] = u[i];
   }
 
-  vpPoint P;
-  unsigned int i_ = 0;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
-    XI[i_] = P.get_x(); //*cam.px + cam.xc ;
-    YI[i_] = P.get_y(); //;*cam.py + cam.yc ;
-    XO[i_] = P.get_oX();
-    YO[i_] = P.get_oY();
-    ZO[i_] = P.get_oZ();
-    ++i_;
+  for (unsigned int i_ = 0; i_ < npt; i_++) {
+    XI[i_] = posePoints.get_x(i_); //*cam.px + cam.xc ;
+    YI[i_] = posePoints.get_y(i_); //;*cam.py + cam.yc ;
+    XO[i_] = posePoints.get_oX(i_);
+    YO[i_] = posePoints.get_oY(i_);
+    ZO[i_] = posePoints.get_oZ(i_);
   }
   tst_lmder = lmder1(&fcn, m, n, sol, f, &jac[0][0], ldfjac, tol, &info, ipvt, lwa, wa);
   if (tst_lmder == -1) {
@@ -0,0 +1,229 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Set of 3D-2D point correspondences used for pose computation.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPosePoints.cpp
+  \brief Set of 3D-2D point correspondences used for pose computation.
+*/
+
+#include <visp3/core/vpMath.h>
+#include <visp3/vision/vpPosePoints.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+/*!
+  Default constructor that builds an empty set of correspondences.
+*/
+vpPosePoints::vpPosePoints() : m_oX(), m_oY(), m_oZ(), m_x(), m_y() {}
+
+/*!
+  Build a set of correspondences from the object frame coordinates oX, oY,
+  oZ and the image plane coordinates x, y of each point of \e points.
+*/
+vpPosePoints::vpPosePoints(const std::vector<vpPoint> &points) : m_oX(), m_oY(), m_oZ(), m_x(), m_y()
+{
+  addPoints(points);
+}
+
+/*!
+  Add (append) a correspondence.
+
+  \param oX, oY, oZ : 3D coordinates of the point in the object frame.
+  \param x, y : 2D normalized coordinates of the point in the image plane.
+*/
+void vpPosePoints::addPoint(double oX, double oY, double oZ, double x, double y)
+{
+  m_oX.push_back(oX);
+  m_oY.push_back(oY);
+  m_oZ.push_back(oZ);
+  m_x.push_back(x);
+  m_y.push_back(y);
+}
+
+/*!
+  Add (append) the correspondence given by the object frame coordinates oX,
+  oY, oZ and the image plane coordinates x, y of \e P.
+*/
+void vpPosePoints::addPoint(const vpPoint &P) { addPoint(P.get_oX(), P.get_oY(), P.get_oZ(), P.get_x(), P.get_y()); }
+
+/*!
+  Add (append) the correspondences given by the object frame coordinates oX,
+  oY, oZ and the image plane coordinates x, y of each point of \e points.
+*/
+void vpPosePoints::addPoints(const std::vector<vpPoint> &points)
+{
+  reserve(size() + (unsigned int)points.size());
+  for (std::vector<vpPoint>::const_iterator it = points.begin(); it != points.end(); ++it) {
+    addPoint(*it);
+  }
+}
+
+/*!
+  Add (append) all the correspondences of \e points.
+*/
+void vpPosePoints::addPoints(const vpPosePoints &points)
+{
+  m_oX.insert(m_oX.end(), points.m_oX.begin(), points.m_oX.end());
+  m_oY.insert(m_oY.end(), points.m_oY.begin(), points.m_oY.end());
+  m_oZ.insert(m_oZ.end(), points.m_oZ.begin(), points.m_oZ.end());
+  m_x.insert(m_x.end(), points.m_x.begin(), points.m_x.end());
+  m_y.insert(m_y.end(), points.m_y.begin(), points.m_y.end());
+}
+
+/*!
+  Remove all the correspondences. The allocated memory is kept to be reused
+  by the next correspondences.
+*/
+void vpPosePoints::clear()
+{
+  m_oX.clear();
+  m_oY.clear();
+  m_oZ.clear();
+  m_x.clear();
+  m_y.clear();
+}
+
+/*!
+  Compute the sum over all the points of the squared distance between the
+  image plane coordinates and the projection of the object frame coordinates
+  for the pose \e cMo. This is the value returned by
+  vpPose::computeResidual().
+
+  \param cMo : Pose to evaluate.
+  \return The residual in meter^2.
+*/
+double vpPosePoints::computeResidual(const vpHomogeneousMatrix &cMo) const
+{
+  const unsigned int n = size();
+  double residual = 0;
+  for (unsigned int i = 0; i < n; i++) {
+    double X = cMo[0][0] * m_oX[i] + cMo[0][1] * m_oY[i] + cMo[0][2] * m_oZ[i] + cMo[0][3];
+    double Y = cMo[1][0] * m_oX[i] + cMo[1][1] * m_oY[i] + cMo[1][2] * m_oZ[i] + cMo[1][3];
+    double Z = cMo[2][0] * m_oX[i] + cMo[2][1] * m_oY[i] + cMo[2][2] * m_oZ[i] + cMo[2][3];
+    double d = 1 / Z;
+    residual += vpMath::sqr(m_x[i] - X * d) + vpMath::sqr(m_y[i] - Y * d);
+  }
+  return residual;
+}
+
+/*!
+  Return the correspondence \e i as a vpPoint with its object frame and
+  image plane coordinates set.
+*/
+vpPoint vpPosePoints::getPoint(unsigned int i) const
+{
+  vpPoint P(m_oX[i], m_oY[i], m_oZ[i]);
+  P.set_x(m_x[i]);
+  P.set_y(m_y[i]);
+  return P;
+}
+
+/*!
+  Express all the points in the camera frame for the pose \e cMo and project
+  them in the image plane.
+
+  The result for the point \e i is the same as the one given by
+  vpPoint::track() on a point with the same object frame coordinates, but the
+  points are processed in a single pass over contiguous memory and nothing is
+  allocated.
+
+  \param cMo : Pose of the object frame in the camera frame.
+  \param x, y : Arrays of size() elements filled with the normalized
+  coordinates of the projected points.
+  \param Z : Array of size() elements filled with the depth of the points in
+  the camera frame, or NULL if the depth is not needed.
+*/
+void vpPosePoints::project(const vpHomogeneousMatrix &cMo, double *x, double *y, double *Z) const
+{
+  const unsigned int n = size();
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  const __m128d r00 = _mm_set1_pd(cMo[0][0]), r01 = _mm_set1_pd(cMo[0][1]), r02 = _mm_set1_pd(cMo[0][2]);
+  const __m128d r10 = _mm_set1_pd(cMo[1][0]), r11 = _mm_set1_pd(cMo[1][1]), r12 = _mm_set1_pd(cMo[1][2]);
+  const __m128d r20 = _mm_set1_pd(cMo[2][0]), r21 = _mm_set1_pd(cMo[2][1]), r22 = _mm_set1_pd(cMo[2][2]);
+  const __m128d t0 = _mm_set1_pd(cMo[0][3]), t1 = _mm_set1_pd(cMo[1][3]), t2 = _mm_set1_pd(cMo[2][3]);
+  const __m128d one = _mm_set1_pd(1.0);
+
+  for (; i + 2 <= n; i += 2) {
+    const __m128d oX = _mm_loadu_pd(&m_oX[i]);
+    const __m128d oY = _mm_loadu_pd(&m_oY[i]);
+    const __m128d oZ = _mm_loadu_pd(&m_oZ[i]);
+
+    // Same operation order as vpPoint::changeFrame() and vpPoint::projection()
+    __m128d cX = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(r00, oX), _mm_mul_pd(r01, oY)), _mm_mul_pd(r02, oZ)), t0);
+    __m128d cY = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(r10, oX), _mm_mul_pd(r11, oY)), _mm_mul_pd(r12, oZ)), t1);
+    __m128d cZ = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(r20, oX), _mm_mul_pd(r21, oY)), _mm_mul_pd(r22, oZ)), t2);
+    __m128d d = _mm_div_pd(one, cZ);
+
+    _mm_storeu_pd(x + i, _mm_mul_pd(cX, d));
+    _mm_storeu_pd(y + i, _mm_mul_pd(cY, d));
+    if (Z != NULL) {
+      _mm_storeu_pd(Z + i, cZ);
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    double cX = cMo[0][0] * m_oX[i] + cMo[0][1] * m_oY[i] + cMo[0][2] * m_oZ[i] + cMo[0][3];
+    double cY = cMo[1][0] * m_oX[i] + cMo[1][1] * m_oY[i] + cMo[1][2] * m_oZ[i] + cMo[1][3];
+    double cZ = cMo[2][0] * m_oX[i] + cMo[2][1] * m_oY[i] + cMo[2][2] * m_oZ[i] + cMo[2][3];
+    double d = 1 / cZ;
+
+    x[i] = cX * d;
+    y[i] = cY * d;
+    if (Z != NULL) {
+      Z[i] = cZ;
+    }
+  }
+}
+
+/*!
+  Reserve memory for \e n correspondences.
+*/
+void vpPosePoints::reserve(unsigned int n)
+{
+  m_oX.reserve(n);
+  m_oY.reserve(n);
+  m_oZ.reserve(n);
+  m_x.reserve(n);
+  m_y.reserve(n);
+}
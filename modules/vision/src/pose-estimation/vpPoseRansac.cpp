@@ -49,6 +49,7 @@
 #include <iostream>
 #include <limits> // numeric_limits
 #include <map>
+#include <set>
 
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpMath.h>
@@ -56,73 +57,154 @@
 #include <visp3/vision/vpPose.h>
 #include <visp3/vision/vpPoseException.h>
 
-#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
-#include <thread>
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+#include <visp3/core/vpMutex.h>
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <mutex>
 #endif
 
 #define eps 1e-6
 
 namespace
 {
-// For std::map<vpPoint>
+// For std::set<unsigned int>, compare the object frame coordinates of two
+// points given by their index in a set of points
 struct CompareObjectPointDegenerate {
-  bool operator()(const vpPoint &point1, const vpPoint &point2) const
+  explicit CompareObjectPointDegenerate(const vpPosePoints &points) : m_points(&points) {}
+
+  bool operator()(unsigned int i1, unsigned int i2) const
   {
-    if (point1.oP[0] - point2.oP[0] < -eps)
+    const vpPosePoints &points = *m_points;
+    if (points.get_oX(i1) - points.get_oX(i2) < -eps)
       return true;
-    if (point1.oP[0] - point2.oP[0] > eps)
+    if (points.get_oX(i1) - points.get_oX(i2) > eps)
       return false;
 
-    if (point1.oP[1] - point2.oP[1] < -eps)
+    if (points.get_oY(i1) - points.get_oY(i2) < -eps)
       return true;
-    if (point1.oP[1] - point2.oP[1] > eps)
+    if (points.get_oY(i1) - points.get_oY(i2) > eps)
       return false;
 
-    if (point1.oP[2] - point2.oP[2] < -eps)
+    if (points.get_oZ(i1) - points.get_oZ(i2) < -eps)
       return true;
-    if (point1.oP[2] - point2.oP[2] > eps)
+    if (points.get_oZ(i1) - points.get_oZ(i2) > eps)
       return false;
 
     return false;
   }
+
+  const vpPosePoints *m_points;
 };
 
-// For std::map<vpPoint>
+// For std::set<unsigned int>, compare the image plane coordinates of two
+// points given by their index in a set of points
 struct CompareImagePointDegenerate {
-  bool operator()(const vpPoint &point1, const vpPoint &point2) const
+  explicit CompareImagePointDegenerate(const vpPosePoints &points) : m_points(&points) {}
+
+  bool operator()(unsigned int i1, unsigned int i2) const
   {
-    if (point1.p[0] - point2.p[0] < -eps)
+    const vpPosePoints &points = *m_points;
+    if (points.get_x(i1) - points.get_x(i2) < -eps)
       return true;
-    if (point1.p[0] - point2.p[0] > eps)
+    if (points.get_x(i1) - points.get_x(i2) > eps)
       return false;
 
-    if (point1.p[1] - point2.p[1] < -eps)
+    if (points.get_y(i1) - points.get_y(i2) < -eps)
       return true;
-    if (point1.p[1] - point2.p[1] > eps)
+    if (points.get_y(i1) - points.get_y(i2) > eps)
       return false;
 
     return false;
   }
+
+  const vpPosePoints *m_points;
 };
 
-// std::find_if
-struct FindDegeneratePoint {
-  explicit FindDegeneratePoint(const vpPoint &pt) : m_pt(pt) {}
+// Return true if the point i has the same object frame or image plane
+// coordinates as one of the points given by their index in \e indexes
+bool isDegeneratePoint(const vpPosePoints &points, unsigned int i, const std::vector<unsigned int> &indexes)
+{
+  for (std::vector<unsigned int>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
+    if ((std::fabs(points.get_oX(i) - points.get_oX(*it)) < eps &&
+         std::fabs(points.get_oY(i) - points.get_oY(*it)) < eps &&
+         std::fabs(points.get_oZ(i) - points.get_oZ(*it)) < eps) ||
+        (std::fabs(points.get_x(i) - points.get_x(*it)) < eps &&
+         std::fabs(points.get_y(i) - points.get_y(*it)) < eps)) {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+class vpPose::RansacSharedState
+{
+public:
+  RansacSharedState(const int maxTrials, const unsigned int nbInlierConsensus, const size_t nbPoints)
+    : m_abort(false), m_maxTrials(maxTrials), m_mutex(), m_nbInlierConsensus(nbInlierConsensus), m_nbInliers(0),
+      m_nbPoints(nbPoints), m_nbTrials(0), m_nbTrialsNeeded(maxTrials)
+  {
+  }
+
+  // Return false if the workers must stop, otherwise count a new trial
+  bool acquireTrial()
+  {
+    m_mutex.lock();
+    const bool ok = !m_abort && m_nbTrials < m_nbTrialsNeeded;
+    if (ok) {
+      m_nbTrials++;
+    }
+    m_mutex.unlock();
+    return ok;
+  }
 
-  bool operator()(const vpPoint &pt)
+  // Abort when the consensus is reached, otherwise adapt the number of trials
+  // to the current ratio of outliers
+  void updateInliers(const unsigned int nbInliers)
   {
-    return ((std::fabs(m_pt.oP[0] - pt.oP[0]) < eps && std::fabs(m_pt.oP[1] - pt.oP[1]) < eps &&
-             std::fabs(m_pt.oP[2] - pt.oP[2]) < eps) ||
-            (std::fabs(m_pt.p[0] - pt.p[0]) < eps && std::fabs(m_pt.p[1] - pt.p[1]) < eps));
+    m_mutex.lock();
+    if (nbInliers > m_nbInliers) {
+      m_nbInliers = nbInliers;
+      if (m_nbInliers >= m_nbInlierConsensus) {
+        m_abort = true;
+      } else {
+        const double epsilon = 1.0 - m_nbInliers / (double)m_nbPoints;
+        const int nbTrials = vpPose::computeRansacIterations(0.99, epsilon, 4, m_maxTrials);
+        if (nbTrials > 0 && nbTrials < m_nbTrialsNeeded) {
+          m_nbTrialsNeeded = nbTrials;
+        }
+      }
+    }
+    m_mutex.unlock();
   }
 
-  vpPoint m_pt;
+private:
+  bool m_abort;
+  int m_maxTrials;
+#if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
+  vpMutex m_mutex;
+#elif defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  std::mutex m_mutex;
+#else
+  // Without threading support the thread pool is sequential
+  struct vpNoMutex {
+    void lock() {}
+    void unlock() {}
+  } m_mutex;
+#endif
+  unsigned int m_nbInlierConsensus;
+  unsigned int m_nbInliers;
+  size_t m_nbPoints;
+  int m_nbTrials;
+  int m_nbTrialsNeeded;
 };
-}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 bool vpPose::RansacFunctor::poseRansacImpl()
 {
-  const unsigned int size = (unsigned int)m_listOfUniquePoints.size();
+  const vpPosePoints &listOfUniquePoints = *m_listOfUniquePoints;
+  const unsigned int size = listOfUniquePoints.size();
   const unsigned int nbMinRandom = 4;
   int nbTrials = 0;
 
@@ -130,19 +212,29 @@ bool vpPose::RansacFunctor::poseRansacImpl()
   srand(m_initial_seed);
 #endif
 
-  vpPoint p; // Point used to project using the estimated pose
+  // Projection of all the points using the estimated pose
+  std::vector<double> xProj(size), yProj(size);
+
+  // Hold the list of the index of the inliers (points in the consensus set)
+  std::vector<unsigned int> cur_consensus;
+  // Hold the list of the index of the outliers
+  std::vector<unsigned int> cur_outliers;
+  // Hold the list of the index of the points randomly picked
+  std::vector<unsigned int> cur_randoms;
+  // Vector of used points
+  std::vector<bool> usedPt(size);
+  // Minimal sample set and pose estimated from it
+  vpPosePoints sample;
+  vpPose poseMin;
+  sample.reserve(nbMinRandom);
+  cur_consensus.reserve(size);
+  cur_outliers.reserve(size);
 
   bool foundSolution = false;
   while (nbTrials < m_ransacMaxTrials && m_nbInliers < m_ransacNbInlierConsensus) {
-    // Hold the list of the index of the inliers (points in the consensus set)
-    std::vector<unsigned int> cur_consensus;
-    // Hold the list of the index of the outliers
-    std::vector<unsigned int> cur_outliers;
-    // Hold the list of the index of the points randomly picked
-    std::vector<unsigned int> cur_randoms;
-    // Hold the list of the current inliers points to avoid to add a
-    // degenerate point if the flag is set
-    std::vector<vpPoint> cur_inliers;
+    cur_consensus.clear();
+    cur_outliers.clear();
+    cur_randoms.clear();
 
     vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
     // Use a temporary variable because if not, the cMo passed in parameters
@@ -152,10 +244,10 @@ bool vpPose::RansacFunctor::poseRansacImpl()
     // cMo passed in parameters
     vpHomogeneousMatrix cMo_tmp;
 
-    // Vector of used points, initialized at false for all points
-    std::vector<bool> usedPt(size, false);
+    // Initialized at false for all points
+    std::fill(usedPt.begin(), usedPt.end(), false);
 
-    vpPose poseMin;
+    sample.clear();
     for (unsigned int i = 0; i < nbMinRandom;) {
       if ((size_t)std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
         // All points was picked once, break otherwise we stay in an infinite loop
@@ -179,29 +271,34 @@ bool vpPose::RansacFunctor::poseRansacImpl()
       }
       // Mark this point as already picked
       usedPt[r_] = true;
-      vpPoint pt = m_listOfUniquePoints[r_];
 
       bool degenerate = false;
       if (m_checkDegeneratePoints) {
-        if (std::find_if(poseMin.listOfPoints.begin(), poseMin.listOfPoints.end(), FindDegeneratePoint(pt)) !=
-            poseMin.listOfPoints.end()) {
-          degenerate = true;
-        }
+        degenerate = isDegeneratePoint(listOfUniquePoints, r_, cur_randoms);
       }
 
       if (!degenerate) {
-        poseMin.addPoint(pt);
+        sample.addPoint(listOfUniquePoints.get_oX(r_), listOfUniquePoints.get_oY(r_), listOfUniquePoints.get_oZ(r_),
+                        listOfUniquePoints.get_x(r_), listOfUniquePoints.get_y(r_));
         cur_randoms.push_back(r_);
         // Increment the number of points picked
         i++;
       }
     }
 
-    if (poseMin.npt < nbMinRandom) {
+    if (sample.size() < nbMinRandom) {
       nbTrials++;
       continue;
     }
 
+    // Only the valid samples count as a trial of the shared state
+    if (m_sharedState != NULL && !m_sharedState->acquireTrial()) {
+      break;
+    }
+
+    poseMin.clearPoint();
+    poseMin.addPoints(sample);
+
     // Flags set if pose computation is OK
     bool is_valid_lagrange = false;
     bool is_valid_dementhon = false;
@@ -261,19 +358,14 @@ bool vpPose::RansacFunctor::poseRansacImpl()
 
       if (isPoseValid && r < m_ransacThreshold) {
         unsigned int nbInliersCur = 0;
-        unsigned int iter = 0;
-        for (std::vector<vpPoint>::const_iterator it = m_listOfUniquePoints.begin(); it != m_listOfUniquePoints.end();
-             ++it, iter++) {
-          p.setWorldCoordinates(it->get_oX(), it->get_oY(), it->get_oZ());
-          p.track(m_cMo);
-
-          double error = sqrt(vpMath::sqr(p.get_x() - it->get_x()) + vpMath::sqr(p.get_y() - it->get_y()));
+        listOfUniquePoints.project(m_cMo, &xProj[0], &yProj[0], NULL);
+        for (unsigned int iter = 0; iter < size; iter++) {
+          double error = sqrt(vpMath::sqr(xProj[iter] - listOfUniquePoints.get_x(iter)) +
+                              vpMath::sqr(yProj[iter] - listOfUniquePoints.get_y(iter)));
           if (error < m_ransacThreshold) {
             bool degenerate = false;
             if (m_checkDegeneratePoints) {
-              if (std::find_if(cur_inliers.begin(), cur_inliers.end(), FindDegeneratePoint(*it)) != cur_inliers.end()) {
-                degenerate = true;
-              }
+              degenerate = isDegeneratePoint(listOfUniquePoints, iter, cur_consensus);
             }
 
             if (!degenerate) {
@@ -281,7 +373,6 @@ bool vpPose::RansacFunctor::poseRansacImpl()
               // threshold
               nbInliersCur++;
               cur_consensus.push_back(iter);
-              cur_inliers.push_back(*it);
             } else {
               cur_outliers.push_back(iter);
             }
@@ -294,6 +385,9 @@ bool vpPose::RansacFunctor::poseRansacImpl()
           foundSolution = true;
           m_best_consensus = cur_consensus;
           m_nbInliers = nbInliersCur;
+          if (m_sharedState != NULL) {
+            m_sharedState->updateInliers(m_nbInliers);
+          }
         }
 
         nbTrials++;
@@ -309,11 +403,6 @@ bool vpPose::RansacFunctor::poseRansacImpl()
     }
   }
 
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-  if (m_nbInliers >= m_ransacNbInlierConsensus)
-    m_abort = true;
-#endif
-
   return foundSolution;
 }
 
@@ -326,19 +415,12 @@ bool vpPose::RansacFunctor::poseRansacImpl()
   otherwise
   \return True if we found at least 4 points with a reprojection
   error below ransacThreshold.
-  \note You can enable a multithreaded version if you have C++11 enabled using \e setUseParallelRansac
+  \note You can enable a multithreaded version using \e setUseParallelRansac
   The number of threads used can then be set with \e setNbParallelRansacThreads
   Filter flag can be used  with \e setRansacFilterFlag
 */
 bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatrix *))
 {
-  // Check only for adding / removing problem
-  // Do not take into account problem with element modification here
-  if (listP.size() != listOfPoints.size()) {
-    std::cerr << "You should not modify vpPose::listP!" << std::endl;
-    listOfPoints = std::vector<vpPoint>(listP.begin(), listP.end());
-  }
-
   ransacInliers.clear();
   ransacInlierIndex.clear();
 
@@ -347,11 +429,11 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
 
   vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
 
-  if (listOfPoints.size() < 4) {
+  if (posePoints.size() < 4) {
     throw(vpPoseException(vpPoseException::notInitializedError, "Not enough point to compute the pose"));
   }
 
-  std::vector<vpPoint> listOfUniquePoints;
+  vpPosePoints listOfUniquePoints;
   std::map<size_t, size_t> mapOfUniquePointIndex;
 
   // Get RANSAC flags
@@ -360,32 +442,27 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
 
   if (prefilterDegeneratePoints) {
     // Remove degenerate object points
-    std::map<vpPoint, size_t, CompareObjectPointDegenerate> filterObjectPointMap;
-    size_t index_pt = 0;
-    for (std::vector<vpPoint>::const_iterator it_pt = listOfPoints.begin(); it_pt != listOfPoints.end();
-         ++it_pt, index_pt++) {
-      if (filterObjectPointMap.find(*it_pt) == filterObjectPointMap.end()) {
-        filterObjectPointMap[*it_pt] = index_pt;
-      }
+    CompareObjectPointDegenerate compareObjectPoint(posePoints);
+    std::set<unsigned int, CompareObjectPointDegenerate> filterObjectPointSet(compareObjectPoint);
+    for (unsigned int index_pt = 0; index_pt < posePoints.size(); index_pt++) {
+      filterObjectPointSet.insert(index_pt);
     }
 
-    std::map<vpPoint, size_t, CompareImagePointDegenerate> filterImagePointMap;
-    for (std::map<vpPoint, size_t, CompareObjectPointDegenerate>::const_iterator it = filterObjectPointMap.begin();
-         it != filterObjectPointMap.end(); ++it) {
-      if (filterImagePointMap.find(it->first) == filterImagePointMap.end()) {
-        filterImagePointMap[it->first] = it->second;
-
-        listOfUniquePoints.push_back(it->first);
-        mapOfUniquePointIndex[listOfUniquePoints.size() - 1] = it->second;
+    CompareImagePointDegenerate compareImagePoint(posePoints);
+    std::set<unsigned int, CompareImagePointDegenerate> filterImagePointSet(compareImagePoint);
+    for (std::set<unsigned int, CompareObjectPointDegenerate>::const_iterator it = filterObjectPointSet.begin();
+         it != filterObjectPointSet.end(); ++it) {
+      if (filterImagePointSet.insert(*it).second) {
+        listOfUniquePoints.addPoint(posePoints.get_oX(*it), posePoints.get_oY(*it), posePoints.get_oZ(*it),
+                                    posePoints.get_x(*it), posePoints.get_y(*it));
+        mapOfUniquePointIndex[listOfUniquePoints.size() - 1] = *it;
       }
     }
   } else {
     // No prefiltering
-    listOfUniquePoints = listOfPoints;
+    listOfUniquePoints = posePoints;
 
-    size_t index_pt = 0;
-    for (std::vector<vpPoint>::const_iterator it_pt = listOfPoints.begin(); it_pt != listOfPoints.end();
-         ++it_pt, index_pt++) {
+    for (size_t index_pt = 0; index_pt < posePoints.size(); index_pt++) {
       mapOfUniquePointIndex[index_pt] = index_pt;
     }
   }
@@ -395,82 +472,64 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
   }
 
   bool executeParallelVersion = useParallelRansac;
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
   unsigned int nbThreads = 1;
-#else
-  executeParallelVersion = false;
-#endif
 
   if (executeParallelVersion) {
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
     if (nbParallelRansacThreads <= 0) {
-      // Get number of CPU threads
-      nbThreads = std::thread::hardware_concurrency();
-      if (nbThreads <= 1) {
-        nbThreads = 1;
-        executeParallelVersion = false;
-      }
+      // Workers of the pool plus the calling thread
+      nbThreads = vpThreadPool::getInstance().getNbThreads() + 1;
+    } else {
+      nbThreads = (unsigned int)nbParallelRansacThreads;
+    }
+    if (nbThreads <= 1) {
+      executeParallelVersion = false;
     }
-#endif
   }
 
   bool foundSolution = false;
 
+  // The trials are counted by the shared state, which stops the search when
+  // the consensus is reached or when the number of trials adapted to the
+  // ratio of outliers is done
+  RansacSharedState sharedState(ransacMaxTrials, ransacNbInlierConsensus, listOfUniquePoints.size());
+
   if (executeParallelVersion) {
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    std::vector<std::thread> threadpool;
+    // The trials are not split between the workers, each worker picks the
+    // next trial from the shared state
     std::vector<RansacFunctor> ransacWorkers;
-    const unsigned int nthreads = std::thread::hardware_concurrency();
-
-    int splitTrials = ransacMaxTrials / nthreads;
-    std::atomic<bool> abort{false};
-    for (size_t i = 0; i < (size_t)nthreads; i++) {
-      unsigned int initial_seed = (unsigned int)i; //((unsigned int) time(NULL) ^ i);
-      if (i < (size_t)nthreads - 1) {
-        ransacWorkers.emplace_back(cMo, ransacNbInlierConsensus, splitTrials, ransacThreshold, initial_seed,
-                                   checkDegeneratePoints, listOfUniquePoints, func, abort);
-      } else {
-        int maxTrialsRemainder = ransacMaxTrials - splitTrials * (nbThreads - 1);
-        ransacWorkers.emplace_back(cMo, ransacNbInlierConsensus, maxTrialsRemainder, ransacThreshold, initial_seed,
-                                   checkDegeneratePoints, listOfUniquePoints, func, abort);
-      }
-    }
-
-    for (auto& worker : ransacWorkers) {
-      threadpool.emplace_back(&RansacFunctor::operator(), &worker);
+    ransacWorkers.reserve(nbThreads);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      unsigned int initial_seed = i; //((unsigned int) time(NULL) ^ i);
+      ransacWorkers.push_back(RansacFunctor(cMo, ransacNbInlierConsensus, ransacMaxTrials, ransacThreshold,
+                                            initial_seed, checkDegeneratePoints, listOfUniquePoints, func,
+                                            &sharedState));
     }
 
-    for (auto& th : threadpool) {
-      th.join();
+    std::vector<vpThreadPool::vpTask *> tasks(nbThreads);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      tasks[i] = &ransacWorkers[i];
     }
+    vpThreadPool::getInstance().run(tasks);
 
     bool successRansac = false;
     size_t best_consensus_size = 0;
-    for (auto &worker : ransacWorkers) {
-      if (worker.getResult()) {
+    for (std::vector<RansacFunctor>::const_iterator it = ransacWorkers.begin(); it != ransacWorkers.end(); ++it) {
+      if (it->getResult()) {
         successRansac = true;
 
-        if (worker.getBestConsensus().size() > best_consensus_size) {
-          nbInliers = worker.getNbInliers();
-          best_consensus = worker.getBestConsensus();
-          best_consensus_size = worker.getBestConsensus().size();
+        if (it->getBestConsensus().size() > best_consensus_size) {
+          nbInliers = it->getNbInliers();
+          best_consensus = it->getBestConsensus();
+          best_consensus_size = best_consensus.size();
         }
       }
     }
 
     foundSolution = successRansac;
-#endif
   } else {
     // Sequential RANSAC
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
-    std::atomic<bool> abort{false};
-#endif
     RansacFunctor sequentialRansac(cMo, ransacNbInlierConsensus, ransacMaxTrials, ransacThreshold, 0,
-                                   checkDegeneratePoints, listOfUniquePoints, func
-                               #ifdef VISP_HAVE_CPP11_COMPATIBILITY
-                                   , abort
-                               #endif
-                                   );
+                                   checkDegeneratePoints, listOfUniquePoints, func, &sharedState);
     sequentialRansac();
     foundSolution = sequentialRansac.getResult();
 
@@ -509,20 +568,42 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(vpHomogeneousMatr
     {
       // Refine the solution using all the points in the consensus set and
       // with VVS pose estimation
-      vpPose pose;
+      vpPosePoints inliers;
+      inliers.reserve((unsigned int)best_consensus.size());
       for (size_t i = 0; i < best_consensus.size(); i++) {
-        vpPoint pt = listOfUniquePoints[best_consensus[i]];
-
-        pose.addPoint(pt);
-        ransacInliers.push_back(pt);
+        const unsigned int index = best_consensus[i];
+        inliers.addPoint(listOfUniquePoints.get_oX(index), listOfUniquePoints.get_oY(index),
+                         listOfUniquePoints.get_oZ(index), listOfUniquePoints.get_x(index),
+                         listOfUniquePoints.get_y(index));
       }
 
+      vpPose pose;
+      pose.addPoints(inliers);
+
       // Update the list of inlier index
       for (std::vector<unsigned int>::const_iterator it_index = best_consensus.begin();
            it_index != best_consensus.end(); ++it_index) {
         ransacInlierIndex.push_back((unsigned int)mapOfUniquePointIndex[*it_index]);
       }
 
+      // Update the list of inliers, with the points given as vpPoint if all
+      // the points were given as vpPoint
+      ransacInliers.reserve(ransacInlierIndex.size());
+      if (posePointsFromListP) {
+        std::vector<const vpPoint *> points;
+        points.reserve(listP.size());
+        for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
+          points.push_back(&(*it));
+        }
+        for (size_t i = 0; i < ransacInlierIndex.size(); i++) {
+          ransacInliers.push_back(*points[ransacInlierIndex[i]]);
+        }
+      } else {
+        for (size_t i = 0; i < ransacInlierIndex.size(); i++) {
+          ransacInliers.push_back(posePoints.getPoint(ransacInlierIndex[i]));
+        }
+      }
+
       // Flags set if pose computation is OK
       bool is_valid_lagrange = false;
       bool is_valid_dementhon = false;
@@ -665,7 +746,7 @@ int vpPose::computeRansacIterations(double probability, double epsilon, const in
   \param maxNbTrials : Maximum number of trials before
   considering a solution fitting the required \e
   numberOfInlierToReachAConsensus and \e threshold cannot be found.
-  \param useParallelRansac : If true, use parallel RANSAC version (if C++11 is available).
+  \param useParallelRansac : If true, use parallel RANSAC version.
   \param nthreads : Number of threads to use, if 0 the number of CPU threads will be determined.
 */
 void vpPose::findMatch(std::vector<vpPoint> &p2D, std::vector<vpPoint> &p3D,
@@ -676,23 +757,21 @@ void vpPose::findMatch(std::vector<vpPoint> &p2D, std::vector<vpPoint> &p3D,
 {
   vpPose pose;
 
-  int nbPts = 0;
+  vpPosePoints points;
+  points.reserve((unsigned int)(p2D.size() * p3D.size()));
   for (unsigned int i = 0; i < p2D.size(); i++) {
     for (unsigned int j = 0; j < p3D.size(); j++) {
-      vpPoint pt(p3D[j].getWorldCoordinates());
-      pt.set_x(p2D[i].get_x());
-      pt.set_y(p2D[i].get_y());
-      pose.addPoint(pt);
-      nbPts++;
+      points.addPoint(p3D[j].get_oX(), p3D[j].get_oY(), p3D[j].get_oZ(), p2D[i].get_x(), p2D[i].get_y());
     }
   }
+  pose.addPoints(points);
 
-  if (pose.listP.size() < 4) {
+  if (pose.npt < 4) {
     vpERROR_TRACE("Ransac method cannot be used in that case ");
     vpERROR_TRACE("(at least 4 points are required)");
-    vpERROR_TRACE("Not enough point (%d) to compute the pose  ", pose.listP.size());
+    vpERROR_TRACE("Not enough point (%d) to compute the pose  ", pose.npt);
     throw(vpPoseException(vpPoseException::notEnoughPointError, "Not enough point (%d) to compute the pose by ransac",
-                          pose.listP.size()));
+                          pose.npt));
   } else {
     pose.setUseParallelRansac(useParallelRansac);
     pose.setNbParallelRansacThreads(nthreads);
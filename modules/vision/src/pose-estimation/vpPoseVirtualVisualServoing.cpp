@@ -46,11 +46,53 @@
 #include <visp3/core/vpRobust.h>
 #include <visp3/vision/vpPose.h>
 
+#include <limits> // numeric_limits
+#include <vector>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Fill the two rows of the interaction matrix of a point projected in (x, y)
+// at depth Z
+inline void computeInteractionMatrix(double x, double y, double Z, double *Lx, double *Ly)
+{
+  Lx[0] = -1 / Z;
+  Lx[1] = 0;
+  Lx[2] = x / Z;
+  Lx[3] = x * y;
+  Lx[4] = -(1 + x * x);
+  Lx[5] = y;
+
+  Ly[0] = 0;
+  Ly[1] = -1 / Z;
+  Ly[2] = y / Z;
+  Ly[3] = 1 + y * y;
+  Ly[4] = -x * y;
+  Ly[5] = -x;
+}
+
+// Interaction matrix and error of all the points for the projection (x, y, Z)
+void computeInteractionMatrix(const vpPosePoints &points, const std::vector<double> &x, const std::vector<double> &y,
+                              const std::vector<double> &Z, vpMatrix &L, vpColVector &err)
+{
+  for (unsigned int k = 0; k < points.size(); k++) {
+    computeInteractionMatrix(x[k], y[k], Z[k], L[2 * k], L[2 * k + 1]);
+    err[2 * k] = x[k] - points.get_x(k);
+    err[2 * k + 1] = y[k] - points.get_y(k);
+  }
+}
+} // namespace
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   \brief Compute the pose using virtual visual servoing approach
 
   This approach is described in \cite Marchand02c.
 
+  The points are projected with vpPosePoints::project() and the normal
+  equations \f${\bf L}^T{\bf L}\f$ and \f${\bf L}^T{\bf e}\f$ are accumulated
+  point by point, so that an iteration neither allocates nor stores a matrix
+  whose size depends on the number of points.
 */
 
 void vpPose::poseVirtualVS(vpHomogeneousMatrix &cMo)
@@ -64,25 +106,15 @@ void vpPose::poseVirtualVS(vpHomogeneousMatrix &cMo)
 
     int iter = 0;
 
-    unsigned int nb = (unsigned int)listP.size();
-    vpMatrix L(2 * nb, 6);
-    vpColVector err(2 * nb);
-    vpColVector sd(2 * nb), s(2 * nb);
+    unsigned int nb = posePoints.size();
+    // Projection of the points for the current pose
+    std::vector<double> x(nb), y(nb), Z(nb);
+    double Lx[6], Ly[6];
+    double LTL_[6][6];
+    vpMatrix LTL(6, 6), LTLp;
+    vpColVector LTe(6);
     vpColVector v;
 
-    vpPoint P;
-    std::list<vpPoint> lP;
-
-    // create sd
-    unsigned int k = 0;
-    for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-      P = *it;
-      sd[2 * k] = P.get_x();
-      sd[2 * k + 1] = P.get_y();
-      lP.push_back(P);
-      k++;
-    }
-
     vpHomogeneousMatrix cMoPrev = cMo;
     // while((int)((residu_1 - r)*1e12) !=0)
     //    while(std::fabs((residu_1 - r)*1e12) >
@@ -90,45 +122,43 @@ void vpPose::poseVirtualVS(vpHomogeneousMatrix &cMo)
     while (std::fabs(residu_1 - r) > vvsEpsilon) {
       residu_1 = r;
 
-      // Compute the interaction matrix and the error
-      k = 0;
-      for (std::list<vpPoint>::const_iterator it = lP.begin(); it != lP.end(); ++it) {
-        P = *it;
-        // forward projection of the 3D model for a given pose
-        // change frame coordinates
-        // perspective projection
-        P.track(cMo);
-
-        double x = s[2 * k] = P.get_x(); /* point projected from cMo */
-        double y = s[2 * k + 1] = P.get_y();
-        double Z = P.get_Z();
-        L[2 * k][0] = -1 / Z;
-        L[2 * k][1] = 0;
-        L[2 * k][2] = x / Z;
-        L[2 * k][3] = x * y;
-        L[2 * k][4] = -(1 + x * x);
-        L[2 * k][5] = y;
-
-        L[2 * k + 1][0] = 0;
-        L[2 * k + 1][1] = -1 / Z;
-        L[2 * k + 1][2] = y / Z;
-        L[2 * k + 1][3] = 1 + y * y;
-        L[2 * k + 1][4] = -x * y;
-        L[2 * k + 1][5] = -x;
-
-        k += 1;
+      // forward projection of the 3D model for a given pose
+      if (nb > 0) {
+        posePoints.project(cMo, &x[0], &y[0], &Z[0]);
       }
-      err = s - sd;
 
-      // compute the residual
-      r = err.sumSquare();
+      // Compute the interaction matrix, the error and the residual
+      for (unsigned int i = 0; i < 6; i++) {
+        LTe[i] = 0;
+        for (unsigned int j = i; j < 6; j++) {
+          LTL_[i][j] = 0;
+        }
+      }
+      r = 0;
+      for (unsigned int k = 0; k < nb; k++) {
+        computeInteractionMatrix(x[k], y[k], Z[k], Lx, Ly);
+        double ex = x[k] - posePoints.get_x(k);
+        double ey = y[k] - posePoints.get_y(k);
+
+        for (unsigned int i = 0; i < 6; i++) {
+          LTe[i] += Lx[i] * ex + Ly[i] * ey;
+          for (unsigned int j = i; j < 6; j++) {
+            LTL_[i][j] += Lx[i] * Lx[j] + Ly[i] * Ly[j];
+          }
+        }
+        r += ex * ex + ey * ey;
+      }
+      for (unsigned int i = 0; i < 6; i++) {
+        for (unsigned int j = i; j < 6; j++) {
+          LTL[i][j] = LTL[j][i] = LTL_[i][j];
+        }
+      }
 
-      // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp;
-      L.pseudoInverse(Lp, 1e-16);
+      // compute the pseudo inverse of the normal matrix
+      LTL.pseudoInverse(LTLp, LTL.getRows() * std::numeric_limits<double>::epsilon());
 
       // compute the VVS control law
-      v = -lambda * Lp * err;
+      v = -lambda * LTLp * LTe;
 
       // std::cout << "r=" << r <<std::endl ;
       // update the pose
@@ -140,8 +170,15 @@ void vpPose::poseVirtualVS(vpHomogeneousMatrix &cMo)
         break;
     }
 
-    if (computeCovariance)
+    if (computeCovariance) {
+      vpMatrix L(2 * nb, 6);
+      vpColVector err(2 * nb);
+      if (nb > 0) {
+        posePoints.project(cMoPrev, &x[0], &y[0], &Z[0]);
+      }
+      computeInteractionMatrix(posePoints, x, y, Z, L, err);
       covarianceMatrix = vpMatrix::computeCovarianceMatrixVVS(cMoPrev, err, L);
+    }
   }
 
   catch (...) {
@@ -165,90 +202,57 @@ void vpPose::poseVirtualVSrobust(vpHomogeneousMatrix &cMo)
     double r = 1e8 - 1;
 
     // we stop the minimization when the error is bellow 1e-8
-    vpMatrix W;
-    vpRobust robust((unsigned int)(2 * listP.size()));
+    unsigned int nb = posePoints.size();
+    vpRobust robust(2 * nb);
     robust.setThreshold(0.0000);
     vpColVector w, res;
 
-    unsigned int nb = (unsigned int)listP.size();
-    vpMatrix L(2 * nb, 6);
-    vpColVector error(2 * nb);
-    vpColVector sd(2 * nb), s(2 * nb);
+    // Projection of the points for the current pose
+    std::vector<double> x(nb), y(nb), Z(nb);
+    vpMatrix L(2 * nb, 6), WL(2 * nb, 6);
+    vpColVector error(2 * nb), Werror(2 * nb);
     vpColVector v;
 
-    listP.front();
-    vpPoint P;
-    std::list<vpPoint> lP;
-
-    // create sd
-    unsigned int k_ = 0;
-    for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-      P = *it;
-      sd[2 * k_] = P.get_x();
-      sd[2 * k_ + 1] = P.get_y();
-      lP.push_back(P);
-      k_++;
-    }
     int iter = 0;
-    res.resize(s.getRows() / 2);
-    w.resize(s.getRows() / 2);
-    W.resize(s.getRows(), s.getRows());
+    res.resize(nb);
+    w.resize(nb);
     w = 1;
 
     // while((int)((residu_1 - r)*1e12) !=0)
     while (std::fabs((residu_1 - r) * 1e12) > std::numeric_limits<double>::epsilon()) {
       residu_1 = r;
 
-      // Compute the interaction matrix and the error
-      k_ = 0;
-      for (std::list<vpPoint>::const_iterator it = lP.begin(); it != lP.end(); ++it) {
-        P = *it;
-        // forward projection of the 3D model for a given pose
-        // change frame coordinates
-        // perspective projection
-        P.track(cMo);
-
-        double x = s[2 * k_] = P.get_x(); // point projected from cMo
-        double y = s[2 * k_ + 1] = P.get_y();
-        double Z = P.get_Z();
-        L[2 * k_][0] = -1 / Z;
-        L[2 * k_][1] = 0;
-        L[2 * k_][2] = x / Z;
-        L[2 * k_][3] = x * y;
-        L[2 * k_][4] = -(1 + x * x);
-        L[2 * k_][5] = y;
-
-        L[2 * k_ + 1][0] = 0;
-        L[2 * k_ + 1][1] = -1 / Z;
-        L[2 * k_ + 1][2] = y / Z;
-        L[2 * k_ + 1][3] = 1 + y * y;
-        L[2 * k_ + 1][4] = -x * y;
-        L[2 * k_ + 1][5] = -x;
-
-        k_++;
+      // forward projection of the 3D model for a given pose
+      if (nb > 0) {
+        posePoints.project(cMo, &x[0], &y[0], &Z[0]);
       }
-      error = s - sd;
+
+      // Compute the interaction matrix and the error
+      computeInteractionMatrix(posePoints, x, y, Z, L, error);
 
       // compute the residual
       r = error.sumSquare();
 
-      for (unsigned int k = 0; k < error.getRows() / 2; k++) {
+      for (unsigned int k = 0; k < nb; k++) {
         res[k] = vpMath::sqr(error[2 * k]) + vpMath::sqr(error[2 * k + 1]);
       }
       robust.setIteration(0);
       robust.MEstimator(vpRobust::TUKEY, res, w);
 
-      // compute the pseudo inverse of the interaction matrix
-      for (unsigned int k = 0; k < error.getRows() / 2; k++) {
-        W[2 * k][2 * k] = w[k];
-        W[2 * k + 1][2 * k + 1] = w[k];
+      // weight the interaction matrix and the error, the weighting matrix
+      // being diagonal
+      for (unsigned int k = 0; k < 2 * nb; k++) {
+        for (unsigned int j = 0; j < 6; j++) {
+          WL[k][j] = w[k / 2] * L[k][j];
+        }
+        Werror[k] = w[k / 2] * error[k];
       }
       // compute the pseudo inverse of the interaction matrix
       vpMatrix Lp;
-      (W * L).pseudoInverse(Lp, 1e-6);
+      WL.pseudoInverse(Lp, 1e-6);
 
       // compute the VVS control law
-      v = -lambda * Lp * W * error;
+      v = -lambda * Lp * Werror;
 
       cMo = vpExponentialMap::direct(v).inverse() * cMo;
       ;
@@ -256,11 +260,15 @@ void vpPose::poseVirtualVSrobust(vpHomogeneousMatrix &cMo)
         break;
     }
 
-    if (computeCovariance)
+    if (computeCovariance) {
+      vpMatrix W2(2 * nb, 2 * nb);
+      for (unsigned int k = 0; k < 2 * nb; k++) {
+        W2[k][k] = vpMath::sqr(w[k / 2]);
+      }
       covarianceMatrix =
-          vpMatrix::computeCovarianceMatrix(L, v, -lambda * error, W * W); // Remark: W*W = W*W.t() since the
-                                                                           // matrix is diagonale, but using W*W
-                                                                           // is more efficient.
+          vpMatrix::computeCovarianceMatrix(L, v, -lambda * error, W2); // Remark: W*W = W*W.t() since the
+                                                                        // matrix is diagonale
+    }
   } catch (...) {
     vpERROR_TRACE(" ");
     throw;
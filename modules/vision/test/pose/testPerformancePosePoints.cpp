@@ -0,0 +1,287 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the pose estimation from a vpPosePoints set.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformancePosePoints.cpp
+
+  \brief Check that vpPosePoints::project() gives the same result as
+  vpPoint::track(), and compare the virtual visual servoing pose estimation
+  from 1000 points stored in a vpPosePoints set with the implementation that
+  tracks a std::list<vpPoint> at each iteration.
+*/
+
+#include <iostream>
+#include <list>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpGaussRand.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPosePoints.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+double uniform(vpUniRand &rand_uniform, double a, double b) { return a + (b - a) * rand_uniform(); }
+
+// Points corrupted by a small gaussian noise
+std::vector<vpPoint> createPoints(unsigned int nbPoints, const vpHomogeneousMatrix &cMo)
+{
+  vpUniRand rand_uniform(42);
+  vpGaussRand rand_gauss(0.0002, 0.0, 17);
+  std::vector<vpPoint> points;
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    vpPoint pt(uniform(rand_uniform, -0.2, 0.2), uniform(rand_uniform, -0.2, 0.2),
+               uniform(rand_uniform, -0.1, 0.1));
+    pt.project(cMo);
+    pt.set_x(pt.get_x() + rand_gauss());
+    pt.set_y(pt.get_y() + rand_gauss());
+    points.push_back(pt);
+  }
+  return points;
+}
+
+// Virtual visual servoing as done before vpPosePoints was introduced: the
+// points are copied in a std::list and tracked one at a time at each
+// iteration
+void poseVirtualVSReference(const std::list<vpPoint> &listP, vpHomogeneousMatrix &cMo, double lambda,
+                            double vvsEpsilon, int vvsIterMax)
+{
+  double residu_1 = 1e8;
+  double r = 1e8 - 1;
+  int iter = 0;
+
+  unsigned int nb = (unsigned int)listP.size();
+  vpMatrix L(2 * nb, 6);
+  vpColVector err(2 * nb);
+  vpColVector sd(2 * nb), s(2 * nb);
+  vpColVector v;
+
+  vpPoint P;
+  std::list<vpPoint> lP;
+
+  unsigned int k = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
+    P = *it;
+    sd[2 * k] = P.get_x();
+    sd[2 * k + 1] = P.get_y();
+    lP.push_back(P);
+    k++;
+  }
+
+  while (std::fabs(residu_1 - r) > vvsEpsilon) {
+    residu_1 = r;
+
+    k = 0;
+    for (std::list<vpPoint>::const_iterator it = lP.begin(); it != lP.end(); ++it) {
+      P = *it;
+      P.track(cMo);
+
+      double x = s[2 * k] = P.get_x();
+      double y = s[2 * k + 1] = P.get_y();
+      double Z = P.get_Z();
+      L[2 * k][0] = -1 / Z;
+      L[2 * k][1] = 0;
+      L[2 * k][2] = x / Z;
+      L[2 * k][3] = x * y;
+      L[2 * k][4] = -(1 + x * x);
+      L[2 * k][5] = y;
+
+      L[2 * k + 1][0] = 0;
+      L[2 * k + 1][1] = -1 / Z;
+      L[2 * k + 1][2] = y / Z;
+      L[2 * k + 1][3] = 1 + y * y;
+      L[2 * k + 1][4] = -x * y;
+      L[2 * k + 1][5] = -x;
+
+      k += 1;
+    }
+    err = s - sd;
+    r = err.sumSquare();
+
+    vpMatrix Lp;
+    L.pseudoInverse(Lp, 1e-16);
+    v = -lambda * Lp * err;
+
+    cMo = vpExponentialMap::direct(v).inverse() * cMo;
+    if (iter++ > vvsIterMax)
+      break;
+  }
+}
+
+bool testProject(const std::vector<vpPoint> &points, const vpHomogeneousMatrix &cMo)
+{
+  vpPosePoints posePoints(points);
+  unsigned int n = posePoints.size();
+  std::vector<double> x(n), y(n), Z(n);
+  posePoints.project(cMo, &x[0], &y[0], &Z[0]);
+
+  for (unsigned int i = 0; i < n; i++) {
+    vpPoint P = points[i];
+    P.track(cMo);
+    if (P.get_x() != x[i] || P.get_y() != y[i] || P.get_Z() != Z[i]) {
+      std::cerr << "Point " << i << ": vpPoint::track() gives (" << P.get_x() << ", " << P.get_y() << ", "
+                << P.get_Z() << ") while vpPosePoints::project() gives (" << x[i] << ", " << y[i] << ", " << Z[i]
+                << ")" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool equal(const vpHomogeneousMatrix &M1, const vpHomogeneousMatrix &M2)
+{
+  for (unsigned int i = 0; i < 4; i++) {
+    for (unsigned int j = 0; j < 4; j++) {
+      if (M1[i][j] != M2[i][j]) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool comparePoses(const vpHomogeneousMatrix &cMo, const vpHomogeneousMatrix &cMo_ref, const std::string &name)
+{
+  vpHomogeneousMatrix cdMc = cMo_ref * cMo.inverse();
+  vpThetaUVector tu(cdMc);
+  if (cdMc.getTranslationVector().euclideanNorm() > 1e-6 || sqrt(tu.sumSquare()) > 1e-6) {
+    std::cerr << name << ": pose\n" << cMo << "\ndiffers from the reference pose\n" << cMo_ref << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+#if defined(__mips__) || defined(__mips) || defined(mips) || defined(__MIPS__)
+  // To avoid Debian test timeout
+  return EXIT_SUCCESS;
+#endif
+
+  try {
+    const vpHomogeneousMatrix cMo_truth(0.05, -0.02, 0.8, vpMath::rad(10), vpMath::rad(-15), vpMath::rad(25));
+    const vpHomogeneousMatrix cMo_init(0.07, -0.01, 0.75, vpMath::rad(15), vpMath::rad(-10), vpMath::rad(20));
+    const unsigned int nbPoints = 1000;
+    const unsigned int nbCalls = 20;
+
+    std::vector<vpPoint> points = createPoints(nbPoints, cMo_truth);
+    std::list<vpPoint> listP(points.begin(), points.end());
+    vpPosePoints posePoints(points);
+
+    if (!testProject(points, cMo_init)) {
+      return EXIT_FAILURE;
+    }
+
+    double t_ref = 0, t_point = 0, t_pose_points = 0;
+    vpHomogeneousMatrix cMo_ref, cMo_point, cMo_pose_points;
+    for (unsigned int i = 0; i < nbCalls; i++) {
+      // Per-point tracking of a std::list<vpPoint>
+      cMo_ref = cMo_init;
+      double t = vpTime::measureTimeMs();
+      poseVirtualVSReference(listP, cMo_ref, 0.25, 1e-8, 200);
+      t_ref += vpTime::measureTimeMs() - t;
+
+      // Points given as vpPoint
+      cMo_point = cMo_init;
+      t = vpTime::measureTimeMs();
+      vpPose pose_point;
+      pose_point.addPoints(points);
+      pose_point.computePose(vpPose::VIRTUAL_VS, cMo_point);
+      t_point += vpTime::measureTimeMs() - t;
+
+      // Points given as a vpPosePoints set
+      cMo_pose_points = cMo_init;
+      t = vpTime::measureTimeMs();
+      vpPose pose_pose_points;
+      pose_pose_points.addPoints(posePoints);
+      pose_pose_points.computePose(vpPose::VIRTUAL_VS, cMo_pose_points);
+      t_pose_points += vpTime::measureTimeMs() - t;
+    }
+
+    std::cout << nbPoints << " points, virtual visual servoing: std::list<vpPoint> tracking " << t_ref / nbCalls
+              << " ms ; vpPose from vpPoint " << t_point / nbCalls << " ms ; vpPose from vpPosePoints "
+              << t_pose_points / nbCalls << " ms per call" << std::endl;
+
+    if (!comparePoses(cMo_point, cMo_ref, "vpPoint") || !comparePoses(cMo_pose_points, cMo_ref, "vpPosePoints")) {
+      return EXIT_FAILURE;
+    }
+
+    // The linear methods and the RANSAC give the same result whatever the
+    // way the points are given
+    vpPose pose_point, pose_pose_points;
+    pose_point.addPoints(points);
+    pose_pose_points.addPoints(posePoints);
+    vpPose::vpPoseMethodType methods[3] = {vpPose::LAGRANGE, vpPose::DEMENTHON, vpPose::RANSAC};
+    std::string names[3] = {"Lagrange", "Dementhon", "RANSAC"};
+    for (unsigned int i = 0; i < 3; i++) {
+      pose_point.setRansacThreshold(0.001);
+      pose_pose_points.setRansacThreshold(0.001);
+      pose_point.computePose(methods[i], cMo_point);
+      pose_pose_points.computePose(methods[i], cMo_pose_points);
+      if (!equal(cMo_point, cMo_pose_points)) {
+        std::cerr << names[i] << ": pose from vpPoint\n"
+                  << cMo_point << "\ndiffers from the pose from vpPosePoints\n"
+                  << cMo_pose_points << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (pose_point.getRansacInlierIndex() != pose_pose_points.getRansacInlierIndex()) {
+      std::cerr << "RANSAC: the inliers differ" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // A direct modification of listP is still taken into account when all
+    // the points were given as vpPoint
+    vpPose pose_list;
+    pose_list.addPoints(createPoints(nbPoints, cMo_init));
+    pose_list.listP.assign(points.begin(), points.end());
+    vpHomogeneousMatrix cMo_list = cMo_init;
+    pose_list.computePose(vpPose::VIRTUAL_VS, cMo_list);
+    if (!comparePoses(cMo_list, cMo_ref, "listP")) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testPerformancePosePoints is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
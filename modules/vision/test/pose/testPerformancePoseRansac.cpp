@@ -0,0 +1,140 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the sequential and parallel RANSAC pose estimation.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformancePoseRansac.cpp
+
+  \brief Compare the latency of a call to the sequential and to the parallel
+  vpPose::poseRansac() for 50, 500 and 5000 correspondences.
+*/
+
+#include <iostream>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpGaussRand.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpPose.h>
+
+namespace
+{
+double uniform(vpUniRand &rand_uniform, double a, double b) { return a + (b - a) * rand_uniform(); }
+
+// 30% of outliers, the inliers are corrupted by a small gaussian noise
+std::vector<vpPoint> createCorrespondences(unsigned int nbPoints, const vpHomogeneousMatrix &cMo)
+{
+  vpUniRand rand_uniform(42);
+  vpGaussRand rand_gauss(0.0002, 0.0, 17);
+  std::vector<vpPoint> points;
+  for (unsigned int i = 0; i < nbPoints; i++) {
+    vpPoint pt(uniform(rand_uniform, -0.2, 0.2), uniform(rand_uniform, -0.2, 0.2),
+               uniform(rand_uniform, -0.1, 0.1));
+    pt.project(cMo);
+    if (i % 10 < 3) {
+      pt.set_x(uniform(rand_uniform, -0.5, 0.5));
+      pt.set_y(uniform(rand_uniform, -0.5, 0.5));
+    } else {
+      pt.set_x(pt.get_x() + rand_gauss());
+      pt.set_y(pt.get_y() + rand_gauss());
+    }
+    points.push_back(pt);
+  }
+  return points;
+}
+
+// nbThreads = 1 for the sequential version, 0 for the number of threads of the pool
+bool benchmark(const std::vector<vpPoint> &points, const vpHomogeneousMatrix &cMo_truth, int nbThreads,
+               unsigned int nbCalls, double &time_ms)
+{
+  time_ms = 0;
+  for (unsigned int i = 0; i < nbCalls; i++) {
+    vpPose pose;
+    pose.addPoints(points);
+    pose.setUseParallelRansac(nbThreads != 1);
+    pose.setNbParallelRansacThreads(nbThreads);
+    pose.setRansacNbInliersToReachConsensus((unsigned int)(0.6 * points.size()));
+    pose.setRansacThreshold(0.001);
+    pose.setRansacMaxTrials(1000);
+
+    vpHomogeneousMatrix cMo;
+    double t = vpTime::measureTimeMs();
+    pose.computePose(vpPose::RANSAC, cMo);
+    time_ms += vpTime::measureTimeMs() - t;
+
+    vpHomogeneousMatrix cdMc = cMo_truth * cMo.inverse();
+    if (cdMc.getTranslationVector().euclideanNorm() > 0.01) {
+      std::cerr << "Bad pose estimated with " << points.size() << " points:\n" << cMo << std::endl;
+      return false;
+    }
+  }
+  time_ms /= nbCalls;
+  return true;
+}
+}
+
+int main()
+{
+#if defined(__mips__) || defined(__mips) || defined(mips) || defined(__MIPS__)
+  // To avoid Debian test timeout
+  return EXIT_SUCCESS;
+#endif
+
+  try {
+    std::cout << "Thread pool with " << vpThreadPool::getInstance().getNbThreads() << " workers" << std::endl;
+
+    const vpHomogeneousMatrix cMo_truth(0.05, -0.02, 0.8, vpMath::rad(10), vpMath::rad(-15), vpMath::rad(25));
+    const unsigned int sizes[] = {50, 500, 5000};
+    const unsigned int nbCalls[] = {100, 20, 5};
+    for (unsigned int i = 0; i < 3; i++) {
+      std::vector<vpPoint> points = createCorrespondences(sizes[i], cMo_truth);
+
+      double t_sequential = 0, t_parallel = 0, t_parallel4 = 0;
+      if (!benchmark(points, cMo_truth, 1, nbCalls[i], t_sequential) ||
+          !benchmark(points, cMo_truth, 0, nbCalls[i], t_parallel) ||
+          !benchmark(points, cMo_truth, 4, nbCalls[i], t_parallel4)) {
+        return EXIT_FAILURE;
+      }
+
+      std::cout << sizes[i] << " correspondences: sequential " << t_sequential << " ms ; parallel " << t_parallel
+                << " ms ; parallel with 4 tasks " << t_parallel4 << " ms per call" << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -1859,14 +1859,12 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   vpPose pose;
   vpPose pose_ransac, pose_ransac2;
 
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
   vpPose pose_ransac_parallel, pose_ransac_parallel2;
   pose_ransac_parallel.setUseParallelRansac(true);
   pose_ransac_parallel2.setUseParallelRansac(true);
 
   pose_ransac_parallel.setRansacFilterFlag(vpPose::PREFILTER_DEGENERATE_POINTS);
   pose_ransac_parallel2.setRansacFilterFlag(vpPose::PREFILTER_DEGENERATE_POINTS);
-#endif
   pose_ransac.setRansacFilterFlag(vpPose::PREFILTER_DEGENERATE_POINTS);
   pose_ransac2.setRansacFilterFlag(vpPose::PREFILTER_DEGENERATE_POINTS);
   for (std::vector<vpPoint>::const_iterator it = bunnyModelPoints_noisy.begin(); it != bunnyModelPoints_noisy.end(); ++it) {
@@ -1875,10 +1873,8 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   // Test addPoints
   pose_ransac.addPoints(bunnyModelPoints_noisy);
   pose_ransac2.addPoints(bunnyModelPoints_noisy);
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
   pose_ransac_parallel.addPoints(bunnyModelPoints_noisy);
   pose_ransac_parallel2.addPoints(bunnyModelPoints_noisy);
-#endif
 
   // Print the number of points in the final data vector
   std::cout << "\nNumber of model points in the noisy data vector: " << bunnyModelPoints_noisy.size() << " points."
@@ -1892,7 +1888,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   pose_ransac.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
   pose_ransac.setRansacThreshold(threshold);
   pose_ransac.setRansacMaxTrials(1000);
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
   pose_ransac_parallel.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
   pose_ransac_parallel.setRansacThreshold(threshold);
   pose_ransac_parallel.setRansacMaxTrials(1000);
@@ -1900,7 +1895,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   pose_ransac_parallel2.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
   pose_ransac_parallel2.setRansacThreshold(threshold);
   pose_ransac_parallel2.setRansacMaxTrials(vpPose::computeRansacIterations(0.99, 0.4, 4, -1));
-#endif
 
   // RANSAC with p=0.99, epsilon=0.4
   pose_ransac2.setRansacNbInliersToReachConsensus(nbInlierToReachConsensus);
@@ -1949,7 +1943,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   double r_estimated = ground_truth_pose.computeResidual(cMo_estimated);
   std::cout << "Corresponding residual: " << r_estimated << std::endl;
 
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
   double r_RANSAC_estimated_parallel = std::numeric_limits<double>::max();
   vpHomogeneousMatrix cMo_estimated_RANSAC_parallel;
   double t_RANSAC_parallel = vpTime::measureTimeMs();
@@ -1976,7 +1969,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
   double r_RANSAC_estimated_parallel2 = ground_truth_pose.computeResidual(cMo_estimated_RANSAC_parallel2);
   std::cout << "Corresponding residual (" << ransac_iterations << " iterations): " << r_RANSAC_estimated_parallel2
             << std::endl;
-#endif
 
   // Check inlier index
   std::vector<unsigned int> vectorOfFoundInlierIndex = pose_ransac.getRansacInlierIndex();
@@ -2020,7 +2012,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
     return false;
   }
 
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
   // Check for parallel RANSAC
   // Check inlier index
   std::cout << "\nCheck for parallel RANSAC (1000 iterations)" << std::endl;
@@ -2064,7 +2055,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
                          bunnyModelPoints_noisy)) {
     return false;
   }
-#endif
 
   if (r_RANSAC_estimated > threshold /*|| r_RANSAC_estimated_2 > threshold*/) {
     std::cerr << "The pose estimated with the RANSAC method is badly estimated!" << std::endl;
@@ -2072,7 +2062,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
     std::cerr << "threshold=" << threshold << std::endl;
     return false;
   } else {
-#ifdef VISP_HAVE_CPP11_COMPATIBILITY
     if (r_RANSAC_estimated_parallel > threshold) {
       std::cerr << "The pose estimated with the parallel RANSAC method is "
                    "badly estimated!"
@@ -2081,7 +2070,6 @@ bool testRansac(const std::vector<vpPoint> &bunnyModelPoints_original,
       std::cerr << "threshold=" << threshold << std::endl;
       return false;
     }
-#endif
     std::cout << "The pose estimated with the RANSAC method is well estimated!" << std::endl;
   }
 
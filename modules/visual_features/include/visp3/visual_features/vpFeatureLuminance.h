@@ -41,8 +41,11 @@
 
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpRect.h>
 #include <visp3/visual_features/vpBasicFeature.h>
 
+#include <vector>
+
 /*!
   \file vpFeatureLuminance.h
   \brief Class that defines the image luminance visual feature
@@ -50,15 +53,19 @@
   For more details see \cite Collewet08c.
 */
 
+#if defined(VISP_BUILD_DEPRECATED_FUNCTIONS)
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
   \class vpLuminance
   \brief Class that defines the luminance and gradient of a point
 
+  \deprecated vpFeatureLuminance no longer stores its pixels as an array of
+  vpLuminance, this class is only kept for compatibility.
+
   \sa vpFeatureLuminance
 */
-class VISP_EXPORT vpLuminance
+class VISP_EXPORT vp_deprecated vpLuminance
 {
 public:
   double x, y;   // point coordinates (in meter)
@@ -67,6 +74,7 @@ public:
   double Z;      // pixel depth
 };
 #endif
+#endif
 
 /*!
   \class vpFeatureLuminance
@@ -74,6 +82,39 @@ public:
   \brief Class that defines the image luminance visual feature
 
   For more details see \cite Collewet08c.
+
+  By default the feature is made of all the pixels of the image except a
+  border of 10 pixels. The set of pixels can be reduced to shrink the task
+  dimension:
+  - setROI() keeps the pixels inside a rectangle,
+  - setSampling() keeps one pixel every \e step_i rows and \e step_j columns,
+  - selectPixels() keeps the pixels where the gradient of an image, usually
+  the desired one, is large enough.
+
+  The current and the desired features have to be made of the same pixels. A
+  copy of the desired feature keeps its set of pixels:
+  \code
+  vpFeatureLuminance sId;
+  sId.init(Id.getHeight(), Id.getWidth(), Z);
+  sId.setCameraParameters(cam);
+  sId.setSampling(2, 2);
+  sId.selectPixels(Id, 10.);
+  sId.buildFrom(Id);
+
+  vpFeatureLuminance sI(sId);
+  sI.buildFrom(I);
+  \endcode
+
+  The luminance and its gradient are stored per pixel in separate arrays, and
+  are computed by buildFrom() several pixels at a time with SSE2 instructions
+  when available. interactionNormalEquations() gives \f${\bf L}^\top {\bf L}\f$
+  and \f${\bf L}^\top {\bf e}\f$ without building the interaction matrix
+  \f$\bf L\f$, which has one row per pixel.
+
+  \note The protected array of vpLuminance \e pixInfo was replaced by the
+  arrays pixRow, pixCol, pixX, pixY, pixIx and pixIy, the luminance being in
+  \e s. A class that inherits from vpFeatureLuminance and uses \e pixInfo has
+  to be updated.
 */
 
 class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
@@ -90,10 +131,28 @@ protected:
   //! Border size.
   unsigned int bord;
 
-  //! Store the image (as a vector with intensity and gradient I, Ix, Iy)
-  vpLuminance *pixInfo;
+  //! Row of each pixel of the feature
+  std::vector<unsigned int> pixRow;
+  //! Column of each pixel of the feature
+  std::vector<unsigned int> pixCol;
+  //! Normalized coordinates x of each pixel (in meter)
+  std::vector<double> pixX;
+  //! Normalized coordinates y of each pixel (in meter)
+  std::vector<double> pixY;
+  //! Gradient of the luminance along x of each pixel
+  std::vector<double> pixIx;
+  //! Gradient of the luminance along y of each pixel
+  std::vector<double> pixIy;
   int firstTimeIn;
 
+  //! Region of interest in the image (used if useROI is true)
+  vpRect roi;
+  bool useROI;
+  //! Sampling step along the rows and the columns of the image
+  unsigned int stepRow, stepCol;
+
+  void initPixels();
+
 public:
   vpFeatureLuminance();
   vpFeatureLuminance(const vpFeatureLuminance &f);
@@ -120,12 +179,16 @@ public:
   void init(unsigned int _nbr, unsigned int _nbc, double _Z);
   vpMatrix interaction(const unsigned int select = FEATURE_ALL);
   void interaction(vpMatrix &L);
+  void interactionNormalEquations(const vpColVector &e, vpMatrix &LtL, vpColVector &Lte);
 
   vpFeatureLuminance &operator=(const vpFeatureLuminance &f);
 
   void print(const unsigned int select = FEATURE_ALL) const;
 
+  void selectPixels(const vpImage<unsigned char> &I, double gradientThreshold);
   void setCameraParameters(vpCameraParameters &_cam);
+  void setROI(const vpRect &roi_);
+  void setSampling(unsigned int step_i, unsigned int step_j);
   void set_Z(const double Z);
 
 public:
@@ -46,6 +46,14 @@
 
 #include <visp3/visual_features/vpFeatureLuminance.h>
 
+#include <algorithm>
+#include <cmath>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 /*!
   \file vpFeatureLuminance.cpp
   \brief Class that defines the image luminance visual feature
@@ -53,6 +61,151 @@
   For more details see \cite Collewet08c.
 */
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Numerator of vpImageFilter::derivativeFilterX() (stride = 1) and
+// vpImageFilter::derivativeFilterY() (stride = image width) at the pixel p,
+// whose denominator is 8418. Since the terms are integers, the derivative
+// n / 8418.0 is exactly the one given by vpImageFilter.
+inline int derivativeNumerator(const unsigned char *p, int stride)
+{
+  return 2047 * (p[stride] - p[-stride]) + 913 * (p[2 * stride] - p[-2 * stride]) +
+         112 * (p[3 * stride] - p[-3 * stride]);
+}
+
+// Interaction matrix row of a pixel with gradient (Ix, Iy) and normalized
+// coordinates (x, y)
+inline void interactionRow(double Ix, double Iy, double x, double y, double Zinv, double *L)
+{
+  L[0] = Ix * Zinv;
+  L[1] = Iy * Zinv;
+  L[2] = -(x * Ix + y * Iy) * Zinv;
+  L[3] = -Ix * x * y - (1 + y * y) * Iy;
+  L[4] = (1 + x * x) * Ix + Iy * x * y;
+  L[5] = Iy * x - Ix * y;
+}
+
+#if VISP_HAVE_SSE2
+inline __m128i load8(const unsigned char *p)
+{
+  return _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(p)), _mm_setzero_si128());
+}
+
+// 8 derivative numerators as two vectors of 4 int32, same computation as
+// derivativeNumerator()
+inline void derivativeNumerator(const unsigned char *p, int stride, __m128i &lo, __m128i &hi)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i c12 = _mm_set_epi16(913, 2047, 913, 2047, 913, 2047, 913, 2047);
+  const __m128i c3 = _mm_set_epi16(0, 112, 0, 112, 0, 112, 0, 112);
+  __m128i d1 = _mm_sub_epi16(load8(p + stride), load8(p - stride));
+  __m128i d2 = _mm_sub_epi16(load8(p + 2 * stride), load8(p - 2 * stride));
+  __m128i d3 = _mm_sub_epi16(load8(p + 3 * stride), load8(p - 3 * stride));
+  lo = _mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(d1, d2), c12),
+                     _mm_madd_epi16(_mm_unpacklo_epi16(d3, zero), c3));
+  hi = _mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(d1, d2), c12),
+                     _mm_madd_epi16(_mm_unpackhi_epi16(d3, zero), c3));
+}
+
+// scale * (n / 8418.0) for 4 int32 numerators n
+inline void storeDerivative(__m128i n, __m128d scale, double *d)
+{
+  const __m128d denom = _mm_set1_pd(8418.0);
+  _mm_storeu_pd(d, _mm_mul_pd(scale, _mm_div_pd(_mm_cvtepi32_pd(n), denom)));
+  _mm_storeu_pd(d + 2, _mm_mul_pd(scale, _mm_div_pd(_mm_cvtepi32_pd(_mm_srli_si128(n, 8)), denom)));
+}
+
+// Interaction matrix rows of two pixels, same operations as interactionRow()
+inline void interactionRows(const double *Ix_, const double *Iy_, const double *x_, const double *y_, __m128d Zinv,
+                            __m128d *L)
+{
+  const __m128d one = _mm_set1_pd(1.0);
+  const __m128d sign = _mm_set1_pd(-0.0);
+  const __m128d Ix = _mm_loadu_pd(Ix_), Iy = _mm_loadu_pd(Iy_);
+  const __m128d x = _mm_loadu_pd(x_), y = _mm_loadu_pd(y_);
+
+  L[0] = _mm_mul_pd(Ix, Zinv);
+  L[1] = _mm_mul_pd(Iy, Zinv);
+  L[2] = _mm_mul_pd(_mm_xor_pd(_mm_add_pd(_mm_mul_pd(x, Ix), _mm_mul_pd(y, Iy)), sign), Zinv);
+  L[3] = _mm_sub_pd(_mm_mul_pd(_mm_mul_pd(_mm_xor_pd(Ix, sign), x), y),
+                    _mm_mul_pd(_mm_add_pd(one, _mm_mul_pd(y, y)), Iy));
+  L[4] = _mm_add_pd(_mm_mul_pd(_mm_add_pd(one, _mm_mul_pd(x, x)), Ix), _mm_mul_pd(_mm_mul_pd(Iy, x), y));
+  L[5] = _mm_sub_pd(_mm_mul_pd(Iy, x), _mm_mul_pd(Ix, y));
+}
+
+// Accumulate the upper triangle of l l^T in acc[0..20] and l e in
+// acc[21..26] for two pixels. The accumulators are written out so that they
+// stay in registers.
+inline void accumulateNormalEquations(const __m128d *l, __m128d e, __m128d *acc)
+{
+  acc[0] = _mm_add_pd(acc[0], _mm_mul_pd(l[0], l[0]));
+  acc[1] = _mm_add_pd(acc[1], _mm_mul_pd(l[0], l[1]));
+  acc[2] = _mm_add_pd(acc[2], _mm_mul_pd(l[0], l[2]));
+  acc[3] = _mm_add_pd(acc[3], _mm_mul_pd(l[0], l[3]));
+  acc[4] = _mm_add_pd(acc[4], _mm_mul_pd(l[0], l[4]));
+  acc[5] = _mm_add_pd(acc[5], _mm_mul_pd(l[0], l[5]));
+  acc[6] = _mm_add_pd(acc[6], _mm_mul_pd(l[1], l[1]));
+  acc[7] = _mm_add_pd(acc[7], _mm_mul_pd(l[1], l[2]));
+  acc[8] = _mm_add_pd(acc[8], _mm_mul_pd(l[1], l[3]));
+  acc[9] = _mm_add_pd(acc[9], _mm_mul_pd(l[1], l[4]));
+  acc[10] = _mm_add_pd(acc[10], _mm_mul_pd(l[1], l[5]));
+  acc[11] = _mm_add_pd(acc[11], _mm_mul_pd(l[2], l[2]));
+  acc[12] = _mm_add_pd(acc[12], _mm_mul_pd(l[2], l[3]));
+  acc[13] = _mm_add_pd(acc[13], _mm_mul_pd(l[2], l[4]));
+  acc[14] = _mm_add_pd(acc[14], _mm_mul_pd(l[2], l[5]));
+  acc[15] = _mm_add_pd(acc[15], _mm_mul_pd(l[3], l[3]));
+  acc[16] = _mm_add_pd(acc[16], _mm_mul_pd(l[3], l[4]));
+  acc[17] = _mm_add_pd(acc[17], _mm_mul_pd(l[3], l[5]));
+  acc[18] = _mm_add_pd(acc[18], _mm_mul_pd(l[4], l[4]));
+  acc[19] = _mm_add_pd(acc[19], _mm_mul_pd(l[4], l[5]));
+  acc[20] = _mm_add_pd(acc[20], _mm_mul_pd(l[5], l[5]));
+  acc[21] = _mm_add_pd(acc[21], _mm_mul_pd(l[0], e));
+  acc[22] = _mm_add_pd(acc[22], _mm_mul_pd(l[1], e));
+  acc[23] = _mm_add_pd(acc[23], _mm_mul_pd(l[2], e));
+  acc[24] = _mm_add_pd(acc[24], _mm_mul_pd(l[3], e));
+  acc[25] = _mm_add_pd(acc[25], _mm_mul_pd(l[4], e));
+  acc[26] = _mm_add_pd(acc[26], _mm_mul_pd(l[5], e));
+}
+#endif
+
+// Luminance and gradient of n consecutive pixels of a row starting at p
+void buildRun(const unsigned char *p, int width, unsigned int n, double px, double py, double *I, double *Ix,
+              double *Iy)
+{
+  unsigned int k = 0;
+#if VISP_HAVE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128d px_ = _mm_set1_pd(px), py_ = _mm_set1_pd(py);
+  for (; k + 8 <= n; k += 8) {
+    const unsigned char *q = p + k;
+    __m128i lo, hi;
+    derivativeNumerator(q, 1, lo, hi);
+    storeDerivative(lo, px_, Ix + k);
+    storeDerivative(hi, px_, Ix + k + 4);
+    derivativeNumerator(q, width, lo, hi);
+    storeDerivative(lo, py_, Iy + k);
+    storeDerivative(hi, py_, Iy + k + 4);
+
+    __m128i c = load8(q);
+    __m128i c_lo = _mm_unpacklo_epi16(c, zero), c_hi = _mm_unpackhi_epi16(c, zero);
+    _mm_storeu_pd(I + k, _mm_cvtepi32_pd(c_lo));
+    _mm_storeu_pd(I + k + 2, _mm_cvtepi32_pd(_mm_srli_si128(c_lo, 8)));
+    _mm_storeu_pd(I + k + 4, _mm_cvtepi32_pd(c_hi));
+    _mm_storeu_pd(I + k + 6, _mm_cvtepi32_pd(_mm_srli_si128(c_hi, 8)));
+  }
+#endif
+  for (; k < n; k++) {
+    const unsigned char *q = p + k;
+    Ix[k] = px * (derivativeNumerator(q, 1) / 8418.0);
+    Iy[k] = py * (derivativeNumerator(q, width) / 8418.0);
+    I[k] = *q;
+  }
+}
+
+} // namespace
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Initialize the memory space requested for vpFeatureLuminance visual feature.
 */
@@ -82,23 +235,52 @@ void vpFeatureLuminance::init(unsigned int _nbr, unsigned int _nbc, double _Z)
     throw vpException(vpException::dimensionError, "border is too important compared to number of row or column.");
   }
 
-  // number of feature = nb column x nb lines in the images
-  dim_s = (nbr - 2 * bord) * (nbc - 2 * bord);
+  initPixels();
 
-  s.resize(dim_s);
+  Z = _Z;
+}
+
+/*!
+  Build the set of pixels of the feature from the image size, the border, the
+  region of interest and the sampling steps. The pixels previously selected by
+  selectPixels() are discarded.
+*/
+void vpFeatureLuminance::initPixels()
+{
+  unsigned int i_min = bord, i_max = nbr - bord, j_min = bord, j_max = nbc - bord;
+  if (useROI) {
+    i_min = (unsigned int)std::max((double)i_min, std::ceil(roi.getTop()));
+    i_max = (unsigned int)std::max((double)i_min, std::min((double)i_max, std::floor(roi.getBottom()) + 1));
+    j_min = (unsigned int)std::max((double)j_min, std::ceil(roi.getLeft()));
+    j_max = (unsigned int)std::max((double)j_min, std::min((double)j_max, std::floor(roi.getRight()) + 1));
+  }
 
-  if (pixInfo != NULL)
-    delete[] pixInfo;
+  pixRow.clear();
+  pixCol.clear();
+  for (unsigned int i = i_min; i < i_max; i += stepRow) {
+    for (unsigned int j = j_min; j < j_max; j += stepCol) {
+      pixRow.push_back(i);
+      pixCol.push_back(j);
+    }
+  }
 
-  pixInfo = new vpLuminance[dim_s];
+  // number of feature = number of pixels
+  dim_s = (unsigned int)pixRow.size();
+  s.resize(dim_s);
+  pixX.resize(dim_s);
+  pixY.resize(dim_s);
+  pixIx.resize(dim_s);
+  pixIy.resize(dim_s);
 
-  Z = _Z;
+  firstTimeIn = 0;
 }
 
 /*!
   Default constructor that build a visual feature.
 */
-vpFeatureLuminance::vpFeatureLuminance() : Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+vpFeatureLuminance::vpFeatureLuminance()
+  : Z(1), nbr(0), nbc(0), bord(10), pixRow(), pixCol(), pixX(), pixY(), pixIx(), pixIy(), firstTimeIn(0), roi(),
+    useROI(false), stepRow(1), stepCol(1), cam()
 {
   nbParameters = 1;
   dim_s = 0;
@@ -111,38 +293,41 @@ vpFeatureLuminance::vpFeatureLuminance() : Z(1), nbr(0), nbc(0), bord(10), pixIn
  Copy constructor.
  */
 vpFeatureLuminance::vpFeatureLuminance(const vpFeatureLuminance &f)
-  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixRow(), pixCol(), pixX(), pixY(), pixIx(), pixIy(),
+    firstTimeIn(0), roi(), useROI(false), stepRow(1), stepCol(1), cam()
 {
   *this = f;
 }
 
 /*!
- Copy operator.
+ Copy operator. The copy is made of the same pixels as \e f.
  */
 vpFeatureLuminance &vpFeatureLuminance::operator=(const vpFeatureLuminance &f)
 {
+  vpBasicFeature::operator=(f);
   Z = f.Z;
   nbr = f.nbr;
   nbc = f.nbc;
   bord = f.bord;
+  pixRow = f.pixRow;
+  pixCol = f.pixCol;
+  pixX = f.pixX;
+  pixY = f.pixY;
+  pixIx = f.pixIx;
+  pixIy = f.pixIy;
   firstTimeIn = f.firstTimeIn;
+  roi = f.roi;
+  useROI = f.useROI;
+  stepRow = f.stepRow;
+  stepCol = f.stepCol;
   cam = f.cam;
-  if (pixInfo)
-    delete[] pixInfo;
-  pixInfo = new vpLuminance[dim_s];
-  for (unsigned int i = 0; i < dim_s; i++)
-    pixInfo[i] = f.pixInfo[i];
   return (*this);
 }
 
 /*!
   Destructor that free allocated memory.
 */
-vpFeatureLuminance::~vpFeatureLuminance()
-{
-  if (pixInfo != NULL)
-    delete[] pixInfo;
-}
+vpFeatureLuminance::~vpFeatureLuminance() {}
 
 /*!
   Set the value of \f$ Z \f$ which represents the depth in the 3D camera
@@ -164,57 +349,136 @@ void vpFeatureLuminance::set_Z(const double Z_)
 */
 double vpFeatureLuminance::get_Z() const { return Z; }
 
-void vpFeatureLuminance::setCameraParameters(vpCameraParameters &_cam) { cam = _cam; }
+void vpFeatureLuminance::setCameraParameters(vpCameraParameters &_cam)
+{
+  cam = _cam;
+  firstTimeIn = 0;
+}
 
 /*!
+  Restrict the feature to the pixels inside a region of interest. The pixels
+  closer than 10 pixels to the image border are never used.
 
-  Build a luminance feature directly from the image
-*/
+  \param roi_ : Region of interest in the image.
 
-void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
+  \sa setSampling(), selectPixels()
+*/
+void vpFeatureLuminance::setROI(const vpRect &roi_)
 {
-  unsigned int l = 0;
-  double Ix, Iy;
+  roi = roi_;
+  useROI = true;
+  if (nbr != 0) {
+    initPixels();
+  }
+}
 
-  double px = cam.get_px();
-  double py = cam.get_py();
+/*!
+  Use only one pixel every \e step_i rows and every \e step_j columns of the
+  image (or of the region of interest set with setROI()).
 
-  if (firstTimeIn == 0) {
-    firstTimeIn = 1;
-    l = 0;
-    for (unsigned int i = bord; i < nbr - bord; i++) {
-      //   cout << i << endl ;
-      for (unsigned int j = bord; j < nbc - bord; j++) {
-        double x = 0, y = 0;
-        vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+  \param step_i, step_j : Sampling steps along the rows and the columns.
+
+  \sa setROI(), selectPixels()
+*/
+void vpFeatureLuminance::setSampling(unsigned int step_i, unsigned int step_j)
+{
+  if (step_i == 0 || step_j == 0) {
+    throw vpException(vpException::badValue, "The sampling steps (%d, %d) have to be positive", step_i, step_j);
+  }
+  stepRow = step_i;
+  stepCol = step_j;
+  if (nbr != 0) {
+    initPixels();
+  }
+}
 
-        pixInfo[l].x = x;
-        pixInfo[l].y = y;
+/*!
+  Keep only the pixels of the feature where the norm of the gradient of \e I
+  is at least \e gradientThreshold. The pixels with a low gradient do not
+  constrain the motion and only increase the task dimension. The selection is
+  usually made from the desired image, and the current feature is then
+  obtained by copying the desired one.
 
-        pixInfo[l].Z = Z;
+  The selection is discarded by init(), setROI() and setSampling().
 
-        l++;
-      }
+  \param I : Image, with the size given to init(), whose gradient is used.
+  \param gradientThreshold : Minimal norm of the gradient, in grey level per
+  pixel.
+*/
+void vpFeatureLuminance::selectPixels(const vpImage<unsigned char> &I, double gradientThreshold)
+{
+  if (I.getHeight() != nbr || I.getWidth() != nbc) {
+    throw vpException(vpException::dimensionError, "Cannot select the pixels from a (%dx%d) image instead of (%dx%d)",
+                      I.getHeight(), I.getWidth(), nbr, nbc);
+  }
+
+  const int width = (int)I.getWidth();
+  const double threshold = vpMath::sqr(8418.0 * gradientThreshold);
+  unsigned int n = 0;
+  for (unsigned int k = 0; k < dim_s; k++) {
+    const unsigned char *p = I[pixRow[k]] + pixCol[k];
+    double nx = derivativeNumerator(p, 1);
+    double ny = derivativeNumerator(p, width);
+    if (nx * nx + ny * ny >= threshold) {
+      pixRow[n] = pixRow[k];
+      pixCol[n] = pixCol[k];
+      n++;
     }
   }
 
-  l = 0;
-  for (unsigned int i = bord; i < nbr - bord; i++) {
-    //   cout << i << endl ;
-    for (unsigned int j = bord; j < nbc - bord; j++) {
-      // cout << dim_s <<" " <<l <<"  " <<i << "  " << j <<endl ;
-      Ix = px * vpImageFilter::derivativeFilterX(I, i, j);
-      Iy = py * vpImageFilter::derivativeFilterY(I, i, j);
+  pixRow.resize(n);
+  pixCol.resize(n);
+  dim_s = n;
+  s.resize(dim_s);
+  pixX.resize(dim_s);
+  pixY.resize(dim_s);
+  pixIx.resize(dim_s);
+  pixIy.resize(dim_s);
+
+  firstTimeIn = 0;
+}
+
+/*!
+
+  Build a luminance feature directly from the image.
+
+  The luminance and the gradient of the pixels of a same row are computed
+  several pixels at a time. The gradient is the one given by
+  vpImageFilter::derivativeFilterX() and vpImageFilter::derivativeFilterY().
 
-      // Calcul de Z
+  \param I : Image of the size given to init().
+
+  \exception vpException::dimensionError : If the size of \e I is not the one
+  given to init().
+*/
 
-      pixInfo[l].I = I[i][j];
-      s[l] = I[i][j];
-      pixInfo[l].Ix = Ix;
-      pixInfo[l].Iy = Iy;
+void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
+{
+  if (I.getHeight() != nbr || I.getWidth() != nbc) {
+    throw vpException(vpException::dimensionError, "Cannot build the feature from a (%dx%d) image instead of (%dx%d)",
+                      I.getHeight(), I.getWidth(), nbr, nbc);
+  }
 
-      l++;
+  double px = cam.get_px();
+  double py = cam.get_py();
+
+  if (firstTimeIn == 0) {
+    firstTimeIn = 1;
+    for (unsigned int k = 0; k < dim_s; k++) {
+      vpPixelMeterConversion::convertPoint(cam, pixCol[k], pixRow[k], pixX[k], pixY[k]);
+    }
+  }
+
+  const int width = (int)I.getWidth();
+  unsigned int k = 0;
+  while (k < dim_s) {
+    // run of consecutive pixels of a same row
+    unsigned int n = 1;
+    while (k + n < dim_s && pixRow[k + n] == pixRow[k] && pixCol[k + n] == pixCol[k] + n) {
+      n++;
     }
+    buildRun(I[pixRow[k]] + pixCol[k], width, n, px, py, s.data + k, &pixIx[k], &pixIy[k]);
+    k += n;
   }
 }
 
@@ -225,25 +489,25 @@ void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 */
 void vpFeatureLuminance::interaction(vpMatrix &L)
 {
-  L.resize(dim_s, 6);
-
-  for (unsigned int m = 0; m < L.getRows(); m++) {
-    double Ix = pixInfo[m].Ix;
-    double Iy = pixInfo[m].Iy;
-
-    double x = pixInfo[m].x;
-    double y = pixInfo[m].y;
-    double Zinv = 1 / pixInfo[m].Z;
-
-    {
-      L[m][0] = Ix * Zinv;
-      L[m][1] = Iy * Zinv;
-      L[m][2] = -(x * Ix + y * Iy) * Zinv;
-      L[m][3] = -Ix * x * y - (1 + y * y) * Iy;
-      L[m][4] = (1 + x * x) * Ix + Iy * x * y;
-      L[m][5] = Iy * x - Ix * y;
+  L.resize(dim_s, 6, false, false);
+
+  const double Zinv = 1 / Z;
+  unsigned int m = 0;
+#if VISP_HAVE_SSE2
+  const __m128d Zinv_ = _mm_set1_pd(Zinv);
+  for (; m + 2 <= dim_s; m += 2) {
+    __m128d l[6];
+    interactionRows(&pixIx[m], &pixIy[m], &pixX[m], &pixY[m], Zinv_, l);
+    double *L_m = L[m], *L_m1 = L[m + 1];
+    for (unsigned int c = 0; c < 6; c += 2) {
+      _mm_storeu_pd(L_m + c, _mm_unpacklo_pd(l[c], l[c + 1]));
+      _mm_storeu_pd(L_m1 + c, _mm_unpackhi_pd(l[c], l[c + 1]));
     }
   }
+#endif
+  for (; m < dim_s; m++) {
+    interactionRow(pixIx[m], pixIy[m], pixX[m], pixY[m], Zinv, L[m]);
+  }
 }
 
 /*!
@@ -258,6 +522,77 @@ vpMatrix vpFeatureLuminance::interaction(const unsigned int /* select */)
   return L;
 }
 
+/*!
+  Compute the normal equations \f${\bf L}^\top {\bf L}\f$ and
+  \f${\bf L}^\top {\bf e}\f$ of the interaction matrix \f$ L_I \f$, as used by
+  a Gauss-Newton or a Levenberg-Marquardt control law.
+
+  The interaction matrix is not built: its rows are computed by blocks of a
+  few pixels from the gradient and accumulated in the 6-by-6 matrix
+  \f${\bf L}^\top {\bf L}\f$ and the 6-dimension vector
+  \f${\bf L}^\top {\bf e}\f$.
+
+  \param e : Vector with one element per pixel of the feature, usually the
+  error given by error().
+  \param LtL : The 6-by-6 matrix \f${\bf L}^\top {\bf L}\f$.
+  \param Lte : The 6-dimension vector \f${\bf L}^\top {\bf e}\f$.
+*/
+void vpFeatureLuminance::interactionNormalEquations(const vpColVector &e, vpMatrix &LtL, vpColVector &Lte)
+{
+  if (e.getRows() != dim_s) {
+    throw vpException(vpException::dimensionError, "Cannot compute L^T e with a %d-dimension vector instead of %d",
+                      e.getRows(), dim_s);
+  }
+
+  LtL.resize(6, 6);
+  Lte.resize(6);
+
+  const double Zinv = 1 / Z;
+  unsigned int m = 0;
+#if VISP_HAVE_SSE2
+  // Upper triangle of L^T L followed by L^T e, accumulated for the even and
+  // the odd pixels in the two halves of the registers
+  __m128d acc[27];
+  for (unsigned int i = 0; i < 27; i++) {
+    acc[i] = _mm_setzero_pd();
+  }
+  const __m128d Zinv_ = _mm_set1_pd(Zinv);
+  for (; m + 2 <= dim_s; m += 2) {
+    __m128d l[6];
+    interactionRows(&pixIx[m], &pixIy[m], &pixX[m], &pixY[m], Zinv_, l);
+    accumulateNormalEquations(l, _mm_loadu_pd(e.data + m), acc);
+  }
+  double tmp[2];
+  unsigned int idx = 0;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = i; j < 6; j++) {
+      _mm_storeu_pd(tmp, acc[idx++]);
+      LtL[i][j] = tmp[0] + tmp[1];
+    }
+  }
+  for (unsigned int i = 0; i < 6; i++) {
+    _mm_storeu_pd(tmp, acc[idx++]);
+    Lte[i] = tmp[0] + tmp[1];
+  }
+#endif
+  for (; m < dim_s; m++) {
+    double l[6];
+    interactionRow(pixIx[m], pixIy[m], pixX[m], pixY[m], Zinv, l);
+    for (unsigned int i = 0; i < 6; i++) {
+      for (unsigned int j = i; j < 6; j++) {
+        LtL[i][j] += l[i] * l[j];
+      }
+      Lte[i] += l[i] * e[m];
+    }
+  }
+
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < i; j++) {
+      LtL[i][j] = LtL[j][i];
+    }
+  }
+}
+
 /*!
   Compute the error \f$ (I-I^*)\f$ between the current and the desired
 
@@ -0,0 +1,306 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the luminance feature.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceFeatureLuminance.cpp
+
+  \brief Check that vpFeatureLuminance gives the same luminance and
+  interaction matrix as a per-pixel implementation, also with a region of
+  interest, a sampling and a gradient based selection of the pixels, check
+  the normal equations computed without the interaction matrix, and measure
+  the time needed to build the feature of a 320x240 image.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Luminance, gradient and coordinates of a pixel, as stored before the
+// feature was split in one array per quantity
+struct Luminance {
+  double x, y;
+  double I;
+  double Ix, Iy;
+  double Z;
+};
+
+// Feature of all the pixels of I except a border, built one pixel at a time
+void buildReference(const vpImage<unsigned char> &I, const vpCameraParameters &cam, double Z, unsigned int bord,
+                    std::vector<Luminance> &pixInfo)
+{
+  pixInfo.clear();
+  for (unsigned int i = bord; i < I.getHeight() - bord; i++) {
+    for (unsigned int j = bord; j < I.getWidth() - bord; j++) {
+      Luminance l;
+      vpPixelMeterConversion::convertPoint(cam, j, i, l.x, l.y);
+      l.Z = Z;
+      l.I = I[i][j];
+      l.Ix = cam.get_px() * vpImageFilter::derivativeFilterX(I, i, j);
+      l.Iy = cam.get_py() * vpImageFilter::derivativeFilterY(I, i, j);
+      pixInfo.push_back(l);
+    }
+  }
+}
+
+void interactionReference(const std::vector<Luminance> &pixInfo, vpMatrix &L)
+{
+  L.resize((unsigned int)pixInfo.size(), 6);
+  for (unsigned int m = 0; m < L.getRows(); m++) {
+    double Ix = pixInfo[m].Ix;
+    double Iy = pixInfo[m].Iy;
+    double x = pixInfo[m].x;
+    double y = pixInfo[m].y;
+    double Zinv = 1 / pixInfo[m].Z;
+
+    L[m][0] = Ix * Zinv;
+    L[m][1] = Iy * Zinv;
+    L[m][2] = -(x * Ix + y * Iy) * Zinv;
+    L[m][3] = -Ix * x * y - (1 + y * y) * Iy;
+    L[m][4] = (1 + x * x) * Ix + Iy * x * y;
+    L[m][5] = Iy * x - Ix * y;
+  }
+}
+
+// Smooth textured image translated by (tu, tv)
+void generateImage(vpImage<unsigned char> &I, double tu, double tv)
+{
+  I.resize(240, 320);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double u = j - tu, v = i - tv;
+      double val = 127.5 + 60. * sin(u / 7.) * cos(v / 11.) + 60. * cos((u + v) / 17.) + 30. * sin(u * v / 900.);
+      I[i][j] = (unsigned char)vpMath::round(val);
+    }
+  }
+}
+
+// Compare the row k of the feature with the pixel (i, j) of the reference
+bool compareRow(const vpColVector &s, const vpMatrix &L, unsigned int k, const std::vector<Luminance> &pixInfo,
+                const vpMatrix &L_ref, unsigned int m, const std::string &name)
+{
+  if (s[k] != pixInfo[m].I) {
+    std::cerr << name << ": luminance " << s[k] << " of feature " << k << " instead of " << pixInfo[m].I << std::endl;
+    return false;
+  }
+  for (unsigned int c = 0; c < 6; c++) {
+    if (std::fabs(L[k][c] - L_ref[m][c]) > 1e-12 * std::max(std::fabs(L_ref[m][c]), 1.)) {
+      std::cerr << name << ": L[" << k << "][" << c << "] = " << L[k][c] << " instead of " << L_ref[m][c]
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool compare(const vpMatrix &M, const vpMatrix &M_ref, const std::string &name)
+{
+  for (unsigned int i = 0; i < M.getRows(); i++) {
+    for (unsigned int j = 0; j < M.getCols(); j++) {
+      if (std::fabs(M[i][j] - M_ref[i][j]) > 1e-9 * std::max(std::fabs(M_ref[i][j]), 1.)) {
+        std::cerr << name << ": element (" << i << ", " << j << ") is " << M[i][j] << " instead of " << M_ref[i][j]
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+#if defined(__mips__) || defined(__mips) || defined(mips) || defined(__MIPS__)
+  // To avoid Debian test timeout
+  return EXIT_SUCCESS;
+#endif
+
+  try {
+    vpCameraParameters cam(870, 870, 160, 120);
+    const double Z = 0.8;
+    const unsigned int bord = 10;
+    vpImage<unsigned char> I, Id;
+    generateImage(I, 3, -2);
+    generateImage(Id, 0, 0);
+    const unsigned int width = I.getWidth() - 2 * bord;
+
+    // All the pixels
+    std::vector<Luminance> pixInfo;
+    vpMatrix L_ref;
+    unsigned int nbIter = 100;
+    double t_ref = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++) {
+      buildReference(I, cam, Z, bord, pixInfo);
+      interactionReference(pixInfo, L_ref);
+    }
+    t_ref = vpTime::measureTimeMs() - t_ref;
+
+    vpFeatureLuminance s;
+    s.init(I.getHeight(), I.getWidth(), Z);
+    s.setCameraParameters(cam);
+    vpMatrix L;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++) {
+      s.buildFrom(I);
+      s.interaction(L);
+    }
+    t = vpTime::measureTimeMs() - t;
+
+    std::cout << s.getDimension() << " pixels, buildFrom() + interaction(): " << t / nbIter
+              << " ms, per-pixel implementation: " << t_ref / nbIter << " ms" << std::endl;
+
+    if (s.getDimension() != pixInfo.size() || L.getRows() != pixInfo.size()) {
+      std::cerr << "Dimension " << s.getDimension() << " instead of " << pixInfo.size() << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int k = 0; k < s.getDimension(); k++) {
+      if (!compareRow(s.get_s(), L, k, pixInfo, L_ref, k, "All the pixels")) {
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Normal equations
+    vpFeatureLuminance sd(s);
+    sd.buildFrom(Id);
+    vpColVector e;
+    s.error(sd, e);
+    vpMatrix LtL, LtL_ref;
+    vpColVector Lte, Lte_ref;
+    double t_ne = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++) {
+      s.interactionNormalEquations(e, LtL, Lte);
+    }
+    t_ne = vpTime::measureTimeMs() - t_ne;
+    double t_ne_ref = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIter; i++) {
+      s.interaction(L);
+      LtL_ref = L.AtA();
+      Lte_ref = L.t() * e;
+    }
+    t_ne_ref = vpTime::measureTimeMs() - t_ne_ref;
+
+    std::cout << "L^T L and L^T e: interactionNormalEquations() " << t_ne / nbIter
+              << " ms, from the interaction matrix " << t_ne_ref / nbIter << " ms" << std::endl;
+
+    if (!compare(LtL, LtL_ref, "L^T L") || !compare(vpMatrix(Lte), vpMatrix(Lte_ref), "L^T e")) {
+      return EXIT_FAILURE;
+    }
+
+    // Region of interest and sampling
+    vpFeatureLuminance s_roi;
+    s_roi.init(I.getHeight(), I.getWidth(), Z);
+    s_roi.setCameraParameters(cam);
+    s_roi.setROI(vpRect(5, 40.5, 200, 100));
+    s_roi.setSampling(2, 3);
+    s_roi.buildFrom(I);
+    s_roi.interaction(L);
+    unsigned int k = 0;
+    for (unsigned int i = 41; i <= 139; i += 2) {
+      for (unsigned int j = bord; j <= 204; j += 3) {
+        if (k >= s_roi.getDimension() ||
+            !compareRow(s_roi.get_s(), L, k, pixInfo, L_ref, (i - bord) * width + (j - bord), "ROI")) {
+          std::cerr << "ROI: feature " << k << " is not the pixel (" << i << ", " << j << ")" << std::endl;
+          return EXIT_FAILURE;
+        }
+        k++;
+      }
+    }
+    if (k != s_roi.getDimension()) {
+      std::cerr << "ROI: dimension " << s_roi.getDimension() << " instead of " << k << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Gradient based selection of the pixels from the desired image, shared
+    // by the current feature
+    const double threshold = 15.;
+    vpFeatureLuminance sd_sel;
+    sd_sel.init(Id.getHeight(), Id.getWidth(), Z);
+    sd_sel.setCameraParameters(cam);
+    sd_sel.selectPixels(Id, threshold);
+    sd_sel.buildFrom(Id);
+    vpFeatureLuminance s_sel(sd_sel);
+    s_sel.buildFrom(I);
+    s_sel.interaction(L);
+
+    std::vector<Luminance> pixInfo_d;
+    buildReference(Id, cam, Z, bord, pixInfo_d);
+    k = 0;
+    for (unsigned int m = 0; m < pixInfo_d.size(); m++) {
+      double Ix = pixInfo_d[m].Ix / cam.get_px(), Iy = pixInfo_d[m].Iy / cam.get_py();
+      if (Ix * Ix + Iy * Iy >= threshold * threshold) {
+        if (k >= s_sel.getDimension() || !compareRow(s_sel.get_s(), L, k, pixInfo, L_ref, m, "Selection")) {
+          std::cerr << "Selection: feature " << k << " is not the pixel " << m << std::endl;
+          return EXIT_FAILURE;
+        }
+        k++;
+      }
+    }
+    if (k != s_sel.getDimension() || s_sel.error(sd_sel).size() != k) {
+      std::cerr << "Selection: dimension " << s_sel.getDimension() << " instead of " << k << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::cout << "Selection: " << k << " pixels out of " << pixInfo_d.size() << std::endl;
+
+    // The image has to be of the size given to init()
+    vpImage<unsigned char> I_small(I.getHeight() / 2, I.getWidth() / 2);
+    try {
+      s_sel.buildFrom(I_small);
+      std::cerr << "buildFrom() accepts a (" << I_small.getHeight() << "x" << I_small.getWidth()
+                << ") image instead of (" << I.getHeight() << "x" << I.getWidth() << ")" << std::endl;
+      return EXIT_FAILURE;
+    } catch (vpException &e) {
+      if (e.getCode() != vpException::dimensionError) {
+        throw;
+      }
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testPerformanceFeatureLuminance is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
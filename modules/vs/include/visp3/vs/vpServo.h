@@ -539,6 +539,14 @@ protected:
    */
   void computeProjectionOperators();
 
+  //! Compute the task Jacobian J1, its pseudo inverse J1p and the primary
+  //! task e1 shared by all the control laws.
+  void computePrimaryTask();
+
+  //! Compute the pseudo inverse of J1, its rank and the orthonormal basis of
+  //! the image of its transpose.
+  unsigned int computeTaskPseudoInverse(vpMatrix &J1p_);
+
 public:
   //! Interaction matrix
   vpMatrix L;
@@ -674,6 +682,36 @@ protected:
   //! A diag matrix used to determine which are the degrees of freedom that
   //! are controlled in the camera frame
   vpMatrix cJc;
+
+  //! Number of calls to the control laws, used to store the initial primary
+  //! task of the control laws with a continuous sequencing
+  unsigned int iteration;
+
+private:
+  //! Desired interaction matrix (workspace of the MEAN interaction matrix)
+  vpMatrix Lstar;
+  //! Workspace: twist transformation matrix from the Jacobian frame to the
+  //! camera frame
+  vpVelocityTwistMatrix cVa;
+  //! Workspace: robot Jacobian expressed in the camera frame
+  vpMatrix cVa_aJe;
+  //! Workspace: orthonormal basis of the image of J1
+  vpMatrix imJ1;
+  //! Workspace: orthonormal basis of the image of J1 transpose
+  vpMatrix imJ1t;
+  //! Workspace: normal equations matrix J1^T J1 of the task Jacobian
+  vpMatrix J1tJ1;
+  //! Workspace: eigenvectors of J1^T J1
+  vpMatrix J1tJ1_V;
+  //! Workspace: eigenvalues of J1^T J1
+  vpColVector J1tJ1_eigenvalues;
+  //! Workspace: unused pseudo inverse when only the image of J1 transpose is
+  //! needed
+  vpMatrix J1p_tmp;
+  //! Workspace: J1p e
+  vpColVector J1p_e;
+  //! Workspace: J1^T e
+  vpColVector J1t_e;
 };
 
 #endif
@@ -40,6 +40,8 @@
 
 #include <visp3/vs/vpServo.h>
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 // Exception
@@ -48,6 +50,101 @@
 // Debug trace
 #include <visp3/core/vpDebug.h>
 
+// Number of rows of the task Jacobian from which its pseudo inverse is
+// computed from the normal equations, see vpServo::computeTaskPseudoInverse()
+static const unsigned int normal_equations_min_rows = 32;
+
+// Product C = A B of 6-by-6 matrices, where C can be A or B
+static void mult6x6(const vpArray2D<double> &A, const vpArray2D<double> &B, vpArray2D<double> &C)
+{
+  double AB[6][6];
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < 6; j++) {
+      double sum = 0;
+      for (unsigned int k = 0; k < 6; k++) {
+        sum += A[i][k] * B[k][j];
+      }
+      AB[i][j] = sum;
+    }
+  }
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < 6; j++) {
+      C[i][j] = AB[i][j];
+    }
+  }
+}
+
+// Eigen-decomposition of the symmetric matrix A with the cyclic Jacobi
+// method. A is overwritten. The eigenvalues are stored in w in decreasing
+// order, and the corresponding eigenvectors in the columns of V. Nothing is
+// allocated when w and V already have the size of A.
+static void symmetricEigenDecomposition(vpMatrix &A, vpColVector &w, vpMatrix &V)
+{
+  const unsigned int n = A.getRows();
+  w.resize(n, false);
+  V.eye(n);
+
+  for (unsigned int sweep = 0; sweep < 50; sweep++) {
+    double off = 0, diag = 0;
+    for (unsigned int p = 0; p < n; p++) {
+      diag += A[p][p] * A[p][p];
+      for (unsigned int q = p + 1; q < n; q++) {
+        off += A[p][q] * A[p][q];
+      }
+    }
+    if (off <= std::numeric_limits<double>::epsilon() * std::numeric_limits<double>::epsilon() * diag) {
+      break;
+    }
+
+    for (unsigned int p = 0; p < n; p++) {
+      for (unsigned int q = p + 1; q < n; q++) {
+        if (A[p][q] == 0) {
+          continue;
+        }
+        // Rotation that cancels A[p][q]
+        const double theta = (A[q][q] - A[p][p]) / (2 * A[p][q]);
+        const double t = (theta >= 0 ? 1.0 : -1.0) / (std::fabs(theta) + sqrt(theta * theta + 1));
+        const double c = 1 / sqrt(t * t + 1);
+        const double sn = t * c;
+        for (unsigned int k = 0; k < n; k++) {
+          const double a_kp = A[k][p], a_kq = A[k][q];
+          A[k][p] = c * a_kp - sn * a_kq;
+          A[k][q] = sn * a_kp + c * a_kq;
+        }
+        for (unsigned int k = 0; k < n; k++) {
+          const double a_pk = A[p][k], a_qk = A[q][k];
+          A[p][k] = c * a_pk - sn * a_qk;
+          A[q][k] = sn * a_pk + c * a_qk;
+        }
+        for (unsigned int k = 0; k < n; k++) {
+          const double v_kp = V[k][p], v_kq = V[k][q];
+          V[k][p] = c * v_kp - sn * v_kq;
+          V[k][q] = sn * v_kp + c * v_kq;
+        }
+      }
+    }
+  }
+
+  for (unsigned int k = 0; k < n; k++) {
+    w[k] = A[k][k];
+  }
+  // Sort the eigenvalues in decreasing order
+  for (unsigned int k = 0; k < n; k++) {
+    unsigned int kmax = k;
+    for (unsigned int l = k + 1; l < n; l++) {
+      if (w[l] > w[kmax]) {
+        kmax = l;
+      }
+    }
+    if (kmax != k) {
+      std::swap(w[k], w[kmax]);
+      for (unsigned int i = 0; i < n; i++) {
+        std::swap(V[i][k], V[i][kmax]);
+      }
+    }
+  }
+}
+
 /*!
   \file vpServo.cpp
   \brief  Class required to compute the visual servoing control law
@@ -72,7 +169,8 @@ vpServo::vpServo()
     interactionMatrixType(DESIRED), inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false),
     fVe(), init_fVe(false), eJe(), init_eJe(false), fJe(), init_fJe(false), errorComputed(false),
     interactionMatrixComputed(false), dim_task(0), taskWasKilled(false), forceInteractionMatrixComputation(false),
-    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6)
+    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6), iteration(0), Lstar(), cVa(), cVa_aJe(),
+    imJ1(), imJ1t(), J1tJ1(), J1tJ1_V(), J1tJ1_eigenvalues(), J1p_tmp(), J1p_e(), J1t_e()
 {
   cJc.eye();
 }
@@ -97,7 +195,8 @@ vpServo::vpServo(vpServoType servo_type)
     inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false), fVe(), init_fVe(false), eJe(),
     init_eJe(false), fJe(), init_fJe(false), errorComputed(false), interactionMatrixComputed(false), dim_task(0),
     taskWasKilled(false), forceInteractionMatrixComputation(false), WpW(), I_WpW(), P(), sv(), mu(4), e1_initial(),
-    iscJcIdentity(true), cJc(6, 6)
+    iscJcIdentity(true), cJc(6, 6), iteration(0), Lstar(), cVa(), cVa_aJe(), imJ1(), imJ1t(), J1tJ1(), J1tJ1_V(),
+    J1tJ1_eigenvalues(), J1p_tmp(), J1p_e(), J1t_e()
 {
   cJc.eye();
 }
@@ -171,6 +270,8 @@ void vpServo::init()
   forceInteractionMatrixComputation = false;
 
   rankJ1 = 0;
+
+  iteration = 0;
 }
 
 /*!
@@ -244,6 +345,8 @@ void vpServo::setServo(const vpServoType &servo_type)
 /*!
   Set a 6-dim column vector representing the degrees of freedom that are
 controlled in the camera frame. When set to 1, all the 6 dof are controlled.
+They are taken into account by all the computeControlLaw() variants,
+including the ones with a continuous sequencing.
 
   \param dof : Degrees of freedom to control in the camera frame.
   Below we give the correspondance between the index of the vector and the
@@ -681,14 +784,14 @@ vpMatrix vpServo::computeInteractionMatrix()
       }
     } break;
     case MEAN: {
-      vpMatrix Lstar(L.getRows(), L.getCols());
       try {
         computeInteractionMatrixFromList(this->featureList, this->featureSelectionList, L);
         computeInteractionMatrixFromList(this->desiredFeatureList, this->featureSelectionList, Lstar);
       } catch (...) {
         throw;
       }
-      L = (L + Lstar) / 2;
+      vpMatrix::add2Matrices(L, Lstar, L);
+      L /= 2;
 
       dim_task = L.getRows();
       interactionMatrixComputed = true;
@@ -934,118 +1037,16 @@ bool vpServo::testUpdated()
 */
 vpColVector vpServo::computeControlLaw()
 {
-  static int iteration = 0;
-
-  try {
-    vpVelocityTwistMatrix cVa; // Twist transformation matrix
-    vpMatrix aJe;              // Jacobian
-
-    if (iteration == 0) {
-      if (testInitialization() == false) {
-        vpERROR_TRACE("All the matrices are not correctly initialized");
-        throw(vpServoException(vpServoException::servoError, "Cannot compute control law "
-                                                             "All the matrices are not correctly"
-                                                             "initialized"));
-      }
-    }
-    if (testUpdated() == false) {
-      vpERROR_TRACE("All the matrices are not correctly updated");
-    }
-
-    // test if all the required initialization have been done
-    switch (servoType) {
-    case NONE:
-      vpERROR_TRACE("No control law have been yet defined");
-      throw(vpServoException(vpServoException::servoError, "No control law have been yet defined"));
-      break;
-    case EYEINHAND_CAMERA:
-    case EYEINHAND_L_cVe_eJe:
-    case EYETOHAND_L_cVe_eJe:
-
-      cVa = cVe;
-      aJe = eJe;
-
-      init_cVe = false;
-      init_eJe = false;
-      break;
-    case EYETOHAND_L_cVf_fVe_eJe:
-      cVa = cVf * fVe;
-      aJe = eJe;
-      init_fVe = false;
-      init_eJe = false;
-      break;
-    case EYETOHAND_L_cVf_fJe:
-      cVa = cVf;
-      aJe = fJe;
-      init_fJe = false;
-      break;
-    }
+  computePrimaryTask();
 
-    computeInteractionMatrix();
-    computeError();
-
-    // compute  task Jacobian
-    if (iscJcIdentity)
-      J1 = L * cVa * aJe;
-    else
-      J1 = L * cJc * cVa * aJe;
-
-    // handle the eye-in-hand eye-to-hand case
-    J1 *= signInteractionMatrix;
-
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1: " << rankJ1 << std::endl;
-      imJ1t.print(std::cout, 10, "imJ1t");
-      imJ1.print(std::cout, 10, "imJ1");
-
-      WpW.print(std::cout, 10, "WpW");
-      J1.print(std::cout, 10, "J1");
-      J1p.print(std::cout, 10, "J1p");
-#endif
-      e1 = WpW * J1p * error;
-    }
-    e = -lambda(e1) * e1;
-
-    vpMatrix I;
-
-    I.eye(J1.getCols(), J1.getCols());
-
-    computeProjectionOperators();
-
-  } catch (...) {
-    throw;
+  const double gain = lambda(e1);
+  e.resize(e1.getRows(), false);
+  for (unsigned int i = 0; i < e1.getRows(); i++) {
+    e[i] = -gain * e1[i];
   }
 
+  computeProjectionOperators();
+
   iteration++;
   return e;
 }
@@ -1086,125 +1087,26 @@ vpColVector vpServo::computeControlLaw()
 */
 vpColVector vpServo::computeControlLaw(double t)
 {
-  static int iteration = 0;
-  // static vpColVector e1_initial;
+  computePrimaryTask();
 
-  try {
-    vpVelocityTwistMatrix cVa; // Twist transformation matrix
-    vpMatrix aJe;              // Jacobian
-
-    if (iteration == 0) {
-      if (testInitialization() == false) {
-        vpERROR_TRACE("All the matrices are not correctly initialized");
-        throw(vpServoException(vpServoException::servoError, "Cannot compute control law "
-                                                             "All the matrices are not correctly"
-                                                             "initialized"));
-      }
-    }
-    if (testUpdated() == false) {
-      vpERROR_TRACE("All the matrices are not correctly updated");
-    }
-
-    // test if all the required initialization have been done
-    switch (servoType) {
-    case NONE:
-      vpERROR_TRACE("No control law have been yet defined");
-      throw(vpServoException(vpServoException::servoError, "No control law have been yet defined"));
-      break;
-    case EYEINHAND_CAMERA:
-    case EYEINHAND_L_cVe_eJe:
-    case EYETOHAND_L_cVe_eJe:
-
-      cVa = cVe;
-      aJe = eJe;
-
-      init_cVe = false;
-      init_eJe = false;
-      break;
-    case EYETOHAND_L_cVf_fVe_eJe:
-      cVa = cVf * fVe;
-      aJe = eJe;
-      init_fVe = false;
-      init_eJe = false;
-      break;
-    case EYETOHAND_L_cVf_fJe:
-      cVa = cVf;
-      aJe = fJe;
-      init_fJe = false;
-      break;
-    }
-
-    computeInteractionMatrix();
-    computeError();
-
-    // compute  task Jacobian
-    J1 = L * cVa * aJe;
-
-    // handle the eye-in-hand eye-to-hand case
-    J1 *= signInteractionMatrix;
-
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
-
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
-
-      imageComputed = true;
-    } else
-      J1p = J1.t();
-
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
-
-#ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
-
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
-#endif
-      e1 = WpW * J1p * error;
-    }
-
-    // memorize the initial e1 value if the function is called the first time
-    // or if the time given as parameter is equal to 0.
-    if (iteration == 0 || std::fabs(t) < std::numeric_limits<double>::epsilon()) {
-      e1_initial = e1;
-    }
-    // Security check. If size of e1_initial and e1 differ, that means that
-    // e1_initial was not set
-    if (e1_initial.getRows() != e1.getRows())
-      e1_initial = e1;
-
-    e = -lambda(e1) * e1 + lambda(e1) * e1_initial * exp(-mu * t);
-
-    vpMatrix I;
-
-    I.eye(J1.getCols(), J1.getCols());
-
-    computeProjectionOperators();
-  } catch (...) {
-    throw;
+  // memorize the initial e1 value if the function is called the first time
+  // or if the time given as parameter is equal to 0.
+  if (iteration == 0 || std::fabs(t) < std::numeric_limits<double>::epsilon()) {
+    e1_initial = e1;
   }
+  // Security check. If size of e1_initial and e1 differ, that means that
+  // e1_initial was not set
+  if (e1_initial.getRows() != e1.getRows())
+    e1_initial = e1;
+
+  const double gain = lambda(e1);
+  const double decay = exp(-mu * t);
+  e.resize(e1.getRows(), false);
+  for (unsigned int i = 0; i < e1.getRows(); i++) {
+    e[i] = -gain * e1[i] + gain * e1_initial[i] * decay;
+  }
+
+  computeProjectionOperators();
 
   iteration++;
   return e;
@@ -1247,140 +1149,270 @@ vpColVector vpServo::computeControlLaw(double t)
 */
 vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
 {
-  static int iteration = 0;
+  computePrimaryTask();
 
-  try {
-    vpVelocityTwistMatrix cVa; // Twist transformation matrix
-    vpMatrix aJe;              // Jacobian
-
-    if (iteration == 0) {
-      if (testInitialization() == false) {
-        vpERROR_TRACE("All the matrices are not correctly initialized");
-        throw(vpServoException(vpServoException::servoError, "Cannot compute control law "
-                                                             "All the matrices are not correctly"
-                                                             "initialized"));
-      }
-    }
-    if (testUpdated() == false) {
-      vpERROR_TRACE("All the matrices are not correctly updated");
-    }
+  // memorize the initial e1 value if the function is called the first time
+  // or if the time given as parameter is equal to 0.
+  if (iteration == 0 || std::fabs(t) < std::numeric_limits<double>::epsilon()) {
+    e1_initial = e1;
+  }
+  // Security check. If size of e1_initial and e1 differ, that means that
+  // e1_initial was not set
+  if (e1_initial.getRows() != e1.getRows())
+    e1_initial = e1;
+
+  const double gain = lambda(e1);
+  const double decay = exp(-mu * t);
+  e.resize(e1.getRows(), false);
+  for (unsigned int i = 0; i < e1.getRows(); i++) {
+    e[i] = -gain * e1[i] + (e_dot_init[i] + gain * e1_initial[i]) * decay;
+  }
 
-    // test if all the required initialization have been done
-    switch (servoType) {
-    case NONE:
-      vpERROR_TRACE("No control law have been yet defined");
-      throw(vpServoException(vpServoException::servoError, "No control law have been yet defined"));
-      break;
-    case EYEINHAND_CAMERA:
-    case EYEINHAND_L_cVe_eJe:
-    case EYETOHAND_L_cVe_eJe:
+  computeProjectionOperators();
 
-      cVa = cVe;
-      aJe = eJe;
+  iteration++;
+  return e;
+}
 
-      init_cVe = false;
-      init_eJe = false;
-      break;
-    case EYETOHAND_L_cVf_fVe_eJe:
-      cVa = cVf * fVe;
-      aJe = eJe;
-      init_fVe = false;
-      init_eJe = false;
-      break;
-    case EYETOHAND_L_cVf_fJe:
-      cVa = cVf;
-      aJe = fJe;
-      init_fJe = false;
-      break;
+/*!
+  Compute the part of the control law shared by all the computeControlLaw()
+  variants: the interaction matrix, the error, the task Jacobian \f${\bf J}_1\f$,
+  its pseudo inverse (or its transpose) and rank, the projection operator
+  \f${\bf W}^+{\bf W}\f$ and the primary task \f${\bf e}_1\f$.
+
+  The intermediate matrices are members of the class that keep their size
+  from one iteration to the next: as long as the task dimension does not
+  change, they are not reallocated. Memory is still allocated by the
+  computation of the interaction matrices and of the errors of the features,
+  and by the singular value decomposition of vpMatrix::pseudoInverse() when
+  the pseudo inverse is not computed from the normal equations (see
+  computeTaskPseudoInverse()).
+
+  Only the degrees of freedom of the camera selected with setCameraDoF() are
+  controlled, whatever the control law.
+*/
+void vpServo::computePrimaryTask()
+{
+  if (iteration == 0) {
+    if (testInitialization() == false) {
+      vpERROR_TRACE("All the matrices are not correctly initialized");
+      throw(vpServoException(vpServoException::servoError, "Cannot compute control law "
+                                                           "All the matrices are not correctly"
+                                                           "initialized"));
     }
+  }
+  if (testUpdated() == false) {
+    vpERROR_TRACE("All the matrices are not correctly updated");
+  }
+
+  // test if all the required initialization have been done
+  const vpMatrix *aJe = NULL; // Jacobian
+  switch (servoType) {
+  case NONE:
+    vpERROR_TRACE("No control law have been yet defined");
+    throw(vpServoException(vpServoException::servoError, "No control law have been yet defined"));
+    break;
+  case EYEINHAND_CAMERA:
+  case EYEINHAND_L_cVe_eJe:
+  case EYETOHAND_L_cVe_eJe:
+    cVa = cVe;
+    aJe = &eJe;
 
-    computeInteractionMatrix();
-    computeError();
+    init_cVe = false;
+    init_eJe = false;
+    break;
+  case EYETOHAND_L_cVf_fVe_eJe:
+    mult6x6(cVf, fVe, cVa);
+    aJe = &eJe;
+    init_fVe = false;
+    init_eJe = false;
+    break;
+  case EYETOHAND_L_cVf_fJe:
+    cVa = cVf;
+    aJe = &fJe;
+    init_fJe = false;
+    break;
+  }
 
-    // compute  task Jacobian
-    J1 = L * cVa * aJe;
+  computeInteractionMatrix();
+  computeError();
 
-    // handle the eye-in-hand eye-to-hand case
-    J1 *= signInteractionMatrix;
+  // compute the task Jacobian J1 = L cJc cVa aJe, where the product of the
+  // small 6-by-n matrices and the sign that handles the eye-in-hand eye-to-hand
+  // case are applied before the multiplication by L that can have many rows
+  if (aJe->getRows() != 6) {
+    throw(vpServoException(vpServoException::dimensionError, "Cannot compute the task Jacobian with a (%dx%d) Jacobian",
+                           aJe->getRows(), aJe->getCols()));
+  }
+  if (!iscJcIdentity) {
+    mult6x6(cJc, cVa, cVa);
+  }
+  const unsigned int ndof = aJe->getCols();
+  cVa_aJe.resize(6, ndof, false, false);
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < ndof; j++) {
+      double sum = 0;
+      for (unsigned int k = 0; k < 6; k++) {
+        sum += cVa[i][k] * (*aJe)[k][j];
+      }
+      cVa_aJe[i][j] = sum;
+    }
+  }
+  cVa_aJe *= signInteractionMatrix;
+  vpMatrix::mult2Matrices(L, cVa_aJe, J1);
 
-    // pseudo inverse of the task Jacobian
-    // and rank of the task Jacobian
-    // the image of J1 is also computed to allows the computation
-    // of the projection operator
-    vpMatrix imJ1t, imJ1;
-    bool imageComputed = false;
+  // pseudo inverse of the task Jacobian
+  // and rank of the task Jacobian
+  // the image of J1 is also computed to allows the computation
+  // of the projection operator
+  bool imageComputed = false;
 
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
+  if (inversionType == PSEUDO_INVERSE) {
+    rankJ1 = computeTaskPseudoInverse(J1p);
 
-      imageComputed = true;
-    } else
-      J1p = J1.t();
+    imageComputed = true;
+  } else
+    J1.transpose(J1p);
 
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
+  vpMatrix::multMatrixVector(J1p, error, J1p_e);
+  if (rankJ1 == J1.getCols()) {
+    /* if no degrees of freedom remains (rank J1 = ndof)
+     WpW = I, multiply by WpW is useless
     */
-      e1 = J1p * error; // primary task
-
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
+    e1 = J1p_e; // primary task
+
+    WpW.eye(J1.getCols(), J1.getCols());
+  } else {
+    if (imageComputed != true) {
+      // image of J1 is computed to allows the computation
+      // of the projection operator
+      rankJ1 = computeTaskPseudoInverse(J1p_tmp);
+    }
+    const unsigned int n = imJ1t.getRows();
+    WpW.resize(n, n, false, false);
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int j = 0; j < n; j++) {
+        double sum = 0;
+        for (unsigned int k = 0; k < imJ1t.getCols(); k++) {
+          sum += imJ1t[i][k] * imJ1t[j][k];
+        }
+        WpW[i][j] = sum;
       }
-      WpW = imJ1t * imJ1t.t();
+    }
 
 #ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
+    std::cout << "rank J1: " << rankJ1 << std::endl;
+    imJ1t.print(std::cout, 10, "imJ1t");
 
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
+    WpW.print(std::cout, 10, "WpW");
+    J1.print(std::cout, 10, "J1");
+    J1p.print(std::cout, 10, "J1p");
 #endif
-      e1 = WpW * J1p * error;
+    vpMatrix::multMatrixVector(WpW, J1p_e, e1);
+  }
+}
+
+/*!
+  Compute the pseudo inverse of the task Jacobian \e J1, its singular values
+  \e sv and the image of its transpose \e imJ1t.
+
+  When \e J1 has many more rows than columns, as with photometric features
+  that give one row per pixel, the singular value decomposition of \e J1 is
+  replaced by the one of the small matrix \f${\bf J}_1^\top {\bf J}_1\f$ (normal
+  equations): its eigenvalues are the squares of the singular values of
+  \f${\bf J}_1\f$ and its eigenvectors the right singular vectors, and
+  \f${\bf J}_1^+ = \left({\bf J}_1^\top {\bf J}_1\right)^+ {\bf J}_1^\top\f$.
+  Since the normal equations square the condition number, the singular value
+  decomposition of \e J1 is still used when a singular value is too close to
+  the rank threshold for the rank to be determined reliably.
+
+  \param J1p_ : Pseudo inverse of \e J1.
+  \return The rank of \e J1.
+*/
+unsigned int vpServo::computeTaskPseudoInverse(vpMatrix &J1p_)
+{
+  const double svThreshold = 1e-6;
+  const unsigned int nrows = J1.getRows(), ncols = J1.getCols();
+
+  if (nrows >= normal_equations_min_rows && nrows > 4 * ncols) {
+    J1.AtA(J1tJ1);
+    vpColVector &eigenvalues = J1tJ1_eigenvalues;
+    symmetricEigenDecomposition(J1tJ1, eigenvalues, J1tJ1_V);
+
+    sv.resize(ncols, false);
+    for (unsigned int k = 0; k < ncols; k++) {
+      sv[k] = sqrt(std::max(eigenvalues[k], 0.0));
     }
 
-    // memorize the initial e1 value if the function is called the first time
-    // or if the time given as parameter is equal to 0.
-    if (iteration == 0 || std::fabs(t) < std::numeric_limits<double>::epsilon()) {
-      e1_initial = e1;
+    // The relative error on the small singular values is about
+    // sqrt(epsilon) sv[0]: the rank is only determined here when no singular
+    // value is close to the threshold
+    bool reliable = sv[0] > 0;
+    unsigned int rank = 0;
+    for (unsigned int k = 0; k < ncols && reliable; k++) {
+      if (sv[k] > sv[0] * svThreshold * 100) {
+        rank++;
+      } else if (sv[k] >= sv[0] * svThreshold / 100) {
+        reliable = false;
+      }
     }
-    // Security check. If size of e1_initial and e1 differ, that means that
-    // e1_initial was not set
-    if (e1_initial.getRows() != e1.getRows())
-      e1_initial = e1;
 
-    e = -lambda(e1) * e1 + (e_dot_init + lambda(e1) * e1_initial) * exp(-mu * t);
+    if (reliable) {
+      // (J1^T J1)^+ restricted to the image of J1^T
+      vpMatrix &V = J1tJ1_V;
+      J1tJ1.resize(ncols, ncols, false, false);
+      for (unsigned int i = 0; i < ncols; i++) {
+        for (unsigned int j = 0; j < ncols; j++) {
+          double sum = 0;
+          for (unsigned int k = 0; k < rank; k++) {
+            sum += V[i][k] * V[j][k] / eigenvalues[k];
+          }
+          J1tJ1[i][j] = sum;
+        }
+      }
 
-    vpMatrix I;
+      // J1^+ = (J1^T J1)^+ J1^T
+      J1p_.resize(ncols, nrows, false, false);
+      for (unsigned int i = 0; i < ncols; i++) {
+        const double *M_i = J1tJ1[i];
+        double *J1p_i = J1p_[i];
+        for (unsigned int r = 0; r < nrows; r++) {
+          const double *J1_r = J1[r];
+          double sum = 0;
+          for (unsigned int k = 0; k < ncols; k++) {
+            sum += M_i[k] * J1_r[k];
+          }
+          J1p_i[r] = sum;
+        }
+      }
 
-    I.eye(J1.getCols(), J1.getCols());
+      imJ1t.resize(ncols, rank, false, false);
+      for (unsigned int i = 0; i < ncols; i++) {
+        for (unsigned int k = 0; k < rank; k++) {
+          imJ1t[i][k] = V[i][k];
+        }
+      }
 
-    computeProjectionOperators();
-  } catch (...) {
-    throw;
+      return rank;
+    }
   }
 
-  iteration++;
-  return e;
+  return J1.pseudoInverse(J1p_, sv, svThreshold, imJ1, imJ1t);
 }
 
 void vpServo::computeProjectionOperators()
 {
   // Initialization
   unsigned int n = J1.getCols();
-  P.resize(n, n);
-
-  vpMatrix I;
-  I.eye(n);
+  P.resize(n, n, false, false);
 
   // Compute classical projection operator
-  I_WpW = (I - WpW);
+  I_WpW.resize(n, n, false, false);
+  for (unsigned int i = 0; i < n; i++) {
+    for (unsigned int j = 0; j < n; j++) {
+      I_WpW[i][j] = (i == j ? 1.0 : 0.0) - WpW[i][j];
+    }
+  }
 
   // Compute gain depending by the task error to ensure a smooth change
   // between the operators.
@@ -1396,17 +1428,27 @@ void vpServo::computeProjectionOperators()
   else
     sig = 0.0;
 
-  vpMatrix J1t = J1.transpose();
-
-  double pp = (error.t() * (J1 * J1t) * error);
-
-  vpMatrix ee_t(n, n);
-  ee_t = error * error.t();
+  // J1^T e, so that e^T J1 J1^T e and J1^T e e^T J1 are computed without the
+  // dim_task-by-dim_task matrices J1 J1^T and e e^T
+  J1t_e.resize(n, false);
+  J1t_e = 0;
+  for (unsigned int i = 0; i < J1.getRows(); i++) {
+    const double *J1_i = J1[i];
+    const double e_i = error[i];
+    for (unsigned int j = 0; j < n; j++) {
+      J1t_e[j] += J1_i[j] * e_i;
+    }
+  }
 
-  vpMatrix P_norm_e(n, n);
-  P_norm_e = I - (1.0 / pp) * J1t * ee_t * J1;
+  double pp = J1t_e.sumSquare();
 
-  P = sig * P_norm_e + (1 - sig) * I_WpW;
+  // P = sig P_norm_e + (1 - sig) (I - WpW)
+  for (unsigned int i = 0; i < n; i++) {
+    for (unsigned int j = 0; j < n; j++) {
+      const double P_norm_e = (i == j ? 1.0 : 0.0) - (1.0 / pp) * J1t_e[i] * J1t_e[j];
+      P[i][j] = sig * P_norm_e + (1 - sig) * I_WpW[i][j];
+    }
+  }
 
   return;
 }
@@ -0,0 +1,288 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Benchmark of the vpServo control law.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPerformanceServo.cpp
+
+  \brief Compare the control law computed by vpServo for a photometric task,
+  whose task Jacobian has one row per pixel, and for a task with 4 points,
+  with the one obtained from the singular value decomposition of the task
+  Jacobian, and measure the time needed by vpServo::computeControlLaw().
+  Check also that the state of the control law is not shared between tasks.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/visual_features/vpFeatureBuilder.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+#include <visp3/visual_features/vpFeaturePoint.h>
+#include <visp3/vs/vpServo.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Smooth textured image translated by (tu, tv)
+void generateImage(vpImage<unsigned char> &I, double tu, double tv)
+{
+  I.resize(240, 320);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      double u = j - tu, v = i - tv;
+      double val = 127.5 + 60. * sin(u / 7.) * cos(v / 11.) + 60. * cos((u + v) / 17.);
+      I[i][j] = (unsigned char)vpMath::round(val);
+    }
+  }
+}
+
+bool compare(const vpMatrix &M, const vpMatrix &M_ref, double epsilon, const std::string &name)
+{
+  if (M.getRows() != M_ref.getRows() || M.getCols() != M_ref.getCols()) {
+    std::cerr << name << ": size (" << M.getRows() << "x" << M.getCols() << ") instead of (" << M_ref.getRows()
+              << "x" << M_ref.getCols() << ")" << std::endl;
+    return false;
+  }
+  double max_ref = 0, max_diff = 0;
+  for (unsigned int i = 0; i < M.getRows(); i++) {
+    for (unsigned int j = 0; j < M.getCols(); j++) {
+      max_ref = std::max(max_ref, std::fabs(M_ref[i][j]));
+      max_diff = std::max(max_diff, std::fabs(M[i][j] - M_ref[i][j]));
+    }
+  }
+  if (max_diff > epsilon * std::max(max_ref, 1.)) {
+    std::cerr << name << ": max difference " << max_diff << " with the reference (max " << max_ref << ")"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool compare(const vpColVector &v, const vpColVector &v_ref, double epsilon, const std::string &name)
+{
+  return compare(vpMatrix(v), vpMatrix(v_ref), epsilon, name);
+}
+
+// Check the control law of a task with full rank or rank deficient task
+// Jacobian against the singular value decomposition of the Jacobian
+bool checkControlLaw(const vpServo &task, const vpColVector &v, double epsilon, const std::string &name)
+{
+  vpMatrix J1 = task.getTaskJacobian();
+  vpMatrix J1p_ref, imJ1, imJ1t;
+  vpColVector sv_ref;
+  unsigned int rank_ref = J1.pseudoInverse(J1p_ref, sv_ref, 1e-6, imJ1, imJ1t);
+
+  if (task.getTaskRank() != rank_ref) {
+    std::cerr << name << ": rank " << task.getTaskRank() << " instead of " << rank_ref << std::endl;
+    return false;
+  }
+
+  vpMatrix WpW_ref = imJ1t * imJ1t.t();
+  vpColVector v_ref = -task.lambda(task.error) * WpW_ref * J1p_ref * task.error;
+
+  return compare(task.getTaskSingularValues(), sv_ref, epsilon, name + " singular values") &&
+         compare(task.getTaskJacobianPseudoInverse(), J1p_ref, epsilon, name + " pseudo inverse") &&
+         compare(task.getWpW(), WpW_ref, epsilon, name + " WpW") && compare(v, v_ref, epsilon, name + " velocity");
+}
+
+bool testPhotometric(const vpColVector &dof, const std::string &name)
+{
+  vpCameraParameters cam(870, 870, 160, 120);
+  vpImage<unsigned char> Id, I;
+  generateImage(Id, 0, 0);
+  generateImage(I, 3, -2);
+
+  vpFeatureLuminance sd, s;
+  sd.init(Id.getHeight(), Id.getWidth(), 1.);
+  sd.setCameraParameters(cam);
+  sd.buildFrom(Id);
+  s.init(I.getHeight(), I.getWidth(), 1.);
+  s.setCameraParameters(cam);
+  s.buildFrom(I);
+
+  vpServo task;
+  task.setServo(vpServo::EYEINHAND_CAMERA);
+  task.setInteractionMatrixType(vpServo::CURRENT);
+  task.setLambda(0.5);
+  task.addFeature(s, sd);
+  if (dof.size() != 0) {
+    task.setCameraDoF(dof);
+  }
+
+  vpColVector v;
+  unsigned int nbIter = 20;
+  double t = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    v = task.computeControlLaw();
+  }
+  t = vpTime::measureTimeMs() - t;
+
+  vpMatrix J1 = task.getTaskJacobian(), J1p_ref, imJ1, imJ1t;
+  vpColVector sv_ref;
+  double t_svd = vpTime::measureTimeMs();
+  for (unsigned int i = 0; i < nbIter; i++) {
+    J1.pseudoInverse(J1p_ref, sv_ref, 1e-6, imJ1, imJ1t);
+  }
+  t_svd = vpTime::measureTimeMs() - t_svd;
+
+  std::cout << name << ": " << task.getDimension() << " features, computeControlLaw() " << t / nbIter
+            << " ms, SVD of the task Jacobian " << t_svd / nbIter << " ms" << std::endl;
+
+  bool ok = checkControlLaw(task, v, 1e-8, name);
+  task.kill();
+  return ok;
+}
+
+void buildPointTask(vpServo &task, vpFeaturePoint p[4], vpFeaturePoint pd[4],
+                    vpServo::vpServoType servo_type = vpServo::EYEINHAND_CAMERA)
+{
+  vpHomogeneousMatrix cdMo(0, 0, 0.75, 0, 0, 0);
+  vpHomogeneousMatrix cMo(0.15, -0.1, 1., vpMath::rad(10), vpMath::rad(-10), vpMath::rad(50));
+  vpPoint point[4];
+  point[0].setWorldCoordinates(-0.1, -0.1, 0);
+  point[1].setWorldCoordinates(0.1, -0.1, 0);
+  point[2].setWorldCoordinates(0.1, 0.1, 0);
+  point[3].setWorldCoordinates(-0.1, 0.1, 0);
+
+  task.setServo(servo_type);
+  task.setInteractionMatrixType(vpServo::CURRENT);
+  task.setLambda(0.5);
+  for (unsigned int i = 0; i < 4; i++) {
+    point[i].track(cdMo);
+    vpFeatureBuilder::create(pd[i], point[i]);
+    point[i].track(cMo);
+    vpFeatureBuilder::create(p[i], point[i]);
+    task.addFeature(p[i], pd[i]);
+  }
+}
+
+bool testPoints()
+{
+  vpServo task;
+  vpFeaturePoint p[4], pd[4];
+  buildPointTask(task, p, pd);
+
+  vpColVector v = task.computeControlLaw();
+  if (!checkControlLaw(task, v, 1e-12, "4 points")) {
+    return false;
+  }
+
+  // Large projection operator computed from the n-by-n matrices
+  // J1^T e e^T J1 and e^T J1 J1^T e
+  vpMatrix J1 = task.getTaskJacobian();
+  vpMatrix ee = task.error * task.error.t();
+  double pp = (task.error.t() * J1 * J1.t() * task.error);
+  vpMatrix I;
+  I.eye(J1.getCols());
+  vpMatrix P_norm_e = I - (1.0 / pp) * J1.t() * ee * J1;
+  double norm_e = task.error.euclideanNorm();
+  double sig = norm_e > 0.7 ? 1.0 : (norm_e < 0.1 ? 0.0 : 1.0 / (1.0 + exp(-12.0 * ((norm_e - 0.1) / 0.6) + 6.0)));
+  vpMatrix P_ref = sig * P_norm_e + (1 - sig) * (I - task.getWpW());
+  bool ok = compare(task.getLargeP(), P_ref, 1e-12, "4 points large projection operator");
+
+  task.kill();
+  return ok;
+}
+
+// The initialization of a task is checked at its first iteration, even if
+// another task has already computed its control law
+bool testPerInstanceState()
+{
+  vpServo task;
+  vpFeaturePoint p[4], pd[4];
+  buildPointTask(task, p, pd);
+  for (unsigned int i = 0; i < 3; i++) {
+    task.computeControlLaw();
+  }
+
+  vpServo task_not_initialized;
+  vpFeaturePoint p2[4], pd2[4];
+  buildPointTask(task_not_initialized, p2, pd2, vpServo::EYEINHAND_L_cVe_eJe);
+  vpMatrix eJe;
+  eJe.eye(6);
+  task_not_initialized.set_eJe(eJe);
+
+  bool ok = false;
+  try {
+    task_not_initialized.computeControlLaw();
+    std::cerr << "The control law of a task without cVe was computed" << std::endl;
+  } catch (const vpServoException &) {
+    ok = true;
+  }
+
+  task.kill();
+  task_not_initialized.kill();
+  return ok;
+}
+} // namespace
+#endif
+
+int main()
+{
+#if defined(__mips__) || defined(__mips) || defined(mips) || defined(__MIPS__)
+  // To avoid Debian test timeout
+  return EXIT_SUCCESS;
+#endif
+
+  try {
+    if (!testPhotometric(vpColVector(), "photometric")) {
+      return EXIT_FAILURE;
+    }
+
+    // Rotation around the optical axis not controlled: rank 5
+    vpColVector dof(6, 1);
+    dof[5] = 0;
+    if (!testPhotometric(dof, "photometric, 5 dof")) {
+      return EXIT_FAILURE;
+    }
+
+    if (!testPoints()) {
+      return EXIT_FAILURE;
+    }
+
+    if (!testPerInstanceState()) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testPerformanceServo is ok." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,147 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2017 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the degrees of freedom of the camera controlled by vpServo.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testServoCameraDoF.cpp
+
+  \brief Check that the degrees of freedom of the camera selected with
+  vpServo::setCameraDoF() are the only ones controlled by all the
+  vpServo::computeControlLaw() variants, including the ones with a continuous
+  sequencing.
+*/
+
+#include <cmath>
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/visual_features/vpFeatureBuilder.h>
+#include <visp3/visual_features/vpFeaturePoint.h>
+#include <visp3/vs/vpServo.h>
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Check that the velocity v has no component on the degrees of freedom
+// turned off in dof, and at least one on the other ones
+bool checkVelocity(const vpColVector &v, const vpColVector &dof, const std::string &name)
+{
+  double norm_controlled = 0;
+  for (unsigned int i = 0; i < 6; i++) {
+    if (dof[i] == 0 && std::fabs(v[i]) > 1e-12) {
+      std::cerr << name << ": dof " << i << " is controlled, v = " << v.t() << std::endl;
+      return false;
+    }
+    norm_controlled += std::fabs(v[i]);
+  }
+  if (norm_controlled < 1e-6) {
+    std::cerr << name << ": no dof is controlled" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+#endif
+
+int main()
+{
+  try {
+    // 4 points seen from a camera that is not at the desired pose
+    vpPoint point[4];
+    point[0].setWorldCoordinates(-0.1, -0.1, 0);
+    point[1].setWorldCoordinates(0.1, -0.1, 0);
+    point[2].setWorldCoordinates(0.1, 0.1, 0);
+    point[3].setWorldCoordinates(-0.1, 0.1, 0);
+
+    vpHomogeneousMatrix cMo(0.05, -0.03, 0.8, vpMath::rad(5), vpMath::rad(-8), vpMath::rad(20));
+    vpHomogeneousMatrix cdMo(0, 0, 0.5, 0, 0, 0);
+
+    vpFeaturePoint p[4], pd[4];
+    vpServo task;
+    task.setServo(vpServo::EYEINHAND_CAMERA);
+    task.setInteractionMatrixType(vpServo::CURRENT);
+    task.setLambda(0.5);
+    for (unsigned int i = 0; i < 4; i++) {
+      point[i].track(cdMo);
+      vpFeatureBuilder::create(pd[i], point[i]);
+      point[i].track(cMo);
+      vpFeatureBuilder::create(p[i], point[i]);
+      task.addFeature(p[i], pd[i]);
+    }
+
+    // Turn off vz and wz
+    vpColVector dof(6, 1);
+    dof[2] = 0;
+    dof[5] = 0;
+    task.setCameraDoF(dof);
+
+    // Initial velocity on the controlled dof only
+    vpColVector e_dot_init(6, 0.1);
+    e_dot_init[2] = 0;
+    e_dot_init[5] = 0;
+    // At t = 0, the continuous sequencing variants store the initial primary
+    // task and give a null velocity (resp. e_dot_init)
+    task.computeControlLaw(0.);
+    vpColVector v_t = task.computeControlLaw(0.5);
+    task.computeControlLaw(0., e_dot_init);
+    vpColVector v_t_e_dot_init = task.computeControlLaw(0.5, e_dot_init);
+    if (!checkVelocity(task.computeControlLaw(), dof, "computeControlLaw()") ||
+        !checkVelocity(v_t, dof, "computeControlLaw(t)") ||
+        !checkVelocity(v_t_e_dot_init, dof, "computeControlLaw(t, e_dot_init)")) {
+      task.kill();
+      return EXIT_FAILURE;
+    }
+
+    // When the initial term vanishes, the continuous sequencing gives the
+    // classical control law
+    vpColVector v = task.computeControlLaw();
+    v_t = task.computeControlLaw(1000.);
+    if ((v - v_t).euclideanNorm() > 1e-12) {
+      std::cerr << "computeControlLaw(t) differs from computeControlLaw(): " << v_t.t() << " instead of " << v.t()
+                << std::endl;
+      task.kill();
+      return EXIT_FAILURE;
+    }
+
+    task.kill();
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testServoCameraDoF is ok." << std::endl;
+  return EXIT_SUCCESS;
+}